@@ -0,0 +1,524 @@
+//
+//  AnimationModel.cpp
+//
+
+#include <cassert>
+#include <cmath>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "ObjLibrary/Material.h"
+
+#include "LodView.h"
+#include "CompiledModel.h"
+#include "AnimationModel.h"
+
+// SSE2 is always available on x86-64
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+	#define ANIMATION_MODEL_SSE2
+	#include <emmintrin.h>
+#endif
+
+using namespace std;
+using namespace ObjLibrary;
+namespace
+{
+	const unsigned int POSITION_OFFSET = 5;
+	const float QUANTIZED_MAX = 65535.0f;
+
+	//
+	//  BlendTerms
+	//
+	//  The terms used to calculate a blended position from two
+	//    quantized values.  Each coordinate is
+	//    ma_base[c] + value0 * ma_scale0[c] +
+	//    value1 * ma_scale1[c].
+	//
+	struct BlendTerms
+	{
+		float ma_base[3];
+		float ma_scale0[3];
+		float ma_scale1[3];
+	};
+
+#ifdef ANIMATION_MODEL_SSE2
+	//
+	//  storeInterleaved
+	//
+	//  Purpose: To store 4 vertexes given as separate x, y, and
+	//           z values as x, y, and z for each vertex in turn.
+	//  Parameter(s):
+	//    <1> x
+	//    <2> y
+	//    <3> z: The coordinates of the 4 vertexes
+	//    <4> a_out: The array to store in
+	//  Precondition(s):
+	//    <1> a_out != NULL
+	//    <2> a_out has space for 12 values
+	//  Returns: N/A
+	//  Side Effect: The first 12 values of a_out are set.
+	//
+	inline void storeInterleaved (__m128 x, __m128 y, __m128 z,
+	                              float* a_out)
+	{
+		assert(a_out != NULL);
+
+		__m128 xy_low   = _mm_unpacklo_ps(x, y);                        // x0 y0 x1 y1
+		__m128 xy_high  = _mm_unpackhi_ps(x, y);                        // x2 y2 x3 y3
+		__m128 z0_x1    = _mm_shuffle_ps(z, x, _MM_SHUFFLE(1, 1, 0, 0)); // z0 z0 x1 x1
+		__m128 y1_z1    = _mm_shuffle_ps(y, z, _MM_SHUFFLE(1, 1, 1, 1)); // y1 y1 z1 z1
+		__m128 z2_x3    = _mm_shuffle_ps(z, x, _MM_SHUFFLE(3, 3, 2, 2)); // z2 z2 x3 x3
+		__m128 y3_z3    = _mm_shuffle_ps(y, z, _MM_SHUFFLE(3, 3, 3, 3)); // y3 y3 z3 z3
+
+		_mm_storeu_ps(a_out,     _mm_shuffle_ps(xy_low, z0_x1,   _MM_SHUFFLE(2, 0, 1, 0)));
+		_mm_storeu_ps(a_out + 4, _mm_shuffle_ps(y1_z1,  xy_high, _MM_SHUFFLE(1, 0, 2, 0)));
+		_mm_storeu_ps(a_out + 8, _mm_shuffle_ps(z2_x3,  y3_z3,   _MM_SHUFFLE(2, 0, 2, 0)));
+	}
+
+	//
+	//  loadQuantized
+	//
+	//  Purpose: To load 4 quantized values as floats.
+	//  Parameter(s):
+	//    <1> a_values: The values
+	//  Precondition(s):
+	//    <1> a_values != NULL
+	//    <2> a_values has at least 4 values
+	//  Returns: The values, converted to floats.
+	//  Side Effect: N/A
+	//
+	inline __m128 loadQuantized (const uint16_t* a_values)
+	{
+		assert(a_values != NULL);
+
+		__m128i packed = _mm_loadl_epi64((const __m128i*)(a_values));
+		return _mm_cvtepi32_ps(_mm_unpacklo_epi16(packed, _mm_setzero_si128()));
+	}
+#endif
+
+	//
+	//  blendFloat
+	//
+	//  Purpose: To blend two frames of float positions.
+	//  Parameter(s):
+	//    <1> a_positions0
+	//    <2> a_positions1: The x, y, and z arrays for each
+	//                      frame, one after another
+	//    <3> count: The number of vertexes
+	//    <4> fraction: How far to go from frame 0 to frame 1
+	//    <5> a_out: The array to fill
+	//  Precondition(s):
+	//    <1> a_positions0 != NULL
+	//    <2> a_positions1 != NULL
+	//    <3> a_out != NULL
+	//  Returns: N/A
+	//  Side Effect: a_out is set to the blended x, y, and z
+	//               for each vertex in turn.
+	//
+	void blendFloat (const float* a_positions0,
+	                 const float* a_positions1,
+	                 unsigned int count,
+	                 float fraction,
+	                 float* a_out)
+	{
+		assert(a_positions0 != NULL);
+		assert(a_positions1 != NULL);
+		assert(a_out != NULL);
+
+		const float* a_x0 = a_positions0;
+		const float* a_y0 = a_x0 + count;
+		const float* a_z0 = a_y0 + count;
+		const float* a_x1 = a_positions1;
+		const float* a_y1 = a_x1 + count;
+		const float* a_z1 = a_y1 + count;
+
+		unsigned int v = 0;
+#ifdef ANIMATION_MODEL_SSE2
+		__m128 t = _mm_set1_ps(fraction);
+		for( ; v + 4 <= count; v += 4)
+		{
+			__m128 x0 = _mm_loadu_ps(a_x0 + v);
+			__m128 y0 = _mm_loadu_ps(a_y0 + v);
+			__m128 z0 = _mm_loadu_ps(a_z0 + v);
+			__m128 x = _mm_add_ps(x0, _mm_mul_ps(_mm_sub_ps(_mm_loadu_ps(a_x1 + v), x0), t));
+			__m128 y = _mm_add_ps(y0, _mm_mul_ps(_mm_sub_ps(_mm_loadu_ps(a_y1 + v), y0), t));
+			__m128 z = _mm_add_ps(z0, _mm_mul_ps(_mm_sub_ps(_mm_loadu_ps(a_z1 + v), z0), t));
+			storeInterleaved(x, y, z, a_out + v * 3);
+		}
+#endif
+		for( ; v < count; v++)
+		{
+			a_out[v * 3]     = a_x0[v] + (a_x1[v] - a_x0[v]) * fraction;
+			a_out[v * 3 + 1] = a_y0[v] + (a_y1[v] - a_y0[v]) * fraction;
+			a_out[v * 3 + 2] = a_z0[v] + (a_z1[v] - a_z0[v]) * fraction;
+		}
+	}
+
+	//
+	//  blendQuantized
+	//
+	//  Purpose: To blend two frames of quantized positions.
+	//  Parameter(s):
+	//    <1> a_values0
+	//    <2> a_values1: The x, y, and z arrays for each frame,
+	//                   one after another
+	//    <3> count: The number of vertexes
+	//    <4> terms: The terms to calculate positions with
+	//    <5> a_out: The array to fill
+	//  Precondition(s):
+	//    <1> a_values0 != NULL
+	//    <2> a_values1 != NULL
+	//    <3> a_out != NULL
+	//  Returns: N/A
+	//  Side Effect: a_out is set to the blended x, y, and z
+	//               for each vertex in turn.
+	//
+	void blendQuantized (const uint16_t* a_values0,
+	                     const uint16_t* a_values1,
+	                     unsigned int count,
+	                     const BlendTerms& terms,
+	                     float* a_out)
+	{
+		assert(a_values0 != NULL);
+		assert(a_values1 != NULL);
+		assert(a_out != NULL);
+
+		const uint16_t* aa_values0[3] = { a_values0, a_values0 + count, a_values0 + count * 2 };
+		const uint16_t* aa_values1[3] = { a_values1, a_values1 + count, a_values1 + count * 2 };
+
+		unsigned int v = 0;
+#ifdef ANIMATION_MODEL_SSE2
+		__m128 a_base[3];
+		__m128 a_scale0[3];
+		__m128 a_scale1[3];
+		for(unsigned int c = 0; c < 3; c++)
+		{
+			a_base[c]   = _mm_set1_ps(terms.ma_base[c]);
+			a_scale0[c] = _mm_set1_ps(terms.ma_scale0[c]);
+			a_scale1[c] = _mm_set1_ps(terms.ma_scale1[c]);
+		}
+
+		for( ; v + 4 <= count; v += 4)
+		{
+			__m128 a_blended[3];
+			for(unsigned int c = 0; c < 3; c++)
+			{
+				__m128 value0 = loadQuantized(aa_values0[c] + v);
+				__m128 value1 = loadQuantized(aa_values1[c] + v);
+				a_blended[c] = _mm_add_ps(a_base[c], _mm_add_ps(_mm_mul_ps(value0, a_scale0[c]),
+				                                                _mm_mul_ps(value1, a_scale1[c])));
+			}
+			storeInterleaved(a_blended[0], a_blended[1], a_blended[2], a_out + v * 3);
+		}
+#endif
+		for( ; v < count; v++)
+			for(unsigned int c = 0; c < 3; c++)
+			{
+				a_out[v * 3 + c] = terms.ma_base[c] + aa_values0[c][v] * terms.ma_scale0[c] +
+				                                      aa_values1[c][v] * terms.ma_scale1[c];
+			}
+	}
+}
+
+
+
+AnimationModel :: AnimationModel ()
+		: m_is_quantized(false)
+		, mv_surfaces()
+		, mv_frames()
+		, mv_positions()
+		, mv_quantized()
+		, mv_draw_positions()
+{
+	assert(invariant());
+}
+
+AnimationModel :: AnimationModel (bool is_quantized)
+		: m_is_quantized(is_quantized)
+		, mv_surfaces()
+		, mv_frames()
+		, mv_positions()
+		, mv_quantized()
+		, mv_draw_positions()
+{
+	assert(invariant());
+}
+
+
+
+bool AnimationModel :: isEmpty () const
+{
+	return mv_frames.empty();
+}
+
+bool AnimationModel :: isQuantized () const
+{
+	return m_is_quantized;
+}
+
+unsigned int AnimationModel :: getFrameCount () const
+{
+	return mv_frames.size();
+}
+
+unsigned int AnimationModel :: getSurfaceCount () const
+{
+	return mv_surfaces.size();
+}
+
+unsigned int AnimationModel :: getVertexCount (unsigned int frame) const
+{
+	assert(frame < getFrameCount());
+
+	return mv_frames[frame].m_vertex_count;
+}
+
+unsigned int AnimationModel :: getTriangleCount (unsigned int frame) const
+{
+	assert(frame < getFrameCount());
+
+	return mv_surfaces[mv_frames[frame].m_surface].getTriangleCount();
+}
+
+unsigned int AnimationModel :: getTriangleCount (unsigned int frame,
+                                                 unsigned int level) const
+{
+	assert(frame < getFrameCount());
+
+	const CompiledModel& surface = mv_surfaces[mv_frames[frame].m_surface];
+	return surface.getTriangleCount(min(level, surface.getLevelCount() - 1));
+}
+
+unsigned int AnimationModel :: getLevelCount (unsigned int frame) const
+{
+	assert(frame < getFrameCount());
+
+	return mv_surfaces[mv_frames[frame].m_surface].getLevelCount();
+}
+
+unsigned int AnimationModel :: chooseLevel (unsigned int frame,
+                                            const LodView& view,
+                                            const Vector3& center,
+                                            float radius) const
+{
+	assert(frame < getFrameCount());
+	assert(radius >= 0.0f);
+
+	const CompiledModel& surface = mv_surfaces[mv_frames[frame].m_surface];
+	unsigned int level = 0;
+	while(level + 1 < surface.getLevelCount() &&
+	      view.isErrorHidden(center, radius, surface.getLevelError(level + 1)))
+	{
+		level++;
+	}
+	return level;
+}
+
+size_t AnimationModel :: getMemoryUsage () const
+{
+	size_t total = mv_frames.size()         * sizeof(Frame) +
+	               mv_positions.size()      * sizeof(float) +
+	               mv_quantized.size()      * sizeof(uint16_t) +
+	               mv_draw_positions.size() * sizeof(float);
+	for(unsigned int i = 0; i < mv_surfaces.size(); i++)
+		total += mv_surfaces[i].getMemoryUsage();
+	return total;
+}
+
+vector<string> AnimationModel :: getDisplayTextureNames () const
+{
+	vector<string> v_names;
+	for(unsigned int i = 0; i < mv_surfaces.size(); i++)
+	{
+		vector<string> v_surface_names = mv_surfaces[i].getDisplayTextureNames();
+		v_names.insert(v_names.end(), v_surface_names.begin(), v_surface_names.end());
+	}
+	return v_names;
+}
+
+void AnimationModel :: getFramePositions (unsigned int frame,
+                                          float* a_positions) const
+{
+	assert(frame < getFrameCount());
+	assert(a_positions != NULL);
+
+	getBlendedPositions(frame, frame, 0.0f, a_positions);
+}
+
+bool AnimationModel :: isBlendable (unsigned int frame0,
+                                    unsigned int frame1) const
+{
+	assert(frame0 < getFrameCount());
+	assert(frame1 < getFrameCount());
+
+	return mv_frames[frame0].m_surface == mv_frames[frame1].m_surface;
+}
+
+void AnimationModel :: getBlendedPositions (unsigned int frame0,
+                                            unsigned int frame1,
+                                            float fraction,
+                                            float* a_positions) const
+{
+	assert(frame0 < getFrameCount());
+	assert(frame1 < getFrameCount());
+	assert(isBlendable(frame0, frame1));
+	assert(a_positions != NULL);
+
+	const Frame& record0 = mv_frames[frame0];
+	const Frame& record1 = mv_frames[frame1];
+	assert(record0.m_vertex_count == record1.m_vertex_count);
+
+	if(m_is_quantized)
+	{
+		// fold the dequantizing into the blend
+		BlendTerms terms;
+		for(unsigned int c = 0; c < 3; c++)
+		{
+			terms.ma_base[c]   = record0.ma_minimum[c] * (1.0f - fraction) + record1.ma_minimum[c] * fraction;
+			terms.ma_scale0[c] = record0.ma_step[c]    * (1.0f - fraction);
+			terms.ma_scale1[c] = record1.ma_step[c]    * fraction;
+		}
+		blendQuantized(mv_quantized.data() + record0.m_first,
+		               mv_quantized.data() + record1.m_first,
+		               record0.m_vertex_count, terms, a_positions);
+	}
+	else
+	{
+		blendFloat(mv_positions.data() + record0.m_first,
+		           mv_positions.data() + record1.m_first,
+		           record0.m_vertex_count, fraction, a_positions);
+	}
+}
+
+
+
+void AnimationModel :: addFrame (const CompiledModel& model)
+{
+	Frame record;
+	record.m_surface = mv_surfaces.size();
+	for(unsigned int i = 0; i < mv_surfaces.size(); i++)
+		if(mv_surfaces[i].isSameSurface(model))
+		{
+			record.m_surface = i;
+			break;
+		}
+	if(record.m_surface == mv_surfaces.size())
+		mv_surfaces.push_back(model);
+
+	const vector<float>& v_vertexes = model.getVertexData();
+	unsigned int count = model.getVertexCount();
+	record.m_vertex_count = count;
+
+	// the draw buffer must hold the largest frame
+	if(mv_draw_positions.size() < count * 3)
+		mv_draw_positions.resize(count * 3);
+
+	if(m_is_quantized)
+	{
+		for(unsigned int c = 0; c < 3; c++)
+		{
+			float minimum =  INFINITY;
+			float maximum = -INFINITY;
+			for(unsigned int v = 0; v < count; v++)
+			{
+				float value = v_vertexes[v * CompiledModel::FLOATS_PER_VERTEX + POSITION_OFFSET + c];
+				if(value < minimum) minimum = value;
+				if(value > maximum) maximum = value;
+			}
+			if(count == 0)
+				minimum = maximum = 0.0f;
+			record.ma_minimum[c] = minimum;
+			record.ma_step[c]    = (maximum - minimum) / QUANTIZED_MAX;
+		}
+
+		record.m_first = mv_quantized.size();
+		for(unsigned int c = 0; c < 3; c++)
+			for(unsigned int v = 0; v < count; v++)
+			{
+				float value = v_vertexes[v * CompiledModel::FLOATS_PER_VERTEX + POSITION_OFFSET + c];
+				float scaled = 0.0f;
+				if(record.ma_step[c] > 0.0f)
+					scaled = (value - record.ma_minimum[c]) / record.ma_step[c];
+				if(scaled > QUANTIZED_MAX)
+					scaled = QUANTIZED_MAX;
+				mv_quantized.push_back((uint16_t)(scaled + 0.5f));
+			}
+	}
+	else
+	{
+		for(unsigned int c = 0; c < 3; c++)
+		{
+			record.ma_minimum[c] = 0.0f;
+			record.ma_step[c]    = 1.0f;
+		}
+
+		record.m_first = mv_positions.size();
+		for(unsigned int c = 0; c < 3; c++)
+			for(unsigned int v = 0; v < count; v++)
+				mv_positions.push_back(v_vertexes[v * CompiledModel::FLOATS_PER_VERTEX + POSITION_OFFSET + c]);
+	}
+
+	mv_frames.push_back(record);
+
+	assert(invariant());
+}
+
+void AnimationModel :: generateLevels ()
+{
+	for(unsigned int i = 0; i < mv_surfaces.size(); i++)
+		if(mv_surfaces[i].getLevelCount() == 1)
+			mv_surfaces[i].generateLevels();
+}
+
+void AnimationModel :: loadTextures ()
+{
+	for(unsigned int i = 0; i < mv_surfaces.size(); i++)
+		mv_surfaces[i].loadTextures();
+}
+
+void AnimationModel :: draw (unsigned int frame) const
+{
+	assert(frame < getFrameCount());
+	assert(!Material::isMaterialActive());
+
+	draw(frame, frame, 0.0f, 0);
+}
+
+void AnimationModel :: draw (unsigned int frame0,
+                             unsigned int frame1,
+                             float fraction,
+                             unsigned int level) const
+{
+	assert(frame0 < getFrameCount());
+	assert(frame1 < getFrameCount());
+	assert(!Material::isMaterialActive());
+
+	if(!isBlendable(frame0, frame1))
+	{
+		if(fraction >= 0.5f)
+			frame0 = frame1;
+		frame1   = frame0;
+		fraction = 0.0f;
+	}
+
+	if(mv_frames[frame0].m_vertex_count == 0)
+		return;
+
+	const CompiledModel& surface = mv_surfaces[mv_frames[frame0].m_surface];
+	getBlendedPositions(frame0, frame1, fraction, mv_draw_positions.data());
+	surface.drawWithPositions(mv_draw_positions.data(), min(level, surface.getLevelCount() - 1));
+
+	assert(!Material::isMaterialActive());
+}
+
+
+
+bool AnimationModel :: invariant () const
+{
+	for(unsigned int i = 0; i < mv_frames.size(); i++)
+		if(mv_frames[i].m_surface >= mv_surfaces.size()) return false;
+	if(m_is_quantized && !mv_positions.empty()) return false;
+	if(!m_is_quantized && !mv_quantized.empty()) return false;
+	return true;
+}
@@ -0,0 +1,459 @@
+//
+//  AnimationModel.h
+//
+//  A module to represent a sequence of animation frames that
+//    share their triangles and texture coordinates.
+//
+
+#ifndef ANIMATION_MODEL_H
+#define ANIMATION_MODEL_H
+
+#include <cassert>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "ObjLibrary/Vector3.h"
+
+#include "CompiledModel.h"
+
+class LodView;
+
+
+
+//
+//  AnimationModel
+//
+//  A class to represent an animation made of several frames,
+//    each of which is a complete model.  Normally, every frame
+//    of an animation has the same triangles, texture
+//    coordinates, normals, and materials, and only the vertex
+//    positions change.  An AnimationModel stores that shared
+//    surface once, as a CompiledModel, and stores only the
+//    positions for each frame.
+//
+//  If a frame does not have the same surface as any earlier
+//    frame, it is given a new surface.  This keeps animations
+//    that were exported inconsistently drawing correctly, but
+//    they save less memory.
+//
+//  The positions for each frame are stored as separate x, y,
+//    and z arrays.  They may be stored as floats or quantized
+//    to 16 bits.  Quantized positions cover the bounding box of
+//    their frame, which is stored with them, so the error is at
+//    most 1/131070 of the size of the frame along each axis.
+//
+//  Positions are converted to the interleaved form OpenGL needs
+//    when a frame is drawn, so an AnimationModel is drawn
+//    directly rather than through a display list.  Two frames
+//    with the same surface can be blended while converting,
+//    which makes the animation smooth without adding frames.
+//    The conversion processes 4 vertexes at a time with SSE2
+//    where it is available.  It writes into a buffer inside
+//    the AnimationModel, so only one thread may draw a given
+//    AnimationModel at a time.
+//
+//  Each surface may have simplified levels of detail.  They
+//    are calculated from the positions of the first frame that
+//    uses the surface and used for every frame, which works
+//    because the frames differ only in their positions.
+//
+//  Class Invariant:
+//    <1> mv_frames[i].m_surface < mv_surfaces.size()
+//                             WHERE 0 <= i < mv_frames.size()
+//    <2> !m_is_quantized || mv_positions.empty()
+//    <3> m_is_quantized || mv_quantized.empty()
+//
+class AnimationModel
+{
+public:
+	//
+	//  Default Constructor
+	//
+	//  Purpose: To create a new AnimationModel with no frames
+	//           that stores positions as floats.
+	//  Parameter(s): N/A
+	//  Precondition(s): N/A
+	//  Returns: N/A
+	//  Side Effect: A new AnimationModel is created.
+	//
+	AnimationModel ();
+
+	//
+	//  Constructor
+	//
+	//  Purpose: To create a new AnimationModel with no frames.
+	//  Parameter(s):
+	//    <1> is_quantized: Whether positions should be stored
+	//                      as 16-bit integers instead of floats
+	//  Precondition(s): N/A
+	//  Returns: N/A
+	//  Side Effect: A new AnimationModel is created.
+	//
+	AnimationModel (bool is_quantized);
+
+	AnimationModel (const AnimationModel& original) = default;
+	~AnimationModel () = default;
+	AnimationModel& operator= (const AnimationModel& original) = default;
+
+	//
+	//  isEmpty
+	//
+	//  Purpose: To determine whether this AnimationModel has any
+	//           frames.
+	//  Parameter(s): N/A
+	//  Precondition(s): N/A
+	//  Returns: Whether there are no frames.
+	//  Side Effect: N/A
+	//
+	bool isEmpty () const;
+
+	//
+	//  isQuantized
+	//
+	//  Purpose: To determine whether this AnimationModel stores
+	//           positions as 16-bit integers.
+	//  Parameter(s): N/A
+	//  Precondition(s): N/A
+	//  Returns: Whether positions are quantized.
+	//  Side Effect: N/A
+	//
+	bool isQuantized () const;
+
+	//
+	//  getFrameCount
+	//
+	//  Purpose: To determine the number of frames in this
+	//           AnimationModel.
+	//  Parameter(s): N/A
+	//  Precondition(s): N/A
+	//  Returns: The number of frames.
+	//  Side Effect: N/A
+	//
+	unsigned int getFrameCount () const;
+
+	//
+	//  getSurfaceCount
+	//
+	//  Purpose: To determine the number of different surfaces
+	//           used by the frames of this AnimationModel.
+	//  Parameter(s): N/A
+	//  Precondition(s): N/A
+	//  Returns: The number of surfaces.  This is 1 if all frames
+	//           differ only in their vertex positions.
+	//  Side Effect: N/A
+	//
+	unsigned int getSurfaceCount () const;
+
+	//
+	//  getVertexCount
+	//
+	//  Purpose: To determine the number of vertexes in the
+	//           specified frame.
+	//  Parameter(s):
+	//    <1> frame: The frame
+	//  Precondition(s):
+	//    <1> frame < getFrameCount()
+	//  Returns: The number of distinct vertexes in frame.
+	//  Side Effect: N/A
+	//
+	unsigned int getVertexCount (unsigned int frame) const;
+
+	//
+	//  getTriangleCount
+	//
+	//  Purpose: To determine the number of triangles in the
+	//           specified frame.
+	//  Parameter(s):
+	//    <1> frame: The frame
+	//  Precondition(s):
+	//    <1> frame < getFrameCount()
+	//  Returns: The number of triangles in frame.
+	//  Side Effect: N/A
+	//
+	unsigned int getTriangleCount (unsigned int frame) const;
+
+	//
+	//  getTriangleCount
+	//
+	//  Purpose: To determine the number of triangles drawn for
+	//           the specified frame at the specified level of
+	//           detail.
+	//  Parameter(s):
+	//    <1> frame: The frame
+	//    <2> level: The level of detail
+	//  Precondition(s):
+	//    <1> frame < getFrameCount()
+	//  Returns: The number of triangles in level of the surface
+	//           for frame.  If the surface has fewer levels,
+	//           its last level is used.
+	//  Side Effect: N/A
+	//
+	unsigned int getTriangleCount (unsigned int frame,
+	                               unsigned int level) const;
+
+	//
+	//  getLevelCount
+	//
+	//  Purpose: To determine the number of levels of detail for
+	//           the specified frame.
+	//  Parameter(s):
+	//    <1> frame: The frame
+	//  Precondition(s):
+	//    <1> frame < getFrameCount()
+	//  Returns: The number of levels of detail in the surface
+	//           for frame.  This is always at least 1.
+	//  Side Effect: N/A
+	//
+	unsigned int getLevelCount (unsigned int frame) const;
+
+	//
+	//  chooseLevel
+	//
+	//  Purpose: To choose the level of detail to draw the
+	//           specified frame at.
+	//  Parameter(s):
+	//    <1> frame: The frame
+	//    <2> view: The camera information
+	//    <3> center: The center of the model in world
+	//                coordinates
+	//    <4> radius: The radius of a sphere enclosing the model
+	//  Precondition(s):
+	//    <1> frame < getFrameCount()
+	//    <2> radius >= 0.0f
+	//  Returns: The simplest level of detail whose error would
+	//           not be visible.
+	//  Side Effect: N/A
+	//
+	unsigned int chooseLevel (unsigned int frame,
+	                          const LodView& view,
+	                          const ObjLibrary::Vector3& center,
+	                          float radius) const;
+
+	//
+	//  getMemoryUsage
+	//
+	//  Purpose: To determine how much memory is used to store
+	//           this AnimationModel.
+	//  Parameter(s): N/A
+	//  Precondition(s): N/A
+	//  Returns: The number of bytes used by the surfaces, the
+	//           positions, and the frame records, including the
+	//           buffer used for drawing.
+	//  Side Effect: N/A
+	//
+	size_t getMemoryUsage () const;
+
+	//
+	//  getDisplayTextureNames
+	//
+	//  Purpose: To determine which texture files will be used
+	//           when this AnimationModel is displayed.
+	//  Parameter(s): N/A
+	//  Precondition(s): N/A
+	//  Returns: The names of the texture files for all
+	//           surfaces, as returned by
+	//           CompiledModel::getDisplayTextureNames.  A name
+	//           may appear more than once.
+	//  Side Effect: N/A
+	//
+	std::vector<std::string> getDisplayTextureNames () const;
+
+	//
+	//  getFramePositions
+	//
+	//  Purpose: To calculate the vertex positions for the
+	//           specified frame in the form OpenGL uses.
+	//  Parameter(s):
+	//    <1> frame: The frame
+	//    <2> a_positions: The array to fill
+	//  Precondition(s):
+	//    <1> frame < getFrameCount()
+	//    <2> a_positions != NULL
+	//    <3> a_positions has space for getVertexCount(frame) * 3
+	//        values
+	//  Returns: N/A
+	//  Side Effect: a_positions is set to the x, y, and z
+	//               coordinates of each vertex of frame in turn.
+	//
+	void getFramePositions (unsigned int frame,
+	                        float* a_positions) const;
+
+	//
+	//  isBlendable
+	//
+	//  Purpose: To determine whether the specified frames can be
+	//           blended.
+	//  Parameter(s):
+	//    <1> frame0
+	//    <2> frame1: The frames
+	//  Precondition(s):
+	//    <1> frame0 < getFrameCount()
+	//    <2> frame1 < getFrameCount()
+	//  Returns: Whether frame0 and frame1 have the same surface.
+	//  Side Effect: N/A
+	//
+	bool isBlendable (unsigned int frame0,
+	                  unsigned int frame1) const;
+
+	//
+	//  getBlendedPositions
+	//
+	//  Purpose: To calculate the vertex positions part way
+	//           between the specified frames in the form OpenGL
+	//           uses.
+	//  Parameter(s):
+	//    <1> frame0
+	//    <2> frame1: The frames to blend
+	//    <3> fraction: How far to go from frame0 to frame1
+	//    <4> a_positions: The array to fill
+	//  Precondition(s):
+	//    <1> frame0 < getFrameCount()
+	//    <2> frame1 < getFrameCount()
+	//    <3> isBlendable(frame0, frame1)
+	//    <4> a_positions != NULL
+	//    <5> a_positions has space for getVertexCount(frame0) *
+	//        3 values
+	//  Returns: N/A
+	//  Side Effect: a_positions is set to the x, y, and z
+	//               coordinates of each vertex in turn,
+	//               interpolated linearly between frame0 and
+	//               frame1.  A fraction of 0.0f gives frame0 and
+	//               a fraction of 1.0f gives frame1.
+	//
+	void getBlendedPositions (unsigned int frame0,
+	                          unsigned int frame1,
+	                          float fraction,
+	                          float* a_positions) const;
+
+	//
+	//  addFrame
+	//
+	//  Purpose: To add a frame to the end of this
+	//           AnimationModel.
+	//  Parameter(s):
+	//    <1> model: The model for the frame
+	//  Precondition(s): N/A
+	//  Returns: N/A
+	//  Side Effect: If model has the same surface as an earlier
+	//               frame, that surface is shared.  Otherwise,
+	//               model is copied as a new surface.  The
+	//               positions of model are stored for the new
+	//               frame.
+	//
+	void addFrame (const CompiledModel& model);
+
+	//
+	//  generateLevels
+	//
+	//  Purpose: To calculate levels of detail for the surfaces
+	//           of this AnimationModel.
+	//  Parameter(s): N/A
+	//  Precondition(s): N/A
+	//  Returns: N/A
+	//  Side Effect: CompiledModel::generateLevels is called for
+	//               each surface that only has level 0.
+	//
+	void generateLevels ();
+
+	//
+	//  loadTextures
+	//
+	//  Purpose: To load the textures used to display this
+	//           AnimationModel.
+	//  Parameter(s): N/A
+	//  Precondition(s): N/A
+	//  Returns: N/A
+	//  Side Effect: The textures for all surfaces are loaded if
+	//               they have not been already.
+	//
+	void loadTextures ();
+
+	//
+	//  draw
+	//
+	//  Purpose: To display the specified frame.
+	//  Parameter(s):
+	//    <1> frame: The frame
+	//  Precondition(s):
+	//    <1> frame < getFrameCount()
+	//    <2> !ObjLibrary::Material::isMaterialActive()
+	//    <3> loadTextures() has been called
+	//  Returns: N/A
+	//  Side Effect: The positions for frame are calculated and
+	//               it is drawn with vertex arrays.
+	//
+	void draw (unsigned int frame) const;
+
+	//
+	//  draw
+	//
+	//  Purpose: To display a blend of the specified frames.
+	//  Parameter(s):
+	//    <1> frame0
+	//    <2> frame1: The frames to blend
+	//    <3> fraction: How far to go from frame0 to frame1
+	//    <4> level: The level of detail
+	//  Precondition(s):
+	//    <1> frame0 < getFrameCount()
+	//    <2> frame1 < getFrameCount()
+	//    <3> !ObjLibrary::Material::isMaterialActive()
+	//    <4> loadTextures() has been called
+	//  Returns: N/A
+	//  Side Effect: The blended positions are calculated and
+	//               drawn with vertex arrays.  If the frames
+	//               cannot be blended, whichever is nearer is
+	//               drawn instead.  If the surface drawn has
+	//               fewer levels than level, its last level is
+	//               used.
+	//
+	void draw (unsigned int frame0,
+	           unsigned int frame1,
+	           float fraction,
+	           unsigned int level) const;
+
+private:
+	//
+	//  Frame
+	//
+	//  A record of where the positions for one frame are
+	//    stored.  The x, y, and z arrays each have
+	//    m_vertex_count values and start at m_first,
+	//    m_first + m_vertex_count, and m_first +
+	//    m_vertex_count * 2.  For quantized positions, each
+	//    coordinate is ma_minimum + value * ma_step.
+	//
+	struct Frame
+	{
+		unsigned int m_surface;
+		unsigned int m_first;
+		unsigned int m_vertex_count;
+		float ma_minimum[3];
+		float ma_step[3];
+	};
+
+	//
+	//  Helper Function: invariant
+	//
+	//  Purpose: To determine if the class invariant is true.
+	//  Parameter(s): N/A
+	//  Precondition(s): N/A
+	//  Returns: Whether the class invariant is true.
+	//  Side Effect: N/A
+	//
+	bool invariant () const;
+
+private:
+	bool m_is_quantized;
+	std::vector<CompiledModel> mv_surfaces;
+	std::vector<Frame> mv_frames;
+	std::vector<float> mv_positions;
+	std::vector<uint16_t> mv_quantized;
+
+	// used only by draw
+	mutable std::vector<float> mv_draw_positions;
+};
+
+
+
+#endif
@@ -0,0 +1,577 @@
+//
+//  AssetLoader.cpp
+//
+
+#include <cassert>
+#include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <mutex>
+#include <set>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "ObjLibrary/ObjModel.h"
+#include "ObjLibrary/DisplayList.h"
+#include "ObjLibrary/TextureBmp.h"
+#include "ObjLibrary/TextureManager.h"
+#include "ObjLibrary/ObjStringParsing.h"
+
+#include "TraceRecorder.h"
+#include "Renderer.h"
+#include "CompiledModel.h"
+#include "AnimationModel.h"
+#include "LodModel.h"
+#include "AssetLoader.h"
+
+using namespace std;
+using namespace ObjLibrary;
+
+
+
+AssetLoader :: Asset :: Asset (Type type, const string& filename)
+		: m_type(type)
+		, m_filename(filename)
+		, m_on_loaded()
+		, m_on_lod_loaded()
+		, m_on_animation_loaded()
+		, mv_frame_filenames()
+		, mp_compiled()
+		, mp_obj_model()
+		, mp_animation()
+		, mp_image()
+		, mv_texture_names()
+		, m_log()
+		, m_queued_time(0.0)
+		, m_read_ms(0.0)
+		, m_upload_ms(0.0)
+		, m_ready_ms(0.0)
+{
+	assert(filename != "");
+}
+
+AssetLoader :: Asset :: ~Asset ()
+{
+	// defined here, where the owned types are complete
+}
+
+
+
+AssetLoader :: AssetLoader ()
+		: m_start_time(chrono::steady_clock::now())
+		, mv_workers()
+		, m_mutex()
+		, m_queue_changed()
+		, m_finished_changed()
+		, m_queue()
+		, m_finished()
+		, m_claimed_textures()
+		, m_unfinished_count(0)
+		, m_is_stopping(false)
+		, m_uploaded_textures()
+		, mv_waiting_models()
+		, mv_done()
+{
+	// leave a processor for the thread adding things to OpenGL
+	unsigned int processor_count = thread::hardware_concurrency();
+	if(processor_count >= 2)
+		startWorkers(processor_count - 1);
+	else
+		startWorkers(1);
+
+	assert(invariant());
+}
+
+AssetLoader :: AssetLoader (unsigned int worker_count)
+		: m_start_time(chrono::steady_clock::now())
+		, mv_workers()
+		, m_mutex()
+		, m_queue_changed()
+		, m_finished_changed()
+		, m_queue()
+		, m_finished()
+		, m_claimed_textures()
+		, m_unfinished_count(0)
+		, m_is_stopping(false)
+		, m_uploaded_textures()
+		, mv_waiting_models()
+		, mv_done()
+{
+	assert(worker_count >= 1);
+
+	startWorkers(worker_count);
+
+	assert(invariant());
+}
+
+AssetLoader :: ~AssetLoader ()
+{
+	{
+		lock_guard<mutex> lock(m_mutex);
+		m_is_stopping = true;
+	}
+	m_queue_changed.notify_all();
+	for(unsigned int i = 0; i < mv_workers.size(); i++)
+		mv_workers[i].join();
+
+	for(unsigned int i = 0; i < m_queue.size(); i++)
+		delete m_queue[i];
+	for(unsigned int i = 0; i < m_finished.size(); i++)
+		delete m_finished[i];
+	for(unsigned int i = 0; i < mv_waiting_models.size(); i++)
+		delete mv_waiting_models[i];
+}
+
+
+
+unsigned int AssetLoader :: getWorkerCount () const
+{
+	return mv_workers.size();
+}
+
+void AssetLoader :: printTimes (ostream& r_out) const
+{
+	r_out << fixed << setprecision(2);
+	r_out << setw(36) << left << "Asset" << right
+	      << setw(12) << "Read (ms)"
+	      << setw(12) << "Upload (ms)"
+	      << setw(12) << "Ready (ms)" << endl;
+
+	double total_read_ms   = 0.0;
+	double total_upload_ms = 0.0;
+	double last_ready_ms   = 0.0;
+	for(unsigned int i = 0; i < mv_done.size(); i++)
+	{
+		const Asset& asset = *(mv_done[i]);
+		r_out << setw(36) << left << asset.m_filename << right
+		      << setw(12) << asset.m_read_ms
+		      << setw(12) << asset.m_upload_ms
+		      << setw(12) << asset.m_ready_ms << endl;
+
+		total_read_ms   += asset.m_read_ms;
+		total_upload_ms += asset.m_upload_ms;
+		if(asset.m_queued_time + asset.m_ready_ms > last_ready_ms)
+			last_ready_ms = asset.m_queued_time + asset.m_ready_ms;
+	}
+
+	r_out << setw(36) << left << "Total" << right
+	      << setw(12) << total_read_ms
+	      << setw(12) << total_upload_ms
+	      << setw(12) << last_ready_ms << endl;
+	r_out << mv_done.size() << " assets read on " << getWorkerCount() << " worker threads" << endl;
+	r_out.unsetf(ios::floatfield);
+}
+
+void AssetLoader :: addModel (const string& obj_filename,
+                              const ModelCallback& on_loaded)
+{
+	assert(obj_filename != "");
+	assert(on_loaded);
+
+	Asset* p_asset = new Asset(Asset::MODEL, obj_filename);
+	p_asset->m_on_loaded   = on_loaded;
+	p_asset->m_queued_time = getTime();
+
+	{
+		lock_guard<mutex> lock(m_mutex);
+		m_queue.push_back(p_asset);
+		m_unfinished_count++;
+		assert(invariant());
+	}
+	m_queue_changed.notify_one();
+}
+
+void AssetLoader :: addModel (const string& obj_filename,
+                              DisplayList& r_list,
+                              unsigned int& r_vertex_count)
+{
+	assert(obj_filename != "");
+
+	addModel(obj_filename, [&r_list, &r_vertex_count] (const DisplayList& list, unsigned int vertex_count)
+	{
+		r_list         = list;
+		r_vertex_count = vertex_count;
+	});
+}
+
+void AssetLoader :: addLodModel (const string& obj_filename,
+                                 const LodModelCallback& on_loaded)
+{
+	assert(obj_filename != "");
+	assert(on_loaded);
+
+	Asset* p_asset = new Asset(Asset::MODEL, obj_filename);
+	p_asset->m_on_lod_loaded = on_loaded;
+	p_asset->m_queued_time   = getTime();
+
+	{
+		lock_guard<mutex> lock(m_mutex);
+		m_queue.push_back(p_asset);
+		m_unfinished_count++;
+		assert(invariant());
+	}
+	m_queue_changed.notify_one();
+}
+
+void AssetLoader :: addLodModel (const string& obj_filename,
+                                 LodModel& r_model)
+{
+	assert(obj_filename != "");
+
+	addLodModel(obj_filename, [&r_model] (const LodModel& model)
+	{
+		r_model = model;
+	});
+}
+
+void AssetLoader :: addAnimation (const vector<string>& frame_filenames,
+                                  bool is_quantized,
+                                  const AnimationCallback& on_loaded)
+{
+	assert(!frame_filenames.empty());
+	assert(on_loaded);
+
+	stringstream name;
+	name << frame_filenames[0] << " +" << (frame_filenames.size() - 1);
+
+	Asset* p_asset = new Asset(Asset::ANIMATION, name.str());
+	p_asset->m_on_animation_loaded = on_loaded;
+	p_asset->mv_frame_filenames    = frame_filenames;
+	p_asset->mp_animation.reset(new AnimationModel(is_quantized));
+	p_asset->m_queued_time         = getTime();
+
+	{
+		lock_guard<mutex> lock(m_mutex);
+		m_queue.push_back(p_asset);
+		m_unfinished_count++;
+		assert(invariant());
+	}
+	m_queue_changed.notify_one();
+}
+
+void AssetLoader :: finish ()
+{
+	TRACE_SCOPE("Finish loading");
+	unique_lock<mutex> lock(m_mutex);
+	while(true)
+	{
+		m_finished_changed.wait(lock, [this] ()
+		{
+			return !m_finished.empty() || m_unfinished_count == 0;
+		});
+		if(m_finished.empty())
+			break;
+
+		Asset* p_asset = m_finished.front();
+		m_finished.pop_front();
+		lock.unlock();
+
+		if(p_asset->m_type == Asset::TEXTURE)
+		{
+			upload(*p_asset);
+
+			// models waiting for this texture may be ready now
+			for(unsigned int i = 0; i < mv_waiting_models.size(); )
+			{
+				if(isTexturesUploaded(*mv_waiting_models[i]))
+				{
+					Asset* p_model = mv_waiting_models[i];
+					mv_waiting_models.erase(mv_waiting_models.begin() + i);
+					upload(*p_model);
+				}
+				else
+					i++;
+			}
+		}
+		else if(isTexturesUploaded(*p_asset))
+			upload(*p_asset);
+		else
+			mv_waiting_models.push_back(p_asset);
+
+		lock.lock();
+	}
+	assert(invariant());
+	lock.unlock();
+
+	// should not happen, but never lose a model
+	for(unsigned int i = 0; i < mv_waiting_models.size(); i++)
+		upload(*mv_waiting_models[i]);
+	mv_waiting_models.clear();
+}
+
+
+
+void AssetLoader :: startWorkers (unsigned int worker_count)
+{
+	assert(worker_count >= 1);
+	assert(mv_workers.empty());
+
+	for(unsigned int i = 0; i < worker_count; i++)
+		mv_workers.push_back(thread(&AssetLoader::runWorker, this));
+}
+
+void AssetLoader :: runWorker ()
+{
+	TraceRecorder::setThreadName("Asset loader");
+
+	unique_lock<mutex> lock(m_mutex);
+	while(true)
+	{
+		m_queue_changed.wait(lock, [this] ()
+		{
+			return m_is_stopping || !m_queue.empty();
+		});
+		if(m_is_stopping)
+			return;
+
+		Asset* p_asset = m_queue.front();
+		m_queue.pop_front();
+		lock.unlock();
+
+		double start_time = getTime();
+		{
+			TRACE_SCOPE("Read asset");
+			if(p_asset->m_type == Asset::MODEL)
+				readModel(*p_asset);
+			else if(p_asset->m_type == Asset::ANIMATION)
+				readAnimation(*p_asset);
+			else
+				readTexture(*p_asset);
+		}
+		p_asset->m_read_ms = getTime() - start_time;
+
+		lock.lock();
+		m_finished.push_back(p_asset);
+		assert(m_unfinished_count > 0);
+		m_unfinished_count--;
+		m_finished_changed.notify_one();
+	}
+}
+
+void AssetLoader :: readModel (Asset& r_asset)
+{
+	assert(r_asset.m_type == Asset::MODEL);
+
+	stringstream log;
+	readModelFile(r_asset.m_filename, log, true, r_asset.mp_compiled, r_asset.mp_obj_model);
+	r_asset.m_log = log.str();
+
+	if(!r_asset.mp_compiled)
+		return;  // ObjModel loads its own textures when uploaded
+
+	// older compiled files and OBJ files have no levels
+	if(r_asset.m_on_lod_loaded && r_asset.mp_compiled->getLevelCount() == 1)
+		r_asset.mp_compiled->generateLevels();
+
+	claimTextures(r_asset, r_asset.mp_compiled->getDisplayTextureNames());
+}
+
+void AssetLoader :: readAnimation (Asset& r_asset)
+{
+	assert(r_asset.m_type == Asset::ANIMATION);
+	assert(r_asset.mp_animation);
+
+	stringstream log;
+	for(unsigned int i = 0; i < r_asset.mv_frame_filenames.size(); i++)
+	{
+		unique_ptr<CompiledModel> p_compiled;
+		unique_ptr<ObjModel> p_obj_model;
+		// welding depends on the positions, so frames could stop matching
+		readModelFile(r_asset.mv_frame_filenames[i], log, false, p_compiled, p_obj_model);
+
+		// an animation can only draw faces
+		if(!p_compiled)
+		{
+			assert(p_obj_model);
+			p_compiled.reset(new CompiledModel(*p_obj_model));
+			p_compiled->optimize(false);
+		}
+		r_asset.mp_animation->addFrame(*p_compiled);
+	}
+	r_asset.mp_animation->generateLevels();
+	r_asset.m_log = log.str();
+
+	claimTextures(r_asset, r_asset.mp_animation->getDisplayTextureNames());
+}
+
+void AssetLoader :: readModelFile (const string& obj_filename,
+                                   ostream& r_log,
+                                   bool is_weld,
+                                   unique_ptr<CompiledModel>& rp_compiled,
+                                   unique_ptr<ObjModel>& rp_obj_model)
+{
+	assert(obj_filename != "");
+
+	rp_compiled.reset();
+	rp_obj_model.reset();
+
+	if(CompiledModel::isCompiledFileCurrent(obj_filename))
+	{
+		string compiled_filename = CompiledModel::getCompiledFilename(obj_filename);
+		rp_compiled.reset(new CompiledModel());
+		if(!rp_compiled->load(compiled_filename))
+		{
+			r_log << "Could not load \"" << compiled_filename << "\": loading OBJ file instead" << endl;
+			rp_compiled.reset();
+		}
+	}
+
+	if(!rp_compiled)
+	{
+		// MtlLibraryManager is thread-safe, so this may load MTL files
+		rp_obj_model.reset(new ObjModel());
+		rp_obj_model->load(obj_filename, r_log);
+
+		// convert here so the main thread only has to upload it
+		if(CompiledModel::isCompilable(*rp_obj_model))
+		{
+			rp_compiled.reset(new CompiledModel(*rp_obj_model));
+			rp_compiled->optimize(is_weld);
+			rp_obj_model.reset();
+		}
+	}
+}
+
+void AssetLoader :: claimTextures (Asset& r_asset,
+                                   const vector<string>& texture_names)
+{
+	bool is_any_queued = false;
+	for(unsigned int i = 0; i < texture_names.size(); i++)
+	{
+		string lower = ObjStringParsing::toLowercase(texture_names[i]);
+		if(!ObjStringParsing::endsWith(lower, ".bmp") || TextureManager::isLoaded(lower))
+			continue;
+
+		r_asset.mv_texture_names.push_back(lower);
+
+		lock_guard<mutex> lock(m_mutex);
+		if(m_claimed_textures.insert(lower).second)
+		{
+			Asset* p_texture = new Asset(Asset::TEXTURE, texture_names[i]);
+			p_texture->m_queued_time = getTime();
+
+			// textures go first, because models are waiting for them
+			m_queue.push_front(p_texture);
+			m_unfinished_count++;
+			is_any_queued = true;
+		}
+	}
+	if(is_any_queued)
+		m_queue_changed.notify_all();
+}
+
+void AssetLoader :: readTexture (Asset& r_asset)
+{
+	assert(r_asset.m_type == Asset::TEXTURE);
+
+	stringstream log;
+	r_asset.mp_image.reset(new TextureBmp(r_asset.m_filename, log));
+	if(r_asset.mp_image->isBad())
+	{
+		// the TextureManager will try again and print the same error
+		r_asset.mp_image.reset();
+	}
+	else
+	{
+		// calculate the mipmaps here so the main thread only copies them
+		if(r_asset.mp_image->isMipmapsPossible())
+			r_asset.mp_image->generateMipmaps();
+		r_asset.m_log = log.str();
+	}
+}
+
+bool AssetLoader :: isTexturesUploaded (const Asset& asset) const
+{
+	for(unsigned int i = 0; i < asset.mv_texture_names.size(); i++)
+		if(m_uploaded_textures.find(asset.mv_texture_names[i]) == m_uploaded_textures.end())
+			return false;
+	return true;
+}
+
+void AssetLoader :: upload (Asset& r_asset)
+{
+	TRACE_SCOPE("Upload asset");
+
+	if(!r_asset.m_log.empty())
+		cerr << r_asset.m_log;
+
+	double start_time = getTime();
+	if(r_asset.m_type == Asset::TEXTURE)
+	{
+		if(r_asset.mp_image && !TextureManager::isLoaded(r_asset.m_filename))
+			TextureManager::add(*r_asset.mp_image, r_asset.m_filename);
+		m_uploaded_textures.insert(ObjStringParsing::toLowercase(r_asset.m_filename));
+	}
+	else if(r_asset.m_type == Asset::ANIMATION)
+	{
+		assert(r_asset.mp_animation);
+		r_asset.mp_animation->loadTextures();
+		r_asset.m_on_animation_loaded(*r_asset.mp_animation);
+	}
+	else if(r_asset.m_on_lod_loaded)
+	{
+		LodModel model;
+		if(r_asset.mp_compiled)
+		{
+			for(unsigned int level = 0; level < r_asset.mp_compiled->getLevelCount(); level++)
+				model.addLevel(r_asset.mp_compiled->getDisplayList(level),
+				               r_asset.mp_compiled->getTriangleCount(level) * 3,
+				               r_asset.mp_compiled->getLevelError(level));
+		}
+		else
+		{
+			assert(r_asset.mp_obj_model);
+			model.addLevel(r_asset.mp_obj_model->getDisplayList(),
+			               Renderer::countVertexes(*r_asset.mp_obj_model),
+			               0.0f);
+		}
+		r_asset.m_on_lod_loaded(model);
+	}
+	else
+	{
+		DisplayList list;
+		unsigned int vertex_count = 0;
+		if(r_asset.mp_compiled)
+		{
+			list         = r_asset.mp_compiled->getDisplayList();
+			vertex_count = r_asset.mp_compiled->getTriangleCount() * 3;
+		}
+		else
+		{
+			assert(r_asset.mp_obj_model);
+			list         = r_asset.mp_obj_model->getDisplayList();
+			vertex_count = Renderer::countVertexes(*r_asset.mp_obj_model);
+		}
+		r_asset.m_on_loaded(list, vertex_count);
+	}
+	double end_time = getTime();
+	r_asset.m_upload_ms = end_time - start_time;
+	r_asset.m_ready_ms  = end_time - r_asset.m_queued_time;
+
+	// keep only the times
+	r_asset.mp_compiled.reset();
+	r_asset.mp_obj_model.reset();
+	r_asset.mp_animation.reset();
+	r_asset.mp_image.reset();
+	r_asset.m_on_loaded = nullptr;
+	r_asset.m_on_lod_loaded = nullptr;
+	r_asset.m_on_animation_loaded = nullptr;
+	mv_done.push_back(unique_ptr<Asset>(&r_asset));
+}
+
+double AssetLoader :: getTime () const
+{
+	return chrono::duration<double, milli>(chrono::steady_clock::now() - m_start_time).count();
+}
+
+bool AssetLoader :: invariant () const
+{
+	if(mv_workers.empty()) return false;
+	if(m_unfinished_count < m_queue.size()) return false;
+	return true;
+}
@@ -0,0 +1,543 @@
+//
+//  AssetLoader.h
+//
+//  A module to load models on worker threads and add them to
+//    OpenGL on the main thread.
+//
+
+#ifndef ASSET_LOADER_H
+#define ASSET_LOADER_H
+
+#include <cassert>
+#include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <iostream>
+#include <memory>
+#include <mutex>
+#include <set>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "ObjLibrary/DisplayList.h"
+
+namespace ObjLibrary
+{
+	class ObjModel;
+	class TextureBmp;
+}
+class CompiledModel;
+class AnimationModel;
+class LodModel;
+
+
+
+//
+//  AssetLoader
+//
+//  A class to load a batch of models in parallel.  Models are
+//    queued with addModel or addLodModel, and animations with
+//    addAnimation,
+//    and a pool of worker threads reads them, using the
+//    compiled file if it is up to date and parsing the OBJ and
+//    MTL files otherwise.  The worker
+//    threads also decode the BMP textures the models use and
+//    calculate their mipmaps.
+//
+//  OpenGL may only be used from the thread that owns the
+//    context, so display lists and textures are created when
+//    that thread calls finish.  finish hands out each model as
+//    soon as it and its textures are ready, so uploading
+//    overlaps with the parsing of later models.  The callback
+//    for a model is called on the same thread.
+//
+//  The time spent on each asset is recorded.  After finish
+//    returns, the times can be printed with printTimes.
+//
+//  An AssetLoader cannot be copied.  The worker threads are
+//    stopped when the AssetLoader is destroyed.
+//
+//  Class Invariant:
+//    <1> !mv_workers.empty()
+//    <2> m_unfinished_count >= m_queue.size()
+//
+class AssetLoader
+{
+public:
+	//
+	//  ModelCallback
+	//
+	//  The type of function called when a model has been
+	//    loaded.  The parameters are the display list for the
+	//    model and the number of triangle vertexes it draws.
+	//
+	typedef std::function<void (const ObjLibrary::DisplayList& list,
+	                            unsigned int vertex_count)> ModelCallback;
+
+	//
+	//  AnimationCallback
+	//
+	//  The type of function called when an animation has been
+	//    loaded.  The parameter is the animation, which is
+	//    destroyed after the function returns.
+	//
+	typedef std::function<void (const AnimationModel& model)> AnimationCallback;
+
+	//
+	//  LodModelCallback
+	//
+	//  The type of function called when a model with levels of
+	//    detail has been loaded.  The parameter is the model.
+	//
+	typedef std::function<void (const LodModel& model)> LodModelCallback;
+
+public:
+	//
+	//  Default Constructor
+	//
+	//  Purpose: To create a new AssetLoader with one worker
+	//           thread for each processor after the first.
+	//  Parameter(s): N/A
+	//  Precondition(s): N/A
+	//  Returns: N/A
+	//  Side Effect: A new AssetLoader is created and its worker
+	//               threads are started.  There is always at
+	//               least one worker thread.
+	//
+	AssetLoader ();
+
+	//
+	//  Constructor
+	//
+	//  Purpose: To create a new AssetLoader with the specified
+	//           number of worker threads.
+	//  Parameter(s):
+	//    <1> worker_count: The number of worker threads
+	//  Precondition(s):
+	//    <1> worker_count >= 1
+	//  Returns: N/A
+	//  Side Effect: A new AssetLoader is created and its worker
+	//               threads are started.
+	//
+	AssetLoader (unsigned int worker_count);
+
+	//
+	//  Destructor
+	//
+	//  Purpose: To safely destroy this AssetLoader.
+	//  Parameter(s): N/A
+	//  Precondition(s): N/A
+	//  Returns: N/A
+	//  Side Effect: The worker threads are stopped.  Any assets
+	//               still queued are discarded without their
+	//               callbacks being called.
+	//
+	~AssetLoader ();
+
+	//
+	//  getWorkerCount
+	//
+	//  Purpose: To determine the number of worker threads used
+	//           by this AssetLoader.
+	//  Parameter(s): N/A
+	//  Precondition(s): N/A
+	//  Returns: The number of worker threads.
+	//  Side Effect: N/A
+	//
+	unsigned int getWorkerCount () const;
+
+	//
+	//  printTimes
+	//
+	//  Purpose: To print the time spent on each asset that has
+	//           been finished.
+	//  Parameter(s):
+	//    <1> r_out: The stream to print to
+	//  Precondition(s): N/A
+	//  Returns: N/A
+	//  Side Effect: One line is printed to r_out for each
+	//               model, animation, and texture, in the order
+	//               they were
+	//               finished, showing the time spent reading
+	//               it on a worker thread, the time spent adding
+	//               it to OpenGL, and the time from when it was
+	//               queued until it was ready.  A total line is
+	//               printed after them.
+	//
+	void printTimes (std::ostream& r_out) const;
+
+	//
+	//  addModel
+	//
+	//  Purpose: To queue the specified model to be loaded.
+	//  Parameter(s):
+	//    <1> obj_filename: The name of the OBJ file
+	//    <2> on_loaded: The function to call when the model
+	//                   has been loaded
+	//  Precondition(s):
+	//    <1> obj_filename != ""
+	//    <2> on_loaded
+	//  Returns: N/A
+	//  Side Effect: The model is queued.  on_loaded will be
+	//               called during the next call to finish.
+	//
+	void addModel (const std::string& obj_filename,
+	               const ModelCallback& on_loaded);
+
+	//
+	//  addModel
+	//
+	//  Purpose: To queue the specified model to be loaded into
+	//           the specified variables.
+	//  Parameter(s):
+	//    <1> obj_filename: The name of the OBJ file
+	//    <2> r_list: The display list to set
+	//    <3> r_vertex_count: The vertex count to set
+	//  Precondition(s):
+	//    <1> obj_filename != ""
+	//  Returns: N/A
+	//  Side Effect: The model is queued.  r_list and
+	//               r_vertex_count will be set during the next
+	//               call to finish.  They must not be destroyed
+	//               before then.
+	//
+	void addModel (const std::string& obj_filename,
+	               ObjLibrary::DisplayList& r_list,
+	               unsigned int& r_vertex_count);
+
+	//
+	//  addLodModel
+	//
+	//  Purpose: To queue the specified model to be loaded with
+	//           levels of detail.
+	//  Parameter(s):
+	//    <1> obj_filename: The name of the OBJ file
+	//    <2> on_loaded: The function to call when the model
+	//                   has been loaded
+	//  Precondition(s):
+	//    <1> obj_filename != ""
+	//    <2> on_loaded
+	//  Returns: N/A
+	//  Side Effect: The model is queued.  on_loaded will be
+	//               called during the next call to finish.  The
+	//               levels stored in the compiled file are used
+	//               if there are any.  Otherwise, they are
+	//               calculated on a worker thread.
+	//
+	void addLodModel (const std::string& obj_filename,
+	                  const LodModelCallback& on_loaded);
+
+	//
+	//  addLodModel
+	//
+	//  Purpose: To queue the specified model to be loaded with
+	//           levels of detail into the specified variable.
+	//  Parameter(s):
+	//    <1> obj_filename: The name of the OBJ file
+	//    <2> r_model: The model to set
+	//  Precondition(s):
+	//    <1> obj_filename != ""
+	//  Returns: N/A
+	//  Side Effect: The model is queued.  r_model will be set
+	//               during the next call to finish.  It must
+	//               not be destroyed before then.
+	//
+	void addLodModel (const std::string& obj_filename,
+	                  LodModel& r_model);
+
+	//
+	//  addAnimation
+	//
+	//  Purpose: To queue the specified animation to be loaded.
+	//  Parameter(s):
+	//    <1> frame_filenames: The names of the OBJ files for the
+	//                         frames, in order
+	//    <2> is_quantized: Whether the positions should be
+	//                      stored as 16-bit integers
+	//    <3> on_loaded: The function to call when the animation
+	//                   has been loaded
+	//  Precondition(s):
+	//    <1> !frame_filenames.empty()
+	//    <2> frame_filenames[i] != ""
+	//                         WHERE 0 <= i < frame_filenames.size()
+	//    <3> on_loaded
+	//  Returns: N/A
+	//  Side Effect: The animation is queued.  on_loaded will be
+	//               called during the next call to finish.  The
+	//               frames are read on one worker thread and
+	//               combined into one AnimationModel, and levels
+	//               of detail are calculated for it.  Point sets
+	//               and polylines in the frames are ignored.
+	//
+	void addAnimation (const std::vector<std::string>& frame_filenames,
+	                   bool is_quantized,
+	                   const AnimationCallback& on_loaded);
+
+	//
+	//  finish
+	//
+	//  Purpose: To wait until all queued models have been
+	//           loaded.
+	//  Parameter(s): N/A
+	//  Precondition(s):
+	//    <1> This function is called from the thread that owns
+	//        the OpenGL context
+	//  Returns: N/A
+	//  Side Effect: Each model and texture is added to OpenGL
+	//               as soon as it is ready, and the callback for
+	//               each model is called.  Any loading errors
+	//               are printed to standard error.
+	//
+	void finish ();
+
+private:
+	//
+	//  Asset
+	//
+	//  A record of one model, animation, or texture moving
+	//    through the pipeline.  For a model or texture, exactly
+	//    one of mp_compiled, mp_obj_model, and mp_image is set
+	//    once the asset has been read, unless reading failed.
+	//    For an animation, mp_animation is set when the asset
+	//    is queued and filled in when it is read.
+	//
+	struct Asset
+	{
+		enum Type
+		{
+			MODEL,
+			ANIMATION,
+			TEXTURE
+		};
+
+		Type m_type;
+		std::string m_filename;
+		ModelCallback m_on_loaded;
+		LodModelCallback m_on_lod_loaded;
+		AnimationCallback m_on_animation_loaded;
+		std::vector<std::string> mv_frame_filenames;
+		std::unique_ptr<CompiledModel> mp_compiled;
+		std::unique_ptr<ObjLibrary::ObjModel> mp_obj_model;
+		std::unique_ptr<AnimationModel> mp_animation;
+		std::unique_ptr<ObjLibrary::TextureBmp> mp_image;
+		std::vector<std::string> mv_texture_names;
+		std::string m_log;
+		double m_queued_time;
+		double m_read_ms;
+		double m_upload_ms;
+		double m_ready_ms;
+
+		Asset (Type type, const std::string& filename);
+		~Asset ();
+	};
+
+	//
+	//  Copy Constructor
+	//  Assignment Operator
+	//
+	//  These functions have intentionally not been implemented
+	//    because the worker threads refer to this AssetLoader.
+	//
+	AssetLoader (const AssetLoader& original);
+	AssetLoader& operator= (const AssetLoader& original);
+
+	//
+	//  Helper Function: startWorkers
+	//
+	//  Purpose: To start the worker threads.
+	//  Parameter(s):
+	//    <1> worker_count: The number of worker threads
+	//  Precondition(s):
+	//    <1> worker_count >= 1
+	//    <2> mv_workers.empty()
+	//  Returns: N/A
+	//  Side Effect: worker_count worker threads are started.
+	//
+	void startWorkers (unsigned int worker_count);
+
+	//
+	//  Helper Function: runWorker
+	//
+	//  Purpose: To run one worker thread.
+	//  Parameter(s): N/A
+	//  Precondition(s): N/A
+	//  Returns: N/A
+	//  Side Effect: Assets are taken from the queue, read, and
+	//               moved to the finished list until this
+	//               AssetLoader is destroyed.
+	//
+	void runWorker ();
+
+	//
+	//  Helper Function: readModel
+	//
+	//  Purpose: To read the specified model asset.
+	//  Parameter(s):
+	//    <1> r_asset: The model asset
+	//  Precondition(s):
+	//    <1> r_asset.m_type == Asset::MODEL
+	//  Returns: N/A
+	//  Side Effect: The model is read from its compiled file or
+	//               its OBJ file.  Any textures it uses that no
+	//               other asset has claimed are queued.
+	//
+	void readModel (Asset& r_asset);
+
+	//
+	//  Helper Function: readAnimation
+	//
+	//  Purpose: To read the specified animation asset.
+	//  Parameter(s):
+	//    <1> r_asset: The animation asset
+	//  Precondition(s):
+	//    <1> r_asset.m_type == Asset::ANIMATION
+	//    <2> r_asset.mp_animation
+	//  Returns: N/A
+	//  Side Effect: Each frame is read from its compiled file or
+	//               its OBJ file and added to the animation.
+	//               Any textures it uses that no other asset has
+	//               claimed are queued.
+	//
+	void readAnimation (Asset& r_asset);
+
+	//
+	//  Helper Function: readModelFile
+	//
+	//  Purpose: To read the specified model file.
+	//  Parameter(s):
+	//    <1> obj_filename: The name of the OBJ file
+	//    <2> r_log: The stream to write loading errors to
+	//    <3> is_weld: Whether a model converted from the OBJ
+	//                 file should have identical vertexes merged
+	//    <4> rp_compiled: The compiled model to set
+	//    <5> rp_obj_model: The OBJ model to set
+	//  Precondition(s):
+	//    <1> obj_filename != ""
+	//  Returns: N/A
+	//  Side Effect: If the compiled file for obj_filename is up
+	//               to date, it is loaded into rp_compiled.
+	//               Otherwise, obj_filename is loaded into
+	//               rp_obj_model and converted into
+	//               rp_compiled if that loses nothing, and
+	//               rp_compiled is optimized as the
+	//               ModelCompiler would.  Exactly one of
+	//               rp_compiled and rp_obj_model is set.
+	//
+	void readModelFile (const std::string& obj_filename,
+	                    std::ostream& r_log,
+	                    bool is_weld,
+	                    std::unique_ptr<CompiledModel>& rp_compiled,
+	                    std::unique_ptr<ObjLibrary::ObjModel>& rp_obj_model);
+
+	//
+	//  Helper Function: claimTextures
+	//
+	//  Purpose: To queue the specified textures for the
+	//           specified asset.
+	//  Parameter(s):
+	//    <1> r_asset: The model or animation asset
+	//    <2> texture_names: The names of the texture files
+	//  Precondition(s): N/A
+	//  Returns: N/A
+	//  Side Effect: Each BMP texture that is not loaded is
+	//               recorded in r_asset, so it is uploaded only
+	//               after them.  Any that no other asset has
+	//               claimed are queued.
+	//
+	void claimTextures (Asset& r_asset,
+	                    const std::vector<std::string>& texture_names);
+
+	//
+	//  Helper Function: readTexture
+	//
+	//  Purpose: To decode the specified texture asset.
+	//  Parameter(s):
+	//    <1> r_asset: The texture asset
+	//  Precondition(s):
+	//    <1> r_asset.m_type == Asset::TEXTURE
+	//  Returns: N/A
+	//  Side Effect: The texture is decoded into memory and its
+	//               mipmaps are calculated.
+	//
+	void readTexture (Asset& r_asset);
+
+	//
+	//  Helper Function: isTexturesUploaded
+	//
+	//  Purpose: To determine whether all the textures used by
+	//           the specified model asset have been uploaded.
+	//  Parameter(s):
+	//    <1> asset: The model asset
+	//  Precondition(s): N/A
+	//  Returns: Whether every texture for asset has been added
+	//           to the TextureManager or has failed to load.
+	//  Side Effect: N/A
+	//
+	bool isTexturesUploaded (const Asset& asset) const;
+
+	//
+	//  Helper Function: upload
+	//
+	//  Purpose: To add the specified asset to OpenGL.
+	//  Parameter(s):
+	//    <1> r_asset: The asset
+	//  Precondition(s):
+	//    <1> This function is called from the thread that owns
+	//        the OpenGL context
+	//  Returns: N/A
+	//  Side Effect: A texture is added to the TextureManager, a
+	//               display list is created for a model, or the
+	//               textures for an animation are loaded, and the
+	//               callback for a model or animation is called.  The time taken is
+	//               recorded in r_asset.
+	//
+	void upload (Asset& r_asset);
+
+	//
+	//  Helper Function: getTime
+	//
+	//  Purpose: To determine the time since this AssetLoader
+	//           was created.
+	//  Parameter(s): N/A
+	//  Precondition(s): N/A
+	//  Returns: The time in milliseconds.
+	//  Side Effect: N/A
+	//
+	double getTime () const;
+
+	//
+	//  Helper Function: invariant
+	//
+	//  Purpose: To determine if the class invariant is true.
+	//  Parameter(s): N/A
+	//  Precondition(s): N/A
+	//  Returns: Whether the class invariant is true.
+	//  Side Effect: N/A
+	//
+	bool invariant () const;
+
+private:
+	std::chrono::steady_clock::time_point m_start_time;
+	std::vector<std::thread> mv_workers;
+
+	// guards everything below
+	mutable std::mutex m_mutex;
+	std::condition_variable m_queue_changed;
+	std::condition_variable m_finished_changed;
+	std::deque<Asset*> m_queue;
+	std::deque<Asset*> m_finished;
+	std::set<std::string> m_claimed_textures;
+	unsigned int m_unfinished_count;
+	bool m_is_stopping;
+
+	// used only by the thread that calls finish
+	std::set<std::string> m_uploaded_textures;
+	std::vector<Asset*> mv_waiting_models;
+	std::vector<std::unique_ptr<Asset> > mv_done;
+};
+
+
+
+#endif
@@ -0,0 +1,949 @@
+//
+//  CompiledModel.cpp
+//
+
+#include <algorithm>
+#include <array>
+#include <cassert>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <map>
+#include <string>
+#include <tuple>
+#include <vector>
+
+#include "GetGlut.h"
+#include "ObjLibrary/Vector3.h"
+#include "ObjLibrary/Material.h"
+#include "ObjLibrary/ObjModel.h"
+#include "ObjLibrary/DisplayList.h"
+#include "ObjLibrary/MappedFile.h"
+
+#include "Renderer.h"
+#include "MeshOptimizer.h"
+#include "MeshSimplifier.h"
+#include "CompiledModel.h"
+
+using namespace std;
+using namespace ObjLibrary;
+namespace
+{
+	//
+	//  The file layout is:
+	//
+	//    FileHeader
+	//    float    vertexes [vertex_count * FLOATS_PER_VERTEX]
+	//    uint32_t indexes  [index_count]
+	//    MeshRecord     meshes   [mesh_count]
+	//    LevelRecord    levels   [level_count]
+	//    MaterialRecord materials[material_count]
+	//    char     strings  [string_bytes]
+	//
+	//  Strings are referenced by their offset in the string
+	//    table and are null-terminated.  The meshes for all
+	//    levels of detail are stored together, and each level
+	//    record says which of them it uses.
+	//
+
+	const char FILE_MAGIC[4] = { 'A', '5', 'M', '\0' };
+
+	// written as a number, so it reads differently in the other byte order
+	const uint32_t BYTE_ORDER_MARK = 0x01020304;
+
+	const uint32_t NO_STRING = ~0u;
+
+	struct FileHeader
+	{
+		char ma_magic[4];
+		uint32_t m_byte_order;
+		uint32_t m_version;
+		uint32_t m_vertex_count;
+		uint32_t m_index_count;
+		uint32_t m_mesh_count;
+		uint32_t m_material_count;
+		uint32_t m_string_bytes;
+		uint32_t m_level_count;
+	};
+
+	struct MeshRecord
+	{
+		uint32_t m_material;
+		uint32_t m_first_index;
+		uint32_t m_index_count;
+	};
+
+	struct LevelRecord
+	{
+		uint32_t m_first_mesh;
+		uint32_t m_mesh_count;
+		float m_error;
+	};
+
+	struct MaterialRecord
+	{
+		uint32_t m_name;
+		uint32_t m_texture_path;
+		uint32_t m_illumination_mode;
+		float ma_emission[3];
+		float ma_ambient [3];
+		float ma_diffuse [3];
+		float ma_specular[3];
+		float m_specular_exponent;
+		float m_transparency;
+		uint32_t m_emission_map;
+		uint32_t m_ambient_map;
+		uint32_t m_diffuse_map;
+		uint32_t m_specular_map;
+	};
+
+	static_assert(sizeof(FileHeader)     == 36, "FileHeader must not be padded");
+	static_assert(sizeof(MeshRecord)     == 12, "MeshRecord must not be padded");
+	static_assert(sizeof(LevelRecord)    == 12, "LevelRecord must not be padded");
+	static_assert(sizeof(MaterialRecord) == 84, "MaterialRecord must not be padded");
+
+	//
+	//  addString
+	//
+	//  Purpose: To add a string to the specified string table.
+	//  Parameter(s):
+	//    <1> r_table: The string table
+	//    <2> str: The string to add
+	//  Precondition(s): N/A
+	//  Returns: The offset of str in r_table.
+	//  Side Effect: str and a terminating null character are
+	//               appended to r_table.
+	//
+	uint32_t addString (string& r_table, const string& str)
+	{
+		uint32_t offset = (uint32_t)(r_table.size());
+		r_table += str;
+		r_table += '\0';
+		return offset;
+	}
+
+	//
+	//  getString
+	//
+	//  Purpose: To retrieve a string from the specified string
+	//           table.
+	//  Parameter(s):
+	//    <1> a_table: The string table
+	//    <2> table_bytes: The size of the string table
+	//    <3> offset: The offset of the string
+	//    <4> r_str: A reference to the string to set
+	//  Precondition(s): N/A
+	//  Returns: Whether offset refers to a null-terminated
+	//           string inside the table.
+	//  Side Effect: If the string is valid, r_str is set to it.
+	//
+	bool getString (const char* a_table, size_t table_bytes,
+	                uint32_t offset, string& r_str)
+	{
+		if(offset >= table_bytes)
+			return false;
+
+		const void* p_end = memchr(a_table + offset, '\0', table_bytes - offset);
+		if(p_end == NULL)
+			return false;
+
+		r_str.assign(a_table + offset, (const char*)(p_end));
+		return true;
+	}
+
+	//
+	//  copyColour
+	//
+	//  Purpose: To copy a colour into a float array.
+	//  Parameter(s):
+	//    <1> colour: The colour
+	//    <2> a_out: The array to copy to
+	//  Precondition(s):
+	//    <1> a_out != NULL
+	//  Returns: N/A
+	//  Side Effect: The first 3 elements of a_out are set.
+	//
+	void copyColour (const Vector3& colour, float a_out[3])
+	{
+		assert(a_out != NULL);
+
+		a_out[0] = (float)(colour.x);
+		a_out[1] = (float)(colour.y);
+		a_out[2] = (float)(colour.z);
+	}
+
+	//
+	//  LEVEL_TRIANGLE_FRACTION
+	//
+	//  The fraction of the triangles in one level of detail
+	//    that the next level is simplified to.
+	//
+	const float LEVEL_TRIANGLE_FRACTION = 0.5f;
+
+	//
+	//  LEVEL_TRIANGLE_FRACTION_MAX
+	//
+	//  The largest fraction of the triangles in one level of
+	//    detail that the next level may keep.  A level that
+	//    removes fewer triangles than this is not worth adding.
+	//
+	const float LEVEL_TRIANGLE_FRACTION_MAX = 0.8f;
+
+	//
+	//  LEVEL_ERROR_MAX_FRACTION
+	//
+	//  The greatest error allowed in a level of detail, as a
+	//    fraction of the radius of the model.
+	//
+	const float LEVEL_ERROR_MAX_FRACTION = 0.1f;
+
+}  // end of anonymous namespace
+
+
+
+const char* const CompiledModel :: FILE_EXTENSION = ".a5m";
+
+string CompiledModel :: getCompiledFilename (const string& obj_filename)
+{
+	assert(obj_filename != "");
+
+	size_t last_dot   = obj_filename.find_last_of('.');
+	size_t last_slash = obj_filename.find_last_of("/\\");
+	if(last_dot == string::npos || (last_slash != string::npos && last_dot < last_slash))
+		return obj_filename + FILE_EXTENSION;
+	else
+		return obj_filename.substr(0, last_dot) + FILE_EXTENSION;
+}
+
+bool CompiledModel :: isCompilable (const ObjModel& model)
+{
+	for(unsigned int m = 0; m < model.getMeshCount(); m++)
+		if(model.getPointSetCount(m) > 0 || model.getPolylineCount(m) > 0)
+			return false;
+	return true;
+}
+
+bool CompiledModel :: isCompiledFileCurrent (const string& obj_filename)
+{
+	assert(obj_filename != "");
+
+	// a compiled file older than its OBJ file is out of date
+	error_code error;
+	filesystem::file_time_type compiled_time = filesystem::last_write_time(getCompiledFilename(obj_filename), error);
+	if(error)
+		return false;
+
+	filesystem::file_time_type obj_time = filesystem::last_write_time(obj_filename, error);
+	return error || compiled_time >= obj_time;
+}
+
+DisplayList CompiledModel :: loadDisplayList (const string& obj_filename,
+                                              unsigned int& r_vertex_count)
+{
+	assert(obj_filename != "");
+
+	if(isCompiledFileCurrent(obj_filename))
+	{
+		string compiled_filename = getCompiledFilename(obj_filename);
+		CompiledModel compiled;
+		if(compiled.load(compiled_filename))
+		{
+			r_vertex_count = compiled.getTriangleCount() * 3;
+			return compiled.getDisplayList();
+		}
+		else
+			cerr << "Could not load \"" << compiled_filename << "\": loading OBJ file instead" << endl;
+	}
+
+	ObjModel model(obj_filename);
+	r_vertex_count = Renderer::countVertexes(model);
+	return model.getDisplayList();
+}
+
+
+
+CompiledModel :: CompiledModel ()
+		: mv_vertexes()
+		, mv_indexes()
+		, mv_meshes()
+		, mv_materials()
+		, mv_levels(1, Level{ 0, 0, 0.0f })
+{
+	assert(invariant());
+}
+
+CompiledModel :: CompiledModel (const ObjModel& model)
+		: mv_vertexes()
+		, mv_indexes()
+		, mv_meshes()
+		, mv_materials()
+		, mv_levels(1, Level{ 0, 0, 0.0f })
+{
+	assert(model.isValid());
+
+	map<tuple<unsigned int, unsigned int, unsigned int>, unsigned int> vertex_indexes;
+	map<const Material*, unsigned int> material_indexes;
+
+	for(unsigned int m = 0; m < model.getMeshCount(); m++)
+	{
+		Mesh mesh;
+		mesh.m_material    = NO_MATERIAL;
+		mesh.m_first_index = mv_indexes.size();
+		mesh.m_index_count = 0;
+
+		const Material* p_material = NULL;
+		if(model.isMeshMaterial(m))
+			p_material = model.getMeshMaterial(m);
+		if(p_material != NULL)
+		{
+			auto found = material_indexes.find(p_material);
+			if(found == material_indexes.end())
+			{
+				found = material_indexes.insert(make_pair(p_material, (unsigned int)(mv_materials.size()))).first;
+				mv_materials.push_back(*p_material);
+			}
+			mesh.m_material = found->second;
+		}
+
+		for(unsigned int f = 0; f < model.getFaceCount(m); f++)
+		{
+			unsigned int face_vertex_count = model.getFaceVertexCount(m, f);
+			vector<unsigned int> v_face_indexes(face_vertex_count);
+
+			for(unsigned int v = 0; v < face_vertex_count; v++)
+			{
+				unsigned int position = model.getFaceVertexIndex(m, f, v);
+				unsigned int texture  = model.getFaceVertexTextureCoordinates(m, f, v);
+				unsigned int normal   = model.getFaceVertexNormal(m, f, v);
+
+				auto key   = make_tuple(position, texture, normal);
+				auto found = vertex_indexes.find(key);
+				if(found == vertex_indexes.end())
+				{
+					found = vertex_indexes.insert(make_pair(key, getVertexCount())).first;
+
+					// flip texture coordinates to match ObjModel
+					double s = 0.0;
+					double t = 1.0;
+					if(texture != ObjModel::NO_TEXTURE_COORDINATES)
+					{
+						s =       model.getTextureCoordinateU(texture);
+						t = 1.0 - model.getTextureCoordinateV(texture);
+					}
+
+					// ObjModel leaves the normal unchanged, but that is not possible with arrays
+					Vector3 normal_vector(0.0, 0.0, 1.0);
+					if(normal != ObjModel::NO_NORMAL)
+						normal_vector = model.getNormalVector(normal);
+
+					const Vector3& position_vector = model.getVertexPosition(position);
+
+					mv_vertexes.push_back((float)(s));
+					mv_vertexes.push_back((float)(t));
+					mv_vertexes.push_back((float)(normal_vector.x));
+					mv_vertexes.push_back((float)(normal_vector.y));
+					mv_vertexes.push_back((float)(normal_vector.z));
+					mv_vertexes.push_back((float)(position_vector.x));
+					mv_vertexes.push_back((float)(position_vector.y));
+					mv_vertexes.push_back((float)(position_vector.z));
+				}
+				v_face_indexes[v] = found->second;
+			}
+
+			// split into a triangle fan, as ObjModel draws it
+			for(unsigned int v = 2; v < face_vertex_count; v++)
+			{
+				mv_indexes.push_back(v_face_indexes[0]);
+				mv_indexes.push_back(v_face_indexes[v - 1]);
+				mv_indexes.push_back(v_face_indexes[v]);
+				mesh.m_index_count += 3;
+			}
+		}
+
+		if(mesh.m_index_count > 0)
+			mv_meshes.push_back(mesh);
+	}
+	mv_levels[0].m_mesh_count = mv_meshes.size();
+
+	assert(invariant());
+}
+
+
+
+bool CompiledModel :: isEmpty () const
+{
+	return mv_indexes.empty();
+}
+
+unsigned int CompiledModel :: getVertexCount () const
+{
+	return mv_vertexes.size() / FLOATS_PER_VERTEX;
+}
+
+unsigned int CompiledModel :: getTriangleCount () const
+{
+	return getTriangleCount(0);
+}
+
+unsigned int CompiledModel :: getTriangleCount (unsigned int level) const
+{
+	assert(level < getLevelCount());
+
+	unsigned int index_count = 0;
+	const Level& lod = mv_levels[level];
+	for(unsigned int i = lod.m_first_mesh; i < lod.m_first_mesh + lod.m_mesh_count; i++)
+		index_count += mv_meshes[i].m_index_count;
+	return index_count / 3;
+}
+
+unsigned int CompiledModel :: getLevelCount () const
+{
+	return mv_levels.size();
+}
+
+float CompiledModel :: getLevelError (unsigned int level) const
+{
+	assert(level < getLevelCount());
+
+	return mv_levels[level].m_error;
+}
+
+unsigned int CompiledModel :: getMeshCount () const
+{
+	return mv_meshes.size();
+}
+
+unsigned int CompiledModel :: getMaterialCount () const
+{
+	return mv_materials.size();
+}
+
+const vector<float>& CompiledModel :: getVertexData () const
+{
+	return mv_vertexes;
+}
+
+const vector<unsigned int>& CompiledModel :: getIndexes () const
+{
+	return mv_indexes;
+}
+
+vector<string> CompiledModel :: getDisplayTextureNames () const
+{
+	// same order as Material::loadDisplayTextures
+	vector<string> v_names;
+	for(unsigned int i = 0; i < mv_materials.size(); i++)
+	{
+		const Material& material = mv_materials[i];
+		if(material.isDiffuseMap())
+			v_names.push_back(material.getTexturePath() + material.getDiffuseMapFilename());
+		else if(material.isAmbientMap())
+			v_names.push_back(material.getTexturePath() + material.getAmbientMapFilename());
+		else if(material.isSpecularMap())
+			v_names.push_back(material.getTexturePath() + material.getSpecularMapFilename());
+		else if(material.isEmissionMap())
+			v_names.push_back(material.getTexturePath() + material.getEmissionMapFilename());
+	}
+	return v_names;
+}
+
+size_t CompiledModel :: getMemoryUsage () const
+{
+	return mv_vertexes.size()  * sizeof(float) +
+	       mv_indexes.size()   * sizeof(unsigned int) +
+	       mv_meshes.size()    * sizeof(Mesh) +
+	       mv_materials.size() * sizeof(Material) +
+	       mv_levels.size()    * sizeof(Level);
+}
+
+bool CompiledModel :: isSameSurface (const CompiledModel& other) const
+{
+	if(mv_vertexes.size()  != other.mv_vertexes.size())  return false;
+	if(mv_indexes          != other.mv_indexes)          return false;
+	if(mv_meshes.size()    != other.mv_meshes.size())    return false;
+	if(mv_materials.size() != other.mv_materials.size()) return false;
+	if(mv_levels.size()    != other.mv_levels.size())    return false;
+
+	for(unsigned int i = 0; i < mv_meshes.size(); i++)
+	{
+		if(mv_meshes[i].m_material    != other.mv_meshes[i].m_material)    return false;
+		if(mv_meshes[i].m_first_index != other.mv_meshes[i].m_first_index) return false;
+		if(mv_meshes[i].m_index_count != other.mv_meshes[i].m_index_count) return false;
+	}
+	for(unsigned int i = 0; i < mv_materials.size(); i++)
+		if(mv_materials[i].getName() != other.mv_materials[i].getName())
+			return false;
+	for(unsigned int i = 0; i < mv_levels.size(); i++)
+		if(mv_levels[i].m_mesh_count != other.mv_levels[i].m_mesh_count)
+			return false;
+
+	// everything but the position
+	static const unsigned int POSITION_OFFSET = 5;
+	for(unsigned int i = 0; i < mv_vertexes.size(); i += FLOATS_PER_VERTEX)
+		for(unsigned int j = 0; j < POSITION_OFFSET; j++)
+			if(mv_vertexes[i + j] != other.mv_vertexes[i + j])
+				return false;
+	return true;
+}
+
+float CompiledModel :: getAcmr () const
+{
+	// level 0 comes first in the index array
+	return MeshOptimizer::calculateAcmr(mv_indexes.data(), getTriangleCount(0) * 3, getVertexCount());
+}
+
+void CompiledModel :: drawWithPositions (const float* a_positions,
+                                         unsigned int level) const
+{
+	assert(a_positions != NULL);
+	assert(level < getLevelCount());
+	assert(!Material::isMaterialActive());
+
+	if(isEmpty())
+		return;
+
+	static const GLsizei STRIDE = FLOATS_PER_VERTEX * sizeof(float);
+	glEnableClientState(GL_TEXTURE_COORD_ARRAY);
+	glEnableClientState(GL_NORMAL_ARRAY);
+	glEnableClientState(GL_VERTEX_ARRAY);
+	glTexCoordPointer(2, GL_FLOAT, STRIDE, mv_vertexes.data());
+	glNormalPointer(GL_FLOAT, STRIDE, mv_vertexes.data() + 2);
+	glVertexPointer(3, GL_FLOAT, 0, a_positions);
+	drawMeshes(level);
+
+	assert(!Material::isMaterialActive());
+}
+
+bool CompiledModel :: save (const string& filename) const
+{
+	assert(filename != "");
+
+	string strings;
+	vector<MaterialRecord> v_material_records(mv_materials.size());
+	for(unsigned int i = 0; i < mv_materials.size(); i++)
+	{
+		const Material& material = mv_materials[i];
+		MaterialRecord& r_record = v_material_records[i];
+
+		r_record.m_name              = addString(strings, material.getName());
+		r_record.m_texture_path      = addString(strings, material.getTexturePath());
+		r_record.m_illumination_mode = material.getIlluminationMode();
+		copyColour(material.getEmission(), r_record.ma_emission);
+		copyColour(material.getAmbient(),  r_record.ma_ambient);
+		copyColour(material.getDiffuse(),  r_record.ma_diffuse);
+		copyColour(material.getSpecular(), r_record.ma_specular);
+		r_record.m_specular_exponent = (float)(material.getSpecularExponent());
+		r_record.m_transparency      = (float)(material.getTransparency());
+		r_record.m_emission_map = material.isEmissionMap() ? addString(strings, material.getEmissionMapFilename()) : NO_STRING;
+		r_record.m_ambient_map  = material.isAmbientMap()  ? addString(strings, material.getAmbientMapFilename())  : NO_STRING;
+		r_record.m_diffuse_map  = material.isDiffuseMap()  ? addString(strings, material.getDiffuseMapFilename())  : NO_STRING;
+		r_record.m_specular_map = material.isSpecularMap() ? addString(strings, material.getSpecularMapFilename()) : NO_STRING;
+	}
+
+	vector<MeshRecord> v_mesh_records(mv_meshes.size());
+	for(unsigned int i = 0; i < mv_meshes.size(); i++)
+	{
+		v_mesh_records[i].m_material    = mv_meshes[i].m_material;
+		v_mesh_records[i].m_first_index = mv_meshes[i].m_first_index;
+		v_mesh_records[i].m_index_count = mv_meshes[i].m_index_count;
+	}
+
+	vector<LevelRecord> v_level_records(mv_levels.size());
+	for(unsigned int i = 0; i < mv_levels.size(); i++)
+	{
+		v_level_records[i].m_first_mesh = mv_levels[i].m_first_mesh;
+		v_level_records[i].m_mesh_count = mv_levels[i].m_mesh_count;
+		v_level_records[i].m_error      = mv_levels[i].m_error;
+	}
+
+	vector<uint32_t> v_indexes(mv_indexes.begin(), mv_indexes.end());
+
+	FileHeader header;
+	memcpy(header.ma_magic, FILE_MAGIC, sizeof(FILE_MAGIC));
+	header.m_byte_order     = BYTE_ORDER_MARK;
+	header.m_version        = FILE_VERSION;
+	header.m_vertex_count   = getVertexCount();
+	header.m_index_count    = v_indexes.size();
+	header.m_mesh_count     = v_mesh_records.size();
+	header.m_material_count = v_material_records.size();
+	header.m_string_bytes   = strings.size();
+	header.m_level_count    = v_level_records.size();
+
+	ofstream output(filename.c_str(), ios::out | ios::binary | ios::trunc);
+	output.write((const char*)(&header), sizeof(header));
+	output.write((const char*)(mv_vertexes.data()),        mv_vertexes.size()        * sizeof(float));
+	output.write((const char*)(v_indexes.data()),          v_indexes.size()          * sizeof(uint32_t));
+	output.write((const char*)(v_mesh_records.data()),     v_mesh_records.size()     * sizeof(MeshRecord));
+	output.write((const char*)(v_level_records.data()),    v_level_records.size()    * sizeof(LevelRecord));
+	output.write((const char*)(v_material_records.data()), v_material_records.size() * sizeof(MaterialRecord));
+	output.write(strings.data(), strings.size());
+	output.close();
+
+	return !output.fail();
+}
+
+
+
+void CompiledModel :: optimize (bool is_weld)
+{
+	unsigned int vertex_count = getVertexCount();
+
+	if(is_weld)
+	{
+		// ObjModel only merges vertexes with the same indexes
+		map<array<float, FLOATS_PER_VERTEX>, unsigned int> first_with_values;
+		vector<unsigned int> v_welded(vertex_count);
+		for(unsigned int v = 0; v < vertex_count; v++)
+		{
+			array<float, FLOATS_PER_VERTEX> values;
+			copy(mv_vertexes.begin() + v * FLOATS_PER_VERTEX,
+			     mv_vertexes.begin() + (v + 1) * FLOATS_PER_VERTEX,
+			     values.begin());
+			v_welded[v] = first_with_values.insert(make_pair(values, v)).first->second;
+		}
+		for(unsigned int i = 0; i < mv_indexes.size(); i++)
+			mv_indexes[i] = v_welded[mv_indexes[i]];
+	}
+
+	// meshes keep their triangles so materials do not change
+	for(unsigned int m = 0; m < mv_meshes.size(); m++)
+		MeshOptimizer::optimizeTriangleOrder(mv_indexes.data() + mv_meshes[m].m_first_index,
+		                                     mv_meshes[m].m_index_count,
+		                                     vertex_count);
+
+	vector<unsigned int> v_new_index = MeshOptimizer::calculateVertexOrder(mv_indexes, vertex_count);
+	vector<float> v_vertexes(mv_vertexes.size());
+	unsigned int used_count = 0;
+	for(unsigned int v = 0; v < vertex_count; v++)
+	{
+		if(v_new_index[v] == MeshOptimizer::NOT_USED)
+			continue;
+		copy(mv_vertexes.begin() + v * FLOATS_PER_VERTEX,
+		     mv_vertexes.begin() + (v + 1) * FLOATS_PER_VERTEX,
+		     v_vertexes.begin() + v_new_index[v] * FLOATS_PER_VERTEX);
+		used_count++;
+	}
+	v_vertexes.resize(used_count * FLOATS_PER_VERTEX);
+	mv_vertexes.swap(v_vertexes);
+
+	for(unsigned int i = 0; i < mv_indexes.size(); i++)
+		mv_indexes[i] = v_new_index[mv_indexes[i]];
+
+	assert(invariant());
+}
+
+void CompiledModel :: generateLevels ()
+{
+	// level 0 comes first, so the rest can just be cut off
+	unsigned int full_triangle_count = getTriangleCount(0);
+	mv_meshes.resize(mv_levels[0].m_mesh_count);
+	mv_indexes.resize(full_triangle_count * 3);
+	mv_levels.resize(1);
+	if(isEmpty())
+		return;
+
+	static const unsigned int POSITION_OFFSET = 5;
+	unsigned int vertex_count = getVertexCount();
+	vector<float> v_positions(vertex_count * 3);
+	float minimum[3] = {  1.0e30f,  1.0e30f,  1.0e30f };
+	float maximum[3] = { -1.0e30f, -1.0e30f, -1.0e30f };
+	for(unsigned int v = 0; v < vertex_count; v++)
+		for(unsigned int a = 0; a < 3; a++)
+		{
+			float value = mv_vertexes[v * FLOATS_PER_VERTEX + POSITION_OFFSET + a];
+			v_positions[v * 3 + a] = value;
+			minimum[a] = min(minimum[a], value);
+			maximum[a] = max(maximum[a], value);
+		}
+	float radius = 0.5f * sqrtf((maximum[0] - minimum[0]) * (maximum[0] - minimum[0]) +
+	                            (maximum[1] - minimum[1]) * (maximum[1] - minimum[1]) +
+	                            (maximum[2] - minimum[2]) * (maximum[2] - minimum[2]));
+	float error_max = radius * LEVEL_ERROR_MAX_FRACTION;
+
+	// every level is simplified from the full model
+	vector<unsigned int> v_full_indexes(mv_indexes);
+	vector<unsigned int> v_simplified;
+	vector<unsigned int> v_sources;
+	unsigned int previous_count = full_triangle_count;
+	while(mv_levels.size() < LEVEL_COUNT_MAX)
+	{
+		unsigned int target_count = (unsigned int)(previous_count * LEVEL_TRIANGLE_FRACTION);
+		float error = MeshSimplifier::simplify(v_positions, v_full_indexes, target_count, error_max,
+		                                       v_simplified, v_sources);
+		unsigned int simplified_count = v_sources.size();
+		if(simplified_count == 0 || simplified_count > previous_count * LEVEL_TRIANGLE_FRACTION_MAX)
+			break;
+
+		Level level;
+		level.m_first_mesh = mv_meshes.size();
+		level.m_mesh_count = 0;
+		level.m_error      = error;
+
+		// triangles stay in order, so each mesh stays together
+		unsigned int full_mesh = 0;
+		for(unsigned int t = 0; t < simplified_count; t++)
+		{
+			unsigned int source_index = v_sources[t] * 3;
+			while(source_index >= mv_meshes[full_mesh].m_first_index + mv_meshes[full_mesh].m_index_count)
+				full_mesh++;
+			assert(full_mesh < mv_levels[0].m_mesh_count);
+
+			if(level.m_mesh_count == 0 ||
+			   mv_meshes.back().m_material != mv_meshes[full_mesh].m_material)
+			{
+				Mesh mesh;
+				mesh.m_material    = mv_meshes[full_mesh].m_material;
+				mesh.m_first_index = mv_indexes.size();
+				mesh.m_index_count = 0;
+				mv_meshes.push_back(mesh);
+				level.m_mesh_count++;
+			}
+
+			mv_indexes.push_back(v_simplified[t * 3 + 0]);
+			mv_indexes.push_back(v_simplified[t * 3 + 1]);
+			mv_indexes.push_back(v_simplified[t * 3 + 2]);
+			mv_meshes.back().m_index_count += 3;
+		}
+
+		for(unsigned int m = level.m_first_mesh; m < mv_meshes.size(); m++)
+			MeshOptimizer::optimizeTriangleOrder(mv_indexes.data() + mv_meshes[m].m_first_index,
+			                                     mv_meshes[m].m_index_count,
+			                                     vertex_count);
+
+		mv_levels.push_back(level);
+		previous_count = simplified_count;
+	}
+
+	assert(invariant());
+}
+
+DisplayList CompiledModel :: getDisplayList ()
+{
+	return getDisplayList(0);
+}
+
+DisplayList CompiledModel :: getDisplayList (unsigned int level)
+{
+	assert(level < getLevelCount());
+	assert(!Material::isMaterialActive());
+
+	// load textures before compiling, as ObjModel does
+	loadTextures();
+
+	DisplayList list;
+	list.begin();
+		draw(level);
+	list.end();
+
+	assert(!Material::isMaterialActive());
+	return list;
+}
+
+void CompiledModel :: loadTextures ()
+{
+	for(unsigned int i = 0; i < mv_materials.size(); i++)
+		mv_materials[i].loadDisplayTextures();
+}
+
+bool CompiledModel :: load (const string& filename)
+{
+	assert(filename != "");
+
+	makeEmpty();
+
+	MappedFile file(filename);
+	if(!file.isOpen() || file.getSize() < sizeof(FileHeader))
+		return false;
+
+	const char* a_data = file.getData();
+	FileHeader header;
+	memcpy(&header, a_data, sizeof(header));
+	if(memcmp(header.ma_magic, FILE_MAGIC, sizeof(FILE_MAGIC)) != 0 ||
+	   header.m_byte_order != BYTE_ORDER_MARK ||
+	   header.m_version    != FILE_VERSION)
+	{
+		return false;
+	}
+
+	// use 64-bit sizes so that damaged counts cannot overflow
+	uint64_t vertex_bytes   = (uint64_t)(header.m_vertex_count)   * FLOATS_PER_VERTEX * sizeof(float);
+	uint64_t index_bytes    = (uint64_t)(header.m_index_count)    * sizeof(uint32_t);
+	uint64_t mesh_bytes     = (uint64_t)(header.m_mesh_count)     * sizeof(MeshRecord);
+	uint64_t level_bytes    = (uint64_t)(header.m_level_count)    * sizeof(LevelRecord);
+	uint64_t material_bytes = (uint64_t)(header.m_material_count) * sizeof(MaterialRecord);
+	uint64_t expected_size  = sizeof(FileHeader) + vertex_bytes + index_bytes +
+	                          mesh_bytes + level_bytes + material_bytes + header.m_string_bytes;
+	if(expected_size != file.getSize())
+		return false;
+
+	const char* p_next = a_data + sizeof(FileHeader);
+
+	mv_vertexes.resize((size_t)(header.m_vertex_count) * FLOATS_PER_VERTEX);
+	memcpy(mv_vertexes.data(), p_next, (size_t)(vertex_bytes));
+	p_next += vertex_bytes;
+
+	vector<uint32_t> v_indexes(header.m_index_count);
+	memcpy(v_indexes.data(), p_next, (size_t)(index_bytes));
+	mv_indexes.assign(v_indexes.begin(), v_indexes.end());
+	p_next += index_bytes;
+
+	vector<MeshRecord> v_mesh_records(header.m_mesh_count);
+	memcpy(v_mesh_records.data(), p_next, (size_t)(mesh_bytes));
+	p_next += mesh_bytes;
+
+	vector<LevelRecord> v_level_records(header.m_level_count);
+	memcpy(v_level_records.data(), p_next, (size_t)(level_bytes));
+	p_next += level_bytes;
+
+	vector<MaterialRecord> v_material_records(header.m_material_count);
+	memcpy(v_material_records.data(), p_next, (size_t)(material_bytes));
+	p_next += material_bytes;
+
+	const char* a_strings = p_next;
+	size_t string_bytes = header.m_string_bytes;
+
+	mv_meshes.resize(v_mesh_records.size());
+	for(unsigned int i = 0; i < v_mesh_records.size(); i++)
+	{
+		mv_meshes[i].m_material    = v_mesh_records[i].m_material;
+		mv_meshes[i].m_first_index = v_mesh_records[i].m_first_index;
+		mv_meshes[i].m_index_count = v_mesh_records[i].m_index_count;
+	}
+
+	mv_levels.resize(v_level_records.size());
+	for(unsigned int i = 0; i < v_level_records.size(); i++)
+	{
+		mv_levels[i].m_first_mesh = v_level_records[i].m_first_mesh;
+		mv_levels[i].m_mesh_count = v_level_records[i].m_mesh_count;
+		mv_levels[i].m_error      = v_level_records[i].m_error;
+	}
+
+	mv_materials.reserve(v_material_records.size());
+	for(unsigned int i = 0; i < v_material_records.size(); i++)
+	{
+		const MaterialRecord& record = v_material_records[i];
+
+		string name;
+		string texture_path;
+		if(!getString(a_strings, string_bytes, record.m_name,         name) ||
+		   !getString(a_strings, string_bytes, record.m_texture_path, texture_path) ||
+		   !Material::isValidIlluminationMode(record.m_illumination_mode))
+		{
+			makeEmpty();
+			return false;
+		}
+
+		Material material(name, texture_path);
+		material.setIlluminationMode(record.m_illumination_mode);
+		material.setEmissionColour(Vector3(record.ma_emission[0], record.ma_emission[1], record.ma_emission[2]));
+		material.setAmbientColour (Vector3(record.ma_ambient [0], record.ma_ambient [1], record.ma_ambient [2]));
+		material.setDiffuseColour (Vector3(record.ma_diffuse [0], record.ma_diffuse [1], record.ma_diffuse [2]));
+		material.setSpecularColour(Vector3(record.ma_specular[0], record.ma_specular[1], record.ma_specular[2]));
+		material.setSpecularExponent(record.m_specular_exponent);
+		material.setTransparency(record.m_transparency);
+
+		string map_filename;
+		if(getString(a_strings, string_bytes, record.m_emission_map, map_filename) && map_filename != "")
+			material.setEmissionMap(map_filename);
+		if(getString(a_strings, string_bytes, record.m_ambient_map,  map_filename) && map_filename != "")
+			material.setAmbientMap(map_filename);
+		if(getString(a_strings, string_bytes, record.m_diffuse_map,  map_filename) && map_filename != "")
+			material.setDiffuseMap(map_filename);
+		if(getString(a_strings, string_bytes, record.m_specular_map, map_filename) && map_filename != "")
+			material.setSpecularMap(map_filename);
+
+		mv_materials.push_back(material);
+	}
+
+	if(!invariant())
+	{
+		makeEmpty();
+		return false;
+	}
+	return true;
+}
+
+void CompiledModel :: makeEmpty ()
+{
+	mv_vertexes.clear();
+	mv_indexes.clear();
+	mv_meshes.clear();
+	mv_materials.clear();
+	mv_levels.assign(1, Level{ 0, 0, 0.0f });
+
+	assert(invariant());
+}
+
+
+
+void CompiledModel :: draw (unsigned int level) const
+{
+	assert(level < getLevelCount());
+	assert(!Material::isMaterialActive());
+
+	if(isEmpty())
+		return;
+
+	glInterleavedArrays(GL_T2F_N3F_V3F, 0, mv_vertexes.data());
+	drawMeshes(level);
+
+	assert(!Material::isMaterialActive());
+}
+
+void CompiledModel :: drawMeshes (unsigned int level) const
+{
+	assert(level < getLevelCount());
+	assert(!Material::isMaterialActive());
+
+	const Level& lod = mv_levels[level];
+	for(unsigned int i = lod.m_first_mesh; i < lod.m_first_mesh + lod.m_mesh_count; i++)
+	{
+		const Mesh& mesh = mv_meshes[i];
+		const unsigned int* a_indexes = mv_indexes.data() + mesh.m_first_index;
+
+		if(mesh.m_material == NO_MATERIAL)
+			glDrawElements(GL_TRIANGLES, mesh.m_index_count, GL_UNSIGNED_INT, a_indexes);
+		else
+		{
+			const Material& material = mv_materials[mesh.m_material];
+			material.activate();
+			glDrawElements(GL_TRIANGLES, mesh.m_index_count, GL_UNSIGNED_INT, a_indexes);
+			Material::deactivate();
+
+			if(material.isSeperateSpecular())
+			{
+				material.activateSeperateSpecular();
+				glDrawElements(GL_TRIANGLES, mesh.m_index_count, GL_UNSIGNED_INT, a_indexes);
+				Material::deactivate();
+			}
+		}
+	}
+	glDisableClientState(GL_VERTEX_ARRAY);
+	glDisableClientState(GL_NORMAL_ARRAY);
+	glDisableClientState(GL_TEXTURE_COORD_ARRAY);
+
+	assert(!Material::isMaterialActive());
+}
+
+bool CompiledModel :: invariant () const
+{
+	if(mv_vertexes.size() % FLOATS_PER_VERTEX != 0) return false;
+	if(mv_indexes.size() % 3 != 0) return false;
+	for(unsigned int i = 0; i < mv_indexes.size(); i++)
+		if(mv_indexes[i] >= getVertexCount()) return false;
+	for(unsigned int i = 0; i < mv_meshes.size(); i++)
+	{
+		if((size_t)(mv_meshes[i].m_first_index) + mv_meshes[i].m_index_count > mv_indexes.size()) return false;
+		if(mv_meshes[i].m_material != NO_MATERIAL &&
+		   mv_meshes[i].m_material >= mv_materials.size()) return false;
+	}
+	if(mv_levels.empty()) return false;
+	if(mv_levels[0].m_first_mesh != 0) return false;
+	for(unsigned int i = 1; i < mv_levels.size(); i++)
+		if(mv_levels[i].m_first_mesh != mv_levels[i - 1].m_first_mesh + mv_levels[i - 1].m_mesh_count) return false;
+	if((size_t)(mv_levels.back().m_first_mesh) + mv_levels.back().m_mesh_count != mv_meshes.size()) return false;
+	return true;
+}
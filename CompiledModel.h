@@ -0,0 +1,655 @@
+//
+//  CompiledModel.h
+//
+//  A module to represent a model stored in a compact binary
+//    format that can be loaded without parsing.
+//
+
+#ifndef COMPILED_MODEL_H
+#define COMPILED_MODEL_H
+
+#include <cassert>
+#include <string>
+#include <vector>
+
+#include "ObjLibrary/Material.h"
+#include "ObjLibrary/DisplayList.h"
+
+namespace ObjLibrary
+{
+	class ObjModel;
+}
+
+
+
+//
+//  CompiledModel
+//
+//  A class to represent a model that has been converted from
+//    an OBJ file into a form that can be sent straight to the
+//    graphics card.  All faces are split into triangles and
+//    every distinct combination of position, texture
+//    coordinates, and normal becomes one vertex.  The vertexes
+//    are stored as an interleaved float array in
+//    GL_T2F_N3F_V3F format and the triangles as a single
+//    index array shared by all meshes.
+//
+//  Each mesh refers to a material by index.  The material
+//    properties needed for display are copied from the MTL
+//    files when the model is compiled, so no MTL file is read
+//    when a compiled model is loaded.  Texture images are
+//    still loaded by filename through the TextureManager.
+//
+//  A CompiledModel may also store simplified levels of detail.
+//    Each level is a further set of meshes and triangles that
+//    use the same vertexes, so switching levels costs nothing
+//    but the index array.  Level 0 is always the full model.
+//    The estimated error of each level, the greatest distance
+//    its surface is from the full model, is stored with it.
+//
+//  Texture coordinates are stored already flipped vertically,
+//    as ObjModel does when drawing.  Point sets and polylines
+//    are not supported.
+//
+//  A CompiledModel is normally created offline with the
+//    ModelCompiler tool and saved to a file with the same name
+//    as the OBJ file but the extension FILE_EXTENSION.  The
+//    file is stored in the byte order of the machine that
+//    wrote it, and is rejected if loaded on a machine with the
+//    other byte order.
+//
+//  Class Invariant:
+//    <1> mv_vertexes.size() % FLOATS_PER_VERTEX == 0
+//    <2> mv_indexes.size() % 3 == 0
+//    <3> mv_indexes[i] < getVertexCount()
+//                             WHERE 0 <= i < mv_indexes.size()
+//    <4> mv_meshes[i].m_first_index + mv_meshes[i].m_index_count
+//        <= mv_indexes.size()
+//                             WHERE 0 <= i < mv_meshes.size()
+//    <5> mv_meshes[i].m_material == NO_MATERIAL ||
+//        mv_meshes[i].m_material < mv_materials.size()
+//                             WHERE 0 <= i < mv_meshes.size()
+//    <6> !mv_levels.empty()
+//    <7> mv_levels[0].m_first_mesh == 0
+//    <8> mv_levels[i].m_first_mesh ==
+//        mv_levels[i - 1].m_first_mesh +
+//        mv_levels[i - 1].m_mesh_count
+//                             WHERE 1 <= i < mv_levels.size()
+//    <9> mv_levels.back().m_first_mesh +
+//        mv_levels.back().m_mesh_count == mv_meshes.size()
+//
+class CompiledModel
+{
+public:
+	//
+	//  FILE_EXTENSION
+	//
+	//  The file extension used for compiled models.
+	//
+	static const char* const FILE_EXTENSION;
+
+	//
+	//  FILE_VERSION
+	//
+	//  The version of the file format.  This must be increased
+	//    whenever the format changes.
+	//
+	static const unsigned int FILE_VERSION = 2;
+
+	//
+	//  FLOATS_PER_VERTEX
+	//
+	//  The number of floats used to store each vertex.  These
+	//    are texture coordinates s and t, then normal x, y, and
+	//    z, and then position x, y, and z.
+	//
+	static const unsigned int FLOATS_PER_VERTEX = 8;
+
+	//
+	//  NO_MATERIAL
+	//
+	//  A constant used as the material index for a mesh with no
+	//    material.
+	//
+	static const unsigned int NO_MATERIAL = ~0u;
+
+	//
+	//  LEVEL_COUNT_MAX
+	//
+	//  The greatest number of levels of detail, including the
+	//    full model, that generateLevels creates.
+	//
+	static const unsigned int LEVEL_COUNT_MAX = 4;
+
+	//
+	//  Class Function: getCompiledFilename
+	//
+	//  Purpose: To determine the name of the compiled file
+	//           corresponding to the specified OBJ file.
+	//  Parameter(s):
+	//    <1> obj_filename: The name of the OBJ file
+	//  Precondition(s):
+	//    <1> obj_filename != ""
+	//  Returns: obj_filename with its extension replaced by
+	//           FILE_EXTENSION.  If obj_filename has no
+	//           extension, FILE_EXTENSION is appended.
+	//  Side Effect: N/A
+	//
+	static std::string getCompiledFilename (
+	                             const std::string& obj_filename);
+
+	//
+	//  Class Function: isCompilable
+	//
+	//  Purpose: To determine whether the specified model can be
+	//           compiled without losing anything.
+	//  Parameter(s):
+	//    <1> model: The model
+	//  Precondition(s): N/A
+	//  Returns: Whether model has no point sets or polylines.
+	//  Side Effect: N/A
+	//
+	static bool isCompilable (const ObjLibrary::ObjModel& model);
+
+	//
+	//  Class Function: isCompiledFileCurrent
+	//
+	//  Purpose: To determine whether the specified OBJ file has
+	//           a compiled file that is up to date.
+	//  Parameter(s):
+	//    <1> obj_filename: The name of the OBJ file
+	//  Precondition(s):
+	//    <1> obj_filename != ""
+	//  Returns: Whether the compiled file for obj_filename
+	//           exists and is not older than obj_filename.  If
+	//           obj_filename does not exist, any compiled file is
+	//           considered up to date.
+	//  Side Effect: N/A
+	//
+	static bool isCompiledFileCurrent (
+	                             const std::string& obj_filename);
+
+	//
+	//  Class Function: loadDisplayList
+	//
+	//  Purpose: To load the specified model into a display list,
+	//           using its compiled file when possible.
+	//  Parameter(s):
+	//    <1> obj_filename: The name of the OBJ file
+	//    <2> r_vertex_count: A reference to the number of
+	//                        triangle vertexes in the model
+	//  Precondition(s):
+	//    <1> obj_filename != ""
+	//  Returns: A display list that draws the model.
+	//  Side Effect: If the compiled file for obj_filename
+	//               exists, is not older than obj_filename, and
+	//               can be read, it is loaded.  Otherwise,
+	//               obj_filename is loaded as an ObjModel.
+	//               r_vertex_count is set to the number of
+	//               vertexes the display list sends to the
+	//               graphics card.
+	//
+	static ObjLibrary::DisplayList loadDisplayList (
+	                             const std::string& obj_filename,
+	                             unsigned int& r_vertex_count);
+
+public:
+	//
+	//  Default Constructor
+	//
+	//  Purpose: To create a new CompiledModel with no meshes.
+	//  Parameter(s): N/A
+	//  Precondition(s): N/A
+	//  Returns: N/A
+	//  Side Effect: A new CompiledModel is created.
+	//
+	CompiledModel ();
+
+	//
+	//  Constructor
+	//
+	//  Purpose: To create a new CompiledModel from the
+	//           specified ObjModel.
+	//  Parameter(s):
+	//    <1> model: The ObjModel to compile
+	//  Precondition(s):
+	//    <1> model.isValid()
+	//  Returns: N/A
+	//  Side Effect: A new CompiledModel is created with the
+	//               faces and materials of model.  Point sets
+	//               and polylines are ignored.
+	//
+	CompiledModel (const ObjLibrary::ObjModel& model);
+
+	CompiledModel (const CompiledModel& original) = default;
+	~CompiledModel () = default;
+	CompiledModel& operator= (const CompiledModel& original) = default;
+
+	//
+	//  isEmpty
+	//
+	//  Purpose: To determine whether this CompiledModel has any
+	//           triangles.
+	//  Parameter(s): N/A
+	//  Precondition(s): N/A
+	//  Returns: Whether there are no triangles.
+	//  Side Effect: N/A
+	//
+	bool isEmpty () const;
+
+	//
+	//  getVertexCount
+	//
+	//  Purpose: To determine the number of distinct vertexes in
+	//           this CompiledModel.
+	//  Parameter(s): N/A
+	//  Precondition(s): N/A
+	//  Returns: The number of vertexes.
+	//  Side Effect: N/A
+	//
+	unsigned int getVertexCount () const;
+
+	//
+	//  getTriangleCount
+	//
+	//  Purpose: To determine the number of triangles in this
+	//           CompiledModel.
+	//  Parameter(s): N/A
+	//  Precondition(s): N/A
+	//  Returns: The number of triangles in level 0.
+	//  Side Effect: N/A
+	//
+	unsigned int getTriangleCount () const;
+
+	//
+	//  getTriangleCount
+	//
+	//  Purpose: To determine the number of triangles in the
+	//           specified level of detail.
+	//  Parameter(s):
+	//    <1> level: The level of detail
+	//  Precondition(s):
+	//    <1> level < getLevelCount()
+	//  Returns: The number of triangles in level.
+	//  Side Effect: N/A
+	//
+	unsigned int getTriangleCount (unsigned int level) const;
+
+	//
+	//  getLevelCount
+	//
+	//  Purpose: To determine the number of levels of detail in
+	//           this CompiledModel.
+	//  Parameter(s): N/A
+	//  Precondition(s): N/A
+	//  Returns: The number of levels, including the full model.
+	//           This is always at least 1.
+	//  Side Effect: N/A
+	//
+	unsigned int getLevelCount () const;
+
+	//
+	//  getLevelError
+	//
+	//  Purpose: To determine how far the specified level of
+	//           detail is from the full model.
+	//  Parameter(s):
+	//    <1> level: The level of detail
+	//  Precondition(s):
+	//    <1> level < getLevelCount()
+	//  Returns: The estimated greatest distance between the
+	//           surface of level and the full model, in model
+	//           coordinates.  This is 0.0f for level 0.
+	//  Side Effect: N/A
+	//
+	float getLevelError (unsigned int level) const;
+
+	//
+	//  getMeshCount
+	//
+	//  Purpose: To determine the number of meshes in this
+	//           CompiledModel.
+	//  Parameter(s): N/A
+	//  Precondition(s): N/A
+	//  Returns: The number of meshes.
+	//  Side Effect: N/A
+	//
+	unsigned int getMeshCount () const;
+
+	//
+	//  getMaterialCount
+	//
+	//  Purpose: To determine the number of materials used by
+	//           this CompiledModel.
+	//  Parameter(s): N/A
+	//  Precondition(s): N/A
+	//  Returns: The number of materials.
+	//  Side Effect: N/A
+	//
+	unsigned int getMaterialCount () const;
+
+	//
+	//  getVertexData
+	//
+	//  Purpose: To retrieve the interleaved vertex array for
+	//           this CompiledModel.
+	//  Parameter(s): N/A
+	//  Precondition(s): N/A
+	//  Returns: The vertex array in GL_T2F_N3F_V3F format.
+	//  Side Effect: N/A
+	//
+	const std::vector<float>& getVertexData () const;
+
+	//
+	//  getIndexes
+	//
+	//  Purpose: To retrieve the triangle index array for this
+	//           CompiledModel.
+	//  Parameter(s): N/A
+	//  Precondition(s): N/A
+	//  Returns: The index array, with 3 indexes per triangle.
+	//           The triangles for every level of detail are
+	//           included, starting with level 0.
+	//  Side Effect: N/A
+	//
+	const std::vector<unsigned int>& getIndexes () const;
+
+	//
+	//  getDisplayTextureNames
+	//
+	//  Purpose: To determine which texture files will be used
+	//           when this CompiledModel is displayed.
+	//  Parameter(s): N/A
+	//  Precondition(s): N/A
+	//  Returns: The names of the texture files, including their
+	//           paths, in the form passed to the TextureManager.
+	//           For each material, this is the first of the
+	//           diffuse, ambient, specular, and emission maps
+	//           that the material has.  A name may appear more
+	//           than once.
+	//  Side Effect: N/A
+	//
+	std::vector<std::string> getDisplayTextureNames () const;
+
+	//
+	//  getMemoryUsage
+	//
+	//  Purpose: To determine how much memory is used to store
+	//           this CompiledModel.
+	//  Parameter(s): N/A
+	//  Precondition(s): N/A
+	//  Returns: The number of bytes used by the vertexes,
+	//           indexes, meshes, and materials.  Memory used by
+	//           the material names and by unused capacity is not
+	//           included.
+	//  Side Effect: N/A
+	//
+	size_t getMemoryUsage () const;
+
+	//
+	//  isSameSurface
+	//
+	//  Purpose: To determine whether this CompiledModel differs
+	//           from another only in its vertex positions.
+	//  Parameter(s):
+	//    <1> other: The CompiledModel to compare to
+	//  Precondition(s): N/A
+	//  Returns: Whether this CompiledModel and other have the
+	//           same triangles, texture coordinates, normals, and
+	//           meshes, and materials with the same names.  The
+	//           levels of detail must also match.
+	//  Side Effect: N/A
+	//
+	bool isSameSurface (const CompiledModel& other) const;
+
+	//
+	//  getAcmr
+	//
+	//  Purpose: To determine how well the triangles of this
+	//           CompiledModel use the vertex cache.
+	//  Parameter(s): N/A
+	//  Precondition(s): N/A
+	//  Returns: The average cache miss ratio for the triangles
+	//           in level 0, as calculated by
+	//           MeshOptimizer::calculateAcmr.
+	//  Side Effect: N/A
+	//
+	float getAcmr () const;
+
+	//
+	//  drawWithPositions
+	//
+	//  Purpose: To display this CompiledModel with its vertexes
+	//           moved to the specified positions.
+	//  Parameter(s):
+	//    <1> a_positions: The vertex positions, as x, y, and z
+	//                     for each vertex in turn
+	//    <2> level: The level of detail to draw
+	//  Precondition(s):
+	//    <1> a_positions != NULL
+	//    <2> a_positions contains getVertexCount() * 3 values
+	//    <3> level < getLevelCount()
+	//    <4> !ObjLibrary::Material::isMaterialActive()
+	//    <5> loadTextures() has been called
+	//  Returns: N/A
+	//  Side Effect: Each mesh in level is drawn with one call
+	//               to glDrawElements, using the texture
+	//               coordinates and normals of this
+	//               CompiledModel and the positions in
+	//               a_positions.
+	//
+	void drawWithPositions (const float* a_positions,
+	                        unsigned int level) const;
+
+	//
+	//  save
+	//
+	//  Purpose: To write this CompiledModel to a file.
+	//  Parameter(s):
+	//    <1> filename: The name of the file to write
+	//  Precondition(s):
+	//    <1> filename != ""
+	//  Returns: Whether the file was written successfully.
+	//  Side Effect: The file filename is replaced with the
+	//               contents of this CompiledModel.
+	//
+	bool save (const std::string& filename) const;
+
+	//
+	//  optimize
+	//
+	//  Purpose: To reorder the triangles and vertexes of this
+	//           CompiledModel so that it draws faster.
+	//  Parameter(s):
+	//    <1> is_weld: Whether vertexes with identical values
+	//                 should be merged
+	//  Precondition(s): N/A
+	//  Returns: N/A
+	//  Side Effect: If is_weld is true, vertexes with the same
+	//               texture coordinates, normal, and position
+	//               are merged.  The triangles in each mesh are
+	//               reordered for the vertex cache and the
+	//               vertexes are renumbered in the order they
+	//               are first used.  Vertexes not used by any
+	//               triangle are removed.  The order depends
+	//               only on the triangles, so frames of an
+	//               animation optimized without welding keep
+	//               the same surface.  Any levels of detail are
+	//               optimized as well.
+	//
+	void optimize (bool is_weld);
+
+	//
+	//  generateLevels
+	//
+	//  Purpose: To calculate simplified levels of detail for
+	//           this CompiledModel.
+	//  Parameter(s): N/A
+	//  Precondition(s): N/A
+	//  Returns: N/A
+	//  Side Effect: Any existing levels after level 0 are
+	//               removed.  Up to LEVEL_COUNT_MAX - 1 new
+	//               levels are then calculated with
+	//               MeshSimplifier, each with about half the
+	//               triangles of the one before.  Levels stop
+	//               when simplifying further would not remove
+	//               enough triangles without moving the surface
+	//               too far.
+	//
+	void generateLevels ();
+
+	//
+	//  getDisplayList
+	//
+	//  Purpose: To create a display list for this
+	//           CompiledModel.
+	//  Parameter(s): N/A
+	//  Precondition(s): N/A
+	//  Returns: A display list that draws this CompiledModel.
+	//  Side Effect: The textures for the materials are loaded
+	//               if they have not been already.
+	//
+	ObjLibrary::DisplayList getDisplayList ();
+
+	//
+	//  getDisplayList
+	//
+	//  Purpose: To create a display list for the specified
+	//           level of detail of this CompiledModel.
+	//  Parameter(s):
+	//    <1> level: The level of detail
+	//  Precondition(s):
+	//    <1> level < getLevelCount()
+	//  Returns: A display list that draws level.
+	//  Side Effect: The textures for the materials are loaded
+	//               if they have not been already.
+	//
+	ObjLibrary::DisplayList getDisplayList (unsigned int level);
+
+	//
+	//  loadTextures
+	//
+	//  Purpose: To load the textures used to display this
+	//           CompiledModel.
+	//  Parameter(s): N/A
+	//  Precondition(s): N/A
+	//  Returns: N/A
+	//  Side Effect: The textures for the materials are loaded
+	//               if they have not been already.
+	//
+	void loadTextures ();
+
+	//
+	//  load
+	//
+	//  Purpose: To replace this CompiledModel with the contents
+	//           of the specified file.
+	//  Parameter(s):
+	//    <1> filename: The name of the file to read
+	//  Precondition(s):
+	//    <1> filename != ""
+	//  Returns: Whether the file could be read.  A file that
+	//           does not exist, has the wrong version or byte
+	//           order, or is damaged cannot be read.
+	//  Side Effect: The file is memory-mapped and copied into
+	//               this CompiledModel.  If the file cannot be
+	//               read, this CompiledModel is made empty.
+	//
+	bool load (const std::string& filename);
+
+	//
+	//  makeEmpty
+	//
+	//  Purpose: To remove all contents from this CompiledModel.
+	//  Parameter(s): N/A
+	//  Precondition(s): N/A
+	//  Returns: N/A
+	//  Side Effect: All vertexes, triangles, meshes, and
+	//               materials are removed.
+	//
+	void makeEmpty ();
+
+private:
+	//
+	//  Mesh
+	//
+	//  A record of the triangles drawn with one material.
+	//
+	struct Mesh
+	{
+		unsigned int m_material;
+		unsigned int m_first_index;
+		unsigned int m_index_count;
+	};
+
+	//
+	//  Level
+	//
+	//  A record of the meshes drawn for one level of detail.
+	//
+	struct Level
+	{
+		unsigned int m_first_mesh;
+		unsigned int m_mesh_count;
+		float m_error;
+	};
+
+	//
+	//  Helper Function: draw
+	//
+	//  Purpose: To display the specified level of detail of
+	//           this CompiledModel.
+	//  Parameter(s):
+	//    <1> level: The level of detail
+	//  Precondition(s):
+	//    <1> level < getLevelCount()
+	//    <2> !ObjLibrary::Material::isMaterialActive()
+	//  Returns: N/A
+	//  Side Effect: Each mesh in level is drawn with one call
+	//               to glDrawElements, surrounded by its
+	//               material.
+	//
+	void draw (unsigned int level) const;
+
+	//
+	//  Helper Function: drawMeshes
+	//
+	//  Purpose: To draw the meshes for the specified level of
+	//           detail from the current vertex arrays.
+	//  Parameter(s):
+	//    <1> level: The level of detail
+	//  Precondition(s):
+	//    <1> level < getLevelCount()
+	//    <2> !ObjLibrary::Material::isMaterialActive()
+	//    <3> The vertex, normal, and texture coordinate arrays
+	//        are set up for this CompiledModel
+	//  Returns: N/A
+	//  Side Effect: Each mesh in level is drawn with one call
+	//               to glDrawElements, surrounded by its
+	//               material.  The vertex, normal, and texture
+	//               coordinate arrays are then disabled.
+	//
+	void drawMeshes (unsigned int level) const;
+
+	//
+	//  Helper Function: invariant
+	//
+	//  Purpose: To determine if the class invariant is true.
+	//  Parameter(s): N/A
+	//  Precondition(s): N/A
+	//  Returns: Whether the class invariant is true.
+	//  Side Effect: N/A
+	//
+	bool invariant () const;
+
+private:
+	std::vector<float> mv_vertexes;
+	std::vector<unsigned int> mv_indexes;
+	std::vector<Mesh> mv_meshes;
+	std::vector<ObjLibrary::Material> mv_materials;
+	std::vector<Level> mv_levels;
+};
+
+
+
+#endif
@@ -0,0 +1,224 @@
+//
+//  DebugOverlay.cpp
+//
+
+#include <cassert>
+#include <cmath>
+#include <vector>
+
+#include "ObjLibrary/Vector3.h"
+
+#include "Pi.h"
+#include "Renderer.h"
+#include "DebugOverlay.h"
+
+using namespace std;
+using namespace ObjLibrary;
+namespace
+{
+	//
+	//  addMarkerTriangle
+	//
+	//  Purpose: To add a triangle to the specified unit sphere,
+	//           facing outwards.
+	//  Parameter(s):
+	//    <1> rv_triangles: The sphere triangle vertexes
+	//    <2> a
+	//    <3> b
+	//    <4> c: The triangle corners
+	//  Precondition(s): N/A
+	//  Returns: N/A
+	//  Side Effect: The triangle is added to rv_triangles with
+	//               counterclockwise winding when seen from
+	//               outside the sphere.
+	//
+	void addMarkerTriangle (vector<Vector3>& rv_triangles,
+	                        const Vector3& a,
+	                        const Vector3& b,
+	                        const Vector3& c)
+	{
+		rv_triangles.push_back(a);
+		Vector3 normal = (b - a).crossProduct(c - a);
+		if(normal.dotProduct(a + b + c) >= 0.0)
+		{
+			rv_triangles.push_back(b);
+			rv_triangles.push_back(c);
+		}
+		else
+		{
+			rv_triangles.push_back(c);
+			rv_triangles.push_back(b);
+		}
+	}
+
+	//
+	//  calculateMarkerPoint
+	//
+	//  Purpose: To calculate a point on the unit marker sphere.
+	//  Parameter(s):
+	//    <1> stack: The stack, from 0 at the top to
+	//               MARKER_STACKS at the bottom
+	//    <2> slice: The slice around the Y axis
+	//  Precondition(s): N/A
+	//  Returns: The point.
+	//  Side Effect: N/A
+	//
+	Vector3 calculateMarkerPoint (unsigned int stack, unsigned int slice)
+	{
+		double latitude  = PI      * stack / DebugOverlay::MARKER_STACKS;
+		double longitude = PI * 2.0 * slice / DebugOverlay::MARKER_SLICES;
+		return Vector3(sin(latitude) * cos(longitude),
+		               cos(latitude),
+		               sin(latitude) * sin(longitude));
+	}
+
+	//
+	//  getMarkerTriangles
+	//
+	//  Purpose: To retrieve the triangles for a unit sphere
+	//           marker.
+	//  Parameter(s): N/A
+	//  Precondition(s): N/A
+	//  Returns: The triangle vertexes, 3 per triangle.
+	//  Side Effect: The first time this function is called, the
+	//               triangles are calculated.
+	//
+	const vector<Vector3>& getMarkerTriangles ()
+	{
+		static const vector<Vector3> TRIANGLES = [] ()
+		{
+			vector<Vector3> v_triangles;
+			for(unsigned int s = 0; s < DebugOverlay::MARKER_STACKS; s++)
+				for(unsigned int k = 0; k < DebugOverlay::MARKER_SLICES; k++)
+				{
+					Vector3 top_0    = calculateMarkerPoint(s,     k);
+					Vector3 top_1    = calculateMarkerPoint(s,     k + 1);
+					Vector3 bottom_0 = calculateMarkerPoint(s + 1, k);
+					Vector3 bottom_1 = calculateMarkerPoint(s + 1, k + 1);
+
+					// the top and bottom stacks are triangle fans
+					if(s != 0)
+						addMarkerTriangle(v_triangles, top_0, top_1, bottom_1);
+					if(s + 1 != DebugOverlay::MARKER_STACKS)
+						addMarkerTriangle(v_triangles, top_0, bottom_1, bottom_0);
+				}
+			return v_triangles;
+		} ();
+
+		assert(TRIANGLES.size() == DebugOverlay::getMarkerTriangleCount() * 3);
+		return TRIANGLES;
+	}
+
+}  // end of anonymous namespace
+
+
+
+const float DebugOverlay :: LINE_WIDTH = 3.0f;
+
+unsigned int DebugOverlay :: getMarkerTriangleCount ()
+{
+	return MARKER_SLICES * (MARKER_STACKS - 1) * 2;
+}
+
+
+
+DebugOverlay :: DebugOverlay ()
+		: mv_line_vertexes()
+		, mv_marker_vertexes()
+{
+	assert(invariant());
+}
+
+
+
+unsigned int DebugOverlay :: getLineCount () const
+{
+	return mv_line_vertexes.size() / (Renderer::FLOATS_PER_COLORED_VERTEX * 2);
+}
+
+unsigned int DebugOverlay :: getMarkerCount () const
+{
+	return mv_marker_vertexes.size() /
+	       (Renderer::FLOATS_PER_COLORED_VERTEX * 3 * getMarkerTriangleCount());
+}
+
+void DebugOverlay :: draw (Renderer& r_renderer) const
+{
+	if(!mv_line_vertexes.empty())
+	{
+		r_renderer.setLineWidth(LINE_WIDTH);
+		r_renderer.drawColoredLines(mv_line_vertexes);
+		r_renderer.setLineWidth(1.0f);
+	}
+
+	if(!mv_marker_vertexes.empty())
+		r_renderer.drawColoredTriangles(mv_marker_vertexes);
+}
+
+
+
+void DebugOverlay :: clearLines ()
+{
+	mv_line_vertexes.clear();
+
+	assert(invariant());
+}
+
+void DebugOverlay :: addLine (const Vector3& start,
+                              const Vector3& end,
+                              float red, float green, float blue)
+{
+	addVertex(mv_line_vertexes, (float)(start.x), (float)(start.y), (float)(start.z),
+	          red, green, blue);
+	addVertex(mv_line_vertexes, (float)(end.x), (float)(end.y), (float)(end.z),
+	          red, green, blue);
+
+	assert(invariant());
+}
+
+void DebugOverlay :: clearMarkers ()
+{
+	mv_marker_vertexes.clear();
+
+	assert(invariant());
+}
+
+void DebugOverlay :: addMarker (const Vector3& center,
+                                float radius,
+                                float red, float green, float blue)
+{
+	assert(radius >= 0.0f);
+
+	const vector<Vector3>& triangles = getMarkerTriangles();
+	for(unsigned int i = 0; i < triangles.size(); i++)
+	{
+		addVertex(mv_marker_vertexes,
+		          (float)(center.x + triangles[i].x * radius),
+		          (float)(center.y + triangles[i].y * radius),
+		          (float)(center.z + triangles[i].z * radius),
+		          red, green, blue);
+	}
+
+	assert(invariant());
+}
+
+
+
+void DebugOverlay :: addVertex (vector<float>& rv_vertexes,
+                                float x, float y, float z,
+                                float red, float green, float blue)
+{
+	rv_vertexes.push_back(red);
+	rv_vertexes.push_back(green);
+	rv_vertexes.push_back(blue);
+	rv_vertexes.push_back(x);
+	rv_vertexes.push_back(y);
+	rv_vertexes.push_back(z);
+}
+
+bool DebugOverlay :: invariant () const
+{
+	if(mv_line_vertexes  .size() % (Renderer::FLOATS_PER_COLORED_VERTEX * 2) != 0) return false;
+	if(mv_marker_vertexes.size() % (Renderer::FLOATS_PER_COLORED_VERTEX * 3) != 0) return false;
+	return true;
+}
@@ -0,0 +1,228 @@
+//
+//  DebugOverlay.h
+//
+//  A module to represent batched debugging geometry drawn over
+//    the world.
+//
+
+#ifndef DEBUG_OVERLAY_H
+#define DEBUG_OVERLAY_H
+
+#include <cassert>
+#include <vector>
+
+#include "ObjLibrary/Vector3.h"
+
+#include "Renderer.h"
+
+
+
+//
+//  DebugOverlay
+//
+//  A class to collect debugging geometry on the CPU and draw it
+//    in a few large batches.  The geometry is divided into
+//    lines, which normally stay the same for many frames (such
+//    as the movement graph), and markers, which are normally
+//    replaced every frame (such as search nodes).
+//
+//  Each marker is a copy of a low-polygon sphere that is
+//    scaled and translated on the CPU, so all the markers can
+//    be drawn in a single draw call.  A complete DebugOverlay
+//    is drawn with at most 2 draw calls.
+//
+//  Class Invariant:
+//    <1> mv_line_vertexes.size() %
+//                 (Renderer::FLOATS_PER_COLORED_VERTEX * 2) == 0
+//    <2> mv_marker_vertexes.size() %
+//                 (Renderer::FLOATS_PER_COLORED_VERTEX * 3) == 0
+//
+class DebugOverlay
+{
+public:
+	//
+	//  LINE_WIDTH
+	//
+	//  The width of the lines in pixels.
+	//
+	static const float LINE_WIDTH;
+
+	//
+	//  MARKER_SLICES
+	//  MARKER_STACKS
+	//
+	//  The number of subdivisions around and along the Y axis
+	//    for the marker sphere.
+	//
+	static const unsigned int MARKER_SLICES = 8;
+	static const unsigned int MARKER_STACKS = 6;
+
+	//
+	//  Class Function: getMarkerTriangleCount
+	//
+	//  Purpose: To determine the number of triangles used to
+	//           draw each marker.
+	//  Parameter(s): N/A
+	//  Precondition(s): N/A
+	//  Returns: The number of triangles per marker.
+	//  Side Effect: N/A
+	//
+	static unsigned int getMarkerTriangleCount ();
+
+public:
+	//
+	//  Default Constructor
+	//
+	//  Purpose: To create a new DebugOverlay with no lines and
+	//           no markers.
+	//  Parameter(s): N/A
+	//  Precondition(s): N/A
+	//  Returns: N/A
+	//  Side Effect: A new DebugOverlay is created.
+	//
+	DebugOverlay ();
+
+	DebugOverlay (const DebugOverlay& original) = default;
+	~DebugOverlay () = default;
+	DebugOverlay& operator= (const DebugOverlay& original) = default;
+
+	//
+	//  getLineCount
+	//
+	//  Purpose: To determine the number of lines in this
+	//           DebugOverlay.
+	//  Parameter(s): N/A
+	//  Precondition(s): N/A
+	//  Returns: The number of lines.
+	//  Side Effect: N/A
+	//
+	unsigned int getLineCount () const;
+
+	//
+	//  getMarkerCount
+	//
+	//  Purpose: To determine the number of markers in this
+	//           DebugOverlay.
+	//  Parameter(s): N/A
+	//  Precondition(s): N/A
+	//  Returns: The number of markers.
+	//  Side Effect: N/A
+	//
+	unsigned int getMarkerCount () const;
+
+	//
+	//  draw
+	//
+	//  Purpose: To display this DebugOverlay.
+	//  Parameter(s):
+	//    <1> r_renderer: The Renderer to draw with
+	//  Precondition(s): N/A
+	//  Returns: N/A
+	//  Side Effect: The lines are drawn in one draw call and
+	//               the markers are drawn in another.  Empty
+	//               batches are skipped.
+	//
+	void draw (Renderer& r_renderer) const;
+
+	//
+	//  clearLines
+	//
+	//  Purpose: To remove all lines from this DebugOverlay.
+	//  Parameter(s): N/A
+	//  Precondition(s): N/A
+	//  Returns: N/A
+	//  Side Effect: All lines are removed.
+	//
+	void clearLines ();
+
+	//
+	//  addLine
+	//
+	//  Purpose: To add a line to this DebugOverlay.
+	//  Parameter(s):
+	//    <1> start
+	//    <2> end: The ends of the line
+	//    <3> red
+	//    <4> green
+	//    <5> blue: The line color
+	//  Precondition(s): N/A
+	//  Returns: N/A
+	//  Side Effect: A line from start to end is added.
+	//
+	void addLine (const ObjLibrary::Vector3& start,
+	              const ObjLibrary::Vector3& end,
+	              float red, float green, float blue);
+
+	//
+	//  clearMarkers
+	//
+	//  Purpose: To remove all markers from this DebugOverlay.
+	//  Parameter(s): N/A
+	//  Precondition(s): N/A
+	//  Returns: N/A
+	//  Side Effect: All markers are removed.  The memory used
+	//               for them is kept, so refilling the markers
+	//               every frame does not allocate.
+	//
+	void clearMarkers ();
+
+	//
+	//  addMarker
+	//
+	//  Purpose: To add a spherical marker to this DebugOverlay.
+	//  Parameter(s):
+	//    <1> center: The center of the marker
+	//    <2> radius: The radius of the marker
+	//    <3> red
+	//    <4> green
+	//    <5> blue: The marker color
+	//  Precondition(s):
+	//    <1> radius >= 0.0f
+	//  Returns: N/A
+	//  Side Effect: A marker is added.
+	//
+	void addMarker (const ObjLibrary::Vector3& center,
+	                float radius,
+	                float red, float green, float blue);
+
+private:
+	//
+	//  Helper Function: addVertex
+	//
+	//  Purpose: To add a colored vertex to the specified
+	//           vertex array.
+	//  Parameter(s):
+	//    <1> rv_vertexes: The vertex array
+	//    <2> x
+	//    <3> y
+	//    <4> z: The vertex position
+	//    <5> red
+	//    <6> green
+	//    <7> blue: The vertex color
+	//  Precondition(s): N/A
+	//  Returns: N/A
+	//  Side Effect: The vertex is appended to rv_vertexes.
+	//
+	static void addVertex (std::vector<float>& rv_vertexes,
+	                       float x, float y, float z,
+	                       float red, float green, float blue);
+
+	//
+	//  Helper Function: invariant
+	//
+	//  Purpose: To determine if the class invariant is true.
+	//  Parameter(s): N/A
+	//  Precondition(s): N/A
+	//  Returns: Whether the class invariant is true.
+	//  Side Effect: N/A
+	//
+	bool invariant () const;
+
+private:
+	std::vector<float> mv_line_vertexes;
+	std::vector<float> mv_marker_vertexes;
+};
+
+
+
+#endif
@@ -4,16 +4,23 @@
 
 #include <cassert>
 #include <iostream>
+#include <memory>
+#include <vector>
 
-#include "GetGlut.h"
 #include "ObjLibrary/Vector3.h"
-#include "ObjLibrary/ObjModel.h"
 #include "ObjLibrary/DisplayList.h"
-#include "ObjLibrary/TextureManager.h"
 
 #include "Pi.h"
-#include "Random.h"
+#include "RandomStream.h"
 #include "DiskType.h"
+#include "LodView.h"
+#include "Renderer.h"
+#include "AssetLoader.h"
+#include "HeightmapMesh.h"
+#include "Heightmap.h"
+#include "HeightmapFormula.h"
+#include "HeightmapCache.h"
+#include "Profiler.h"
 #include "Disk.h"
 
 
@@ -24,8 +31,38 @@ namespace
 	const double SQRT2      = 1.4142135623730950488016887242097;
 	const double HALF_SQRT2 = SQRT2 * 0.5;
 
+	//
+	//  HEIGHTMAP_CELL_PIXELS_MIN
+	//
+	//  The smallest size in pixels that heightmap cells should
+	//    be drawn at.  Finer levels of detail would only add
+	//    triangles smaller than this.
+	//
+	const float HEIGHTMAP_CELL_PIXELS_MIN = 6.0f;
+
+	//
+	//  HEIGHTMAP_PIXELS_MIN
+	//
+	//  The smallest size in pixels that a heightmap is drawn
+	//    at.  Smaller heightmaps would cover only a few pixels
+	//    at their coarsest level of detail, so the disk is drawn
+	//    flat instead.
+	//
+	const float HEIGHTMAP_PIXELS_MIN = 32.0f;
+
+	//
+	//  SEED_ROTATION
+	//  SEED_HEIGHTMAP
+	//
+	//  The streams derived from the seed of a disk for its
+	//    rotation and its heightmap.
+	//
+	const uint64_t SEED_ROTATION  = 0;
+	const uint64_t SEED_HEIGHTMAP = 1;
+
 	bool g_is_initialized = false;
 	DisplayList ga_disk_list[DiskType::COUNT];
+	unsigned int ga_disk_vertex_count[DiskType::COUNT];
 
 
 
@@ -34,26 +71,12 @@ namespace
 
 
 
-const float Disk :: RADIUS_MIN =  6.0f;
-const float Disk :: RADIUS_MAX = 50.0f;
-
-
-
 unsigned int Disk :: calculateDiskType (float radius)
 {
 	assert(radius >= RADIUS_MIN);
 	assert(radius <= RADIUS_MAX);
 
-	if(radius < 8.0f)
-		return DiskType::RED_ROCK;
-	else if(radius < 12.0f)
-		return DiskType::LEAFY;
-	else if(radius < 20.0f)
-		return DiskType::ICY;
-	else if(radius < 30.0f)
-		return DiskType::SANDY;
-	else
-		return DiskType::GREY_ROCK;
+	return DiskType::getForRadius(radius);
 }
 
 bool Disk :: isModelsLoaded ()
@@ -61,16 +84,14 @@ bool Disk :: isModelsLoaded ()
 	return g_is_initialized;
 }
 
-void Disk :: loadModels ()
+void Disk :: loadModels (AssetLoader& r_loader)
 {
 	assert(!isModelsLoaded());
 
 	g_is_initialized = true;
 
 	for(unsigned int i = 0; i < DiskType::COUNT; i++)
-		ga_disk_list[i] = ObjModel(DiskType::getModelName(i)).getDisplayList();
-
-	assert(isModelsLoaded());
+		r_loader.addModel(DiskType::getModelName(i), ga_disk_list[i], ga_disk_vertex_count[i]);
 }
 
 
@@ -79,14 +100,23 @@ Disk :: Disk ()
 		: m_position()
 		, m_radius(RADIUS_MIN)
 		, m_disk_type(calculateDiskType(m_radius))
-		, m_heightmap(m_disk_type, false)
-		, m_rotation_radians(random1((float)(TWO_PI)))
+		, m_seed(RandomStream::createSeed())
+		, m_rotation_radians(RandomStream(RandomStream::mixSeed(m_seed, SEED_ROTATION)).random1((float)(TWO_PI)))
 {
 	assert(invariant());
 }
 
-Disk :: Disk (const Vector3& position, float radius) : m_position(position), m_radius(radius), m_disk_type(calculateDiskType(m_radius)), m_heightmap(m_disk_type, true)
-		, m_rotation_radians(random1((float)(TWO_PI)))
+Disk :: Disk (const Vector3& position, float radius)
+		: Disk(position, radius, RandomStream::createSeed())
+{
+}
+
+Disk :: Disk (const Vector3& position, float radius, uint64_t seed)
+		: m_position(position)
+		, m_radius(radius)
+		, m_disk_type(calculateDiskType(m_radius))
+		, m_seed(seed)
+		, m_rotation_radians(RandomStream(RandomStream::mixSeed(m_seed, SEED_ROTATION)).random1((float)(TWO_PI)))
 {
 	assert(position.y == 0);
 	assert(radius >= RADIUS_MIN);
@@ -111,8 +141,143 @@ unsigned int Disk :: getDiskType () const
 {
 	return m_disk_type;
 }
+
+uint64_t Disk :: getSeed () const
+{
+	return m_seed;
+}
 	
 float Disk :: getHeight (const Vector3& position) const
+{
+	PROFILE_COUNT(COUNTER_HEIGHT, 1);
+
+	return calculateHeight(HeightmapFormula(m_disk_type, getHeightmapSeed()), position);
+}
+
+bool Disk :: isHeightmapResident () const
+{
+	return HeightmapCache::isResident(m_disk_type, getHeightmapSeed());
+}
+
+bool Disk :: isHeightmapFinalized () const
+{
+	shared_ptr<Heightmap> p_heightmap = HeightmapCache::find(m_disk_type, getHeightmapSeed());
+	return p_heightmap != nullptr && p_heightmap->isFinalized();
+}
+
+unsigned int Disk :: getHeightmapLevelCount () const
+{
+	return Heightmap::calculateLevelCount(getHeightmapSideLength());
+}
+
+unsigned int Disk :: getHeightmapTriangleCount (unsigned int level) const
+{
+	assert(level < getHeightmapLevelCount());
+
+	unsigned int level_side_length = getHeightmapSideLength() >> level;
+	return level_side_length * level_side_length * 2;
+}
+
+unsigned int Disk :: chooseHeightmapLevel (const LodView& view) const
+{
+	// the heightmap is a square that just covers the disk
+	float heightmap_size = (float)(m_radius * SQRT2);
+	float pixels         = view.getProjectedSize(m_position, m_radius, heightmap_size);
+
+	unsigned int level_count = getHeightmapLevelCount();
+	unsigned int level = 0;
+	while(level + 1 < level_count &&
+	      pixels / (getHeightmapSideLength() >> level) < HEIGHTMAP_CELL_PIXELS_MIN)
+	{
+		level++;
+	}
+
+	assert(level < getHeightmapLevelCount());
+	return level;
+}
+
+bool Disk :: isHeightmapVisible (const LodView& view) const
+{
+	float heightmap_size = (float)(m_radius * SQRT2);
+	return view.getProjectedSize(m_position, m_radius, heightmap_size) >= HEIGHTMAP_PIXELS_MIN;
+}
+
+void Disk :: prefetchHeightmap () const
+{
+	getHeightmap();
+}
+
+vector<HeightmapMesh> Disk :: buildHeightmapMeshes () const
+{
+	shared_ptr<Heightmap> p_heightmap = HeightmapCache::find(m_disk_type, getHeightmapSeed());
+	if(p_heightmap == nullptr)
+		return Heightmap(m_disk_type, false, getHeightmapSeed()).buildMeshes();
+	else
+		return p_heightmap->buildMeshes();
+}
+
+void Disk :: draw (Renderer& r_renderer) const
+{
+	assert(isModelsLoaded());
+
+	draw(r_renderer, 0);
+}
+
+void Disk :: draw (Renderer& r_renderer,
+                   unsigned int heightmap_level) const
+{
+	assert(isModelsLoaded());
+	assert(heightmap_level < getHeightmapLevelCount());
+
+	shared_ptr<Heightmap> p_heightmap = getHeightmap();
+	if(!p_heightmap->isFinalized())
+	{
+		p_heightmap->finalize();
+		HeightmapCache::markFinalized(m_disk_type, getHeightmapSeed(), p_heightmap.get());
+	}
+
+	drawBase(r_renderer);
+		// draw heightmap
+		r_renderer.setColor(1.0, 1.0, 1.0);
+		r_renderer.setTexturing(true);
+		r_renderer.bindTexture(DiskType::getTextureName(m_disk_type));
+		p_heightmap->draw(r_renderer, heightmap_level);  // covers [0, 1] along x znd z
+		r_renderer.setTexturing(false);
+	r_renderer.popMatrix();
+}
+
+void Disk :: drawWithoutHeightmap (Renderer& r_renderer) const
+{
+	assert(isModelsLoaded());
+
+	drawBase(r_renderer);
+	r_renderer.popMatrix();
+}
+
+void Disk :: finalizeHeightmap (const vector<HeightmapMesh>& meshes) const
+{
+	shared_ptr<Heightmap> p_heightmap = getHeightmap();
+	if(!p_heightmap->isFinalized())
+	{
+		p_heightmap->finalize(meshes);
+		HeightmapCache::markFinalized(m_disk_type, getHeightmapSeed(), p_heightmap.get());
+	}
+}
+
+
+
+unsigned int Disk :: getHeightmapSideLength () const
+{
+	return DiskType::getSideLength(m_disk_type);
+}
+
+uint64_t Disk :: getHeightmapSeed () const
+{
+	return RandomStream::mixSeed(m_seed, SEED_HEIGHTMAP);
+}
+
+float Disk :: calculateHeight (const HeightmapFormula& formula,
+                               const Vector3& position) const
 {
 	if(DEBUGGING_GET_HEIGHT)
 	{
@@ -120,7 +285,7 @@ float Disk :: getHeight (const Vector3& position) const
 		cout << "\tDisk position: " << m_position << endl;
 		cout << "\tDisk radius: " << m_radius << endl;
 		cout << "\tDisk rotation: " << m_rotation_radians << " radians" << endl;
-		cout << "\tHeightmap size: " << m_heightmap.getSideLength() << endl;
+		cout << "\tHeightmap size: " << formula.getSideLength() << endl;
 		cout << "\tPlayer position: " << position << endl;
 	}
 
@@ -146,47 +311,42 @@ float Disk :: getHeight (const Vector3& position) const
 	if(DEBUGGING_GET_HEIGHT)
 		cout << "\tscaled_position2: " << scaled_position2 << endl;
 
-	float heightmap_i = (float)(scaled_position2.x) * m_heightmap.getSideLength();
-	float heightmap_j = (float)(scaled_position2.z) * m_heightmap.getSideLength();
+	float heightmap_i = (float)(scaled_position2.x) * formula.getSideLength();
+	float heightmap_j = (float)(scaled_position2.z) * formula.getSideLength();
 	if(DEBUGGING_GET_HEIGHT)
 	{
 		cout << "\tHeightmap coordinates: (" << heightmap_i << ", " << heightmap_j << ")" << endl;
-		cout << "\tHeight: " << m_heightmap.getHeight(heightmap_i, heightmap_j) << endl;
+		cout << "\tHeight: " << formula.getHeight(heightmap_i, heightmap_j) << endl;
 	}
-	return m_heightmap.getHeight(heightmap_i, heightmap_j);
+	return formula.getHeight(heightmap_i, heightmap_j);
+}
+
+shared_ptr<Heightmap> Disk :: getHeightmap () const
+{
+	return HeightmapCache::get(m_disk_type, getHeightmapSeed());
 }
 
-void Disk :: draw () const
+void Disk :: drawBase (Renderer& r_renderer) const
 {
 	assert(isModelsLoaded());
 
 	float rotation_degrees = (float)(m_rotation_radians * 180.0f / PI);
 
-	glPushMatrix();
+	r_renderer.pushMatrix();
 		// translate from world coordinates to disk coordinates
-		glTranslated(m_position.x, m_position.y, m_position.z);
-		glRotated(rotation_degrees, 0.0, 1.0, 0.0);
-		glScaled(m_radius, 1.0, m_radius);
+		r_renderer.translate(m_position.x, m_position.y, m_position.z);
+		r_renderer.rotate(rotation_degrees, 0.0, 1.0, 0.0);
+		r_renderer.scale(m_radius, 1.0, m_radius);
 
 		// draw disk
 		assert(m_disk_type < DiskType::COUNT);
-		ga_disk_list[m_disk_type].draw();
+		r_renderer.drawDisplayList(ga_disk_list[m_disk_type], ga_disk_vertex_count[m_disk_type]);
 
 		// translate from disk coordinates to heightmap coordinates
-		glTranslated(-HALF_SQRT2, 0.0, -HALF_SQRT2);
-		glScaled(SQRT2, 1.0, SQRT2);
-
-		// draw heightmap
-		glColor3d(1.0, 1.0, 1.0);
-		glEnable(GL_TEXTURE_2D);
-		TextureManager::activate(DiskType::getTextureName(m_disk_type));
-		m_heightmap.draw();  // covers [0, 1] along x znd z
-		glDisable(GL_TEXTURE_2D);
-	glPopMatrix();
+		r_renderer.translate(-HALF_SQRT2, 0.0, -HALF_SQRT2);
+		r_renderer.scale(SQRT2, 1.0, SQRT2);
 }
 
-
-
 bool Disk :: invariant () const
 {
 	if(m_position.y != 0) return false;
@@ -7,9 +7,19 @@
 #ifndef DISK_H
 #define DISK_H
 
+#include <cstdint>
+#include <memory>
+#include <vector>
+
 #include "ObjLibrary/Vector3.h"
 
+#include "LodView.h"
+#include "Renderer.h"
+#include "HeightmapMesh.h"
 #include "Heightmap.h"
+#include "HeightmapFormula.h"
+
+class AssetLoader;
 
 
 
@@ -18,6 +28,17 @@
 //
 //  A class to represent one disk in the world.
 //
+//  The heightmap for a Disk is not generated until it is
+//    drawn.  It is then kept in the HeightmapCache, which may
+//    evict it again to save memory, and it is regenerated from
+//    the seed the next time it is needed.  As a result, a Disk
+//    can be created quickly.  Heights are calculated from a
+//    HeightmapFormula instead, which gives the same values
+//    without generating the heightmap or using the
+//    HeightmapCache.  A Disk itself never changes, so the
+//    functions that do not draw can be called from any thread
+//    without locking.
+//
 //  Class Invariant:
 //    <1> m_position.y == 0
 //    <2> m_radius >= RADIUS_MIN
@@ -33,14 +54,14 @@ public:
 	//
 	//  The minimum legal radius for a disk.
 	//
-	static const float RADIUS_MIN;
+	static constexpr float RADIUS_MIN =  6.0f;
 
 	//
 	//  RADIUS_MAX
 	//
 	//  The maximum legal radius for a disk.
 	//
-	static const float RADIUS_MAX;
+	static constexpr float RADIUS_MAX = 50.0f;
 
 	//
 	//  Class Function: calculateDiskType
@@ -72,14 +93,18 @@ public:
 	//
 	//  Class Function: loadModels
 	//
-	//  Purpose: To load the models for the Disk class.
-	//  Parameter(s): N/A
+	//  Purpose: To queue the models for the Disk class to be
+	//           loaded.
+	//  Parameter(s):
+	//    <1> r_loader: The AssetLoader to load the models with
 	//  Precondition(s):
 	//    <1> !isModelsLoaded()
-	//  Returns: The Disk is initialized.
-	//  Side Effect: N/A
+	//  Returns: N/A
+	//  Side Effect: The models are queued in r_loader.  The
+	//               Disk class is initialized when
+	//               r_loader.finish() returns.
 	//
-	static void loadModels ();
+	static void loadModels (AssetLoader& r_loader);
 
 public:
 	//
@@ -109,15 +134,43 @@ public:
 	//  Returns: N/A
 	//  Side Effect: A new Disk is created at position position
 	//               radius radius and the appriopriate disk
-	//               type.  The disk rotation is determined
-	//               randomly.
+	//               type.  The disk rotation and heightmap are
+	//               determined randomly.
 	//
 	Disk (const ObjLibrary::Vector3& position,
 	      float radius);
 
+	//
+	//  Constructor
+	//
+	//  Purpose: To create a new Disk with the specified
+	//           position, radius, and seed.
+	//  Parameter(s):
+	//    <1> position: The center position
+	//    <2> radius: The disk radius
+	//    <3> seed: The seed for the disk rotation and heightmap
+	//  Precondition(s):
+	//    <1> position.y == 0
+	//    <2> radius >= RADIUS_MIN
+	//    <3> radius <= RADIUS_MAX
+	//  Returns: N/A
+	//  Side Effect: A new Disk is created at position position
+	//               radius radius and the appriopriate disk
+	//               type.  The disk rotation and heightmap are
+	//               determined by seed, so the same seed always
+	//               gives the same Disk.
+	//  Note: This constructor does not use OpenGL or rand() and
+	//        can be called from any thread.
+	//
+	Disk (const ObjLibrary::Vector3& position,
+	      float radius,
+	      uint64_t seed);
+
 	Disk (const Disk& original) = default;
+	Disk (Disk&& original) = default;
 	~Disk () = default;
 	Disk& operator= (const Disk& original) = default;
+	Disk& operator= (Disk&& original) = default;
 
 	//
 	//  getPosition
@@ -152,6 +205,19 @@ public:
 	//
 	unsigned int getDiskType () const;
 
+	//
+	//  getSeed
+	//
+	//  Purpose: To determine the seed this Disk was created
+	//           with.
+	//  Parameter(s): N/A
+	//  Precondition(s): N/A
+	//  Returns: The seed.  A Disk created with the same
+	//           position, radius, and seed is identical.
+	//  Side Effect: N/A
+	//
+	uint64_t getSeed () const;
+
 	//
 	//  getHeight
 	//
@@ -169,19 +235,270 @@ public:
 	//
 	float getHeight (const ObjLibrary::Vector3& position) const;
 
+	//
+	//  isHeightmapResident
+	//
+	//  Purpose: To determine if the heightmap for this Disk has
+	//           been generated and not evicted since.
+	//  Parameter(s): N/A
+	//  Precondition(s): N/A
+	//  Returns: Whether the heightmap is in the HeightmapCache.
+	//  Side Effect: N/A
+	//
+	bool isHeightmapResident () const;
+
+	//
+	//  isHeightmapFinalized
+	//
+	//  Purpose: To determine if the heightmap for this Disk has
+	//           been finalized.
+	//  Parameter(s): N/A
+	//  Precondition(s):
+	//    <1> Called from the thread with the OpenGL context
+	//  Returns: Whether the heightmap is resident and has been
+	//           finalized.
+	//  Side Effect: If the heightmap is resident, it is marked
+	//               as recently used.
+	//
+	bool isHeightmapFinalized () const;
+
+	//
+	//  getHeightmapLevelCount
+	//
+	//  Purpose: To determine the number of levels of detail for
+	//           the heightmap of this Disk.
+	//  Parameter(s): N/A
+	//  Precondition(s): N/A
+	//  Returns: The number of heightmap levels of detail.
+	//  Side Effect: N/A
+	//
+	unsigned int getHeightmapLevelCount () const;
+
+	//
+	//  getHeightmapTriangleCount
+	//
+	//  Purpose: To determine the number of triangles drawn for
+	//           the heightmap of this Disk at the specified
+	//           level of detail.
+	//  Parameter(s):
+	//    <1> level: Which level of detail
+	//  Precondition(s):
+	//    <1> level < getHeightmapLevelCount()
+	//  Returns: The number of heightmap triangles at level
+	//           level.
+	//  Side Effect: N/A
+	//
+	unsigned int getHeightmapTriangleCount (
+	                                 unsigned int level) const;
+
+	//
+	//  chooseHeightmapLevel
+	//
+	//  Purpose: To choose the level of detail for the heightmap
+	//           of this Disk based on how large it will appear
+	//           on the screen.
+	//  Parameter(s):
+	//    <1> view: The camera to draw for
+	//  Precondition(s): N/A
+	//  Returns: The finest level of detail at which no
+	//           heightmap cell will cover less than a few
+	//           pixels, or the coarsest level if there is no
+	//           such level.  The value returned is less than
+	//           getHeightmapLevelCount().
+	//  Side Effect: N/A
+	//
+	unsigned int chooseHeightmapLevel (const LodView& view) const;
+
+	//
+	//  isHeightmapVisible
+	//
+	//  Purpose: To determine whether the heightmap of this Disk
+	//           will appear large enough on the screen to be
+	//           worth drawing.
+	//  Parameter(s):
+	//    <1> view: The camera to draw for
+	//  Precondition(s): N/A
+	//  Returns: Whether the heightmap should be drawn.  If not,
+	//           this Disk can be drawn with drawWithoutHeightmap
+	//           instead, so that its heightmap is not generated
+	//           just to be drawn a few pixels across.
+	//  Side Effect: N/A
+	//
+	bool isHeightmapVisible (const LodView& view) const;
+
+	//
+	//  prefetchHeightmap
+	//
+	//  Purpose: To make sure the heightmap for this Disk is
+	//           resident.
+	//  Parameter(s): N/A
+	//  Precondition(s): N/A
+	//  Returns: N/A
+	//  Side Effect: If the heightmap is not resident, it is
+	//               generated and added to the HeightmapCache.
+	//               Otherwise, it is marked as recently used.
+	//
+	void prefetchHeightmap () const;
+
+	//
+	//  buildHeightmapMeshes
+	//
+	//  Purpose: To construct the 3D meshes for all levels of
+	//           detail of the heightmap of this Disk on the
+	//           CPU.
+	//  Parameter(s): N/A
+	//  Precondition(s): N/A
+	//  Returns: The heightmap meshes.  If the heightmap is not
+	//           resident, it is generated for this call only.
+	//  Side Effect: N/A
+	//  Note: This function does not use OpenGL and can be
+	//        called from any thread.
+	//
+	std::vector<HeightmapMesh> buildHeightmapMeshes () const;
+
 	//
 	//  draw
 	//
 	//  Purpose: To display this Disk.
-	//  Parameter(s): N/A
+	//  Parameter(s):
+	//    <1> r_renderer: The Renderer to draw with
 	//  Precondition(s):
 	//    <1> isModelsLoaded()
 	//  Returns: N/A
-	//  Side Effect: This Disk is displayed.
+	//  Side Effect: This Disk is displayed.  If the heightmap
+	//               is not resident, it is generated and added
+	//               to the HeightmapCache.  If it is not
+	//               finalized, it is finalized.
+	//
+	void draw (Renderer& r_renderer) const;
+
+	//
+	//  draw
+	//
+	//  Purpose: To display this Disk with the specified
+	//           heightmap level of detail.
+	//  Parameter(s):
+	//    <1> r_renderer: The Renderer to draw with
+	//    <2> heightmap_level: The level of detail for the
+	//                         heightmap
+	//  Precondition(s):
+	//    <1> isModelsLoaded()
+	//    <2> heightmap_level < getHeightmapLevelCount()
+	//  Returns: N/A
+	//  Side Effect: This Disk is displayed.  If the heightmap
+	//               is not resident, it is generated and added
+	//               to the HeightmapCache.  If it is not
+	//               finalized, it is finalized.
+	//
+	void draw (Renderer& r_renderer,
+	           unsigned int heightmap_level) const;
+
+	//
+	//  drawWithoutHeightmap
+	//
+	//  Purpose: To display this Disk without its heightmap.
+	//  Parameter(s):
+	//    <1> r_renderer: The Renderer to draw with
+	//  Precondition(s):
+	//    <1> isModelsLoaded()
+	//  Returns: N/A
+	//  Side Effect: This Disk is displayed with a flat top.
+	//
+	void drawWithoutHeightmap (Renderer& r_renderer) const;
+
+	//
+	//  finalizeHeightmap
+	//
+	//  Purpose: To finalize the heightmap for this Disk using
+	//           meshes that have already been built.
+	//  Parameter(s):
+	//    <1> meshes: The meshes returned by
+	//                buildHeightmapMeshes()
+	//  Precondition(s):
+	//    <1> Called from the thread with the OpenGL context
+	//  Returns: N/A
+	//  Side Effect: If the heightmap is not resident, it is
+	//               generated and added to the HeightmapCache.
+	//               If it is not finalized, the heightmap
+	//               meshes are copied to the graphics card.
 	//
-	void draw () const;
+	void finalizeHeightmap (
+	                   const std::vector<HeightmapMesh>& meshes) const;
 
 private:
+	//
+	//  Helper Function: getHeightmapSideLength
+	//
+	//  Purpose: To determine the side length of the heightmap
+	//           for this Disk without generating it.
+	//  Parameter(s): N/A
+	//  Precondition(s): N/A
+	//  Returns: The heightmap side length in cells.
+	//  Side Effect: N/A
+	//
+	unsigned int getHeightmapSideLength () const;
+
+	//
+	//  Helper Function: getHeightmapSeed
+	//
+	//  Purpose: To determine the seed for the heightmap of this
+	//           Disk.
+	//  Parameter(s): N/A
+	//  Precondition(s): N/A
+	//  Returns: The heightmap seed, which is derived from the
+	//           seed for this Disk.
+	//  Side Effect: N/A
+	//
+	uint64_t getHeightmapSeed () const;
+
+	//
+	//  Helper Function: calculateHeight
+	//
+	//  Purpose: To determine the height of this Disk at the
+	//           specified position using the specified
+	//           HeightmapFormula.
+	//  Parameter(s):
+	//    <1> formula: The HeightmapFormula for this Disk
+	//    <2> position: The position to test
+	//  Precondition(s): N/A
+	//  Returns: The height at position position, as described
+	//           for getHeight.
+	//  Side Effect: N/A
+	//
+	float calculateHeight (const HeightmapFormula& formula,
+	                       const ObjLibrary::Vector3& position) const;
+
+	//
+	//  Helper Function: getHeightmap
+	//
+	//  Purpose: To retrieve the heightmap for this Disk,
+	//           generating it if needed.
+	//  Parameter(s): N/A
+	//  Precondition(s): N/A
+	//  Returns: The heightmap.
+	//  Side Effect: If the heightmap is not resident, it is
+	//               generated and added to the HeightmapCache.
+	//               Otherwise, it is marked as recently used.
+	//
+	std::shared_ptr<Heightmap> getHeightmap () const;
+
+	//
+	//  Helper Function: drawBase
+	//
+	//  Purpose: To display this Disk with a flat top and leave
+	//           the transformation set for its heightmap.
+	//  Parameter(s):
+	//    <1> r_renderer: The Renderer to draw with
+	//  Precondition(s):
+	//    <1> isModelsLoaded()
+	//  Returns: N/A
+	//  Side Effect: The disk model is displayed and a matrix is
+	//               pushed on r_renderer that maps [0, 1] in X
+	//               and Z to the square covered by the
+	//               heightmap.  The caller must pop it.
+	//
+	void drawBase (Renderer& r_renderer) const;
+
 	//
 	//  Helper Function: invariant
 	//
@@ -197,7 +514,7 @@ private:
 	ObjLibrary::Vector3 m_position;
 	float m_radius;
 	unsigned int m_disk_type;
-	Heightmap m_heightmap;
+	uint64_t m_seed;
 	float m_rotation_radians;
 public:
 	std::vector<int> disk_node_list;
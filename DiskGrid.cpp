@@ -0,0 +1,118 @@
+//
+//  DiskGrid.cpp
+//
+
+#include <cassert>
+#include <cmath>
+#include <cstdint>
+#include <unordered_map>
+#include <vector>
+
+#include "ObjLibrary/Vector3.h"
+
+#include "DiskGrid.h"
+
+using namespace std;
+using namespace ObjLibrary;
+
+
+
+DiskGrid :: DiskGrid (double cell_size)
+		: m_cell_size(cell_size)
+		, m_cells()
+{
+	assert(cell_size > 0.0);
+
+	assert(invariant());
+}
+
+
+
+double DiskGrid :: getCellSize () const
+{
+	return m_cell_size;
+}
+
+unsigned int DiskGrid :: getCellCount () const
+{
+	return m_cells.size();
+}
+
+void DiskGrid :: getNear (const Vector3& position,
+                          double distance,
+                          vector<unsigned int>& rv_disks) const
+{
+	assert(distance >= 0.0);
+
+	int32_t x_min = getCellCoordinate(position.x - distance);
+	int32_t x_max = getCellCoordinate(position.x + distance);
+	int32_t z_min = getCellCoordinate(position.z - distance);
+	int32_t z_max = getCellCoordinate(position.z + distance);
+
+	for(int32_t z = z_min; z <= z_max; z++)
+		for(int32_t x = x_min; x <= x_max; x++)
+		{
+			auto it = m_cells.find(getCellKey(x, z));
+			if(it != m_cells.end())
+				rv_disks.insert(rv_disks.end(), it->second.begin(), it->second.end());
+		}
+}
+
+
+
+void DiskGrid :: clear ()
+{
+	m_cells.clear();
+
+	assert(invariant());
+}
+
+void DiskGrid :: insert (unsigned int disk,
+                         const Vector3& position)
+{
+	uint64_t key = getCellKey(getCellCoordinate(position.x), getCellCoordinate(position.z));
+	m_cells[key].push_back(disk);
+
+	assert(invariant());
+}
+
+bool DiskGrid :: remove (unsigned int disk,
+                         const Vector3& position)
+{
+	uint64_t key = getCellKey(getCellCoordinate(position.x), getCellCoordinate(position.z));
+	auto it = m_cells.find(key);
+	if(it == m_cells.end())
+		return false;
+
+	vector<unsigned int>& rv_cell = it->second;
+	for(unsigned int i = 0; i < rv_cell.size(); i++)
+		if(rv_cell[i] == disk)
+		{
+			rv_cell[i] = rv_cell.back();
+			rv_cell.pop_back();
+			if(rv_cell.empty())
+				m_cells.erase(it);
+
+			assert(invariant());
+			return true;
+		}
+	return false;
+}
+
+
+
+int32_t DiskGrid :: getCellCoordinate (double coordinate) const
+{
+	return (int32_t)(floor(coordinate / m_cell_size));
+}
+
+uint64_t DiskGrid :: getCellKey (int32_t x, int32_t z)
+{
+	return ((uint64_t)((uint32_t)(x)) << 32) | (uint64_t)((uint32_t)(z));
+}
+
+bool DiskGrid :: invariant () const
+{
+	if(!(m_cell_size > 0.0)) return false;
+	return true;
+}
@@ -0,0 +1,193 @@
+//
+//  DiskGrid.h
+//
+//  A module to find the disks near a position quickly.
+//
+//  This module does not use OpenGL, so it can be used by tools
+//    as well as the game.
+//
+
+#ifndef DISK_GRID_H
+#define DISK_GRID_H
+
+#include <cassert>
+#include <cstdint>
+#include <unordered_map>
+#include <vector>
+
+#include "ObjLibrary/Vector3.h"
+
+
+
+//
+//  DiskGrid
+//
+//  A class to sort the centers of disks into square cells in
+//    the XZ plane, so that the disks near a position can be
+//    found without checking every disk.  The disks themselves
+//    are identified only by index; the client keeps their
+//    positions and radii.
+//
+//  Only cells that contain a disk are stored, so the grid can
+//    cover any area.  If the cell size is at least twice the
+//    largest disk radius, the disks that can touch a disk are
+//    all in the 3x3 block of cells around it.
+//
+//  Class Invariant:
+//    <1> m_cell_size > 0.0
+//
+class DiskGrid
+{
+public:
+	//
+	//  Constructor
+	//
+	//  Purpose: To create a new, empty DiskGrid with the
+	//           specified cell size.
+	//  Parameter(s):
+	//    <1> cell_size: The side length of each cell
+	//  Precondition(s):
+	//    <1> cell_size > 0.0
+	//  Returns: N/A
+	//  Side Effect: A new DiskGrid is created.
+	//
+	explicit DiskGrid (double cell_size);
+
+	DiskGrid (const DiskGrid& original) = default;
+	~DiskGrid () = default;
+	DiskGrid& operator= (const DiskGrid& original) = default;
+
+	//
+	//  getCellSize
+	//
+	//  Purpose: To determine the side length of the cells.
+	//  Parameter(s): N/A
+	//  Precondition(s): N/A
+	//  Returns: The cell size.
+	//  Side Effect: N/A
+	//
+	double getCellSize () const;
+
+	//
+	//  getCellCount
+	//
+	//  Purpose: To determine how many cells contain disks.
+	//  Parameter(s): N/A
+	//  Precondition(s): N/A
+	//  Returns: The number of non-empty cells.
+	//  Side Effect: N/A
+	//
+	unsigned int getCellCount () const;
+
+	//
+	//  getNear
+	//
+	//  Purpose: To find the disks with centers near the
+	//           specified position.
+	//  Parameter(s):
+	//    <1> position: The position
+	//    <2> distance: The greatest horizontal distance
+	//    <3> rv_disks: A reference to the vector to add the
+	//                  disks to
+	//  Precondition(s):
+	//    <1> distance >= 0.0
+	//  Returns: N/A
+	//  Side Effect: Every disk with its center within distance
+	//               of position, ignoring the Y-coordinate, is
+	//               added to the end of rv_disks.  Some farther
+	//               disks may also be added, so the client must
+	//               check the distances itself.  The order of
+	//               the disks added is not specified.
+	//
+	void getNear (const ObjLibrary::Vector3& position,
+	              double distance,
+	              std::vector<unsigned int>& rv_disks) const;
+
+	//
+	//  clear
+	//
+	//  Purpose: To remove all disks from this DiskGrid.
+	//  Parameter(s): N/A
+	//  Precondition(s): N/A
+	//  Returns: N/A
+	//  Side Effect: This DiskGrid is set to be empty.
+	//
+	void clear ();
+
+	//
+	//  insert
+	//
+	//  Purpose: To add a disk to this DiskGrid.
+	//  Parameter(s):
+	//    <1> disk: The index of the disk
+	//    <2> position: The center of the disk
+	//  Precondition(s):
+	//    <1> disk is not already in this DiskGrid
+	//  Returns: N/A
+	//  Side Effect: Disk disk is added to the cell containing
+	//               position.
+	//
+	void insert (unsigned int disk,
+	             const ObjLibrary::Vector3& position);
+
+	//
+	//  remove
+	//
+	//  Purpose: To remove a disk from this DiskGrid.
+	//  Parameter(s):
+	//    <1> disk: The index of the disk
+	//    <2> position: The center the disk was inserted with
+	//  Precondition(s): N/A
+	//  Returns: Whether disk disk was found and removed.
+	//  Side Effect: Disk disk is removed from the cell
+	//               containing position, if it is there.
+	//
+	bool remove (unsigned int disk,
+	             const ObjLibrary::Vector3& position);
+
+private:
+	//
+	//  Helper Function: getCellCoordinate
+	//
+	//  Purpose: To determine which row or column of cells the
+	//           specified coordinate is in.
+	//  Parameter(s):
+	//    <1> coordinate: The X- or Z-coordinate
+	//  Precondition(s): N/A
+	//  Returns: The cell row or column.
+	//  Side Effect: N/A
+	//
+	int32_t getCellCoordinate (double coordinate) const;
+
+	//
+	//  Helper Function: getCellKey
+	//
+	//  Purpose: To combine a cell column and row into one key.
+	//  Parameter(s):
+	//    <1> x
+	//    <2> z: The cell column and row
+	//  Precondition(s): N/A
+	//  Returns: A key unique to cell (x, z).
+	//  Side Effect: N/A
+	//
+	static uint64_t getCellKey (int32_t x, int32_t z);
+
+	//
+	//  Helper Function: invariant
+	//
+	//  Purpose: To determine if the class invariant is true.
+	//  Parameter(s): N/A
+	//  Precondition(s): N/A
+	//  Returns: Whether the class invariant is true.
+	//  Side Effect: N/A
+	//
+	bool invariant () const;
+
+private:
+	double m_cell_size;
+	std::unordered_map<uint64_t, std::vector<unsigned int> > m_cells;
+};
+
+
+
+#endif
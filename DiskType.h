@@ -65,6 +65,35 @@ namespace DiskType
 
 
 
+	//
+	//  getForRadius
+	//
+	//  Purpose: To determine the type of a disk with the
+	//           specified radius.
+	//  Parameter(s):
+	//    <1> radius: The disk radius
+	//  Precondition(s):
+	//    <1> radius > 0.0f
+	//  Returns: The disk type for a disk of radius radius.
+	//  Side Effect: N/A
+	//
+	inline unsigned int getForRadius (float radius)
+	{
+		assert(radius > 0.0f);
+
+		if(radius < 8.0f)
+			return RED_ROCK;
+		else if(radius < 12.0f)
+			return LEAFY;
+		else if(radius < 20.0f)
+			return ICY;
+		else if(radius < 30.0f)
+			return SANDY;
+		else
+			return GREY_ROCK;
+	}
+
+
 	//
 	//  getModelName
 	//
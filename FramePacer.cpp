@@ -0,0 +1,283 @@
+//
+//  FramePacer.cpp
+//
+
+#include <cassert>
+#include <cmath>
+#include <atomic>
+#include <chrono>
+#include <iostream>
+#include <mutex>
+#include <thread>
+
+#include "FramePacer.h"
+
+using namespace std;
+namespace
+{
+	//
+	//  SLEEP_ESTIMATE_INITIAL
+	//
+	//  The time in seconds a sleep is assumed to take before
+	//    any have been measured.  This is on the high side, so
+	//    the first ticks spin rather than oversleep.
+	//
+	const double SLEEP_ESTIMATE_INITIAL = 0.005;
+
+	//
+	//  SLEEP_COUNT_MAX
+	//
+	//  The number of sleeps the running mean and variance are
+	//    taken over.  After this, older sleeps fade out, so the
+	//    estimate follows changes in the system timer.
+	//
+	const unsigned int SLEEP_COUNT_MAX = 1000;
+
+	//
+	//  SLEEP_DEVIATION_COUNT
+	//
+	//  The number of standard deviations above the mean sleep
+	//    length that a sleep is assumed to take.  This covers
+	//    all but a few percent of sleeps.
+	//
+	const double SLEEP_DEVIATION_COUNT = 2.0;
+
+	//
+	//  toSeconds
+	//
+	//  Purpose: To convert the specified duration to seconds.
+	//  Parameter(s):
+	//    <1> duration: The duration
+	//  Precondition(s): N/A
+	//  Returns: duration in seconds.
+	//  Side Effect: N/A
+	//
+	template <typename Duration>
+	double toSeconds (const Duration& duration)
+	{
+		return chrono::duration<double>(duration).count();
+	}
+}
+
+
+
+const double FramePacer :: LAG_MAX     = 0.25;
+const double FramePacer :: SLEEP_SLICE = 0.001;
+
+
+
+FramePacer :: FramePacer (double period)
+		: m_period(period)
+		, m_period_ns((Nanoseconds::rep)(period * 1.0e9 + 0.5))
+		, m_reset_time()
+		, m_schedule_start_ns(0)
+		, m_tick_count(0)
+		, m_last_wake_time()
+		, m_is_last_wake_on_time(false)
+		, m_sleep_mean(SLEEP_ESTIMATE_INITIAL)
+		, m_sleep_variance(0.0)
+		, m_sleep_count(0)
+		, m_sleep_estimate(SLEEP_ESTIMATE_INITIAL)
+		, m_statistics_mutex()
+{
+	assert(period > 0.0);
+
+	reset();
+
+	assert(invariant());
+}
+
+
+
+double FramePacer :: getPeriod () const
+{
+	return m_period;
+}
+
+unsigned int FramePacer :: getTickCount () const
+{
+	return m_tick_count.load();
+}
+
+double FramePacer :: getElapsedTime () const
+{
+	return toSeconds(Clock::now() - m_reset_time);
+}
+
+double FramePacer :: getTickPosition () const
+{
+	Nanoseconds::rep now_ns = chrono::duration_cast<Nanoseconds>(Clock::now().time_since_epoch()).count();
+	return (double)(now_ns - m_schedule_start_ns.load()) / m_period_ns.count();
+}
+
+FramePacer::Statistics FramePacer :: getStatistics () const
+{
+	lock_guard<mutex> lock(m_statistics_mutex);
+
+	Statistics statistics = m_statistics;
+	if(m_lateness_count > 0)
+		statistics.m_lateness_mean = m_lateness_total / m_lateness_count;
+	if(m_jitter_count > 0)
+		statistics.m_jitter_rms = sqrt(m_jitter_squared_total / m_jitter_count);
+	return statistics;
+}
+
+void FramePacer :: printStatistics (ostream& r_out) const
+{
+	Statistics statistics = getStatistics();
+	double waiting_time = statistics.m_sleep_time + statistics.m_spin_time;
+	double sleep_percent = 0.0;
+	if(waiting_time > 0.0)
+		sleep_percent = statistics.m_sleep_time / waiting_time * 100.0;
+
+	r_out << "Ticks:    " << statistics.m_tick_count
+	      << " (" << statistics.m_dropped_count << " dropped)" << endl;
+	r_out << "Lateness: " << statistics.m_lateness_mean * 1.0e6 << " us mean, "
+	      << statistics.m_lateness_max * 1.0e6 << " us max" << endl;
+	r_out << "Jitter:   " << statistics.m_jitter_rms * 1.0e6 << " us RMS, "
+	      << statistics.m_jitter_max * 1.0e6 << " us max" << endl;
+	r_out << "Waiting:  " << sleep_percent << "% asleep" << endl;
+}
+
+
+
+void FramePacer :: reset ()
+{
+	m_reset_time = Clock::now();
+	m_schedule_start_ns = chrono::duration_cast<Nanoseconds>(m_reset_time.time_since_epoch()).count();
+	m_tick_count = 0;
+	m_is_last_wake_on_time = false;
+	resetStatistics();
+
+	assert(invariant());
+}
+
+void FramePacer :: resetStatistics ()
+{
+	lock_guard<mutex> lock(m_statistics_mutex);
+
+	m_statistics.m_tick_count    = 0;
+	m_statistics.m_dropped_count = 0;
+	m_statistics.m_lateness_mean = 0.0;
+	m_statistics.m_lateness_max  = 0.0;
+	m_statistics.m_jitter_rms    = 0.0;
+	m_statistics.m_jitter_max    = 0.0;
+	m_statistics.m_sleep_time    = 0.0;
+	m_statistics.m_spin_time     = 0.0;
+	m_lateness_total       = 0.0;
+	m_lateness_count       = 0;
+	m_jitter_squared_total = 0.0;
+	m_jitter_count         = 0;
+}
+
+unsigned int FramePacer :: wait (unsigned int tick_count_max)
+{
+	assert(tick_count_max >= 1);
+
+	unsigned int tick = m_tick_count.load();
+	TimePoint due = getTickTime(tick);
+	TimePoint now = Clock::now();
+	bool is_on_time = false;
+	if(now < due)
+	{
+		now = waitUntil(due);
+		is_on_time = true;
+	}
+
+	// drop ticks beyond LAG_MAX and move the schedule forward to match
+	unsigned int dropped_count = 0;
+	double lag = toSeconds(now - due);
+	if(lag > LAG_MAX)
+	{
+		dropped_count = (unsigned int)((lag - LAG_MAX) / m_period) + 1;
+		m_schedule_start_ns += m_period_ns.count() * dropped_count;
+		due = getTickTime(tick);
+	}
+
+	unsigned int due_count = (unsigned int)((now - due) / m_period_ns) + 1;
+	if(due_count > tick_count_max)
+		due_count = tick_count_max;
+	m_tick_count = tick + due_count;
+
+	{
+		lock_guard<mutex> lock(m_statistics_mutex);
+
+		m_statistics.m_tick_count    += due_count;
+		m_statistics.m_dropped_count += dropped_count;
+		if(is_on_time)
+		{
+			double lateness = toSeconds(now - due);
+			m_lateness_total += lateness;
+			m_lateness_count++;
+			if(lateness > m_statistics.m_lateness_max)
+				m_statistics.m_lateness_max = lateness;
+
+			// jitter is how far the time between ticks is from the period
+			if(m_is_last_wake_on_time)
+			{
+				double interval = toSeconds(now - m_last_wake_time);
+				double jitter   = fabs(interval - m_period);
+				m_jitter_squared_total += jitter * jitter;
+				m_jitter_count++;
+				if(jitter > m_statistics.m_jitter_max)
+					m_statistics.m_jitter_max = jitter;
+			}
+		}
+	}
+	m_last_wake_time       = now;
+	m_is_last_wake_on_time = is_on_time && due_count == 1;
+
+	assert(invariant());
+	return due_count;
+}
+
+
+
+FramePacer::TimePoint FramePacer :: getTickTime (unsigned int tick) const
+{
+	return TimePoint(chrono::duration_cast<Clock::duration>(Nanoseconds(m_schedule_start_ns.load()))) +
+	       chrono::duration_cast<Clock::duration>(m_period_ns * tick);
+}
+
+FramePacer::TimePoint FramePacer :: waitUntil (TimePoint target)
+{
+	TimePoint now = Clock::now();
+
+	// sleep while even a long sleep would end in time
+	TimePoint sleep_start = now;
+	while(toSeconds(target - now) > m_sleep_estimate)
+	{
+		TimePoint before = now;
+		this_thread::sleep_for(chrono::duration<double>(SLEEP_SLICE));
+		now = Clock::now();
+
+		double slept = toSeconds(now - before);
+		if(m_sleep_count < SLEEP_COUNT_MAX)
+			m_sleep_count++;
+		double weight = 1.0 / m_sleep_count;
+		double delta  = slept - m_sleep_mean;
+		m_sleep_mean     += weight * delta;
+		m_sleep_variance  = (1.0 - weight) * (m_sleep_variance + weight * delta * delta);
+		m_sleep_estimate  = m_sleep_mean + SLEEP_DEVIATION_COUNT * sqrt(m_sleep_variance);
+	}
+
+	// then spin for the rest
+	TimePoint spin_start = now;
+	while(now < target)
+	{
+		this_thread::yield();
+		now = Clock::now();
+	}
+
+	lock_guard<mutex> lock(m_statistics_mutex);
+	m_statistics.m_sleep_time += toSeconds(spin_start - sleep_start);
+	m_statistics.m_spin_time  += toSeconds(now - spin_start);
+	return now;
+}
+
+bool FramePacer :: invariant () const
+{
+	if(m_period <= 0.0) return false;
+	if(m_sleep_estimate < 0.0) return false;
+	return true;
+}
@@ -0,0 +1,303 @@
+//
+//  FramePacer.h
+//
+//  A module to wait for frames that are due at a fixed rate.
+//
+
+#ifndef FRAME_PACER_H
+#define FRAME_PACER_H
+
+#include <cassert>
+#include <atomic>
+#include <chrono>
+#include <iostream>
+#include <mutex>
+
+
+
+//
+//  FramePacer
+//
+//  A class to space out ticks at a fixed period using a
+//    monotonic clock with nanosecond resolution.
+//
+//  Tick N is due at a fixed time N periods after the start, so
+//    errors in waiting do not add up over time.  If the caller
+//    falls more than LAG_MAX seconds behind, the ticks it has
+//    missed beyond that are dropped and the schedule is moved
+//    forward, so it does not try to catch up forever.
+//
+//  Waiting is done in two stages.  While the next tick is
+//    further away than the time a short sleep might overshoot
+//    by, the thread sleeps for SLEEP_SLICE.  It then yields
+//    until the tick is due.  The overshoot is estimated from
+//    the sleeps themselves, as their mean plus one standard
+//    deviation, so the spinning stays short on systems with
+//    accurate timers and grows on systems with coarse ones.
+//
+//  Statistics are kept on how late each tick was, how much
+//    the time between ticks varied, and how much of the
+//    waiting was spent sleeping.  They may be read from any
+//    thread.  The other functions may only be called by the
+//    thread that waits, except getTickPosition.
+//
+//  A FramePacer cannot be copied.
+//
+//  Class Invariant:
+//    <1> m_period > 0.0
+//    <2> m_sleep_estimate >= 0.0
+//
+class FramePacer
+{
+public:
+	//
+	//  LAG_MAX
+	//
+	//  How far behind the schedule in seconds the caller may
+	//    fall before ticks are dropped.
+	//
+	static const double LAG_MAX;
+
+	//
+	//  SLEEP_SLICE
+	//
+	//  The length in seconds of each sleep.
+	//
+	static const double SLEEP_SLICE;
+
+	//
+	//  Statistics
+	//
+	//  A record of how well the ticks were spaced.  All times
+	//    are in seconds.
+	//
+	struct Statistics
+	{
+		unsigned int m_tick_count;
+		unsigned int m_dropped_count;
+		double m_lateness_mean;
+		double m_lateness_max;
+		double m_jitter_rms;
+		double m_jitter_max;
+		double m_sleep_time;
+		double m_spin_time;
+	};
+
+public:
+	//
+	//  Constructor
+	//
+	//  Purpose: To create a new FramePacer with the specified
+	//           period.
+	//  Parameter(s):
+	//    <1> period: The time between ticks in seconds
+	//  Precondition(s):
+	//    <1> period > 0.0
+	//  Returns: N/A
+	//  Side Effect: A new FramePacer is created with tick 0
+	//               due immediately.
+	//
+	FramePacer (double period);
+
+	FramePacer (const FramePacer& original) = delete;
+	FramePacer& operator= (const FramePacer& original) = delete;
+
+	//
+	//  getPeriod
+	//
+	//  Purpose: To determine the time between ticks.
+	//  Parameter(s): N/A
+	//  Precondition(s): N/A
+	//  Returns: The period in seconds.
+	//  Side Effect: N/A
+	//
+	double getPeriod () const;
+
+	//
+	//  getTickCount
+	//
+	//  Purpose: To determine the number of ticks that have
+	//           been handed out by wait.
+	//  Parameter(s): N/A
+	//  Precondition(s): N/A
+	//  Returns: The number of ticks, not counting dropped
+	//           ticks.
+	//  Side Effect: N/A
+	//
+	unsigned int getTickCount () const;
+
+	//
+	//  getElapsedTime
+	//
+	//  Purpose: To determine the time since this FramePacer was
+	//           last reset.
+	//  Parameter(s): N/A
+	//  Precondition(s): N/A
+	//  Returns: The elapsed time in seconds.  Dropped ticks do
+	//           not affect it.
+	//  Side Effect: N/A
+	//
+	double getElapsedTime () const;
+
+	//
+	//  getTickPosition
+	//
+	//  Purpose: To determine how far along the schedule the
+	//           current time is.
+	//  Parameter(s): N/A
+	//  Precondition(s): N/A
+	//  Returns: The current time, measured in ticks since the
+	//           schedule started.  A value from N to N + 1
+	//           means tick N is due and tick N + 1 is not.
+	//           This function may be called from any thread.
+	//  Side Effect: N/A
+	//
+	double getTickPosition () const;
+
+	//
+	//  getStatistics
+	//
+	//  Purpose: To retrieve the timing statistics.
+	//  Parameter(s): N/A
+	//  Precondition(s): N/A
+	//  Returns: The statistics since they were last reset.
+	//           This function may be called from any thread.
+	//  Side Effect: N/A
+	//
+	Statistics getStatistics () const;
+
+	//
+	//  printStatistics
+	//
+	//  Purpose: To print the timing statistics.
+	//  Parameter(s):
+	//    <1> r_out: The stream to print to
+	//  Precondition(s): N/A
+	//  Returns: N/A
+	//  Side Effect: The statistics are printed to r_out in
+	//               microseconds.
+	//
+	void printStatistics (std::ostream& r_out) const;
+
+	//
+	//  reset
+	//
+	//  Purpose: To restart the schedule.
+	//  Parameter(s): N/A
+	//  Precondition(s): N/A
+	//  Returns: N/A
+	//  Side Effect: The tick count is set to 0, tick 0 becomes
+	//               due immediately, and the statistics are
+	//               reset.
+	//
+	void reset ();
+
+	//
+	//  resetStatistics
+	//
+	//  Purpose: To clear the timing statistics.
+	//  Parameter(s): N/A
+	//  Precondition(s): N/A
+	//  Returns: N/A
+	//  Side Effect: The statistics are reset.  The schedule is
+	//               not changed.
+	//
+	void resetStatistics ();
+
+	//
+	//  wait
+	//
+	//  Purpose: To wait until at least one tick is due.
+	//  Parameter(s):
+	//    <1> tick_count_max: The greatest number of ticks to
+	//                        hand out
+	//  Precondition(s):
+	//    <1> tick_count_max >= 1
+	//  Returns: The number of ticks that are due, up to
+	//           tick_count_max.  The caller should run that
+	//           many ticks.
+	//  Side Effect: If no tick is due, this function sleeps
+	//               and then spins until one is.  The ticks
+	//               returned are counted as handed out.  Ticks
+	//               more than LAG_MAX overdue are dropped.  The
+	//               statistics are updated.
+	//
+	unsigned int wait (unsigned int tick_count_max);
+
+private:
+	//
+	//  Clock
+	//  TimePoint
+	//  Nanoseconds
+	//
+	//  The types used for time.
+	//
+	typedef std::chrono::steady_clock Clock;
+	typedef Clock::time_point TimePoint;
+	typedef std::chrono::nanoseconds Nanoseconds;
+
+	//
+	//  Helper Function: getTickTime
+	//
+	//  Purpose: To determine when the specified tick is due.
+	//  Parameter(s):
+	//    <1> tick: The tick
+	//  Precondition(s): N/A
+	//  Returns: The time tick is due.
+	//  Side Effect: N/A
+	//
+	TimePoint getTickTime (unsigned int tick) const;
+
+	//
+	//  Helper Function: waitUntil
+	//
+	//  Purpose: To wait until the specified time.
+	//  Parameter(s):
+	//    <1> target: The time to wait until
+	//  Precondition(s): N/A
+	//  Returns: The time waiting ended.
+	//  Side Effect: This thread sleeps and then spins until
+	//               target.  The estimate of how much a sleep
+	//               overshoots is updated, and the time spent
+	//               sleeping and spinning is recorded.
+	//
+	TimePoint waitUntil (TimePoint target);
+
+	//
+	//  Helper Function: invariant
+	//
+	//  Purpose: To determine if the class invariant is true.
+	//  Parameter(s): N/A
+	//  Precondition(s): N/A
+	//  Returns: Whether the class invariant is true.
+	//  Side Effect: N/A
+	//
+	bool invariant () const;
+
+private:
+	double m_period;
+	Nanoseconds m_period_ns;
+	TimePoint m_reset_time;
+	std::atomic<Nanoseconds::rep> m_schedule_start_ns;
+	std::atomic<unsigned int> m_tick_count;
+	TimePoint m_last_wake_time;
+	bool m_is_last_wake_on_time;
+
+	// running mean and variance of sleep lengths
+	double m_sleep_mean;
+	double m_sleep_variance;
+	unsigned int m_sleep_count;
+	double m_sleep_estimate;
+
+	// guards the statistics
+	mutable std::mutex m_statistics_mutex;
+	Statistics m_statistics;
+	double m_lateness_total;
+	unsigned int m_lateness_count;
+	double m_jitter_squared_total;
+	unsigned int m_jitter_count;
+};
+
+
+
+#endif
@@ -3,28 +3,36 @@
 //
 
 #include <cassert>
+#include <cstdint>
 #include <cstdlib>
+#include <memory>
 #include <string>
 #include <iostream>
 #include <fstream>
 #include <vector>
 #include <deque>
 
-#include "GetGlut.h"
 #include "Pi.h"
 #include "Random.h"
 #include "ObjLibrary/Vector3.h"
-#include "ObjLibrary/ObjModel.h"
 #include "ObjLibrary/DisplayList.h"
 
 #include "PhysicsFrameLength.h"
 #include "DiskType.h"
+#include "LodView.h"
+#include "Renderer.h"
+#include "AssetLoader.h"
+#include "DebugOverlay.h"
 #include "Heightmap.h"
 #include "Disk.h"
 #include "Rod.h"
 #include "Ring.h"
 #include "Player.h"
+#include "RandomStream.h"
+#include "GameSnapshot.h"
+#include "GameCheckpoint.h"
 #include "Collision.h"
+#include "Profiler.h"
 #include "Game.h"
 #include "World.h"
 #include "Nodes.h"
@@ -43,7 +51,50 @@ namespace
 	const float   PLAYER_STRAFE_ACCELERATION   = 10.0f;  // meters per second squared
 	const float   PLAYER_TURN_RATE             =  2.0f;  // radians per frame
 
+	//
+	//  PLAYER_PREFETCH_DISTANCE
+	//
+	//  How close a disk must be to the player for its heightmap
+	//    to be generated before it is drawn.
+	//
+	const float PLAYER_PREFETCH_DISTANCE = 100.0f;
+
+	//
+	//  RING_PATH_PREFETCH_DISTANCE
+	//
+	//  How close a ring must be to the player for the disks
+	//    along its path to be prefetched.  There is a ring on
+	//    every disk, so prefetching along every path would
+	//    generate every heightmap in the world.
+	//
+	const float RING_PATH_PREFETCH_DISTANCE = 100.0f;
+
+	//
+	//  RING_PATH_PREFETCH_LENGTH
+	//
+	//  How far ahead along a ring path disks are prefetched.
+	//    Rings move a few meters per second, so this covers
+	//    several seconds of movement.  A path can cross the whole
+	//    world, and the rest of it is too far ahead to matter.
+	//
+	const float RING_PATH_PREFETCH_LENGTH = 100.0f;
+
+	//
+	//  RING_PATH_PREFETCH_SPACING
+	//
+	//  How far apart the positions along a ring path that disks
+	//    are prefetched around are.  The path nodes are much
+	//    closer together than this, and prefetching around every
+	//    one of them would find the same disks many times.  Every
+	//    disk within this distance of a position is prefetched,
+	//    so no disk under the path is missed.
+	//
+	const float RING_PATH_PREFETCH_SPACING = Disk::RADIUS_MIN;
+
 	DisplayList g_skybox_list;
+	unsigned int g_skybox_vertex_count = 0;
+
+	const bool IS_PRINT_LOAD_TIMES = true;
 }
 
 
@@ -62,12 +113,16 @@ void Game :: loadModels ()
 {
 	assert(!isModelsLoaded());
 
-	g_skybox_list = ObjModel("Models/Skybox.obj").getDisplayList();
+	AssetLoader loader;
+	loader.addModel("Models/Skybox.obj", g_skybox_list, g_skybox_vertex_count);
+	Disk  ::loadModels(loader);
+	Rod   ::loadModels(loader);
+	Ring  ::loadModels(loader);
+	Player::loadModels(loader);
+	loader.finish();
 
-	Disk  ::loadModels();
-	Rod   ::loadModels();
-	Ring  ::loadModels();
-	Player::loadModels();
+	if(IS_PRINT_LOAD_TIMES)
+		loader.printTimes(cout);
 
 	assert(isModelsLoaded());
 }
@@ -75,21 +130,25 @@ void Game :: loadModels ()
 
 
 Game :: Game ()
-		: m_world()
+		: mp_world()
 		, mv_rods()
 		, mv_rings()
 		, m_player()
 		, m_score(0)
+		, m_random(0)
+		, mp_drawn_world()
 {
 	assert(invariant());
 }
 
 Game :: Game (const std::string& filename)
-		: m_world()
+		: mp_world()
 		, mv_rods()
 		, mv_rings()
 		, m_player()
 		, m_score(0)
+		, m_random(0)
+		, mp_drawn_world()
 {
 	assert(filename != "");
 
@@ -99,11 +158,36 @@ Game :: Game (const std::string& filename)
 	assert(invariant());
 }
 
+Game :: Game (const shared_ptr<const World>& p_world)
+		: mp_world()
+		, mv_rods()
+		, mv_rings()
+		, m_player()
+		, m_score(0)
+		, m_random(0)
+		, mp_drawn_world()
+{
+	assert(p_world != nullptr);
+	assert(p_world->isInitialized());
+
+	assert(invariant());
+	init(p_world);
+
+	assert(invariant());
+}
+
 
 
 bool Game :: isInitialized () const
 {
-	return m_world.isInitialized();
+	return mp_world != nullptr && mp_world->isInitialized();
+}
+
+const shared_ptr<const World>& Game :: getWorld () const
+{
+	assert(isInitialized());
+
+	return mp_world;
 }
 
 bool Game :: isGameOver () const
@@ -121,66 +205,133 @@ int Game :: getScore () const
 	return m_score;
 }
 
-ObjLibrary::Vector3 Game :: getCameraPosition () const
+Vector3 Game :: getPlayerPosition () const
 {
-	return m_player.getPosition() -
-	       m_player.getForward() * CAMERA_DISTANCE_HORIZONTAL +
-	       CAMERA_UP             * CAMERA_DISTANCE_VERTICAL;
+	assert(isInitialized());
+
+	return m_player.getPosition();
 }
 
-void Game :: setupCamera () const
+shared_ptr<const GameSnapshot> Game :: makeSnapshot (unsigned int update_count,
+                                                    bool is_search_shown) const
 {
 	assert(isInitialized());
 
-	Vector3 player_position = m_player.getPosition();
-	Vector3 camera_position = getCameraPosition();
+	return make_shared<const GameSnapshot>(update_count, mp_world, m_score, m_player,
+	                                       mv_rods, mv_rings, is_search_shown);
+}
+
+void Game :: saveCheckpoint (GameCheckpoint& r_checkpoint) const
+{
+	assert(isInitialized());
+
+	r_checkpoint.start(mp_world);
+
+	r_checkpoint.writeUnsigned((unsigned int)(mv_rods.size()));
+	for(unsigned int i = 0; i < mv_rods.size(); i++)
+		mv_rods[i].saveCheckpoint(r_checkpoint);
+
+	r_checkpoint.writeUnsigned((unsigned int)(mv_rings.size()));
+	for(unsigned int i = 0; i < mv_rings.size(); i++)
+		mv_rings[i].saveCheckpoint(r_checkpoint);
+
+	m_player.saveCheckpoint(r_checkpoint);
+	r_checkpoint.writeInt(m_score);
+	r_checkpoint.writeUint64(m_random.getState());
+
+	r_checkpoint.writeUnsigned((unsigned int)(path.size()));
+	for(unsigned int i = 0; i < path.size(); i++)
+		r_checkpoint.writeInt(path[i]);
+}
+
+ObjLibrary::Vector3 Game :: getCameraPosition (const GameSnapshot& snapshot) const
+{
+	assert(snapshot.getWorld() != nullptr);
+
+	const Player& player = snapshot.getPlayer();
+	return player.getPosition() -
+	       player.getForward() * CAMERA_DISTANCE_HORIZONTAL +
+	       CAMERA_UP           * CAMERA_DISTANCE_VERTICAL;
+}
+
+void Game :: setupCamera (Renderer& r_renderer,
+                          const GameSnapshot& snapshot) const
+{
+	assert(snapshot.getWorld() != nullptr);
+
+	Vector3 player_position = snapshot.getPlayer().getPosition();
+	Vector3 camera_position = getCameraPosition(snapshot);
 
-	gluLookAt(camera_position.x, camera_position.y, camera_position.z,
-	          player_position.x, player_position.y, player_position.z,
-	                CAMERA_UP.x,       CAMERA_UP.y,       CAMERA_UP.z);
+	r_renderer.lookAt(camera_position, player_position, CAMERA_UP);
 }
 
-void Game :: drawSkybox () const
+void Game :: drawSkybox (Renderer& r_renderer,
+                         const GameSnapshot& snapshot) const
 {
 	assert(isModelsLoaded());
-	assert(isInitialized());
+	assert(snapshot.getWorld() != nullptr);
+
+	PROFILE_SCOPE(SECTION_SKYBOX);
+
+	Vector3 camera_position = getCameraPosition(snapshot);
+
+	r_renderer.setDepthWrite(false);
+	r_renderer.pushMatrix();
+		r_renderer.translate(camera_position.x, camera_position.y, camera_position.z);
+		r_renderer.drawDisplayList(g_skybox_list, g_skybox_vertex_count);
+	r_renderer.popMatrix();
+	r_renderer.setDepthWrite(true);
+}
 
-	Vector3 camera_position = getCameraPosition();
+unsigned int Game :: getTerrainTriangleCountDrawn () const
+{
+	if(mp_drawn_world == nullptr)
+		return 0;
+	return mp_drawn_world->getTerrainTriangleCountDrawn();
+}
 
-	glDepthMask(GL_FALSE);
-	glPushMatrix();
-		glTranslated(camera_position.x, camera_position.y, camera_position.z);
-		g_skybox_list.draw();
-	glPopMatrix();
-	glDepthMask(GL_TRUE);
+unsigned int Game :: getTerrainTriangleCountFull () const
+{
+	if(mp_drawn_world == nullptr)
+		return 0;
+	return mp_drawn_world->getTerrainTriangleCountFull();
 }
 
-void Game :: draw () 
+void Game :: draw (Renderer& r_renderer,
+                   const LodView& view,
+                   const GameSnapshot& snapshot)
 {
 	assert(isModelsLoaded());
-	assert(isInitialized());
+	assert(snapshot.getWorld() != nullptr);
 
-	m_world.draw();
-	if(over)
-	m_world.Display_movementGraph();
-	for(unsigned int i = 0; i < mv_rods.size(); i++)
-		mv_rods[i].draw();
-	for (unsigned int i = 0; i < mv_rings.size(); i++)
+	// the graph lines only change when the world does
+	if(snapshot.getWorld() != mp_drawn_world)
 	{
-		mv_rings[i].draw();
-		
-		
+		mp_drawn_world = snapshot.getWorld();
+		m_debug_overlay.clearLines();
+		mp_drawn_world->addMovementGraphLines(m_debug_overlay);
+	}
 
-		//if (copy == 1)
-			
+	mp_drawn_world->draw(r_renderer, view);
+	{
+		PROFILE_SCOPE(SECTION_OBJECTS);
+		snapshot.draw(r_renderer, view);
 	}
 
-	if (over)
+	if(snapshot.isSearchShown())
 	{
-		mv_rings[0].drawSpheres();
-		mv_rings[0].drawPath();
+		PROFILE_SCOPE(SECTION_SEARCH_OVERLAY);
+		// the graph lines stay the same, but the search changes
+		const Ring& search_ring = snapshot.getSearchRing();
+		m_debug_overlay.clearMarkers();
+		search_ring.addSearchMarkers(m_debug_overlay);
+		m_debug_overlay.draw(r_renderer);
+		search_ring.drawPath(r_renderer);
+	}
+	{
+		PROFILE_SCOPE(SECTION_PLAYER_MODEL);
+		snapshot.getPlayer().draw(r_renderer, view);
 	}
-	m_player.draw();
 }
 
 
@@ -189,14 +340,31 @@ void Game :: init (const std::string& filename)
 {
 	assert(filename != "");
 
-	m_world.init(filename);
-	
-	for (int i = 0; i < m_world.all_nodes.size(); i++)
-	{
-		game_nodes.push_back(m_world.all_nodes[i]);
-	}
-	initSearchdata();
-//	bestSearchData();
+	shared_ptr<World> p_world = make_shared<World>();
+	if(!p_world->init(filename))
+		exit(1);
+	init(p_world);
+
+	assert(invariant());
+}
+
+void Game :: init (const shared_ptr<const World>& p_world)
+{
+	assert(p_world != nullptr);
+	assert(p_world->isInitialized());
+
+	init(p_world, RandomStream::createSeed());
+}
+
+void Game :: init (const shared_ptr<const World>& p_world,
+                   uint64_t seed)
+{
+	assert(p_world != nullptr);
+	assert(p_world->isInitialized());
+
+	mp_world = p_world;
+
+	m_random = RandomStream(seed);
 	mv_rods.clear();
 	
 	initRods();
@@ -204,57 +372,116 @@ void Game :: init (const std::string& filename)
 	mv_rings.clear();
 	initRings();
 
-	Vector3 player_position = m_world.getDisk(0).getPosition();
-	player_position.y = m_world.getHeightOnDisk(player_position) + Player::HALF_HEIGHT;
+	Vector3 player_position = mp_world->getDisk(0).getPosition();
+	player_position.y = mp_world->getHeightOnDisk(player_position) + Player::HALF_HEIGHT;
 	m_player.init(player_position);
 
 	m_score = 0;
+	path.clear();
 
 	assert(invariant());
 }
-/*
-void Game :: update ()
+
+void Game :: switchTo (Game& r_other,
+                       bool is_keep_player)
 {
-	assert(isInitialized());
-	int target = random1(6);
-	m_player.update(m_world);
-	for (int i = 0; i < game_nodes.size(); i++)
-	{
-		
-	}
-		
+	assert(r_other.isInitialized());
 
-	for (unsigned int i = 0; i < mv_rings.size(); i++)
+	swap(mp_world, r_other.mp_world);
+	mv_rods .swap(r_other.mv_rods);
+	mv_rings.swap(r_other.mv_rings);
+	if(!is_keep_player)
 	{
-		//
-		//Dijkstras_path(game_nodes[i].pos_node, i, game_nodes[target].pos_node, target);
-		//if(target<6)
-		
-		mv_rings[i].update(m_world, game_nodes, path);
-		
+		swap(m_player, r_other.m_player);
+		swap(m_score,  r_other.m_score);
 	}
-	
-
-	handleCollisions();
+	swap(m_random, r_other.m_random);
+	path.swap(r_other.path);
 
 	assert(invariant());
+	assert(isInitialized());
 }
-*/
 
+void Game :: restoreCheckpoint (const GameCheckpoint& checkpoint)
+{
+	assert(!checkpoint.isEmpty());
+
+	// the number of rods and rings depends on the World
+	if(checkpoint.getWorld() != mp_world)
+		init(checkpoint.getWorld());
+
+	size_t offset = 0;
+
+	unsigned int rod_count = checkpoint.readUnsigned(offset);
+	assert(rod_count == mv_rods.size());
+	for(unsigned int i = 0; i < rod_count; i++)
+		mv_rods[i].restoreCheckpoint(checkpoint, offset);
+
+	unsigned int ring_count = checkpoint.readUnsigned(offset);
+	assert(ring_count == mv_rings.size());
+	for(unsigned int i = 0; i < ring_count; i++)
+		mv_rings[i].restoreCheckpoint(checkpoint, offset);
+
+	m_player.restoreCheckpoint(checkpoint, offset);
+	m_score  = checkpoint.readInt(offset);
+	m_random = RandomStream(checkpoint.readUint64(offset));
+
+	unsigned int path_length = checkpoint.readUnsigned(offset);
+	path.clear();
+	for(unsigned int i = 0; i < path_length; i++)
+		path.push_back(checkpoint.readInt(offset));
+
+	assert(offset == checkpoint.getByteCount());
+	assert(invariant());
+}
 void Game::update()
 {
 	assert(isInitialized());
 
-	m_player.update(m_world);
-	for (unsigned int i = 0; i < mv_rings.size(); i++)
 	{
-		
-		mv_rings[i].update(m_world, game_nodes);
-		
+		// generate heightmaps in parallel instead of one at a time when drawn
+		mp_world->prefetchHeightmaps(vector<Vector3>(1, m_player.getPosition()), PLAYER_PREFETCH_DISTANCE);
+
+		vector<Vector3> v_path_positions;
+		vector<Vector3> v_prefetch_positions;
+		for(unsigned int i = 0; i < mv_rings.size(); i++)
+		{
+			if(mv_rings[i].getPosition().getDistanceXZ(m_player.getPosition()) > RING_PATH_PREFETCH_DISTANCE)
+				continue;
+
+			v_path_positions.clear();
+			mv_rings[i].getPathPositions(v_path_positions);
+			Vector3 previous    = mv_rings[i].getPosition();
+			float   path_length = 0.0f;
+			for(unsigned int p = 0; p < v_path_positions.size() && path_length <= RING_PATH_PREFETCH_LENGTH; p++)
+			{
+				path_length += (float)(v_path_positions[p].getDistanceXZ(previous));
+				previous     = v_path_positions[p];
+				if(p == 0 || v_path_positions[p].getDistanceXZ(v_prefetch_positions.back()) >= RING_PATH_PREFETCH_SPACING)
+					v_prefetch_positions.push_back(v_path_positions[p]);
+			}
+		}
+		mp_world->prefetchHeightmaps(v_prefetch_positions, RING_PATH_PREFETCH_SPACING);
+	}
+	{
+		PROFILE_SCOPE(SECTION_PLAYER);
+		m_player.update(*mp_world);
+	}
+	{
+		PROFILE_SCOPE(SECTION_RINGS);
+		for (unsigned int i = 0; i < mv_rings.size(); i++)
+		{
+			
+			mv_rings[i].update(*mp_world, m_random);
+			
+		}
 	}
 		
 
-	handleCollisions();
+	{
+		PROFILE_SCOPE(SECTION_COLLISIONS);
+		handleCollisions();
+	}
 
 	assert(invariant());
 }
@@ -266,7 +493,7 @@ void Game :: playerAccelerateForward ()
 	assert(isInitialized());
 	assert(!isPlayerJumping());
 
-	const Disk& closest_disk = m_world.getClosestDisk(m_player.getPosition());
+	const Disk& closest_disk = mp_world->getClosestDisk(m_player.getPosition());
 	float factor = DiskType::getAccelerationFactor(closest_disk.getDiskType());
 	m_player.accelerateForward(PLAYER_FORWARD_ACCELERATION * factor);
 	m_player.markRunning(true);
@@ -279,7 +506,7 @@ void Game :: playerAccelerateBackward ()
 	assert(isInitialized());
 	assert(!isPlayerJumping());
 
-	const Disk& closest_disk = m_world.getClosestDisk(m_player.getPosition());
+	const Disk& closest_disk = mp_world->getClosestDisk(m_player.getPosition());
 	float factor = DiskType::getAccelerationFactor(closest_disk.getDiskType());
 	m_player.accelerateForward(-PLAYER_BACKWARD_ACCELERATION * factor);
 	m_player.markRunning(false);
@@ -292,7 +519,7 @@ void Game :: playerAccelerateLeft ()
 	assert(isInitialized());
 	assert(!isPlayerJumping());
 
-	const Disk& closest_disk = m_world.getClosestDisk(m_player.getPosition());
+	const Disk& closest_disk = mp_world->getClosestDisk(m_player.getPosition());
 	float factor = DiskType::getAccelerationFactor(closest_disk.getDiskType());
 	m_player.accelerateLeft(PLAYER_STRAFE_ACCELERATION * factor);
 
@@ -304,7 +531,7 @@ void Game :: playerAccelerateRight ()
 	assert(isInitialized());
 	assert(!isPlayerJumping());
 
-	const Disk& closest_disk = m_world.getClosestDisk(m_player.getPosition());
+	const Disk& closest_disk = mp_world->getClosestDisk(m_player.getPosition());
 	float factor = DiskType::getAccelerationFactor(closest_disk.getDiskType());
 	m_player.accelerateLeft(-PLAYER_STRAFE_ACCELERATION * factor);
 
@@ -339,16 +566,40 @@ void Game :: playerJump ()
 	assert(invariant());
 }
 
+void Game :: handleInput (unsigned int input)
+{
+	assert(isInitialized());
+
+	if((input & INPUT_TURN_LEFT) != 0)
+		playerTurnLeft();
+	if((input & INPUT_TURN_RIGHT) != 0)
+		playerTurnRight();
+
+	if(!isPlayerJumping())
+	{
+		if((input & INPUT_FORWARD) != 0)
+			playerAccelerateForward();
+		if((input & INPUT_BACKWARD) != 0)
+			playerAccelerateBackward();
+		if((input & INPUT_LEFT) != 0)
+			playerAccelerateLeft();
+		if((input & INPUT_RIGHT) != 0)
+			playerAccelerateRight();
+		if((input & INPUT_JUMP) != 0)
+			playerJump();
+	}
+}
+
 
 
 void Game :: initRods ()
 {
-	assert(m_world.isInitialized());
+	assert(isInitialized());
 	assert(mv_rods.empty());
 
-	for(unsigned int i = 0; i < m_world.getDiskCount(); i++)
+	for(unsigned int i = 0; i < mp_world->getDiskCount(); i++)
 	{
-		const Disk& disk = m_world.getDisk(i);
+		const Disk& disk = mp_world->getDisk(i);
 		Vector3 position = disk.getPosition();
 		position.y = Rod::HALF_HEIGHT + disk.getHeight(position);
 		unsigned int points = 1 + disk.getDiskType();
@@ -359,18 +610,18 @@ void Game :: initRods ()
 
 void Game :: initRings ()
 {
-	assert(m_world.isInitialized());
+	assert(isInitialized());
 	assert(mv_rings.empty());
 
 
 
-	for( int i = 0; i < m_world.getDiskCount(); i++)
+	for( int i = 0; i < mp_world->getDiskCount(); i++)
 	{
-		Vector3 position = game_nodes[i].pos_node;
+		Vector3 position = mp_world->getNodes()[i].pos_node;
 
-		position.y = Ring::HALF_HEIGHT + m_world.getHeightOnDisk(position);
+		position.y = Ring::HALF_HEIGHT + mp_world->getHeightOnDisk(position);
 
-		mv_rings.push_back({ (position), i , game_nodes});
+		mv_rings.push_back({ (position), i , m_random });
 	}
 	mv_rings[0].copy = 1;
 }
@@ -414,74 +665,7 @@ void Game :: handleCollisions ()
 
 bool Game :: invariant () const
 {
-	if(m_world.isInitialized() && m_world.getDiskCount() != mv_rods.size()) return false;
-	if(m_world.isInitialized() && m_world.getDiskCount() != mv_rings.size()) return false;
+	if(isInitialized() && mp_world->getDiskCount() != mv_rods.size()) return false;
+	if(isInitialized() && mp_world->getDiskCount() != mv_rings.size()) return false;
 	return true;
 }
-
-void Game::initSearchdata()
-{
-	for (int i = 0; i < game_nodes.size(); i++)
-	{
-		if(i!=0)
-			game_nodes[i].search_data_node.push_back({ i-1, m_world.m_graph[i].disk_links[0].weight, 0.0, (m_world.m_graph[i].disk_links[0].weight + 0.0) });
-		else
-			game_nodes[i].search_data_node.push_back({ 0, m_world.m_graph[i].disk_links[0].weight, 0.0, (m_world.m_graph[i].disk_links[0].weight + 0.0) });
-	}
-
-}
-
-void Game::bestSearchData()
-{
-	for (int k = 0; k < game_nodes.size(); k++)		
-	{
-
-		std::vector<Search_data> temp_searchsata;
-
-		for (int l = 0; l < m_world.m_graph[k].disk_links.size(); l++)
-		{
-			if (k != 0)
-				temp_searchsata.push_back({ k - 1, (m_world.m_graph[k].disk_links[l].weight + m_world.m_graph[k-1].disk_links[l].weight) , 0.0, ((m_world.m_graph[k].disk_links[l].weight + m_world.m_graph[k - 1].disk_links[l].weight) + 0.0) });
-			else
-				temp_searchsata.push_back({ 0, (m_world.m_graph[k].disk_links[l].weight ) , 0.0, ((m_world.m_graph[k].disk_links[l].weight) + 0.0) });
-		}
-
-		for (int l = 0; l < temp_searchsata.size(); l++)
-		{
-			if (temp_searchsata[l].g < game_nodes[k].search_data_node[0].g)
-			{
-				game_nodes[k].search_data_node[0].previous_node_id = temp_searchsata[l].previous_node_id;
-				game_nodes[k].search_data_node[0].g = temp_searchsata[l].g;
-				game_nodes[k].search_data_node[0].h = temp_searchsata[l].h;
-				game_nodes[k].search_data_node[0].f = temp_searchsata[l].f;
-			}
-		}
-		//if ( <
-
-		
-	}
-}
-
-
-void Game::Dijkstras_path(Vector3 source_pos, int source_node_id, Vector3 dest_pos, int dest_node_id )
-{
-	int current_node;
-	if (source_node_id != dest_node_id)
-	{
-		for (current_node = dest_node_id; game_nodes[current_node].search_data_node[0].previous_node_id != source_node_id; current_node = game_nodes[current_node].search_data_node[0].previous_node_id)
-
-			//while (game_nodes[current_node].search_data_node[0].previous_node_id != source_node_id)
-		{
-			path.push_back(current_node);
-			//current_node = 
-
-		}
-		path.push_back(current_node);
-		//path.push_back(source_node_id);
-		//for (int i = 0; i < path.size(); i++)
-
-		cout << "\n"<<path.size();
-	}
-	
-}
-
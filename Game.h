@@ -8,18 +8,26 @@
 #define GAME_H
 
 #include <cassert>
+#include <cstdint>
+#include <memory>
 #include <string>
 #include <vector>
 #include <deque>
 
 #include "ObjLibrary/Vector3.h"
 
+#include "LodView.h"
+#include "Renderer.h"
+#include "DebugOverlay.h"
 #include "Heightmap.h"
 #include "Disk.h"
 #include "World.h"
 #include "Rod.h"
 #include "Ring.h"
 #include "Player.h"
+#include "RandomStream.h"
+#include "GameSnapshot.h"
+#include "GameCheckpoint.h"
 #include "Nodes.h"
 
 
@@ -29,15 +37,70 @@
 //
 //  A class to represent the state of the game.
 //
+//  A Game may be updated on one thread while it is displayed
+//    on another.  The functions used for display take a
+//    GameSnapshot of the changing state, and only read the
+//    World it refers to, which does not change after it is
+//    initialized.  The disk heightmaps are generated as either
+//    thread needs them, but the HeightmapCache that holds them
+//    is thread-safe.  The debugging overlay and the World last
+//    drawn are only used by the display thread.
+//
+//  The World is shared, so it can be loaded on another thread
+//    and kept after the Game stops using it.  A Game never
+//    changes its World, so any number of Games, on any number
+//    of threads, can share one.  A Game can be
+//    prepared for a World ahead of time and then switched to
+//    with switchTo between physics frames, which only
+//    exchanges pointers.
+//
+//  The state that changes during play, including the
+//    RandomStream the rings choose their targets with, can be
+//    saved to a GameCheckpoint and restored later, which is
+//    much faster than initializing the Game again.  A Game
+//    restored from a GameCheckpoint plays on exactly as the
+//    saved Game did, given the same key presses.
+//
 //  Class Invariant:
-//    <1> !m_world.isInitialized() ||
-//        m_world.getDiskCount() == mv_rods.size()
-//    <2> !m_world.isInitialized() ||
-//        m_world.getDiskCount() == mv_rings.size()
+//    <1> !isInitialized() ||
+//        mp_world->getDiskCount() == mv_rods.size()
+//    <2> !isInitialized() ||
+//        mp_world->getDiskCount() == mv_rings.size()
 //
 class Game
 {
 public:
+	//
+	//  INPUT_TURN_LEFT
+	//  INPUT_TURN_RIGHT
+	//  INPUT_FORWARD
+	//  INPUT_BACKWARD
+	//  INPUT_LEFT
+	//  INPUT_RIGHT
+	//  INPUT_JUMP
+	//
+	//  The bits of an input bitmask, which holds the player
+	//    controls used for one physics frame.  A game is the
+	//    same every time it is played with the same seeds and
+	//    the same input bitmasks.
+	//
+	static const unsigned int INPUT_TURN_LEFT  = 0x01;
+	static const unsigned int INPUT_TURN_RIGHT = 0x02;
+	static const unsigned int INPUT_FORWARD    = 0x04;
+	static const unsigned int INPUT_BACKWARD   = 0x08;
+	static const unsigned int INPUT_LEFT       = 0x10;
+	static const unsigned int INPUT_RIGHT      = 0x20;
+	static const unsigned int INPUT_JUMP       = 0x40;
+
+	//
+	//  INPUT_RESTART
+	//
+	//  The input bit for restarting the game.  It is not
+	//    handled by handleInput, because the Game does not know
+	//    what state to restart from.
+	//
+	static const unsigned int INPUT_RESTART    = 0x80;
+
 	//
 	//  Class Function: isModelsLoaded
 	//
@@ -59,7 +122,10 @@ public:
 	//    <1> !isModelsLoaded()
 	//  Returns: The Game is initialized.  This includes
 	//           initializing the classes it is composed from.
-	//  Side Effect: N/A
+	//  Side Effect: The models are read on worker threads and
+	//               added to OpenGL on this thread.  The time
+	//               taken for each model and texture may be
+	//               printed to standard output.
 	//
 	static void loadModels ();
 
@@ -90,6 +156,22 @@ public:
 	//
 	Game (const std::string& filename);
 
+	//
+	//  Constructor
+	//
+	//  Purpose: To create a new Game and initialize it with the
+	//           specified World.
+	//  Parameter(s):
+	//    <1> p_world: The World
+	//  Precondition(s):
+	//    <1> p_world != nullptr
+	//    <2> p_world->isInitialized()
+	//  Returns: N/A
+	//  Side Effect: A new Game is initialized in World
+	//               p_world.
+	//
+	Game (const std::shared_ptr<const World>& p_world);
+
 	Game (const Game& original) = default;
 	~Game () = default;
 	Game& operator= (const Game& original) = default;
@@ -105,6 +187,18 @@ public:
 	//
 	bool isInitialized () const;
 
+	//
+	//  getWorld
+	//
+	//  Purpose: To retrieve the World this Game is in.
+	//  Parameter(s): N/A
+	//  Precondition(s):
+	//    <1> isInitialized()
+	//  Returns: The World.
+	//  Side Effect: N/A
+	//
+	const std::shared_ptr<const World>& getWorld () const;
+
 	//
 	//  isGameOver
 	//
@@ -144,55 +238,155 @@ public:
 	int getScore () const;
 
 	//
-	//  getCameraPosition
+	//  getPlayerPosition
 	//
-	//  Purpose: To determine the position of the camera for
-	//           this Game.
+	//  Purpose: To determine where the player is.
 	//  Parameter(s): N/A
 	//  Precondition(s):
 	//    <1> isInitialized()
+	//  Returns: The position of the player.
+	//  Side Effect: N/A
+	//
+	ObjLibrary::Vector3 getPlayerPosition () const;
+
+	//
+	//  makeSnapshot
+	//
+	//  Purpose: To create a GameSnapshot of the current state
+	//           of this Game.
+	//  Parameter(s):
+	//    <1> update_count: The number of times this Game has
+	//                      been updated
+	//    <2> is_search_shown: Whether to include the path
+	//                         search for the overview
+	//  Precondition(s):
+	//    <1> isInitialized()
+	//  Returns: The new GameSnapshot.  It is never changed
+	//           afterwards and may be shared between threads.
+	//  Side Effect: N/A
+	//
+	std::shared_ptr<const GameSnapshot> makeSnapshot (
+	                                     unsigned int update_count,
+	                                     bool is_search_shown) const;
+
+	//
+	//  saveCheckpoint
+	//
+	//  Purpose: To save the current state of this Game.
+	//  Parameter(s):
+	//    <1> r_checkpoint: The GameCheckpoint to save to
+	//  Precondition(s):
+	//    <1> isInitialized()
+	//  Returns: N/A
+	//  Side Effect: r_checkpoint is set to hold the state of
+	//               the rods, rings, player, score, and random
+	//               numbers for this Game, and to share the
+	//               World.  The memory already used by
+	//               r_checkpoint is reused.
+	//
+	void saveCheckpoint (GameCheckpoint& r_checkpoint) const;
+
+	//
+	//  getCameraPosition
+	//
+	//  Purpose: To determine the position of the camera for
+	//           the specified GameSnapshot of this Game.
+	//  Parameter(s):
+	//    <1> snapshot: The GameSnapshot being displayed
+	//  Precondition(s):
+	//    <1> snapshot.getWorld() != nullptr
 	//  Returns: The position of the camera.
 	//  Side Effect: N/A
 	//
-	ObjLibrary::Vector3 getCameraPosition () const;
+	ObjLibrary::Vector3 getCameraPosition (
+	                            const GameSnapshot& snapshot) const;
 
 	//
 	//  setupCamera
 	//
-	//  Purpose: To set up the camera for this Game.
-	//  Parameter(s): N/A
+	//  Purpose: To set up the camera for the specified
+	//           GameSnapshot of this Game.
+	//  Parameter(s):
+	//    <1> r_renderer: The Renderer to set the camera for
+	//    <2> snapshot: The GameSnapshot being displayed
 	//  Precondition(s):
-	//    <1> isInitialized()
+	//    <1> snapshot.getWorld() != nullptr
 	//  Returns: N/A
 	//  Side Effect: The camera is set up for this Game.
 	//
-	void setupCamera () const;
+	void setupCamera (Renderer& r_renderer,
+	                  const GameSnapshot& snapshot) const;
 
 	//
 	//  drawSkybox
 	//
-	//  Purpose: To display the skybox for this Game.
-	//  Parameter(s): N/A
+	//  Purpose: To display the skybox for the specified
+	//           GameSnapshot of this Game.
+	//  Parameter(s):
+	//    <1> r_renderer: The Renderer to draw with
+	//    <2> snapshot: The GameSnapshot being displayed
 	//  Precondition(s):
 	//    <1> isModelsLoaded()
-	//    <2> isInitialized()
+	//    <2> snapshot.getWorld() != nullptr
 	//  Returns: N/A
 	//  Side Effect: The skybox for this Game is displayed.
 	//
-	void drawSkybox () const;
+	void drawSkybox (Renderer& r_renderer,
+	                 const GameSnapshot& snapshot) const;
 
 	//
-	//  draw
+	//  getTerrainTriangleCountDrawn
 	//
-	//  Purpose: To display this Game.
+	//  Purpose: To determine the number of heightmap triangles
+	//           drawn the last time this Game was displayed.
 	//  Parameter(s): N/A
+	//  Precondition(s): N/A
+	//  Returns: The number of heightmap triangles drawn, or 0
+	//           if this Game has not been displayed.
+	//  Side Effect: N/A
+	//
+	unsigned int getTerrainTriangleCountDrawn () const;
+
+	//
+	//  getTerrainTriangleCountFull
+	//
+	//  Purpose: To determine the number of heightmap triangles
+	//           that would have been drawn the last time this
+	//           Game was displayed without levels of detail.
+	//  Parameter(s): N/A
+	//  Precondition(s): N/A
+	//  Returns: The number of heightmap triangles at full
+	//           detail, or 0 if this Game has not been
+	//           displayed.
+	//  Side Effect: N/A
+	//
+	unsigned int getTerrainTriangleCountFull () const;
+
+	//
+	//  draw
+	//
+	//  Purpose: To display the specified GameSnapshot of this
+	//           Game.
+	//  Parameter(s):
+	//    <1> r_renderer: The Renderer to draw with
+	//    <2> view: The camera being drawn for
+	//    <3> snapshot: The GameSnapshot to display
 	//  Precondition(s):
 	//    <1> isModelsLoaded()
-	//    <2> isInitialized()
+	//    <2> snapshot.getWorld() != nullptr
 	//  Returns: N/A
-	//  Side Effect: The state of this Game is displayed.
+	//  Side Effect: The world and snapshot are displayed.  The
+	//               levels of detail are chosen for view.  If
+	//               snapshot includes a path search, it is
+	//               displayed with the movement graph.  The
+	//               World of snapshot is drawn, not the one
+	//               this Game is in now, so a GameSnapshot from
+	//               before switchTo is still displayed
+	//               correctly.
 	//
-	void draw ();
+	void draw (Renderer& r_renderer,
+	           const LodView& view,
+	           const GameSnapshot& snapshot);
 
 	//
 	//  init
@@ -206,10 +400,92 @@ public:
 	//  Returns: N/A
 	//  Side Effect: This Game is initialized from file
 	//               filename.  The current state of this Game,
-	//               if any, is lost.
+	//               if any, is lost.  If the file cannot be
+	//               loaded, an error message is printed and the
+	//               program is terminated.
 	//
 	void init (const std::string& filename);
 
+	//
+	//  init
+	//
+	//  Purpose: To initialize this Game in the specified World.
+	//  Parameter(s):
+	//    <1> p_world: The World
+	//  Precondition(s):
+	//    <1> p_world != nullptr
+	//    <2> p_world->isInitialized()
+	//  Returns: N/A
+	//  Side Effect: This Game is initialized in World p_world,
+	//               which it shares.  The current state of this
+	//               Game, if any, is lost.
+	//
+	void init (const std::shared_ptr<const World>& p_world);
+
+	//
+	//  init
+	//
+	//  Purpose: To initialize this Game in the specified World
+	//           with the specified seed.
+	//  Parameter(s):
+	//    <1> p_world: The World
+	//    <2> seed: The seed for the ring rotations and targets
+	//  Precondition(s):
+	//    <1> p_world != nullptr
+	//    <2> p_world->isInitialized()
+	//  Returns: N/A
+	//  Side Effect: This Game is initialized in World p_world,
+	//               which it shares.  The current state of this
+	//               Game, if any, is lost.  Initializing in the
+	//               same World with the same seed always gives
+	//               the same Game.
+	//
+	void init (const std::shared_ptr<const World>& p_world,
+	           uint64_t seed);
+
+	//
+	//  switchTo
+	//
+	//  Purpose: To exchange the state of this Game with the
+	//           specified Game.
+	//  Parameter(s):
+	//    <1> r_other: The Game to switch to
+	//    <2> is_keep_player: Whether to keep the player and
+	//                        score of this Game
+	//  Precondition(s):
+	//    <1> r_other.isInitialized()
+	//  Returns: N/A
+	//  Side Effect: This Game takes the World, rods, rings,
+	//               player, and score of r_other, and r_other
+	//               is left with the ones this Game had.  If
+	//               is_keep_player == true, the player and score
+	//               are not exchanged, as when the same world
+	//               is reloaded.  The state used only for
+	//               display is not exchanged, so this function
+	//               may be called on the update thread while
+	//               this Game is displayed.  No state is copied.
+	//
+	void switchTo (Game& r_other,
+	               bool is_keep_player = false);
+
+	//
+	//  restoreCheckpoint
+	//
+	//  Purpose: To return this Game to a saved state.
+	//  Parameter(s):
+	//    <1> checkpoint: The GameCheckpoint to restore from
+	//  Precondition(s):
+	//    <1> !checkpoint.isEmpty()
+	//  Returns: N/A
+	//  Side Effect: This Game is set to the state saved in
+	//               checkpoint.  If checkpoint is for a
+	//               different World, this Game is first
+	//               initialized in that World, which is slower.
+	//               The state used only for display is not
+	//               changed.
+	//
+	void restoreCheckpoint (const GameCheckpoint& checkpoint);
+
 	//
 	//  update
 	//
@@ -270,6 +546,23 @@ public:
 	//
 	void playerJump ();
 
+	//
+	//  handleInput
+	//
+	//  Purpose: To move the player according to the specified
+	//           input bitmask for 1 frame.
+	//  Parameter(s):
+	//    <1> input: The input bitmask
+	//  Precondition(s):
+	//    <1> isInitialized()
+	//  Returns: N/A
+	//  Side Effect: The player is turned and accelerated as
+	//               the bits in input say.  While the player is
+	//               jumping, it can only be turned.
+	//               INPUT_RESTART is ignored.
+	//
+	void handleInput (unsigned int input);
+
 private:
 	//
 	//  Helper Function: initRods
@@ -277,7 +570,7 @@ private:
 	//  Purpose: To initialize the rods.
 	//  Parameter(s): N/A
 	//  Precondition(s):
-	//    <1> m_world.isInitialized()
+	//    <1> isInitialized()
 	//    <2> mv_rods.empty()
 	//  Returns: N/A
 	//  Side Effect: The rods are added to the world.
@@ -290,7 +583,7 @@ private:
 	//  Purpose: To initialize the rings.
 	//  Parameter(s): N/A
 	//  Precondition(s):
-	//    <1> m_world.isInitialized()
+	//    <1> isInitialized()
 	//    <2> mv_rings.empty()
 	//  Returns: N/A
 	//  Side Effect: The rings are added to the world.
@@ -321,21 +614,19 @@ private:
 	bool invariant () const;
 
 private:
-	World m_world;
+	std::shared_ptr<const World> mp_world;
 	std::vector<Rod>  mv_rods;
 	std::vector<Ring> mv_rings;
 	Player m_player;
 	int m_score;
+	RandomStream m_random;
+
+	// only used by the display thread
+	std::shared_ptr<const World> mp_drawn_world;
+	DebugOverlay m_debug_overlay;
 
 public:
 	std::deque<int> path;
-	std::vector<Nodes> game_nodes;
-	void initSearchdata();
-	void bestSearchData();
-	void Dijkstras_path(Vector3 source_pos, int source_node_id, Vector3 dest_pos, int dest_node_id);
-	void dijkstra_path(Vector3 source_pos, int source_node_id, Vector3 dest_pos, int dest_node_id);
-
-	bool over;
 };
 
 
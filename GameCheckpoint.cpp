@@ -0,0 +1,204 @@
+//
+//  GameCheckpoint.cpp
+//
+
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <memory>
+#include <vector>
+
+#include "ObjLibrary/Vector3.h"
+
+#include "World.h"
+#include "GameCheckpoint.h"
+
+using namespace std;
+using namespace ObjLibrary;
+
+
+
+GameCheckpoint :: GameCheckpoint ()
+		: mp_world()
+		, mv_bytes()
+{
+	assert(invariant());
+}
+
+
+
+bool GameCheckpoint :: isEmpty () const
+{
+	return mp_world == nullptr;
+}
+
+const shared_ptr<const World>& GameCheckpoint :: getWorld () const
+{
+	assert(!isEmpty());
+
+	return mp_world;
+}
+
+size_t GameCheckpoint :: getByteCount () const
+{
+	return mv_bytes.size();
+}
+
+uint64_t GameCheckpoint :: calculateHash () const
+{
+	// FNV-1a, but 8 bytes at a time
+	uint64_t hash = 0xcbf29ce484222325ull;
+	size_t i = 0;
+	for( ; i + sizeof(uint64_t) <= mv_bytes.size(); i += sizeof(uint64_t))
+	{
+		uint64_t word;
+		memcpy(&word, mv_bytes.data() + i, sizeof(word));
+		hash ^= word;
+		hash *= 0x100000001b3ull;
+	}
+	for( ; i < mv_bytes.size(); i++)
+	{
+		hash ^= mv_bytes[i];
+		hash *= 0x100000001b3ull;
+	}
+	return hash;
+}
+
+bool GameCheckpoint :: readBool (size_t& r_offset) const
+{
+	unsigned char value;
+	readBytes(r_offset, &value, sizeof(value));
+	return value != 0;
+}
+
+int GameCheckpoint :: readInt (size_t& r_offset) const
+{
+	int value;
+	readBytes(r_offset, &value, sizeof(value));
+	return value;
+}
+
+unsigned int GameCheckpoint :: readUnsigned (size_t& r_offset) const
+{
+	unsigned int value;
+	readBytes(r_offset, &value, sizeof(value));
+	return value;
+}
+
+float GameCheckpoint :: readFloat (size_t& r_offset) const
+{
+	float value;
+	readBytes(r_offset, &value, sizeof(value));
+	return value;
+}
+
+double GameCheckpoint :: readDouble (size_t& r_offset) const
+{
+	double value;
+	readBytes(r_offset, &value, sizeof(value));
+	return value;
+}
+
+uint64_t GameCheckpoint :: readUint64 (size_t& r_offset) const
+{
+	uint64_t value;
+	readBytes(r_offset, &value, sizeof(value));
+	return value;
+}
+
+Vector3 GameCheckpoint :: readVector3 (size_t& r_offset) const
+{
+	double a_xyz[3];
+	readBytes(r_offset, a_xyz, sizeof(a_xyz));
+	return Vector3(a_xyz[0], a_xyz[1], a_xyz[2]);
+}
+
+
+
+void GameCheckpoint :: clear ()
+{
+	mp_world = nullptr;
+	mv_bytes.clear();
+
+	assert(invariant());
+}
+
+void GameCheckpoint :: start (const shared_ptr<const World>& p_world)
+{
+	assert(p_world != nullptr);
+
+	mp_world = p_world;
+	mv_bytes.clear();
+
+	assert(invariant());
+}
+
+void GameCheckpoint :: writeBool (bool value)
+{
+	unsigned char byte = value ? 1 : 0;
+	writeBytes(&byte, sizeof(byte));
+}
+
+void GameCheckpoint :: writeInt (int value)
+{
+	writeBytes(&value, sizeof(value));
+}
+
+void GameCheckpoint :: writeUnsigned (unsigned int value)
+{
+	writeBytes(&value, sizeof(value));
+}
+
+void GameCheckpoint :: writeFloat (float value)
+{
+	writeBytes(&value, sizeof(value));
+}
+
+void GameCheckpoint :: writeDouble (double value)
+{
+	writeBytes(&value, sizeof(value));
+}
+
+void GameCheckpoint :: writeUint64 (uint64_t value)
+{
+	writeBytes(&value, sizeof(value));
+}
+
+void GameCheckpoint :: writeVector3 (const Vector3& value)
+{
+	double a_xyz[3] = { value.x, value.y, value.z };
+	writeBytes(a_xyz, sizeof(a_xyz));
+}
+
+
+
+void GameCheckpoint :: readBytes (size_t& r_offset,
+                                  void* p_value,
+                                  size_t size) const
+{
+	assert(p_value != nullptr);
+	assert(r_offset + size <= getByteCount());
+
+	memcpy(p_value, mv_bytes.data() + r_offset, size);
+	r_offset += size;
+}
+
+void GameCheckpoint :: writeBytes (const void* p_value,
+                                   size_t size)
+{
+	assert(p_value != nullptr);
+	assert(!isEmpty());
+
+	size_t offset = mv_bytes.size();
+	mv_bytes.resize(offset + size);
+	memcpy(mv_bytes.data() + offset, p_value, size);
+
+	assert(invariant());
+}
+
+bool GameCheckpoint :: invariant () const
+{
+	if(mp_world == nullptr && !mv_bytes.empty()) return false;
+	return true;
+}
@@ -0,0 +1,253 @@
+//
+//  GameCheckpoint.h
+//
+//  A module to save the state of a game in a compact binary
+//    form, so the game can be returned to that state later.
+//
+
+#ifndef GAME_CHECKPOINT_H
+#define GAME_CHECKPOINT_H
+
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+#include "ObjLibrary/Vector3.h"
+
+class World;
+
+
+
+//
+//  GameCheckpoint
+//
+//  A class to hold the state of a Game at one physics frame.
+//    The state is written as a sequence of values by
+//    Game::saveCheckpoint and read back in the same order by
+//    Game::restoreCheckpoint.  The values are stored as raw
+//    bytes with no padding or type information, so a
+//    GameCheckpoint is only meaningful to the same program that
+//    wrote it.
+//
+//  Only the state that changes as the game is played is
+//    stored.  The World is not copied, but a GameCheckpoint
+//    shares ownership of it, so it is kept as long as the
+//    GameCheckpoint is.
+//
+//  The bytes are kept when a GameCheckpoint is cleared, so
+//    saving to the same GameCheckpoint again does not allocate
+//    memory.  Reading does not change a GameCheckpoint, so
+//    different threads can restore from the same GameCheckpoint
+//    at the same time.
+//
+//  Class Invariant:
+//    <1> mp_world != nullptr || mv_bytes.empty()
+//
+class GameCheckpoint
+{
+public:
+	//
+	//  Default Constructor
+	//
+	//  Purpose: To create a new, empty GameCheckpoint.
+	//  Parameter(s): N/A
+	//  Precondition(s): N/A
+	//  Returns: N/A
+	//  Side Effect: A new GameCheckpoint is created.
+	//
+	GameCheckpoint ();
+
+	GameCheckpoint (const GameCheckpoint& original) = default;
+	~GameCheckpoint () = default;
+	GameCheckpoint& operator= (const GameCheckpoint& original) = default;
+
+	//
+	//  isEmpty
+	//
+	//  Purpose: To determine whether this GameCheckpoint holds
+	//           a game state.
+	//  Parameter(s): N/A
+	//  Precondition(s): N/A
+	//  Returns: Whether this GameCheckpoint is empty.
+	//  Side Effect: N/A
+	//
+	bool isEmpty () const;
+
+	//
+	//  getWorld
+	//
+	//  Purpose: To retrieve the World the saved game was in.
+	//  Parameter(s): N/A
+	//  Precondition(s):
+	//    <1> !isEmpty()
+	//  Returns: The World.
+	//  Side Effect: N/A
+	//
+	const std::shared_ptr<const World>& getWorld () const;
+
+	//
+	//  getByteCount
+	//
+	//  Purpose: To determine how large the saved state is.
+	//  Parameter(s): N/A
+	//  Precondition(s): N/A
+	//  Returns: The number of bytes written.
+	//  Side Effect: N/A
+	//
+	size_t getByteCount () const;
+
+	//
+	//  calculateHash
+	//
+	//  Purpose: To calculate a hash of the saved state.
+	//  Parameter(s): N/A
+	//  Precondition(s): N/A
+	//  Returns: A 64-bit hash of the bytes written.  Two
+	//           GameCheckpoints of the same game state always
+	//           have the same hash, and ones of different
+	//           states almost never do.
+	//  Side Effect: N/A
+	//
+	uint64_t calculateHash () const;
+
+	//
+	//  readBool
+	//  readInt
+	//  readUnsigned
+	//  readFloat
+	//  readDouble
+	//  readUint64
+	//  readVector3
+	//
+	//  Purpose: To read the next value from this
+	//           GameCheckpoint.
+	//  Parameter(s):
+	//    <1> r_offset: The byte to read from
+	//  Precondition(s):
+	//    <1> r_offset + the size of the value <= getByteCount()
+	//  Returns: The value at offset r_offset.
+	//  Side Effect: r_offset is advanced past the value read.
+	//
+	bool readBool (size_t& r_offset) const;
+	int readInt (size_t& r_offset) const;
+	unsigned int readUnsigned (size_t& r_offset) const;
+	float readFloat (size_t& r_offset) const;
+	double readDouble (size_t& r_offset) const;
+	uint64_t readUint64 (size_t& r_offset) const;
+	ObjLibrary::Vector3 readVector3 (size_t& r_offset) const;
+
+	//
+	//  clear
+	//
+	//  Purpose: To remove the saved state from this
+	//           GameCheckpoint.
+	//  Parameter(s): N/A
+	//  Precondition(s): N/A
+	//  Returns: N/A
+	//  Side Effect: This GameCheckpoint is set to be empty.  The
+	//               memory for the bytes is kept.
+	//
+	void clear ();
+
+	//
+	//  start
+	//
+	//  Purpose: To begin saving a game state in the specified
+	//           World.
+	//  Parameter(s):
+	//    <1> p_world: The World
+	//  Precondition(s):
+	//    <1> p_world != nullptr
+	//  Returns: N/A
+	//  Side Effect: Any state saved before is removed and this
+	//               GameCheckpoint is set to refer to World
+	//               p_world.  The values are then written with
+	//               the write functions.
+	//
+	void start (const std::shared_ptr<const World>& p_world);
+
+	//
+	//  writeBool
+	//  writeInt
+	//  writeUnsigned
+	//  writeFloat
+	//  writeDouble
+	//  writeUint64
+	//  writeVector3
+	//
+	//  Purpose: To add a value to the end of this
+	//           GameCheckpoint.
+	//  Parameter(s):
+	//    <1> value: The value
+	//  Precondition(s):
+	//    <1> !isEmpty()
+	//  Returns: N/A
+	//  Side Effect: Value value is added after the values
+	//               already written.
+	//
+	void writeBool (bool value);
+	void writeInt (int value);
+	void writeUnsigned (unsigned int value);
+	void writeFloat (float value);
+	void writeDouble (double value);
+	void writeUint64 (uint64_t value);
+	void writeVector3 (const ObjLibrary::Vector3& value);
+
+private:
+	//
+	//  Helper Function: readBytes
+	//
+	//  Purpose: To read the specified number of bytes.
+	//  Parameter(s):
+	//    <1> r_offset: The byte to read from
+	//    <2> p_value: Where to copy the bytes to
+	//    <3> size: The number of bytes
+	//  Precondition(s):
+	//    <1> p_value != nullptr
+	//    <2> r_offset + size <= getByteCount()
+	//  Returns: N/A
+	//  Side Effect: The bytes at offset r_offset are copied to
+	//               p_value and r_offset is advanced past them.
+	//
+	void readBytes (size_t& r_offset,
+	                void* p_value,
+	                size_t size) const;
+
+	//
+	//  Helper Function: writeBytes
+	//
+	//  Purpose: To write the specified number of bytes.
+	//  Parameter(s):
+	//    <1> p_value: The bytes to write
+	//    <2> size: The number of bytes
+	//  Precondition(s):
+	//    <1> p_value != nullptr
+	//    <2> !isEmpty()
+	//  Returns: N/A
+	//  Side Effect: The bytes are added to the end of this
+	//               GameCheckpoint.
+	//
+	void writeBytes (const void* p_value,
+	                 size_t size);
+
+	//
+	//  Helper Function: invariant
+	//
+	//  Purpose: To determine if the class invariant is true.
+	//  Parameter(s): N/A
+	//  Precondition(s): N/A
+	//  Returns: Whether the class invariant is true.
+	//  Side Effect: N/A
+	//
+	bool invariant () const;
+
+private:
+	std::shared_ptr<const World> mp_world;
+	std::vector<unsigned char> mv_bytes;
+};
+
+
+
+#endif
@@ -0,0 +1,159 @@
+//
+//  GameSnapshot.cpp
+//
+
+#include <cassert>
+#include <memory>
+#include <vector>
+
+#include "ObjLibrary/Vector3.h"
+
+#include "LodView.h"
+#include "Renderer.h"
+#include "Rod.h"
+#include "Ring.h"
+#include "Player.h"
+#include "GameSnapshot.h"
+
+using namespace std;
+using namespace ObjLibrary;
+
+
+
+GameSnapshot :: GameSnapshot ()
+		: m_update_count(0)
+		, mp_world()
+		, m_score(0)
+		, m_player()
+		, mv_rods()
+		, mv_ring_poses()
+		, mp_search_ring()
+{
+	assert(invariant());
+}
+
+GameSnapshot :: GameSnapshot (unsigned int update_count,
+                              const shared_ptr<const World>& p_world,
+                              int score,
+                              const Player& player,
+                              const vector<Rod>& rods,
+                              const vector<Ring>& rings,
+                              bool is_search_shown)
+		: m_update_count(update_count)
+		, mp_world(p_world)
+		, m_score(score)
+		, m_player(player)
+		, mv_rods(rods)
+		, mv_ring_poses(rings.size())
+		, mp_search_ring()
+{
+	assert(p_world != nullptr);
+	assert(rods.size() == rings.size());
+	assert(!is_search_shown || !rings.empty());
+
+	for(unsigned int i = 0; i < rings.size(); i++)
+	{
+		mv_ring_poses[i].m_position = rings[i].getPosition();
+		mv_ring_poses[i].m_rotation = rings[i].getRotation();
+		mv_ring_poses[i].m_is_taken = rings[i].isTaken();
+	}
+
+	if(is_search_shown)
+		mp_search_ring = make_shared<const Ring>(rings[0]);
+
+	assert(invariant());
+}
+
+GameSnapshot :: GameSnapshot (const GameSnapshot& previous,
+                              const GameSnapshot& current,
+                              float fraction)
+		: GameSnapshot(current)
+{
+	assert(previous.getWorld() != current.getWorld() ||
+	       previous.getRingCount() == current.getRingCount());
+	assert(fraction >= 0.0f);
+	assert(fraction <= 1.0f);
+
+	// the player and rings jump when the world is switched
+	if(previous.mp_world == mp_world)
+	{
+		m_player.interpolatePose(previous.m_player, fraction);
+
+		for(unsigned int i = 0; i < mv_ring_poses.size(); i++)
+		{
+			const RingPose& before = previous.mv_ring_poses[i];
+			RingPose& r_pose = mv_ring_poses[i];
+			r_pose.m_position = before.m_position + (r_pose.m_position - before.m_position) * fraction;
+			r_pose.m_rotation = before.m_rotation + (r_pose.m_rotation - before.m_rotation) * fraction;
+		}
+	}
+
+	assert(invariant());
+}
+
+
+
+unsigned int GameSnapshot :: getUpdateCount () const
+{
+	return m_update_count;
+}
+
+const shared_ptr<const World>& GameSnapshot :: getWorld () const
+{
+	return mp_world;
+}
+
+int GameSnapshot :: getScore () const
+{
+	return m_score;
+}
+
+bool GameSnapshot :: isGameOver () const
+{
+	return m_player.isDead();
+}
+
+const Player& GameSnapshot :: getPlayer () const
+{
+	return m_player;
+}
+
+unsigned int GameSnapshot :: getRingCount () const
+{
+	return mv_ring_poses.size();
+}
+
+bool GameSnapshot :: isSearchShown () const
+{
+	return mp_search_ring != nullptr;
+}
+
+const Ring& GameSnapshot :: getSearchRing () const
+{
+	assert(isSearchShown());
+
+	return *mp_search_ring;
+}
+
+void GameSnapshot :: draw (Renderer& r_renderer, const LodView& view) const
+{
+	assert(Rod ::isModelsLoaded());
+	assert(Ring::isModelsLoaded());
+
+	for(unsigned int i = 0; i < mv_rods.size(); i++)
+		mv_rods[i].draw(r_renderer);
+	for(unsigned int i = 0; i < mv_ring_poses.size(); i++)
+	{
+		const RingPose& pose = mv_ring_poses[i];
+		if(!pose.m_is_taken)
+			Ring::drawModel(r_renderer, view, pose.m_position, pose.m_rotation);
+	}
+}
+
+
+
+bool GameSnapshot :: invariant () const
+{
+	if(mv_rods.size() != mv_ring_poses.size()) return false;
+	return true;
+}
@@ -0,0 +1,273 @@
+//
+//  GameSnapshot.h
+//
+//  A module to represent the state of the game at one physics
+//    frame, as needed to display it.
+//
+
+#ifndef GAME_SNAPSHOT_H
+#define GAME_SNAPSHOT_H
+
+#include <cassert>
+#include <memory>
+#include <vector>
+
+#include "ObjLibrary/Vector3.h"
+
+#include "LodView.h"
+#include "Renderer.h"
+#include "Rod.h"
+#include "Ring.h"
+#include "Player.h"
+
+class World;
+
+
+
+//
+//  GameSnapshot
+//
+//  A class to represent a copy of the parts of a Game that
+//    change as it is updated.  The simulation thread creates a
+//    new GameSnapshot after each physics frame and never
+//    changes it afterwards, so the display thread can read it
+//    without locking while the Game goes on being updated.
+//
+//  Only what is needed to draw a ring is copied, because the
+//    path search data in a Ring is large.  The Ring whose
+//    search is shown in the overview is copied in full, but
+//    only when the overview is shown.
+//
+//  A GameSnapshot can also be interpolated between two others,
+//    to display the game between physics frames.
+//
+//  The World is not copied, but a GameSnapshot shares
+//    ownership of it, so it is kept while the GameSnapshot is
+//    displayed even if the Game has switched to another world.
+//
+//  Class Invariant:
+//    <1> mv_rods.size() == mv_ring_poses.size()
+//
+class GameSnapshot
+{
+public:
+	//
+	//  Default Constructor
+	//
+	//  Purpose: To create a new GameSnapshot with no rods or
+	//           rings.
+	//  Parameter(s): N/A
+	//  Precondition(s): N/A
+	//  Returns: N/A
+	//  Side Effect: A new GameSnapshot is created for physics
+	//               frame 0.
+	//
+	GameSnapshot ();
+
+	//
+	//  Constructor
+	//
+	//  Purpose: To create a new GameSnapshot of the specified
+	//           game state.
+	//  Parameter(s):
+	//    <1> update_count: The number of physics frames that
+	//                      have been run
+	//    <2> p_world: The World the game is in
+	//    <3> score: The player score
+	//    <4> player: The player
+	//    <5> rods: The rods
+	//    <6> rings: The rings
+	//    <7> is_search_shown: Whether to copy the path search
+	//                         for the first ring
+	//  Precondition(s):
+	//    <1> p_world != nullptr
+	//    <2> rods.size() == rings.size()
+	//    <3> !is_search_shown || !rings.empty()
+	//  Returns: N/A
+	//  Side Effect: A new GameSnapshot is created.
+	//
+	GameSnapshot (unsigned int update_count,
+	              const std::shared_ptr<const World>& p_world,
+	              int score,
+	              const Player& player,
+	              const std::vector<Rod>& rods,
+	              const std::vector<Ring>& rings,
+	              bool is_search_shown);
+
+	//
+	//  Interpolation Constructor
+	//
+	//  Purpose: To create a new GameSnapshot between the
+	//           specified two.
+	//  Parameter(s):
+	//    <1> previous: The earlier GameSnapshot
+	//    <2> current: The later GameSnapshot
+	//    <3> fraction: How far the new GameSnapshot is from
+	//                  previous to current
+	//  Precondition(s):
+	//    <1> previous.getWorld() != current.getWorld() ||
+	//        previous.getRingCount() == current.getRingCount()
+	//    <2> fraction >= 0.0f
+	//    <3> fraction <= 1.0f
+	//  Returns: N/A
+	//  Side Effect: A new GameSnapshot is created with the
+	//               player and ring positions interpolated.
+	//               Everything else is copied from current.  If
+	//               the two GameSnapshots are in different
+	//               worlds, nothing is interpolated.
+	//
+	GameSnapshot (const GameSnapshot& previous,
+	              const GameSnapshot& current,
+	              float fraction);
+
+	GameSnapshot (const GameSnapshot& original) = default;
+	~GameSnapshot () = default;
+	GameSnapshot& operator= (const GameSnapshot& original) = default;
+
+	//
+	//  getUpdateCount
+	//
+	//  Purpose: To determine which physics frame this
+	//           GameSnapshot is from.
+	//  Parameter(s): N/A
+	//  Precondition(s): N/A
+	//  Returns: The number of physics frames that had been run.
+	//  Side Effect: N/A
+	//
+	unsigned int getUpdateCount () const;
+
+	//
+	//  getWorld
+	//
+	//  Purpose: To retrieve the World the game was in.
+	//  Parameter(s): N/A
+	//  Precondition(s): N/A
+	//  Returns: The World, or nullptr if this GameSnapshot was
+	//           created with the default constructor.
+	//  Side Effect: N/A
+	//
+	const std::shared_ptr<const World>& getWorld () const;
+
+	//
+	//  getScore
+	//
+	//  Purpose: To determine the score.
+	//  Parameter(s): N/A
+	//  Precondition(s): N/A
+	//  Returns: The player score.
+	//  Side Effect: N/A
+	//
+	int getScore () const;
+
+	//
+	//  isGameOver
+	//
+	//  Purpose: To determine whether the game was over.
+	//  Parameter(s): N/A
+	//  Precondition(s): N/A
+	//  Returns: Whether the player had fallen off the world.
+	//  Side Effect: N/A
+	//
+	bool isGameOver () const;
+
+	//
+	//  getPlayer
+	//
+	//  Purpose: To retrieve the player.
+	//  Parameter(s): N/A
+	//  Precondition(s): N/A
+	//  Returns: The copy of the player.
+	//  Side Effect: N/A
+	//
+	const Player& getPlayer () const;
+
+	//
+	//  getRingCount
+	//
+	//  Purpose: To determine the number of rings.
+	//  Parameter(s): N/A
+	//  Precondition(s): N/A
+	//  Returns: The number of rings.
+	//  Side Effect: N/A
+	//
+	unsigned int getRingCount () const;
+
+	//
+	//  isSearchShown
+	//
+	//  Purpose: To determine whether this GameSnapshot has a
+	//           path search to display.
+	//  Parameter(s): N/A
+	//  Precondition(s): N/A
+	//  Returns: Whether the path search was copied.
+	//  Side Effect: N/A
+	//
+	bool isSearchShown () const;
+
+	//
+	//  getSearchRing
+	//
+	//  Purpose: To retrieve the Ring whose path search was
+	//           copied.
+	//  Parameter(s): N/A
+	//  Precondition(s):
+	//    <1> isSearchShown()
+	//  Returns: The copy of the first ring.
+	//  Side Effect: N/A
+	//
+	const Ring& getSearchRing () const;
+
+	//
+	//  draw
+	//
+	//  Purpose: To display the rods and rings in this
+	//           GameSnapshot.
+	//  Parameter(s):
+	//    <1> r_renderer: The Renderer to draw with
+	//    <2> view: The camera being drawn for
+	//  Precondition(s):
+	//    <1> Rod::isModelsLoaded()
+	//    <2> Ring::isModelsLoaded()
+	//  Returns: N/A
+	//  Side Effect: The rods and rings that have not been
+	//               taken are displayed.
+	//
+	void draw (Renderer& r_renderer, const LodView& view) const;
+
+private:
+	//
+	//  RingPose
+	//
+	//  A record of where a Ring is drawn.
+	//
+	struct RingPose
+	{
+		ObjLibrary::Vector3 m_position;
+		float m_rotation;
+		bool m_is_taken;
+	};
+
+	//
+	//  Helper Function: invariant
+	//
+	//  Purpose: To determine if the class invariant is true.
+	//  Parameter(s): N/A
+	//  Precondition(s): N/A
+	//  Returns: Whether the class invariant is true.
+	//  Side Effect: N/A
+	//
+	bool invariant () const;
+
+private:
+	unsigned int m_update_count;
+	std::shared_ptr<const World> mp_world;
+	int m_score;
+	Player m_player;
+	std::vector<Rod> mv_rods;
+	std::vector<RingPose> mv_ring_poses;
+	std::shared_ptr<const Ring> mp_search_ring;
+};
+
+
+
+#endif
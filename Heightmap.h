@@ -8,10 +8,14 @@
 #define HEIGHTMAP_H
 
 #include <cassert>
+#include <cstddef>
+#include <cstdint>
 #include <vector>
 
 #include "ObjLibrary/DisplayList.h"
 
+#include "Renderer.h"
+#include "HeightmapMesh.h"
 
 
 //
@@ -47,7 +51,19 @@
 //    Heightmap is initialized, the 3D mesh for its surface is
 //    constructed and the vertex heights become immutable.  If
 //    necessary, the Heightmap can be un-finalized, restoring it
-//    to its mutable form.
+//    to its mutable form.  The mesh is built on the CPU as a
+//    HeightmapMesh first, which does not require OpenGL, so
+//    meshes for many Heightmaps can be built in parallel and
+//    then finalized one at a time.
+//
+//  A finalized Heightmap has a mesh for each of several levels
+//    of detail.  Level 0 uses every vertex, and each following
+//    level uses every second vertex of the one before, halving
+//    the side length.  Levels are only created while the side
+//    length is even, so every coarse vertex is also a vertex in
+//    the full mesh.  All edge vertexes have a height of
+//    HEIGHT_EDGE at every level, so the edges of the coarser
+//    meshes match the full mesh exactly and no cracks appear.
 //
 //  When a Heightmap is drawn, occupies the space from [0, 1]
 //    along the x and z axes.  The client code should apply the
@@ -59,10 +75,13 @@
 //    <1> m_side_length >= SIDE_LENGTH_MIN
 //    <2> m_texture_repeat >= SIDE_LENGTH_MIN
 //    <3> mv_heights.size() == m_side_length * m_side_length
-//    <4> !m_mesh.isPartial()
-//    <5> mv_heights[getVertexIndex(i, 0)] == HEIGHT_EDGE
+//    <4> mv_meshes.size() == 0 ||
+//        mv_meshes.size() == calculateLevelCount(m_side_length)
+//    <5> !mv_meshes[l].isPartial()
+//                            WHERE 0 <= l < mv_meshes.size()
+//    <6> mv_heights[getVertexIndex(i, 0)] == HEIGHT_EDGE
 //                                  WHERE 0 <= i < m_side_length
-//    <6> mv_heights[getVertexIndex(0, j)] == HEIGHT_EDGE
+//    <7> mv_heights[getVertexIndex(0, j)] == HEIGHT_EDGE
 //                                  WHERE 0 <= j < m_side_length
 //
 class Heightmap
@@ -90,6 +109,31 @@ public:
 	//
 	static const float HEIGHT_EDGE;
 
+	//
+	//  LEVEL_COUNT_MAX
+	//
+	//  The maximum number of levels of detail for a Heightmap.
+	//
+	static const unsigned int LEVEL_COUNT_MAX = 4;
+
+	//
+	//  Class Function: calculateLevelCount
+	//
+	//  Purpose: To determine the number of levels of detail for
+	//           a Heightmap with the specified side length.
+	//  Parameter(s):
+	//    <1> side_length: The side length
+	//  Precondition(s):
+	//    <1> side_length >= SIDE_LENGTH_MIN
+	//  Returns: The number of levels of detail.  This is one
+	//           more than the number of times side_length can
+	//           be halved without becoming odd, to a maximum of
+	//           LEVEL_COUNT_MAX.
+	//  Side Effect: N/A
+	//
+	static unsigned int calculateLevelCount (
+	                                 unsigned int side_length);
+
 public:
 	//
 	//  Default Constructor
@@ -115,6 +159,7 @@ public:
 	//  Parameter(s):
 	//    <1> disk_type: The type of the disk
 	//    <2> is_finalize: Whther to finalize the Heightmap
+	//    <3> seed: The seed for the random heights
 	//  Precondition(s):
 	//    <1> disk_type < DiskType::COUNT
 	//    <2> DiskType::getSideLength(disk_type) >=
@@ -123,15 +168,22 @@ public:
 	//                                        TEXTURE_REPEAT_MIN
 	//  Returns: N/A
 	//  Side Effect: A new Heightmap is created for a disk of type
-	//               disk_type.  is_finalize == true, the new
-	//               Heightmap is finalized.
+	//               disk_type.  The heights depend only on
+	//               disk_type and seed, and are calculated by a
+	//               HeightmapFormula.  is_finalize == true,
+	//               the new Heightmap is finalized.
+	//  Note: If is_finalize == false, this constructor does not
+	//        use OpenGL and can be called from any thread.
 	//
 	Heightmap (unsigned int disk_type,
-	           bool is_finalize);
+	           bool is_finalize,
+	           uint64_t seed);
 
 	Heightmap (const Heightmap& original) = default;
+	Heightmap (Heightmap&& original) = default;
 	~Heightmap () = default;
 	Heightmap& operator= (const Heightmap& original) = default;
+	Heightmap& operator= (Heightmap&& original) = default;
 
 	//
 	//  isFinalized
@@ -167,6 +219,62 @@ public:
 	//
 	unsigned int getTextureRepeat () const;
 
+	//
+	//  getLevelCount
+	//
+	//  Purpose: To determine the number of levels of detail for
+	//           this Heightmap.
+	//  Parameter(s): N/A
+	//  Precondition(s): N/A
+	//  Returns: The number of levels of detail.
+	//  Side Effect: N/A
+	//
+	unsigned int getLevelCount () const;
+
+	//
+	//  getLevelSideLength
+	//
+	//  Purpose: To determine the side length of the mesh for
+	//           the specified level of detail.
+	//  Parameter(s):
+	//    <1> level: Which level of detail
+	//  Precondition(s):
+	//    <1> level < getLevelCount()
+	//  Returns: The side length in cells at level level.
+	//  Side Effect: N/A
+	//
+	unsigned int getLevelSideLength (unsigned int level) const;
+
+	//
+	//  getTriangleCount
+	//
+	//  Purpose: To determine the number of triangles drawn at
+	//           the specified level of detail.
+	//  Parameter(s):
+	//    <1> level: Which level of detail
+	//  Precondition(s):
+	//    <1> level < getLevelCount()
+	//  Returns: The number of triangles in the mesh for level
+	//           level.
+	//  Side Effect: N/A
+	//
+	unsigned int getTriangleCount (unsigned int level) const;
+
+	//
+	//  getMemoryBytes
+	//
+	//  Purpose: To estimate how much memory this Heightmap uses.
+	//  Parameter(s): N/A
+	//  Precondition(s): N/A
+	//  Returns: The number of bytes used for the heights and,
+	//           if this Heightmap is finalized, the vertexes and
+	//           indexes of its meshes.  The meshes are counted
+	//           even though they are normally stored by the
+	//           graphics driver.
+	//  Side Effect: N/A
+	//
+	size_t getMemoryBytes () const;
+
 	//
 	//  getVertexHeight
 	//
@@ -221,15 +329,36 @@ public:
 	//  draw
 	//
 	//  Purpose: To display this Heightmap.
-	//  Parameter(s): N/A
+	//  Parameter(s):
+	//    <1> r_renderer: The Renderer to draw with
 	//  Precondition(s):
 	//    <1> isFinalized()
 	//  Returns: N/A
-	//  Side Effect: This Heightmap is displayed.  It is scaled
-	//               to cover the space from [0, 1] alomg the x-
-	//               and z-axes, regardless of the side length.
+	//  Side Effect: This Heightmap is displayed at full detail.
+	//               It is scaled to cover the space from [0, 1]
+	//               alomg the x- and z-axes, regardless of the
+	//               side length.
 	//
-	void draw () const;
+	void draw (Renderer& r_renderer) const;
+
+	//
+	//  draw
+	//
+	//  Purpose: To display this Heightmap at the specified
+	//           level of detail.
+	//  Parameter(s):
+	//    <1> r_renderer: The Renderer to draw with
+	//    <2> level: Which level of detail
+	//  Precondition(s):
+	//    <1> isFinalized()
+	//    <2> level < getLevelCount()
+	//  Returns: N/A
+	//  Side Effect: This Heightmap is displayed using the mesh
+	//               for level level.  It is scaled to cover the
+	//               space from [0, 1] alomg the x- and z-axes.
+	//
+	void draw (Renderer& r_renderer,
+	           unsigned int level) const;
 
 	//
 	//  setVertexHeight
@@ -253,6 +382,38 @@ public:
 	                      unsigned int j,
 	                      float height);
 
+	//
+	//  buildMesh
+	//
+	//  Purpose: To construct the 3D mesh for the specified level
+	//           of detail of this Heightmap on the CPU.
+	//  Parameter(s):
+	//    <1> level: Which level of detail
+	//  Precondition(s):
+	//    <1> level < getLevelCount()
+	//  Returns: The mesh for level level with the current
+	//           vertex heights.
+	//  Side Effect: N/A
+	//  Note: This function does not use OpenGL and can be
+	//        called from any thread.
+	//
+	HeightmapMesh buildMesh (unsigned int level) const;
+
+	//
+	//  buildMeshes
+	//
+	//  Purpose: To construct the 3D meshes for all levels of
+	//           detail of this Heightmap on the CPU.
+	//  Parameter(s): N/A
+	//  Precondition(s): N/A
+	//  Returns: The meshes, with element l being the mesh for
+	//           level l.
+	//  Side Effect: N/A
+	//  Note: This function does not use OpenGL and can be
+	//        called from any thread.
+	//
+	std::vector<HeightmapMesh> buildMeshes () const;
+
 	//
 	//  finalize
 	//
@@ -266,6 +427,24 @@ public:
 	//
 	void finalize ();
 
+	//
+	//  finalize
+	//
+	//  Purpose: To finalize this Heightmap using meshes that
+	//           have already been built.
+	//  Parameter(s):
+	//    <1> meshes: The meshes to use
+	//  Precondition(s):
+	//    <1> !isFinalized()
+	//    <2> meshes.size() == getLevelCount()
+	//    <3> meshes were built by buildMeshes() with the
+	//        current vertex heights
+	//  Returns: N/A
+	//  Side Effect: The 3d geometry for this Heightmap is
+	//               copied from meshes to the graphics card.
+	//
+	void finalize (const std::vector<HeightmapMesh>& meshes);
+
 	//
 	//  unfinalize
 	//
@@ -298,45 +477,6 @@ private:
 	unsigned int getVertexIndex (unsigned int i,
 	                             unsigned int j) const;
 
-	//
-	//  Helper Function: setHeightsRedRock
-	//  Helper Function: setHeightsLeafy
-	//  Helper Function: setHeightsIcy
-	//  Helper Function: setHeightsSandy
-	//  Helper Function: setHeightsGrey
-	//
-	//  Purpose: To calculate the vertex heights for a disk of
-	//           the indicated disk type.
-	//  Parameter(s): N/A
-	//  Precondition(s):
-	//    <1> !isFinalized()
-	//  Returns: N/A
-	//  Side Effect: The vertex heights are calculated.
-	//
-	void setHeightsRedRock ();
-	void setHeightsLeafy ();
-	void setHeightsIcy ();
-	void setHeightsSandy ();
-	void setHeightsGreyRock ();
-
-	//
-	//  Helper Function: getEdgeFactor
-	//
-	//  Purpose: To determine the multiplier factor for the
-	//           perlin noise based on the distance to the
-	//           heightmap edge.
-	//  Parameter(s):
-	//    <1> i
-	//    <2> j: The coordinates of the vertex
-	//  Precondition(s):
-	//    <1> i < getSideLength()
-	//    <2> j < getSideLength()
-	//  Returns: The hight multiplier for vertex (i, j).
-	//  Side Effect: N/A
-	//
-	float getEdgeFactor (unsigned int i,
-	                     unsigned int j) const;
-
 	//
 	//  Helper Function: invariant
 	//
@@ -352,7 +492,7 @@ private:
 	unsigned int m_side_length;
 	unsigned int m_texture_repeat;
 	std::vector<float> mv_heights;
-	ObjLibrary::DisplayList m_mesh;
+	std::vector<ObjLibrary::DisplayList> mv_meshes;
 };
 
 
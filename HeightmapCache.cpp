@@ -0,0 +1,324 @@
+//
+//  HeightmapCache.cpp
+//
+
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+
+#include "DiskType.h"
+#include "Heightmap.h"
+#include "HeightmapCache.h"
+
+using namespace std;
+namespace
+{
+	//
+	//  Key
+	//
+	//  The disk type and seed that identify a heightmap.
+	//
+	struct Key
+	{
+		unsigned int m_disk_type;
+		uint64_t m_seed;
+
+		bool operator== (const Key& other) const
+		{
+			return m_disk_type == other.m_disk_type && m_seed == other.m_seed;
+		}
+	};
+
+	struct KeyHash
+	{
+		size_t operator() (const Key& key) const
+		{
+			return (size_t)(key.m_seed ^ ((uint64_t)(key.m_disk_type) << 61));
+		}
+	};
+
+	//
+	//  Entry
+	//
+	//  A heightmap in the cache, the memory it was using the
+	//    last time it was counted, and whether it has been
+	//    finalized.
+	//
+	struct Entry
+	{
+		Key m_key;
+		shared_ptr<Heightmap> mp_heightmap;
+		size_t m_bytes;
+		bool m_is_finalized;
+	};
+
+	//
+	//  g_entries
+	//
+	//  The heightmaps in the cache, from most to least recently
+	//    used.  g_entry_by_key finds the entry for each
+	//    heightmap, so it can be moved to the front when used.
+	//
+	list<Entry> g_entries;
+	unordered_map<Key, list<Entry>::iterator, KeyHash> g_entry_by_key;
+
+	//
+	//  gv_evicted
+	//
+	//  The heightmaps that have been evicted but not released
+	//    yet, because they are finalized or were still in use
+	//    elsewhere.  They can no longer be found, so once the
+	//    cache holds the only reference, it stays that way.  A
+	//    heightmap can be evicted while it is being finalized,
+	//    so markFinalized also flags entries here.  It is
+	//    called while the caller still holds a reference, so
+	//    the entry cannot be released off the thread with the
+	//    OpenGL context before it is flagged.
+	//
+	vector<Entry> gv_evicted;
+
+	size_t g_memory_budget = HeightmapCache::MEMORY_BUDGET_DEFAULT;
+	size_t g_memory_used   = 0;
+	unsigned int g_generated_count = 0;
+	unsigned int g_evicted_count   = 0;
+
+	//
+	//  g_mutex
+	//
+	//  The mutex guarding all the above.
+	//
+	mutex g_mutex;
+
+
+
+	//
+	//  touch
+	//
+	//  Purpose: To mark the specified entry as the most recently
+	//           used.
+	//  Parameter(s):
+	//    <1> it: An iterator to the entry
+	//  Precondition(s):
+	//    <1> g_mutex is locked
+	//    <2> it is in g_entries
+	//  Returns: N/A
+	//  Side Effect: The entry for it is moved to the front of
+	//               g_entries.
+	//
+	void touch (list<Entry>::iterator it)
+	{
+		if(it != g_entries.begin())
+			g_entries.splice(g_entries.begin(), g_entries, it);
+	}
+
+	//
+	//  releaseUnused
+	//
+	//  Purpose: To release the evicted heightmaps that are no
+	//           longer in use.
+	//  Parameter(s):
+	//    <1> is_finalized_released: Whether finalized
+	//                               heightmaps can be released
+	//  Precondition(s):
+	//    <1> g_mutex is locked
+	//    <2> If is_finalized_released == true, this function is
+	//        called from the thread with the OpenGL context.
+	//  Returns: N/A
+	//  Side Effect: The heightmaps in gv_evicted that are only
+	//               referenced from there, and are finalized
+	//               only if is_finalized_released == true, are
+	//               released.
+	//
+	void releaseUnused (bool is_finalized_released)
+	{
+		unsigned int kept = 0;
+		for(unsigned int i = 0; i < gv_evicted.size(); i++)
+		{
+			Entry& r_entry = gv_evicted[i];
+			if(r_entry.mp_heightmap.use_count() == 1 &&
+			   (is_finalized_released || !r_entry.m_is_finalized))
+			{
+				continue;  // released when gv_evicted shrinks
+			}
+			if(kept != i)
+				gv_evicted[kept] = move(r_entry);
+			kept++;
+		}
+		gv_evicted.resize(kept);
+	}
+
+	//
+	//  evictOverBudget
+	//
+	//  Purpose: To evict heightmaps until the memory budget is
+	//           not exceeded.
+	//  Parameter(s): N/A
+	//  Precondition(s):
+	//    <1> g_mutex is locked
+	//  Returns: N/A
+	//  Side Effect: The least recently used heightmaps are
+	//               removed from the cache until the memory used
+	//               is within the budget, but the most recently
+	//               used heightmap is never removed.  The
+	//               heightmaps removed are released if that is
+	//               safe and added to gv_evicted otherwise.
+	//
+	void evictOverBudget ()
+	{
+		while(g_memory_used > g_memory_budget && g_entries.size() > 1)
+		{
+			Entry& r_entry = g_entries.back();
+			assert(g_memory_used >= r_entry.m_bytes);
+			g_memory_used -= r_entry.m_bytes;
+			g_entry_by_key.erase(r_entry.m_key);
+			gv_evicted.push_back(move(r_entry));
+			g_entries.pop_back();
+			g_evicted_count++;
+		}
+		releaseUnused(false);
+	}
+}
+
+
+
+size_t HeightmapCache :: getMemoryBudget ()
+{
+	lock_guard<mutex> lock(g_mutex);
+	return g_memory_budget;
+}
+
+size_t HeightmapCache :: getMemoryUsed ()
+{
+	lock_guard<mutex> lock(g_mutex);
+	return g_memory_used;
+}
+
+unsigned int HeightmapCache :: getResidentCount ()
+{
+	lock_guard<mutex> lock(g_mutex);
+	return g_entries.size();
+}
+
+unsigned int HeightmapCache :: getGeneratedCount ()
+{
+	lock_guard<mutex> lock(g_mutex);
+	return g_generated_count;
+}
+
+unsigned int HeightmapCache :: getEvictedCount ()
+{
+	lock_guard<mutex> lock(g_mutex);
+	return g_evicted_count;
+}
+
+bool HeightmapCache :: isResident (unsigned int disk_type, uint64_t seed)
+{
+	lock_guard<mutex> lock(g_mutex);
+	return g_entry_by_key.find({ disk_type, seed }) != g_entry_by_key.end();
+}
+
+shared_ptr<Heightmap> HeightmapCache :: find (unsigned int disk_type, uint64_t seed)
+{
+	lock_guard<mutex> lock(g_mutex);
+
+	auto found = g_entry_by_key.find({ disk_type, seed });
+	if(found == g_entry_by_key.end())
+		return nullptr;
+
+	touch(found->second);
+	return found->second->mp_heightmap;
+}
+
+shared_ptr<Heightmap> HeightmapCache :: get (unsigned int disk_type, uint64_t seed)
+{
+	assert(disk_type < DiskType::COUNT);
+
+	shared_ptr<Heightmap> p_heightmap = find(disk_type, seed);
+	if(p_heightmap != nullptr)
+		return p_heightmap;
+
+	// generate without the lock, so other threads can use the cache
+	p_heightmap = make_shared<Heightmap>(disk_type, false, seed);
+
+	lock_guard<mutex> lock(g_mutex);
+	Key key = { disk_type, seed };
+	auto found = g_entry_by_key.find(key);
+	if(found != g_entry_by_key.end())
+	{
+		// another thread generated it first
+		touch(found->second);
+		return found->second->mp_heightmap;
+	}
+
+	size_t bytes = p_heightmap->getMemoryBytes();
+	g_entries.push_front({ key, p_heightmap, bytes, false });
+	g_entry_by_key[key] = g_entries.begin();
+	g_memory_used += bytes;
+	g_generated_count++;
+
+	evictOverBudget();
+	return p_heightmap;
+}
+
+void HeightmapCache :: markFinalized (unsigned int disk_type,
+                                      uint64_t seed,
+                                      const Heightmap* p_heightmap)
+{
+	assert(p_heightmap != nullptr);
+	assert(p_heightmap->isFinalized());
+
+	lock_guard<mutex> lock(g_mutex);
+
+	// the heightmap may have been evicted, and even generated again, since it was retrieved
+	auto found = g_entry_by_key.find({ disk_type, seed });
+	if(found != g_entry_by_key.end() && found->second->mp_heightmap.get() == p_heightmap)
+	{
+		Entry& r_entry = *found->second;
+		size_t bytes = p_heightmap->getMemoryBytes();
+		g_memory_used = g_memory_used - r_entry.m_bytes + bytes;
+		r_entry.m_bytes        = bytes;
+		r_entry.m_is_finalized = true;
+		return;
+	}
+
+	for(unsigned int i = 0; i < gv_evicted.size(); i++)
+		if(gv_evicted[i].mp_heightmap.get() == p_heightmap)
+		{
+			// still in use by the caller, so it cannot have been released yet
+			gv_evicted[i].m_is_finalized = true;
+			return;
+		}
+}
+
+void HeightmapCache :: setMemoryBudget (size_t bytes)
+{
+	lock_guard<mutex> lock(g_mutex);
+
+	g_memory_budget = bytes;
+	evictOverBudget();
+}
+
+void HeightmapCache :: releaseEvicted ()
+{
+	lock_guard<mutex> lock(g_mutex);
+
+	releaseUnused(true);
+}
+
+void HeightmapCache :: clear ()
+{
+	lock_guard<mutex> lock(g_mutex);
+
+	for(list<Entry>::iterator it = g_entries.begin(); it != g_entries.end(); ++it)
+		gv_evicted.push_back(move(*it));
+	g_evicted_count += g_entries.size();
+	g_entries.clear();
+	g_entry_by_key.clear();
+	g_memory_used = 0;
+	releaseUnused(false);
+}
@@ -0,0 +1,241 @@
+//
+//  HeightmapCache.h
+//
+//  A module to generate disk heightmaps when they are needed
+//    and limit how much memory is used for them.
+//
+
+#ifndef HEIGHTMAP_CACHE_H
+#define HEIGHTMAP_CACHE_H
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+
+class Heightmap;
+
+
+
+//
+//  HeightmapCache
+//
+//  A namespace to keep the heightmaps that have been generated
+//    for disks, up to a memory budget.  A heightmap is fully
+//    determined by its disk type and seed, so it is identified
+//    by them, and a heightmap that has been evicted can be
+//    generated again exactly as it was.
+//
+//  The heightmaps are kept in least-recently-used order.  When
+//    a heightmap is added and the total memory used is over the
+//    budget, the least recently used heightmaps are evicted
+//    until it is not.  The budget should be large enough for
+//    every heightmap used in one frame, or heightmaps will be
+//    generated again every frame.
+//
+//  These functions can be called from any thread, and
+//    heightmaps are generated without holding the lock, so
+//    several can be generated at once.  However, a finalized
+//    heightmap owns display lists, so it must be destroyed on
+//    the thread with the OpenGL context.  When one is evicted,
+//    it is therefore only released by releaseEvicted, which
+//    must be called regularly from that thread.  Heightmaps
+//    that are not finalized are released immediately.
+//
+namespace HeightmapCache
+{
+	//
+	//  MEMORY_BUDGET_DEFAULT
+	//
+	//  The default memory budget in bytes.
+	//
+	const size_t MEMORY_BUDGET_DEFAULT = 128 * 1024 * 1024;
+
+	//
+	//  getMemoryBudget
+	//
+	//  Purpose: To determine the memory budget.
+	//  Parameter(s): N/A
+	//  Precondition(s): N/A
+	//  Returns: The largest number of bytes to use for
+	//           heightmaps.
+	//  Side Effect: N/A
+	//
+	size_t getMemoryBudget ();
+
+	//
+	//  getMemoryUsed
+	//
+	//  Purpose: To determine how much memory is used by the
+	//           heightmaps in the cache.
+	//  Parameter(s): N/A
+	//  Precondition(s): N/A
+	//  Returns: The number of bytes used, as counted by
+	//           Heightmap::getMemoryBytes when each heightmap
+	//           was added or finalized.
+	//  Side Effect: N/A
+	//
+	size_t getMemoryUsed ();
+
+	//
+	//  getResidentCount
+	//
+	//  Purpose: To determine how many heightmaps are in the
+	//           cache.
+	//  Parameter(s): N/A
+	//  Precondition(s): N/A
+	//  Returns: The number of heightmaps.
+	//  Side Effect: N/A
+	//
+	unsigned int getResidentCount ();
+
+	//
+	//  getGeneratedCount
+	//
+	//  Purpose: To determine how many heightmaps have been
+	//           generated.
+	//  Parameter(s): N/A
+	//  Precondition(s): N/A
+	//  Returns: The number of heightmaps generated by get since
+	//           the program started.
+	//  Side Effect: N/A
+	//
+	unsigned int getGeneratedCount ();
+
+	//
+	//  getEvictedCount
+	//
+	//  Purpose: To determine how many heightmaps have been
+	//           evicted.
+	//  Parameter(s): N/A
+	//  Precondition(s): N/A
+	//  Returns: The number of heightmaps evicted since the
+	//           program started.
+	//  Side Effect: N/A
+	//
+	unsigned int getEvictedCount ();
+
+	//
+	//  isResident
+	//
+	//  Purpose: To determine whether the specified heightmap is
+	//           in the cache.
+	//  Parameter(s):
+	//    <1> disk_type: The disk type for the heightmap
+	//    <2> seed: The seed for the heightmap
+	//  Precondition(s): N/A
+	//  Returns: Whether the heightmap for disk_type and seed is
+	//           in the cache.
+	//  Side Effect: N/A
+	//
+	bool isResident (unsigned int disk_type, uint64_t seed);
+
+	//
+	//  find
+	//
+	//  Purpose: To retrieve the specified heightmap if it is in
+	//           the cache.
+	//  Parameter(s):
+	//    <1> disk_type: The disk type for the heightmap
+	//    <2> seed: The seed for the heightmap
+	//  Precondition(s): N/A
+	//  Returns: The heightmap for disk_type and seed, or nullptr
+	//           if it is not in the cache.
+	//  Side Effect: If the heightmap is found, it becomes the
+	//               most recently used.
+	//
+	std::shared_ptr<Heightmap> find (unsigned int disk_type,
+	                                 uint64_t seed);
+
+	//
+	//  get
+	//
+	//  Purpose: To retrieve the specified heightmap, generating
+	//           it if needed.
+	//  Parameter(s):
+	//    <1> disk_type: The disk type for the heightmap
+	//    <2> seed: The seed for the heightmap
+	//  Precondition(s):
+	//    <1> disk_type < DiskType::COUNT
+	//  Returns: The heightmap for disk_type and seed.
+	//  Side Effect: If the heightmap is not in the cache, it is
+	//               generated, unfinalized, and added as the
+	//               most recently used.  The least recently used
+	//               heightmaps may be evicted.  Otherwise, it
+	//               becomes the most recently used.
+	//
+	std::shared_ptr<Heightmap> get (unsigned int disk_type,
+	                                uint64_t seed);
+
+	//
+	//  markFinalized
+	//
+	//  Purpose: To record that the specified heightmap has been
+	//           finalized.
+	//  Parameter(s):
+	//    <1> disk_type: The disk type for the heightmap
+	//    <2> seed: The seed for the heightmap
+	//    <3> p_heightmap: The heightmap, as returned by find or
+	//                     get for disk_type and seed
+	//  Precondition(s):
+	//    <1> Called from the thread with the OpenGL context
+	//    <2> p_heightmap != nullptr
+	//    <3> p_heightmap->isFinalized()
+	//    <4> The caller still holds a reference to the
+	//        heightmap
+	//  Returns: N/A
+	//  Side Effect: If p_heightmap is in the cache, the memory
+	//               used for its meshes is counted.  Whether or
+	//               not it has been evicted since it was
+	//               retrieved, it will only be released by
+	//               releaseEvicted.
+	//
+	void markFinalized (unsigned int disk_type,
+	                    uint64_t seed,
+	                    const Heightmap* p_heightmap);
+
+	//
+	//  setMemoryBudget
+	//
+	//  Purpose: To change the memory budget.
+	//  Parameter(s):
+	//    <1> bytes: The new budget in bytes
+	//  Precondition(s): N/A
+	//  Returns: N/A
+	//  Side Effect: The memory budget is set to bytes.  If more
+	//               memory than that is used, the least
+	//               recently used heightmaps are evicted.
+	//
+	void setMemoryBudget (size_t bytes);
+
+	//
+	//  releaseEvicted
+	//
+	//  Purpose: To release the finalized heightmaps that have
+	//           been evicted.
+	//  Parameter(s): N/A
+	//  Precondition(s):
+	//    <1> Called from the thread with the OpenGL context
+	//  Returns: N/A
+	//  Side Effect: The evicted heightmaps that are not in use
+	//               anywhere else are destroyed.  The rest are
+	//               kept until the next call.
+	//
+	void releaseEvicted ();
+
+	//
+	//  clear
+	//
+	//  Purpose: To evict every heightmap.
+	//  Parameter(s): N/A
+	//  Precondition(s): N/A
+	//  Returns: N/A
+	//  Side Effect: The cache is emptied.  Finalized heightmaps
+	//               are released by releaseEvicted.
+	//
+	void clear ();
+
+}  // end of namespace HeightmapCache
+
+
+
+#endif
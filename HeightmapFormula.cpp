@@ -0,0 +1,512 @@
+//
+//  HeightmapFormula.cpp
+//
+
+#include <cassert>
+#include <climits>
+#include <cmath>
+#include <cstdint>
+#include <iostream>
+#include <algorithm>  // for min, max
+
+#include "Pi.h"
+#include "RandomStream.h"
+#include "NoiseField.h"
+#include "ObjLibrary/Vector2.h"
+
+#include "DiskType.h"
+#include "Heightmap.h"
+#include "HeightmapFormula.h"
+
+using namespace std;
+using namespace ObjLibrary;
+namespace
+{
+	//
+	//  sqr
+	//
+	//  Purpose: To square the specified value.
+	//  Parameter(s):
+	//    <1> v: The value to square
+	//  Precondition(s): N/A
+	//  Returns: v * v.
+	//  Side Effect: N/A
+	//
+	template <typename T>
+	inline T sqr (T v)
+	{
+		return v * v;
+	}
+
+	//
+	//  cube
+	//
+	//  Purpose: To cube the specified value.
+	//  Parameter(s):
+	//    <1> v: The value to cube
+	//  Precondition(s): N/A
+	//  Returns: v * v.
+	//  Side Effect: N/A
+	//
+	template <typename T>
+	inline T cube (T v)
+	{
+		return v * v * v;
+	}
+
+	//
+	//  intPow
+	//
+	//  Purpose: To calculate the result of a value raised to an
+	//           non-negative integer exponent.
+	//  Parameter(s):
+	//    <1> v: The value
+	//    <2> e: The exponent
+	//  Precondition(s): N/A
+	//  Returns: v^e.
+	//  Side Effect: N/A
+	//
+	template <typename T>
+	inline T intPow (T v, unsigned int e)
+	{
+		switch(e)
+		{
+		case 0: return (T)(0);
+		case 1: return v;
+		case 2: return sqr(v);
+		case 3: return cube(v);
+		default:
+			{
+				T v_po_e_div_2 = intPow(v, e / 2);
+				T v_po_e_lower = v_po_e_div_2 * v_po_e_div_2;
+				if(e % 2 == 0)
+					return v_po_e_lower;
+				else
+					return v_po_e_lower * v;
+			}
+		}
+	}
+
+	//
+	//  getRandomSphereVector
+	//
+	//  Purpose: To generate a random vector inside the unit
+	//           circle.
+	//  Parameter(s):
+	//    <1> r_random: The RandomStream to choose the vector
+	//                  with
+	//  Precondition(s): N/A
+	//  Returns: A random vector with a norm of at most 1.  All
+	//           points in the unit circle are equally likely.
+	//  Side Effect: r_random advances.
+	//
+	Vector2 getRandomSphereVector (RandomStream& r_random)
+	{
+		while(true)  // loop returns below
+		{
+			Vector2 vector(r_random.random0() * 2.0 - 1.0,
+			               r_random.random0() * 2.0 - 1.0);
+			if(vector.getNormSquared() <= 1.0)
+				return vector;
+		}
+	}
+
+
+
+	const double ICY_HEIGHT_SCALE = 0.7;
+
+	const float SANDY_CELL_SIZE = 16.0f;
+	const float SANDY_AMPLITUDE = 8.0f;
+
+	const float A_GREY_ROCK_CELL_SIZE[] =
+	{	32.0f,	16.0f,	8.0f,	4.0f,	2.0f,	};
+	const float A_GREY_ROCK_AMPLITUDE[] =
+	{	10.0f,	7.0f,	5.0f,	3.5f,	2.5f,	};  // ~2^(-N/2)
+
+	const bool DEBUGGING_SET_HEIGHTS_RED_ROCK = false;
+	const bool DEBUGGING_SET_HEIGHTS_ICY      = false;
+	const bool DEBUGGING_SET_HEIGHTS_SANDY    = false;
+
+}  // end of anonymouse namespace
+
+
+
+HeightmapFormula :: HeightmapFormula (unsigned int disk_type,
+                                      uint64_t seed)
+		: m_disk_type(disk_type)
+		, m_side_length(DiskType::getSideLength(disk_type))
+		, m_noise_count(0)
+{
+	assert(disk_type < DiskType::COUNT);
+
+	RandomStream random(seed);
+	switch(disk_type)
+	{
+	case DiskType::RED_ROCK:  initRedRock(random);  break;
+	case DiskType::LEAFY:     initLeafy(random);    break;
+	case DiskType::ICY:       initIcy(random);      break;
+	case DiskType::SANDY:     initSandy(random);    break;
+	case DiskType::GREY_ROCK: initGreyRock(random); break;
+	}
+
+	assert(invariant());
+}
+
+
+
+unsigned int HeightmapFormula :: getSideLength () const
+{
+	return m_side_length;
+}
+
+float HeightmapFormula :: getVertexHeight (unsigned int i,
+                                           unsigned int j) const
+{
+	assert(i < getSideLength());
+	assert(j < getSideLength());
+
+	if(i == 0 || j == 0)
+		return Heightmap::HEIGHT_EDGE;
+
+	switch(m_disk_type)
+	{
+	case DiskType::RED_ROCK:  return getVertexHeightRedRock(i, j);
+	case DiskType::LEAFY:     return getVertexHeightLeafy(i, j);
+	case DiskType::ICY:       return getVertexHeightIcy(i, j);
+	case DiskType::SANDY:     return getVertexHeightSandy(i, j);
+	case DiskType::GREY_ROCK: return getVertexHeightGreyRock(i, j);
+	}
+
+	assert(false);
+	return Heightmap::HEIGHT_EDGE;
+}
+
+float HeightmapFormula :: getVertexHeightTolerant (int i, int j) const
+{
+	if(               i  <= 0)             return Heightmap::HEIGHT_EDGE;
+	if((unsigned int)(i) >= m_side_length) return Heightmap::HEIGHT_EDGE;
+	if(               j  <= 0)             return Heightmap::HEIGHT_EDGE;
+	if((unsigned int)(j) >= m_side_length) return Heightmap::HEIGHT_EDGE;
+
+	return getVertexHeight(i, j);
+}
+
+float HeightmapFormula :: getHeight (float i, float j) const
+{
+	if(i <= 0.0f)          return Heightmap::HEIGHT_EDGE;
+	if(i >= m_side_length) return Heightmap::HEIGHT_EDGE;
+	if(j <= 0.0f)          return Heightmap::HEIGHT_EDGE;
+	if(j >= m_side_length) return Heightmap::HEIGHT_EDGE;
+
+	int i0 = (int)(i);
+	int i1 = i0 + 1;
+	float fraction_i1 = i - i0;
+
+	int j0 = (int)(j);
+	int j1 = j0 + 1;
+	float fraction_j1 = j - j0;
+
+	// only the 3 vertexes of the triangle containing (i, j)
+	//   are calculated, as for Heightmap::getHeight
+	float height_00 = getVertexHeightTolerant(i0, j0);
+	float height_11 = getVertexHeightTolerant(i1, j1);
+
+	if(fraction_i1 < fraction_j1)
+	{
+		float height_01   = getVertexHeightTolerant(i0, j1);
+		float fraction_01 = fraction_j1 - fraction_i1;
+		return height_00 * (1.0f - fraction_j1) +
+		       height_11 * fraction_i1 +
+		       height_01 * fraction_01;
+	}
+	else
+	{
+		float height_10   = getVertexHeightTolerant(i1, j0);
+		float fraction_10 = fraction_i1 - fraction_j1;
+		return height_00 * (1.0f - fraction_i1) +
+		       height_11 * fraction_j1 +
+		       height_10 * fraction_10;
+	}
+}
+
+
+
+void HeightmapFormula :: initRedRock (RandomStream& r_random)
+{
+	assert(RING_COUNT >= 1);
+	assert(DiskType::getSideLength(DiskType::RED_ROCK) + 1 == RING_COUNT * 2 - 1);
+
+	if(DEBUGGING_SET_HEIGHTS_RED_ROCK)
+		cout << "setHeightsRedRock" << endl;
+
+	// choose a height for each ring
+	ma_ring_height[0] = 0.0f;
+	ma_ring_height[1] = 0.0f;
+	for(unsigned int r = 2; r < RING_COUNT; r++)
+	{
+		assert(r >= 1);
+		ma_ring_height[r] = ma_ring_height[r - 1] + r_random.random2(-1.0f, 2.0f);
+	}
+
+	if(DEBUGGING_SET_HEIGHTS_RED_ROCK)
+	{
+		cout << "Rings:";
+		for(unsigned int r = 0; r < RING_COUNT; r++)
+			cout << "\t" << ma_ring_height[r];
+		cout << endl;
+	}
+}
+
+void HeightmapFormula :: initLeafy (RandomStream& r_random)
+{
+	//
+	//  i2 = i * 2 - 1
+	//  j2 = j * 2 - 1
+	//  dist    = min(sqrt(i2^2 + j2^2), 1)
+	//  radians = atan2(j2, i2);
+	//
+	//  Straight lines:
+	//    Left:   i^4 * (1 - i) * 12
+	//    Center: (cos(pi * i2) + 1) * 0.5
+	//    Right:  (1 - i)^4 * i * 12
+	//
+	//  Rings:
+	//    Inner:               max(1 - dist,           0)^2
+	//    Middle:     sin(pi * min(    dist^0.8 * 4/3, 1)  )
+	//    Outer:  max(sin(pi *         dist^1.6            ), 0)
+	//
+	//  Arms:
+	//    Inner:  (sqrt(    dist) -      dist ) * 4
+	//    Middle: dist2^2 * (1 - dist)^2 * 16
+	//    Outer:  (sqrt(1 - dist) - (1 - dist)) * 4
+	//
+
+	// choose some random parameters for the formula
+	m_line_left   = r_random.random2(-1.0f, 1.0f);
+	m_line_center = r_random.random2(-1.0f, 1.0f);
+	m_line_right  = r_random.random2(-1.0f, 1.0f);
+
+	m_ring_inner  = r_random.random2(-1.0f, 1.0f);
+	m_ring_middle = r_random.random2(-1.0f, 1.0f);
+	m_ring_outer  = r_random.random2(-1.0f, 1.0f);
+
+	m_arm_count   = min(r_random.random2(0, 7), r_random.random2(0, 7));
+	m_arm_radians = r_random.random1(TWO_PI);
+	const double ARM_UP = r_random.randomBool() ? 1.0f : -1.0f;
+	m_arm_inner  = r_random.random2(0.0f, 1.0f) * ARM_UP;
+	m_arm_middle = r_random.random2(0.0f, 1.0f) * ARM_UP;
+	m_arm_outer  = r_random.random2(0.0f, 1.0f) * ARM_UP;
+}
+
+void HeightmapFormula :: initIcy (RandomStream& r_random)
+{
+	if(DEBUGGING_SET_HEIGHTS_ICY)
+		cout << "setHeightsIcy" << endl;
+
+	float half_size = (m_side_length - 1.0f) * 0.5f;
+	Vector2 half_offset(half_size + 1.0, half_size + 1.0);
+
+	for(unsigned int p = 0; p < ICY_POINT_COUNT; p++)
+	{
+		double distance   = max(max(r_random.random0(), r_random.random0()), max(r_random.random0(), r_random.random0())) * half_size;
+		double height_max = (half_size - distance) * ICY_HEIGHT_SCALE;
+		ma_icy_points [p] = half_offset + getRandomSphereVector(r_random) * distance;
+		ma_icy_heights[p] = r_random.random2(-height_max, height_max);
+	}
+
+	if(DEBUGGING_SET_HEIGHTS_ICY)
+	{
+		cout << "Center: " << half_offset << endl;
+		cout << "Points:" << endl;
+		for(unsigned int p = 0; p < ICY_POINT_COUNT; p++)
+			cout << "\t" << ma_icy_points[p] << ", " << ma_icy_heights[p] << endl;
+	}
+}
+
+void HeightmapFormula :: initSandy (RandomStream& r_random)
+{
+	if(DEBUGGING_SET_HEIGHTS_SANDY)
+		cout << "setHeightsSandy" << endl;
+
+	m_noise_count = 1;
+	ma_noise[0] = NoiseField(SANDY_CELL_SIZE, SANDY_AMPLITUDE,
+	                         (unsigned int)(r_random.random0() * UINT_MAX),
+	                         (unsigned int)(r_random.random0() * UINT_MAX),
+	                         (unsigned int)(r_random.random0() * UINT_MAX),
+	                         (unsigned int)(r_random.random0() * UINT_MAX),
+	                         (unsigned int)(r_random.random0() * UINT_MAX),
+	                         (unsigned int)(r_random.random0() * UINT_MAX),
+	                         (unsigned int)(r_random.random0() * UINT_MAX));
+
+	if(DEBUGGING_SET_HEIGHTS_SANDY)
+		cout << "Created noise field" << endl;
+}
+
+void HeightmapFormula :: initGreyRock (RandomStream& r_random)
+{
+	m_noise_count = NOISE_LEVEL_COUNT;
+	for(unsigned int i = 0; i < NOISE_LEVEL_COUNT; i++)
+	{
+		ma_noise[i] = NoiseField(A_GREY_ROCK_CELL_SIZE[i], A_GREY_ROCK_AMPLITUDE[i],
+		                         (unsigned int)(r_random.random0() * UINT_MAX),
+		                         (unsigned int)(r_random.random0() * UINT_MAX),
+		                         (unsigned int)(r_random.random0() * UINT_MAX),
+		                         (unsigned int)(r_random.random0() * UINT_MAX),
+		                         (unsigned int)(r_random.random0() * UINT_MAX),
+		                         (unsigned int)(r_random.random0() * UINT_MAX),
+		                         (unsigned int)(r_random.random0() * UINT_MAX));
+	}
+}
+
+
+
+float HeightmapFormula :: getVertexHeightRedRock (unsigned int i,
+                                                  unsigned int j) const
+{
+	assert(i >= 1 && i < getSideLength());
+	assert(j >= 1 && j < getSideLength());
+
+	// set vertexes to ring height
+	int center = m_side_length / 2;
+
+	unsigned int diff_i   = abs((int)(i) - center);
+	unsigned int diff_j   = abs((int)(j) - center);
+	unsigned int diff_max = (diff_i > diff_j) ? diff_i : diff_j;
+
+	if(DEBUGGING_SET_HEIGHTS_RED_ROCK)
+		cout << "\t(" << i << ", " << j << ")  diffs: " << diff_i << ", " << diff_j << " => " << diff_max << endl;
+
+	assert(diff_max <= RING_COUNT - 1);
+	unsigned int ring = RING_COUNT - 1 - diff_max;
+
+	if(DEBUGGING_SET_HEIGHTS_RED_ROCK)
+		cout << "\t\tRing: " << ring << " (" << ma_ring_height[ring] << ")" << endl;
+
+	return ma_ring_height[ring];
+}
+
+float HeightmapFormula :: getVertexHeightLeafy (unsigned int i,
+                                                unsigned int j) const
+{
+	assert(i >= 1 && i < getSideLength());
+	assert(j >= 1 && j < getSideLength());
+
+	// basic variables
+	double i1 = (double)(i) / (double)(m_side_length);
+	double j1 = (double)(j) / (double)(m_side_length);
+	double i2 = i1 * 2.0 - 1.0;
+	double j2 = j1 * 2.0 - 1.0;
+	double dist    = min(sqrt(sqr(i2) + sqr(j2)), 1.0);
+	double radians = atan2(j2, i2);
+
+	// line/ring combination
+	double line_left   = intPow(i1, 4) * (1.0f - i1) * 12.0f;
+	double line_center = (cos(PI * i2) + 1) * 0.5;
+	double line_right  = intPow(1.0f - i1, 4) * (i1) * 12.0f;
+	double line_sum    = line_left * m_line_left + line_center * m_line_center + line_right * m_line_right;
+
+	double ring_inner  =     sqr(     max(1.0 -      dist,                   0.0));
+	double ring_middle =     sin(PI * min(       pow(dist, 0.8) * 4.0 / 3.0, 1.0));
+	double ring_outer  = max(sin(PI *            pow(dist, 1.6)                  ), 0.0);
+	double ring_sum    = ring_inner * m_ring_inner + ring_middle * m_ring_middle + ring_outer * m_ring_outer;
+
+	double non_arm_height = line_sum * ring_sum;
+
+	// arms
+	double arm_inner  = (sqrt(dist) - dist) * 4.0;
+	double arm_middle = sqr(dist) * sqr(1.0 - dist) * 16.0;
+	double arm_outer  = (sqrt(1.0 - dist) - (1.0 - dist)) * 4.0;
+	double arm_sum    = arm_inner * m_arm_inner + arm_middle * m_arm_middle + arm_outer * m_arm_outer;
+
+	double arm_magnitude = (sin(radians * m_arm_count + m_arm_radians) + 1.0) * 0.5;
+	double arm_height    = arm_magnitude * arm_sum;
+
+	// putting it together
+	double weighted_sum = non_arm_height * 5.0 + arm_height * 3.0;
+	return (float)(weighted_sum);
+}
+
+float HeightmapFormula :: getVertexHeightIcy (unsigned int i,
+                                              unsigned int j) const
+{
+	assert(i >= 1 && i < getSideLength());
+	assert(j >= 1 && j < getSideLength());
+
+	Vector2 position(i, j);
+	double lowest  = 0.0;
+	double highest = 0.0;
+
+	for(unsigned int p = 0; p < ICY_POINT_COUNT; p++)
+	{
+		double distance_scaled = position.getDistance(ma_icy_points[p]) * ICY_HEIGHT_SCALE;
+		double high = ma_icy_heights[p] - distance_scaled;
+		double low  = ma_icy_heights[p] + distance_scaled;
+
+		if(high > highest)
+			highest = high;
+		if(low < lowest)
+			lowest = low;
+	}
+
+	double sum = highest + lowest;
+	if(DEBUGGING_SET_HEIGHTS_ICY)
+		cout << "\t(" << i << ", " << j << "): " << highest << " - " << fabs(lowest) << " = " << sum << endl;
+
+	return (float)(sum);
+}
+
+float HeightmapFormula :: getVertexHeightSandy (unsigned int i,
+                                                unsigned int j) const
+{
+	assert(i >= 1 && i < getSideLength());
+	assert(j >= 1 && j < getSideLength());
+	assert(m_noise_count == 1);
+
+	float edge_factor = getEdgeFactor(i, j);
+	float noise_at    = ma_noise[0].perlin((float)(i), (float)(j));
+
+	if(DEBUGGING_SET_HEIGHTS_SANDY)
+		cout << "\t(" << i << ", " << j << "): " << edge_factor << " * " << noise_at << " = " << (noise_at * edge_factor) << endl;
+
+	return edge_factor * noise_at;
+}
+
+float HeightmapFormula :: getVertexHeightGreyRock (unsigned int i,
+                                                   unsigned int j) const
+{
+	assert(i >= 1 && i < getSideLength());
+	assert(j >= 1 && j < getSideLength());
+	assert(m_noise_count == NOISE_LEVEL_COUNT);
+
+	float edge_factor = getEdgeFactor(i, j);
+	float noise_at    = 0.0f;
+	for(unsigned int l = 0; l < NOISE_LEVEL_COUNT; l++)
+		noise_at += ma_noise[l].perlin((float)(i), (float)(j));
+
+	return edge_factor * noise_at;
+}
+
+float HeightmapFormula :: getEdgeFactor (unsigned int i,
+                                         unsigned int j) const
+{
+	assert(i < getSideLength());
+	assert(j < getSideLength());
+
+	static const unsigned int EXPONENT = 6;
+
+	float i1 = i / (m_side_length + 1.0f);
+	float i2 = 1.0f - i1;
+
+	float j1 = j / (m_side_length + 1.0f);
+	float j2 = 1.0f - j1;
+
+	return (1.0f - max(max(intPow(i1, EXPONENT), intPow(i2, EXPONENT)),
+	                   max(intPow(j1, EXPONENT), intPow(j2, EXPONENT)))) / ( 1.0f - intPow(0.5f, EXPONENT));
+}
+
+bool HeightmapFormula :: invariant () const
+{
+	if(m_disk_type >= DiskType::COUNT) return false;
+	if(m_side_length != DiskType::getSideLength(m_disk_type)) return false;
+	return true;
+}
@@ -0,0 +1,250 @@
+//
+//  HeightmapFormula.h
+//
+//  A module to calculate the heights of a heightmap without
+//    storing them.
+//
+
+#ifndef HEIGHTMAP_FORMULA_H
+#define HEIGHTMAP_FORMULA_H
+
+#include <cstdint>
+
+#include "ObjLibrary/Vector2.h"
+
+#include "RandomStream.h"
+#include "NoiseField.h"
+
+
+
+//
+//  HeightmapFormula
+//
+//  A class to calculate the vertex heights for the heightmap
+//    of 1 disk.  The random parameters for the disk type are
+//    chosen when a HeightmapFormula is created, and the height
+//    of each vertex is then calculated from them independently
+//    of the others.  A Heightmap created with the same disk
+//    type and seed has exactly the same vertex heights, because
+//    it uses a HeightmapFormula to set them.
+//
+//  Finding one height with a HeightmapFormula is much cheaper
+//    than generating the whole Heightmap, and a
+//    HeightmapFormula never changes once created, so it can be
+//    created on the stack whenever a height is needed and used
+//    from any thread.
+//
+//  The vertexes are numbered as for a Heightmap, with vertex 0
+//    in each direction being the edge.
+//
+//  Class Invariant:
+//    <1> m_disk_type < DiskType::COUNT
+//    <2> m_side_length == DiskType::getSideLength(m_disk_type)
+//
+class HeightmapFormula
+{
+public:
+	//
+	//  Constructor
+	//
+	//  Purpose: To create a new HeightmapFormula for a disk of
+	//           the specified type.
+	//  Parameter(s):
+	//    <1> disk_type: The type of the disk
+	//    <2> seed: The seed for the random heights
+	//  Precondition(s):
+	//    <1> disk_type < DiskType::COUNT
+	//  Returns: N/A
+	//  Side Effect: A new HeightmapFormula is created for a disk
+	//               of type disk_type.  The heights depend only
+	//               on disk_type and seed.
+	//
+	HeightmapFormula (unsigned int disk_type,
+	                  uint64_t seed);
+
+	HeightmapFormula (const HeightmapFormula& original) = default;
+	~HeightmapFormula () = default;
+	HeightmapFormula& operator= (
+	                   const HeightmapFormula& original) = default;
+
+	//
+	//  getSideLength
+	//
+	//  Purpose: To determine the side length of the heightmap
+	//           for this HeightmapFormula.
+	//  Parameter(s): N/A
+	//  Precondition(s): N/A
+	//  Returns: The side length in cells.
+	//  Side Effect: N/A
+	//
+	unsigned int getSideLength () const;
+
+	//
+	//  getVertexHeight
+	//
+	//  Purpose: To calculate the height of the specified vertex.
+	//  Parameter(s):
+	//    <1> i
+	//    <2> j: The coordinates of the vertex
+	//  Precondition(s):
+	//    <1> i < getSideLength()
+	//    <2> j < getSideLength()
+	//  Returns: The height of the vertex with coordinates
+	//           (i, j).  If i or j is 0, Heightmap::HEIGHT_EDGE
+	//           is returned.
+	//  Side Effect: N/A
+	//
+	float getVertexHeight (unsigned int i,
+	                       unsigned int j) const;
+
+	//
+	//  getVertexHeightTolerant
+	//
+	//  Purpose: To calculate the height of the specified vertex.
+	//  Parameter(s):
+	//    <1> i
+	//    <2> j: The coordinates of the vertex
+	//  Precondition(s): N/A
+	//  Returns: The height of the vertex with coordinates
+	//           (i, j).  If there is no such vertex in the
+	//           heightmap, Heightmap::HEIGHT_EDGE is returned.
+	//  Side Effect: N/A
+	//
+	float getVertexHeightTolerant (int i, int j) const;
+
+	//
+	//  getHeight
+	//
+	//  Purpose: To calculate the height of the heightmap at the
+	//           specified position.
+	//  Parameter(s):
+	//    <1> i
+	//    <2> j: The coordinates of the position
+	//  Precondition(s): N/A
+	//  Returns: The height at position (i, j), interpolated in
+	//           the same way as Heightmap::getHeight.  If
+	//           position (i, j) is outside the heightmap,
+	//           Heightmap::HEIGHT_EDGE is returned.
+	//  Side Effect: N/A
+	//
+	float getHeight (float i, float j) const;
+
+private:
+	//
+	//  Helper Function: initRedRock
+	//  Helper Function: initLeafy
+	//  Helper Function: initIcy
+	//  Helper Function: initSandy
+	//  Helper Function: initGreyRock
+	//
+	//  Purpose: To choose the random parameters for a disk of
+	//           the indicated disk type.
+	//  Parameter(s):
+	//    <1> r_random: The RandomStream to choose the
+	//                  parameters with
+	//  Precondition(s): N/A
+	//  Returns: N/A
+	//  Side Effect: The parameters are chosen.  r_random
+	//               advances.
+	//
+	void initRedRock  (RandomStream& r_random);
+	void initLeafy    (RandomStream& r_random);
+	void initIcy      (RandomStream& r_random);
+	void initSandy    (RandomStream& r_random);
+	void initGreyRock (RandomStream& r_random);
+
+	//
+	//  Helper Function: getVertexHeightRedRock
+	//  Helper Function: getVertexHeightLeafy
+	//  Helper Function: getVertexHeightIcy
+	//  Helper Function: getVertexHeightSandy
+	//  Helper Function: getVertexHeightGreyRock
+	//
+	//  Purpose: To calculate the height of the specified vertex
+	//           for a disk of the indicated disk type.
+	//  Parameter(s):
+	//    <1> i
+	//    <2> j: The coordinates of the vertex
+	//  Precondition(s):
+	//    <1> i >= 1 && i < getSideLength()
+	//    <2> j >= 1 && j < getSideLength()
+	//  Returns: The height of the vertex with coordinates
+	//           (i, j).
+	//  Side Effect: N/A
+	//
+	float getVertexHeightRedRock  (unsigned int i,
+	                               unsigned int j) const;
+	float getVertexHeightLeafy    (unsigned int i,
+	                               unsigned int j) const;
+	float getVertexHeightIcy      (unsigned int i,
+	                               unsigned int j) const;
+	float getVertexHeightSandy    (unsigned int i,
+	                               unsigned int j) const;
+	float getVertexHeightGreyRock (unsigned int i,
+	                               unsigned int j) const;
+
+	//
+	//  Helper Function: getEdgeFactor
+	//
+	//  Purpose: To determine the multiplier factor for the
+	//           perlin noise based on the distance to the
+	//           heightmap edge.
+	//  Parameter(s):
+	//    <1> i
+	//    <2> j: The coordinates of the vertex
+	//  Precondition(s):
+	//    <1> i < getSideLength()
+	//    <2> j < getSideLength()
+	//  Returns: The hight multiplier for vertex (i, j).
+	//  Side Effect: N/A
+	//
+	float getEdgeFactor (unsigned int i,
+	                     unsigned int j) const;
+
+	//
+	//  Helper Function: invariant
+	//
+	//  Purpose: To determine if the class invariant is true.
+	//  Parameter(s): N/A
+	//  Precondition(s): N/A
+	//  Returns: Whether the class invariant is true.
+	//  Side Effect: N/A
+	//
+	bool invariant () const;
+
+private:
+	static const unsigned int RING_COUNT        = 8 + 1;
+	static const unsigned int ICY_POINT_COUNT   = 200;
+	static const unsigned int NOISE_LEVEL_COUNT = 5;
+
+	unsigned int m_disk_type;
+	unsigned int m_side_length;
+
+	// red rock
+	float ma_ring_height[RING_COUNT];
+
+	// leafy
+	double m_line_left;
+	double m_line_center;
+	double m_line_right;
+	double m_ring_inner;
+	double m_ring_middle;
+	double m_ring_outer;
+	unsigned int m_arm_count;
+	double m_arm_radians;
+	double m_arm_inner;
+	double m_arm_middle;
+	double m_arm_outer;
+
+	// icy
+	ObjLibrary::Vector2 ma_icy_points [ICY_POINT_COUNT];
+	double              ma_icy_heights[ICY_POINT_COUNT];
+
+	// sandy and grey rock
+	NoiseField ma_noise[NOISE_LEVEL_COUNT];
+	unsigned int m_noise_count;
+};
+
+
+
+#endif
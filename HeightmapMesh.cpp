@@ -0,0 +1,163 @@
+//
+//  HeightmapMesh.cpp
+//
+
+#include <cassert>
+#include <map>
+#include <mutex>
+#include <vector>
+
+#include "GetGlut.h"
+
+#include "HeightmapMesh.h"
+
+using namespace std;
+namespace
+{
+	mutex g_indexes_mutex;
+	map<unsigned int, vector<unsigned short> > g_indexes_by_side_length;
+}
+
+
+
+unsigned int HeightmapMesh :: getVertexCount (unsigned int side_length)
+{
+	assert(side_length >= 1);
+
+	return (side_length + 1) * (side_length + 1);
+}
+
+unsigned int HeightmapMesh :: getIndexCount (unsigned int side_length)
+{
+	assert(side_length >= 1);
+
+	return side_length * side_length * 6;
+}
+
+const vector<unsigned short>& HeightmapMesh :: getSharedIndexes (unsigned int side_length)
+{
+	assert(side_length >= 1);
+	assert(getVertexCount(side_length) <= 65536);
+
+	lock_guard<mutex> lock(g_indexes_mutex);
+
+	// references to map elements are never invalidated
+	vector<unsigned short>& r_indexes = g_indexes_by_side_length[side_length];
+	if(r_indexes.empty())
+	{
+		//
+		//  Each cell is split into 2 triangles along the same
+		//    diagonal used by Heightmap::getHeight:
+		//
+		//    01 +---+ 11
+		//       | / |
+		//    00 +---+ 10
+		//
+		unsigned int row_length = side_length + 1;
+		r_indexes.reserve(getIndexCount(side_length));
+		for(unsigned int i0 = 0; i0 < side_length; i0++)
+			for(unsigned int j0 = 0; j0 < side_length; j0++)
+			{
+				unsigned short index_00 = (unsigned short)( j0      * row_length + i0);
+				unsigned short index_10 = (unsigned short)( j0      * row_length + i0 + 1);
+				unsigned short index_01 = (unsigned short)((j0 + 1) * row_length + i0);
+				unsigned short index_11 = (unsigned short)((j0 + 1) * row_length + i0 + 1);
+
+				r_indexes.push_back(index_10);
+				r_indexes.push_back(index_00);
+				r_indexes.push_back(index_11);
+
+				r_indexes.push_back(index_11);
+				r_indexes.push_back(index_00);
+				r_indexes.push_back(index_01);
+			}
+		assert(r_indexes.size() == getIndexCount(side_length));
+	}
+	return r_indexes;
+}
+
+
+
+HeightmapMesh :: HeightmapMesh ()
+		: m_side_length(1)
+		, mv_vertexes(getVertexCount(1) * FLOATS_PER_VERTEX, 0.0f)
+		, mp_indexes(&getSharedIndexes(1))
+{
+	assert(invariant());
+}
+
+HeightmapMesh :: HeightmapMesh (unsigned int side_length,
+                                unsigned int texture_repeat,
+                                const vector<float>& heights)
+		: m_side_length(side_length)
+		, mv_vertexes(getVertexCount(side_length) * FLOATS_PER_VERTEX)
+		, mp_indexes(&getSharedIndexes(side_length))
+{
+	assert(side_length >= 1);
+	assert(heights.size() == side_length * side_length);
+
+	float fraction_per_cell = 1.0f / side_length;
+	float texture_per_cell  = (float)(texture_repeat) / side_length;
+
+	unsigned int v = 0;
+	for(unsigned int j = 0; j <= side_length; j++)
+	{
+		// using modulus to avoid array index out of bounds on last vertex
+		unsigned int j_index = j % side_length;
+		for(unsigned int i = 0; i <= side_length; i++)
+		{
+			unsigned int i_index = i % side_length;
+
+			assert(v + FLOATS_PER_VERTEX <= mv_vertexes.size());
+			mv_vertexes[v    ] = i * texture_per_cell;
+			mv_vertexes[v + 1] = j * texture_per_cell;
+			mv_vertexes[v + 2] = i * fraction_per_cell;
+			mv_vertexes[v + 3] = heights[j_index * side_length + i_index];
+			mv_vertexes[v + 4] = j * fraction_per_cell;
+			v += FLOATS_PER_VERTEX;
+		}
+	}
+	assert(v == mv_vertexes.size());
+
+	assert(invariant());
+}
+
+
+
+unsigned int HeightmapMesh :: getSideLength () const
+{
+	return m_side_length;
+}
+
+const vector<float>& HeightmapMesh :: getVertexData () const
+{
+	return mv_vertexes;
+}
+
+const vector<unsigned short>& HeightmapMesh :: getIndexes () const
+{
+	assert(mp_indexes != NULL);
+	return *mp_indexes;
+}
+
+void HeightmapMesh :: draw () const
+{
+	assert(mp_indexes != NULL);
+
+	glInterleavedArrays(GL_T2F_V3F, 0, mv_vertexes.data());
+	glDrawElements(GL_TRIANGLES, (GLsizei)(mp_indexes->size()),
+	               GL_UNSIGNED_SHORT, mp_indexes->data());
+	glDisableClientState(GL_VERTEX_ARRAY);
+	glDisableClientState(GL_TEXTURE_COORD_ARRAY);
+}
+
+
+
+bool HeightmapMesh :: invariant () const
+{
+	if(m_side_length < 1) return false;
+	if(mv_vertexes.size() != getVertexCount(m_side_length) * FLOATS_PER_VERTEX) return false;
+	if(mp_indexes == NULL) return false;
+	if(mp_indexes->size() != getIndexCount(m_side_length)) return false;
+	return true;
+}
@@ -0,0 +1,218 @@
+//
+//  HeightmapMesh.h
+//
+//  A module to represent the CPU-side 3D mesh for the surface
+//    of a heightmap.
+//
+
+#ifndef HEIGHTMAP_MESH_H
+#define HEIGHTMAP_MESH_H
+
+#include <cassert>
+#include <vector>
+
+
+
+//
+//  HeightmapMesh
+//
+//  A class to represent the 3D mesh for a Heightmap before it
+//    is sent to the graphics card.  The mesh is a grid of
+//    (side length + 1) * (side length + 1) vertexes stored as
+//    an interleaved float array in GL_T2F_V3F format (texture
+//    coordinates followed by position).  The vertexes are
+//    stored row by row, so the vertex with coordinates (i, j)
+//    is at index j * (side length + 1) + i.
+//
+//  The triangles are described by an index array.  The index
+//    array only depends on the side length, so one array is
+//    shared by every HeightmapMesh with that side length.
+//
+//  A HeightmapMesh does not use OpenGL until it is drawn, so
+//    meshes can be built on any thread.  They are normally
+//    drawn once, while a display list is being compiled.
+//
+//  Class Invariant:
+//    <1> m_side_length >= 1
+//    <2> mv_vertexes.size() ==
+//                  getVertexCount(m_side_length) * FLOATS_PER_VERTEX
+//    <3> mp_indexes != NULL
+//    <4> mp_indexes->size() == getIndexCount(m_side_length)
+//
+class HeightmapMesh
+{
+public:
+	//
+	//  FLOATS_PER_VERTEX
+	//
+	//  The number of floats used to store each vertex.  These
+	//    are texture coordinates s and t and then position x,
+	//    y, and z.
+	//
+	static const unsigned int FLOATS_PER_VERTEX = 5;
+
+	//
+	//  Class Function: getVertexCount
+	//
+	//  Purpose: To determine the number of vertexes in a mesh
+	//           with the specified side length.
+	//  Parameter(s):
+	//    <1> side_length: The side length in cells
+	//  Precondition(s):
+	//    <1> side_length >= 1
+	//  Returns: The number of vertexes.
+	//  Side Effect: N/A
+	//
+	static unsigned int getVertexCount (unsigned int side_length);
+
+	//
+	//  Class Function: getIndexCount
+	//
+	//  Purpose: To determine the number of indexes needed to
+	//           draw a mesh with the specified side length.
+	//  Parameter(s):
+	//    <1> side_length: The side length in cells
+	//  Precondition(s):
+	//    <1> side_length >= 1
+	//  Returns: The number of indexes.  There are 3 indexes
+	//           for each triangle.
+	//  Side Effect: N/A
+	//
+	static unsigned int getIndexCount (unsigned int side_length);
+
+	//
+	//  Class Function: getSharedIndexes
+	//
+	//  Purpose: To retrieve the shared index array for meshes
+	//           with the specified side length.
+	//  Parameter(s):
+	//    <1> side_length: The side length in cells
+	//  Precondition(s):
+	//    <1> side_length >= 1
+	//    <2> getVertexCount(side_length) <= 65536
+	//  Returns: The index array.  The indexes describe the
+	//           triangles as a GL_TRIANGLES list.
+	//  Side Effect: If this is the first time this function has
+	//               been called for side_length, the index
+	//               array is calculated.  This function is
+	//               thread-safe.
+	//
+	static const std::vector<unsigned short>& getSharedIndexes (
+	                                 unsigned int side_length);
+
+public:
+	//
+	//  Default Constructor
+	//
+	//  Purpose: To create a new HeightmapMesh for a flat
+	//           heightmap with a side length of 1.
+	//  Parameter(s): N/A
+	//  Precondition(s): N/A
+	//  Returns: N/A
+	//  Side Effect: A new HeightmapMesh is created.
+	//
+	HeightmapMesh ();
+
+	//
+	//  Constructor
+	//
+	//  Purpose: To create a new HeightmapMesh for a heightmap
+	//           with the specified values.
+	//  Parameter(s):
+	//    <1> side_length: The side length in cells
+	//    <2> texture_repeat: The number of times the texture
+	//                        repeats across the heightmap
+	//    <3> heights: The vertex heights
+	//  Precondition(s):
+	//    <1> side_length >= 1
+	//    <2> heights.size() == side_length * side_length
+	//  Returns: N/A
+	//  Side Effect: A new HeightmapMesh is created.  The height
+	//               of vertex (i, j) is taken from heights[(j %
+	//               side_length) * side_length + (i %
+	//               side_length)], so the last row and column
+	//               repeat the first ones.  The mesh covers the
+	//               space from [0, 1] along the x and z axes.
+	//
+	HeightmapMesh (unsigned int side_length,
+	               unsigned int texture_repeat,
+	               const std::vector<float>& heights);
+
+	HeightmapMesh (const HeightmapMesh& original) = default;
+	~HeightmapMesh () = default;
+	HeightmapMesh& operator= (const HeightmapMesh& original) = default;
+
+	//
+	//  getSideLength
+	//
+	//  Purpose: To determine the side length of this
+	//           HeightmapMesh.
+	//  Parameter(s): N/A
+	//  Precondition(s): N/A
+	//  Returns: The side length in cells.
+	//  Side Effect: N/A
+	//
+	unsigned int getSideLength () const;
+
+	//
+	//  getVertexData
+	//
+	//  Purpose: To retrieve the interleaved vertex array for
+	//           this HeightmapMesh.
+	//  Parameter(s): N/A
+	//  Precondition(s): N/A
+	//  Returns: The vertex array in GL_T2F_V3F format.
+	//  Side Effect: N/A
+	//
+	const std::vector<float>& getVertexData () const;
+
+	//
+	//  getIndexes
+	//
+	//  Purpose: To retrieve the index array for this
+	//           HeightmapMesh.
+	//  Parameter(s): N/A
+	//  Precondition(s): N/A
+	//  Returns: The index array.  This array is shared with
+	//           all other HeightmapMeshes with the same side
+	//           length.
+	//  Side Effect: N/A
+	//
+	const std::vector<unsigned short>& getIndexes () const;
+
+	//
+	//  draw
+	//
+	//  Purpose: To display this HeightmapMesh.
+	//  Parameter(s): N/A
+	//  Precondition(s): N/A
+	//  Returns: N/A
+	//  Side Effect: This HeightmapMesh is displayed using
+	//               vertex arrays.  If a display list is being
+	//               compiled, the mesh is copied into it.  The
+	//               vertex and texture coordinate arrays are
+	//               disabled afterwards.
+	//
+	void draw () const;
+
+private:
+	//
+	//  Helper Function: invariant
+	//
+	//  Purpose: To determine if the class invariant is true.
+	//  Parameter(s): N/A
+	//  Precondition(s): N/A
+	//  Returns: Whether the class invariant is true.
+	//  Side Effect: N/A
+	//
+	bool invariant () const;
+
+private:
+	unsigned int m_side_length;
+	std::vector<float> mv_vertexes;
+	const std::vector<unsigned short>* mp_indexes;
+};
+
+
+
+#endif
@@ -0,0 +1,293 @@
+//
+//  InputRecording.cpp
+//
+
+#include <algorithm>
+#include <cassert>
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include "ObjLibrary/MappedFile.h"
+
+#include "InputRecording.h"
+
+using namespace std;
+using namespace ObjLibrary;
+namespace
+{
+	//
+	//  The file layout is:
+	//
+	//    FileHeader
+	//    uint32_t state_hashes[tick_count]
+	//    uint32_t run_lengths [run_count]
+	//    uint8_t  run_inputs  [run_count]
+	//    char     world_filename[filename_length]
+	//
+	//  The world filename is not terminated.
+	//
+
+	const char FILE_MAGIC[4] = { 'A', '5', 'I', '\0' };
+	const uint32_t FILE_VERSION = 1;
+
+	// written as a number, so it reads differently in the other byte order
+	const uint32_t BYTE_ORDER_MARK = 0x01020304;
+
+	struct FileHeader
+	{
+		char ma_magic[4];
+		uint32_t m_byte_order;
+		uint32_t m_version;
+		uint32_t m_warm_up_count;
+		uint64_t m_world_seed;
+		uint64_t m_game_seed;
+		uint32_t m_tick_count;
+		uint32_t m_run_count;
+		uint32_t m_filename_length;
+		uint32_t m_padding;
+	};
+
+	static_assert(sizeof(FileHeader) == 48, "FileHeader must not be padded");
+}
+
+
+
+InputRecording :: InputRecording ()
+		: m_world_filename()
+		, m_world_seed(0)
+		, m_game_seed(0)
+		, m_warm_up_count(0)
+		, mv_run_ends()
+		, mv_run_inputs()
+		, mv_state_hashes()
+{
+	assert(invariant());
+}
+
+
+
+const string& InputRecording :: getWorldFilename () const
+{
+	return m_world_filename;
+}
+
+uint64_t InputRecording :: getWorldSeed () const
+{
+	return m_world_seed;
+}
+
+uint64_t InputRecording :: getGameSeed () const
+{
+	return m_game_seed;
+}
+
+unsigned int InputRecording :: getWarmUpCount () const
+{
+	return m_warm_up_count;
+}
+
+unsigned int InputRecording :: getTickCount () const
+{
+	return mv_state_hashes.size();
+}
+
+unsigned int InputRecording :: getRunCount () const
+{
+	return mv_run_ends.size();
+}
+
+unsigned int InputRecording :: getInput (unsigned int tick) const
+{
+	assert(tick < getTickCount());
+
+	// the first run that ends after tick contains it
+	vector<uint32_t>::const_iterator found = upper_bound(mv_run_ends.begin(), mv_run_ends.end(), tick);
+	assert(found != mv_run_ends.end());
+	return mv_run_inputs[found - mv_run_ends.begin()];
+}
+
+bool InputRecording :: isStateHashMatching (unsigned int tick,
+                                            uint64_t state_hash) const
+{
+	assert(tick < getTickCount());
+
+	return mv_state_hashes[tick] == shortenHash(state_hash);
+}
+
+bool InputRecording :: save (const string& filename) const
+{
+	assert(filename != "");
+
+	vector<uint32_t> v_run_lengths(mv_run_ends.size());
+	for(unsigned int r = 0; r < mv_run_ends.size(); r++)
+		v_run_lengths[r] = mv_run_ends[r] - (r == 0 ? 0 : mv_run_ends[r - 1]);
+
+	FileHeader header;
+	memcpy(header.ma_magic, FILE_MAGIC, sizeof(FILE_MAGIC));
+	header.m_byte_order      = BYTE_ORDER_MARK;
+	header.m_version         = FILE_VERSION;
+	header.m_warm_up_count   = m_warm_up_count;
+	header.m_world_seed      = m_world_seed;
+	header.m_game_seed       = m_game_seed;
+	header.m_tick_count      = mv_state_hashes.size();
+	header.m_run_count       = mv_run_ends.size();
+	header.m_filename_length = m_world_filename.size();
+	header.m_padding         = 0;
+
+	ofstream output(filename.c_str(), ios::out | ios::binary | ios::trunc);
+	output.write((const char*)(&header), sizeof(header));
+	output.write((const char*)(mv_state_hashes.data()), mv_state_hashes.size() * sizeof(uint32_t));
+	output.write((const char*)(v_run_lengths.data()), v_run_lengths.size() * sizeof(uint32_t));
+	output.write((const char*)(mv_run_inputs.data()), mv_run_inputs.size() * sizeof(uint8_t));
+	output.write(m_world_filename.data(), m_world_filename.size());
+	output.close();
+
+	if(output.fail())
+	{
+		cerr << "Error in InputRecording::save: Could not write \"" << filename << "\"" << endl;
+		return false;
+	}
+	return true;
+}
+
+
+
+void InputRecording :: start (const string& world_filename,
+                              uint64_t world_seed,
+                              uint64_t game_seed,
+                              unsigned int warm_up_count)
+{
+	assert(world_filename != "");
+
+	clear();
+	m_world_filename = world_filename;
+	m_world_seed     = world_seed;
+	m_game_seed      = game_seed;
+	m_warm_up_count  = warm_up_count;
+
+	assert(invariant());
+}
+
+void InputRecording :: addTick (unsigned int input,
+                                uint64_t state_hash)
+{
+	assert(input <= UINT8_MAX);
+
+	uint32_t tick = mv_state_hashes.size();
+	if(!mv_run_inputs.empty() && mv_run_inputs.back() == input)
+		mv_run_ends.back() = tick + 1;
+	else
+	{
+		mv_run_ends.push_back(tick + 1);
+		mv_run_inputs.push_back((uint8_t)(input));
+	}
+	mv_state_hashes.push_back(shortenHash(state_hash));
+
+	assert(invariant());
+}
+
+bool InputRecording :: load (const string& filename)
+{
+	assert(filename != "");
+
+	clear();
+	m_world_filename = "";
+
+	MappedFile file(filename);
+	if(!file.isOpen() || file.getSize() < sizeof(FileHeader))
+	{
+		cerr << "Error in InputRecording::load: Could not read \"" << filename << "\"" << endl;
+		return false;
+	}
+
+	const char* a_data = file.getData();
+	FileHeader header;
+	memcpy(&header, a_data, sizeof(header));
+	if(memcmp(header.ma_magic, FILE_MAGIC, sizeof(FILE_MAGIC)) != 0 ||
+	   header.m_byte_order != BYTE_ORDER_MARK ||
+	   header.m_version    != FILE_VERSION)
+	{
+		cerr << "Error in InputRecording::load: \"" << filename << "\" is not an input recording" << endl;
+		return false;
+	}
+
+	// use 64-bit sizes so that damaged counts cannot overflow
+	uint64_t hash_bytes   = (uint64_t)(header.m_tick_count) * sizeof(uint32_t);
+	uint64_t length_bytes = (uint64_t)(header.m_run_count)  * sizeof(uint32_t);
+	uint64_t input_bytes  = (uint64_t)(header.m_run_count)  * sizeof(uint8_t);
+	uint64_t payload_size = hash_bytes + length_bytes + input_bytes + header.m_filename_length;
+	if(sizeof(FileHeader) + payload_size != file.getSize() ||
+	   header.m_filename_length == 0)
+	{
+		cerr << "Error in InputRecording::load: \"" << filename << "\" is damaged" << endl;
+		return false;
+	}
+
+	const char* p_next = a_data + sizeof(FileHeader);
+	mv_state_hashes.resize(header.m_tick_count);
+	memcpy(mv_state_hashes.data(), p_next, (size_t)(hash_bytes));
+	p_next += hash_bytes;
+
+	mv_run_ends.resize(header.m_run_count);
+	memcpy(mv_run_ends.data(), p_next, (size_t)(length_bytes));
+	p_next += length_bytes;
+	uint64_t run_end = 0;
+	for(unsigned int r = 0; r < header.m_run_count; r++)
+	{
+		if(mv_run_ends[r] == 0)
+			run_end = UINT64_MAX;  // empty runs are never written
+		else
+			run_end += mv_run_ends[r];
+		if(run_end > header.m_tick_count)
+			break;
+		mv_run_ends[r] = (uint32_t)(run_end);
+	}
+	if(run_end != header.m_tick_count)
+	{
+		cerr << "Error in InputRecording::load: \"" << filename << "\" is damaged" << endl;
+		clear();
+		return false;
+	}
+
+	mv_run_inputs.resize(header.m_run_count);
+	memcpy(mv_run_inputs.data(), p_next, (size_t)(input_bytes));
+	p_next += input_bytes;
+
+	m_world_filename.assign(p_next, header.m_filename_length);
+	p_next += header.m_filename_length;
+	assert(p_next == a_data + file.getSize());
+
+	m_world_seed    = header.m_world_seed;
+	m_game_seed     = header.m_game_seed;
+	m_warm_up_count = header.m_warm_up_count;
+
+	assert(invariant());
+	return true;
+}
+
+
+
+uint32_t InputRecording :: shortenHash (uint64_t hash)
+{
+	return (uint32_t)(hash ^ (hash >> 32));
+}
+
+void InputRecording :: clear ()
+{
+	mv_run_ends.clear();
+	mv_run_inputs.clear();
+	mv_state_hashes.clear();
+
+	assert(invariant());
+}
+
+bool InputRecording :: invariant () const
+{
+	if(mv_run_ends.size() != mv_run_inputs.size()) return false;
+	if(!mv_run_ends.empty() && mv_run_ends.back() != mv_state_hashes.size()) return false;
+	return true;
+}
@@ -0,0 +1,290 @@
+//
+//  InputRecording.h
+//
+//  A module to record the player input for a game session, so
+//    the session can be replayed exactly.
+//
+
+#ifndef INPUT_RECORDING_H
+#define INPUT_RECORDING_H
+
+#include <cassert>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+
+
+//
+//  InputRecording
+//
+//  A class to record the input bitmasks (see Game::INPUT_*) for
+//    each physics frame of a game session, and a hash of the
+//    game state after each one.  Given the world data file and
+//    seeds that the session started with, a Game updated with
+//    the same input bitmasks goes through exactly the same
+//    states.  A replay can check the hashes to find the first
+//    physics frame where it differs.
+//
+//  The input rarely changes from one physics frame to the
+//    next, so the bitmasks are stored run-length encoded.  The
+//    hashes are 64-bit hashes from GameCheckpoint::calculateHash
+//    folded to 32 bits, which is still enough to notice a
+//    difference within a few physics frames.
+//
+//  A session starts with the World loaded from the world data
+//    file with the world seed (see World::init), and a Game
+//    initialized in it with the game seed (see Game::init).
+//    The Game is then updated a number of times with no input
+//    before the first recorded physics frame.  The restart
+//    input means that the Game was returned to its state at
+//    the first recorded physics frame, before the other input
+//    was handled.
+//
+//  Class Invariant:
+//    <1> mv_run_ends.size() == mv_run_inputs.size()
+//    <2> mv_run_ends.empty() ||
+//        mv_run_ends.back() == mv_state_hashes.size()
+//
+class InputRecording
+{
+public:
+	//
+	//  Default Constructor
+	//
+	//  Purpose: To create a new InputRecording with no physics
+	//           frames.
+	//  Parameter(s): N/A
+	//  Precondition(s): N/A
+	//  Returns: N/A
+	//  Side Effect: A new InputRecording is created.
+	//
+	InputRecording ();
+
+	InputRecording (const InputRecording& original) = default;
+	~InputRecording () = default;
+	InputRecording& operator= (const InputRecording& original) = default;
+
+	//
+	//  getWorldFilename
+	//
+	//  Purpose: To determine which world data file the session
+	//           was in.
+	//  Parameter(s): N/A
+	//  Precondition(s): N/A
+	//  Returns: The name of the world data file.
+	//  Side Effect: N/A
+	//
+	const std::string& getWorldFilename () const;
+
+	//
+	//  getWorldSeed
+	//
+	//  Purpose: To determine the seed the World was loaded
+	//           with.
+	//  Parameter(s): N/A
+	//  Precondition(s): N/A
+	//  Returns: The world seed.
+	//  Side Effect: N/A
+	//
+	uint64_t getWorldSeed () const;
+
+	//
+	//  getGameSeed
+	//
+	//  Purpose: To determine the seed the Game was initialized
+	//           with.
+	//  Parameter(s): N/A
+	//  Precondition(s): N/A
+	//  Returns: The game seed.
+	//  Side Effect: N/A
+	//
+	uint64_t getGameSeed () const;
+
+	//
+	//  getWarmUpCount
+	//
+	//  Purpose: To determine how many times the Game was
+	//           updated before the first recorded physics
+	//           frame.
+	//  Parameter(s): N/A
+	//  Precondition(s): N/A
+	//  Returns: The number of updates with no input.
+	//  Side Effect: N/A
+	//
+	unsigned int getWarmUpCount () const;
+
+	//
+	//  getTickCount
+	//
+	//  Purpose: To determine how many physics frames have been
+	//           recorded.
+	//  Parameter(s): N/A
+	//  Precondition(s): N/A
+	//  Returns: The number of physics frames.
+	//  Side Effect: N/A
+	//
+	unsigned int getTickCount () const;
+
+	//
+	//  getRunCount
+	//
+	//  Purpose: To determine how many runs of the same input
+	//           have been recorded.
+	//  Parameter(s): N/A
+	//  Precondition(s): N/A
+	//  Returns: The number of runs.
+	//  Side Effect: N/A
+	//
+	unsigned int getRunCount () const;
+
+	//
+	//  getInput
+	//
+	//  Purpose: To determine the input for the specified
+	//           physics frame.
+	//  Parameter(s):
+	//    <1> tick: Which physics frame
+	//  Precondition(s):
+	//    <1> tick < getTickCount()
+	//  Returns: The input bitmask for physics frame tick.
+	//  Side Effect: N/A
+	//
+	unsigned int getInput (unsigned int tick) const;
+
+	//
+	//  isStateHashMatching
+	//
+	//  Purpose: To determine whether the specified game state
+	//           hash matches the one recorded for the specified
+	//           physics frame.
+	//  Parameter(s):
+	//    <1> tick: Which physics frame
+	//    <2> state_hash: The hash of the game state after
+	//                    physics frame tick
+	//  Precondition(s):
+	//    <1> tick < getTickCount()
+	//  Returns: Whether the shortened form of state_hash is the
+	//           same as the one recorded.
+	//  Side Effect: N/A
+	//
+	bool isStateHashMatching (unsigned int tick,
+	                          uint64_t state_hash) const;
+
+	//
+	//  save
+	//
+	//  Purpose: To write this InputRecording to a file.
+	//  Parameter(s):
+	//    <1> filename: The name of the file to write
+	//  Precondition(s):
+	//    <1> filename != ""
+	//  Returns: Whether the file was written.
+	//  Side Effect: File filename is created or replaced.
+	//
+	bool save (const std::string& filename) const;
+
+	//
+	//  start
+	//
+	//  Purpose: To start a new recording.
+	//  Parameter(s):
+	//    <1> world_filename: The world data file
+	//    <2> world_seed: The seed the World was loaded with
+	//    <3> game_seed: The seed the Game was initialized with
+	//    <4> warm_up_count: The number of times the Game was
+	//                       updated before recording starts
+	//  Precondition(s):
+	//    <1> world_filename != ""
+	//  Returns: N/A
+	//  Side Effect: Any physics frames recorded before are
+	//               removed and the session information is set.
+	//
+	void start (const std::string& world_filename,
+	            uint64_t world_seed,
+	            uint64_t game_seed,
+	            unsigned int warm_up_count);
+
+	//
+	//  addTick
+	//
+	//  Purpose: To record a physics frame.
+	//  Parameter(s):
+	//    <1> input: The input bitmask used for the physics
+	//               frame
+	//    <2> state_hash: The hash of the game state after it
+	//  Precondition(s):
+	//    <1> input <= UINT8_MAX
+	//  Returns: N/A
+	//  Side Effect: The physics frame is added at the end.
+	//
+	void addTick (unsigned int input,
+	              uint64_t state_hash);
+
+	//
+	//  load
+	//
+	//  Purpose: To read an InputRecording from a file.
+	//  Parameter(s):
+	//    <1> filename: The name of the file to read
+	//  Precondition(s):
+	//    <1> filename != ""
+	//  Returns: Whether the file was read.
+	//  Side Effect: This InputRecording is set to the one in
+	//               file filename.  If the file cannot be read,
+	//               an error message is printed and this
+	//               InputRecording is left with no physics
+	//               frames.
+	//
+	bool load (const std::string& filename);
+
+private:
+	//
+	//  Helper Function: shortenHash
+	//
+	//  Purpose: To shorten the specified hash to 32 bits.
+	//  Parameter(s):
+	//    <1> hash: The hash
+	//  Precondition(s): N/A
+	//  Returns: A 32-bit hash depending on every bit of hash.
+	//  Side Effect: N/A
+	//
+	static uint32_t shortenHash (uint64_t hash);
+
+	//
+	//  Helper Function: clear
+	//
+	//  Purpose: To remove all recorded physics frames.
+	//  Parameter(s): N/A
+	//  Precondition(s): N/A
+	//  Returns: N/A
+	//  Side Effect: This InputRecording has no physics frames.
+	//
+	void clear ();
+
+	//
+	//  Helper Function: invariant
+	//
+	//  Purpose: To determine if the class invariant is true.
+	//  Parameter(s): N/A
+	//  Precondition(s): N/A
+	//  Returns: Whether the class invariant is true.
+	//  Side Effect: N/A
+	//
+	bool invariant () const;
+
+private:
+	std::string m_world_filename;
+	uint64_t m_world_seed;
+	uint64_t m_game_seed;
+	unsigned int m_warm_up_count;
+
+	// mv_run_ends[r] is the physics frame after the end of run r
+	std::vector<uint32_t> mv_run_ends;
+	std::vector<uint8_t> mv_run_inputs;
+	std::vector<uint32_t> mv_state_hashes;
+};
+
+
+
+#endif
@@ -0,0 +1,97 @@
+//
+//  LodModel.cpp
+//
+
+#include <cassert>
+#include <vector>
+
+#include "ObjLibrary/Vector3.h"
+#include "ObjLibrary/DisplayList.h"
+
+#include "LodView.h"
+#include "LodModel.h"
+
+using namespace std;
+using namespace ObjLibrary;
+
+
+
+LodModel :: LodModel ()
+		: mv_levels()
+{
+	assert(invariant());
+}
+
+
+
+bool LodModel :: isReady () const
+{
+	return !mv_levels.empty();
+}
+
+unsigned int LodModel :: getLevelCount () const
+{
+	return mv_levels.size();
+}
+
+const DisplayList& LodModel :: getDisplayList (unsigned int level) const
+{
+	assert(level < getLevelCount());
+
+	return mv_levels[level].m_list;
+}
+
+unsigned int LodModel :: getVertexCount (unsigned int level) const
+{
+	assert(level < getLevelCount());
+
+	return mv_levels[level].m_vertex_count;
+}
+
+float LodModel :: getError (unsigned int level) const
+{
+	assert(level < getLevelCount());
+
+	return mv_levels[level].m_error;
+}
+
+unsigned int LodModel :: chooseLevel (const LodView& view,
+                                      const Vector3& center,
+                                      float radius) const
+{
+	assert(isReady());
+	assert(radius >= 0.0f);
+
+	unsigned int level = 0;
+	while(level + 1 < getLevelCount() &&
+	      view.isErrorHidden(center, radius, mv_levels[level + 1].m_error))
+	{
+		level++;
+	}
+	return level;
+}
+
+void LodModel :: addLevel (const DisplayList& list,
+                           unsigned int vertex_count,
+                           float error)
+{
+	assert(list.isReady());
+	assert(error >= 0.0f);
+	assert(isReady() || error == 0.0f);
+
+	Level level;
+	level.m_list         = list;
+	level.m_vertex_count = vertex_count;
+	level.m_error        = error;
+	mv_levels.push_back(level);
+
+	assert(invariant());
+}
+
+
+
+bool LodModel :: invariant () const
+{
+	if(!mv_levels.empty() && mv_levels[0].m_error != 0.0f) return false;
+	return true;
+}
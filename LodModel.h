@@ -0,0 +1,195 @@
+//
+//  LodModel.h
+//
+//  A module to represent a model with several levels of
+//    detail.
+//
+
+#ifndef LOD_MODEL_H
+#define LOD_MODEL_H
+
+#include <cassert>
+#include <vector>
+
+#include "ObjLibrary/Vector3.h"
+#include "ObjLibrary/DisplayList.h"
+
+class LodView;
+
+
+
+//
+//  LodModel
+//
+//  A class to represent a model that has been added to OpenGL
+//    as one display list for each level of detail.  Level 0 is
+//    the full model and each later level is simpler.  The
+//    error for each level is the estimated greatest distance
+//    its surface is from the full model, and is used to choose
+//    the simplest level that looks the same on the screen.
+//
+//  A model that could not be simplified has only level 0.
+//
+//  Class Invariant:
+//    <1> mv_levels.empty() || mv_levels[0].m_error == 0.0f
+//
+class LodModel
+{
+public:
+	//
+	//  Default Constructor
+	//
+	//  Purpose: To create a new LodModel with no levels.
+	//  Parameter(s): N/A
+	//  Precondition(s): N/A
+	//  Returns: N/A
+	//  Side Effect: A new LodModel is created.
+	//
+	LodModel ();
+
+	LodModel (const LodModel& original) = default;
+	~LodModel () = default;
+	LodModel& operator= (const LodModel& original) = default;
+
+	//
+	//  isReady
+	//
+	//  Purpose: To determine whether this LodModel can be
+	//           drawn.
+	//  Parameter(s): N/A
+	//  Precondition(s): N/A
+	//  Returns: Whether this LodModel has at least one level.
+	//  Side Effect: N/A
+	//
+	bool isReady () const;
+
+	//
+	//  getLevelCount
+	//
+	//  Purpose: To determine the number of levels of detail in
+	//           this LodModel.
+	//  Parameter(s): N/A
+	//  Precondition(s): N/A
+	//  Returns: The number of levels.
+	//  Side Effect: N/A
+	//
+	unsigned int getLevelCount () const;
+
+	//
+	//  getDisplayList
+	//
+	//  Purpose: To retrieve the display list for the specified
+	//           level of detail.
+	//  Parameter(s):
+	//    <1> level: The level of detail
+	//  Precondition(s):
+	//    <1> level < getLevelCount()
+	//  Returns: The display list for level.
+	//  Side Effect: N/A
+	//
+	const ObjLibrary::DisplayList& getDisplayList (
+	                                    unsigned int level) const;
+
+	//
+	//  getVertexCount
+	//
+	//  Purpose: To determine the number of triangle vertexes
+	//           drawn for the specified level of detail.
+	//  Parameter(s):
+	//    <1> level: The level of detail
+	//  Precondition(s):
+	//    <1> level < getLevelCount()
+	//  Returns: The number of vertexes sent to the graphics
+	//           card to draw level.
+	//  Side Effect: N/A
+	//
+	unsigned int getVertexCount (unsigned int level) const;
+
+	//
+	//  getError
+	//
+	//  Purpose: To determine how far the specified level of
+	//           detail is from the full model.
+	//  Parameter(s):
+	//    <1> level: The level of detail
+	//  Precondition(s):
+	//    <1> level < getLevelCount()
+	//  Returns: The estimated error for level, in model
+	//           coordinates.
+	//  Side Effect: N/A
+	//
+	float getError (unsigned int level) const;
+
+	//
+	//  chooseLevel
+	//
+	//  Purpose: To choose the level of detail to draw this
+	//           LodModel at.
+	//  Parameter(s):
+	//    <1> view: The camera information
+	//    <2> center: The center of the model in world
+	//                coordinates
+	//    <3> radius: The radius of a sphere enclosing the model
+	//  Precondition(s):
+	//    <1> isReady()
+	//    <2> radius >= 0.0f
+	//  Returns: The simplest level of detail whose error would
+	//           not be visible.
+	//  Side Effect: N/A
+	//
+	unsigned int chooseLevel (const LodView& view,
+	                          const ObjLibrary::Vector3& center,
+	                          float radius) const;
+
+	//
+	//  addLevel
+	//
+	//  Purpose: To add a level of detail to this LodModel.
+	//  Parameter(s):
+	//    <1> list: The display list for the level
+	//    <2> vertex_count: The number of triangle vertexes the
+	//                      display list draws
+	//    <3> error: The estimated error for the level
+	//  Precondition(s):
+	//    <1> list.isReady()
+	//    <2> error >= 0.0f
+	//    <3> isReady() || error == 0.0f
+	//  Returns: N/A
+	//  Side Effect: The level is added after any existing
+	//               levels.
+	//
+	void addLevel (const ObjLibrary::DisplayList& list,
+	               unsigned int vertex_count,
+	               float error);
+
+private:
+	//
+	//  Level
+	//
+	//  A record of one level of detail.
+	//
+	struct Level
+	{
+		ObjLibrary::DisplayList m_list;
+		unsigned int m_vertex_count;
+		float m_error;
+	};
+
+	//
+	//  Helper Function: invariant
+	//
+	//  Purpose: To determine if the class invariant is true.
+	//  Parameter(s): N/A
+	//  Precondition(s): N/A
+	//  Returns: Whether the class invariant is true.
+	//  Side Effect: N/A
+	//
+	bool invariant () const;
+
+private:
+	std::vector<Level> mv_levels;
+};
+
+
+
+#endif
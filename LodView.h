@@ -0,0 +1,202 @@
+//
+//  LodView.h
+//
+//  A module to represent the information about the camera
+//    needed to choose a level of detail.
+//
+
+#ifndef LOD_VIEW_H
+#define LOD_VIEW_H
+
+#include <cassert>
+#include <cmath>
+
+#include "ObjLibrary/Vector3.h"
+
+#include "Pi.h"
+
+
+
+//
+//  LodView
+//
+//  A class to represent the camera position and projection
+//    scale used to estimate how large an object will appear on
+//    the screen.
+//
+//  The pixel scale is the number of pixels covered by an object
+//    1 unit across at a distance of 1 unit from the camera.  For
+//    a perspective projection with a vertical field of view of
+//    fovy and a viewport h pixels high, this is
+//    h / (2 * tan(fovy / 2)).
+//
+//  Class Invariant:
+//    <1> m_pixel_scale > 0.0f
+//
+class LodView
+{
+public:
+	//
+	//  DISTANCE_MIN
+	//
+	//  The minimum distance used when calculating the projected
+	//    size of an object.  This avoids dividing by zero when
+	//    the camera is inside an object.
+	//
+	static constexpr float DISTANCE_MIN = 0.01f;
+
+	//
+	//  ERROR_PIXELS_MAX
+	//
+	//  The largest error, in pixels, that a simplified model
+	//    may show on the screen.
+	//
+	static constexpr float ERROR_PIXELS_MAX = 1.0f;
+
+	//
+	//  Class Function: calculatePixelScale
+	//
+	//  Purpose: To calculate the pixel scale for the specified
+	//           perspective projection.
+	//  Parameter(s):
+	//    <1> field_of_view_y_degrees: The vertical field of
+	//                                 view in degrees
+	//    <2> viewport_height: The viewport height in pixels
+	//  Precondition(s):
+	//    <1> field_of_view_y_degrees > 0.0
+	//    <2> field_of_view_y_degrees < 180.0
+	//    <3> viewport_height > 0
+	//  Returns: The pixel scale.
+	//  Side Effect: N/A
+	//
+	static float calculatePixelScale (double field_of_view_y_degrees,
+	                                  int viewport_height)
+	{
+		assert(field_of_view_y_degrees > 0.0);
+		assert(field_of_view_y_degrees < 180.0);
+		assert(viewport_height > 0);
+
+		double half_radians = degreesToRadians(field_of_view_y_degrees * 0.5);
+		return (float)(viewport_height / (2.0 * tan(half_radians)));
+	}
+
+public:
+	//
+	//  Constructor
+	//
+	//  Purpose: To create a new LodView with the specified
+	//           camera position and pixel scale.
+	//  Parameter(s):
+	//    <1> camera_position: The camera position
+	//    <2> pixel_scale: The pixel scale
+	//  Precondition(s):
+	//    <1> pixel_scale > 0.0f
+	//  Returns: N/A
+	//  Side Effect: A new LodView is created.
+	//
+	LodView (const ObjLibrary::Vector3& camera_position,
+	         float pixel_scale)
+			: m_camera_position(camera_position)
+			, m_pixel_scale(pixel_scale)
+	{
+		assert(pixel_scale > 0.0f);
+	}
+
+	LodView (const LodView& original) = default;
+	~LodView () = default;
+	LodView& operator= (const LodView& original) = default;
+
+	//
+	//  getCameraPosition
+	//
+	//  Purpose: To determine the camera position.
+	//  Parameter(s): N/A
+	//  Precondition(s): N/A
+	//  Returns: The camera position.
+	//  Side Effect: N/A
+	//
+	const ObjLibrary::Vector3& getCameraPosition () const
+	{
+		return m_camera_position;
+	}
+
+	//
+	//  getPixelScale
+	//
+	//  Purpose: To determine the pixel scale.
+	//  Parameter(s): N/A
+	//  Precondition(s): N/A
+	//  Returns: The pixel scale.
+	//  Side Effect: N/A
+	//
+	float getPixelScale () const
+	{
+		return m_pixel_scale;
+	}
+
+	//
+	//  getProjectedSize
+	//
+	//  Purpose: To estimate how many pixels an object of the
+	//           specified size will cover on the screen.
+	//  Parameter(s):
+	//    <1> center: The center of the object
+	//    <2> radius: The radius of a sphere enclosing the
+	//                object
+	//    <3> size: The size of the object
+	//  Precondition(s):
+	//    <1> radius >= 0.0f
+	//    <2> size >= 0.0f
+	//  Returns: The number of pixels covered by size at the
+	//           nearest point of the bounding sphere.  The
+	//           direction the camera is facing is ignored.
+	//  Side Effect: N/A
+	//
+	float getProjectedSize (const ObjLibrary::Vector3& center,
+	                        float radius,
+	                        float size) const
+	{
+		assert(radius >= 0.0f);
+		assert(size >= 0.0f);
+
+		float distance = (float)(m_camera_position.getDistance(center)) - radius;
+		if(distance < DISTANCE_MIN)
+			distance = DISTANCE_MIN;
+		return size * m_pixel_scale / distance;
+	}
+
+	//
+	//  isErrorHidden
+	//
+	//  Purpose: To determine whether an error of the specified
+	//           size in an object would be too small to see.
+	//  Parameter(s):
+	//    <1> center: The center of the object
+	//    <2> radius: The radius of a sphere enclosing the
+	//                object
+	//    <3> error: The size of the error
+	//  Precondition(s):
+	//    <1> radius >= 0.0f
+	//    <2> error >= 0.0f
+	//  Returns: Whether error covers no more than
+	//           ERROR_PIXELS_MAX pixels on the screen.
+	//  Side Effect: N/A
+	//
+	bool isErrorHidden (const ObjLibrary::Vector3& center,
+	                    float radius,
+	                    float error) const
+	{
+		assert(radius >= 0.0f);
+		assert(error >= 0.0f);
+
+		return getProjectedSize(center, radius, error) <= ERROR_PIXELS_MAX;
+	}
+
+private:
+	ObjLibrary::Vector3 m_camera_position;
+	float m_pixel_scale;
+};
+
+
+
+#endif
@@ -3,17 +3,33 @@
 //
 
 #include <cassert>
+#include <cstdint>
 #include <cstdlib>
+#include <iostream>
+#include <memory>
 #include <sstream>
+#include <string>
 
 #include "GetGlut.h"
-#include "Sleep.h"
+#include "FramePacer.h"
+#include "TraceRecorder.h"
+#include "Profiler.h"
 #include "Random.h"
+#include "RandomStream.h"
 #include "ObjLibrary/Vector3.h"
 #include "ObjLibrary/SpriteFont.h"
 #include "World.h"
+#include "WorldLibrary.h"
+#include "WorldFileWatcher.h"
+#include "HeightmapCache.h"
+#include "LodView.h"
+#include "RendererGl.h"
 #include "PhysicsFrameLength.h"
+#include "GameSnapshot.h"
 #include "Game.h"
+#include "TelemetryExporter.h"
+#include "InputRecording.h"
+#include "SimulationThread.h"
 #include "Main.h"
 
 #include "Nodes.h"
@@ -29,11 +45,11 @@ namespace
 	int g_window_width  = 640;
 	int g_window_height = 480;
 
-	const unsigned int KEY_COUNT       = 260;
-	const unsigned int KEY_ARROW_LEFT  = 256;
-	const unsigned int KEY_ARROW_UP    = 257;
-	const unsigned int KEY_ARROW_RIGHT = 258;
-	const unsigned int KEY_ARROW_DOWN  = 259;
+	const unsigned int KEY_COUNT       = SimulationThread::KEY_COUNT;
+	const unsigned int KEY_ARROW_LEFT  = SimulationThread::KEY_ARROW_LEFT;
+	const unsigned int KEY_ARROW_UP    = SimulationThread::KEY_ARROW_UP;
+	const unsigned int KEY_ARROW_RIGHT = SimulationThread::KEY_ARROW_RIGHT;
+	const unsigned int KEY_ARROW_DOWN  = SimulationThread::KEY_ARROW_DOWN;
 
 	bool ga_is_pressed[KEY_COUNT];
 
@@ -41,19 +57,129 @@ namespace
 	const Vector3 OVERVIEW_LOOK_AT (  0.0,   0.0,  0.0);
 	const Vector3 OVERVIEW_UP      (  0.0,   1.0,  0.0);
 
+	//
+	//  WORLD_FILENAMES
+	//
+	//  The worlds that can be switched to with the number keys,
+	//    starting from 1.  The first one is loaded at startup.
+	//
+	const char* const WORLD_FILENAMES[] =
+	{
+		"Worlds/Small.txt",
+		"Worlds/Basic.txt",
+		"Worlds/Simple.txt",
+		"Worlds/Sparse.txt",
+		"Worlds/Dense.txt",
+		"Worlds/Twisted.txt",
+		"Worlds/Icy.txt",
+		"Worlds/Leafy.txt",
+		"Worlds/Rocky.txt",
+	};
+	const unsigned int WORLD_COUNT = sizeof(WORLD_FILENAMES) / sizeof(WORLD_FILENAMES[0]);
+
+	//
+	//  g_switch_filename
+	//  g_is_switch_reload
+	//  gp_switch_game
+	//
+	//  The world a Game is being prepared for, or "" if none,
+	//    whether it is being reloaded because its file changed,
+	//    and the Game given to the simulation thread to switch
+	//    to.  Once the switch is made, gp_switch_game holds the
+	//    old state until it is given back to g_worlds.
+	//
+	WorldLibrary g_worlds;
+	string g_switch_filename;
+	bool g_is_switch_reload = false;
+	shared_ptr<Game> gp_switch_game;
+
+	//
+	//  g_world_filename
+	//  g_world_watcher
+	//
+	//  The file for the world being played, and a watcher to
+	//    reload it when it is edited.
+	//
+	string g_world_filename;
+	WorldFileWatcher g_world_watcher;
+
+	// the simulation thread must be destroyed first, so it stops
+	//   before the game it updates is destroyed
 	Game g_game;
+	TelemetryExporter g_telemetry;
+	InputRecording g_recording;
+	SimulationThread g_simulation;
+
+	//
+	//  TELEMETRY_FILENAME
+	//
+	//  The file the live statistics are published to, for
+	//    Tools/TelemetryReader or another dashboard to watch.
+	//
+	const bool IS_TELEMETRY_EXPORTED = true;
+	const char* const TELEMETRY_FILENAME = "Telemetry.bin";
+
+	//
+	//  RECORD_ARGUMENT
+	//  RECORDING_FILENAME
+	//
+	//  The input for the session is only recorded if the program
+	//    is run with RECORD_ARGUMENT, because recording hashes
+	//    the game state every physics frame.  It is written to
+	//    RECORDING_FILENAME when the program exits, for
+	//    Tools/InputReplayer to replay.
+	//
+	const string RECORD_ARGUMENT = "--record";
+	const char* const RECORDING_FILENAME = "Recording.a5i";
+	bool g_is_input_recorded = false;
 
-	double g_start_time;
-	unsigned int g_update_count;
 	double g_last_display_time;
 	double g_display_fps;
 	const double DISPLAY_FPS_SMOOTHING_FACTOR = 0.02;
 
-	SpriteFont g_font;
-
+	//
+	//  RESIDENT_SAMPLE_INTERVAL
+	//
+	//  How often the resident memory is measured for the
+	//    telemetry, in seconds.  Measuring it makes system calls,
+	//    so it is done on the display thread and handed to the
+	//    TelemetryExporter, not on the simulation thread.
+	//
+	const double RESIDENT_SAMPLE_INTERVAL = 1.0;
+	double g_last_resident_sample_time = -RESIDENT_SAMPLE_INTERVAL;
 
-
-	const bool DEBUGGING_FRAME_RATE = false;
+	SpriteFont g_font;
+	RendererGl g_renderer;
+
+
+
+	//
+	//  DISPLAY_FRAME_LENGTH_MIN
+	//
+	//  The shortest time in seconds between displayed frames.
+	//    The display is not tied to the physics frames, so this
+	//    only stops it from using a whole processor.
+	//
+	const double DISPLAY_FRAME_LENGTH_MIN = 1.0 / 240.0;
+	FramePacer g_display_pacer(DISPLAY_FRAME_LENGTH_MIN);
+
+	const bool IS_PRINT_PACER_STATISTICS = true;
+	const bool IS_PRINT_PROFILE          = true;
+
+	//
+	//  KEY_PROFILE
+	//
+	//  The key that shows or hides the profile overlay.
+	//
+	const unsigned char KEY_PROFILE = 'p';
+	bool g_is_profile_shown = false;
+
+	//
+	//  KEY_TRACE
+	//
+	//  The key that writes out the recent trace events.
+	//
+	const unsigned char KEY_TRACE = 't';
 
 }  // end of anonymous namespace
 
@@ -61,10 +187,19 @@ namespace
 
 int main (int argc, char* argv[])
 {
+	TraceRecorder::setThreadName("Main");
+
 	glutInitWindowSize(g_window_width, g_window_height);
 	glutInitWindowPosition(0, 0);
 
 	glutInit(&argc, argv);
+	for(int a = 1; a < argc; a++)
+	{
+		if(argv[a] == RECORD_ARGUMENT)
+			g_is_input_recorded = true;
+		else
+			cerr << "Warning: Ignoring unknown argument \"" << argv[a] << "\"" << endl;
+	}
 	glutInitDisplayMode(GLUT_DOUBLE | GLUT_DEPTH | GLUT_RGB);
 	glutCreateWindow("Assignment 5");
 	glutKeyboardFunc(&keyboardDown);
@@ -78,20 +213,36 @@ int main (int argc, char* argv[])
 	seedRandom();
 	initDisplay();
 	Game::loadModels();
-	g_game.init("Worlds/Small.txt");
-	
+	// chosen here so the session can be recorded and replayed
+	uint64_t world_seed = RandomStream::createSeed();
+	uint64_t game_seed  = RandomStream::createSeed();
+	g_worlds.setSeed(world_seed);
+
+	g_world_filename = WORLD_FILENAMES[0];
+	shared_ptr<World> p_world = g_worlds.load(g_world_filename);
+	if(p_world == nullptr)
+		exit(1);
+	g_game.init(p_world, game_seed);
+	g_world_watcher.watch(g_world_filename);
 
 	g_font.load("FontTimesNewRoman16.bmp");
 
 	// one update now, because first frame is always slow
 	g_game.update();
 
-	g_start_time        = glutGet(GLUT_ELAPSED_TIME) * 0.001;
-	g_update_count      = 0;
-	g_last_display_time = g_start_time;
+	g_display_pacer.reset();
+	g_last_display_time = g_display_pacer.getElapsedTime();
 	assert(PHYSICS_FRAME_LENGTH > 0.0);
 	g_display_fps       = 1.0 / PHYSICS_FRAME_LENGTH;
 
+	if(IS_TELEMETRY_EXPORTED && g_telemetry.open(TELEMETRY_FILENAME))
+		g_simulation.setTelemetryExporter(&g_telemetry);
+	if(g_is_input_recorded)
+	{
+		g_recording.start(g_world_filename, world_seed, game_seed, 1);
+		g_simulation.setInputRecording(&g_recording);
+	}
+	g_simulation.start(g_game);
 	glutMainLoop();
 
 	return 1;
@@ -116,13 +267,39 @@ void keyboardDown (unsigned char key, int x, int y)
 {
 	if(key >= 'A' && key <= 'Z')
 		key = key - 'A' + 'a';
-	ga_is_pressed[key] = true;
+	bool is_repeat = ga_is_pressed[key];
+	setKeyPressed(key, true);
 
 	switch (key)
 	{
 	case 27: // on [ESC]
+		g_simulation.stop();
+		if(g_is_input_recorded && g_recording.getTickCount() > 0)
+			g_recording.save(RECORDING_FILENAME);
+		if(IS_PRINT_PACER_STATISTICS)
+		{
+			cout << "Physics frame timing:" << endl;
+			g_simulation.getPacer().printStatistics(cout);
+		}
+		if(IS_PRINT_PROFILE && Profiler::IS_ENABLED)
+		{
+			cout << "Profile:" << endl;
+			Profiler::printSummaries(cout);
+		}
 		exit(0); // normal exit
 		break;
+	case KEY_PROFILE:
+		if(!is_repeat)
+			g_is_profile_shown = !g_is_profile_shown;
+		break;
+	case KEY_TRACE:
+		if(!is_repeat)
+			TraceRecorder::dump("requested from keyboard");
+		break;
+	default:
+		if(key >= '1' && key < '1' + WORLD_COUNT && !is_repeat)
+			requestWorld(WORLD_FILENAMES[key - '1']);
+		break;
 	}
 }
 
@@ -130,7 +307,7 @@ void keyboardUp (unsigned char key, int x, int y)
 {
 	if(key >= 'A' && key <= 'Z')
 		key = key - 'A' + 'a';
-	ga_is_pressed[key] = false;
+	setKeyPressed(key, false);
 }
 
 void specialDown (int special_key, int x, int y)
@@ -138,16 +315,16 @@ void specialDown (int special_key, int x, int y)
 	switch(special_key)
 	{
 	case GLUT_KEY_LEFT:
-		ga_is_pressed[KEY_ARROW_LEFT]  = true;
+		setKeyPressed(KEY_ARROW_LEFT,  true);
 		break;
 	case GLUT_KEY_RIGHT:
-		ga_is_pressed[KEY_ARROW_RIGHT] = true;
+		setKeyPressed(KEY_ARROW_RIGHT, true);
 		break;
 	case GLUT_KEY_UP:
-		ga_is_pressed[KEY_ARROW_UP]    = true;
+		setKeyPressed(KEY_ARROW_UP,    true);
 		break;
 	case GLUT_KEY_DOWN:
-		ga_is_pressed[KEY_ARROW_DOWN]  = true;
+		setKeyPressed(KEY_ARROW_DOWN,  true);
 		break;
 	}
 }
@@ -157,79 +334,87 @@ void specialUp (int special_key, int x, int y)
 	switch(special_key)
 	{
 	case GLUT_KEY_LEFT:
-		ga_is_pressed[KEY_ARROW_LEFT]  = false;
+		setKeyPressed(KEY_ARROW_LEFT,  false);
 		break;
 	case GLUT_KEY_RIGHT:
-		ga_is_pressed[KEY_ARROW_RIGHT] = false;
+		setKeyPressed(KEY_ARROW_RIGHT, false);
 		break;
 	case GLUT_KEY_UP:
-		ga_is_pressed[KEY_ARROW_UP]    = false;
+		setKeyPressed(KEY_ARROW_UP,    false);
 		break;
 	case GLUT_KEY_DOWN:
-		ga_is_pressed[KEY_ARROW_DOWN]  = false;
+		setKeyPressed(KEY_ARROW_DOWN,  false);
 		break;
 	}
 }
 
+void setKeyPressed (unsigned int key, bool is_pressed)
+{
+	assert(key < KEY_COUNT);
+
+	// key repeat sends the same press again
+	if(ga_is_pressed[key] == is_pressed)
+		return;
+
+	// if the queue is full, try again on the next key repeat
+	if(g_simulation.setKeyPressed(key, is_pressed))
+		ga_is_pressed[key] = is_pressed;
+}
+
 
 
 void update ()
 {
-	double current_time    = glutGet(GLUT_ELAPSED_TIME) * 0.001;
-	double next_frame_time = g_start_time + g_update_count * PHYSICS_FRAME_LENGTH;
-	if(next_frame_time > current_time)
-	{
-		double sleep_time = next_frame_time - current_time;
-		if(sleep_time > 0.0f)
-			sleep(sleep_time);
-		current_time = glutGet(GLUT_ELAPSED_TIME) * 0.001;
-	}
-
-	if(DEBUGGING_FRAME_RATE)
-		cout << "time = " << current_time << " / " << next_frame_time;
+	// the physics frames run on the simulation thread
+	updateWorldSwitch();
+	g_display_pacer.wait(1);
+	glutPostRedisplay();
+}
 
-	unsigned int sanity = 0;
-	while(next_frame_time <= current_time && sanity < 10)
-	{
-		if(!g_game.isGameOver())
-			handleKeyboard();
-		g_game.update();
-		g_update_count++;
+void requestWorld (const char* filename)
+{
+	assert(filename != nullptr);
 
-		current_time    = glutGet(GLUT_ELAPSED_TIME) * 0.001;
-		next_frame_time = g_start_time + g_update_count * PHYSICS_FRAME_LENGTH;
-		sanity++;
+	g_switch_filename  = filename;
+	g_is_switch_reload = false;
+	g_worlds.prepareGame(g_switch_filename);
+}
 
-		if(DEBUGGING_FRAME_RATE)
-			cout << " +";
-	}
-	if(DEBUGGING_FRAME_RATE)
-		cout << endl;
+void reloadWorld ()
+{
+	assert(g_world_filename != "");
 
-	if(sanity > 0)
-		glutPostRedisplay();
+	g_switch_filename  = g_world_filename;
+	g_is_switch_reload = true;
+	g_worlds.reloadGame(g_switch_filename);
 }
 
-void handleKeyboard ()
+void updateWorldSwitch ()
 {
-	if(ga_is_pressed[KEY_ARROW_LEFT])
-		g_game.playerTurnLeft();
-	if(ga_is_pressed[KEY_ARROW_RIGHT])
-		g_game.playerTurnRight();
-
-	if(!g_game.isPlayerJumping())
+	if(gp_switch_game != nullptr)
+	{
+		// the old state is destroyed on the loading thread
+		if(!g_simulation.isSwitchPending())
+			g_worlds.release(move(gp_switch_game));
+	}
+	else if(g_switch_filename != "")
 	{
-		if(ga_is_pressed['w'] || ga_is_pressed[KEY_ARROW_UP])
-			g_game.playerAccelerateForward();
-		if(ga_is_pressed['s'] || ga_is_pressed[KEY_ARROW_DOWN])
-			g_game.playerAccelerateBackward();
-		if(ga_is_pressed['a'])
-			g_game.playerAccelerateLeft();
-		if(ga_is_pressed['d'])
-			g_game.playerAccelerateRight();
-		if(ga_is_pressed[' '])
-			g_game.playerJump();
+		gp_switch_game = g_worlds.takePreparedGame(g_switch_filename);
+		if(gp_switch_game != nullptr)
+		{
+			g_simulation.switchGame(gp_switch_game, g_is_switch_reload);
+			if(g_switch_filename != g_world_filename)
+			{
+				g_world_filename = g_switch_filename;
+				g_world_watcher.watch(g_world_filename);
+			}
+			g_switch_filename = "";
+		}
+		else if(g_worlds.isFailed(g_switch_filename))
+			g_switch_filename = "";
 	}
+	else if(g_world_watcher.isChanged())
+		reloadWorld();
 }
 
 
@@ -254,45 +439,54 @@ void reshape (int w, int h)
 
 void display ()
 {
-	glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
-
-	glLoadIdentity();
+	shared_ptr<const GameSnapshot> p_previous;
+	shared_ptr<const GameSnapshot> p_current;
+	float fraction;
+	g_simulation.getSnapshots(p_previous, p_current, fraction);
+	GameSnapshot snapshot(*p_previous, *p_current, fraction);
 
-	bool is_overview = ga_is_pressed['o'];
-	g_game.over = is_overview;
-	if(is_overview)
+	// the swap is left out, since it may wait for the display
 	{
-		gluLookAt(OVERVIEW_POSITION.x, OVERVIEW_POSITION.y, OVERVIEW_POSITION.z,
-		          OVERVIEW_LOOK_AT .x, OVERVIEW_LOOK_AT .y, OVERVIEW_LOOK_AT .z,
-		          OVERVIEW_UP      .x, OVERVIEW_UP      .y, OVERVIEW_UP      .z);
+		PROFILE_SCOPE(SECTION_DISPLAY);
+		g_renderer.beginFrame();
 
+		bool is_overview = ga_is_pressed[SimulationThread::KEY_OVERVIEW];
+		Vector3 camera_position = OVERVIEW_POSITION;
+		if(is_overview)
+		{
+			g_renderer.lookAt(OVERVIEW_POSITION, OVERVIEW_LOOK_AT, OVERVIEW_UP);
+		}
+		else
+		{
+			g_game.setupCamera(g_renderer, snapshot);
+			g_game.drawSkybox(g_renderer, snapshot);  // must be drawn first
+			camera_position = g_game.getCameraPosition(snapshot);
+		}
 
-	}
-	else
-	{
-		g_game.setupCamera();
-		g_game.drawSkybox();  // must be drawn first
-	}
-
-	g_game.draw();
-
-	
+		int viewport_height = (g_window_height > 0) ? g_window_height : 1;
+		g_game.draw(g_renderer, LodView(camera_position, LodView::calculatePixelScale(FIELD_OF_VIEW_Y, viewport_height)), snapshot);
 
-	if(!is_overview)
-		drawOverlays();  // must be drawn last
+		drawOverlays(snapshot);  // must be drawn last
 
+		g_renderer.endFrame();
+	}
+	PROFILE_END_FRAME(TIMELINE_DISPLAY);
 	glutSwapBuffers();
 }
 
-void drawOverlays ()
+void drawOverlays (const GameSnapshot& snapshot)
 {
-	double current_time = glutGet(GLUT_ELAPSED_TIME) * 0.001;
+	PROFILE_SCOPE(SECTION_TEXT);
+
+	double current_time = g_display_pacer.getElapsedTime();
 
 	stringstream score_ss;
-	score_ss << "Score: " << g_game.getScore();
+	score_ss << "Score: " << snapshot.getScore();
 
-	double elapsed_time = current_time - g_start_time;
-	int    update_rate  = (int)(g_update_count / elapsed_time + 0.5);
+	double elapsed_time = g_simulation.getElapsedTime();
+	int    update_rate  = 0;
+	if(elapsed_time > 0.0)
+		update_rate = (int)(g_simulation.getUpdateCount() / elapsed_time + 0.5);
 	stringstream update_rate_ss;
 	update_rate_ss << "Updates: " << update_rate << " / s";
 
@@ -301,22 +495,117 @@ void drawOverlays ()
 	if(display_time > 0.0)
 		current_fps = (int)(1.0 / display_time);
 	g_display_fps += (current_fps - g_display_fps) * DISPLAY_FPS_SMOOTHING_FACTOR;
+	g_telemetry.setDisplayRate(g_display_fps);
+	if(g_telemetry.isOpen() && current_time - g_last_resident_sample_time >= RESIDENT_SAMPLE_INTERVAL)
+	{
+		g_telemetry.setResidentBytes(TelemetryExporter::getResidentBytes());
+		g_last_resident_sample_time = current_time;
+	}
 	stringstream display_rate_ss;
 	display_rate_ss << "Display: " << (int)(g_display_fps + 0.5) << " / s";
 
-	SpriteFont::setUp2dView(g_window_width, g_window_height);
-		g_font.draw(score_ss       .str(), g_window_width - 160, 16);
-		g_font.draw(update_rate_ss .str(), g_window_width - 160, 40);
-		g_font.draw(display_rate_ss.str(), g_window_width - 160, 64);
-
-		if(g_game.isGameOver())
+	stringstream terrain_ss;
+	terrain_ss << "Terrain: " << g_game.getTerrainTriangleCountDrawn()
+	           << " / " << g_game.getTerrainTriangleCountFull() << " tris";
+
+	stringstream heightmaps_ss;
+	heightmaps_ss << "Heightmaps: " << HeightmapCache::getResidentCount()
+	              << " (" << HeightmapCache::getMemoryUsed() / (1024 * 1024) << " MB)";
+
+	stringstream worlds_ss;
+	worlds_ss << "Worlds: " << g_worlds.getResidentCount()
+	          << " (" << g_worlds.getMemoryUsed() / (1024 * 1024) << " MB)";
+	if(g_switch_filename != "")
+		worlds_ss << ", loading " << (int)(g_worlds.getProgress(g_switch_filename) * 100.0f + 0.5f) << "%";
+
+	FramePacer::Statistics pacer_statistics = g_simulation.getPacer().getStatistics();
+	stringstream jitter_ss;
+	jitter_ss << "Jitter: " << (int)(pacer_statistics.m_jitter_rms * 1.0e6 + 0.5) << " us";
+
+	g_renderer.begin2dView(g_window_width, g_window_height);
+		g_renderer.drawText(g_font, score_ss       .str(), g_window_width - 160, 16);
+		g_renderer.drawText(g_font, update_rate_ss .str(), g_window_width - 160, 40);
+		g_renderer.drawText(g_font, display_rate_ss.str(), g_window_width - 160, 64);
+		g_renderer.drawText(g_font, terrain_ss     .str(), g_window_width - 240, 88);
+		g_renderer.drawText(g_font, jitter_ss      .str(), g_window_width - 160, 112);
+		g_renderer.drawText(g_font, heightmaps_ss  .str(), g_window_width - 240, 136);
+		g_renderer.drawText(g_font, worlds_ss      .str(), g_window_width - 240, 160);
+
+		if(snapshot.isGameOver())
 		{
 			static const string GAME_OVER_TEXT = "Game Over";
 			float game_over_x = g_window_width  * 0.5f  - g_font.getWidth(GAME_OVER_TEXT) * 0.5f;
 			float game_over_y = g_window_height * 0.22f - g_font.getHeight()              * 0.5f;
-			g_font.draw(GAME_OVER_TEXT, game_over_x, game_over_y);
+			g_renderer.drawText(g_font, GAME_OVER_TEXT, game_over_x, game_over_y);
+
+			static const string RESTART_TEXT = "Press R to restart";
+			float restart_x = g_window_width * 0.5f - g_font.getWidth(RESTART_TEXT) * 0.5f;
+			float restart_y = game_over_y + g_font.getHeight() * 1.5f;
+			g_renderer.drawText(g_font, RESTART_TEXT, restart_x, restart_y);
 		}
-	SpriteFont::unsetUp2dView();
+
+		if(g_is_profile_shown)
+			drawProfile();
+	g_renderer.end2dView();
 
 	g_last_display_time = current_time;
 }
+
+void drawProfile ()
+{
+	static const int LINE_HEIGHT = 20;
+	static const int NAME_X      = 16;
+	static const int MEDIAN_X    = 150;
+	static const int HIGH_X      = 210;
+	static const int MAX_X       = 270;
+
+	if(!Profiler::IS_ENABLED)
+	{
+		g_renderer.drawText(g_font, "Profiler disabled", NAME_X, 16);
+		return;
+	}
+
+	int y = 16;
+	g_renderer.drawText(g_font, "Time (us)", NAME_X,   y);
+	g_renderer.drawText(g_font, "p50",       MEDIAN_X, y);
+	g_renderer.drawText(g_font, "p95",       HIGH_X,   y);
+	g_renderer.drawText(g_font, "max",       MAX_X,    y);
+	y += LINE_HEIGHT;
+
+	for(unsigned int i = 0; i <= Profiler::SECTION_COUNT + Profiler::COUNTER_COUNT; i++)
+	{
+		Profiler::Summary summary;
+		string name;
+		if(i < Profiler::SECTION_COUNT)
+		{
+			summary = Profiler::getSectionSummary((Profiler::Section)(i));
+			name    = string(Profiler::getSectionDepth((Profiler::Section)(i)) * 2, ' ') +
+			          Profiler::getSectionName((Profiler::Section)(i));
+		}
+		else if(i == Profiler::SECTION_COUNT)
+		{
+			g_renderer.drawText(g_font, "Per update", NAME_X, y);
+			y += LINE_HEIGHT;
+			continue;
+		}
+		else
+		{
+			Profiler::Counter counter = (Profiler::Counter)(i - Profiler::SECTION_COUNT - 1);
+			summary = Profiler::getCounterSummary(counter);
+			name    = Profiler::getCounterName(counter);
+		}
+
+		stringstream median_ss;
+		stringstream high_ss;
+		stringstream max_ss;
+		median_ss << (int)(summary.m_median       + 0.5f);
+		high_ss   << (int)(summary.m_percentile95 + 0.5f);
+		max_ss    << (int)(summary.m_max          + 0.5f);
+
+		g_renderer.drawText(g_font, name,           NAME_X,   y);
+		g_renderer.drawText(g_font, median_ss.str(), MEDIAN_X, y);
+		g_renderer.drawText(g_font, high_ss  .str(), HIGH_X,   y);
+		g_renderer.drawText(g_font, max_ss   .str(), MAX_X,    y);
+		y += LINE_HEIGHT;
+	}
+}
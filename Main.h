@@ -6,6 +6,8 @@
 #define MAIN_H
 #include "overview.h"
 
+class GameSnapshot;
+
 
 int main (int argc, char* argv[]);
 void initDisplay ();
@@ -14,13 +16,17 @@ void keyboardDown (unsigned char key, int x, int y);
 void keyboardUp (unsigned char key, int x, int y);
 void specialDown (int special_key, int x, int y);
 void specialUp (int special_key, int x, int y);
+void setKeyPressed (unsigned int key, bool is_pressed);
 
 void update ();
-void handleKeyboard ();
+void requestWorld (const char* filename);
+void reloadWorld ();
+void updateWorldSwitch ();
 
 void reshape (int w, int h);
 void display ();
-void drawOverlays ();
+void drawOverlays (const GameSnapshot& snapshot);
+void drawProfile ();
 
 
 
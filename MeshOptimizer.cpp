@@ -0,0 +1,268 @@
+//
+//  MeshOptimizer.cpp
+//
+
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+#include <vector>
+
+#include "MeshOptimizer.h"
+
+using namespace std;
+namespace
+{
+	//
+	//  The scoring constants from Tom Forsyth, "Linear-Speed
+	//    Vertex Cache Optimisation", 2006.  The cache used for
+	//    scoring is LRU rather than FIFO, as in the original.
+	//
+	const float CACHE_DECAY_POWER   = 1.5f;
+	const float LAST_TRIANGLE_SCORE = 0.75f;
+	const float VALENCE_BOOST_SCALE = 2.0f;
+	const float VALENCE_BOOST_POWER = 0.5f;
+
+	const int NOT_IN_CACHE = -1;
+	const unsigned int NO_TRIANGLE = ~0u;
+
+	//
+	//  calculateVertexScore
+	//
+	//  Purpose: To calculate how much adding a triangle that uses
+	//           a vertex would help the vertex cache.
+	//  Parameter(s):
+	//    <1> cache_position: The position of the vertex in the
+	//                        LRU cache, or NOT_IN_CACHE
+	//    <2> remaining_count: The number of triangles using the
+	//                         vertex that have not been added
+	//  Precondition(s):
+	//    <1> cache_position == NOT_IN_CACHE ||
+	//        (cache_position >= 0 &&
+	//         cache_position < MeshOptimizer::CACHE_SIZE)
+	//  Returns: The score for the vertex.  Vertexes at the front
+	//           of the cache and vertexes with few remaining
+	//           triangles score higher.  A vertex with no
+	//           remaining triangles scores -1.0f.
+	//  Side Effect: N/A
+	//
+	float calculateVertexScore (int cache_position,
+	                            unsigned int remaining_count)
+	{
+		assert(cache_position == NOT_IN_CACHE ||
+		       (cache_position >= 0 && cache_position < (int)(MeshOptimizer::CACHE_SIZE)));
+
+		if(remaining_count == 0)
+			return -1.0f;
+
+		float score = 0.0f;
+		if(cache_position < 0)
+			;  // not in cache
+		else if(cache_position < 3)
+		{
+			// the last triangle added gets a fixed score so
+			//   it does not matter which of its vertexes is used
+			score = LAST_TRIANGLE_SCORE;
+		}
+		else
+		{
+			const float SCALER = 1.0f / (MeshOptimizer::CACHE_SIZE - 3);
+			score = 1.0f - (cache_position - 3) * SCALER;
+			score = powf(score, CACHE_DECAY_POWER);
+		}
+
+		// bonus for vertexes with few triangles left, so none are stranded
+		score += VALENCE_BOOST_SCALE * powf((float)(remaining_count), -VALENCE_BOOST_POWER);
+		return score;
+	}
+
+}  // end of anonymous namespace
+
+
+
+float MeshOptimizer :: calculateAcmr (const unsigned int* a_indexes,
+                                      unsigned int index_count,
+                                      unsigned int vertex_count)
+{
+	assert(a_indexes != NULL || index_count == 0);
+	assert(index_count % 3 == 0);
+
+	if(index_count == 0)
+		return 0.0f;
+
+	// each vertex remembers when it entered the FIFO
+	vector<unsigned int> v_entered(vertex_count, 0);
+	unsigned int miss_count = 0;
+	for(unsigned int i = 0; i < index_count; i++)
+	{
+		unsigned int vertex = a_indexes[i];
+		assert(vertex < vertex_count);
+
+		if(v_entered[vertex] == 0 || miss_count + 1 - v_entered[vertex] > CACHE_SIZE)
+		{
+			miss_count++;
+			v_entered[vertex] = miss_count;
+		}
+	}
+	return (float)(miss_count) / (index_count / 3);
+}
+
+void MeshOptimizer :: optimizeTriangleOrder (unsigned int* a_indexes,
+                                             unsigned int index_count,
+                                             unsigned int vertex_count)
+{
+	assert(a_indexes != NULL || index_count == 0);
+	assert(index_count % 3 == 0);
+
+	unsigned int triangle_count = index_count / 3;
+	if(triangle_count <= 1)
+		return;
+
+	//
+	//  The triangles using each vertex are stored in one
+	//    array, with the triangles for vertex v starting at
+	//    v_first[v].  The first v_remaining[v] of them have not
+	//    been added yet.
+	//
+
+	vector<unsigned int> v_remaining(vertex_count, 0);
+	for(unsigned int i = 0; i < index_count; i++)
+	{
+		assert(a_indexes[i] < vertex_count);
+		v_remaining[a_indexes[i]]++;
+	}
+
+	vector<unsigned int> v_first(vertex_count + 1, 0);
+	for(unsigned int v = 0; v < vertex_count; v++)
+		v_first[v + 1] = v_first[v] + v_remaining[v];
+
+	vector<unsigned int> v_triangles(index_count);
+	vector<unsigned int> v_filled(v_first.begin(), v_first.end() - 1);
+	for(unsigned int i = 0; i < index_count; i++)
+		v_triangles[v_filled[a_indexes[i]]++] = i / 3;
+
+	vector<int>   v_cache_position(vertex_count, NOT_IN_CACHE);
+	vector<float> v_vertex_score(vertex_count);
+	for(unsigned int v = 0; v < vertex_count; v++)
+		v_vertex_score[v] = calculateVertexScore(NOT_IN_CACHE, v_remaining[v]);
+
+	vector<float> v_triangle_score(triangle_count);
+	vector<bool>  v_is_added(triangle_count, false);
+	unsigned int best = 0;
+	for(unsigned int t = 0; t < triangle_count; t++)
+	{
+		v_triangle_score[t] = v_vertex_score[a_indexes[t * 3 + 0]] +
+		                      v_vertex_score[a_indexes[t * 3 + 1]] +
+		                      v_vertex_score[a_indexes[t * 3 + 2]];
+		if(v_triangle_score[t] > v_triangle_score[best])
+			best = t;
+	}
+
+	vector<unsigned int> v_output;
+	v_output.reserve(index_count);
+	vector<unsigned int> v_cache;
+	vector<unsigned int> v_new_cache;
+	v_cache.reserve(CACHE_SIZE + 3);
+	v_new_cache.reserve(CACHE_SIZE + 3);
+	unsigned int first_unadded = 0;
+
+	for(unsigned int added_count = 0; added_count < triangle_count; added_count++)
+	{
+		if(best == NO_TRIANGLE)
+		{
+			// nothing in the cache helps, so take the best of the rest
+			while(v_is_added[first_unadded])
+				first_unadded++;
+			best = first_unadded;
+			for(unsigned int t = first_unadded + 1; t < triangle_count; t++)
+				if(!v_is_added[t] && v_triangle_score[t] > v_triangle_score[best])
+					best = t;
+		}
+		assert(best < triangle_count);
+		assert(!v_is_added[best]);
+
+		// add the triangle
+		v_is_added[best] = true;
+		v_new_cache.clear();
+		for(unsigned int c = 0; c < 3; c++)
+		{
+			unsigned int vertex = a_indexes[best * 3 + c];
+			v_output.push_back(vertex);
+			if(find(v_new_cache.begin(), v_new_cache.end(), vertex) == v_new_cache.end())
+				v_new_cache.push_back(vertex);
+
+			// move the triangle past the end of the remaining ones
+			unsigned int* a_list = v_triangles.data() + v_first[vertex];
+			unsigned int last = v_remaining[vertex] - 1;
+			for(unsigned int i = 0; i <= last; i++)
+				if(a_list[i] == best)
+				{
+					a_list[i]    = a_list[last];
+					a_list[last] = best;
+					break;
+				}
+			v_remaining[vertex]--;
+		}
+
+		// the new triangle goes to the front of the LRU cache
+		unsigned int triangle_vertex_count = v_new_cache.size();
+		for(unsigned int i = 0; i < v_cache.size(); i++)
+		{
+			unsigned int vertex = v_cache[i];
+			if(find(v_new_cache.begin(), v_new_cache.begin() + triangle_vertex_count, vertex) == v_new_cache.begin() + triangle_vertex_count)
+				v_new_cache.push_back(vertex);
+		}
+		for(unsigned int i = 0; i < v_new_cache.size(); i++)
+		{
+			unsigned int vertex = v_new_cache[i];
+			v_cache_position[vertex] = (i < CACHE_SIZE) ? (int)(i) : NOT_IN_CACHE;
+			v_vertex_score[vertex] = calculateVertexScore(v_cache_position[vertex], v_remaining[vertex]);
+		}
+
+		// only triangles touching the cache can have changed
+		best = NO_TRIANGLE;
+		float best_score = -1.0f;
+		for(unsigned int i = 0; i < v_new_cache.size(); i++)
+		{
+			unsigned int vertex = v_new_cache[i];
+			const unsigned int* a_list = v_triangles.data() + v_first[vertex];
+			for(unsigned int j = 0; j < v_remaining[vertex]; j++)
+			{
+				unsigned int t = a_list[j];
+				v_triangle_score[t] = v_vertex_score[a_indexes[t * 3 + 0]] +
+				                      v_vertex_score[a_indexes[t * 3 + 1]] +
+				                      v_vertex_score[a_indexes[t * 3 + 2]];
+				if(i < CACHE_SIZE && v_triangle_score[t] > best_score)
+				{
+					best       = t;
+					best_score = v_triangle_score[t];
+				}
+			}
+		}
+
+		if(v_new_cache.size() > CACHE_SIZE)
+			v_new_cache.resize(CACHE_SIZE);
+		v_cache.swap(v_new_cache);
+	}
+
+	assert(v_output.size() == index_count);
+	for(unsigned int i = 0; i < index_count; i++)
+		a_indexes[i] = v_output[i];
+}
+
+vector<unsigned int> MeshOptimizer :: calculateVertexOrder (
+                                     const vector<unsigned int>& indexes,
+                                     unsigned int vertex_count)
+{
+	vector<unsigned int> v_new_index(vertex_count, NOT_USED);
+	unsigned int next = 0;
+	for(unsigned int i = 0; i < indexes.size(); i++)
+	{
+		assert(indexes[i] < vertex_count);
+		if(v_new_index[indexes[i]] == NOT_USED)
+		{
+			v_new_index[indexes[i]] = next;
+			next++;
+		}
+	}
+	return v_new_index;
+}
@@ -0,0 +1,124 @@
+//
+//  MeshOptimizer.h
+//
+//  A module to reorder indexed triangles so that the graphics
+//    card transforms fewer vertexes.
+//
+
+#ifndef MESH_OPTIMIZER_H
+#define MESH_OPTIMIZER_H
+
+#include <vector>
+
+
+
+//
+//  MeshOptimizer
+//
+//  A namespace to reorder indexed triangle lists.  A graphics
+//    card keeps a small cache of recently transformed
+//    vertexes, so a triangle whose vertexes were used by a
+//    recent triangle is cheaper to draw.  The triangles are
+//    reordered with Tom Forsyth's linear-speed vertex cache
+//    optimization, and the vertexes are then renumbered in the
+//    order they are first used so that they are read from
+//    memory in order.
+//
+//  The quality of an order is measured by the average cache
+//    miss ratio (ACMR): the number of vertexes transformed per
+//    triangle with a FIFO cache of CACHE_SIZE vertexes.  It is
+//    3.0 if nothing is reused, and approaches 0.5 for a large
+//    regular grid.
+//
+//  Every function depends only on the index values, so two
+//    meshes with the same triangles are always given the same
+//    order.
+//
+
+namespace MeshOptimizer
+{
+	//
+	//  CACHE_SIZE
+	//
+	//  The number of vertexes in the simulated vertex cache.
+	//
+	const unsigned int CACHE_SIZE = 32;
+
+	//
+	//  NOT_USED
+	//
+	//  The value returned by calculateVertexOrder for a vertex
+	//    that no triangle uses.
+	//
+	const unsigned int NOT_USED = ~0u;
+
+	//
+	//  calculateAcmr
+	//
+	//  Purpose: To calculate the average cache miss ratio for
+	//           the specified triangles.
+	//  Parameter(s):
+	//    <1> a_indexes: The triangle indexes
+	//    <2> index_count: The number of indexes
+	//    <3> vertex_count: The number of vertexes referred to
+	//  Precondition(s):
+	//    <1> a_indexes != NULL || index_count == 0
+	//    <2> index_count % 3 == 0
+	//    <3> a_indexes[i] < vertex_count
+	//                               WHERE 0 <= i < index_count
+	//  Returns: The number of vertexes transformed per triangle
+	//           with a FIFO cache of CACHE_SIZE vertexes.  If
+	//           there are no triangles, 0.0f is returned.
+	//  Side Effect: N/A
+	//
+	float calculateAcmr (const unsigned int* a_indexes,
+	                     unsigned int index_count,
+	                     unsigned int vertex_count);
+
+	//
+	//  optimizeTriangleOrder
+	//
+	//  Purpose: To reorder the specified triangles for the
+	//           vertex cache.
+	//  Parameter(s):
+	//    <1> a_indexes: The triangle indexes
+	//    <2> index_count: The number of indexes
+	//    <3> vertex_count: The number of vertexes referred to
+	//  Precondition(s):
+	//    <1> a_indexes != NULL || index_count == 0
+	//    <2> index_count % 3 == 0
+	//    <3> a_indexes[i] < vertex_count
+	//                               WHERE 0 <= i < index_count
+	//  Returns: N/A
+	//  Side Effect: The triangles in a_indexes are reordered.
+	//               The vertexes of each triangle stay in the
+	//               same order, so its facing does not change.
+	//
+	void optimizeTriangleOrder (unsigned int* a_indexes,
+	                            unsigned int index_count,
+	                            unsigned int vertex_count);
+
+	//
+	//  calculateVertexOrder
+	//
+	//  Purpose: To calculate a new numbering for the vertexes
+	//           that puts them in the order they are first used.
+	//  Parameter(s):
+	//    <1> indexes: The triangle indexes
+	//    <2> vertex_count: The number of vertexes referred to
+	//  Precondition(s):
+	//    <1> indexes[i] < vertex_count
+	//                               WHERE 0 <= i < indexes.size()
+	//  Returns: The new index for each old vertex.  Vertexes
+	//           that are not used are given NOT_USED.
+	//  Side Effect: N/A
+	//
+	std::vector<unsigned int> calculateVertexOrder (
+	                      const std::vector<unsigned int>& indexes,
+	                      unsigned int vertex_count);
+
+}  // end of namespace MeshOptimizer
+
+
+
+#endif
@@ -0,0 +1,602 @@
+//
+//  MeshSimplifier.cpp
+//
+
+#include <algorithm>
+#include <array>
+#include <cassert>
+#include <cmath>
+#include <cstdint>
+#include <map>
+#include <vector>
+
+#include "MeshSimplifier.h"
+
+using namespace std;
+namespace
+{
+	//
+	//  BORDER_WEIGHT
+	//
+	//  How strongly the edges of an open mesh are kept in
+	//    place, compared to the triangles themselves.
+	//
+	const double BORDER_WEIGHT = 10.0;
+
+	//
+	//  PASS_COUNT_MAX
+	//
+	//  The greatest number of passes made.  Each pass normally
+	//    removes a quarter or more of the remaining triangles,
+	//    so this is only reached if few collapses are possible.
+	//
+	const unsigned int PASS_COUNT_MAX = 100;
+
+	//
+	//  Quadric
+	//
+	//  A record of the sum of the squared distances to a set of
+	//    weighted planes, stored as the upper triangle of a
+	//    symmetric 4x4 matrix in the order a00, a01, a02, a03,
+	//    a11, a12, a13, a22, a23, a33.
+	//
+	struct Quadric
+	{
+		double ma_terms[10];
+		double m_weight;
+	};
+
+	//
+	//  Point
+	//
+	//  A record of a position.
+	//
+	struct Point
+	{
+		double x;
+		double y;
+		double z;
+	};
+
+	//
+	//  Collapse
+	//
+	//  A record of moving every vertex at one position to
+	//    another position.
+	//
+	struct Collapse
+	{
+		unsigned int m_from;
+		unsigned int m_to;
+		double m_error;
+	};
+
+	//
+	//  addPlane
+	//
+	//  Purpose: To add a plane to the specified quadric.
+	//  Parameter(s):
+	//    <1> r_quadric: The quadric
+	//    <2> normal: The unit normal of the plane
+	//    <3> point: A point on the plane
+	//    <4> weight: The weight of the plane
+	//  Precondition(s):
+	//    <1> weight >= 0.0
+	//  Returns: N/A
+	//  Side Effect: The plane is added to r_quadric.
+	//
+	void addPlane (Quadric& r_quadric, const Point& normal,
+	               const Point& point, double weight)
+	{
+		assert(weight >= 0.0);
+
+		double a = normal.x;
+		double b = normal.y;
+		double c = normal.z;
+		double d = -(a * point.x + b * point.y + c * point.z);
+
+		double* a_terms = r_quadric.ma_terms;
+		a_terms[0] += weight * a * a;
+		a_terms[1] += weight * a * b;
+		a_terms[2] += weight * a * c;
+		a_terms[3] += weight * a * d;
+		a_terms[4] += weight * b * b;
+		a_terms[5] += weight * b * c;
+		a_terms[6] += weight * b * d;
+		a_terms[7] += weight * c * c;
+		a_terms[8] += weight * c * d;
+		a_terms[9] += weight * d * d;
+		r_quadric.m_weight += weight;
+	}
+
+	//
+	//  addQuadric
+	//
+	//  Purpose: To add one quadric to another.
+	//  Parameter(s):
+	//    <1> r_quadric: The quadric to add to
+	//    <2> other: The quadric to add
+	//  Precondition(s): N/A
+	//  Returns: N/A
+	//  Side Effect: other is added to r_quadric.
+	//
+	void addQuadric (Quadric& r_quadric, const Quadric& other)
+	{
+		for(unsigned int i = 0; i < 10; i++)
+			r_quadric.ma_terms[i] += other.ma_terms[i];
+		r_quadric.m_weight += other.m_weight;
+	}
+
+	//
+	//  calculateError
+	//
+	//  Purpose: To calculate the mean squared distance from a
+	//           point to the planes in the sum of two quadrics.
+	//  Parameter(s):
+	//    <1> quadric1
+	//    <2> quadric2: The quadrics
+	//    <3> point: The point
+	//  Precondition(s): N/A
+	//  Returns: The weighted mean of the squared distances, or
+	//           0.0 if the quadrics have no weight.
+	//  Side Effect: N/A
+	//
+	double calculateError (const Quadric& quadric1,
+	                       const Quadric& quadric2,
+	                       const Point& point)
+	{
+		double a[10];
+		for(unsigned int i = 0; i < 10; i++)
+			a[i] = quadric1.ma_terms[i] + quadric2.ma_terms[i];
+		double weight = quadric1.m_weight + quadric2.m_weight;
+		if(weight <= 0.0)
+			return 0.0;
+
+		double x = point.x;
+		double y = point.y;
+		double z = point.z;
+		double error = a[0] * x * x + 2.0 * a[1] * x * y + 2.0 * a[2] * x * z + 2.0 * a[3] * x +
+		               a[4] * y * y + 2.0 * a[5] * y * z + 2.0 * a[6] * y +
+		               a[7] * z * z + 2.0 * a[8] * z +
+		               a[9];
+
+		// rounding can make it slightly negative
+		return max(error, 0.0) / weight;
+	}
+
+	//
+	//  calculateNormal
+	//
+	//  Purpose: To calculate the normal of a triangle.
+	//  Parameter(s):
+	//    <1> p0
+	//    <2> p1
+	//    <3> p2: The corners of the triangle
+	//  Precondition(s): N/A
+	//  Returns: The cross product of the edges from p0, which
+	//           is twice the area of the triangle long.
+	//  Side Effect: N/A
+	//
+	Point calculateNormal (const Point& p0, const Point& p1,
+	                       const Point& p2)
+	{
+		double ux = p1.x - p0.x;
+		double uy = p1.y - p0.y;
+		double uz = p1.z - p0.z;
+		double vx = p2.x - p0.x;
+		double vy = p2.y - p0.y;
+		double vz = p2.z - p0.z;
+
+		Point normal = { uy * vz - uz * vy,
+		                 uz * vx - ux * vz,
+		                 ux * vy - uy * vx };
+		return normal;
+	}
+
+	//
+	//  getLength
+	//
+	//  Purpose: To calculate the length of a vector.
+	//  Parameter(s):
+	//    <1> vector: The vector
+	//  Precondition(s): N/A
+	//  Returns: The length of vector.
+	//  Side Effect: N/A
+	//
+	double getLength (const Point& vector)
+	{
+		return sqrt(vector.x * vector.x + vector.y * vector.y + vector.z * vector.z);
+	}
+
+	//
+	//  makeEdgeKey
+	//
+	//  Purpose: To combine the two ends of an edge into one
+	//           value that does not depend on their order.
+	//  Parameter(s):
+	//    <1> a
+	//    <2> b: The ends of the edge
+	//  Precondition(s): N/A
+	//  Returns: The key for the edge.
+	//  Side Effect: N/A
+	//
+	uint64_t makeEdgeKey (unsigned int a, unsigned int b)
+	{
+		if(a > b)
+			swap(a, b);
+		return ((uint64_t)(a) << 32) | b;
+	}
+
+}  // end of anonymous namespace
+
+
+
+float MeshSimplifier :: simplify (const vector<float>& positions,
+                                  const vector<unsigned int>& indexes,
+                                  unsigned int target_triangle_count,
+                                  float error_max,
+                                  vector<unsigned int>& r_indexes,
+                                  vector<unsigned int>& r_source_triangles)
+{
+	assert(positions.size() % 3 == 0);
+	assert(indexes.size() % 3 == 0);
+	assert(error_max >= 0.0f);
+
+	unsigned int vertex_count   = positions.size() / 3;
+	unsigned int triangle_count = indexes.size() / 3;
+
+	// vertexes on either side of a seam move together
+	map<array<float, 3>, unsigned int> group_of_position;
+	vector<unsigned int> v_group(vertex_count);
+	vector<Point> v_points;
+	for(unsigned int v = 0; v < vertex_count; v++)
+	{
+		array<float, 3> key = { positions[v * 3 + 0], positions[v * 3 + 1], positions[v * 3 + 2] };
+		auto inserted = group_of_position.insert(make_pair(key, (unsigned int)(v_points.size())));
+		if(inserted.second)
+		{
+			Point point = { key[0], key[1], key[2] };
+			v_points.push_back(point);
+		}
+		v_group[v] = inserted.first->second;
+	}
+	unsigned int group_count = v_points.size();
+
+	vector<unsigned int> v_triangles(indexes);
+	vector<bool> v_is_alive(triangle_count, true);
+	unsigned int alive_count = 0;
+	Quadric zero = {};
+	vector<Quadric> v_quadrics(group_count, zero);
+	for(unsigned int t = 0; t < triangle_count; t++)
+	{
+		unsigned int g0 = v_group[v_triangles[t * 3 + 0]];
+		unsigned int g1 = v_group[v_triangles[t * 3 + 1]];
+		unsigned int g2 = v_group[v_triangles[t * 3 + 2]];
+		if(g0 == g1 || g1 == g2 || g2 == g0)
+		{
+			v_is_alive[t] = false;
+			continue;
+		}
+		alive_count++;
+
+		Point normal = calculateNormal(v_points[g0], v_points[g1], v_points[g2]);
+		double length = getLength(normal);
+		if(length <= 0.0)
+			continue;
+		Point unit = { normal.x / length, normal.y / length, normal.z / length };
+		double area = length * 0.5;
+		addPlane(v_quadrics[g0], unit, v_points[g0], area);
+		addPlane(v_quadrics[g1], unit, v_points[g0], area);
+		addPlane(v_quadrics[g2], unit, v_points[g0], area);
+	}
+
+	//
+	//  The border of an open mesh is held in place by adding
+	//    a plane through each border edge, perpendicular to
+	//    its triangle.
+	//
+
+	{
+		vector<uint64_t> v_edges;
+		for(unsigned int t = 0; t < triangle_count; t++)
+			if(v_is_alive[t])
+				for(unsigned int c = 0; c < 3; c++)
+					v_edges.push_back(makeEdgeKey(v_group[v_triangles[t * 3 + c]],
+					                              v_group[v_triangles[t * 3 + (c + 1) % 3]]));
+		sort(v_edges.begin(), v_edges.end());
+
+		for(unsigned int t = 0; t < triangle_count; t++)
+		{
+			if(!v_is_alive[t])
+				continue;
+
+			unsigned int ga[3] = { v_group[v_triangles[t * 3 + 0]],
+			                       v_group[v_triangles[t * 3 + 1]],
+			                       v_group[v_triangles[t * 3 + 2]] };
+			Point normal = calculateNormal(v_points[ga[0]], v_points[ga[1]], v_points[ga[2]]);
+			for(unsigned int c = 0; c < 3; c++)
+			{
+				unsigned int a = ga[c];
+				unsigned int b = ga[(c + 1) % 3];
+				auto range = equal_range(v_edges.begin(), v_edges.end(), makeEdgeKey(a, b));
+				if(range.second - range.first != 1)
+					continue;
+
+				Point edge = { v_points[b].x - v_points[a].x,
+				               v_points[b].y - v_points[a].y,
+				               v_points[b].z - v_points[a].z };
+				Point side = { edge.y * normal.z - edge.z * normal.y,
+				               edge.z * normal.x - edge.x * normal.z,
+				               edge.x * normal.y - edge.y * normal.x };
+				double side_length = getLength(side);
+				if(side_length <= 0.0)
+					continue;
+				Point unit = { side.x / side_length, side.y / side_length, side.z / side_length };
+
+				double edge_length = getLength(edge);
+				double weight = edge_length * edge_length * BORDER_WEIGHT;
+				addPlane(v_quadrics[a], unit, v_points[a], weight);
+				addPlane(v_quadrics[b], unit, v_points[a], weight);
+			}
+		}
+	}
+
+	double error_max_squared = (double)(error_max) * error_max;
+	double error_used = 0.0;
+	vector<unsigned int> v_first(group_count + 1);
+	vector<unsigned int> v_adjacent;
+	vector<uint64_t> v_edges;
+	vector<bool> v_is_border(group_count);
+	vector<Collapse> v_collapses;
+	vector<bool> v_is_locked(group_count);
+	vector<unsigned int> v_stamp(group_count, 0);
+	unsigned int stamp = 0;
+	vector<unsigned int> v_remap(vertex_count);
+	vector<pair<unsigned int, unsigned int>> v_partners;
+
+	for(unsigned int pass = 0; pass < PASS_COUNT_MAX && alive_count > target_triangle_count; pass++)
+	{
+		// the triangles around each position
+		fill(v_first.begin(), v_first.end(), 0);
+		for(unsigned int t = 0; t < triangle_count; t++)
+			if(v_is_alive[t])
+				for(unsigned int c = 0; c < 3; c++)
+					v_first[v_group[v_triangles[t * 3 + c]] + 1]++;
+		for(unsigned int g = 0; g < group_count; g++)
+			v_first[g + 1] += v_first[g];
+		v_adjacent.resize(v_first[group_count]);
+		{
+			vector<unsigned int> v_filled(v_first.begin(), v_first.end() - 1);
+			for(unsigned int t = 0; t < triangle_count; t++)
+				if(v_is_alive[t])
+					for(unsigned int c = 0; c < 3; c++)
+						v_adjacent[v_filled[v_group[v_triangles[t * 3 + c]]]++] = t;
+		}
+
+		// each edge once, marked if it is on the border
+		v_edges.clear();
+		for(unsigned int t = 0; t < triangle_count; t++)
+			if(v_is_alive[t])
+				for(unsigned int c = 0; c < 3; c++)
+					v_edges.push_back(makeEdgeKey(v_group[v_triangles[t * 3 + c]],
+					                              v_group[v_triangles[t * 3 + (c + 1) % 3]]));
+		sort(v_edges.begin(), v_edges.end());
+
+		fill(v_is_border.begin(), v_is_border.end(), false);
+		v_collapses.clear();
+		for(unsigned int i = 0; i < v_edges.size(); )
+		{
+			unsigned int run = 1;
+			while(i + run < v_edges.size() && v_edges[i + run] == v_edges[i])
+				run++;
+			unsigned int a = (unsigned int)(v_edges[i] >> 32);
+			unsigned int b = (unsigned int)(v_edges[i] & 0xFFFFFFFF);
+			if(run == 1)
+			{
+				v_is_border[a] = true;
+				v_is_border[b] = true;
+			}
+			i += run;
+		}
+		for(unsigned int i = 0; i < v_edges.size(); )
+		{
+			unsigned int run = 1;
+			while(i + run < v_edges.size() && v_edges[i + run] == v_edges[i])
+				run++;
+			unsigned int a = (unsigned int)(v_edges[i] >> 32);
+			unsigned int b = (unsigned int)(v_edges[i] & 0xFFFFFFFF);
+			bool is_border_edge = (run == 1);
+			i += run;
+
+			// a border vertex may only slide along the border
+			bool is_a_movable = !v_is_border[a] || is_border_edge;
+			bool is_b_movable = !v_is_border[b] || is_border_edge;
+			double error_a = calculateError(v_quadrics[a], v_quadrics[b], v_points[b]);
+			double error_b = calculateError(v_quadrics[a], v_quadrics[b], v_points[a]);
+
+			Collapse collapse;
+			if(is_a_movable && (!is_b_movable || error_a <= error_b))
+			{
+				collapse.m_from  = a;
+				collapse.m_to    = b;
+				collapse.m_error = error_a;
+			}
+			else if(is_b_movable)
+			{
+				collapse.m_from  = b;
+				collapse.m_to    = a;
+				collapse.m_error = error_b;
+			}
+			else
+				continue;
+
+			if(collapse.m_error <= error_max_squared)
+				v_collapses.push_back(collapse);
+		}
+		sort(v_collapses.begin(), v_collapses.end(), [] (const Collapse& c1, const Collapse& c2)
+		{
+			if(c1.m_error != c2.m_error)
+				return c1.m_error < c2.m_error;
+			return c1.m_from < c2.m_from;  // so the result does not depend on the sort
+		});
+
+		fill(v_is_locked.begin(), v_is_locked.end(), false);
+		for(unsigned int v = 0; v < vertex_count; v++)
+			v_remap[v] = v;
+
+		bool is_any_collapsed = false;
+		for(unsigned int i = 0; i < v_collapses.size() && alive_count > target_triangle_count; i++)
+		{
+			unsigned int from = v_collapses[i].m_from;
+			unsigned int to   = v_collapses[i].m_to;
+			if(v_is_locked[from] || v_is_locked[to])
+				continue;
+
+			// every vertex at from must have a matching vertex at to
+			v_partners.clear();
+			unsigned int shared_count = 0;
+			for(unsigned int j = v_first[from]; j < v_first[from + 1]; j++)
+			{
+				unsigned int t = v_adjacent[j];
+				int corner_from = -1;
+				int corner_to   = -1;
+				for(unsigned int c = 0; c < 3; c++)
+				{
+					unsigned int group = v_group[v_triangles[t * 3 + c]];
+					if(group == from)
+						corner_from = c;
+					else if(group == to)
+						corner_to = c;
+				}
+				assert(corner_from >= 0);
+				if(corner_to >= 0)
+				{
+					v_partners.push_back(make_pair(v_triangles[t * 3 + corner_from],
+					                               v_triangles[t * 3 + corner_to]));
+					shared_count++;
+				}
+			}
+
+			bool is_valid = (shared_count > 0);
+			for(unsigned int j = v_first[from]; is_valid && j < v_first[from + 1]; j++)
+			{
+				unsigned int t = v_adjacent[j];
+				for(unsigned int c = 0; c < 3; c++)
+				{
+					unsigned int vertex = v_triangles[t * 3 + c];
+					if(v_group[vertex] != from)
+						continue;
+
+					bool is_found = false;
+					for(unsigned int k = 0; k < v_partners.size(); k++)
+						if(v_partners[k].first == vertex)
+							is_found = true;
+					if(!is_found)
+						is_valid = false;
+				}
+			}
+			if(!is_valid)
+				continue;
+
+			// the ends may share only the neighbours across the edge
+			stamp++;
+			for(unsigned int j = v_first[to]; j < v_first[to + 1]; j++)
+			{
+				unsigned int t = v_adjacent[j];
+				for(unsigned int c = 0; c < 3; c++)
+					v_stamp[v_group[v_triangles[t * 3 + c]]] = stamp;
+			}
+			unsigned int common_count = 0;
+			for(unsigned int j = v_first[from]; j < v_first[from + 1]; j++)
+			{
+				unsigned int t = v_adjacent[j];
+				for(unsigned int c = 0; c < 3; c++)
+				{
+					unsigned int group = v_group[v_triangles[t * 3 + c]];
+					if(group != from && group != to && v_stamp[group] == stamp)
+					{
+						v_stamp[group] = 0;  // count each once
+						common_count++;
+					}
+				}
+			}
+			if(common_count != shared_count)
+				continue;
+
+			// no triangle may flip over
+			for(unsigned int j = v_first[from]; is_valid && j < v_first[from + 1]; j++)
+			{
+				unsigned int t = v_adjacent[j];
+				Point before[3];
+				Point after[3];
+				bool is_shared = false;
+				for(unsigned int c = 0; c < 3; c++)
+				{
+					unsigned int group = v_group[v_triangles[t * 3 + c]];
+					if(group == to)
+						is_shared = true;
+					before[c] = v_points[group];
+					after[c]  = (group == from) ? v_points[to] : v_points[group];
+				}
+				if(is_shared)
+					continue;
+
+				Point normal_before = calculateNormal(before[0], before[1], before[2]);
+				Point normal_after  = calculateNormal(after[0],  after[1],  after[2]);
+				double dot = normal_before.x * normal_after.x +
+				             normal_before.y * normal_after.y +
+				             normal_before.z * normal_after.z;
+				if(dot <= 0.0)
+					is_valid = false;
+			}
+			if(!is_valid)
+				continue;
+
+			for(unsigned int k = 0; k < v_partners.size(); k++)
+				v_remap[v_partners[k].first] = v_partners[k].second;
+			addQuadric(v_quadrics[to], v_quadrics[from]);
+
+			// later collapses this pass must not see these triangles
+			for(unsigned int j = v_first[from]; j < v_first[from + 1]; j++)
+			{
+				unsigned int t = v_adjacent[j];
+				for(unsigned int c = 0; c < 3; c++)
+					v_is_locked[v_group[v_triangles[t * 3 + c]]] = true;
+			}
+
+			alive_count -= shared_count;
+			error_used = max(error_used, v_collapses[i].m_error);
+			is_any_collapsed = true;
+		}
+		if(!is_any_collapsed)
+			break;
+
+		for(unsigned int t = 0; t < triangle_count; t++)
+		{
+			if(!v_is_alive[t])
+				continue;
+
+			for(unsigned int c = 0; c < 3; c++)
+				v_triangles[t * 3 + c] = v_remap[v_triangles[t * 3 + c]];
+
+			unsigned int g0 = v_group[v_triangles[t * 3 + 0]];
+			unsigned int g1 = v_group[v_triangles[t * 3 + 1]];
+			unsigned int g2 = v_group[v_triangles[t * 3 + 2]];
+			if(g0 == g1 || g1 == g2 || g2 == g0)
+				v_is_alive[t] = false;
+		}
+	}
+
+	r_indexes.clear();
+	r_source_triangles.clear();
+	for(unsigned int t = 0; t < triangle_count; t++)
+	{
+		if(!v_is_alive[t])
+			continue;
+		r_indexes.push_back(v_triangles[t * 3 + 0]);
+		r_indexes.push_back(v_triangles[t * 3 + 1]);
+		r_indexes.push_back(v_triangles[t * 3 + 2]);
+		r_source_triangles.push_back(t);
+	}
+	return (float)(sqrt(error_used));
+}
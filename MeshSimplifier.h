@@ -0,0 +1,87 @@
+//
+//  MeshSimplifier.h
+//
+//  A module to reduce the number of triangles in a mesh.
+//
+
+#ifndef MESH_SIMPLIFIER_H
+#define MESH_SIMPLIFIER_H
+
+#include <vector>
+
+
+
+//
+//  MeshSimplifier
+//
+//  A namespace to simplify indexed triangle meshes with the
+//    quadric error metric of Garland and Heckbert.  Each
+//    vertex position accumulates the planes of the triangles
+//    around it, and the edge whose collapse moves the surface
+//    least is collapsed first.
+//
+//  Edges are collapsed onto one of their existing endpoints,
+//    so every remaining vertex keeps its texture coordinates
+//    and normal and the vertex array can be shared with the
+//    original mesh.  Vertexes with the same position but
+//    different texture coordinates or normals are moved
+//    together, and a collapse that would tear such a seam, move
+//    a vertex off the border of an open mesh, or flip a
+//    triangle is not made.
+//
+//  Collapses are made in passes.  In each pass, the cheapest
+//    collapses that do not touch each other are made together,
+//    which keeps the mesh data simple at the cost of a
+//    slightly less even result.
+//
+
+namespace MeshSimplifier
+{
+	//
+	//  simplify
+	//
+	//  Purpose: To calculate a simplified version of the
+	//           specified mesh.
+	//  Parameter(s):
+	//    <1> positions: The vertex positions, as x, y, and z
+	//                   for each vertex in turn
+	//    <2> indexes: The triangle indexes
+	//    <3> target_triangle_count: The number of triangles to
+	//                               reduce the mesh to
+	//    <4> error_max: The greatest distance any collapse may
+	//                   move the surface
+	//    <5> r_indexes: The simplified triangle indexes
+	//    <6> r_source_triangles: The original triangle that
+	//                            each simplified triangle came
+	//                            from
+	//  Precondition(s):
+	//    <1> positions.size() % 3 == 0
+	//    <2> indexes.size() % 3 == 0
+	//    <3> indexes[i] < positions.size() / 3
+	//                               WHERE 0 <= i < indexes.size()
+	//    <4> error_max >= 0.0f
+	//  Returns: The estimated greatest distance between the
+	//           original and simplified surfaces.
+	//  Side Effect: r_indexes is set to the triangles that
+	//               remain, in their original order, with their
+	//               vertexes replaced by the ones they were
+	//               collapsed onto.  r_source_triangles is set
+	//               to the index of each of those triangles in
+	//               indexes.  Simplifying stops when
+	//               target_triangle_count triangles remain or
+	//               no more collapses are possible within
+	//               error_max, whichever comes first.
+	//               Triangles with no area are removed.
+	//
+	float simplify (const std::vector<float>& positions,
+	                const std::vector<unsigned int>& indexes,
+	                unsigned int target_triangle_count,
+	                float error_max,
+	                std::vector<unsigned int>& r_indexes,
+	                std::vector<unsigned int>& r_source_triangles);
+
+}  // end of namespace MeshSimplifier
+
+
+
+#endif
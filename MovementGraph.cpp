@@ -18,7 +18,7 @@
 using namespace std;
 using namespace ObjLibrary;
 
-MovementGraph::MovementGraph(Vector3 pos, Disk did): Node_position(pos), disk_id(did)
+MovementGraph::MovementGraph(Vector3 pos, unsigned int disk): Node_position(pos), disk_index(disk)
 {
 
 }
\ No newline at end of file
@@ -21,11 +21,11 @@ class MovementGraph
 {
 public:
 
-	MovementGraph(Vector3 pos, Disk did);
+	MovementGraph(Vector3 pos, unsigned int disk);
 	//~MovementGraph();
 
 	Vector3 Node_position;
-	Disk disk_id;
+	unsigned int disk_index;
 	std::vector<Links> disk_links;
 
 	//Nodes node_found;
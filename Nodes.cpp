@@ -33,15 +33,3 @@ Nodes::Nodes(Vector3 node_pos, double c, double v) : pos_node(node_pos), cost(c)
 
 }
 
-
-Vector3 Nodes::calculateNodePosition(Disk disk_a, Disk disk_b)
-{
-	Vector3 long_directionVector = disk_b.getPosition() - disk_a.getPosition();
-	Vector3 unit_distanceVector = long_directionVector.getNormalized();
-	double dist_a = disk_a.getRadius() - 0.7;
-
-
-	Vector3 pos_aNode = disk_a.getPosition() + unit_distanceVector * dist_a;
-
-	return pos_aNode;
-}
\ No newline at end of file
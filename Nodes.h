@@ -26,7 +26,6 @@ public:
 	Nodes(Vector3 node_pos, double c, double v);
 
 	Vector3 pos_node;
-	static ObjLibrary::Vector3 calculateNodePosition(Disk disk_a, Disk disk_b);
 	std::vector<Search_data> search_data_node;
 	std::vector<Links> all_links;
 	double cost, h, f;
@@ -2,6 +2,9 @@
 //  NoiseField.h
 //
 
+#ifndef NOISE_FIELD_H
+#define NOISE_FIELD_H
+
 
 
 //
@@ -68,3 +71,6 @@ private:
 	unsigned int m_seed_q2;
 };
 
+
+
+#endif
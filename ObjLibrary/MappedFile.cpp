@@ -0,0 +1,171 @@
+//
+//  MappedFile.cpp
+//
+//  This file is part of the ObjLibrary, but is not part of
+//    the official release by Richard Hamilton.
+//
+
+#include <cassert>
+#include <cstddef>
+#include <string>
+
+#ifdef _WIN32
+	#define WIN32_LEAN_AND_MEAN
+	#define NOMINMAX
+	#include <windows.h>
+#else
+	#include <fcntl.h>
+	#include <sys/mman.h>
+	#include <sys/stat.h>
+	#include <unistd.h>
+#endif
+
+#include "MappedFile.h"
+
+using namespace std;
+using namespace ObjLibrary;
+
+
+
+MappedFile :: MappedFile ()
+		: m_is_open(false)
+		, ma_data(NULL)
+		, m_size(0)
+{
+	assert(invariant());
+}
+
+MappedFile :: MappedFile (const string& filename)
+		: m_is_open(false)
+		, ma_data(NULL)
+		, m_size(0)
+{
+	assert(filename != "");
+
+	open(filename);
+
+	assert(invariant());
+}
+
+MappedFile :: ~MappedFile ()
+{
+	close();
+}
+
+
+
+bool MappedFile :: isOpen () const
+{
+	return m_is_open;
+}
+
+const char* MappedFile :: getData () const
+{
+	return ma_data;
+}
+
+size_t MappedFile :: getSize () const
+{
+	return m_size;
+}
+
+
+
+bool MappedFile :: open (const string& filename)
+{
+	assert(filename != "");
+
+	close();
+
+#ifdef _WIN32
+	HANDLE file = CreateFileA(filename.c_str(), GENERIC_READ, FILE_SHARE_READ, NULL,
+	                          OPEN_EXISTING, FILE_FLAG_SEQUENTIAL_SCAN, NULL);
+	if(file == INVALID_HANDLE_VALUE)
+		return false;
+
+	LARGE_INTEGER size;
+	if(!GetFileSizeEx(file, &size))
+	{
+		CloseHandle(file);
+		return false;
+	}
+
+	if(size.QuadPart > 0)
+	{
+		// the mapping keeps its own reference to the file
+		HANDLE mapping = CreateFileMappingA(file, NULL, PAGE_READONLY, 0, 0, NULL);
+		CloseHandle(file);
+		if(mapping == NULL)
+			return false;
+
+		void* a_view = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+		CloseHandle(mapping);
+		if(a_view == NULL)
+			return false;
+
+		ma_data = (const char*)(a_view);
+		m_size  = (size_t)(size.QuadPart);
+	}
+	else
+		CloseHandle(file);
+#else
+	int file = ::open(filename.c_str(), O_RDONLY);
+	if(file < 0)
+		return false;
+
+	struct stat status;
+	if(fstat(file, &status) != 0)
+	{
+		::close(file);
+		return false;
+	}
+
+	// mmap does not allow mapping 0 bytes
+	if(status.st_size > 0)
+	{
+		void* a_view = mmap(NULL, (size_t)(status.st_size), PROT_READ, MAP_PRIVATE, file, 0);
+		::close(file);
+		if(a_view == MAP_FAILED)
+			return false;
+		madvise(a_view, (size_t)(status.st_size), MADV_SEQUENTIAL);
+
+		ma_data = (const char*)(a_view);
+		m_size  = (size_t)(status.st_size);
+	}
+	else
+		::close(file);
+#endif
+
+	m_is_open = true;
+
+	assert(invariant());
+	return true;
+}
+
+void MappedFile :: close ()
+{
+	if(ma_data != NULL)
+	{
+#ifdef _WIN32
+		UnmapViewOfFile(ma_data);
+#else
+		munmap((void*)(ma_data), m_size);
+#endif
+	}
+
+	m_is_open = false;
+	ma_data   = NULL;
+	m_size    = 0;
+
+	assert(invariant());
+}
+
+
+
+bool MappedFile :: invariant () const
+{
+	if(!m_is_open && ma_data != NULL) return false;
+	if(!m_is_open && m_size  != 0) return false;
+	if(m_size != 0 && ma_data == NULL) return false;
+	return true;
+}
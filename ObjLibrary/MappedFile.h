@@ -0,0 +1,176 @@
+//
+//  MappedFile.h
+//
+//  A module to encapsulate a read-only memory-mapped file.
+//
+//  This file is part of the ObjLibrary, but is not part of
+//    the official release by Richard Hamilton.
+//
+
+#ifndef OBJ_LIBRARY_MAPPED_FILE_H
+#define OBJ_LIBRARY_MAPPED_FILE_H
+
+#include <cstddef>
+#include <string>
+
+
+
+namespace ObjLibrary
+{
+
+//
+//  MappedFile
+//
+//  A class to give read-only access to the contents of a file
+//    by mapping it into memory.  This avoids copying the file
+//    into a buffer and lets the operating system page the
+//    contents in as they are read.  On Windows, the file is
+//    mapped with CreateFileMapping; elsewhere, with mmap.
+//
+//  A MappedFile cannot be copied.  The file stays mapped until
+//    the MappedFile is destroyed or close() is called.  The
+//    contents are not null-terminated.
+//
+//  Class Invariant:
+//    <1> isOpen() || ma_data == NULL
+//    <2> isOpen() || m_size == 0
+//    <3> m_size == 0 || ma_data != NULL
+//
+class MappedFile
+{
+public:
+//
+//  Default Constructor
+//
+//  Purpose: To create a new MappedFile that is not associated
+//           with any file.
+//  Parameter(s): N/A
+//  Precondition(s): N/A
+//  Returns: N/A
+//  Side Effect: A new MappedFile is created.
+//
+	MappedFile ();
+
+//
+//  Constructor
+//
+//  Purpose: To create a new MappedFile for the specified file.
+//  Parameter(s):
+//    <1> filename: The name of the file to map
+//  Precondition(s):
+//    <1> filename != ""
+//  Returns: N/A
+//  Side Effect: A new MappedFile is created.  If the file can
+//               be opened, it is mapped into memory.
+//               Otherwise, the MappedFile is not open.
+//
+	MappedFile (const std::string& filename);
+
+//
+//  Destructor
+//
+//  Purpose: To safely destroy a MappedFile.
+//  Parameter(s): N/A
+//  Precondition(s): N/A
+//  Returns: N/A
+//  Side Effect: The file is unmapped, if it is open.
+//
+	~MappedFile ();
+
+//
+//  isOpen
+//
+//  Purpose: To determine whether this MappedFile is associated
+//           with a file.
+//  Parameter(s): N/A
+//  Precondition(s): N/A
+//  Returns: Whether a file is mapped.  An empty file counts as
+//           open even though no memory is mapped for it.
+//  Side Effect: N/A
+//
+	bool isOpen () const;
+
+//
+//  getData
+//
+//  Purpose: To retrieve the contents of the mapped file.
+//  Parameter(s): N/A
+//  Precondition(s): N/A
+//  Returns: A pointer to the first byte of the file.  If the
+//           file is not open or empty, NULL is returned.
+//  Side Effect: N/A
+//
+	const char* getData () const;
+
+//
+//  getSize
+//
+//  Purpose: To determine the size of the mapped file.
+//  Parameter(s): N/A
+//  Precondition(s): N/A
+//  Returns: The size of the file in bytes.  If the file is not
+//           open, 0 is returned.
+//  Side Effect: N/A
+//
+	size_t getSize () const;
+
+//
+//  open
+//
+//  Purpose: To map the specified file into memory.
+//  Parameter(s):
+//    <1> filename: The name of the file to map
+//  Precondition(s):
+//    <1> filename != ""
+//  Returns: Whether the file could be mapped.
+//  Side Effect: Any file already mapped is unmapped.  Then, if
+//               the file can be opened, it is mapped into
+//               memory.
+//
+	bool open (const std::string& filename);
+
+//
+//  close
+//
+//  Purpose: To unmap the file for this MappedFile.
+//  Parameter(s): N/A
+//  Precondition(s): N/A
+//  Returns: N/A
+//  Side Effect: If a file is mapped, it is unmapped.
+//               Otherwise, there is no effect.
+//
+	void close ();
+
+private:
+//
+//  Copy Constructor
+//  Assignment Operator
+//
+//  These functions have intentionally not been implemented
+//    because a mapping should only be released once.
+//
+	MappedFile (const MappedFile& original);
+	MappedFile& operator= (const MappedFile& original);
+
+//
+//  Helper Function: invariant
+//
+//  Purpose: To determine if the class invariant is true.
+//  Parameter(s): N/A
+//  Precondition(s): N/A
+//  Returns: Whether the class invariant is true.
+//  Side Effect: N/A
+//
+	bool invariant () const;
+
+private:
+	bool m_is_open;
+	const char* ma_data;
+	size_t m_size;
+};
+
+
+
+}  // end of namespace ObjLibrary
+
+#endif
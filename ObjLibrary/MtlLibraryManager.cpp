@@ -22,6 +22,7 @@
 #include <vector>
 #include <iostream>
 #include <fstream>
+#include <mutex>
 
 #include "ObjStringParsing.h"
 #include "MtlLibrary.h"
@@ -35,12 +36,38 @@ namespace
 {
 	std::vector<MtlLibrary*> g_mtl_libraries;
 	MtlLibrary g_empty;
+
+	// guards g_mtl_libraries; the libraries themselves are never moved
+	std::mutex g_mutex;
+
+	//
+	//  findLibrary
+	//
+	//  Purpose: To find the material library with the specified
+	//           name.
+	//  Parameter(s):
+	//    <1> lower: The name of the material library, in
+	//               lowercase
+	//  Precondition(s):
+	//    <1> g_mutex is locked by the calling thread
+	//  Returns: A pointer to the material library, or NULL if
+	//           there is none.
+	//  Side Effect: N/A
+	//
+	MtlLibrary* findLibrary (const string& lower)
+	{
+		for(unsigned int i = 0; i < g_mtl_libraries.size(); i++)
+			if(g_mtl_libraries[i]->getFileNameWithPathLowercase() == lower)
+				return g_mtl_libraries[i];
+		return NULL;
+	}
 }
 
 
 
 unsigned int MtlLibraryManager :: getCount ()
 {
+	lock_guard<mutex> lock(g_mutex);
 	return g_mtl_libraries.size();
 }
 
@@ -48,6 +75,7 @@ MtlLibrary& MtlLibraryManager :: get (unsigned int index)
 {
 	assert(index < getCount());
 
+	lock_guard<mutex> lock(g_mutex);
 	return *(g_mtl_libraries[index]);
 }
 
@@ -62,10 +90,8 @@ bool MtlLibraryManager :: isLoaded (const std::string& name)
 {
 	string lower = toLowercase(name);
 
-	for(unsigned int i = 0; i < g_mtl_libraries.size(); i++)
-		if(g_mtl_libraries[i]->getFileNameWithPathLowercase() == lower)
-			return true;
-	return false;
+	lock_guard<mutex> lock(g_mutex);
+	return findLibrary(lower) != NULL;
 }
 
 MtlLibrary& MtlLibraryManager :: get (const char* a_name)
@@ -114,14 +140,33 @@ MtlLibrary& MtlLibraryManager :: get (const string& name, ostream& r_logstream)
 {
 	string lower = toLowercase(name);
 
-	for(unsigned int i = 0; i < g_mtl_libraries.size(); i++)
-		if(g_mtl_libraries[i]->getFileNameWithPathLowercase() == lower)
-			return *(g_mtl_libraries[i]);
+	{
+		lock_guard<mutex> lock(g_mutex);
+		MtlLibrary* p_found = findLibrary(lower);
+		if(p_found != NULL)
+			return *p_found;
+	}
 
-	if(endsWith(lower, ".mtl"))
-		return add(MtlLibrary(name, r_logstream));
-	else
+	if(!endsWith(lower, ".mtl"))
 		return g_empty;
+
+	//
+	//  Parse the file without holding the lock so that other
+	//    threads can load other libraries at the same time.
+	//    If another thread loaded the same library meanwhile,
+	//    its copy is used and this one is discarded.
+	//
+	MtlLibrary* p_library = new MtlLibrary(name, r_logstream);
+
+	lock_guard<mutex> lock(g_mutex);
+	MtlLibrary* p_found = findLibrary(lower);
+	if(p_found != NULL)
+	{
+		delete p_library;
+		return *p_found;
+	}
+	g_mtl_libraries.push_back(p_library);
+	return *p_library;
 }
 
 bool MtlLibraryManager :: isMaterial (const char* a_name, const char* a_material)
@@ -230,6 +275,7 @@ MtlLibrary& MtlLibraryManager :: add (const MtlLibrary& mtl_library)
 {
 	assert(!isLoaded(mtl_library.getFileNameWithPathLowercase()));
 
+	lock_guard<mutex> lock(g_mutex);
 	unsigned int index = g_mtl_libraries.size();
 	g_mtl_libraries.push_back(new MtlLibrary(mtl_library));
 
@@ -238,6 +284,7 @@ MtlLibrary& MtlLibraryManager :: add (const MtlLibrary& mtl_library)
 
 void MtlLibraryManager :: unloadAll ()
 {
+	lock_guard<mutex> lock(g_mutex);
 	for(unsigned int i = 0; i < g_mtl_libraries.size(); i++)
 		delete g_mtl_libraries[i];
 	g_mtl_libraries.clear();
@@ -247,6 +294,7 @@ void MtlLibraryManager :: loadDisplayTextures ()
 {
 	// such simple code for such a powerful command...
 
+	lock_guard<mutex> lock(g_mutex);
 	for(unsigned int i = 0; i < g_mtl_libraries.size(); i++)
 		g_mtl_libraries[i]->loadDisplayTextures();
 }
@@ -255,6 +303,7 @@ void MtlLibraryManager :: loadAllTextures ()
 {
 	// such simple code for such a powerful command...
 
+	lock_guard<mutex> lock(g_mutex);
 	for(unsigned int i = 0; i < g_mtl_libraries.size(); i++)
 		g_mtl_libraries[i]->loadAllTextures();
 }
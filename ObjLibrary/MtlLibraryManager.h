@@ -3,6 +3,14 @@
 //
 //  A global service to handle MtlLibraries.
 //
+//  The list of libraries is guarded by a mutex, so libraries
+//    may be looked up and loaded from several threads at once,
+//    for example by ObjModels being loaded on worker threads.
+//    A library is never moved once added, so references
+//    returned remain valid until unloadAll is called.  The
+//    functions that load textures use OpenGL and must only be
+//    called from the thread that owns the OpenGL context.
+//
 //  This file is part of the ObjLibrary, by Richard Hamilton,
 //    which is copyright Hamilton 2009-2016.
 //
@@ -37,6 +45,14 @@ class Material;
 //
 //  A global service to handle MtlLibraries.
 //
+//  The list of libraries is guarded by a mutex, so libraries
+//    may be looked up and loaded from several threads at once,
+//    for example by ObjModels being loaded on worker threads.
+//    A library is never moved once added, so references
+//    returned remain valid until unloadAll is called.  The
+//    functions that load textures use OpenGL and must only be
+//    called from the thread that owns the OpenGL context.
+//
 namespace MtlLibraryManager
 {
 
@@ -19,8 +19,10 @@
 
 #include <cassert>
 #include <cctype>
-#include <cstdlib>	// for atoi
+#include <cstring>	// for memchr
+#include <charconv>	// for from_chars
 #include <string>
+#include <string_view>
 #include <iostream>
 #include <iomanip>
 #include <fstream>
@@ -35,6 +37,7 @@
 #endif
 
 #include "ObjStringParsing.h"
+#include "MappedFile.h"
 #include "DisplayList.h"
 #include "Material.h"
 #include "MtlLibrary.h"
@@ -75,6 +78,118 @@ namespace
 	const bool DEBUGGING_VALIDATE      = false || DEBUGGING_LOAD;
 	const bool DEBUGGING_VERTEX_BUFFER = false;
 	const bool DEBUGGING_FACE_SHADERS  = false;
+
+	//
+	//  isWhitespace
+	//
+	//  Purpose: To determine if the specified character is
+	//           whitespace.
+	//  Parameter(s):
+	//    <1> c: The character
+	//  Precondition(s): N/A
+	//  Returns: Whether c is whitespace, as determined by
+	//           isspace.
+	//  Side Effect: N/A
+	//
+	inline bool isWhitespace (char c)
+	{
+		return isspace((unsigned char)(c)) != 0;
+	}
+
+	//
+	//  isKeyword
+	//
+	//  Purpose: To determine if the specified line starts with
+	//           the specified keyword.
+	//  Parameter(s):
+	//    <1> line: The line
+	//    <2> keyword: The keyword
+	//  Precondition(s): N/A
+	//  Returns: Whether line starts with keyword followed by
+	//           a whitespace character.
+	//  Side Effect: N/A
+	//
+	inline bool isKeyword (string_view line, string_view keyword)
+	{
+		return line.size() > keyword.size() &&
+		       line.compare(0, keyword.size(), keyword) == 0 &&
+		       isWhitespace(line[keyword.size()]);
+	}
+
+	//
+	//  popToken
+	//
+	//  Purpose: To remove the first token from the specified
+	//           string.  Tokens are separated by whitespace.
+	//  Parameter(s):
+	//    <1> r_str: The string
+	//  Precondition(s): N/A
+	//  Returns: The first token in r_str.  If there are no
+	//           tokens, an empty string is returned.
+	//  Side Effect: The token and any whitespace before it are
+	//               removed from r_str.
+	//
+	string_view popToken (string_view& r_str)
+	{
+		size_t start = 0;
+		while(start < r_str.size() && isWhitespace(r_str[start]))
+			start++;
+		size_t end = start;
+		while(end < r_str.size() && !isWhitespace(r_str[end]))
+			end++;
+
+		string_view token = r_str.substr(start, end - start);
+		r_str.remove_prefix(end);
+		return token;
+	}
+
+	//
+	//  parseDouble
+	//  parseInt
+	//
+	//  Purpose: To read a number from the beginning of the
+	//           specified string.
+	//  Parameter(s):
+	//    <1> str: The string
+	//  Precondition(s): N/A
+	//  Returns: The number at the start of str, read as by
+	//           atof or atoi.  If there is no number, 0 is
+	//           returned.
+	//  Side Effect: N/A
+	//
+	double parseDouble (string_view str)
+	{
+		const char* p_begin = str.data();
+		const char* p_end   = str.data() + str.size();
+		if(p_begin != p_end && *p_begin == '+')
+		{
+			p_begin++;
+			if(p_begin != p_end && *p_begin == '-')
+				return 0.0;
+		}
+
+		double value = 0.0;
+		if(from_chars(p_begin, p_end, value).ec != errc())
+			return 0.0;
+		return value;
+	}
+
+	int parseInt (string_view str)
+	{
+		const char* p_begin = str.data();
+		const char* p_end   = str.data() + str.size();
+		if(p_begin != p_end && *p_begin == '+')
+		{
+			p_begin++;
+			if(p_begin != p_end && *p_begin == '-')
+				return 0;
+		}
+
+		int value = 0;
+		if(from_chars(p_begin, p_end, value).ec != errc())
+			return 0;
+		return value;
+	}
 }
 
 
@@ -1916,7 +2031,6 @@ void ObjModel :: load (const string& filename, ostream& r_logstream)
 	assert(filename.find_last_of("/\\") == string::npos ||
 	       filename.find_last_of("/\\") + 1 < filename.size());
 
-	ifstream input_file;
 	unsigned int line_count;
 
 	if(DEBUGGING_LOAD)
@@ -1929,11 +2043,10 @@ void ObjModel :: load (const string& filename, ostream& r_logstream)
 
 	setFileNameWithPath(filename);
 
-	input_file.open(filename.c_str(), ios::in);
-	if(!input_file.is_open())
+	MappedFile input_file(filename);
+	if(!input_file.isOpen())
 	{
 		r_logstream << "Error: File \"" << filename << "\" does not exist" << endl;
-		input_file.close();
 
 		m_file_load_success = false;
 
@@ -1946,68 +2059,67 @@ void ObjModel :: load (const string& filename, ostream& r_logstream)
 	//
 	//  http://www.martinreddy.net/gfx/3d/OBJ.spec
 	//
+	//  The lines are read directly from the mapped file, so
+	//    no line is ever copied unless it is invalid.
+	//
+
+	const char* p_next = input_file.getData();
+	const char* p_end  = input_file.getData() + input_file.getSize();
 
 	line_count = 0;
-	while(true)	// drops out at EOF below
+	while(p_next < p_end)
 	{
-		string line;
-		size_t line_length;
-		bool valid;
+		const char* p_newline = (const char*)(memchr(p_next, '\n', p_end - p_next));
+		if(p_newline == NULL)
+			p_newline = p_end;
+		string_view line(p_next, p_newline - p_next);
+		p_next = p_newline + 1;
 
-		getline(input_file, line);
-		if(line == "" && input_file.eof())
-			break;	// drop out if no more lines (but include last line)
+		size_t line_length = line.length();
+		bool valid;
 
-		line_length = line.length();
 		line_count++;
 
-		if(line_length < 1 || line[0] == '#' || line[0] == '\r' || line[0] == '\n')
+		if(line_length < 1 || line[0] == '#' || line[0] == '\r')
 			continue;	// skip blank lines and comments
 
 		valid = true;
-		if(line_length < 1)
-			valid = false;
-		else
+		if(isKeyword(line, "mtllib"))
+			valid = readMaterialLibrary(line.substr(7), r_logstream);
+		else if(isKeyword(line, "usemtl"))
+			valid = readMaterial(line.substr(7), r_logstream);
+		else if(isKeyword(line, "v"))
+			valid = readVertex(line.substr(2), r_logstream);
+		else if(isKeyword(line, "vt"))
+			valid = readTextureCoordinates(line.substr(3), r_logstream);
+		else if(isKeyword(line, "vn"))
+			valid = readNormal(line.substr(3), r_logstream);
+		else if(isKeyword(line, "p"))
+			valid = readPointSet(line.substr(2), r_logstream);
+		else if(isKeyword(line, "l"))
+			valid = readPolyline(line.substr(2), r_logstream);
+		else if(isKeyword(line, "f"))
+			valid = readFace(line.substr(2), r_logstream);
+		else if(line[0] == 'g' && (line.length() == 1 || isWhitespace(line[1])))
 		{
-			line = whitespaceToSpaces(line);
-
-			if(startsWith(line, "mtllib "))
-				valid = readMaterialLibrary(line.substr(7), r_logstream);
-			else if(startsWith(line, "usemtl "))
-				valid = readMaterial(line.substr(7), r_logstream);
-			else if(startsWith(line, "v "))
-				valid = readVertex(line.substr(2), r_logstream);
-			else if(startsWith(line, "vt "))
-				valid = readTextureCoordinates(line.substr(3), r_logstream);
-			else if(startsWith(line, "vn "))
-				valid = readNormal(line.substr(3), r_logstream);
-			else if(startsWith(line, "p "))
-				valid = readPointSet(line.substr(2), r_logstream);
-			else if(startsWith(line, "l "))
-				valid = readPolyline(line.substr(2), r_logstream);
-			else if(startsWith(line, "f "))
-				valid = readFace(line.substr(2), r_logstream);
-			else if(line[0] == 'g' && (line.length() == 1 || isspace(line[1])))
-			{
-				if(DEBUGGING_LOAD)
-					r_logstream << "In file \"" << filename << "\": ignoring groupings \"" << line.substr(1) << "\"" << endl;
-			}
-			else if(line[0] == 's' && (line.length() == 1 || isspace(line[1])))
-			{
-				if(DEBUGGING_LOAD)
-					r_logstream << "In file \"" << filename << "\": ignoring smoothing group \"" << line.substr(1) << "\"" << endl;
-			}
-			else if(line[0] == 'o' && (line.length() == 1 || isspace(line[1])))
-			{
-				if(DEBUGGING_LOAD)
-					r_logstream << "In file \"" << filename << "\": ignoring object name \"" << line.substr(1) << "\"" << endl;
-			}
-			else
-				valid = false;
+			if(DEBUGGING_LOAD)
+				r_logstream << "In file \"" << filename << "\": ignoring groupings \"" << line.substr(1) << "\"" << endl;
+		}
+		else if(line[0] == 's' && (line.length() == 1 || isWhitespace(line[1])))
+		{
+			if(DEBUGGING_LOAD)
+				r_logstream << "In file \"" << filename << "\": ignoring smoothing group \"" << line.substr(1) << "\"" << endl;
 		}
+		else if(line[0] == 'o' && (line.length() == 1 || isWhitespace(line[1])))
+		{
+			if(DEBUGGING_LOAD)
+				r_logstream << "In file \"" << filename << "\": ignoring object name \"" << line.substr(1) << "\"" << endl;
+		}
+		else
+			valid = false;
 
 		if(!valid)
-			r_logstream << "Line " << setw(6) << line_count << " of file \"" << filename << "\" is invalid: \"" << line << "\"" << endl;
+			r_logstream << "Line " << setw(6) << line_count << " of file \"" << filename << "\" is invalid: \"" << whitespaceToSpaces(string(line)) << "\"" << endl;
 	}
 
 	input_file.close();
@@ -3947,25 +4059,15 @@ unsigned int ObjModel :: getVertexArrangementTotalCount (const VertexArrangement
 
 
 
-bool ObjModel :: readMaterialLibrary (const string& str, ostream& r_logstream)
+bool ObjModel :: readMaterialLibrary (string_view str, ostream& r_logstream)
 {
-	string::size_type start_index;
-
-	if(isspace(str[0]))
-		start_index = nextToken(str, 0);
-	else
-		start_index = 0;
+	string_view token = popToken(str);
+	if(token.empty())
+		return false;
 
-	for(string::size_type token_index = start_index; token_index != string::npos; token_index = nextToken(str, token_index))
+	for( ; !token.empty(); token = popToken(str))
 	{
-		string library;
-
-		size_t token_length = getTokenLength(str, token_index);
-
-		if(token_length == 0)
-			return false;
-
-		library = str.substr(token_index, token_length);
+		string library(token);
 
 		//
 		//  Should we add on the current file path? <|>
@@ -3992,115 +4094,76 @@ bool ObjModel :: readMaterialLibrary (const string& str, ostream& r_logstream)
 	return true;
 }
 
-bool ObjModel :: readMaterial (const string& str, ostream& r_logstream)
+bool ObjModel :: readMaterial (string_view str, ostream& r_logstream)
 {
-	string material;
+	string material(popToken(str));
 	unsigned int mesh_index;
 
-	size_t length;
-	size_t start_index;
-	size_t end_index;
-
-	if(isspace(str[0]))
-		start_index = nextToken(str, 0);
-	else
-		start_index = 0;
-
-	length = str.length();
-	for(end_index = start_index; end_index < length && !isspace(str[end_index]); end_index++)
-		; // do nothing
-
-	if(end_index < length)
-		material = str.substr(start_index, end_index - start_index);
-	else
-		material = str.substr(start_index);
-
 	mesh_index = addMesh();
 	setMeshMaterial(mesh_index, material);
 	return true;
 }
 
-bool ObjModel :: readVertex (const string& str, ostream& r_logstream)
+bool ObjModel :: readVertex (string_view str, ostream& r_logstream)
 {
 	double x;
 	double y;
 	double z;
 
-	size_t index;
-
-	if(isspace(str[0]))
-		index = nextToken(str, 0);
-	else
-		index = 0;
-
-	x = atof(str.c_str() + index);
+	x = parseDouble(popToken(str));
 
-	index = nextToken(str, index);
-	if(index == string::npos)
+	string_view token = popToken(str);
+	if(token.empty())
 		return false;
 
-	y = atof(str.c_str() + index);
+	y = parseDouble(token);
 
-	index = nextToken(str, index);
-	if(index == string::npos)
+	token = popToken(str);
+	if(token.empty())
 		return false;
 
-	z = atof(str.c_str() + index);
+	z = parseDouble(token);
 
 	addVertex(x, y, z);
 	return true;
 }
 
-bool ObjModel :: readTextureCoordinates (const string& str, ostream& r_logstream)
+bool ObjModel :: readTextureCoordinates (string_view str, ostream& r_logstream)
 {
 	double u;
 	double v;
 
-	size_t index;
-
-	if(isspace(str[0]))
-		index = nextToken(str, 0);
-	else
-		index = 0;
-
-	u = atof(str.c_str() + index);
+	u = parseDouble(popToken(str));
 
-	index = nextToken(str, index);
-	if(index == string::npos)
+	string_view token = popToken(str);
+	if(token.empty())
 		return false;
 
-	v = atof(str.c_str() + index);
+	v = parseDouble(token);
 
 	addTextureCoordinate(u, v);
 	return true;
 }
 
-bool ObjModel :: readNormal (const string& str, ostream& r_logstream)
+bool ObjModel :: readNormal (string_view str, ostream& r_logstream)
 {
 	double x;
 	double y;
 	double z;
 
-	size_t index;
-
-	if(isspace(str[0]))
-		index = nextToken(str, 0);
-	else
-		index = 0;
-
-	x = atof(str.c_str() + index);
+	x = parseDouble(popToken(str));
 
-	index = nextToken(str, index);
-	if(index == string::npos)
+	string_view token = popToken(str);
+	if(token.empty())
 		return false;
 
-	y = atof(str.c_str() + index);
+	y = parseDouble(token);
 
-	index = nextToken(str, index);
-	if(index == string::npos)
+	token = popToken(str);
+	if(token.empty())
 		return false;
 
-	z = atof(str.c_str() + index);
+	z = parseDouble(token);
 
 	if(x == 0.0 && y == 0.0 && z == 0.0)
 	{
@@ -4112,30 +4175,23 @@ bool ObjModel :: readNormal (const string& str, ostream& r_logstream)
 	return true;
 }
 
-bool ObjModel :: readPointSet (const string& str, ostream& r_logstream)
+bool ObjModel :: readPointSet (string_view str, ostream& r_logstream)
 {
 	const unsigned int NO_POINT_SET = ~0u;
 
 	unsigned int point_set_index = NO_POINT_SET;
 	unsigned int mesh_index;
 
-	string::size_type start_index;
-
-	if(isspace(str[0]))
-		start_index = nextToken(str, 0);
-	else
-		start_index = 0;
-
 	if(mv_meshes.empty())
 		mesh_index = addMesh();
 	else
 		mesh_index = mv_meshes.size() - 1;
 
-	for(string::size_type token_index = start_index; token_index != string::npos; token_index = nextToken(str, token_index))
+	for(string_view token = popToken(str); !token.empty(); token = popToken(str))
 	{
 		int vertex;
 
-		vertex = atoi(str.c_str() + token_index);
+		vertex = parseInt(token);
 		if(vertex < 0)
 			vertex += getVertexCount() + 1;
 		if(vertex <= 0)
@@ -4159,7 +4215,7 @@ bool ObjModel :: readPointSet (const string& str, ostream& r_logstream)
 	return true;
 }
 
-bool ObjModel :: readPolyline (const string& str, ostream& r_logstream)
+bool ObjModel :: readPolyline (string_view str, ostream& r_logstream)
 {
 	//
 	//  This function reads a polyline of vertexes in the
@@ -4171,28 +4227,17 @@ bool ObjModel :: readPolyline (const string& str, ostream& r_logstream)
 	unsigned int polyline_index = NO_LINE;
 	unsigned int mesh_index;
 
-	string::size_type start_index;
-
-	if(isspace(str[0]))
-		start_index = nextToken(str, 0);
-	else
-		start_index = 0;
-
 	if(mv_meshes.empty())
 		mesh_index = addMesh();
 	else
 		mesh_index = mv_meshes.size() - 1;
 
-	for(string::size_type token_index = start_index; token_index != string::npos; token_index = nextToken(str, token_index))
+	for(string_view token = popToken(str); !token.empty(); token = popToken(str))
 	{
-		size_t number_index;
-
 		int vertex;
 		int texture_coordinates;
 
-		number_index = token_index;
-
-		vertex = atoi(str.c_str() + number_index);
+		vertex = parseInt(token);
 		if(vertex < 0)
 			vertex += getVertexCount() + 1;
 		if(vertex <= 0)
@@ -4202,25 +4247,18 @@ bool ObjModel :: readPolyline (const string& str, ostream& r_logstream)
 			return false;
 		}
 
-		number_index = nextSlashInToken(str, number_index);
-		if(number_index == string::npos)
+		size_t slash_index = token.find('/');
+		if(slash_index == string_view::npos || slash_index + 1 == token.size())
 		{
 			texture_coordinates = NO_TEXTURE_COORDINATES;
 		}
 		else
 		{
-			number_index++;
-
-			if(isspace(str[number_index]))
-				texture_coordinates = NO_TEXTURE_COORDINATES;
-			else
-			{
-				texture_coordinates = atoi(str.c_str() + number_index);
-				if(texture_coordinates < 0)
-					texture_coordinates += getTextureCoordinateCount() + 1;
-				if(texture_coordinates <= 0)
-					return false;
-			}
+			texture_coordinates = parseInt(token.substr(slash_index + 1));
+			if(texture_coordinates < 0)
+				texture_coordinates += getTextureCoordinateCount() + 1;
+			if(texture_coordinates <= 0)
+				return false;
 		}
 
 		if(polyline_index == NO_LINE)
@@ -4243,36 +4281,25 @@ bool ObjModel :: readPolyline (const string& str, ostream& r_logstream)
 	return true;
 }
 
-bool ObjModel :: readFace (const string& str, ostream& r_logstream)
+bool ObjModel :: readFace (string_view str, ostream& r_logstream)
 {
 	const unsigned int NO_FACE = ~0u;
 
 	unsigned int face_index = NO_FACE;
 	unsigned int mesh_index;
 
-	string::size_type start_index;
-
-	if(isspace(str[0]))
-		start_index = nextToken(str, 0);
-	else
-		start_index = 0;
-
 	if(mv_meshes.empty())
 		mesh_index = addMesh();
 	else
 		mesh_index = mv_meshes.size() - 1;
 
-	for(string::size_type token_index = start_index; token_index != string::npos; token_index = nextToken(str, token_index))
+	for(string_view token = popToken(str); !token.empty(); token = popToken(str))
 	{
-		size_t number_index;
-
 		int vertex;
 		int texture_coordinates;
 		int normal;
 
-		number_index = token_index;
-
-		vertex = atoi(str.c_str() + number_index);
+		vertex = parseInt(token);
 		if(vertex < 0)
 			vertex += getVertexCount() + 1;
 		if(vertex <= 0)
@@ -4282,44 +4309,37 @@ bool ObjModel :: readFace (const string& str, ostream& r_logstream)
 			return false;
 		}
 
-		number_index = nextSlashInToken(str, number_index);
-		if(number_index == string::npos)
+		size_t slash_index = token.find('/');
+		if(slash_index == string_view::npos)
 		{
 			texture_coordinates = NO_TEXTURE_COORDINATES;
 			normal = NO_NORMAL;
 		}
 		else
 		{
-			number_index++;
+			string_view rest = token.substr(slash_index + 1);
 
-			if(str[number_index] == '/')
+			if(!rest.empty() && rest[0] == '/')
 				texture_coordinates = NO_TEXTURE_COORDINATES;
 			else
 			{
-				texture_coordinates = atoi(str.c_str() + number_index);
+				texture_coordinates = parseInt(rest);
 				if(texture_coordinates < 0)
 					texture_coordinates += getTextureCoordinateCount() + 1;
 				if(texture_coordinates <= 0)
 					return false;
 			}
 
-			number_index = nextSlashInToken(str, number_index);
-			if(number_index == string::npos)
+			slash_index = rest.find('/');
+			if(slash_index == string_view::npos || slash_index + 1 == rest.size())
 				normal = NO_NORMAL;
 			else
 			{
-				number_index++;
-
-				if(isspace(str[number_index]))
-					normal = NO_NORMAL;
-				else
-				{
-					normal = atoi(str.c_str() + number_index);
-					if(normal < 0)
-						normal += getNormalCount() + 1;
-					if(normal <= 0)
-						return false;
-				}
+				normal = parseInt(rest.substr(slash_index + 1));
+				if(normal < 0)
+					normal += getNormalCount() + 1;
+				if(normal <= 0)
+					return false;
 			}
 		}
 
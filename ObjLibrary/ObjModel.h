@@ -24,6 +24,7 @@
 #define OBJ_LIBRARY_OBJ_MODEL_H
 
 #include <string>
+#include <string_view>
 #include <vector>
 
 #include "ObjSettings.h"
@@ -1999,7 +2000,9 @@ public:
 //               logging stream is specified, any loading errors
 //               are written to that file or stream.  Otherwise,
 //               any loading errors are written to the standard
-//               error stream.
+//               error stream.  The file is memory-mapped and
+//               parsed in a single pass without copying each
+//               line.
 //
 	void load (const std::string& filename);
 	void load (const std::string& filename,
@@ -3511,8 +3514,8 @@ private:
 //               when searching for a material.  Otherwise,
 //               there is no effect.
 //
-	bool readMaterialLibrary (const std::string& str,
-	                          std::ostream& r_logstream);
+	bool readMaterialLibrary (std::string_view str,
+	                        std::ostream& r_logstream);
 
 //
 //  readMaterial
@@ -3528,8 +3531,8 @@ private:
 //               material is set to be the current material for
 //               this ObjModel.  Otherwise, there is no effect.
 //
-	bool readMaterial (const std::string& str,
-	                   std::ostream& r_logstream);
+	bool readMaterial (std::string_view str,
+	                 std::ostream& r_logstream);
 
 //
 //  readVertex
@@ -3545,8 +3548,8 @@ private:
 //               is added to this ObjModel.  Otherwise, there is
 //               no effect.
 //
-	bool readVertex (const std::string& str,
-	                 std::ostream& r_logstream);
+	bool readVertex (std::string_view str,
+	               std::ostream& r_logstream);
 
 //
 //  readTextureCoordinates
@@ -3565,8 +3568,8 @@ private:
 //               coordinates, that pair is added to this
 //               ObjModel.  Otherwise, there is no effect.
 //
-	bool readTextureCoordinates (const std::string& str,
-	                             std::ostream& r_logstream);
+	bool readTextureCoordinates (std::string_view str,
+	                           std::ostream& r_logstream);
 
 //
 //  readNormal
@@ -3583,8 +3586,8 @@ private:
 //               normal vector is added to this ObjModel.
 //               Otherwise, there is no effect.
 //
-	bool readNormal (const std::string& str,
-	                 std::ostream& r_logstream);
+	bool readNormal (std::string_view str,
+	               std::ostream& r_logstream);
 
 //
 //  readPointSet
@@ -3601,8 +3604,8 @@ private:
 //               is marked as invalid.  Otherwise, there is no
 //               effect.
 //
-	bool readPointSet (const std::string& str,
-	                   std::ostream& r_logstream);
+	bool readPointSet (std::string_view str,
+	                 std::ostream& r_logstream);
 
 //
 //  readPolyline
@@ -3619,8 +3622,8 @@ private:
 //               this ObjModel is marked as invalid.  Otherwise,
 //               there is no effect.
 //
-	bool readPolyline (const std::string& str,
-	                   std::ostream& r_logstream);
+	bool readPolyline (std::string_view str,
+	                 std::ostream& r_logstream);
 
 //
 //  readFace
@@ -3637,8 +3640,8 @@ private:
 //               marked as invalid.  Otherwise, there is no
 //               effect.
 //
-	bool readFace (const std::string& str,
-	               std::ostream& r_logstream);
+	bool readFace (std::string_view str,
+	             std::ostream& r_logstream);
 
 //
 //  removeLastPointSet
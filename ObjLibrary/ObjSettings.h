@@ -117,6 +117,26 @@
 
 
 
+//
+//  The original .bmp loader reads the file through a stream
+//    and converts it a pixel at a time, and mipmaps are built
+//    by gluBuild2DMipmaps (or glGenerateMipmap) when the
+//    texture is added to OpenGL.  A faster loader is also
+//    available.  It memory-maps the file, converts whole rows
+//    from BGR to RGB at once (with SSSE3 where the processor
+//    supports it), and flips the image while converting.
+//    Mipmaps for power-of-two textures are then built on the
+//    CPU, spread over several threads, so adding the texture
+//    to OpenGL is only a copy.  The fast loader rejects
+//    truncated files instead of reading past their end.
+//
+//  To use the faster .bmp loader, define the macro
+//    OBJ_LIBRARY_FAST_BMP.
+//
+#define OBJ_LIBRARY_FAST_BMP
+
+
+
 //
 //  The Vector* classes in the ObjLibrary can interface with the
 //    OpenGL Mathematics (glm) library.  The glm library
@@ -23,6 +23,8 @@
 #include <string>
 #include <fstream>
 #include <iostream>
+#include <vector>
+#include <thread>
 
 //
 //  ObjSettings.h may be #included by header file.  It is not
@@ -39,6 +41,18 @@
 	#include "../GetGlut.h"
 #endif
 
+#ifdef OBJ_LIBRARY_FAST_BMP
+	#include "MappedFile.h"
+
+	#if defined(__x86_64__) || defined(__i386__) || defined(_M_X64) || defined(_M_IX86)
+		#define OBJ_LIBRARY_FAST_BMP_SSSE3
+		#include <tmmintrin.h>
+		#ifdef _MSC_VER
+			#include <intrin.h>
+		#endif
+	#endif
+#endif
+
 using namespace std;
 using namespace ObjLibrary;
 namespace
@@ -155,6 +169,272 @@ namespace
 		return width * 3 + width % 4;
 	}
 
+	//
+	//  isPowerOfTwo
+	//
+	//  Purpose: To determine if the specified value is a power
+	//	     of two.
+	//  Parameter(s):
+	//	<1> n: The value to test
+	//  Reconditions: N/A
+	//  Returns: Whether n is a power of two.  0 is not a power
+	//	     of two.
+	//  Side Effect: N/A
+	//
+	inline bool isPowerOfTwo (unsigned int n)
+	{
+		return n != 0 && (n & (n - 1)) == 0;
+	}
+
+	//
+	//  MIPMAP_BYTES_PER_THREAD
+	//
+	//  The minimum size of a mipmap level, in bytes, for each
+	//    thread used to calculate it.  Smaller levels are not
+	//    worth starting a thread for.
+	//
+	const unsigned int MIPMAP_BYTES_PER_THREAD = 1 << 16;
+
+	//
+	//  halveRows
+	//
+	//  Purpose: To calculate some rows of a mipmap level from
+	//	     the level above it.
+	//  Parameter(s):
+	//	<1> a_source: The level above
+	//	<2> source_width
+	//	<3> source_height: The size of the level above
+	//	<4> source_bytes_per_row: The row length of the
+	//				  level above
+	//	<5> a_destination: The level to calculate
+	//	<6> width: The width of the level to calculate
+	//	<7> bytes_per_row: The row length of the level to
+	//			   calculate
+	//	<8> bytes_per_pixel: The number of colour components
+	//	<9> first_row
+	//	<10> end_row: The rows to calculate
+	//  Reconditions:
+	//	<1> a_source != NULL
+	//	<2> a_destination != NULL
+	//	<3> bytes_per_pixel == 3 || bytes_per_pixel == 4
+	//  Returns: N/A
+	//  Side Effect: Rows first_row to end_row - 1 of
+	//		 a_destination are set to the average of each
+	//		 2x2 block in a_source.  If the level above is
+	//		 only 1 pixel wide or tall, the pixel is used
+	//		 twice.
+	//
+	void halveRows (const unsigned char* a_source,
+	                unsigned int source_width,
+	                unsigned int source_height,
+	                unsigned int source_bytes_per_row,
+	                unsigned char* a_destination,
+	                unsigned int width,
+	                unsigned int bytes_per_row,
+	                unsigned int bytes_per_pixel,
+	                unsigned int first_row,
+	                unsigned int end_row)
+	{
+		assert(a_source != NULL);
+		assert(a_destination != NULL);
+		assert(bytes_per_pixel == 3 || bytes_per_pixel == 4);
+
+		unsigned int step_x = (source_width  > 1) ? bytes_per_pixel      : 0;
+		unsigned int step_y = (source_height > 1) ? source_bytes_per_row : 0;
+		unsigned int row_bytes = width * bytes_per_pixel;
+
+		for(unsigned int y = first_row; y < end_row; y++)
+		{
+			const unsigned char* a_top = a_source + (y * 2) * source_bytes_per_row;
+			const unsigned char* a_bottom = a_top + step_y;
+			unsigned char* a_out = a_destination + y * bytes_per_row;
+
+			for(unsigned int i = 0; i < row_bytes; i += bytes_per_pixel)
+			{
+				unsigned int from = ((step_x == 0) ? i : i * 2);
+				for(unsigned int c = 0; c < bytes_per_pixel; c++)
+				{
+					unsigned int sum = a_top   [from + c] + a_top   [from + step_x + c] +
+					                   a_bottom[from + c] + a_bottom[from + step_x + c];
+					a_out[i + c] = (unsigned char)((sum + 2) >> 2);
+				}
+			}
+		}
+	}
+
+#ifdef OBJ_LIBRARY_FAST_BMP
+	//
+	//  convertRowScalar
+	//
+	//  Purpose: To copy a row of BMP pixels, converting BGR to
+	//	     RGB or BGRA to RGBA with full alpha.
+	//  Parameter(s):
+	//	<1> a_source: The row in the file
+	//	<2> a_destination: The row in the texture
+	//	<3> first
+	//	<4> end: The range of bytes to convert
+	//	<5> is_alpha: Whether the pixels are 4 bytes
+	//  Reconditions:
+	//	<1> a_source != NULL
+	//	<2> a_destination != NULL
+	//	<3> (end - first) is a multiple of the pixel size
+	//  Returns: N/A
+	//  Side Effect: Bytes first to end - 1 of a_destination are
+	//		 set.
+	//
+	void convertRowScalar (const unsigned char* a_source,
+	                       unsigned char* a_destination,
+	                       unsigned int first,
+	                       unsigned int end,
+	                       bool is_alpha)
+	{
+		assert(a_source != NULL);
+		assert(a_destination != NULL);
+
+		if(is_alpha)
+		{
+			for(unsigned int i = first; i < end; i += 4)
+			{
+				a_destination[i]     = a_source[i + 2];
+				a_destination[i + 1] = a_source[i + 1];
+				a_destination[i + 2] = a_source[i];
+				a_destination[i + 3] = 0xFF;
+			}
+		}
+		else
+		{
+			for(unsigned int i = first; i < end; i += 3)
+			{
+				a_destination[i]     = a_source[i + 2];
+				a_destination[i + 1] = a_source[i + 1];
+				a_destination[i + 2] = a_source[i];
+			}
+		}
+	}
+
+#ifdef OBJ_LIBRARY_FAST_BMP_SSSE3
+	//
+	//  isSsse3
+	//
+	//  Purpose: To determine if the processor supports the
+	//	     SSSE3 instructions.
+	//  Parameter(s): N/A
+	//  Reconditions: N/A
+	//  Returns: Whether SSSE3 is available.
+	//  Side Effect: N/A
+	//
+	bool isSsse3 ()
+	{
+#ifdef _MSC_VER
+		int a_info[4];
+		__cpuid(a_info, 1);
+		return (a_info[2] & (1 << 9)) != 0;
+#else
+		return __builtin_cpu_supports("ssse3") != 0;
+#endif
+	}
+
+	const bool IS_SSSE3 = isSsse3();
+
+	//
+	//  convertRowSsse3
+	//
+	//  Purpose: To copy a row of BMP pixels, converting BGR to
+	//	     RGB or BGRA to RGBA with full alpha, 16 bytes at
+	//	     a time.
+	//  Parameter(s):
+	//	<1> a_source: The row in the file
+	//	<2> a_destination: The row in the texture
+	//	<3> row_bytes: The number of bytes of pixels in the
+	//		       row, not including padding
+	//	<4> is_alpha: Whether the pixels are 4 bytes
+	//  Reconditions:
+	//	<1> a_source != NULL
+	//	<2> a_destination != NULL
+	//	<3> IS_SSSE3
+	//  Returns: The number of bytes converted.  This is a
+	//	     multiple of the pixel size.  The rest of the row
+	//	     must be converted with convertRowScalar.
+	//  Side Effect: The converted bytes of a_destination are
+	//		 set.  No bytes past row_bytes are read or
+	//		 written.
+	//
+#ifndef _MSC_VER
+	__attribute__((target("ssse3")))
+#endif
+	unsigned int convertRowSsse3 (const unsigned char* a_source,
+	                              unsigned char* a_destination,
+	                              unsigned int row_bytes,
+	                              bool is_alpha)
+	{
+		assert(a_source != NULL);
+		assert(a_destination != NULL);
+		assert(IS_SSSE3);
+
+		unsigned int i = 0;
+		if(is_alpha)
+		{
+			const __m128i SHUFFLE = _mm_setr_epi8(2, 1, 0, 3, 6, 5, 4, 7,
+			                                      10, 9, 8, 11, 14, 13, 12, 15);
+			const __m128i ALPHA = _mm_set1_epi32((int)0xFF000000);
+			for( ; i + 16 <= row_bytes; i += 16)
+			{
+				__m128i pixels = _mm_loadu_si128((const __m128i*)(a_source + i));
+				pixels = _mm_or_si128(_mm_shuffle_epi8(pixels, SHUFFLE), ALPHA);
+				_mm_storeu_si128((__m128i*)(a_destination + i), pixels);
+			}
+		}
+		else
+		{
+			// 5 whole pixels per step; the 16th byte is rewritten next step
+			const __m128i SHUFFLE = _mm_setr_epi8(2, 1, 0, 5, 4, 3, 8, 7,
+			                                      6, 11, 10, 9, 14, 13, 12, 15);
+			for( ; i + 16 <= row_bytes; i += 15)
+			{
+				__m128i pixels = _mm_loadu_si128((const __m128i*)(a_source + i));
+				pixels = _mm_shuffle_epi8(pixels, SHUFFLE);
+				_mm_storeu_si128((__m128i*)(a_destination + i), pixels);
+			}
+		}
+		return i;
+	}
+#endif
+
+	//
+	//  convertRow
+	//
+	//  Purpose: To copy a row of BMP pixels, converting BGR to
+	//	     RGB or BGRA to RGBA with full alpha.
+	//  Parameter(s):
+	//	<1> a_source: The row in the file
+	//	<2> a_destination: The row in the texture
+	//	<3> row_bytes: The number of bytes of pixels in the
+	//		       row, not including padding
+	//	<4> is_alpha: Whether the pixels are 4 bytes
+	//  Reconditions:
+	//	<1> a_source != NULL
+	//	<2> a_destination != NULL
+	//  Returns: N/A
+	//  Side Effect: The first row_bytes bytes of a_destination
+	//		 are set.
+	//
+	void convertRow (const unsigned char* a_source,
+	                 unsigned char* a_destination,
+	                 unsigned int row_bytes,
+	                 bool is_alpha)
+	{
+		assert(a_source != NULL);
+		assert(a_destination != NULL);
+
+		unsigned int converted = 0;
+#ifdef OBJ_LIBRARY_FAST_BMP_SSSE3
+		if(IS_SSSE3)
+			converted = convertRowSsse3(a_source, a_destination, row_bytes, is_alpha);
+#endif
+		convertRowScalar(a_source, a_destination, converted, row_bytes, is_alpha);
+	}
+#endif
+
 
 
 }	// end of anonymous namespace
@@ -1005,6 +1285,7 @@ void TextureBmp :: init (unsigned int width, unsigned int height, bool is_alpha)
 	assert(md_texture == NULL);
 
 	m_is_bad = false;
+	mv_mipmaps.clear();
 	m_width = width;
 	m_height = height;
 	m_is_alpha = is_alpha;
@@ -1076,14 +1357,29 @@ void TextureBmp :: load (const string& filename, const string& logfile)
 
 void TextureBmp :: load (const string& filename, ostream& r_logstream)
 {
-	unsigned int bit_depth;
-	unsigned int header_size;
-
 	if(md_texture != NULL)
 		destroy();
 	assert(md_texture == NULL);
 
+#ifdef OBJ_LIBRARY_FAST_BMP
+	loadMapped(filename, r_logstream);
+#else
+	loadStream(filename, r_logstream);
+#endif
+
+	assert(invariant());
+}
+
+void TextureBmp :: loadStream (const string& filename,
+                               ostream& r_logstream)
+{
+	assert(md_texture == NULL);
+
+	unsigned int bit_depth;
+	unsigned int header_size;
+
 	m_is_bad = false;
+	mv_mipmaps.clear();
 
 	// Open the input file.
 	ifstream input_file(filename.c_str(), ios::in | ios::binary);
@@ -1211,8 +1507,130 @@ void TextureBmp :: load (const string& filename, ostream& r_logstream)
 	assert(invariant());
 }
 
+void TextureBmp :: loadMapped (const string& filename,
+                               ostream& r_logstream)
+{
+#ifdef OBJ_LIBRARY_FAST_BMP
+	assert(md_texture == NULL);
+
+	static const unsigned int FILE_HEADER_SIZE = 14;
+	static const unsigned int MINIMUM_HEADER_SIZE = 16;
+
+	m_is_bad = false;
+	mv_mipmaps.clear();
+
+	MappedFile file(filename);
+	if(!file.isOpen())
+	{
+		r_logstream << "Error: File \"" << filename << "\" does not exist" << endl;
+		createDefault();
+		m_is_bad = true;
+
+		assert(invariant());
+		return;
+	}
+
+	// the headers are described in loadStream
+	const unsigned char* a_data = (const unsigned char*)(file.getData());
+	size_t file_size = file.getSize();
+	if(file_size < 2 || a_data[0] != 'B' || a_data[1] != 'M')
+	{
+		r_logstream << "Error: File \"" << filename << "\" is not a bmp" << endl;
+		createDefault();
+		m_is_bad = true;
+
+		assert(invariant());
+		return;
+	}
+
+	unsigned int header_size = 0;
+	unsigned int width       = 0;
+	unsigned int height      = 0;
+	unsigned int bit_depth   = 0;
+	if(file_size >= FILE_HEADER_SIZE + MINIMUM_HEADER_SIZE)
+	{
+		const unsigned char* a_header = a_data + FILE_HEADER_SIZE;
+		header_size = a_header[0] | (a_header[1] << 8) | (a_header[2] << 16) | ((unsigned int)(a_header[3]) << 24);
+		width       = a_header[4] | (a_header[5] << 8) | (a_header[6] << 16) | ((unsigned int)(a_header[7]) << 24);
+		height      = a_header[8] | (a_header[9] << 8) | (a_header[10] << 16) | ((unsigned int)(a_header[11]) << 24);
+		bit_depth   = a_header[14] | (a_header[15] << 8);
+	}
+
+	if(bit_depth != 24 && bit_depth != 32)
+	{
+		r_logstream << "Error: File \"" << filename << "\" is not 24-bit or 32-bit" << endl;
+		createDefault();
+		m_is_bad = true;
+
+		assert(invariant());
+		return;
+	}
+
+	m_is_alpha = (bit_depth == 32);
+	unsigned int bytes_per_row;
+	if(m_is_alpha)
+		bytes_per_row = getBytesPerRowAlpha(width);
+	else
+		bytes_per_row = getBytesPerRowNoAlpha(width);
+
+	// the original loader reads past the end of a short file
+	unsigned long long pixel_start = (unsigned long long)(FILE_HEADER_SIZE) + header_size;
+	unsigned long long pixel_size  = (unsigned long long)(bytes_per_row) * height;
+	if(width == 0 || height == 0 || header_size < MINIMUM_HEADER_SIZE ||
+	   pixel_size > 0xFFFFFFFFull || pixel_start + pixel_size > file_size)
+	{
+		r_logstream << "Error: File \"" << filename << "\" is truncated or has an invalid size" << endl;
+		createDefault();
+		m_is_bad = true;
+
+		assert(invariant());
+		return;
+	}
+
+	m_width = width;
+	m_height = height;
+	m_bytes_per_row = bytes_per_row;
+	m_array_size = m_bytes_per_row * m_height;
+	md_texture = new unsigned char[m_array_size];
+
+	// BMP files store the bottom row first, so flip while converting
+	const unsigned char* a_pixels = a_data + pixel_start;
+	unsigned int row_bytes = m_width * (m_is_alpha ? 4 : 3);
+	for(unsigned int y = 0; y < m_height; y++)
+	{
+		const unsigned char* a_source = a_pixels + (m_height - 1 - y) * m_bytes_per_row;
+		unsigned char* a_destination = md_texture + y * m_bytes_per_row;
+
+		convertRow(a_source, a_destination, row_bytes, m_is_alpha);
+		for(unsigned int i = row_bytes; i < m_bytes_per_row; i++)
+			a_destination[i] = a_source[i];
+	}
+
+	assert(invariant());
+#else
+	// without the macro, MappedFile may not be available
+	loadStream(filename, r_logstream);
+#endif
+}
+
+bool TextureBmp :: isMipmapsPossible () const
+{
+	return isPowerOfTwo(m_width) && isPowerOfTwo(m_height);
+}
+
+void TextureBmp :: generateMipmaps ()
+{
+	assert(isMipmapsPossible());
+
+	calculateMipmaps(mv_mipmaps);
+
+	assert(invariant());
+}
+
 void TextureBmp :: mirrorX ()
 {
+	mv_mipmaps.clear();
+
 	for(unsigned int x1 = 0; x1 < m_width / 2; x1++)
 	{
 		unsigned int x2 = m_width - 1 - x1;
@@ -1248,6 +1666,8 @@ void TextureBmp :: mirrorX ()
 
 void TextureBmp :: mirrorY ()
 {
+	mv_mipmaps.clear();
+
 	for(unsigned int y1 = 0; y1 < m_height / 2; y1++)
 	{
 		unsigned int y2 = m_height - 1 - y1;
@@ -1291,6 +1711,8 @@ void TextureBmp :: setPixel (unsigned int x,
 	assert(y < getHeight());
 	assert(!isAlphaChannel());
 
+	mv_mipmaps.clear();
+
 	unsigned int index = y * m_bytes_per_row + x * 3;
 	assert(index + 2 < m_array_size);
 
@@ -1312,6 +1734,8 @@ void TextureBmp :: setPixel (unsigned int x,
 	assert(y < getHeight());
 	assert(isAlphaChannel());
 
+	mv_mipmaps.clear();
+
 	unsigned int index = y * m_bytes_per_row + x * 4;
 	assert(index + 3 < m_array_size);
 
@@ -1330,6 +1754,8 @@ void TextureBmp :: setPixel (unsigned int x,
 	assert(x < getWidth());
 	assert(y < getHeight());
 
+	mv_mipmaps.clear();
+
 	unsigned int index;
 
 	if(isAlphaChannel())
@@ -1438,6 +1864,19 @@ unsigned int TextureBmp :: addToOpenGL (unsigned int wrap_s,
 		else
 			glTexImage2D(GL_TEXTURE_2D, 0, GL_RGB,  m_width, m_height, 0, GL_RGB,  GL_UNSIGNED_BYTE, md_texture);
 	}
+	else if(isMipmaps())
+	{
+		// already calculated, so just copy them
+		addMipmapsToOpenGL(mv_mipmaps);
+	}
+#ifdef OBJ_LIBRARY_FAST_BMP
+	else if(isMipmapsPossible())
+	{
+		vector<unsigned char> v_mipmaps;
+		calculateMipmaps(v_mipmaps);
+		addMipmapsToOpenGL(v_mipmaps);
+	}
+#endif
 	else
 	{
 #ifndef OBJ_LIBRARY_SHADER_DISPLAY
@@ -1474,6 +1913,103 @@ unsigned int TextureBmp :: addToOpenGL (unsigned int wrap_s,
 
 
 
+void TextureBmp :: calculateMipmaps (vector<unsigned char>& r_mipmaps) const
+{
+	assert(isMipmapsPossible());
+
+	unsigned int bytes_per_pixel = m_is_alpha ? 4 : 3;
+
+	// find where each level starts
+	vector<unsigned int> v_offsets;
+	unsigned int total_size = 0;
+	for(unsigned int width = m_width, height = m_height; width > 1 || height > 1; )
+	{
+		if(width  > 1) width  /= 2;
+		if(height > 1) height /= 2;
+
+		v_offsets.push_back(total_size);
+		if(m_is_alpha)
+			total_size += getBytesPerRowAlpha(width) * height;
+		else
+			total_size += getBytesPerRowNoAlpha(width) * height;
+	}
+	r_mipmaps.resize(total_size);
+
+	unsigned int thread_limit = thread::hardware_concurrency();
+	if(thread_limit < 1)
+		thread_limit = 1;
+
+	const unsigned char* a_source = md_texture;
+	unsigned int source_width  = m_width;
+	unsigned int source_height = m_height;
+	unsigned int source_bytes_per_row = m_bytes_per_row;
+	for(unsigned int level = 0; level < v_offsets.size(); level++)
+	{
+		unsigned int width  = (source_width  > 1) ? source_width  / 2 : 1;
+		unsigned int height = (source_height > 1) ? source_height / 2 : 1;
+		unsigned int bytes_per_row = m_is_alpha ? getBytesPerRowAlpha(width)
+		                                        : getBytesPerRowNoAlpha(width);
+		unsigned char* a_destination = r_mipmaps.data() + v_offsets[level];
+
+		// each level needs the one above it, so only split within a level
+		unsigned int thread_count = (bytes_per_row * height) / MIPMAP_BYTES_PER_THREAD;
+		if(thread_count > thread_limit)
+			thread_count = thread_limit;
+		if(thread_count > height)
+			thread_count = height;
+
+		if(thread_count <= 1)
+		{
+			halveRows(a_source, source_width, source_height, source_bytes_per_row,
+			          a_destination, width, bytes_per_row, bytes_per_pixel, 0, height);
+		}
+		else
+		{
+			vector<thread> v_threads;
+			for(unsigned int t = 1; t < thread_count; t++)
+			{
+				v_threads.push_back(thread(halveRows, a_source, source_width, source_height, source_bytes_per_row,
+				                           a_destination, width, bytes_per_row, bytes_per_pixel,
+				                           height * t / thread_count, height * (t + 1) / thread_count));
+			}
+			halveRows(a_source, source_width, source_height, source_bytes_per_row,
+			          a_destination, width, bytes_per_row, bytes_per_pixel, 0, height / thread_count);
+			for(unsigned int t = 0; t < v_threads.size(); t++)
+				v_threads[t].join();
+		}
+
+		a_source = a_destination;
+		source_width  = width;
+		source_height = height;
+		source_bytes_per_row = bytes_per_row;
+	}
+}
+
+void TextureBmp :: addMipmapsToOpenGL (const vector<unsigned char>& mipmaps) const
+{
+	assert(isMipmapsPossible());
+
+	unsigned int format = m_is_alpha ? GL_RGBA : GL_RGB;
+	glTexImage2D(GL_TEXTURE_2D, 0, format, m_width, m_height, 0, format, GL_UNSIGNED_BYTE, md_texture);
+
+	unsigned int offset = 0;
+	unsigned int level = 1;
+	for(unsigned int width = m_width, height = m_height; width > 1 || height > 1; level++)
+	{
+		if(width  > 1) width  /= 2;
+		if(height > 1) height /= 2;
+
+		assert(offset < mipmaps.size());
+		glTexImage2D(GL_TEXTURE_2D, level, format, width, height, 0, format, GL_UNSIGNED_BYTE, mipmaps.data() + offset);
+
+		if(m_is_alpha)
+			offset += getBytesPerRowAlpha(width) * height;
+		else
+			offset += getBytesPerRowNoAlpha(width) * height;
+	}
+	assert(offset == mipmaps.size());
+}
+
 void TextureBmp :: createDefault ()
 {
 	assert(md_texture == NULL);
@@ -1506,6 +2042,7 @@ void TextureBmp :: copy (const TextureBmp& original)
 	md_texture = new unsigned char[m_array_size];
 	for(unsigned int i = 0; i < m_array_size; i++)
 		md_texture[i] = original.md_texture[i];
+	mv_mipmaps = original.mv_mipmaps;
 
 	assert(invariant());
 }
@@ -1516,6 +2053,7 @@ void TextureBmp :: destroy ()
 
 	delete md_texture;
 	md_texture = NULL;
+	mv_mipmaps.clear();
 
 	assert(md_texture == NULL);
 }
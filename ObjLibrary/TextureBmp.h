@@ -25,6 +25,7 @@
 
 #include <cassert>
 #include <string>
+#include <vector>
 
 // if you don't need shaders, you can remove this line
 #include "ObjSettings.h"
@@ -56,6 +57,13 @@ namespace ObjLibrary
 //    1 +--------+ 1
 //      0        1
 //
+//  A TextureBmp may also store a mipmap chain, created by
+//    generateMipmaps.  If it does, addToOpenGL copies the
+//    mipmaps instead of calculating them.  Any change made
+//    through a member function discards the mipmaps.  Changes
+//    made through the array returned by getArray do not, so
+//    call generateMipmaps again after making them.
+//
 //  Class Invariant:
 //    <1> md_texture != NULL
 //    <2> m_width > 0
@@ -676,7 +684,8 @@ public:
 //  Parameter(s): N/A
 //  Precondition(s): N/A
 //  Returns: A pointer to the array storing the texture data for
-//           this TextureBmp.
+//           this TextureBmp.  Any mipmaps are not updated if
+//           the array is changed.
 //  Side Effect: N/A
 //
 	unsigned char* getArray () const
@@ -944,6 +953,51 @@ public:
 	               unsigned int y,
 	               unsigned int rgb);
 
+//
+//  isMipmapsPossible
+//
+//  Purpose: To determine whether a mipmap chain can be
+//           generated for this TextureBmp.
+//  Parameter(s): N/A
+//  Precondition(s): N/A
+//  Returns: Whether the width and height of this TextureBmp
+//           are both powers of two.  Other sizes are rescaled
+//           by gluBuild2DMipmaps when added to OpenGL.
+//  Side Effect: N/A
+//
+	bool isMipmapsPossible () const;
+
+//
+//  isMipmaps
+//
+//  Purpose: To determine whether this TextureBmp has a mipmap
+//           chain.
+//  Parameter(s): N/A
+//  Precondition(s): N/A
+//  Returns: Whether there are mipmaps.
+//  Side Effect: N/A
+//
+	bool isMipmaps () const
+	{
+		return !mv_mipmaps.empty();
+	}
+
+//
+//  generateMipmaps
+//
+//  Purpose: To calculate the mipmap chain for this TextureBmp.
+//  Parameter(s): N/A
+//  Precondition(s):
+//    <1> isMipmapsPossible()
+//  Returns: N/A
+//  Side Effect: Every mipmap level down to 1x1 is calculated
+//               with a 2x2 box filter and stored.  Large
+//               levels are split across several threads.
+//               This function does not use OpenGL, so it may
+//               be called on any thread.
+//
+	void generateMipmaps ();
+
 //
 //  addToOpenGL
 //
@@ -987,9 +1041,14 @@ public:
 //        min_filter == GL_LINEAR_MIPMAP_LINEAR
 //  Returns: The OpenGL name for the texture.
 //  Side Effect: This texture is added to OpenGL texture memory.
-//               This TextureBmp instance is not needed to use
-//               the texture and, unless it is used elsewhere in
-//               client code, can be safely deleted.
+//               If mipmaps are needed and this TextureBmp has
+//               them, they are copied.  Otherwise, if
+//               OBJ_LIBRARY_FAST_BMP is defined and mipmaps
+//               are possible, they are calculated on the CPU
+//               first.  This TextureBmp instance is not needed
+//               to use the texture and, unless it is used
+//               elsewhere in client code, can be safely
+//               deleted.
 //
 	unsigned int addToOpenGL () const;
 	unsigned int addToOpenGL (unsigned int wrap) const;
@@ -1001,6 +1060,76 @@ public:
 	                          unsigned int min_filter) const;
 
 private:
+//
+//  Helper Function: loadStream
+//
+//  Purpose: To load this TextureBmp from the specified file
+//           by reading it through a stream.
+//  Parameter(s):
+//    <1> filename: The name of the file to load
+//    <2> r_logstream: The stream to write loading errors to
+//  Precondition(s):
+//    <1> md_texture == NULL
+//  Returns: N/A
+//  Side Effect: This TextureBmp is set to the contents of the
+//               file.  If the file cannot be loaded, this
+//               TextureBmp is set to the default texture and
+//               marked as bad.
+//
+	void loadStream (const std::string& filename,
+	                 std::ostream& r_logstream);
+
+//
+//  Helper Function: loadMapped
+//
+//  Purpose: To load this TextureBmp from the specified file
+//           by mapping it into memory.
+//  Parameter(s):
+//    <1> filename: The name of the file to load
+//    <2> r_logstream: The stream to write loading errors to
+//  Precondition(s):
+//    <1> md_texture == NULL
+//  Returns: N/A
+//  Side Effect: This TextureBmp is set to the contents of the
+//               file.  If the file cannot be loaded, this
+//               TextureBmp is set to the default texture and
+//               marked as bad.
+//
+	void loadMapped (const std::string& filename,
+	                 std::ostream& r_logstream);
+
+//
+//  Helper Function: calculateMipmaps
+//
+//  Purpose: To calculate the mipmap chain for this TextureBmp.
+//  Parameter(s):
+//    <1> r_mipmaps: The vector to store the mipmaps in
+//  Precondition(s):
+//    <1> isMipmapsPossible()
+//  Returns: N/A
+//  Side Effect: r_mipmaps is set to every mipmap level after
+//               the first, one after another, with each row
+//               padded to a multiple of 4 bytes.
+//
+	void calculateMipmaps (
+	                 std::vector<unsigned char>& r_mipmaps) const;
+
+//
+//  Helper Function: addMipmapsToOpenGL
+//
+//  Purpose: To add this TextureBmp and the specified mipmap
+//           chain to the currently bound OpenGL texture.
+//  Parameter(s):
+//    <1> mipmaps: The mipmap chain, as calculated by
+//                 calculateMipmaps
+//  Precondition(s):
+//    <1> isMipmapsPossible()
+//  Returns: N/A
+//  Side Effect: Every mipmap level is copied to OpenGL.
+//
+	void addMipmapsToOpenGL (
+	           const std::vector<unsigned char>& mipmaps) const;
+
 //
 //  Helper Function: createDefault
 //
@@ -1065,6 +1194,7 @@ private:
 	bool m_is_alpha;
 	unsigned int m_array_size;
 	unsigned char* md_texture;
+	std::vector<unsigned char> mv_mipmaps;
 };
 
 
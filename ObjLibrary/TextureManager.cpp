@@ -22,6 +22,7 @@
 #include <vector>
 #include <iostream>
 #include <fstream>
+#include <mutex>
 
 #include "ObjSettings.h"
 
@@ -58,6 +59,9 @@ namespace
 	//     supported?
 	vector<TextureData*> gvp_textures;
 
+	// guards gvp_textures; the TextureData themselves are never moved
+	mutex g_mutex;
+
 	Texture g_white;
 
 	//
@@ -120,6 +124,7 @@ namespace
 
 unsigned int TextureManager :: getCount ()
 {
+	lock_guard<mutex> lock(g_mutex);
 	return gvp_textures.size();
 }
 
@@ -136,6 +141,7 @@ const Texture& TextureManager :: get (unsigned int index)
 {
 	assert(index < getCount());
 
+	lock_guard<mutex> lock(g_mutex);
 	assert(index < gvp_textures.size());
 	assert(gvp_textures[index] != NULL);
 	return gvp_textures[index]->m_texture;
@@ -158,6 +164,7 @@ const Texture& TextureManager :: get (const string& name)
 		return getDummyTexture();
 	else
 	{
+		lock_guard<mutex> lock(g_mutex);
 		assert(index < gvp_textures.size());
 		assert(gvp_textures[index] != NULL);
 		assert(toLowercase(gvp_textures[index]->m_name) == toLowercase(name));
@@ -169,6 +176,7 @@ void TextureManager :: activate (unsigned int index)
 {
 	assert(index < getCount());
 
+	lock_guard<mutex> lock(g_mutex);
 	assert(index < gvp_textures.size());
 	assert(gvp_textures[index] != NULL);
 	gvp_textures[index]->m_texture.activate();
@@ -211,6 +219,7 @@ unsigned int TextureManager :: getIndex (const std::string& name)
 {
 	string lower = toLowercase(name);
 
+	lock_guard<mutex> lock(g_mutex);
 	for(unsigned int i = 0; i < gvp_textures.size(); i++)
 	{
 		assert(gvp_textures[i] != NULL);
@@ -261,6 +270,7 @@ unsigned int TextureManager :: add (const Texture& texture, const string& name)
 	assert(texture.isSet());
 	assert(!isLoaded(name));
 
+	lock_guard<mutex> lock(g_mutex);
 	unsigned int texture_count = gvp_textures.size();
 
 	gvp_textures.push_back(new TextureData);  //  USE INITIALIZING CONSTRUCTOR  <|>
@@ -272,6 +282,19 @@ unsigned int TextureManager :: add (const Texture& texture, const string& name)
 	return texture_count;
 }
 
+unsigned int TextureManager :: add (const TextureBmp& image, const string& name)
+{
+	assert(!image.isBad());
+	assert(!isLoaded(name));
+
+	// use the same parameters as load(name)
+#ifdef OBJ_LIBRARY_LINEAR_TEXTURE_INTERPOLATION
+	return add(image.addToOpenGL(GL_REPEAT, GL_REPEAT, GL_LINEAR, GL_LINEAR_MIPMAP_LINEAR), name);
+#else
+	return add(image.addToOpenGL(GL_REPEAT, GL_REPEAT, GL_NEAREST, GL_NEAREST_MIPMAP_NEAREST), name);
+#endif
+}
+
 
 
 unsigned int TextureManager :: load (const char* a_name)
@@ -899,6 +922,7 @@ unsigned int TextureManager :: load (const std::string& name,
 
 void TextureManager :: unloadAll ()
 {
+	lock_guard<mutex> lock(g_mutex);
 	for(unsigned int i = 0; i < gvp_textures.size(); i++)
 	{
 		assert(gvp_textures[i] != NULL);
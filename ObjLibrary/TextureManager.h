@@ -32,6 +32,7 @@ namespace ObjLibrary
 
 class Vector3;
 class Texture;
+class TextureBmp;
 
 
 
@@ -61,6 +62,15 @@ class Texture;
 //
 //  Name comparisons are always case-insensitive.
 //
+//  The list of textures is guarded by a mutex, so textures
+//    may be looked up from several threads at once.  A texture
+//    is never moved once added, so references returned remain
+//    valid until unloadAll is called.  Any function that may
+//    load a texture uses OpenGL and must only be called from
+//    the thread that owns the OpenGL context.  To decode an
+//    image on another thread, construct a TextureBmp there and
+//    pass it to add on the OpenGL thread.
+//
 namespace TextureManager
 {
 
@@ -371,6 +381,26 @@ unsigned int add (const Texture& texture,
 unsigned int add (const Texture& texture,
                   const std::string& name);
 
+//
+//  add
+//
+//  Purpose: To add the specified decoded image to OpenGL and
+//           to the texture manager with the specified name.
+//  Parameter(s):
+//    <1> image: The decoded image
+//    <2> name: The name of the texture
+//  Precondition(s):
+//    <1> !image.isBad()
+//    <2> !isLoaded(name)
+//  Returns: The index that the texture was added at.
+//  Side Effect: image is added to OpenGL texture memory with
+//               the same parameters load(name) would use and
+//               added to the texture manager under the name
+//               name.
+//
+unsigned int add (const TextureBmp& image,
+                  const std::string& name);
+
 //
 //  load
 //
@@ -0,0 +1,139 @@
+//
+//  ParallelFor.cpp
+//
+
+#include <cassert>
+#include <algorithm>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "ParallelFor.h"
+
+using namespace std;
+namespace
+{
+	//
+	//  Job
+	//
+	//  A job that worker threads may help with, how many more
+	//    of them may still start it, and how many are running it
+	//    now.
+	//
+	struct Job
+	{
+		const function<void ()>* mp_function;
+		unsigned int m_worker_slots;
+		unsigned int m_worker_active;
+	};
+
+	//
+	//  WorkerPool
+	//
+	//  The worker threads and the jobs waiting for them.  The
+	//    workers are stopped when the program ends.
+	//
+	struct WorkerPool
+	{
+		mutex m_mutex;
+		condition_variable m_job_added;
+		condition_variable m_job_finished;
+		deque<Job*> m_jobs;
+		vector<thread> mv_workers;
+		bool m_is_stopping = false;
+
+		~WorkerPool ()
+		{
+			{
+				lock_guard<mutex> lock(m_mutex);
+				m_is_stopping = true;
+			}
+			m_job_added.notify_all();
+			for(unsigned int w = 0; w < mv_workers.size(); w++)
+				mv_workers[w].join();
+		}
+	};
+
+	WorkerPool g_pool;
+
+
+
+	//
+	//  runWorker
+	//
+	//  Purpose: To run jobs from the WorkerPool until it is
+	//           stopped.
+	//  Parameter(s): N/A
+	//  Precondition(s): N/A
+	//  Returns: N/A
+	//  Side Effect: Jobs are taken from the WorkerPool and run.
+	//
+	void runWorker ()
+	{
+		unique_lock<mutex> lock(g_pool.m_mutex);
+		while(true)  // loop returns below
+		{
+			g_pool.m_job_added.wait(lock, [] ()
+			{
+				return g_pool.m_is_stopping || !g_pool.m_jobs.empty();
+			});
+			if(g_pool.m_is_stopping)
+				return;
+
+			Job* p_job = g_pool.m_jobs.front();
+			assert(p_job != nullptr);
+			assert(p_job->m_worker_slots > 0);
+			p_job->m_worker_slots--;
+			p_job->m_worker_active++;
+			if(p_job->m_worker_slots == 0)
+				g_pool.m_jobs.pop_front();
+
+			lock.unlock();
+			(*p_job->mp_function)();
+			lock.lock();
+
+			assert(p_job->m_worker_active > 0);
+			p_job->m_worker_active--;
+			if(p_job->m_worker_active == 0)
+				g_pool.m_job_finished.notify_all();
+		}
+	}
+
+}  // end of anonymous namespace
+
+
+
+void runOnWorkers (const function<void ()>& job,
+                   unsigned int worker_max)
+{
+	if(worker_max == 0)
+	{
+		job();
+		return;
+	}
+
+	Job pooled = { &job, worker_max, 0 };
+	{
+		lock_guard<mutex> lock(g_pool.m_mutex);
+		while(g_pool.mv_workers.size() < worker_max)
+			g_pool.mv_workers.push_back(thread(runWorker));
+		g_pool.m_jobs.push_back(&pooled);
+	}
+	g_pool.m_job_added.notify_all();
+
+	job();
+
+	// the caller's copy only returns when nothing is left to
+	//   start, so no more workers need to join
+	unique_lock<mutex> lock(g_pool.m_mutex);
+	deque<Job*>::iterator it = find(g_pool.m_jobs.begin(), g_pool.m_jobs.end(), &pooled);
+	if(it != g_pool.m_jobs.end())
+		g_pool.m_jobs.erase(it);
+	g_pool.m_job_finished.wait(lock, [&pooled] ()
+	{
+		return pooled.m_worker_active == 0;
+	});
+}
@@ -0,0 +1,113 @@
+//
+//  ParallelFor.h
+//
+//  A module to run the iterations of a loop on several threads.
+//
+//  The loops share one pool of worker threads, which are
+//    started the first time they are needed and then kept until
+//    the program ends, so a loop does not create any threads.
+//    Any number of threads may run loops at once, including
+//    from inside another loop.  The thread that runs a loop
+//    always works on it too, and a worker only helps with one
+//    loop at a time, so a loop started while every worker is
+//    busy simply runs on the calling thread.
+//
+
+#ifndef PARALLEL_FOR_H
+#define PARALLEL_FOR_H
+
+#include <cassert>
+#include <atomic>
+#include <functional>
+#include <thread>
+
+
+
+//
+//  runOnWorkers
+//
+//  Purpose: To run the specified job on the calling thread and
+//           on up to the specified number of worker threads at
+//           the same time.
+//  Parameter(s):
+//    <1> job: The function to run
+//    <2> worker_max: The most worker threads to run job on
+//  Precondition(s):
+//    <1> job can safely be run on several threads at once
+//    <2> job returns once there is nothing left for any copy of
+//        it to start
+//  Returns: N/A
+//  Side Effect: job is run once on the calling thread and once
+//               on each idle worker thread, up to worker_max of
+//               them.  If there are fewer than worker_max worker
+//               threads, more are started.  This function does
+//               not return until every copy of job has
+//               returned.
+//
+void runOnWorkers (const std::function<void ()>& job,
+                   unsigned int worker_max);
+
+
+
+//
+//  parallelFor
+//
+//  Purpose: To call the specified function once for each index
+//           in the specified range, using all available
+//           hardware threads.
+//  Parameter(s):
+//    <1> begin: The first index
+//    <2> end: One past the last index
+//    <3> function: The function to call; it must accept an
+//                  unsigned int index
+//    <4> thread_max: The most threads to use, including the
+//                    calling thread, or 0 for one per hardware
+//                    thread
+//  Precondition(s):
+//    <1> begin <= end
+//    <2> function can safely be called concurrently for
+//        different indexes
+//  Returns: N/A
+//  Side Effect: function is called once for each index in
+//               [begin, end).  The indexes are handed out in
+//               order, but may finish in any order.  This
+//               function does not return until every call has
+//               finished.  No threads are created unless the
+//               worker pool is smaller than thread_max.
+//
+template <typename Function>
+void parallelFor (unsigned int begin,
+                  unsigned int end,
+                  const Function& function,
+                  unsigned int thread_max = 0)
+{
+	assert(begin <= end);
+
+	unsigned int count        = end - begin;
+	unsigned int thread_count = std::thread::hardware_concurrency();
+	if(thread_max != 0 && thread_count > thread_max)
+		thread_count = thread_max;
+	if(thread_count > count)
+		thread_count = count;
+
+	if(thread_count <= 1)
+	{
+		for(unsigned int i = begin; i < end; i++)
+			function(i);
+		return;
+	}
+
+	std::atomic<unsigned int> next(begin);
+	auto worker = [&] ()
+	{
+		for(unsigned int i = next++; i < end; i = next++)
+			function(i);
+	};
+
+	// the calling thread does some of the work too
+	runOnWorkers(worker, thread_count - 1);
+}
+
+
+
+#endif
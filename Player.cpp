@@ -5,8 +5,8 @@
 #include <string>
 #include <iostream>
 #include <sstream>
+#include <vector>
 
-#include "GetGlut.h"
 #include "Pi.h"
 #include "ObjLibrary/Vector3.h"
 #include "ObjLibrary/ObjModel.h"
@@ -17,6 +17,12 @@
 #include "Heightmap.h"
 #include "Disk.h"
 #include "World.h"
+#include "Renderer.h"
+#include "AnimationModel.h"
+#include "AssetLoader.h"
+#include "LodView.h"
+#include "LodModel.h"
+#include "GameCheckpoint.h"
 #include "Player.h"
 
 using namespace std;
@@ -35,10 +41,14 @@ namespace
 	const string MODEL_NAME = "cbabe";
 	//const string MODEL_NAME = "guard";
 	const bool IS_LOAD_ANIMATION = true;
+	const bool IS_QUANTIZE_ANIMATION = true;
+	const bool IS_BLEND_ANIMATION = true;
 	const unsigned int RUN_FRAME_COUNT = 20;
-	DisplayList g_stand_list;
-	DisplayList g_jump_list;
-	DisplayList ga_run_list[RUN_FRAME_COUNT];
+	LodModel g_stand_model;
+	LodModel g_jump_model;
+
+	// the run frames share everything but their positions
+	AnimationModel g_run_animation;
 
 	const unsigned int RUN_COUNTER_MAX = 2;
 	const float RUN_FRAMES_FORWARD_PER_SECOND  = 20.0f;
@@ -59,34 +69,31 @@ const float Player :: DEAD_Y      = -100.0f;
 
 bool Player :: isModelsLoaded ()
 {
-	assert(g_jump_list.isReady() == g_stand_list.isReady());
-	for(unsigned int i = 0; i < RUN_FRAME_COUNT; i++)
-		assert(ga_run_list[i].isReady() == g_stand_list.isReady());
+	assert(g_jump_model.isReady() == g_stand_model.isReady());
+	assert(g_run_animation.isEmpty() != g_stand_model.isReady());
 
-	return g_stand_list.isReady();
+	return g_stand_model.isReady();
 }
 
-void Player :: loadModels ()
+void Player :: loadModels (AssetLoader& r_loader)
 {
 	assert(!isModelsLoaded());
 
-	g_stand_list = ObjModel("Models/" + MODEL_NAME + "_stand.obj").getDisplayList();
-	g_jump_list  = ObjModel("Models/" + MODEL_NAME + "_jump.obj" ).getDisplayList();
-	for(unsigned int i = 0; i < RUN_FRAME_COUNT; i++)
+	r_loader.addLodModel("Models/" + MODEL_NAME + "_stand.obj", g_stand_model);
+	r_loader.addLodModel("Models/" + MODEL_NAME + "_jump.obj",  g_jump_model);
+
+	// without the animation, the first frame is used for all of them
+	vector<string> v_run_filenames;
+	for(unsigned int i = 0; i < (IS_LOAD_ANIMATION ? RUN_FRAME_COUNT : 1); i++)
 	{
-		if(IS_LOAD_ANIMATION || i == 0)
-		{
-			stringstream ss;
-			ss << "Models/" << MODEL_NAME << "_run" << i << ".obj";
-			ga_run_list[i] = ObjModel(ss.str()).getDisplayList();
-		}
-		else
-		{
-			assert(i > 0);
-			assert(ga_run_list[0].isReady());
-			ga_run_list[i] = ga_run_list[0];
-		}
+		stringstream ss;
+		ss << "Models/" << MODEL_NAME << "_run" << i << ".obj";
+		v_run_filenames.push_back(ss.str());
 	}
+	r_loader.addAnimation(v_run_filenames, IS_QUANTIZE_ANIMATION, [] (const AnimationModel& model)
+	{
+		g_run_animation = model;
+	});
 
 	if(IS_CALCULATE_HALF_HEIGHT)
 	{
@@ -97,8 +104,6 @@ void Player :: loadModels ()
 				y_min = stand.getVertexY(v);
 		cout << "Half height: " << y_min << endl;
 	}
-
-	assert(isModelsLoaded());
 }
 
 
@@ -152,17 +157,23 @@ bool Player :: isDead () const
 	return m_position.y <= DEAD_Y;
 }
 
-void Player :: draw () const
+void Player :: draw (Renderer& r_renderer, const LodView& view) const
 {
 	assert(isModelsLoaded());
 
-	glPushMatrix();
+	// the model is centered on the position
+	static const float MODEL_RADIUS = HALF_HEIGHT;
+
+	r_renderer.pushMatrix();
 		float rotation = (float)(radiansToDegrees(m_forward.getRotationY()) - 90.0);
-		glTranslated(m_position.x, m_position.y, m_position.z);
-		glRotated(rotation, 0.0, 1.0, 0.0);
+		r_renderer.translate(m_position.x, m_position.y, m_position.z);
+		r_renderer.rotate(rotation, 0.0, 1.0, 0.0);
 
 		if(m_is_jumping)
-			g_jump_list.draw();
+		{
+			unsigned int level = g_jump_model.chooseLevel(view, m_position, MODEL_RADIUS);
+			r_renderer.drawDisplayList(g_jump_model.getDisplayList(level), g_jump_model.getVertexCount(level));
+		}
 		else if(m_run_counter > 0)
 		{
 			double run_frame_fraction = fmod(m_run_frame, RUN_FRAME_COUNT);
@@ -172,11 +183,32 @@ void Player :: draw () const
 			assert(run_frame_fraction <  RUN_FRAME_COUNT);
 			unsigned int run_frame_int = (unsigned int)(run_frame_fraction);
 			assert(run_frame_int <  RUN_FRAME_COUNT);
-			ga_run_list[run_frame_int].draw();
+
+			unsigned int frame_count = g_run_animation.getFrameCount();
+			unsigned int frame0 = run_frame_int % frame_count;
+			unsigned int frame1 = (run_frame_int + 1) % frame_count;
+			float blend = IS_BLEND_ANIMATION ? (float)(run_frame_fraction - run_frame_int) : 0.0f;
+			unsigned int level = g_run_animation.chooseLevel(frame0, view, m_position, MODEL_RADIUS);
+			r_renderer.drawAnimation(g_run_animation, frame0, frame1, blend, level);
 		}
 		else
-			g_stand_list.draw();
-	glPopMatrix();
+		{
+			unsigned int level = g_stand_model.chooseLevel(view, m_position, MODEL_RADIUS);
+			r_renderer.drawDisplayList(g_stand_model.getDisplayList(level), g_stand_model.getVertexCount(level));
+		}
+	r_renderer.popMatrix();
+}
+
+void Player :: saveCheckpoint (GameCheckpoint& r_checkpoint) const
+{
+	assert(!r_checkpoint.isEmpty());
+
+	r_checkpoint.writeVector3 (m_position);
+	r_checkpoint.writeVector3 (m_velocity);
+	r_checkpoint.writeVector3 (m_forward);
+	r_checkpoint.writeBool    (m_is_jumping);
+	r_checkpoint.writeUnsigned(m_run_counter);
+	r_checkpoint.writeFloat   (m_run_frame);
 }
 
 
@@ -277,6 +309,40 @@ void Player :: turnLeft (float radians_per_second)
 	assert(invariant());
 }
 
+void Player :: interpolatePose (const Player& previous, float fraction)
+{
+	assert(fraction >= 0.0f);
+	assert(fraction <= 1.0f);
+
+	m_position = previous.m_position + (m_position - previous.m_position) * fraction;
+
+	// turn the short way round, keeping the forward vector normalized
+	double turn = m_forward.getRotationY() - previous.m_forward.getRotationY();
+	if(turn > PI)
+		turn -= TWO_PI;
+	else if(turn < -PI)
+		turn += TWO_PI;
+	m_forward = previous.m_forward.getRotatedY(turn * fraction);
+
+	if(m_run_counter > 0 && previous.m_run_counter > 0)
+		m_run_frame = previous.m_run_frame + (m_run_frame - previous.m_run_frame) * fraction;
+
+	assert(invariant());
+}
+
+void Player :: restoreCheckpoint (const GameCheckpoint& checkpoint,
+                                  size_t& r_offset)
+{
+	m_position    = checkpoint.readVector3 (r_offset);
+	m_velocity    = checkpoint.readVector3 (r_offset);
+	m_forward     = checkpoint.readVector3 (r_offset);
+	m_is_jumping  = checkpoint.readBool    (r_offset);
+	m_run_counter = checkpoint.readUnsigned(r_offset);
+	m_run_frame   = checkpoint.readFloat   (r_offset);
+
+	assert(invariant());
+}
+
 void Player :: doJump ()
 {
 	assert(!isJumping());
@@ -7,9 +7,16 @@
 #ifndef PLAYER_H
 #define PLAYER_H
 
+#include <cstddef>
+
 #include "ObjLibrary/Vector3.h"
 
+#include "Renderer.h"
+
 class World;
+class GameCheckpoint;
+class AssetLoader;
+class LodView;
 
 
 
@@ -61,14 +68,18 @@ public:
 	//
 	//  Class Function: loadModels
 	//
-	//  Purpose: To load the models for the Player class.
-	//  Parameter(s): N/A
+	//  Purpose: To queue the models for the Player class to be
+	//           loaded.
+	//  Parameter(s):
+	//    <1> r_loader: The AssetLoader to load the models with
 	//  Precondition(s):
 	//    <1> !isModelsLoaded()
-	//  Returns: The Player is initialized.
-	//  Side Effect: N/A
+	//  Returns: N/A
+	//  Side Effect: The models are queued in r_loader.  The
+	//               Player class is initialized when
+	//               r_loader.finish() returns.
 	//
-	static void loadModels ();
+	static void loadModels (AssetLoader& r_loader);
 
 public:
 	//
@@ -166,13 +177,30 @@ public:
 	//  draw
 	//
 	//  Purpose: To display this Player.
-	//  Parameter(s): N/A
+	//  Parameter(s):
+	//    <1> r_renderer: The Renderer to draw with
+	//    <2> view: The camera information used to choose the
+	//              level of detail
 	//  Precondition(s):
 	//    <1> isModelsLoaded()
 	//  Returns: N/A
 	//  Side Effect: This Player is displayed.
 	//
-	void draw () const;
+	void draw (Renderer& r_renderer, const LodView& view) const;
+
+	//
+	//  saveCheckpoint
+	//
+	//  Purpose: To save the state of this Player.
+	//  Parameter(s):
+	//    <1> r_checkpoint: The GameCheckpoint to save to
+	//  Precondition(s):
+	//    <1> !r_checkpoint.isEmpty()
+	//  Returns: N/A
+	//  Side Effect: The state of this Player is written to the
+	//               end of r_checkpoint.
+	//
+	void saveCheckpoint (GameCheckpoint& r_checkpoint) const;
 
 	//
 	//  init
@@ -280,6 +308,48 @@ public:
 	//
 	void markRunning (bool is_forward);
 
+	//
+	//  interpolatePose
+	//
+	//  Purpose: To move this Player part of the way back to the
+	//           pose of the specified earlier Player, so it can
+	//           be drawn between physics frames.
+	//  Parameter(s):
+	//    <1> previous: This Player one or more frames earlier
+	//    <2> fraction: How far to place this Player from
+	//                  previous towards its current pose
+	//  Precondition(s):
+	//    <1> fraction >= 0.0f
+	//    <2> fraction <= 1.0f
+	//  Returns: N/A
+	//  Side Effect: The position, facing, and run animation of
+	//               this Player are set between those of
+	//               previous and this Player.  If fraction is
+	//               0.0f, they match previous, and if it is
+	//               1.0f, they are unchanged.  The velocity and
+	//               whether this Player is jumping are not
+	//               changed.
+	//
+	void interpolatePose (const Player& previous, float fraction);
+
+	//
+	//  restoreCheckpoint
+	//
+	//  Purpose: To return this Player to a saved state.
+	//  Parameter(s):
+	//    <1> checkpoint: The GameCheckpoint to restore from
+	//    <2> r_offset: Where in checkpoint the state starts
+	//  Precondition(s):
+	//    <1> The state at offset r_offset was written by
+	//        saveCheckpoint
+	//  Returns: N/A
+	//  Side Effect: This Player is set to the state saved at
+	//               offset r_offset, and r_offset is advanced
+	//               past it.
+	//
+	void restoreCheckpoint (const GameCheckpoint& checkpoint,
+	                        size_t& r_offset);
+
 private:
 	//
 	//  Helper Function: moveAccordingToVelocity
@@ -0,0 +1,291 @@
+//
+//  Profiler.cpp
+//
+
+#include <cassert>
+#include <algorithm>
+#include <chrono>
+#include <iomanip>
+#include <iostream>
+#include <mutex>
+
+#include "TraceRecorder.h"
+#include "Profiler.h"
+
+using namespace std;
+using namespace Profiler;
+namespace
+{
+	//
+	//  SECTION_INFO
+	//  COUNTER_INFO
+	//
+	//  The name of each section and counter, how deeply it is
+	//    nested in other sections, the timeline it is sampled
+	//    on, and whether it is also sent to the TraceRecorder,
+	//    in the same order as the enums.  Sections that run many
+	//    times a frame are not traced, so they do not push the
+	//    rest out of the trace buffers.
+	//
+	struct SeriesInfo
+	{
+		const char* m_name;
+		unsigned int m_depth;
+		Timeline m_timeline;
+		bool m_is_traced;
+	};
+
+	const SeriesInfo SECTION_INFO[SECTION_COUNT] =
+	{
+		{ "Update",       0, TIMELINE_UPDATE,  true  },
+		{ "Player",       1, TIMELINE_UPDATE,  true  },
+		{ "Rings",        1, TIMELINE_UPDATE,  true  },
+		{ "Search",       2, TIMELINE_UPDATE,  true  },
+		{ "Collisions",   1, TIMELINE_UPDATE,  true  },
+		{ "Display",      0, TIMELINE_DISPLAY, true  },
+		{ "Skybox",       1, TIMELINE_DISPLAY, true  },
+		{ "Terrain",      1, TIMELINE_DISPLAY, true  },
+		{ "LOD",          2, TIMELINE_DISPLAY, false },
+		{ "Objects",      1, TIMELINE_DISPLAY, true  },
+		{ "Search lines", 1, TIMELINE_DISPLAY, true  },
+		{ "Player",       1, TIMELINE_DISPLAY, true  },
+		{ "Text",         1, TIMELINE_DISPLAY, true  },
+	};
+
+	const SeriesInfo COUNTER_INFO[COUNTER_COUNT] =
+	{
+		{ "Searches",       0, TIMELINE_UPDATE, false },
+		{ "Nodes expanded", 0, TIMELINE_UPDATE, false },
+		{ "Closest disk",   0, TIMELINE_UPDATE, false },
+		{ "Height",         0, TIMELINE_UPDATE, false },
+	};
+
+	//
+	//  Window
+	//
+	//  A rolling window of the last WINDOW_SIZE samples.  Once
+	//    it is full, each new sample replaces the oldest.
+	//
+	struct Window
+	{
+		float ma_samples[WINDOW_SIZE];
+		unsigned int m_next;
+		unsigned int m_count;
+	};
+
+	//
+	//  FrameTotals
+	//
+	//  The times and counts added on one thread since its last
+	//    frame ended.
+	//
+	struct FrameTotals
+	{
+		double ma_seconds[SECTION_COUNT];
+		unsigned int ma_counts[COUNTER_COUNT];
+	};
+
+	thread_local FrameTotals g_totals = {};
+
+	// guards the windows
+	mutex g_window_mutex;
+	Window ga_section_windows[SECTION_COUNT] = {};
+	Window ga_counter_windows[COUNTER_COUNT] = {};
+
+	//
+	//  addSample
+	//
+	//  Purpose: To add a sample to the specified window.
+	//  Parameter(s):
+	//    <1> r_window: The window
+	//    <2> sample: The sample
+	//  Precondition(s):
+	//    <1> g_window_mutex is locked
+	//  Returns: N/A
+	//  Side Effect: sample is added to r_window, replacing the
+	//               oldest sample if r_window is full.
+	//
+	void addSample (Window& r_window, float sample)
+	{
+		assert(r_window.m_next < WINDOW_SIZE);
+
+		r_window.ma_samples[r_window.m_next] = sample;
+		r_window.m_next = (r_window.m_next + 1) % WINDOW_SIZE;
+		if(r_window.m_count < WINDOW_SIZE)
+			r_window.m_count++;
+	}
+
+	//
+	//  summarize
+	//
+	//  Purpose: To calculate the percentiles of the samples in
+	//           the specified window.
+	//  Parameter(s):
+	//    <1> window: The window
+	//    <2> scale: The factor to multiply the samples by
+	//  Precondition(s): N/A
+	//  Returns: The percentiles of the samples in window,
+	//           multiplied by scale.  If window is empty, they
+	//           are all 0.0f.
+	//  Side Effect: N/A
+	//
+	Summary summarize (const Window& window, float scale)
+	{
+		float a_sorted[WINDOW_SIZE];
+		unsigned int count;
+		{
+			lock_guard<mutex> lock(g_window_mutex);
+			count = window.m_count;
+			copy(window.ma_samples, window.ma_samples + count, a_sorted);
+		}
+
+		Summary summary;
+		summary.m_sample_count = count;
+		summary.m_median       = 0.0f;
+		summary.m_percentile95 = 0.0f;
+		summary.m_max          = 0.0f;
+		if(count == 0)
+			return summary;
+
+		// nth_element leaves everything after each rank larger
+		unsigned int median_rank = count / 2;
+		unsigned int high_rank   = count * 95 / 100;
+		nth_element(a_sorted, a_sorted + high_rank, a_sorted + count);
+		summary.m_percentile95 = a_sorted[high_rank] * scale;
+		summary.m_max = *max_element(a_sorted + high_rank, a_sorted + count) * scale;
+		nth_element(a_sorted, a_sorted + median_rank, a_sorted + high_rank + 1);
+		summary.m_median = a_sorted[median_rank] * scale;
+		return summary;
+	}
+
+	//
+	//  printSummary
+	//
+	//  Purpose: To print one row of the summary table.
+	//  Parameter(s):
+	//    <1> r_out: The stream to print to
+	//    <2> name: The name of the row
+	//    <3> depth: How far to indent the name
+	//    <4> summary: The percentiles
+	//  Precondition(s):
+	//    <1> name != nullptr
+	//  Returns: N/A
+	//  Side Effect: summary is printed to r_out.
+	//
+	void printSummary (ostream& r_out,
+	                   const char* name,
+	                   unsigned int depth,
+	                   const Summary& summary)
+	{
+		assert(name != nullptr);
+
+		r_out << "  " << left << setw(16) << (string(depth * 2, ' ') + name) << right
+		      << setw(10) << summary.m_median
+		      << setw(10) << summary.m_percentile95
+		      << setw(10) << summary.m_max << endl;
+	}
+}
+
+
+
+const char* Profiler :: getSectionName (Section section)
+{
+	assert(section < SECTION_COUNT);
+
+	return SECTION_INFO[section].m_name;
+}
+
+unsigned int Profiler :: getSectionDepth (Section section)
+{
+	assert(section < SECTION_COUNT);
+
+	return SECTION_INFO[section].m_depth;
+}
+
+const char* Profiler :: getCounterName (Counter counter)
+{
+	assert(counter < COUNTER_COUNT);
+
+	return COUNTER_INFO[counter].m_name;
+}
+
+Summary Profiler :: getSectionSummary (Section section)
+{
+	assert(section < SECTION_COUNT);
+
+	return summarize(ga_section_windows[section], 1.0e6f);
+}
+
+Summary Profiler :: getCounterSummary (Counter counter)
+{
+	assert(counter < COUNTER_COUNT);
+
+	return summarize(ga_counter_windows[counter], 1.0f);
+}
+
+void Profiler :: printSummaries (ostream& r_out)
+{
+	ios::fmtflags old_flags = r_out.flags();
+	r_out << fixed << setprecision(1);
+
+	r_out << "Time (us)           median       p95       max" << endl;
+	for(unsigned int i = 0; i < SECTION_COUNT; i++)
+		printSummary(r_out, getSectionName((Section)(i)), getSectionDepth((Section)(i)), getSectionSummary((Section)(i)));
+	r_out << "Count per update    median       p95       max" << endl;
+	for(unsigned int i = 0; i < COUNTER_COUNT; i++)
+		printSummary(r_out, getCounterName((Counter)(i)), 0, getCounterSummary((Counter)(i)));
+
+	r_out.flags(old_flags);
+}
+
+
+
+void Profiler :: beginSection (Section section, TraceRecorder::TimePoint start)
+{
+	assert(section < SECTION_COUNT);
+
+	if(TRACE_ENABLED && SECTION_INFO[section].m_is_traced)
+		TraceRecorder::recordBegin(SECTION_INFO[section].m_name, start);
+}
+
+void Profiler :: endSection (Section section,
+                             TraceRecorder::TimePoint start,
+                             TraceRecorder::TimePoint end)
+{
+	assert(section < SECTION_COUNT);
+
+	g_totals.ma_seconds[section] += chrono::duration<double>(end - start).count();
+	if(TRACE_ENABLED && SECTION_INFO[section].m_is_traced)
+		TraceRecorder::recordEnd(SECTION_INFO[section].m_name, end);
+}
+
+void Profiler :: addCount (Counter counter, unsigned int amount)
+{
+	assert(counter < COUNTER_COUNT);
+
+	g_totals.ma_counts[counter] += amount;
+}
+
+unsigned int Profiler :: getFrameCount (Counter counter)
+{
+	assert(counter < COUNTER_COUNT);
+
+	return g_totals.ma_counts[counter];
+}
+
+void Profiler :: endFrame (Timeline timeline)
+{
+	assert(timeline < TIMELINE_COUNT);
+
+	{
+		lock_guard<mutex> lock(g_window_mutex);
+		for(unsigned int i = 0; i < SECTION_COUNT; i++)
+			if(SECTION_INFO[i].m_timeline == timeline)
+				addSample(ga_section_windows[i], (float)(g_totals.ma_seconds[i]));
+		for(unsigned int i = 0; i < COUNTER_COUNT; i++)
+			if(COUNTER_INFO[i].m_timeline == timeline)
+				addSample(ga_counter_windows[i], (float)(g_totals.ma_counts[i]));
+	}
+
+	g_totals = FrameTotals();
+}
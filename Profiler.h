@@ -0,0 +1,375 @@
+//
+//  Profiler.h
+//
+//  A module to time the phases of each physics frame and
+//    displayed frame.
+//
+
+#ifndef PROFILER_H
+#define PROFILER_H
+
+#include <chrono>
+#include <iostream>
+
+#include "TraceRecorder.h"
+
+
+
+//
+//  PROFILER_ENABLED
+//
+//  Whether the profiling macros do anything.  If this is
+//    defined as 0 before this file is included (e.g. on the
+//    compiler command line), PROFILE_SCOPE, PROFILE_COUNT, and
+//    PROFILE_END_FRAME expand to nothing, so the timed code is
+//    the same as if they were not there.
+//
+#ifndef PROFILER_ENABLED
+	#define PROFILER_ENABLED 1
+#endif
+
+#if PROFILER_ENABLED
+	#define PROFILE_SCOPE(section)         Profiler::Scope profiler_scope_##section(Profiler::section)
+	#define PROFILE_COUNT(counter, amount) Profiler::addCount(Profiler::counter, (amount))
+	#define PROFILE_END_FRAME(timeline)    Profiler::endFrame(Profiler::timeline)
+#else
+	#define PROFILE_SCOPE(section)
+	#define PROFILE_COUNT(counter, amount) ((void)0)
+	#define PROFILE_END_FRAME(timeline)    ((void)0)
+#endif
+
+
+
+//
+//  Profiler
+//
+//  A namespace to measure where the time goes in each physics
+//    frame and each displayed frame.  Code is timed by placing
+//    PROFILE_SCOPE(SECTION_...) at the start of a block, and
+//    events are counted with PROFILE_COUNT(COUNTER_..., n).
+//
+//  Times and counts are added up separately on each thread,
+//    with no locking.  When a thread calls
+//    PROFILE_END_FRAME(TIMELINE_...), the totals for the
+//    sections and counters belonging to that timeline are
+//    added as one sample each to rolling windows of the last
+//    WINDOW_SIZE frames, and the thread's totals are cleared.
+//    Only this step takes a lock.  Percentiles are calculated
+//    from the windows when they are requested.
+//
+namespace Profiler
+{
+	//
+	//  Timeline
+	//
+	//  The kinds of frame that samples are taken for.  Physics
+	//    frames run on the simulation thread and displayed
+	//    frames on the main thread.
+	//
+	enum Timeline
+	{
+		TIMELINE_UPDATE,
+		TIMELINE_DISPLAY,
+		TIMELINE_COUNT
+	};
+
+	//
+	//  Section
+	//
+	//  The parts of a frame that can be timed.  A section may
+	//    contain other sections.
+	//
+	enum Section
+	{
+		SECTION_UPDATE,
+		SECTION_PLAYER,
+		SECTION_RINGS,
+		SECTION_SEARCH,
+		SECTION_COLLISIONS,
+		SECTION_DISPLAY,
+		SECTION_SKYBOX,
+		SECTION_TERRAIN,
+		SECTION_TERRAIN_LOD,
+		SECTION_OBJECTS,
+		SECTION_SEARCH_OVERLAY,
+		SECTION_PLAYER_MODEL,
+		SECTION_TEXT,
+		SECTION_COUNT
+	};
+
+	//
+	//  Counter
+	//
+	//  The events that can be counted.  All of them are counted
+	//    per physics frame.
+	//
+	enum Counter
+	{
+		COUNTER_SEARCHES,
+		COUNTER_NODES_EXPANDED,
+		COUNTER_CLOSEST_DISK,
+		COUNTER_HEIGHT,
+		COUNTER_COUNT
+	};
+
+	//
+	//  WINDOW_SIZE
+	//
+	//  The number of frames the percentiles are taken over.
+	//
+	const unsigned int WINDOW_SIZE = 240;
+
+	//
+	//  IS_ENABLED
+	//
+	//  Whether the profiling macros do anything.
+	//
+	const bool IS_ENABLED = (PROFILER_ENABLED != 0);
+
+	//
+	//  Summary
+	//
+	//  The percentiles of the samples in a rolling window.
+	//    Times are in microseconds.
+	//
+	struct Summary
+	{
+		unsigned int m_sample_count;
+		float m_median;
+		float m_percentile95;
+		float m_max;
+	};
+
+	//
+	//  getSectionName
+	//
+	//  Purpose: To determine the name of the specified section.
+	//  Parameter(s):
+	//    <1> section: The section
+	//  Precondition(s):
+	//    <1> section < SECTION_COUNT
+	//  Returns: The name of section.
+	//  Side Effect: N/A
+	//
+	const char* getSectionName (Section section);
+
+	//
+	//  getSectionDepth
+	//
+	//  Purpose: To determine how deeply the specified section
+	//           is nested in other sections.
+	//  Parameter(s):
+	//    <1> section: The section
+	//  Precondition(s):
+	//    <1> section < SECTION_COUNT
+	//  Returns: The number of sections section is inside.
+	//  Side Effect: N/A
+	//
+	unsigned int getSectionDepth (Section section);
+
+	//
+	//  getCounterName
+	//
+	//  Purpose: To determine the name of the specified counter.
+	//  Parameter(s):
+	//    <1> counter: The counter
+	//  Precondition(s):
+	//    <1> counter < COUNTER_COUNT
+	//  Returns: The name of counter.
+	//  Side Effect: N/A
+	//
+	const char* getCounterName (Counter counter);
+
+	//
+	//  getSectionSummary
+	//
+	//  Purpose: To determine the percentiles of the time spent
+	//           in the specified section per frame.
+	//  Parameter(s):
+	//    <1> section: The section
+	//  Precondition(s):
+	//    <1> section < SECTION_COUNT
+	//  Returns: The percentiles over the last WINDOW_SIZE
+	//           frames, in microseconds.  This function may be
+	//           called from any thread.
+	//  Side Effect: N/A
+	//
+	Summary getSectionSummary (Section section);
+
+	//
+	//  getCounterSummary
+	//
+	//  Purpose: To determine the percentiles of the specified
+	//           counter per frame.
+	//  Parameter(s):
+	//    <1> counter: The counter
+	//  Precondition(s):
+	//    <1> counter < COUNTER_COUNT
+	//  Returns: The percentiles over the last WINDOW_SIZE
+	//           frames.  This function may be called from any
+	//           thread.
+	//  Side Effect: N/A
+	//
+	Summary getCounterSummary (Counter counter);
+
+	//
+	//  printSummaries
+	//
+	//  Purpose: To print the percentiles for every section and
+	//           counter.
+	//  Parameter(s):
+	//    <1> r_out: The stream to print to
+	//  Precondition(s): N/A
+	//  Returns: N/A
+	//  Side Effect: A table of the percentiles is printed to
+	//               r_out.
+	//
+	void printSummaries (std::ostream& r_out);
+
+	//
+	//  beginSection
+	//
+	//  Purpose: To record that the specified section has
+	//           started on this thread.
+	//  Parameter(s):
+	//    <1> section: The section
+	//    <2> start: When the section started
+	//  Precondition(s):
+	//    <1> section < SECTION_COUNT
+	//  Returns: N/A
+	//  Side Effect: If section is traced, its start is sent to
+	//               the TraceRecorder.
+	//
+	void beginSection (Section section, TraceRecorder::TimePoint start);
+
+	//
+	//  endSection
+	//
+	//  Purpose: To add time spent in the specified section to
+	//           the current frame on this thread.
+	//  Parameter(s):
+	//    <1> section: The section
+	//    <2> start: When the section started
+	//    <3> end: When the section ended
+	//  Precondition(s):
+	//    <1> section < SECTION_COUNT
+	//    <2> start <= end
+	//  Returns: N/A
+	//  Side Effect: The time from start to end is added to the
+	//               total for section on this thread.  If
+	//               section is traced, its end is sent to the
+	//               TraceRecorder.
+	//
+	void endSection (Section section,
+	                 TraceRecorder::TimePoint start,
+	                 TraceRecorder::TimePoint end);
+
+	//
+	//  addCount
+	//
+	//  Purpose: To count events for the specified counter in
+	//           the current frame on this thread.
+	//  Parameter(s):
+	//    <1> counter: The counter
+	//    <2> amount: The number of events
+	//  Precondition(s):
+	//    <1> counter < COUNTER_COUNT
+	//  Returns: N/A
+	//  Side Effect: amount is added to the total for counter on
+	//               this thread.
+	//
+	void addCount (Counter counter, unsigned int amount);
+
+	//
+	//  getFrameCount
+	//
+	//  Purpose: To determine the count so far for the specified
+	//           counter in the current frame on this thread.
+	//  Parameter(s):
+	//    <1> counter: The counter
+	//  Precondition(s):
+	//    <1> counter < COUNTER_COUNT
+	//  Returns: The total for counter on this thread since its
+	//           last frame ended.  If the profiling macros are
+	//           disabled, this is always 0.
+	//  Side Effect: N/A
+	//
+	unsigned int getFrameCount (Counter counter);
+
+	//
+	//  endFrame
+	//
+	//  Purpose: To end a frame of the specified timeline on
+	//           this thread.
+	//  Parameter(s):
+	//    <1> timeline: The timeline
+	//  Precondition(s):
+	//    <1> timeline < TIMELINE_COUNT
+	//  Returns: N/A
+	//  Side Effect: The totals on this thread for every section
+	//               and counter in timeline are added to their
+	//               rolling windows.  All the totals on this
+	//               thread are then cleared, including those for
+	//               other timelines, which are discarded.
+	//
+	void endFrame (Timeline timeline);
+
+
+
+	//
+	//  Scope
+	//
+	//  A class to time a block of code.  The time from when a
+	//    Scope is created until it is destroyed is added to a
+	//    section, and it is traced as a block.  It is normally
+	//    created with PROFILE_SCOPE.
+	//
+	class Scope
+	{
+	public:
+		//
+		//  Constructor
+		//
+		//  Purpose: To start timing the specified section.
+		//  Parameter(s):
+		//    <1> section: The section
+		//  Precondition(s):
+		//    <1> section < SECTION_COUNT
+		//  Returns: N/A
+		//  Side Effect: A new Scope is created.
+		//
+		Scope (Section section)
+				: m_section(section)
+				, m_start(TraceRecorder::Clock::now())
+		{
+			beginSection(m_section, m_start);
+		}
+
+		//
+		//  Destructor
+		//
+		//  Purpose: To stop timing the section.
+		//  Parameter(s): N/A
+		//  Precondition(s): N/A
+		//  Returns: N/A
+		//  Side Effect: The time since this Scope was created is
+		//               added to its section and its end is
+		//               traced.
+		//
+		~Scope ()
+		{
+			endSection(m_section, m_start, TraceRecorder::Clock::now());
+		}
+
+		Scope (const Scope& original) = delete;
+		Scope& operator= (const Scope& original) = delete;
+
+	private:
+		Section m_section;
+		TraceRecorder::TimePoint m_start;
+	};
+}
+
+
+
+#endif
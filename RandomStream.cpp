@@ -0,0 +1,80 @@
+//
+//  RandomStream.cpp
+//
+
+#include <cassert>
+#include <cstdint>
+#include <cstdlib>
+
+#include "RandomStream.h"
+
+namespace
+{
+	const uint64_t GOLDEN_GAMMA = 0x9e3779b97f4a7c15ull;
+
+	//
+	//  mix64
+	//
+	//  Purpose: To scramble the bits of the specified value.
+	//  Parameter(s):
+	//    <1> z: The value
+	//  Precondition(s): N/A
+	//  Returns: The finalizer of SplitMix64 applied to z.
+	//  Side Effect: N/A
+	//
+	uint64_t mix64 (uint64_t z)
+	{
+		z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ull;
+		z = (z ^ (z >> 27)) * 0x94d049bb133111ebull;
+		return z ^ (z >> 31);
+	}
+}
+
+
+
+uint64_t RandomStream :: createSeed ()
+{
+	// rand() may only give 15 bits at a time
+	uint64_t seed = 0;
+	for(unsigned int i = 0; i < 5; i++)
+		seed = (seed << 15) ^ (uint64_t)(rand());
+	return mix64(seed);
+}
+
+uint64_t RandomStream :: mixSeed (uint64_t seed, uint64_t index)
+{
+	return mix64(seed + (index + 1) * GOLDEN_GAMMA);
+}
+
+
+
+RandomStream :: RandomStream (uint64_t seed)
+		: m_state(seed)
+{
+}
+
+
+
+uint64_t RandomStream :: getState () const
+{
+	return m_state;
+}
+
+
+
+uint64_t RandomStream :: next ()
+{
+	m_state += GOLDEN_GAMMA;
+	return mix64(m_state);
+}
+
+double RandomStream :: random0 ()
+{
+	// the top 53 bits fill a double exactly
+	return (double)(next() >> 11) * (1.0 / 9007199254740992.0);
+}
+
+bool RandomStream :: randomBool ()
+{
+	return (next() >> 63) != 0;
+}
@@ -0,0 +1,186 @@
+//
+//  RandomStream.h
+//
+//  A module to provide independent, reproducible streams of
+//    pseudorandom numbers.
+//
+
+#ifndef RANDOM_STREAM_H
+#define RANDOM_STREAM_H
+
+#include <cassert>
+#include <cstdint>
+
+
+
+//
+//  RandomStream
+//
+//  A class to generate a sequence of pseudorandom numbers from
+//    a 64-bit seed.  Unlike the functions in Random.h, which
+//    share the state of rand(), each RandomStream has its own
+//    state, so the same seed always produces the same sequence
+//    and different RandomStreams can be used on different
+//    threads at the same time.
+//
+//  The generator is SplitMix64, which is fast and accepts any
+//    seed, including 0.
+//
+class RandomStream
+{
+public:
+	//
+	//  createSeed
+	//
+	//  Purpose: To choose a seed for a new RandomStream.
+	//  Parameter(s): N/A
+	//  Precondition(s): N/A
+	//  Returns: A pseudorandom seed.
+	//  Side Effect: N/A
+	//  Note: Calls the rand() function, so the seeds chosen
+	//        follow seedRandom().
+	//
+	static uint64_t createSeed ();
+
+	//
+	//  mixSeed
+	//
+	//  Purpose: To derive a seed for one of many RandomStreams
+	//           from a shared seed.
+	//  Parameter(s):
+	//    <1> seed: The shared seed
+	//    <2> index: Which stream to derive the seed for
+	//  Precondition(s): N/A
+	//  Returns: A seed that depends on both seed and index.
+	//           Different indexes give unrelated seeds.
+	//  Side Effect: N/A
+	//
+	static uint64_t mixSeed (uint64_t seed, uint64_t index);
+
+public:
+	//
+	//  Constructor
+	//
+	//  Purpose: To create a new RandomStream with the
+	//           specified seed.
+	//  Parameter(s):
+	//    <1> seed: The seed
+	//  Precondition(s): N/A
+	//  Returns: N/A
+	//  Side Effect: A new RandomStream is created.
+	//
+	explicit RandomStream (uint64_t seed);
+
+	RandomStream (const RandomStream& original) = default;
+	~RandomStream () = default;
+	RandomStream& operator= (const RandomStream& original) = default;
+
+	//
+	//  getState
+	//
+	//  Purpose: To determine the current state of this
+	//           RandomStream.
+	//  Parameter(s): N/A
+	//  Precondition(s): N/A
+	//  Returns: The state.  A RandomStream created with the
+	//           state as its seed generates the same sequence
+	//           from here on as this RandomStream does.
+	//  Side Effect: N/A
+	//
+	uint64_t getState () const;
+
+	//
+	//  next
+	//
+	//  Purpose: To generate the next 64 pseudorandom bits.
+	//  Parameter(s): N/A
+	//  Precondition(s): N/A
+	//  Returns: A pseudorandom 64-bit value.
+	//  Side Effect: This RandomStream advances.
+	//
+	uint64_t next ();
+
+	//
+	//  random0
+	//
+	//  Purpose; To generate a psuedorandom number in the range
+	//           [0, 1).
+	//  Parameter(s): N/A
+	//  Precondition(s): N/A
+	//  Returns: A pseudorandom number in the range [0, 1).  The
+	//           value returned can be 0 but cannot be 1.
+	//  Side Effect: This RandomStream advances.
+	//
+	double random0 ();
+
+	//
+	//  random1
+	//
+	//  Purpose; To generate a psuedorandom number in the range
+	//           from 0 to the specified maximum.
+	//  Parameter(s):
+	//    <1> max: The exclusive maximum
+	//  Precondition(s):
+	//    <1> 0 <= max
+	//  Returns: A pseudorandom number in the range [0, max).
+	//           If max == 0, (T)(0) is always returned.
+	//  Side Effect: This RandomStream advances.
+	//  T must meet the requirements of random1 in Random.h.
+	//
+	template <typename T>
+	T random1 (T max);
+
+	//
+	//  random2
+	//
+	//  Purpose: To generate a psuedorandom number in the
+	//           specified range.
+	//  Parameter(s):
+	//    <1> min: The inclusive minimum
+	//    <2> max: The exclusive maximum
+	//  Precondition(s):
+	//    <1> min <= max
+	//  Returns: A pseudorandom number in the range [min, max).
+	//           If min == max, min is always returned.
+	//  Side Effect: This RandomStream advances.
+	//  T must meet the requirements of random2 in Random.h.
+	//
+	template <typename T>
+	T random2 (T min, T max);
+
+	//
+	//  randomBool
+	//
+	//  Purpose; To generate a random boolean value.
+	//  Parameter(s): N/A
+	//  Precondition(s): N/A
+	//  Returns: true or false, with equal probabilities.
+	//  Side Effect: This RandomStream advances.
+	//
+	bool randomBool ();
+
+private:
+	uint64_t m_state;
+};
+
+
+
+template <typename T>
+T RandomStream :: random1 (T max)
+{
+	assert(0 <= max);
+
+	return (T)(max * random0());
+}
+
+template <typename T>
+T RandomStream :: random2 (T min, T max)
+{
+	assert(min <= max);
+
+	return min + (T)((max - min) * random0());
+}
+
+
+
+#endif
@@ -0,0 +1,26 @@
+//
+//  Renderer.cpp
+//
+
+#include <cassert>
+
+#include "ObjLibrary/ObjModel.h"
+
+#include "Renderer.h"
+
+using namespace ObjLibrary;
+
+
+
+unsigned int Renderer :: countVertexes (const ObjModel& model)
+{
+	unsigned int vertex_count = 0;
+	for(unsigned int m = 0; m < model.getMeshCount(); m++)
+		for(unsigned int f = 0; f < model.getFaceCount(m); f++)
+		{
+			unsigned int face_vertex_count = model.getFaceVertexCount(m, f);
+			if(face_vertex_count >= 3)
+				vertex_count += (face_vertex_count - 2) * 3;
+		}
+	return vertex_count;
+}
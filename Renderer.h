@@ -0,0 +1,407 @@
+//
+//  Renderer.h
+//
+//  A module to represent the interface used to draw the game.
+//
+
+#ifndef RENDERER_H
+#define RENDERER_H
+
+#include <string>
+#include <vector>
+
+#include "ObjLibrary/Vector3.h"
+
+namespace ObjLibrary
+{
+	class ObjModel;
+	class DisplayList;
+	class SpriteFont;
+}
+class AnimationModel;
+
+
+
+//
+//  Renderer
+//
+//  An abstract class to represent the drawing commands used by
+//    the game.  All per-frame drawing goes through a Renderer
+//    instead of calling OpenGL directly, so the drawing can be
+//    sent to OpenGL (RendererGl) or recorded and counted
+//    without a graphics card (RendererRecording).
+//
+//  The commands closely follow fixed-function OpenGL.  Matrix
+//    commands affect the modelview matrix, and the current
+//    state set by the state commands is used by later draw
+//    commands.
+//
+//  Each draw command takes a vertex count, or calculates one,
+//    so that the amount of geometry drawn can be measured.
+//    Display lists cannot be inspected, so the client must
+//    supply the vertex count for them.
+//
+class Renderer
+{
+public:
+	//
+	//  FLOATS_PER_COLORED_VERTEX
+	//
+	//  The number of floats used to store each vertex passed to
+	//    drawColoredLines and drawColoredTriangles.  These are
+	//    the red, green, and blue color components and then
+	//    position x, y, and z, as in the GL_C3F_V3F format.
+	//
+	static const unsigned int FLOATS_PER_COLORED_VERTEX = 6;
+
+	//
+	//  Class Function: countVertexes
+	//
+	//  Purpose: To determine the number of vertexes that will
+	//           be sent to the graphics card when the specified
+	//           model is drawn as triangles.
+	//  Parameter(s):
+	//    <1> model: The model
+	//  Precondition(s): N/A
+	//  Returns: The number of triangle vertexes in model.  A
+	//           face with N vertexes is counted as N - 2
+	//           triangles.  Point sets and polylines are not
+	//           included.
+	//  Side Effect: N/A
+	//
+	static unsigned int countVertexes (
+	                         const ObjLibrary::ObjModel& model);
+
+public:
+	//
+	//  Destructor
+	//
+	//  Purpose: To safely destroy this Renderer.
+	//  Parameter(s): N/A
+	//  Precondition(s): N/A
+	//  Returns: N/A
+	//  Side Effect: N/A
+	//
+	virtual ~Renderer () = default;
+
+	//
+	//  beginFrame
+	//
+	//  Purpose: To start drawing a new frame.
+	//  Parameter(s): N/A
+	//  Precondition(s): N/A
+	//  Returns: N/A
+	//  Side Effect: The color and depth buffers are cleared and
+	//               the modelview matrix is reset to the
+	//               identity matrix.
+	//
+	virtual void beginFrame () = 0;
+
+	//
+	//  endFrame
+	//
+	//  Purpose: To finish drawing the current frame.
+	//  Parameter(s): N/A
+	//  Precondition(s): N/A
+	//  Returns: N/A
+	//  Side Effect: Any frame statistics are finalized.  The
+	//               buffers are not swapped.
+	//
+	virtual void endFrame () = 0;
+
+	//
+	//  lookAt
+	//
+	//  Purpose: To multiply the modelview matrix by a viewing
+	//           transformation.
+	//  Parameter(s):
+	//    <1> eye: The camera position
+	//    <2> look_at: The position the camera is looking at
+	//    <3> up: The up direction for the camera
+	//  Precondition(s):
+	//    <1> eye != look_at
+	//  Returns: N/A
+	//  Side Effect: The modelview matrix is changed as by
+	//               gluLookAt.
+	//
+	virtual void lookAt (const ObjLibrary::Vector3& eye,
+	                     const ObjLibrary::Vector3& look_at,
+	                     const ObjLibrary::Vector3& up) = 0;
+
+	//
+	//  pushMatrix
+	//  popMatrix
+	//
+	//  Purpose: To save or restore the modelview matrix.
+	//  Parameter(s): N/A
+	//  Precondition(s):
+	//    <1> popMatrix: There is a saved matrix
+	//  Returns: N/A
+	//  Side Effect: The modelview matrix is pushed onto or
+	//               popped off of the matrix stack.
+	//
+	virtual void pushMatrix () = 0;
+	virtual void popMatrix () = 0;
+
+	//
+	//  translate
+	//
+	//  Purpose: To apply a translation to the modelview matrix.
+	//  Parameter(s):
+	//    <1> x
+	//    <2> y
+	//    <3> z: The translation
+	//  Precondition(s): N/A
+	//  Returns: N/A
+	//  Side Effect: The modelview matrix is translated.
+	//
+	virtual void translate (double x, double y, double z) = 0;
+
+	//
+	//  rotate
+	//
+	//  Purpose: To apply a rotation to the modelview matrix.
+	//  Parameter(s):
+	//    <1> degrees: The rotation angle in degrees
+	//    <2> x
+	//    <3> y
+	//    <4> z: The rotation axis
+	//  Precondition(s): N/A
+	//  Returns: N/A
+	//  Side Effect: The modelview matrix is rotated.
+	//
+	virtual void rotate (double degrees,
+	                     double x, double y, double z) = 0;
+
+	//
+	//  scale
+	//
+	//  Purpose: To apply a scaling to the modelview matrix.
+	//  Parameter(s):
+	//    <1> x
+	//    <2> y
+	//    <3> z: The scaling factors
+	//  Precondition(s): N/A
+	//  Returns: N/A
+	//  Side Effect: The modelview matrix is scaled.
+	//
+	virtual void scale (double x, double y, double z) = 0;
+
+	//
+	//  setColor
+	//
+	//  Purpose: To change the current color.
+	//  Parameter(s):
+	//    <1> red
+	//    <2> green
+	//    <3> blue: The color components in the range [0, 1]
+	//  Precondition(s): N/A
+	//  Returns: N/A
+	//  Side Effect: The current color is set.
+	//
+	virtual void setColor (double red, double green, double blue) = 0;
+
+	//
+	//  setTexturing
+	//
+	//  Purpose: To enable or disable 2D texturing.
+	//  Parameter(s):
+	//    <1> is_enabled: Whether texturing should be enabled
+	//  Precondition(s): N/A
+	//  Returns: N/A
+	//  Side Effect: 2D texturing is enabled or disabled.
+	//
+	virtual void setTexturing (bool is_enabled) = 0;
+
+	//
+	//  bindTexture
+	//
+	//  Purpose: To make the texture with the specified name
+	//           current.
+	//  Parameter(s):
+	//    <1> name: The name of the texture
+	//  Precondition(s): N/A
+	//  Returns: N/A
+	//  Side Effect: The texture is activated as by
+	//               TextureManager::activate.
+	//
+	virtual void bindTexture (const std::string& name) = 0;
+
+	//
+	//  setDepthWrite
+	//
+	//  Purpose: To enable or disable writing to the depth
+	//           buffer.
+	//  Parameter(s):
+	//    <1> is_enabled: Whether depth writes should be enabled
+	//  Precondition(s): N/A
+	//  Returns: N/A
+	//  Side Effect: Depth writes are enabled or disabled.
+	//
+	virtual void setDepthWrite (bool is_enabled) = 0;
+
+	//
+	//  setLineWidth
+	//
+	//  Purpose: To change the width used to draw lines.
+	//  Parameter(s):
+	//    <1> width: The new line width in pixels
+	//  Precondition(s):
+	//    <1> width > 0.0f
+	//  Returns: N/A
+	//  Side Effect: The line width is set.
+	//
+	virtual void setLineWidth (float width) = 0;
+
+	//
+	//  drawDisplayList
+	//
+	//  Purpose: To draw the specified display list.
+	//  Parameter(s):
+	//    <1> list: The display list
+	//    <2> vertex_count: The number of vertexes in list
+	//  Precondition(s):
+	//    <1> list.isReady()
+	//  Returns: N/A
+	//  Side Effect: The display list is drawn.
+	//
+	virtual void drawDisplayList (
+	                      const ObjLibrary::DisplayList& list,
+	                      unsigned int vertex_count) = 0;
+
+	//
+	//  drawAnimation
+	//
+	//  Purpose: To draw a blend of two frames of the specified
+	//           animation.
+	//  Parameter(s):
+	//    <1> model: The animation
+	//    <2> frame0
+	//    <3> frame1: The frames to blend
+	//    <4> fraction: How far to go from frame0 to frame1
+	//    <5> level: The level of detail
+	//  Precondition(s):
+	//    <1> frame0 < model.getFrameCount()
+	//    <2> frame1 < model.getFrameCount()
+	//  Returns: N/A
+	//  Side Effect: The blended frame is drawn at level, as
+	//               AnimationModel::draw does.  If the frames
+	//               cannot be blended, the nearer one is drawn.
+	//
+	virtual void drawAnimation (const AnimationModel& model,
+	                            unsigned int frame0,
+	                            unsigned int frame1,
+	                            float fraction,
+	                            unsigned int level) = 0;
+
+	//
+	//  drawLineStrip
+	//
+	//  Purpose: To draw a strip of connected line segments.
+	//  Parameter(s):
+	//    <1> vertexes: The vertexes of the line strip
+	//  Precondition(s): N/A
+	//  Returns: N/A
+	//  Side Effect: A line strip connecting the vertexes in
+	//               order is drawn in the current color.
+	//
+	virtual void drawLineStrip (
+	     const std::vector<ObjLibrary::Vector3>& vertexes) = 0;
+
+	//
+	//  drawColoredLines
+	//
+	//  Purpose: To draw a batch of separate line segments, each
+	//           vertex with its own color, in one draw call.
+	//  Parameter(s):
+	//    <1> vertexes: The interleaved vertex data
+	//  Precondition(s):
+	//    <1> vertexes.size() % (FLOATS_PER_COLORED_VERTEX * 2)
+	//        == 0
+	//  Returns: N/A
+	//  Side Effect: A line segment is drawn between each pair of
+	//               vertexes.  The current color is undefined
+	//               afterwards.
+	//
+	virtual void drawColoredLines (
+	                      const std::vector<float>& vertexes) = 0;
+
+	//
+	//  drawColoredTriangles
+	//
+	//  Purpose: To draw a batch of separate triangles, each
+	//           vertex with its own color, in one draw call.
+	//  Parameter(s):
+	//    <1> vertexes: The interleaved vertex data
+	//  Precondition(s):
+	//    <1> vertexes.size() % (FLOATS_PER_COLORED_VERTEX * 3)
+	//        == 0
+	//  Returns: N/A
+	//  Side Effect: A triangle is drawn for each 3 vertexes.
+	//               The current color is undefined afterwards.
+	//
+	virtual void drawColoredTriangles (
+	                      const std::vector<float>& vertexes) = 0;
+
+	//
+	//  drawSphere
+	//
+	//  Purpose: To draw a solid sphere at the origin.
+	//  Parameter(s):
+	//    <1> radius: The sphere radius
+	//    <2> slices: The number of subdivisions around the Y
+	//                axis
+	//    <3> stacks: The number of subdivisions along the Y
+	//                axis
+	//  Precondition(s):
+	//    <1> radius >= 0.0
+	//    <2> slices >= 3
+	//    <3> stacks >= 2
+	//  Returns: N/A
+	//  Side Effect: A sphere is drawn in the current color as
+	//               by glutSolidSphere.
+	//
+	virtual void drawSphere (double radius,
+	                         unsigned int slices,
+	                         unsigned int stacks) = 0;
+
+	//
+	//  begin2dView
+	//  end2dView
+	//
+	//  Purpose: To start or stop drawing in screen coordinates.
+	//  Parameter(s):
+	//    <1> width
+	//    <2> height: The size of the window in pixels
+	//  Precondition(s):
+	//    <1> begin2dView: width > 0 && height > 0
+	//  Returns: N/A
+	//  Side Effect: The view is set up for drawing text as by
+	//               SpriteFont::setUp2dView, or restored.
+	//
+	virtual void begin2dView (int width, int height) = 0;
+	virtual void end2dView () = 0;
+
+	//
+	//  drawText
+	//
+	//  Purpose: To draw a string of text.
+	//  Parameter(s):
+	//    <1> font: The font to use
+	//    <2> text: The text to draw
+	//    <3> x
+	//    <4> y: The position of the top left corner in pixels
+	//  Precondition(s):
+	//    <1> font.isInitalized()
+	//    <2> Between calls to begin2dView and end2dView
+	//  Returns: N/A
+	//  Side Effect: The text is drawn.
+	//
+	virtual void drawText (const ObjLibrary::SpriteFont& font,
+	                       const std::string& text,
+	                       float x, float y) = 0;
+};
+
+
+
+#endif
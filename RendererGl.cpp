@@ -0,0 +1,195 @@
+//
+//  RendererGl.cpp
+//
+
+#include <cassert>
+#include <string>
+#include <vector>
+
+#include "GetGlut.h"
+#include "ObjLibrary/Vector3.h"
+#include "ObjLibrary/DisplayList.h"
+#include "ObjLibrary/SpriteFont.h"
+#include "ObjLibrary/TextureManager.h"
+
+#include "AnimationModel.h"
+#include "RendererGl.h"
+
+using namespace std;
+using namespace ObjLibrary;
+
+
+
+void RendererGl :: beginFrame ()
+{
+	glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+	glLoadIdentity();
+}
+
+void RendererGl :: endFrame ()
+{
+}
+
+
+
+void RendererGl :: lookAt (const Vector3& eye,
+                           const Vector3& look_at,
+                           const Vector3& up)
+{
+	assert(eye != look_at);
+
+	gluLookAt(    eye.x,     eye.y,     eye.z,
+	          look_at.x, look_at.y, look_at.z,
+	               up.x,      up.y,      up.z);
+}
+
+void RendererGl :: pushMatrix ()
+{
+	glPushMatrix();
+}
+
+void RendererGl :: popMatrix ()
+{
+	glPopMatrix();
+}
+
+void RendererGl :: translate (double x, double y, double z)
+{
+	glTranslated(x, y, z);
+}
+
+void RendererGl :: rotate (double degrees,
+                           double x, double y, double z)
+{
+	glRotated(degrees, x, y, z);
+}
+
+void RendererGl :: scale (double x, double y, double z)
+{
+	glScaled(x, y, z);
+}
+
+
+
+void RendererGl :: setColor (double red, double green, double blue)
+{
+	glColor3d(red, green, blue);
+}
+
+void RendererGl :: setTexturing (bool is_enabled)
+{
+	if(is_enabled)
+		glEnable(GL_TEXTURE_2D);
+	else
+		glDisable(GL_TEXTURE_2D);
+}
+
+void RendererGl :: bindTexture (const string& name)
+{
+	TextureManager::activate(name);
+}
+
+void RendererGl :: setDepthWrite (bool is_enabled)
+{
+	glDepthMask(is_enabled ? GL_TRUE : GL_FALSE);
+}
+
+void RendererGl :: setLineWidth (float width)
+{
+	assert(width > 0.0f);
+
+	glLineWidth(width);
+}
+
+
+
+void RendererGl :: drawDisplayList (const DisplayList& list,
+                                    unsigned int /*vertex_count*/)
+{
+	assert(list.isReady());
+
+	list.draw();
+}
+
+void RendererGl :: drawAnimation (const AnimationModel& model,
+                                  unsigned int frame0,
+                                  unsigned int frame1,
+                                  float fraction,
+                                  unsigned int level)
+{
+	assert(frame0 < model.getFrameCount());
+	assert(frame1 < model.getFrameCount());
+
+	model.draw(frame0, frame1, fraction, level);
+}
+
+void RendererGl :: drawLineStrip (const vector<Vector3>& vertexes)
+{
+	glBegin(GL_LINE_STRIP);
+		for(unsigned int i = 0; i < vertexes.size(); i++)
+			glVertex3d(vertexes[i].x, vertexes[i].y, vertexes[i].z);
+	glEnd();
+}
+
+void RendererGl :: drawColoredLines (const vector<float>& vertexes)
+{
+	assert(vertexes.size() % (FLOATS_PER_COLORED_VERTEX * 2) == 0);
+
+	drawColoredArrays(GL_LINES, vertexes);
+}
+
+void RendererGl :: drawColoredTriangles (const vector<float>& vertexes)
+{
+	assert(vertexes.size() % (FLOATS_PER_COLORED_VERTEX * 3) == 0);
+
+	drawColoredArrays(GL_TRIANGLES, vertexes);
+}
+
+void RendererGl :: drawSphere (double radius,
+                               unsigned int slices,
+                               unsigned int stacks)
+{
+	assert(radius >= 0.0);
+	assert(slices >= 3);
+	assert(stacks >= 2);
+
+	glutSolidSphere(radius, slices, stacks);
+}
+
+
+
+void RendererGl :: begin2dView (int width, int height)
+{
+	assert(width  > 0);
+	assert(height > 0);
+
+	SpriteFont::setUp2dView(width, height);
+}
+
+void RendererGl :: end2dView ()
+{
+	SpriteFont::unsetUp2dView();
+}
+
+void RendererGl :: drawText (const SpriteFont& font,
+                             const string& text,
+                             float x, float y)
+{
+	assert(font.isInitalized());
+
+	font.draw(text, x, y);
+}
+
+
+
+void RendererGl :: drawColoredArrays (unsigned int mode,
+                                      const vector<float>& vertexes)
+{
+	if(vertexes.empty())
+		return;
+
+	glInterleavedArrays(GL_C3F_V3F, 0, vertexes.data());
+	glDrawArrays(mode, 0, (GLsizei)(vertexes.size() / FLOATS_PER_COLORED_VERTEX));
+	glDisableClientState(GL_VERTEX_ARRAY);
+	glDisableClientState(GL_COLOR_ARRAY);
+}
@@ -0,0 +1,98 @@
+//
+//  RendererGl.h
+//
+//  A module to draw the game using fixed-function OpenGL.
+//
+
+#ifndef RENDERER_GL_H
+#define RENDERER_GL_H
+
+#include <string>
+#include <vector>
+
+#include "ObjLibrary/Vector3.h"
+
+#include "Renderer.h"
+
+
+
+//
+//  RendererGl
+//
+//  A Renderer that sends every command straight to OpenGL,
+//    GLU, and GLUT.  All functions must be called from the
+//    thread that owns the OpenGL context.
+//
+class RendererGl : public Renderer
+{
+public:
+	RendererGl () = default;
+	RendererGl (const RendererGl& original) = default;
+	virtual ~RendererGl () = default;
+	RendererGl& operator= (const RendererGl& original) = default;
+
+	virtual void beginFrame ();
+	virtual void endFrame ();
+
+	virtual void lookAt (const ObjLibrary::Vector3& eye,
+	                     const ObjLibrary::Vector3& look_at,
+	                     const ObjLibrary::Vector3& up);
+	virtual void pushMatrix ();
+	virtual void popMatrix ();
+	virtual void translate (double x, double y, double z);
+	virtual void rotate (double degrees,
+	                     double x, double y, double z);
+	virtual void scale (double x, double y, double z);
+
+	virtual void setColor (double red, double green, double blue);
+	virtual void setTexturing (bool is_enabled);
+	virtual void bindTexture (const std::string& name);
+	virtual void setDepthWrite (bool is_enabled);
+	virtual void setLineWidth (float width);
+
+	virtual void drawDisplayList (
+	                      const ObjLibrary::DisplayList& list,
+	                      unsigned int vertex_count);
+	virtual void drawAnimation (const AnimationModel& model,
+	                            unsigned int frame0,
+	                            unsigned int frame1,
+	                            float fraction,
+	                            unsigned int level);
+	virtual void drawLineStrip (
+	          const std::vector<ObjLibrary::Vector3>& vertexes);
+	virtual void drawColoredLines (
+	                      const std::vector<float>& vertexes);
+	virtual void drawColoredTriangles (
+	                      const std::vector<float>& vertexes);
+	virtual void drawSphere (double radius,
+	                         unsigned int slices,
+	                         unsigned int stacks);
+
+	virtual void begin2dView (int width, int height);
+	virtual void end2dView ();
+	virtual void drawText (const ObjLibrary::SpriteFont& font,
+	                       const std::string& text,
+	                       float x, float y);
+
+private:
+	//
+	//  Helper Function: drawColoredArrays
+	//
+	//  Purpose: To draw interleaved colored vertexes as the
+	//           specified primitive type.
+	//  Parameter(s):
+	//    <1> mode: The OpenGL primitive type
+	//    <2> vertexes: The vertex data in GL_C3F_V3F format
+	//  Precondition(s): N/A
+	//  Returns: N/A
+	//  Side Effect: The vertexes are drawn with one call to
+	//               glDrawArrays.  The vertex and color arrays
+	//               are disabled afterwards.
+	//
+	void drawColoredArrays (unsigned int mode,
+	                        const std::vector<float>& vertexes);
+};
+
+
+
+#endif
@@ -0,0 +1,315 @@
+//
+//  RendererRecording.cpp
+//
+
+#include <cassert>
+#include <string>
+#include <vector>
+#include <iostream>
+#include <initializer_list>
+
+#include "ObjLibrary/Vector3.h"
+#include "ObjLibrary/DisplayList.h"
+#include "ObjLibrary/SpriteFont.h"
+
+#include "AnimationModel.h"
+#include "RendererRecording.h"
+
+using namespace std;
+using namespace ObjLibrary;
+namespace
+{
+	const RendererRecording::Stats STATS_ZERO = { 0, 0, 0, 0, 0 };
+
+	const float LINE_WIDTH_DEFAULT = 1.0f;
+}
+
+
+
+RendererRecording :: RendererRecording ()
+		: mv_commands()
+		, m_current(STATS_ZERO)
+		, m_last_frame(STATS_ZERO)
+		, m_is_texturing(false)
+		, m_texture_name()
+		, m_is_depth_write(true)
+		, m_line_width(LINE_WIDTH_DEFAULT)
+{
+	ma_color[0] = 1.0;
+	ma_color[1] = 1.0;
+	ma_color[2] = 1.0;
+}
+
+
+
+const RendererRecording::Stats& RendererRecording :: getCurrentStats () const
+{
+	return m_current;
+}
+
+const RendererRecording::Stats& RendererRecording :: getLastFrameStats () const
+{
+	return m_last_frame;
+}
+
+unsigned int RendererRecording :: getCommandCount () const
+{
+	return mv_commands.size();
+}
+
+void RendererRecording :: writeCommands (ostream& r_out) const
+{
+	for(unsigned int c = 0; c < mv_commands.size(); c++)
+	{
+		const Command& command = mv_commands[c];
+		r_out << command.ma_name;
+		for(unsigned int a = 0; a < command.m_argument_count; a++)
+			r_out << " " << command.ma_arguments[a];
+		if(!command.m_text.empty())
+			r_out << " \"" << command.m_text << "\"";
+		r_out << "\n";
+	}
+}
+
+void RendererRecording :: writeStats (ostream& r_out,
+                                      const Stats& stats)
+{
+	r_out << "draw_calls "              << stats.m_draw_calls
+	      << " vertexes "               << stats.m_vertexes
+	      << " state_changes "          << stats.m_state_changes
+	      << " redundant_state_changes " << stats.m_redundant_state_changes
+	      << " matrix_operations "      << stats.m_matrix_operations << "\n";
+}
+
+
+
+void RendererRecording :: beginFrame ()
+{
+	mv_commands.clear();
+	m_current = STATS_ZERO;
+	addCommand("begin_frame", {}, "");
+}
+
+void RendererRecording :: endFrame ()
+{
+	addCommand("end_frame", {}, "");
+	m_last_frame = m_current;
+}
+
+
+
+void RendererRecording :: lookAt (const Vector3& eye,
+                                  const Vector3& look_at,
+                                  const Vector3& up)
+{
+	assert(eye != look_at);
+
+	addCommand("look_at", {     eye.x,     eye.y,     eye.z,
+	                        look_at.x, look_at.y, look_at.z,
+	                             up.x,      up.y,      up.z }, "");
+	m_current.m_matrix_operations++;
+}
+
+void RendererRecording :: pushMatrix ()
+{
+	addCommand("push_matrix", {}, "");
+	m_current.m_matrix_operations++;
+}
+
+void RendererRecording :: popMatrix ()
+{
+	addCommand("pop_matrix", {}, "");
+	m_current.m_matrix_operations++;
+}
+
+void RendererRecording :: translate (double x, double y, double z)
+{
+	addCommand("translate", { x, y, z }, "");
+	m_current.m_matrix_operations++;
+}
+
+void RendererRecording :: rotate (double degrees,
+                                  double x, double y, double z)
+{
+	addCommand("rotate", { degrees, x, y, z }, "");
+	m_current.m_matrix_operations++;
+}
+
+void RendererRecording :: scale (double x, double y, double z)
+{
+	addCommand("scale", { x, y, z }, "");
+	m_current.m_matrix_operations++;
+}
+
+
+
+void RendererRecording :: setColor (double red, double green, double blue)
+{
+	addCommand("color", { red, green, blue }, "");
+	addStateChange(red   == ma_color[0] &&
+	               green == ma_color[1] &&
+	               blue  == ma_color[2]);
+	ma_color[0] = red;
+	ma_color[1] = green;
+	ma_color[2] = blue;
+}
+
+void RendererRecording :: setTexturing (bool is_enabled)
+{
+	addCommand("texturing", { is_enabled ? 1.0 : 0.0 }, "");
+	addStateChange(is_enabled == m_is_texturing);
+	m_is_texturing = is_enabled;
+}
+
+void RendererRecording :: bindTexture (const string& name)
+{
+	addCommand("bind_texture", {}, name);
+	addStateChange(name == m_texture_name);
+	m_texture_name = name;
+}
+
+void RendererRecording :: setDepthWrite (bool is_enabled)
+{
+	addCommand("depth_write", { is_enabled ? 1.0 : 0.0 }, "");
+	addStateChange(is_enabled == m_is_depth_write);
+	m_is_depth_write = is_enabled;
+}
+
+void RendererRecording :: setLineWidth (float width)
+{
+	assert(width > 0.0f);
+
+	addCommand("line_width", { width }, "");
+	addStateChange(width == m_line_width);
+	m_line_width = width;
+}
+
+
+
+void RendererRecording :: drawDisplayList (const DisplayList& /*list*/,
+                                           unsigned int vertex_count)
+{
+	addCommand("draw_list", { (double)(vertex_count) }, "");
+	addDrawCall(vertex_count);
+}
+
+void RendererRecording :: drawAnimation (const AnimationModel& model,
+                                         unsigned int frame0,
+                                         unsigned int frame1,
+                                         float fraction,
+                                         unsigned int level)
+{
+	assert(frame0 < model.getFrameCount());
+	assert(frame1 < model.getFrameCount());
+
+	unsigned int vertex_count = model.getTriangleCount(frame0, level) * 3;
+	addCommand("draw_animation", { (double)(frame0), (double)(frame1), fraction, (double)(level), (double)(vertex_count) }, "");
+	addDrawCall(vertex_count);
+}
+
+void RendererRecording :: drawLineStrip (const vector<Vector3>& vertexes)
+{
+	addCommand("draw_line_strip", { (double)(vertexes.size()) }, "");
+	addDrawCall(vertexes.size());
+}
+
+void RendererRecording :: drawColoredLines (const vector<float>& vertexes)
+{
+	assert(vertexes.size() % (FLOATS_PER_COLORED_VERTEX * 2) == 0);
+
+	unsigned int vertex_count = vertexes.size() / FLOATS_PER_COLORED_VERTEX;
+	addCommand("draw_colored_lines", { (double)(vertex_count) }, "");
+	addDrawCall(vertex_count);
+	forgetColor();
+}
+
+void RendererRecording :: drawColoredTriangles (const vector<float>& vertexes)
+{
+	assert(vertexes.size() % (FLOATS_PER_COLORED_VERTEX * 3) == 0);
+
+	unsigned int vertex_count = vertexes.size() / FLOATS_PER_COLORED_VERTEX;
+	addCommand("draw_colored_triangles", { (double)(vertex_count) }, "");
+	addDrawCall(vertex_count);
+	forgetColor();
+}
+
+void RendererRecording :: drawSphere (double radius,
+                                      unsigned int slices,
+                                      unsigned int stacks)
+{
+	assert(radius >= 0.0);
+	assert(slices >= 3);
+	assert(stacks >= 2);
+
+	// glutSolidSphere draws one quad strip per stack
+	unsigned int vertex_count = stacks * (slices + 1) * 2;
+	addCommand("draw_sphere", { radius, (double)(slices), (double)(stacks) }, "");
+	addDrawCall(vertex_count);
+}
+
+
+
+void RendererRecording :: begin2dView (int width, int height)
+{
+	assert(width  > 0);
+	assert(height > 0);
+
+	addCommand("begin_2d", { (double)(width), (double)(height) }, "");
+	m_current.m_matrix_operations++;
+}
+
+void RendererRecording :: end2dView ()
+{
+	addCommand("end_2d", {}, "");
+	m_current.m_matrix_operations++;
+}
+
+void RendererRecording :: drawText (const SpriteFont& /*font*/,
+                                    const string& text,
+                                    float x, float y)
+{
+	// one textured quad per character
+	addCommand("draw_text", { x, y }, text);
+	addDrawCall(text.length() * 4);
+}
+
+
+
+void RendererRecording :: addCommand (const char* a_name,
+                                      initializer_list<double> arguments,
+                                      const string& text)
+{
+	assert(a_name != NULL);
+	assert(arguments.size() <= ARGUMENT_COUNT_MAX);
+
+	Command command;
+	command.ma_name          = a_name;
+	command.m_argument_count = 0;
+	for(double argument : arguments)
+	{
+		command.ma_arguments[command.m_argument_count] = argument;
+		command.m_argument_count++;
+	}
+	command.m_text = text;
+	mv_commands.push_back(command);
+}
+
+void RendererRecording :: addStateChange (bool is_redundant)
+{
+	m_current.m_state_changes++;
+	if(is_redundant)
+		m_current.m_redundant_state_changes++;
+}
+
+void RendererRecording :: addDrawCall (unsigned int vertex_count)
+{
+	m_current.m_draw_calls++;
+	m_current.m_vertexes += vertex_count;
+}
+
+void RendererRecording :: forgetColor ()
+{
+	ma_color[0] = -1.0;
+	ma_color[1] = -1.0;
+	ma_color[2] = -1.0;
+}
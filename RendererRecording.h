@@ -0,0 +1,281 @@
+//
+//  RendererRecording.h
+//
+//  A module to record and count drawing commands without
+//    drawing anything.
+//
+
+#ifndef RENDERER_RECORDING_H
+#define RENDERER_RECORDING_H
+
+#include <string>
+#include <vector>
+#include <iostream>
+#include <initializer_list>
+
+#include "ObjLibrary/Vector3.h"
+
+#include "Renderer.h"
+
+
+
+//
+//  RendererRecording
+//
+//  A Renderer that does not use OpenGL.  Instead, it keeps a
+//    list of the commands issued during the current frame and
+//    counts the draw calls, vertexes, state changes, and matrix
+//    operations.  The command list can be written to a stream
+//    in a simple text format, one command per line.
+//
+//  A state change is any call to setColor, setTexturing,
+//    bindTexture, setDepthWrite, or setLineWidth.  A state
+//    change is also counted as redundant if it sets the state
+//    to the value it already had.
+//
+//  The statistics for the previous frame are kept until the
+//    next frame ends, so they can be read between frames.
+//
+class RendererRecording : public Renderer
+{
+public:
+	//
+	//  Stats
+	//
+	//  A record of the amount of work done in one frame.
+	//
+	struct Stats
+	{
+		unsigned int m_draw_calls;
+		unsigned int m_vertexes;
+		unsigned int m_state_changes;
+		unsigned int m_redundant_state_changes;
+		unsigned int m_matrix_operations;
+	};
+
+public:
+	//
+	//  Default Constructor
+	//
+	//  Purpose: To create a new RendererRecording.
+	//  Parameter(s): N/A
+	//  Precondition(s): N/A
+	//  Returns: N/A
+	//  Side Effect: A new RendererRecording is created with no
+	//               recorded commands.
+	//
+	RendererRecording ();
+
+	RendererRecording (const RendererRecording& original) = default;
+	virtual ~RendererRecording () = default;
+	RendererRecording& operator= (const RendererRecording& original) = default;
+
+	//
+	//  getCurrentStats
+	//
+	//  Purpose: To determine the statistics for the frame
+	//           currently being drawn.
+	//  Parameter(s): N/A
+	//  Precondition(s): N/A
+	//  Returns: The statistics for the commands since the last
+	//           call to beginFrame.
+	//  Side Effect: N/A
+	//
+	const Stats& getCurrentStats () const;
+
+	//
+	//  getLastFrameStats
+	//
+	//  Purpose: To determine the statistics for the last
+	//           complete frame.
+	//  Parameter(s): N/A
+	//  Precondition(s): N/A
+	//  Returns: The statistics for the frame that ended with
+	//           the last call to endFrame.  If no frame has
+	//           ended, all values are 0.
+	//  Side Effect: N/A
+	//
+	const Stats& getLastFrameStats () const;
+
+	//
+	//  getCommandCount
+	//
+	//  Purpose: To determine the number of commands recorded
+	//           for the current frame.
+	//  Parameter(s): N/A
+	//  Precondition(s): N/A
+	//  Returns: The number of commands since the last call to
+	//           beginFrame.
+	//  Side Effect: N/A
+	//
+	unsigned int getCommandCount () const;
+
+	//
+	//  writeCommands
+	//
+	//  Purpose: To write the recorded commands to the specified
+	//           stream.
+	//  Parameter(s):
+	//    <1> r_out: The stream to write to
+	//  Precondition(s): N/A
+	//  Returns: N/A
+	//  Side Effect: The commands recorded since the last call to
+	//               beginFrame are written to r_out, one per
+	//               line.  Each line is the command name followed
+	//               by its arguments separated by spaces.
+	//
+	void writeCommands (std::ostream& r_out) const;
+
+	//
+	//  writeStats
+	//
+	//  Purpose: To write the specified statistics to the
+	//           specified stream.
+	//  Parameter(s):
+	//    <1> r_out: The stream to write to
+	//    <2> stats: The statistics to write
+	//  Precondition(s): N/A
+	//  Returns: N/A
+	//  Side Effect: The statistics are written to r_out on a
+	//               single line.
+	//
+	static void writeStats (std::ostream& r_out,
+	                        const Stats& stats);
+
+	virtual void beginFrame ();
+	virtual void endFrame ();
+
+	virtual void lookAt (const ObjLibrary::Vector3& eye,
+	                     const ObjLibrary::Vector3& look_at,
+	                     const ObjLibrary::Vector3& up);
+	virtual void pushMatrix ();
+	virtual void popMatrix ();
+	virtual void translate (double x, double y, double z);
+	virtual void rotate (double degrees,
+	                     double x, double y, double z);
+	virtual void scale (double x, double y, double z);
+
+	virtual void setColor (double red, double green, double blue);
+	virtual void setTexturing (bool is_enabled);
+	virtual void bindTexture (const std::string& name);
+	virtual void setDepthWrite (bool is_enabled);
+	virtual void setLineWidth (float width);
+
+	virtual void drawDisplayList (
+	                      const ObjLibrary::DisplayList& list,
+	                      unsigned int vertex_count);
+	virtual void drawAnimation (const AnimationModel& model,
+	                            unsigned int frame0,
+	                            unsigned int frame1,
+	                            float fraction,
+	                            unsigned int level);
+	virtual void drawLineStrip (
+	          const std::vector<ObjLibrary::Vector3>& vertexes);
+	virtual void drawColoredLines (
+	                      const std::vector<float>& vertexes);
+	virtual void drawColoredTriangles (
+	                      const std::vector<float>& vertexes);
+	virtual void drawSphere (double radius,
+	                         unsigned int slices,
+	                         unsigned int stacks);
+
+	virtual void begin2dView (int width, int height);
+	virtual void end2dView ();
+	virtual void drawText (const ObjLibrary::SpriteFont& font,
+	                       const std::string& text,
+	                       float x, float y);
+
+private:
+	//
+	//  ARGUMENT_COUNT_MAX
+	//
+	//  The maximum number of numeric arguments for a command.
+	//
+	static const unsigned int ARGUMENT_COUNT_MAX = 9;
+
+	//
+	//  Command
+	//
+	//  A record of one command.
+	//
+	struct Command
+	{
+		const char* ma_name;
+		double ma_arguments[ARGUMENT_COUNT_MAX];
+		unsigned int m_argument_count;
+		std::string m_text;
+	};
+
+	//
+	//  Helper Function: addCommand
+	//
+	//  Purpose: To record a command.
+	//  Parameter(s):
+	//    <1> a_name: The command name
+	//    <2> arguments: The numeric arguments
+	//    <3> text: The text argument, if any
+	//  Precondition(s):
+	//    <1> a_name != NULL
+	//    <2> arguments.size() <= ARGUMENT_COUNT_MAX
+	//  Returns: N/A
+	//  Side Effect: The command is added to the command list.
+	//
+	void addCommand (const char* a_name,
+	                 std::initializer_list<double> arguments,
+	                 const std::string& text);
+
+	//
+	//  Helper Function: addStateChange
+	//
+	//  Purpose: To count a state change.
+	//  Parameter(s):
+	//    <1> is_redundant: Whether the state change did not
+	//                      change the state
+	//  Precondition(s): N/A
+	//  Returns: N/A
+	//  Side Effect: The state change counts are updated.
+	//
+	void addStateChange (bool is_redundant);
+
+	//
+	//  Helper Function: addDrawCall
+	//
+	//  Purpose: To count a draw call.
+	//  Parameter(s):
+	//    <1> vertex_count: The number of vertexes drawn
+	//  Precondition(s): N/A
+	//  Returns: N/A
+	//  Side Effect: The draw call and vertex counts are
+	//               updated.
+	//
+	void addDrawCall (unsigned int vertex_count);
+
+	//
+	//  Helper Function: forgetColor
+	//
+	//  Purpose: To record that the current color is unknown.
+	//  Parameter(s): N/A
+	//  Precondition(s): N/A
+	//  Returns: N/A
+	//  Side Effect: The current color is set to an invalid
+	//               value, so the next color change is never
+	//               counted as redundant.
+	//
+	void forgetColor ();
+
+private:
+	std::vector<Command> mv_commands;
+	Stats m_current;
+	Stats m_last_frame;
+
+	// the current state, used to detect redundant changes
+	double ma_color[3];
+	bool m_is_texturing;
+	std::string m_texture_name;
+	bool m_is_depth_write;
+	float m_line_width;
+};
+
+
+
+#endif
@@ -3,12 +3,13 @@
 //
 
 #include <cassert>
+#include <cstddef>
+#include <deque>
 
-#include "GetGlut.h"
 #include "Pi.h"
 #include "Random.h"
+#include "RandomStream.h"
 #include "ObjLibrary/Vector3.h"
-#include "ObjLibrary/ObjModel.h"
 #include "ObjLibrary/DisplayList.h"
 
 #include "PhysicsFrameLength.h"
@@ -16,6 +17,13 @@
 #include "Heightmap.h"
 #include "Disk.h"
 #include "World.h"
+#include "Renderer.h"
+#include "AssetLoader.h"
+#include "LodView.h"
+#include "LodModel.h"
+#include "DebugOverlay.h"
+#include "Profiler.h"
+#include "GameCheckpoint.h"
 #include "Ring.h"
 
 
@@ -26,7 +34,52 @@ namespace
 	const float ROTATION_RATE   = 75.0f;  // degrees per meter
 	const float MOVE_SPEED_BASE =  2.5f;  // meters per second
 
-	DisplayList g_display_list;
+	LodModel g_model;
+
+	//
+	//  writeNodePositions
+	//
+	//  Purpose: To save the positions of the specified nodes.
+	//  Parameter(s):
+	//    <1> r_checkpoint: The GameCheckpoint to save to
+	//    <2> nodes: The nodes
+	//  Precondition(s):
+	//    <1> !r_checkpoint.isEmpty()
+	//  Returns: N/A
+	//  Side Effect: The number of nodes and their positions are
+	//               written to the end of r_checkpoint.
+	//
+	void writeNodePositions (GameCheckpoint& r_checkpoint,
+	                         const deque<Nodes>& nodes)
+	{
+		r_checkpoint.writeUnsigned((unsigned int)(nodes.size()));
+		for(unsigned int i = 0; i < nodes.size(); i++)
+			r_checkpoint.writeVector3(nodes[i].pos_node);
+	}
+
+	//
+	//  readNodePositions
+	//
+	//  Purpose: To restore nodes saved by writeNodePositions.
+	//  Parameter(s):
+	//    <1> checkpoint: The GameCheckpoint to restore from
+	//    <2> r_offset: Where in checkpoint the nodes start
+	//    <3> r_nodes: The list to restore the nodes to
+	//  Precondition(s): N/A
+	//  Returns: N/A
+	//  Side Effect: r_nodes is set to nodes at the saved
+	//               positions, with no cost or links, and
+	//               r_offset is advanced past them.
+	//
+	void readNodePositions (const GameCheckpoint& checkpoint,
+	                        size_t& r_offset,
+	                        deque<Nodes>& r_nodes)
+	{
+		unsigned int count = checkpoint.readUnsigned(r_offset);
+		r_nodes.clear();
+		for(unsigned int i = 0; i < count; i++)
+			r_nodes.push_back({ checkpoint.readVector3(r_offset), 0.0, 0.0 });
+	}
 }
 
 
@@ -39,16 +92,29 @@ const unsigned int Ring :: POINTS      = 1;
 
 bool Ring :: isModelsLoaded ()
 {
-	return g_display_list.isReady();
+	return g_model.isReady();
 }
 
-void Ring :: loadModels ()
+void Ring :: loadModels (AssetLoader& r_loader)
 {
 	assert(!isModelsLoaded());
 
-	g_display_list = ObjModel("Models/Ring.obj").getDisplayList();
+	r_loader.addLodModel("Models/Ring.obj", g_model);
+}
 
+void Ring :: drawModel (Renderer& r_renderer,
+                        const LodView& view,
+                        const Vector3& position,
+                        float rotation)
+{
 	assert(isModelsLoaded());
+
+	unsigned int level = g_model.chooseLevel(view, position, RADIUS);
+	r_renderer.pushMatrix();
+		r_renderer.translate(position.x, position.y, position.z);
+		r_renderer.rotate(rotation, 0.0, 1.0, 0.0);
+		r_renderer.drawDisplayList(g_model.getDisplayList(level), g_model.getVertexCount(level));
+	r_renderer.popMatrix();
 }
 
 
@@ -62,13 +128,13 @@ Ring :: Ring ()
 {
 }
 
-Ring :: Ring (const ObjLibrary::Vector3& position, int i, std::vector<Nodes> ring_Nodes)
+Ring :: Ring (const ObjLibrary::Vector3& position, int i,
+              RandomStream& r_random)
 		: m_position(position)
-		, m_rotation(random1(360.0f))
+		, m_rotation(r_random.random1(360.0f))
 		, m_is_taken(false)
 		, m_target_position(position)
 		, source_id(i)
-		, ring_nodes(ring_Nodes)
 		, nodepos(position)
 {
 }
@@ -80,52 +146,79 @@ const Vector3& Ring :: getPosition () const
 	return m_position;
 }
 
+float Ring :: getRotation () const
+{
+	return m_rotation;
+}
+
 bool Ring :: isTaken () const
 {
 	return m_is_taken;
 }
 
-void Ring :: draw () const
+void Ring :: getPathPositions (vector<Vector3>& rv_positions) const
+{
+	if(isTaken())
+		return;
+
+	rv_positions.push_back(nodepos);
+	for(unsigned int i = 0; i < FinalClosedList.size(); i++)
+		rv_positions.push_back(FinalClosedList[i].pos_node);
+	rv_positions.push_back(m_target_position);
+}
+
+void Ring :: draw (Renderer& r_renderer, const LodView& view) const
 {
 	assert(isModelsLoaded());
 
 	if(isTaken())
 		return;
 
-	glPushMatrix();
-		glTranslated(m_position.x, m_position.y, m_position.z);
-		glRotated(m_rotation, 0.0, 1.0, 0.0);
-		g_display_list.draw();
-	glPopMatrix();
-	
+	drawModel(r_renderer, view, m_position, m_rotation);
 }
 
-void Ring :: drawPath ()
+void Ring :: drawPath (Renderer& r_renderer) const
 {
-	if (isNodePosition() && !drawList.empty())
-		drawList.erase(drawList.begin());
-	
 	const float LINE_ABOVE = 0.5f;
 
-	glLineWidth(3.0);
-	glColor3d(1.0, 1.0, 1.0);
-	glBegin(GL_LINE_STRIP);
-		glVertex3d(m_position       .x, m_position       .y,              m_position       .z);
-		glVertex3d(m_position       .x, m_position       .y + LINE_ABOVE, m_position       .z);
-		for (int i = 0; i < drawList.size(); i++)
-		{
-			glVertex3d(drawList[i].pos_node.x, drawList[i].pos_node.y + LINE_ABOVE, drawList[i].pos_node.z);
-		}
-		
-	glEnd();
-	glLineWidth(1.0);
+	vector<Vector3> line_strip;
+	line_strip.reserve(drawList.size() + 2);
+	line_strip.push_back(m_position);
+	line_strip.push_back(m_position + Vector3(0.0, LINE_ABOVE, 0.0));
+	for (int i = 0; i < drawList.size(); i++)
+	{
+		line_strip.push_back(drawList[i].pos_node + Vector3(0.0, LINE_ABOVE, 0.0));
+	}
+
+	r_renderer.setLineWidth(3.0);
+	r_renderer.setColor(1.0, 1.0, 1.0);
+	r_renderer.drawLineStrip(line_strip);
+	r_renderer.setLineWidth(1.0);
 
 	
 }
 
+void Ring :: saveCheckpoint (GameCheckpoint& r_checkpoint) const
+{
+	assert(!r_checkpoint.isEmpty());
+
+	r_checkpoint.writeVector3(m_position);
+	r_checkpoint.writeFloat  (m_rotation);
+	r_checkpoint.writeBool   (m_is_taken);
+	r_checkpoint.writeVector3(m_target_position);
+	r_checkpoint.writeInt    (source_id);
+	r_checkpoint.writeInt    (target_id);
+	r_checkpoint.writeVector3(nodepos);
+	r_checkpoint.writeVector3(startpos);
+	writeNodePositions(r_checkpoint, FinalClosedList);
+	writeNodePositions(r_checkpoint, drawList);
+	writeNodePositions(r_checkpoint, drawListsphere);
+}
 
 
-void Ring :: update (World& world, std::vector<Nodes> target_node_find)
+
+void Ring :: update (const World& world,
+                     RandomStream& r_random)
 {
 	if(!isTaken())
 	{
@@ -141,7 +234,7 @@ void Ring :: update (World& world, std::vector<Nodes> target_node_find)
 				ClosedList2.clear();
 				FinalClosedList.clear();
 				startpos = m_position;
-				chooseTarget(target_node_find.size(), target_node_find);
+				chooseTarget(world.getNodes(), r_random);
 				
 				MM(world);
 
@@ -178,6 +271,9 @@ void Ring :: update (World& world, std::vector<Nodes> target_node_find)
 
 		// maintain disk height
 		m_position.y = HALF_HEIGHT + world.getHeightOnDisk(m_position);
+
+		if (isNodePosition() && !drawList.empty())
+			drawList.erase(drawList.begin());
 	}
 }
 
@@ -186,6 +282,29 @@ void Ring :: markTaken ()
 	m_is_taken = true;
 }
 
+void Ring :: restoreCheckpoint (const GameCheckpoint& checkpoint,
+                                size_t& r_offset)
+{
+	m_position        = checkpoint.readVector3(r_offset);
+	m_rotation        = checkpoint.readFloat  (r_offset);
+	m_is_taken        = checkpoint.readBool   (r_offset);
+	m_target_position = checkpoint.readVector3(r_offset);
+	source_id         = checkpoint.readInt    (r_offset);
+	target_id         = checkpoint.readInt    (r_offset);
+	nodepos           = checkpoint.readVector3(r_offset);
+	startpos          = checkpoint.readVector3(r_offset);
+	readNodePositions(checkpoint, r_offset, FinalClosedList);
+	readNodePositions(checkpoint, r_offset, drawList);
+	readNodePositions(checkpoint, r_offset, drawListsphere);
+
+	// the search lists are rebuilt by the next search
+	OpenList.clear();
+	OpenList2.clear();
+	ClosedList.clear();
+	ClosedList2.clear();
+	Neighbours.clear();
+}
+
 void Ring::getnextnode()
 {
 	nodepos = FinalClosedList.front().pos_node;
@@ -249,29 +368,45 @@ void Ring::moveTowardsTarget(const World& world)
 }
 
 
-void Ring::chooseTarget(int node_id, std::vector<Nodes> target_node_find)
+void Ring::chooseTarget(const std::vector<Nodes>& v_nodes,
+                        RandomStream& r_random)
 {
-	unsigned int node_index = random1(node_id);
+	assert(!v_nodes.empty());
+
+	unsigned int node_index = r_random.random1(v_nodes.size());
 	target_id = node_index;
-	assert(node_index <  target_node_find.size());
-	m_target_position = target_node_find[node_index].pos_node;
+	assert(node_index <  v_nodes.size());
+	m_target_position = v_nodes[node_index].pos_node;
 
 
 	
 }
 
-void Ring::MM(World& world)
+void Ring::MM(const World& world)
 {
+	PROFILE_SCOPE(SECTION_SEARCH);
+	PROFILE_COUNT(COUNTER_SEARCHES, 1);
 	
 
 	
 
 	//double low_cost = 100.0;
 
-	OpenList.push_back(ring_nodes[source_id]);
-	OpenList2.push_back(ring_nodes[target_id]);
-	ClosedList.push_back(ring_nodes[source_id]);
-	ClosedList2.push_back(ring_nodes[target_id]);
+	// the search costs are kept in the copies, never in the shared graph
+	const std::vector<Nodes>& v_nodes = world.getNodes();
+	Nodes source = v_nodes[source_id];
+	source.cost = 0.0;
+	source.h    = 0.0;
+	source.f    = 0.0;
+	Nodes target = v_nodes[target_id];
+	target.cost = 0.0;
+	target.h    = 0.0;
+	target.f    = 0.0;
+
+	OpenList.push_back(source);
+	OpenList2.push_back(target);
+	ClosedList.push_back(source);
+	ClosedList2.push_back(target);
 
 	//cout << "Low_Cost: " << low_cost;
 
@@ -333,16 +468,18 @@ void Ring::MM(World& world)
 			if ((OpenList.front().f <= OpenList2.front().f) && !OpenList.empty())
 			{
 				current_node = OpenList.front();
+				PROFILE_COUNT(COUNTER_NODES_EXPANDED, 1);
 
 				Neighbours.clear();
 
 				for (int j = 0; j < current_node.all_links.size(); j++)
 				{
-					int tempID = getNodeID(current_node.all_links[j].other_node);///////////////////////
-					ring_nodes[tempID].cost = calculateweight(ring_nodes[tempID].pos_node, current_node.pos_node, world);
-					ring_nodes[tempID].h = m_target_position.getDistanceXZ(current_node.pos_node);
-					ring_nodes[tempID].f = ring_nodes[tempID].cost + ring_nodes[tempID].h;
-					Neighbours.push_back(ring_nodes[tempID]);
+					int tempID = getNodeID(v_nodes, current_node.all_links[j].other_node);///////////////////////
+					Nodes neighbour = v_nodes[tempID];
+					neighbour.cost = calculateweight(neighbour.pos_node, current_node.pos_node, world);
+					neighbour.h = m_target_position.getDistanceXZ(current_node.pos_node);
+					neighbour.f = neighbour.cost + neighbour.h;
+					Neighbours.push_back(neighbour);
 				}
 
 				for (int i = 0; i < Neighbours.size(); i++)
@@ -376,16 +513,18 @@ void Ring::MM(World& world)
 			else if ((OpenList2.front().f <= OpenList.front().f) && !OpenList2.empty())
 			{
 				current_node2 = OpenList2.front();
+				PROFILE_COUNT(COUNTER_NODES_EXPANDED, 1);
 
 				Neighbours.clear();
 
 				for (int j = 0; j < current_node2.all_links.size(); j++)
 				{
-					int tempID = getNodeID(current_node2.all_links[j].other_node);///////////////////////
-					ring_nodes[tempID].cost = calculateweight(ring_nodes[tempID].pos_node, current_node2.pos_node, world);
-					ring_nodes[tempID].h = m_target_position.getDistanceXZ(current_node2.pos_node);
-					ring_nodes[tempID].f = ring_nodes[tempID].cost + ring_nodes[tempID].h;
-					Neighbours.push_back(ring_nodes[tempID]);
+					int tempID = getNodeID(v_nodes, current_node2.all_links[j].other_node);///////////////////////
+					Nodes neighbour = v_nodes[tempID];
+					neighbour.cost = calculateweight(neighbour.pos_node, current_node2.pos_node, world);
+					neighbour.h = m_target_position.getDistanceXZ(current_node2.pos_node);
+					neighbour.f = neighbour.cost + neighbour.h;
+					Neighbours.push_back(neighbour);
 				}
 
 				for (int i = 0; i < Neighbours.size(); i++)
@@ -517,18 +656,18 @@ bool Ring::similarClosedList()
 	return 0;
 }
 
-int Ring::getNodeID(Vector3 pos)
+int Ring::getNodeID(const std::vector<Nodes>& v_nodes, Vector3 pos)
 {
-	for (int i = 0; i < ring_nodes.size(); i++)
+	for (int i = 0; i < v_nodes.size(); i++)
 	{
-		if (ring_nodes[i].pos_node == pos)
+		if (v_nodes[i].pos_node == pos)
 			return i;
 	}
 	return 0;
 }
 
 
-double Ring::calculateweight(Vector3 posa, Vector3 posb, World& world)
+double Ring::calculateweight(Vector3 posa, Vector3 posb, const World& world)
 {
 
 	unsigned int disk_type = world.getClosestDisk(startpos).getDiskType();
@@ -569,53 +708,23 @@ double Ring::calculateweight(Vector3 posa, Vector3 posb, World& world)
 
 }
 
-void Ring::drawSpheres() const
+void Ring::addSearchMarkers(DebugOverlay& r_overlay) const
 {
-	//glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
-	//glMatrixMode(GL_MODELVIEW);
-	glColor3d(1.0, 1.0, 1.0);
-	glPushMatrix();
-		glTranslated(m_target_position.x, 0.1, m_target_position.z);
-		//glScaled(3.0, 3.0, 3.0);
-		glutSolidSphere(3.0, 50, 50);
-
-	glPopMatrix();
-
-	glColor3d(0.0, 1.0, 1.0);
-	glPushMatrix();
-		glTranslated(startpos.x, 0.1, startpos.z);
-		//glScaled(3.0, 3.0, 3.0);
-		glutSolidSphere(3.0, 50, 50);
+	r_overlay.addMarker(Vector3(m_target_position.x, 0.1, m_target_position.z), 3.0f, 1.0f, 1.0f, 1.0f);
+	r_overlay.addMarker(Vector3(startpos.x,          0.1, startpos.z),          3.0f, 0.0f, 1.0f, 1.0f);
 
-	glPopMatrix();
-
-//	glColor3d(0.0, 0.5, 1.0);
 	for (int i = 0; i < ClosedList.size(); i++)
 	{
 		double c = (0.5 / ClosedList.size());
-		glColor3d(0.0, 1.0 - (i *c ), 1.0);
-		glPushMatrix();
-
-		glTranslated(ClosedList[i].pos_node.x, 0.1, ClosedList[i].pos_node.z);
-		//glScaled(3.0, 3.0, 3.0);
-		glutSolidSphere(1.5, 50, 50);
-
-		glPopMatrix();
+		r_overlay.addMarker(Vector3(ClosedList[i].pos_node.x, 0.1, ClosedList[i].pos_node.z), 1.5f,
+		                    0.0f, (float)(1.0 - (i *c )), 1.0f);
 	}
 
-
-	
 	for (int i = 0; i < ClosedList2.size(); i++)
 	{
 		double c = (1 / ClosedList2.size());
-		glColor3d(1.0, 1.0 - (i* c), 1.0);
-		glPushMatrix();
-
-		glTranslated(ClosedList2[i].pos_node.x, 0.1, ClosedList2[i].pos_node.z);
-		//glScaled(3.0, 3.0, 3.0);
-		glutSolidSphere(1.5, 50, 50);
-
-		glPopMatrix();
+		r_overlay.addMarker(Vector3(ClosedList2[i].pos_node.x, 0.1, ClosedList2[i].pos_node.z), 1.5f,
+		                    1.0f, (float)(1.0 - (i* c)), 1.0f);
 	}
 }
 
@@ -8,14 +8,22 @@
 #define RING_H
 
 #include <cassert>
+#include <cstddef>
 #include <vector>
 #include <deque>
 #include <algorithm>
 
 #include "ObjLibrary/Vector3.h"
+
+#include "Renderer.h"
+#include "DebugOverlay.h"
 #include "Nodes.h"
 
 class World;
+class AssetLoader;
+class LodView;
+class RandomStream;
+class GameCheckpoint;
 
 
 
@@ -25,6 +33,11 @@ class World;
 //  A class to represent a ring pickup that wanders around the
 //    world randomly.
 //
+//  A Ring searches the movement graph of the World it is in
+//    for a path to each target.  The graph is read from the
+//    World, not copied, and the World is not changed, so many
+//    Rings in many Games can share one World.
+//
 class Ring
 {
 public:
@@ -65,14 +78,40 @@ public:
 	//
 	//  Class Function: loadModels
 	//
-	//  Purpose: To load the models for the Ring class.
-	//  Parameter(s): N/A
+	//  Purpose: To queue the models for the Ring class to be
+	//           loaded.
+	//  Parameter(s):
+	//    <1> r_loader: The AssetLoader to load the models with
 	//  Precondition(s):
 	//    <1> !isModelsLoaded()
-	//  Returns: The Ring is initialized.
-	//  Side Effect: N/A
+	//  Returns: N/A
+	//  Side Effect: The models are queued in r_loader.  The
+	//               Ring class is initialized when
+	//               r_loader.finish() returns.
 	//
-	static void loadModels ();
+	static void loadModels (AssetLoader& r_loader);
+
+	//
+	//  Class Function: drawModel
+	//
+	//  Purpose: To display the Ring model at the specified
+	//           position and rotation.
+	//  Parameter(s):
+	//    <1> r_renderer: The Renderer to draw with
+	//    <2> view: The camera information used to choose the
+	//              level of detail
+	//    <3> position: The center position of the model
+	//    <4> rotation: The rotation of the model around the Y
+	//                  axis, in degrees
+	//  Precondition(s):
+	//    <1> isModelsLoaded()
+	//  Returns: N/A
+	//  Side Effect: The Ring model is displayed.
+	//
+	static void drawModel (Renderer& r_renderer,
+	                       const LodView& view,
+	                       const ObjLibrary::Vector3& position,
+	                       float rotation);
 
 public:
 	//
@@ -94,12 +133,16 @@ public:
 	//           position.
 	//  Parameter(s):
 	//    <1> position: The center position
+	//    <2> i: The movement graph node at position
+	//    <3> r_random: The RandomStream to choose the rotation
+	//                  with
 	//  Precondition(s): N/A
 	//  Returns: N/A
 	//  Side Effect: A new Ring is created at position with no
-	//               path.
+	//               path.  r_random is advanced.
 	//
-	Ring (const ObjLibrary::Vector3& position, int i,std::vector<Nodes> ring_Nodes);
+	Ring (const ObjLibrary::Vector3& position, int i,
+	      RandomStream& r_random);
 
 	Ring (const Ring& original) = default;
 	~Ring () = default;
@@ -118,6 +161,19 @@ public:
 	//
 	const ObjLibrary::Vector3& getPosition () const;
 
+	//
+	//  getRotation
+	//
+	//  Purpose: To determine how far this Ring has rotated.
+	//  Parameter(s): N/A
+	//  Precondition(s): N/A
+	//  Returns: The rotation around the Y axis in degrees.  The
+	//           rotation increases as the Ring moves and is not
+	//           wrapped.
+	//  Side Effect: N/A
+	//
+	float getRotation () const;
+
 	//
 	//  isTaken
 	//
@@ -129,29 +185,66 @@ public:
 	//
 	bool isTaken () const;
 
+	//
+	//  getPathPositions
+	//
+	//  Purpose: To determine the positions this Ring will move
+	//           through on its current path.
+	//  Parameter(s):
+	//    <1> rv_positions: A vector to add the positions to
+	//  Precondition(s): N/A
+	//  Returns: N/A
+	//  Side Effect: If this Ring has not been taken, the node
+	//               it is moving towards, the remaining nodes on
+	//               its path, and its target position are added
+	//               to the end of rv_positions.
+	//
+	void getPathPositions (
+	         std::vector<ObjLibrary::Vector3>& rv_positions) const;
+
 	//
 	//  draw
 	//
 	//  Purpose: To display this Ring.
-	//  Parameter(s): N/A
+	//  Parameter(s):
+	//    <1> r_renderer: The Renderer to draw with
+	//    <2> view: The camera information used to choose the
+	//              level of detail
 	//  Precondition(s):
 	//    <1> isModelsLoaded()
 	//  Returns: N/A
 	//  Side Effect: This Ring is displayed.
 	//
-	void draw () const;
+	void draw (Renderer& r_renderer, const LodView& view) const;
 
 	//
 	//  drawPath
 	//
 	//  Purpose: To display the path for this Ring.
-	//  Parameter(s): N/A
+	//  Parameter(s):
+	//    <1> r_renderer: The Renderer to draw with
 	//  Precondition(s):
 	//    <1> isModelsLoaded()
 	//  Returns: N/A
 	//  Side Effect: The path for this Ring is displayed.
 	//
-	void drawPath ();
+	void drawPath (Renderer& r_renderer) const;
+
+	//
+	//  saveCheckpoint
+	//
+	//  Purpose: To save the state of this Ring.
+	//  Parameter(s):
+	//    <1> r_checkpoint: The GameCheckpoint to save to
+	//  Precondition(s):
+	//    <1> !r_checkpoint.isEmpty()
+	//  Returns: N/A
+	//  Side Effect: The position, target, and progress along
+	//               the current path for this Ring are written
+	//               to the end of r_checkpoint.  The lists used
+	//               while searching for a path are not saved.
+	//
+	void saveCheckpoint (GameCheckpoint& r_checkpoint) const;
 
 	//
 	//  update
@@ -159,11 +252,17 @@ public:
 	//  Purpose: To update this Ring for 1 frame.
 	//  Parameter(s):
 	//    <1> world: The World this Ring is in
+	//    <2> r_random: The RandomStream to choose new targets
+	//                  with
 	//  Precondition(s): N/A
 	//  Returns: N/A
-	//  Side Effect: This Ring is updated for 1 frame.
+	//  Side Effect: This Ring is updated for 1 frame.  If it
+	//               reaches a node on its drawn path, that node
+	//               is removed from the path.  If a new target
+	//               is chosen, r_random is advanced.
 	//
-	void update (World& world, std::vector<Nodes> target_node_find);
+	void update (const World& world,
+	             RandomStream& r_random);
 
 	//
 	//  markTaken
@@ -178,6 +277,25 @@ public:
 	//
 	void markTaken ();
 
+	//
+	//  restoreCheckpoint
+	//
+	//  Purpose: To return this Ring to a saved state.
+	//  Parameter(s):
+	//    <1> checkpoint: The GameCheckpoint to restore from
+	//    <2> r_offset: Where in checkpoint the state starts
+	//  Precondition(s):
+	//    <1> The state at offset r_offset was written by
+	//        saveCheckpoint for a Ring in the same World
+	//  Returns: N/A
+	//  Side Effect: This Ring is set to the state saved at
+	//               offset r_offset, and r_offset is advanced
+	//               past it.  The markers for the most recent
+	//               path search are cleared.
+	//
+	void restoreCheckpoint (const GameCheckpoint& checkpoint,
+	                        size_t& r_offset);
+
 private:
 	//
 	//  isTargetPosition
@@ -210,14 +328,17 @@ private:
 	//
 	//  Purpose: To choose a new target position for this Ring.
 	//  Parameter(s):
-	//    <1> world: The World this Ring is in
-	//  Precondition(s): N/A
+	//    <1> v_nodes: The movement graph nodes to choose from
+	//    <2> r_random: The RandomStream to choose with
+	//  Precondition(s):
+	//    <1> !v_nodes.empty()
 	//  Returns: N/A
 	//  Side Effect: A new target position is chosen for this
-	//               Ring.
+	//               Ring.  r_random is advanced.
 	//
-	void chooseTarget(int node_id, std::vector<Nodes> target_node_find);
-	void MM(World& world);
+	void chooseTarget(const std::vector<Nodes>& v_nodes,
+	                  RandomStream& r_random);
+	void MM(const World& world);
 	void getnextnode();
 	static bool valuesort(const Nodes& a, const Nodes& b);
 	bool check_similarity_closedList(Vector3 check);
@@ -227,12 +348,25 @@ private:
 	bool similarClosedList();
 
 public:
-	void drawSpheres() const;
+	//
+	//  addSearchMarkers
+	//
+	//  Purpose: To add markers for the most recent path search
+	//           by this Ring to the specified DebugOverlay.
+	//  Parameter(s):
+	//    <1> r_overlay: The DebugOverlay to add the markers to
+	//  Precondition(s): N/A
+	//  Returns: N/A
+	//  Side Effect: Markers are added to r_overlay for the
+	//               target, the start, and the nodes searched
+	//               from each end.
+	//
+	void addSearchMarkers(DebugOverlay& r_overlay) const;
 
 private:
 	bool isNodePosition() const;
-	int getNodeID(Vector3 pos);
-	double calculateweight(Vector3 posa, Vector3 posb, World& world);
+	int getNodeID(const std::vector<Nodes>& v_nodes, Vector3 pos);
+	double calculateweight(Vector3 posa, Vector3 posb, const World& world);
 	//double calculateweightring(Vector3 posa, Vector3 posb, World& world);
 private:
 	ObjLibrary::Vector3 m_position;
@@ -249,8 +383,6 @@ private:
 	std::deque<Nodes> FinalClosedList;
 
 	std::deque<Nodes> Neighbours;
-	
-	std::vector<Nodes> ring_nodes;
 
 	std::deque<Nodes> drawList;
 	std::deque<Nodes> drawListsphere;
@@ -4,11 +4,12 @@
 
 #include <cassert>
 
-#include "GetGlut.h"
 #include "ObjLibrary/Vector3.h"
-#include "ObjLibrary/ObjModel.h"
 #include "ObjLibrary/DisplayList.h"
 
+#include "Renderer.h"
+#include "AssetLoader.h"
+#include "GameCheckpoint.h"
 #include "Rod.h"
 
 using namespace ObjLibrary;
@@ -17,6 +18,7 @@ namespace
 	bool g_is_initilaized = false;
 
 	DisplayList g_display_list;
+	unsigned int g_vertex_count = 0;
 }
 
 
@@ -31,15 +33,13 @@ bool Rod :: isModelsLoaded ()
 	return g_is_initilaized;
 }
 
-void Rod :: loadModels ()
+void Rod :: loadModels (AssetLoader& r_loader)
 {
 	assert(!isModelsLoaded());
 
-	g_display_list = ObjModel("Models/Rod.obj").getDisplayList();
+	r_loader.addModel("Models/Rod.obj", g_display_list, g_vertex_count);
 
 	g_is_initilaized = true;
-
-	assert(isModelsLoaded());
 }
 
 
@@ -81,17 +81,24 @@ bool Rod :: isTaken () const
 	return m_is_taken;
 }
 
-void Rod :: draw () const
+void Rod :: draw (Renderer& r_renderer) const
 {
 	assert(isModelsLoaded());
 
 	if(isTaken())
 		return;
 
-	glPushMatrix();
-		glTranslated(m_position.x, m_position.y, m_position.z);
-		g_display_list.draw();
-	glPopMatrix();
+	r_renderer.pushMatrix();
+		r_renderer.translate(m_position.x, m_position.y, m_position.z);
+		r_renderer.drawDisplayList(g_display_list, g_vertex_count);
+	r_renderer.popMatrix();
+}
+
+void Rod :: saveCheckpoint (GameCheckpoint& r_checkpoint) const
+{
+	assert(!r_checkpoint.isEmpty());
+
+	r_checkpoint.writeBool(m_is_taken);
 }
 
 
@@ -103,6 +110,14 @@ void Rod :: markTaken ()
 	assert(invariant());
 }
 
+void Rod :: restoreCheckpoint (const GameCheckpoint& checkpoint,
+                               size_t& r_offset)
+{
+	m_is_taken = checkpoint.readBool(r_offset);
+
+	assert(invariant());
+}
+
 
 
 bool Rod :: invariant () const
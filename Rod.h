@@ -8,9 +8,15 @@
 #define ROD_H
 
 #include <cassert>
+#include <cstddef>
 
 #include "ObjLibrary/Vector3.h"
 
+#include "Renderer.h"
+
+class AssetLoader;
+class GameCheckpoint;
+
 
 
 //
@@ -69,14 +75,18 @@ public:
 	//
 	//  Class Function: loadModels
 	//
-	//  Purpose: To load the models for the Rod class.
-	//  Parameter(s): N/A
+	//  Purpose: To queue the models for the Rod class to be
+	//           loaded.
+	//  Parameter(s):
+	//    <1> r_loader: The AssetLoader to load the models with
 	//  Precondition(s):
 	//    <1> !isModelsLoaded()
-	//  Returns: The Rod is initialized.
-	//  Side Effect: N/A
+	//  Returns: N/A
+	//  Side Effect: The models are queued in r_loader.  The
+	//               Rod class is initialized when
+	//               r_loader.finish() returns.
 	//
-	static void loadModels ();
+	static void loadModels (AssetLoader& r_loader);
 
 public:
 	//
@@ -150,13 +160,30 @@ public:
 	//  draw
 	//
 	//  Purpose: To display this Rod.
-	//  Parameter(s): N/A
+	//  Parameter(s):
+	//    <1> r_renderer: The Renderer to draw with
 	//  Precondition(s):
 	//    <1> isModelsLoaded()
 	//  Returns: N/A
 	//  Side Effect: This Rod is displayed.
 	//
-	void draw () const;
+	void draw (Renderer& r_renderer) const;
+
+	//
+	//  saveCheckpoint
+	//
+	//  Purpose: To save the state of this Rod.
+	//  Parameter(s):
+	//    <1> r_checkpoint: The GameCheckpoint to save to
+	//  Precondition(s):
+	//    <1> !r_checkpoint.isEmpty()
+	//  Returns: N/A
+	//  Side Effect: Whether this Rod has been taken is written
+	//               to the end of r_checkpoint.  The position
+	//               and points never change, so they are not
+	//               saved.
+	//
+	void saveCheckpoint (GameCheckpoint& r_checkpoint) const;
 
 	//
 	//  markTaken
@@ -171,6 +198,23 @@ public:
 	//
 	void markTaken ();
 
+	//
+	//  restoreCheckpoint
+	//
+	//  Purpose: To return this Rod to a saved state.
+	//  Parameter(s):
+	//    <1> checkpoint: The GameCheckpoint to restore from
+	//    <2> r_offset: Where in checkpoint the state starts
+	//  Precondition(s):
+	//    <1> The state at offset r_offset was written by
+	//        saveCheckpoint for a Rod at the same position
+	//  Returns: N/A
+	//  Side Effect: This Rod is set to the state saved at offset
+	//               r_offset, and r_offset is advanced past it.
+	//
+	void restoreCheckpoint (const GameCheckpoint& checkpoint,
+	                        size_t& r_offset);
+
 private:
 	//
 	//  Helper Function: invariant
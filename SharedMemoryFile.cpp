@@ -0,0 +1,249 @@
+//
+//  SharedMemoryFile.cpp
+//
+
+#include <cassert>
+#include <cstddef>
+#include <iostream>
+#include <string>
+
+#ifdef _WIN32
+	#include <windows.h>
+#else	// Posix
+	#include <fcntl.h>
+	#include <sys/mman.h>
+	#include <sys/stat.h>
+	#include <unistd.h>
+#endif
+
+#include "SharedMemoryFile.h"
+
+using namespace std;
+
+
+
+SharedMemoryFile :: SharedMemoryFile ()
+		: mp_data(nullptr)
+		, m_size(0)
+		, mp_file_handle(nullptr)
+		, mp_mapping_handle(nullptr)
+{
+	assert(invariant());
+}
+
+SharedMemoryFile :: ~SharedMemoryFile ()
+{
+	close();
+}
+
+
+
+bool SharedMemoryFile :: isOpen () const
+{
+	return mp_data != nullptr;
+}
+
+size_t SharedMemoryFile :: getSize () const
+{
+	assert(isOpen());
+
+	return m_size;
+}
+
+void* SharedMemoryFile :: getData () const
+{
+	assert(isOpen());
+
+	return mp_data;
+}
+
+
+
+#ifdef _WIN32
+
+bool SharedMemoryFile :: openForWriting (const string& filename, size_t size)
+{
+	assert(!isOpen());
+	assert(filename != "");
+	assert(size > 0);
+
+	HANDLE file = CreateFileA(filename.c_str(), GENERIC_READ | GENERIC_WRITE,
+	                          FILE_SHARE_READ | FILE_SHARE_WRITE, nullptr,
+	                          OPEN_ALWAYS, FILE_ATTRIBUTE_NORMAL, nullptr);
+	if(file == INVALID_HANDLE_VALUE)
+	{
+		cerr << "Error in SharedMemoryFile: Could not open file \"" << filename << "\"" << endl;
+		return false;
+	}
+
+	// the mapping sets the file size
+	HANDLE mapping = CreateFileMappingA(file, nullptr, PAGE_READWRITE,
+	                                    (DWORD)((unsigned long long)(size) >> 32),
+	                                    (DWORD)(size), nullptr);
+	void* p_data = nullptr;
+	if(mapping != nullptr)
+		p_data = MapViewOfFile(mapping, FILE_MAP_ALL_ACCESS, 0, 0, size);
+	if(p_data == nullptr)
+	{
+		cerr << "Error in SharedMemoryFile: Could not map file \"" << filename << "\"" << endl;
+		if(mapping != nullptr)
+			CloseHandle(mapping);
+		CloseHandle(file);
+		return false;
+	}
+
+	mp_data           = p_data;
+	m_size            = size;
+	mp_file_handle    = file;
+	mp_mapping_handle = mapping;
+
+	assert(invariant());
+	return true;
+}
+
+bool SharedMemoryFile :: openForReading (const string& filename)
+{
+	assert(!isOpen());
+	assert(filename != "");
+
+	HANDLE file = CreateFileA(filename.c_str(), GENERIC_READ,
+	                          FILE_SHARE_READ | FILE_SHARE_WRITE, nullptr,
+	                          OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+	if(file == INVALID_HANDLE_VALUE)
+		return false;
+
+	LARGE_INTEGER size;
+	if(!GetFileSizeEx(file, &size) || size.QuadPart == 0)
+	{
+		CloseHandle(file);
+		return false;
+	}
+
+	HANDLE mapping = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+	void* p_data = nullptr;
+	if(mapping != nullptr)
+		p_data = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+	if(p_data == nullptr)
+	{
+		cerr << "Error in SharedMemoryFile: Could not map file \"" << filename << "\"" << endl;
+		if(mapping != nullptr)
+			CloseHandle(mapping);
+		CloseHandle(file);
+		return false;
+	}
+
+	mp_data           = p_data;
+	m_size            = (size_t)(size.QuadPart);
+	mp_file_handle    = file;
+	mp_mapping_handle = mapping;
+
+	assert(invariant());
+	return true;
+}
+
+void SharedMemoryFile :: close ()
+{
+	if(!isOpen())
+		return;
+
+	UnmapViewOfFile(mp_data);
+	CloseHandle((HANDLE)(mp_mapping_handle));
+	CloseHandle((HANDLE)(mp_file_handle));
+	mp_data           = nullptr;
+	m_size            = 0;
+	mp_file_handle    = nullptr;
+	mp_mapping_handle = nullptr;
+
+	assert(invariant());
+}
+
+#else	// Posix
+
+bool SharedMemoryFile :: openForWriting (const string& filename, size_t size)
+{
+	assert(!isOpen());
+	assert(filename != "");
+	assert(size > 0);
+
+	int file = open(filename.c_str(), O_RDWR | O_CREAT, 0644);
+	if(file < 0)
+	{
+		cerr << "Error in SharedMemoryFile: Could not open file \"" << filename << "\"" << endl;
+		return false;
+	}
+	if(ftruncate(file, (off_t)(size)) != 0)
+	{
+		cerr << "Error in SharedMemoryFile: Could not resize file \"" << filename << "\"" << endl;
+		::close(file);
+		return false;
+	}
+
+	// the mapping keeps the file open
+	void* p_data = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, file, 0);
+	::close(file);
+	if(p_data == MAP_FAILED)
+	{
+		cerr << "Error in SharedMemoryFile: Could not map file \"" << filename << "\"" << endl;
+		return false;
+	}
+
+	mp_data = p_data;
+	m_size  = size;
+
+	assert(invariant());
+	return true;
+}
+
+bool SharedMemoryFile :: openForReading (const string& filename)
+{
+	assert(!isOpen());
+	assert(filename != "");
+
+	int file = open(filename.c_str(), O_RDONLY);
+	if(file < 0)
+		return false;
+
+	struct stat status;
+	if(fstat(file, &status) != 0 || status.st_size <= 0)
+	{
+		::close(file);
+		return false;
+	}
+
+	size_t size = (size_t)(status.st_size);
+	void* p_data = mmap(nullptr, size, PROT_READ, MAP_SHARED, file, 0);
+	::close(file);
+	if(p_data == MAP_FAILED)
+	{
+		cerr << "Error in SharedMemoryFile: Could not map file \"" << filename << "\"" << endl;
+		return false;
+	}
+
+	mp_data = p_data;
+	m_size  = size;
+
+	assert(invariant());
+	return true;
+}
+
+void SharedMemoryFile :: close ()
+{
+	if(!isOpen())
+		return;
+
+	munmap(mp_data, m_size);
+	mp_data = nullptr;
+	m_size  = 0;
+
+	assert(invariant());
+}
+
+#endif
+
+
+
+bool SharedMemoryFile :: invariant () const
+{
+	if((mp_data == nullptr) != (m_size == 0)) return false;
+	return true;
+}
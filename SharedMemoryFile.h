@@ -0,0 +1,169 @@
+//
+//  SharedMemoryFile.h
+//
+//  A module to map a file into memory so that other processes
+//    can see it.
+//
+
+#ifndef SHARED_MEMORY_FILE_H
+#define SHARED_MEMORY_FILE_H
+
+#include <cassert>
+#include <cstddef>
+#include <string>
+
+
+
+//
+//  SharedMemoryFile
+//
+//  A class to map a file of a fixed size into memory.  Changes
+//    made through the mapping are seen by every process that
+//    maps the same file, without any system calls, so it can be
+//    used to pass data to other programs while the game runs.
+//
+//  A SharedMemoryFile cannot be copied.  The file is unmapped
+//    when the SharedMemoryFile is destroyed, but it is not
+//    deleted.
+//
+//  Class Invariant:
+//    <1> (mp_data == nullptr) == (m_size == 0)
+//
+class SharedMemoryFile
+{
+public:
+	//
+	//  Default Constructor
+	//
+	//  Purpose: To create a new SharedMemoryFile that is not
+	//           open.
+	//  Parameter(s): N/A
+	//  Precondition(s): N/A
+	//  Returns: N/A
+	//  Side Effect: A new SharedMemoryFile is created.
+	//
+	SharedMemoryFile ();
+
+	//
+	//  Destructor
+	//
+	//  Purpose: To safely destroy this SharedMemoryFile.
+	//  Parameter(s): N/A
+	//  Precondition(s): N/A
+	//  Returns: N/A
+	//  Side Effect: If the file is open, it is unmapped.
+	//
+	~SharedMemoryFile ();
+
+	SharedMemoryFile (const SharedMemoryFile& original) = delete;
+	SharedMemoryFile& operator= (const SharedMemoryFile& original) = delete;
+
+	//
+	//  isOpen
+	//
+	//  Purpose: To determine whether a file is mapped.
+	//  Parameter(s): N/A
+	//  Precondition(s): N/A
+	//  Returns: Whether a file is mapped.
+	//  Side Effect: N/A
+	//
+	bool isOpen () const;
+
+	//
+	//  getSize
+	//
+	//  Purpose: To determine the size of the mapped file.
+	//  Parameter(s): N/A
+	//  Precondition(s):
+	//    <1> isOpen()
+	//  Returns: The size in bytes.
+	//  Side Effect: N/A
+	//
+	size_t getSize () const;
+
+	//
+	//  getData
+	//
+	//  Purpose: To retrieve the mapped memory.
+	//  Parameter(s): N/A
+	//  Precondition(s):
+	//    <1> isOpen()
+	//  Returns: A pointer to the start of the file in memory.
+	//           It is aligned for any type.  If the file was
+	//           opened read-only, it must not be written to.
+	//  Side Effect: N/A
+	//
+	void* getData () const;
+
+	//
+	//  openForWriting
+	//
+	//  Purpose: To create or open the specified file and map it
+	//           for reading and writing.
+	//  Parameter(s):
+	//    <1> filename: The name of the file
+	//    <2> size: The size of the file in bytes
+	//  Precondition(s):
+	//    <1> !isOpen()
+	//    <2> filename != ""
+	//    <3> size > 0
+	//  Returns: Whether the file was mapped.
+	//  Side Effect: The file is created if it does not exist and
+	//               resized to size bytes.  It is then mapped.
+	//               If this fails, an error message is printed.
+	//
+	bool openForWriting (const std::string& filename, size_t size);
+
+	//
+	//  openForReading
+	//
+	//  Purpose: To map the specified file read-only.
+	//  Parameter(s):
+	//    <1> filename: The name of the file
+	//  Precondition(s):
+	//    <1> !isOpen()
+	//    <2> filename != ""
+	//  Returns: Whether the file was mapped.  If the file does
+	//           not exist or is empty, false is returned without
+	//           printing a message, so the caller can try again.
+	//  Side Effect: The whole file is mapped.  If this fails for
+	//               another reason, an error message is printed.
+	//
+	bool openForReading (const std::string& filename);
+
+	//
+	//  close
+	//
+	//  Purpose: To unmap the file.
+	//  Parameter(s): N/A
+	//  Precondition(s): N/A
+	//  Returns: N/A
+	//  Side Effect: If the file is open, it is unmapped.
+	//               Otherwise, there is no effect.
+	//
+	void close ();
+
+private:
+	//
+	//  Helper Function: invariant
+	//
+	//  Purpose: To determine if the class invariant is true.
+	//  Parameter(s): N/A
+	//  Precondition(s): N/A
+	//  Returns: Whether the class invariant is true.
+	//  Side Effect: N/A
+	//
+	bool invariant () const;
+
+private:
+	void* mp_data;
+	size_t m_size;
+
+	// the Windows handles, unused elsewhere
+	void* mp_file_handle;
+	void* mp_mapping_handle;
+};
+
+
+
+#endif
@@ -0,0 +1,424 @@
+//
+//  SimulationThread.cpp
+//
+
+#include <cassert>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <sstream>
+#include <memory>
+#include <mutex>
+#include <thread>
+
+#include "ObjLibrary/Vector3.h"
+
+#include "PhysicsFrameLength.h"
+#include "FramePacer.h"
+#include "SpscQueue.h"
+#include "TraceRecorder.h"
+#include "Profiler.h"
+#include "GameSnapshot.h"
+#include "GameCheckpoint.h"
+#include "TelemetryBlock.h"
+#include "TelemetryExporter.h"
+#include "InputRecording.h"
+#include "Game.h"
+#include "SimulationThread.h"
+
+using namespace std;
+using namespace ObjLibrary;
+namespace
+{
+	//
+	//  TICK_TIME_MEAN_WEIGHT
+	//
+	//  How much each physics frame counts towards the published
+	//    mean tick time.
+	//
+	const double TICK_TIME_MEAN_WEIGHT = 0.05;
+}
+
+
+
+const double SimulationThread :: HITCH_THRESHOLD_DEFAULT = PHYSICS_FRAME_LENGTH;
+
+
+
+SimulationThread :: SimulationThread ()
+		: mp_game(nullptr)
+		, m_thread()
+		, m_pacer(PHYSICS_FRAME_LENGTH)
+		, m_is_stopping(false)
+		, m_update_count(0)
+		, m_hitch_threshold(HITCH_THRESHOLD_DEFAULT)
+		, m_key_events()
+		, mp_telemetry(nullptr)
+		, m_telemetry_values()
+		, m_restart_checkpoint()
+		, mp_recording(nullptr)
+		, m_hash_checkpoint()
+		, m_switch_mutex()
+		, mp_switch_game()
+		, m_is_switch_keep_player(false)
+		, m_is_switch_pending(false)
+		, m_snapshot_mutex()
+		, mp_previous_snapshot()
+		, mp_current_snapshot()
+{
+	for(unsigned int i = 0; i < KEY_COUNT; i++)
+		ma_is_pressed[i] = false;
+
+	assert(invariant());
+}
+
+SimulationThread :: ~SimulationThread ()
+{
+	stop();
+}
+
+
+
+bool SimulationThread :: isRunning () const
+{
+	return m_thread.joinable();
+}
+
+unsigned int SimulationThread :: getUpdateCount () const
+{
+	return m_update_count.load();
+}
+
+double SimulationThread :: getElapsedTime () const
+{
+	return m_pacer.getElapsedTime();
+}
+
+const FramePacer& SimulationThread :: getPacer () const
+{
+	return m_pacer;
+}
+
+double SimulationThread :: getHitchThreshold () const
+{
+	return m_hitch_threshold.load();
+}
+
+void SimulationThread :: getSnapshots (shared_ptr<const GameSnapshot>& rp_previous,
+                                       shared_ptr<const GameSnapshot>& rp_current,
+                                       float& r_fraction) const
+{
+	assert(isRunning());
+
+	{
+		lock_guard<mutex> lock(m_snapshot_mutex);
+		rp_previous = mp_previous_snapshot;
+		rp_current  = mp_current_snapshot;
+	}
+	assert(rp_previous != nullptr);
+	assert(rp_current  != nullptr);
+
+	//
+	//  A GameSnapshot with an update count of N is published
+	//    after physics frame N - 1 is due but before frame N
+	//    is, so the current time normally falls between the
+	//    previous GameSnapshot and the current one.
+	//
+
+	unsigned int previous_count = rp_previous->getUpdateCount();
+	unsigned int current_count  = rp_current ->getUpdateCount();
+	if(current_count <= previous_count)
+	{
+		r_fraction = 1.0f;
+		return;
+	}
+
+	double frame = m_pacer.getTickPosition();
+	r_fraction = (float)((frame - previous_count) / (current_count - previous_count));
+	if(r_fraction < 0.0f)
+		r_fraction = 0.0f;
+	else if(r_fraction > 1.0f)
+		r_fraction = 1.0f;
+}
+
+
+
+void SimulationThread :: start (Game& r_game)
+{
+	assert(!isRunning());
+	assert(r_game.isInitialized());
+
+	mp_game = &r_game;
+	m_is_stopping = false;
+	m_update_count = 0;
+	m_telemetry_values = TelemetryValues();
+	mp_previous_snapshot = nullptr;
+	mp_current_snapshot  = nullptr;
+	publishSnapshot();
+	r_game.saveCheckpoint(m_restart_checkpoint);
+
+	m_pacer.reset();
+	m_thread = thread(&SimulationThread::run, this);
+
+	assert(invariant());
+}
+
+void SimulationThread :: stop ()
+{
+	if(!isRunning())
+		return;
+
+	m_is_stopping = true;
+	m_thread.join();
+
+	assert(invariant());
+}
+
+bool SimulationThread :: setKeyPressed (unsigned int key, bool is_pressed)
+{
+	assert(key < KEY_COUNT);
+
+	KeyEvent event;
+	event.m_key        = key;
+	event.m_is_pressed = is_pressed;
+	return m_key_events.push(event);
+}
+
+void SimulationThread :: setHitchThreshold (double threshold)
+{
+	assert(threshold >= 0.0);
+
+	m_hitch_threshold = threshold;
+}
+
+void SimulationThread :: setTelemetryExporter (TelemetryExporter* p_exporter)
+{
+	assert(!isRunning());
+	assert(p_exporter == nullptr || p_exporter->isOpen());
+
+	mp_telemetry = p_exporter;
+}
+
+void SimulationThread :: setInputRecording (InputRecording* p_recording)
+{
+	assert(!isRunning());
+
+	mp_recording = p_recording;
+}
+
+bool SimulationThread :: isSwitchPending () const
+{
+	return m_is_switch_pending.load();
+}
+
+void SimulationThread :: switchGame (const shared_ptr<Game>& p_game,
+                                     bool is_keep_player)
+{
+	assert(isRunning());
+	assert(p_game != nullptr);
+	assert(p_game->isInitialized());
+	assert(!isSwitchPending());
+
+	lock_guard<mutex> lock(m_switch_mutex);
+	mp_switch_game = p_game;
+	m_is_switch_keep_player = is_keep_player;
+	m_is_switch_pending = true;
+}
+
+
+
+void SimulationThread :: run ()
+{
+	assert(mp_game != nullptr);
+
+	TraceRecorder::setThreadName("Simulation");
+
+	while(!m_is_stopping)
+	{
+		unsigned int batch_count = m_pacer.wait(UPDATE_COUNT_MAX);
+		assert(batch_count >= 1);
+		for(unsigned int i = 0; i < batch_count; i++)
+		{
+			TraceRecorder::TimePoint start = TraceRecorder::Clock::now();
+			{
+				PROFILE_SCOPE(SECTION_UPDATE);
+				if(m_is_switch_pending.load())
+					applySwitch();
+				bool is_restarted = applyKeyEvents();
+				unsigned int input = getKeyboardInput();
+				if(!mp_game->isGameOver())
+					mp_game->handleInput(input);
+				mp_game->update();
+				if(mp_recording != nullptr)
+					recordTick(is_restarted ? (input | Game::INPUT_RESTART) : input);
+			}
+			double duration = chrono::duration<double>(TraceRecorder::Clock::now() - start).count();
+			if(mp_telemetry != nullptr)
+				publishTelemetry(duration);
+			PROFILE_END_FRAME(TIMELINE_UPDATE);
+
+			double threshold = m_hitch_threshold.load();
+			if(threshold > 0.0 && duration > threshold)
+			{
+				stringstream reason;
+				reason << "physics frame " << m_update_count << " took " << duration * 1000.0 << " ms";
+				TraceRecorder::dumpHitch(reason.str());
+			}
+			m_update_count++;
+		}
+		assert(m_update_count == m_pacer.getTickCount());
+
+		publishSnapshot();
+	}
+}
+
+void SimulationThread :: applySwitch ()
+{
+	assert(mp_game != nullptr);
+
+	lock_guard<mutex> lock(m_switch_mutex);
+	if(mp_switch_game == nullptr)
+		return;
+
+	TRACE_SCOPE("Switch game");
+	mp_switch_game->saveCheckpoint(m_restart_checkpoint);
+	mp_game->switchTo(*mp_switch_game, m_is_switch_keep_player);
+	mp_recording = nullptr;  // a recording cannot replay the switch
+	mp_switch_game = nullptr;  // the caller still has it
+	m_is_switch_pending = false;
+}
+
+void SimulationThread :: applyRestart ()
+{
+	assert(mp_game != nullptr);
+	assert(!m_restart_checkpoint.isEmpty());
+
+	TRACE_SCOPE("Restart game");
+	mp_game->restoreCheckpoint(m_restart_checkpoint);
+
+	// twice, so the previous GameSnapshot is after the restart too
+	publishSnapshot();
+	publishSnapshot();
+}
+
+bool SimulationThread :: applyKeyEvents ()
+{
+	assert(mp_game != nullptr);
+
+	bool is_restarted = false;
+	KeyEvent event;
+	while(m_key_events.pop(event))
+	{
+		assert(event.m_key < KEY_COUNT);
+		if(event.m_key == KEY_RESTART && event.m_is_pressed &&
+		   !ma_is_pressed[KEY_RESTART] && mp_game->isGameOver())
+		{
+			applyRestart();
+			is_restarted = true;
+		}
+		ma_is_pressed[event.m_key] = event.m_is_pressed;
+	}
+	return is_restarted;
+}
+
+unsigned int SimulationThread :: getKeyboardInput () const
+{
+	unsigned int input = 0;
+	if(ma_is_pressed[KEY_ARROW_LEFT])
+		input |= Game::INPUT_TURN_LEFT;
+	if(ma_is_pressed[KEY_ARROW_RIGHT])
+		input |= Game::INPUT_TURN_RIGHT;
+	if(ma_is_pressed['w'] || ma_is_pressed[KEY_ARROW_UP])
+		input |= Game::INPUT_FORWARD;
+	if(ma_is_pressed['s'] || ma_is_pressed[KEY_ARROW_DOWN])
+		input |= Game::INPUT_BACKWARD;
+	if(ma_is_pressed['a'])
+		input |= Game::INPUT_LEFT;
+	if(ma_is_pressed['d'])
+		input |= Game::INPUT_RIGHT;
+	if(ma_is_pressed[' '])
+		input |= Game::INPUT_JUMP;
+	return input;
+}
+
+void SimulationThread :: recordTick (unsigned int input)
+{
+	assert(mp_game != nullptr);
+	assert(mp_recording != nullptr);
+
+	TRACE_SCOPE("Record input");
+	mp_game->saveCheckpoint(m_hash_checkpoint);
+	mp_recording->addTick(input, m_hash_checkpoint.calculateHash());
+}
+
+void SimulationThread :: publishSnapshot ()
+{
+	assert(mp_game != nullptr);
+
+	// build the snapshot before taking the lock
+	shared_ptr<const GameSnapshot> p_snapshot =
+	        mp_game->makeSnapshot(m_update_count, ma_is_pressed[KEY_OVERVIEW]);
+
+	// the oldest snapshot is released after the lock, if at all
+	shared_ptr<const GameSnapshot> p_oldest;
+	{
+		lock_guard<mutex> lock(m_snapshot_mutex);
+		p_oldest = move(mp_previous_snapshot);
+		mp_previous_snapshot = mp_current_snapshot;
+		mp_current_snapshot  = p_snapshot;
+		if(mp_previous_snapshot == nullptr)
+			mp_previous_snapshot = mp_current_snapshot;
+
+		assert(invariant());
+	}
+}
+
+
+void SimulationThread :: publishTelemetry (double tick_time)
+{
+	assert(mp_game != nullptr);
+	assert(mp_telemetry != nullptr);
+
+	TelemetryValues& r_values = m_telemetry_values;
+	r_values.m_update_count = m_update_count + 1;
+	r_values.m_elapsed_time = m_pacer.getElapsedTime();
+
+	r_values.m_tick_time = tick_time;
+	if(r_values.m_update_count == 1)
+		r_values.m_tick_time_mean = tick_time;
+	else
+		r_values.m_tick_time_mean += (tick_time - r_values.m_tick_time_mean) * TICK_TIME_MEAN_WEIGHT;
+	if(tick_time > r_values.m_tick_time_max)
+		r_values.m_tick_time_max = tick_time;
+
+	// these are only counted if the profiler is enabled
+	r_values.m_search_count   = Profiler::getFrameCount(Profiler::COUNTER_SEARCHES);
+	r_values.m_nodes_expanded = Profiler::getFrameCount(Profiler::COUNTER_NODES_EXPANDED);
+	r_values.m_height_count   = Profiler::getFrameCount(Profiler::COUNTER_HEIGHT);
+	r_values.m_search_count_total += r_values.m_search_count;
+
+	Vector3 player_position = mp_game->getPlayerPosition();
+	r_values.m_player_x     = (float)(player_position.x);
+	r_values.m_player_y     = (float)(player_position.y);
+	r_values.m_player_z     = (float)(player_position.z);
+	r_values.m_score        = mp_game->getScore();
+	r_values.m_is_game_over = mp_game->isGameOver() ? 1 : 0;
+
+	if(r_values.m_update_count % TELEMETRY_SLOW_INTERVAL == 1)
+	{
+		FramePacer::Statistics statistics = m_pacer.getStatistics();
+		r_values.m_dropped_count  = statistics.m_dropped_count;
+		r_values.m_jitter_rms     = statistics.m_jitter_rms;
+	}
+
+	mp_telemetry->publish(r_values);
+}
+
+
+
+bool SimulationThread :: invariant () const
+{
+	if(mp_game != nullptr && mp_current_snapshot == nullptr) return false;
+	if((mp_previous_snapshot == nullptr) != (mp_current_snapshot == nullptr)) return false;
+	return true;
+}
@@ -0,0 +1,604 @@
+//
+//  SimulationThread.h
+//
+//  A module to update the game on its own thread.
+//
+
+#ifndef SIMULATION_THREAD_H
+#define SIMULATION_THREAD_H
+
+#include <cassert>
+#include <atomic>
+#include <memory>
+#include <mutex>
+#include <thread>
+
+#include "FramePacer.h"
+#include "SpscQueue.h"
+#include "GameSnapshot.h"
+#include "GameCheckpoint.h"
+#include "TelemetryBlock.h"
+
+class Game;
+class TelemetryExporter;
+class InputRecording;
+
+
+
+//
+//  SimulationThread
+//
+//  A class to run the physics frames for a Game at a fixed
+//    rate on a separate thread from the display.  A slow
+//    display therefore no longer delays the physics, and the
+//    game can be displayed more often than it is updated.  The
+//    physics frames are timed by a FramePacer.
+//
+//  After each batch of physics frames, the simulation thread
+//    publishes a new GameSnapshot.  The display thread keeps
+//    the previous GameSnapshot as well as the current one and
+//    displays the game interpolated between them, about one
+//    physics frame behind the simulation.  Only the two
+//    pointers are guarded by a mutex; the GameSnapshots
+//    themselves are never changed after they are published.
+//
+//  If a physics frame takes longer than the hitch threshold,
+//    the TraceRecorder is told to write out what every thread
+//    was doing, so slow frames can be looked into afterwards.
+//
+//  If a TelemetryExporter is set, the tick times and other
+//    statistics are published to it after every physics frame.
+//
+//  The Game can be switched to another, prepared ahead of
+//    time, with switchGame.  The switch is made on the
+//    simulation thread between physics frames, so it does not
+//    interrupt the frames or race with them.
+//
+//  Key presses are sent from the display thread to the
+//    simulation thread through a lock-free queue.  The
+//    simulation thread keeps its own record of which keys are
+//    held down and applies them before each physics frame.
+//
+//  The state of the Game when it was started or last switched
+//    is kept in a GameCheckpoint.  Pressing the restart key
+//    after the game is over restores it, so the game restarts
+//    without being initialized again.
+//
+//  The keys held down are turned into an input bitmask (see
+//    Game::INPUT_*) for each physics frame.  If an
+//    InputRecording is set, the bitmask and a hash of the game
+//    state afterwards are added to it after every physics
+//    frame, so the session can be replayed exactly.  Hashing
+//    saves a GameCheckpoint, so it takes about 0.1 ms a frame.
+//
+//  A SimulationThread cannot be copied.  The thread is stopped
+//    when the SimulationThread is destroyed.
+//
+//  Class Invariant:
+//    <1> mp_game == nullptr || mp_current_snapshot != nullptr
+//    <2> (mp_previous_snapshot == nullptr) ==
+//        (mp_current_snapshot == nullptr)
+//
+class SimulationThread
+{
+public:
+	//
+	//  KEY_COUNT
+	//
+	//  The number of keys that can be sent to the simulation
+	//    thread.  Keys 0 to 255 are ASCII characters, which
+	//    should be lowercase for letters, and the special keys
+	//    after them are the arrow keys.
+	//
+	static const unsigned int KEY_COUNT       = 260;
+	static const unsigned int KEY_ARROW_LEFT  = 256;
+	static const unsigned int KEY_ARROW_UP    = 257;
+	static const unsigned int KEY_ARROW_RIGHT = 258;
+	static const unsigned int KEY_ARROW_DOWN  = 259;
+
+	//
+	//  KEY_OVERVIEW
+	//
+	//  The key that is held to show the overview.  While it is
+	//    held, the GameSnapshots include the path search.
+	//
+	static const unsigned int KEY_OVERVIEW = 'o';
+
+	//
+	//  KEY_RESTART
+	//
+	//  The key that restarts the game after it is over.
+	//
+	static const unsigned int KEY_RESTART = 'r';
+
+	//
+	//  KEY_QUEUE_SIZE
+	//
+	//  The greatest number of key presses and releases that can
+	//    wait for the simulation thread.
+	//
+	static const unsigned int KEY_QUEUE_SIZE = 256;
+
+	//
+	//  UPDATE_COUNT_MAX
+	//
+	//  The greatest number of physics frames run before a new
+	//    GameSnapshot is published, if the simulation falls
+	//    behind.  If it falls more than FramePacer::LAG_MAX
+	//    seconds behind, the extra physics frames are skipped.
+	//
+	static const unsigned int UPDATE_COUNT_MAX = 10;
+
+	//
+	//  HITCH_THRESHOLD_DEFAULT
+	//
+	//  The default hitch threshold in seconds.  A physics frame
+	//    that takes longer than this has gone over its budget.
+	//
+	static const double HITCH_THRESHOLD_DEFAULT;
+
+	//
+	//  TELEMETRY_SLOW_INTERVAL
+	//
+	//  The number of physics frames between updates of the
+	//    telemetry values that need locks.  The resident memory
+	//    needs system calls, so it is measured on the display
+	//    thread instead.
+	//
+	static const unsigned int TELEMETRY_SLOW_INTERVAL = 60;
+
+public:
+	//
+	//  Default Constructor
+	//
+	//  Purpose: To create a new SimulationThread that is not
+	//           running.
+	//  Parameter(s): N/A
+	//  Precondition(s): N/A
+	//  Returns: N/A
+	//  Side Effect: A new SimulationThread is created.
+	//
+	SimulationThread ();
+
+	//
+	//  Destructor
+	//
+	//  Purpose: To safely destroy this SimulationThread.
+	//  Parameter(s): N/A
+	//  Precondition(s): N/A
+	//  Returns: N/A
+	//  Side Effect: If the thread is running, it is stopped.
+	//
+	~SimulationThread ();
+
+	//
+	//  isRunning
+	//
+	//  Purpose: To determine whether the simulation thread is
+	//           running.
+	//  Parameter(s): N/A
+	//  Precondition(s): N/A
+	//  Returns: Whether the thread is running.
+	//  Side Effect: N/A
+	//
+	bool isRunning () const;
+
+	//
+	//  getUpdateCount
+	//
+	//  Purpose: To determine the number of physics frames run
+	//           since the thread was started.
+	//  Parameter(s): N/A
+	//  Precondition(s): N/A
+	//  Returns: The number of physics frames.
+	//  Side Effect: N/A
+	//
+	unsigned int getUpdateCount () const;
+
+	//
+	//  getElapsedTime
+	//
+	//  Purpose: To determine how long the thread has been
+	//           running.
+	//  Parameter(s): N/A
+	//  Precondition(s): N/A
+	//  Returns: The time since the thread was last started, in
+	//           seconds.  If it has never been started, the
+	//           time since this SimulationThread was created
+	//           is returned.
+	//  Side Effect: N/A
+	//
+	double getElapsedTime () const;
+
+	//
+	//  getPacer
+	//
+	//  Purpose: To retrieve the FramePacer that times the
+	//           physics frames.
+	//  Parameter(s): N/A
+	//  Precondition(s): N/A
+	//  Returns: The FramePacer.  Only its statistics and tick
+	//           position should be used while the thread is
+	//           running.
+	//  Side Effect: N/A
+	//
+	const FramePacer& getPacer () const;
+
+	//
+	//  getHitchThreshold
+	//
+	//  Purpose: To determine how long a physics frame may take
+	//           before a trace is written.
+	//  Parameter(s): N/A
+	//  Precondition(s): N/A
+	//  Returns: The hitch threshold in seconds.  A value of 0.0
+	//           means traces are never written for slow frames.
+	//  Side Effect: N/A
+	//
+	double getHitchThreshold () const;
+
+	//
+	//  getSnapshots
+	//
+	//  Purpose: To retrieve the GameSnapshots to display.
+	//  Parameter(s):
+	//    <1> rp_previous: A reference to the pointer to set to
+	//                     the previous GameSnapshot
+	//    <2> rp_current: A reference to the pointer to set to
+	//                    the current GameSnapshot
+	//    <3> r_fraction: A reference to the variable to set to
+	//                    how far to interpolate from the
+	//                    previous GameSnapshot to the current one
+	//  Precondition(s):
+	//    <1> isRunning()
+	//  Returns: N/A
+	//  Side Effect: rp_previous and rp_current are set to the
+	//               two most recent GameSnapshots and
+	//               r_fraction is set to a value from 0.0f to
+	//               1.0f based on the current time.  If there
+	//               is only one GameSnapshot, both pointers
+	//               point to it.
+	//
+	void getSnapshots (std::shared_ptr<const GameSnapshot>& rp_previous,
+	                   std::shared_ptr<const GameSnapshot>& rp_current,
+	                   float& r_fraction) const;
+
+	//
+	//  start
+	//
+	//  Purpose: To start updating the specified Game on the
+	//           simulation thread.
+	//  Parameter(s):
+	//    <1> r_game: The Game to update
+	//  Precondition(s):
+	//    <1> !isRunning()
+	//    <2> r_game.isInitialized()
+	//  Returns: N/A
+	//  Side Effect: A GameSnapshot of r_game is published, the
+	//               state of r_game is saved to restart from,
+	//               and the simulation thread is started.
+	//               Until stop is called, r_game may only be
+	//               changed by the simulation thread.
+	//
+	void start (Game& r_game);
+
+	//
+	//  stop
+	//
+	//  Purpose: To stop the simulation thread.
+	//  Parameter(s): N/A
+	//  Precondition(s): N/A
+	//  Returns: N/A
+	//  Side Effect: If the thread is running, it is stopped
+	//               after the current batch of physics frames
+	//               and this function waits for it to finish.
+	//               Otherwise, there is no effect.
+	//
+	void stop ();
+
+	//
+	//  setKeyPressed
+	//
+	//  Purpose: To send a key press or release to the
+	//           simulation thread.
+	//  Parameter(s):
+	//    <1> key: The key
+	//    <2> is_pressed: Whether the key was pressed
+	//  Precondition(s):
+	//    <1> key < KEY_COUNT
+	//    <2> Only one thread calls setKeyPressed.
+	//  Returns: Whether the key was sent.  If too many keys
+	//           are waiting for the simulation thread, false is
+	//           returned.
+	//  Side Effect: The key will be marked as pressed or
+	//               released before the next physics frame.
+	//
+	bool setKeyPressed (unsigned int key, bool is_pressed);
+
+	//
+	//  setHitchThreshold
+	//
+	//  Purpose: To change how long a physics frame may take
+	//           before a trace is written.
+	//  Parameter(s):
+	//    <1> threshold: The hitch threshold in seconds
+	//  Precondition(s):
+	//    <1> threshold >= 0.0
+	//  Returns: N/A
+	//  Side Effect: The hitch threshold is set to threshold.  If
+	//               it is 0.0, traces are never written for slow
+	//               frames.  This function may be called while
+	//               the thread is running.
+	//
+	void setHitchThreshold (double threshold);
+
+	//
+	//  setTelemetryExporter
+	//
+	//  Purpose: To set where statistics are published.
+	//  Parameter(s):
+	//    <1> p_exporter: A pointer to the TelemetryExporter, or
+	//                    nullptr for none
+	//  Precondition(s):
+	//    <1> !isRunning()
+	//    <2> p_exporter == nullptr || p_exporter->isOpen()
+	//  Returns: N/A
+	//  Side Effect: Statistics will be published to p_exporter
+	//               after each physics frame.  p_exporter must
+	//               not be destroyed while the thread is
+	//               running.
+	//
+	void setTelemetryExporter (TelemetryExporter* p_exporter);
+
+	//
+	//  setInputRecording
+	//
+	//  Purpose: To set where the input is recorded.
+	//  Parameter(s):
+	//    <1> p_recording: A pointer to the InputRecording, or
+	//                     nullptr for none
+	//  Precondition(s):
+	//    <1> !isRunning()
+	//  Returns: N/A
+	//  Side Effect: The input and game state hash for each
+	//               physics frame will be added to
+	//               *p_recording, until the Game is switched.
+	//               p_recording must not be used or destroyed
+	//               while the thread is running.
+	//
+	void setInputRecording (InputRecording* p_recording);
+
+	//
+	//  isSwitchPending
+	//
+	//  Purpose: To determine whether a Game switch is waiting
+	//           for the simulation thread.
+	//  Parameter(s): N/A
+	//  Precondition(s): N/A
+	//  Returns: Whether switchGame has been called and the
+	//           switch has not been made yet.
+	//  Side Effect: N/A
+	//
+	bool isSwitchPending () const;
+
+	//
+	//  switchGame
+	//
+	//  Purpose: To switch the Game being updated to the state
+	//           of the specified Game.
+	//  Parameter(s):
+	//    <1> p_game: The Game to switch to
+	//    <2> is_keep_player: Whether to keep the player and
+	//                        score of the current Game
+	//  Precondition(s):
+	//    <1> isRunning()
+	//    <2> p_game != nullptr
+	//    <3> p_game->isInitialized()
+	//    <4> !isSwitchPending()
+	//  Returns: N/A
+	//  Side Effect: Before the next physics frame, the Game
+	//               being updated takes the state of *p_game
+	//               and *p_game takes its old state (see
+	//               Game::switchTo), except for the player and
+	//               score if is_keep_player == true.  Once
+	//               isSwitchPending() returns false, *p_game
+	//               is no longer used by the simulation thread
+	//               and may be destroyed.
+	//
+	void switchGame (const std::shared_ptr<Game>& p_game,
+	                 bool is_keep_player = false);
+
+private:
+	//
+	//  KeyEvent
+	//
+	//  A record of a key being pressed or released.
+	//
+	struct KeyEvent
+	{
+		unsigned int m_key;
+		bool m_is_pressed;
+	};
+
+	//
+	//  Copy Constructor
+	//  Assignment Operator
+	//
+	//  These functions have intentionally not been implemented
+	//    because the simulation thread refers to this
+	//    SimulationThread.
+	//
+	SimulationThread (const SimulationThread& original);
+	SimulationThread& operator= (const SimulationThread& original);
+
+	//
+	//  Helper Function: run
+	//
+	//  Purpose: To run the physics frames until the thread is
+	//           stopped.
+	//  Parameter(s): N/A
+	//  Precondition(s):
+	//    <1> mp_game != nullptr
+	//  Returns: N/A
+	//  Side Effect: The Game is updated whenever a physics
+	//               frame is due, and a GameSnapshot is
+	//               published after each batch.  Between
+	//               batches, the thread waits on the
+	//               FramePacer.  If a physics frame takes longer
+	//               than the hitch threshold, a trace is
+	//               written.
+	//
+	void run ();
+
+	//
+	//  Helper Function: applySwitch
+	//
+	//  Purpose: To make the Game switch that is waiting, if
+	//           any.
+	//  Parameter(s): N/A
+	//  Precondition(s):
+	//    <1> mp_game != nullptr
+	//  Returns: N/A
+	//  Side Effect: If switchGame has been called, the Game is
+	//               switched and the switch is no longer
+	//               pending.  The state of the Game switched to
+	//               is saved to restart from.
+	//
+	void applySwitch ();
+
+	//
+	//  Helper Function: applyRestart
+	//
+	//  Purpose: To restart the Game from the saved state.
+	//  Parameter(s): N/A
+	//  Precondition(s):
+	//    <1> mp_game != nullptr
+	//    <2> !m_restart_checkpoint.isEmpty()
+	//  Returns: N/A
+	//  Side Effect: The Game is restored from the state saved
+	//               when it was started or last switched.  A
+	//               GameSnapshot of it is published, so the
+	//               display does not blend from the state before
+	//               the restart.
+	//
+	void applyRestart ();
+
+	//
+	//  Helper Function: applyKeyEvents
+	//
+	//  Purpose: To apply the key presses and releases waiting
+	//           in the queue.
+	//  Parameter(s): N/A
+	//  Precondition(s):
+	//    <1> mp_game != nullptr
+	//  Returns: Whether the Game was restarted.
+	//  Side Effect: The queue is emptied and the keys are
+	//               marked as pressed or released.  If the
+	//               restart key is pressed while the game is
+	//               over, the Game is restarted.
+	//
+	bool applyKeyEvents ();
+
+	//
+	//  Helper Function: getKeyboardInput
+	//
+	//  Purpose: To determine the input for the keys that are
+	//           held down.
+	//  Parameter(s): N/A
+	//  Precondition(s): N/A
+	//  Returns: The input bitmask, not including
+	//           Game::INPUT_RESTART.
+	//  Side Effect: N/A
+	//
+	unsigned int getKeyboardInput () const;
+
+	//
+	//  Helper Function: recordTick
+	//
+	//  Purpose: To record the physics frame that just ran.
+	//  Parameter(s):
+	//    <1> input: The input bitmask for the physics frame
+	//  Precondition(s):
+	//    <1> mp_game != nullptr
+	//    <2> mp_recording != nullptr
+	//  Returns: N/A
+	//  Side Effect: The input and a hash of the state of the
+	//               Game are added to the InputRecording.
+	//
+	void recordTick (unsigned int input);
+
+	//
+	//  Helper Function: publishSnapshot
+	//
+	//  Purpose: To publish a new GameSnapshot of the Game.
+	//  Parameter(s): N/A
+	//  Precondition(s):
+	//    <1> mp_game != nullptr
+	//  Returns: N/A
+	//  Side Effect: The current GameSnapshot becomes the
+	//               previous one, and a new GameSnapshot of the
+	//               Game becomes the current one.
+	//
+	void publishSnapshot ();
+
+	//
+	//  Helper Function: publishTelemetry
+	//
+	//  Purpose: To publish statistics about the physics frame
+	//           that just ran.
+	//  Parameter(s):
+	//    <1> tick_time: How long the physics frame took in
+	//                   seconds
+	//  Precondition(s):
+	//    <1> mp_game != nullptr
+	//    <2> mp_telemetry != nullptr
+	//    <3> The Profiler frame has not ended yet.
+	//  Returns: N/A
+	//  Side Effect: The statistics are updated and published to
+	//               the TelemetryExporter.
+	//
+	void publishTelemetry (double tick_time);
+
+	//
+	//  Helper Function: invariant
+	//
+	//  Purpose: To determine if the class invariant is true.
+	//  Parameter(s): N/A
+	//  Precondition(s): N/A
+	//  Returns: Whether the class invariant is true.
+	//  Side Effect: N/A
+	//
+	bool invariant () const;
+
+private:
+	Game* mp_game;
+	std::thread m_thread;
+	FramePacer m_pacer;
+	std::atomic<bool> m_is_stopping;
+	std::atomic<unsigned int> m_update_count;
+	std::atomic<double> m_hitch_threshold;
+	SpscQueue<KeyEvent, KEY_QUEUE_SIZE> m_key_events;
+
+	// used only by the simulation thread
+	bool ma_is_pressed[KEY_COUNT];
+	TelemetryExporter* mp_telemetry;
+	TelemetryValues m_telemetry_values;
+	GameCheckpoint m_restart_checkpoint;
+	InputRecording* mp_recording;
+	GameCheckpoint m_hash_checkpoint;
+
+	// guards the Game to switch to
+	std::mutex m_switch_mutex;
+	std::shared_ptr<Game> mp_switch_game;
+	bool m_is_switch_keep_player;
+	std::atomic<bool> m_is_switch_pending;
+
+	// guards the snapshot pointers
+	mutable std::mutex m_snapshot_mutex;
+	std::shared_ptr<const GameSnapshot> mp_previous_snapshot;
+	std::shared_ptr<const GameSnapshot> mp_current_snapshot;
+};
+
+
+
+#endif
@@ -0,0 +1,184 @@
+//
+//  SpscQueue.h
+//
+//  A module to pass values from one thread to another without
+//    locking.
+//
+
+#ifndef SPSC_QUEUE_H
+#define SPSC_QUEUE_H
+
+#include <cassert>
+#include <atomic>
+
+
+
+//
+//  SpscQueue
+//
+//  A template class to represent a fixed-size first-in,
+//    first-out queue with a single producer thread and a single
+//    consumer thread.  Only the producer may call push and only
+//    the consumer may call pop.  Neither call ever blocks or
+//    allocates memory.
+//
+//  The queue is a ring buffer.  The producer only writes
+//    m_tail and the consumer only writes m_head, so each index
+//    is published with a release store and read with an
+//    acquire load.  One element is always left empty to tell a
+//    full queue from an empty one.
+//
+//  An SpscQueue cannot be copied.
+//
+//  Class Invariant:
+//    <1> CAPACITY >= 1
+//    <2> m_head < CAPACITY + 1
+//    <3> m_tail < CAPACITY + 1
+//
+template <typename T, unsigned int CAPACITY>
+class SpscQueue
+{
+public:
+	//
+	//  Default Constructor
+	//
+	//  Purpose: To create a new empty SpscQueue.
+	//  Parameter(s): N/A
+	//  Precondition(s): N/A
+	//  Returns: N/A
+	//  Side Effect: A new SpscQueue is created.
+	//
+	SpscQueue ()
+			: m_head(0)
+			, m_tail(0)
+	{
+		assert(invariant());
+	}
+
+	SpscQueue (const SpscQueue& original) = delete;
+	SpscQueue& operator= (const SpscQueue& original) = delete;
+
+	//
+	//  isEmpty
+	//
+	//  Purpose: To determine whether this SpscQueue is empty.
+	//  Parameter(s): N/A
+	//  Precondition(s): N/A
+	//  Returns: Whether this SpscQueue contains no values.  If
+	//           the other thread is using this SpscQueue, the
+	//           result may already be out of date.
+	//  Side Effect: N/A
+	//
+	bool isEmpty () const
+	{
+		return m_head.load(std::memory_order_acquire) ==
+		       m_tail.load(std::memory_order_acquire);
+	}
+
+	//
+	//  push
+	//
+	//  Purpose: To add a value to the end of this SpscQueue.
+	//  Parameter(s):
+	//    <1> value: The value to add
+	//  Precondition(s):
+	//    <1> Only the producer thread calls push.
+	//  Returns: Whether value was added.  If this SpscQueue is
+	//           full, false is returned.
+	//  Side Effect: If this SpscQueue is not full, value is
+	//               added to the end.
+	//
+	bool push (const T& value)
+	{
+		unsigned int tail = m_tail.load(std::memory_order_relaxed);
+		unsigned int next = advance(tail);
+		if(next == m_head.load(std::memory_order_acquire))
+			return false;  // full
+
+		ma_values[tail] = value;
+		m_tail.store(next, std::memory_order_release);
+
+		assert(invariant());
+		return true;
+	}
+
+	//
+	//  pop
+	//
+	//  Purpose: To remove the value at the front of this
+	//           SpscQueue.
+	//  Parameter(s):
+	//    <1> r_value: A reference to the variable to store the
+	//                 value in
+	//  Precondition(s):
+	//    <1> Only the consumer thread calls pop.
+	//  Returns: Whether a value was removed.  If this SpscQueue
+	//           is empty, false is returned.
+	//  Side Effect: If this SpscQueue is not empty, the value
+	//               at the front is removed and stored in
+	//               r_value.  Otherwise, r_value is unchanged.
+	//
+	bool pop (T& r_value)
+	{
+		unsigned int head = m_head.load(std::memory_order_relaxed);
+		if(head == m_tail.load(std::memory_order_acquire))
+			return false;  // empty
+
+		r_value = ma_values[head];
+		m_head.store(advance(head), std::memory_order_release);
+
+		assert(invariant());
+		return true;
+	}
+
+private:
+	//
+	//  Helper Function: advance
+	//
+	//  Purpose: To determine the element after the specified
+	//           one in the ring buffer.
+	//  Parameter(s):
+	//    <1> index: The current element
+	//  Precondition(s):
+	//    <1> index < CAPACITY + 1
+	//  Returns: The index of the next element.
+	//  Side Effect: N/A
+	//
+	static unsigned int advance (unsigned int index)
+	{
+		assert(index < CAPACITY + 1);
+
+		index++;
+		if(index == CAPACITY + 1)
+			index = 0;
+		return index;
+	}
+
+	//
+	//  Helper Function: invariant
+	//
+	//  Purpose: To determine if the class invariant is true.
+	//  Parameter(s): N/A
+	//  Precondition(s): N/A
+	//  Returns: Whether the class invariant is true.
+	//  Side Effect: N/A
+	//
+	bool invariant () const
+	{
+		if(CAPACITY < 1) return false;
+		if(m_head.load(std::memory_order_relaxed) >= CAPACITY + 1) return false;
+		if(m_tail.load(std::memory_order_relaxed) >= CAPACITY + 1) return false;
+		return true;
+	}
+
+private:
+	// the indexes are on separate cache lines so the two
+	//   threads do not keep taking the line from each other
+	T ma_values[CAPACITY + 1];
+	alignas(64) std::atomic<unsigned int> m_head;
+	alignas(64) std::atomic<unsigned int> m_tail;
+};
+
+
+
+#endif
@@ -0,0 +1,133 @@
+//
+//  TelemetryBlock.h
+//
+//  A module to define the layout of the live statistics shared
+//    with other programs.
+//
+//  This file is shared by the game and the telemetry reader,
+//    so it must not depend on anything else in the game.
+//
+
+#ifndef TELEMETRY_BLOCK_H
+#define TELEMETRY_BLOCK_H
+
+#include <cassert>
+#include <atomic>
+#include <cstdint>
+#include <cstring>
+
+
+
+//
+//  TelemetryValues
+//
+//  The statistics published after each physics frame.  The
+//    fields are fixed-size and ordered from largest to
+//    smallest, so the layout is the same for every compiler.
+//    Times are in seconds.  The fields marked "slow" are only
+//    refreshed about once a second.
+//
+struct TelemetryValues
+{
+	uint64_t m_update_count;
+	uint64_t m_dropped_count;       // slow
+	uint64_t m_search_count_total;
+	uint64_t m_resident_bytes;      // slow
+	double m_elapsed_time;
+	double m_tick_time;
+	double m_tick_time_mean;        // exponentially weighted
+	double m_tick_time_max;
+	double m_jitter_rms;            // slow
+	double m_display_rate;          // frames per second
+	float m_player_x;
+	float m_player_y;
+	float m_player_z;
+	int32_t m_score;
+	uint32_t m_search_count;        // in the last physics frame
+	uint32_t m_nodes_expanded;      // in the last physics frame
+	uint32_t m_height_count;        // in the last physics frame
+	uint32_t m_is_game_over;
+};
+
+//
+//  TelemetryBlock
+//
+//  The contents of the shared file.  The values are guarded by
+//    a sequence lock: the writer makes m_sequence odd while it
+//    changes them and even again afterwards, and a reader
+//    retries if m_sequence was odd or changed while it copied
+//    them.  Neither side ever waits for the other.
+//
+struct TelemetryBlock
+{
+	static const uint32_t MAGIC   = 0x4d4c5441;  // "ATLM"
+	static const uint32_t VERSION = 1;
+
+	uint32_t m_magic;
+	uint32_t m_version;
+	uint32_t m_values_size;
+	std::atomic<uint32_t> m_sequence;
+	TelemetryValues m_values;
+};
+
+static_assert(sizeof(TelemetryValues) == 112, "TelemetryValues layout changed");
+static_assert(std::atomic<uint32_t>::is_always_lock_free,
+              "TelemetryBlock needs a lock-free atomic to be shared between processes");
+
+
+
+//
+//  writeTelemetry
+//
+//  Purpose: To publish new values in the specified
+//           TelemetryBlock.
+//  Parameter(s):
+//    <1> r_block: The TelemetryBlock
+//    <2> values: The new values
+//  Precondition(s):
+//    <1> Only one thread writes to r_block.
+//  Returns: N/A
+//  Side Effect: The values in r_block are replaced with values.
+//
+inline void writeTelemetry (TelemetryBlock& r_block,
+                            const TelemetryValues& values)
+{
+	uint32_t sequence = r_block.m_sequence.load(std::memory_order_relaxed);
+	r_block.m_sequence.store(sequence + 1, std::memory_order_relaxed);
+	std::atomic_thread_fence(std::memory_order_release);
+	std::memcpy(&r_block.m_values, &values, sizeof(TelemetryValues));
+	r_block.m_sequence.store(sequence + 2, std::memory_order_release);
+}
+
+//
+//  readTelemetry
+//
+//  Purpose: To copy the values out of the specified
+//           TelemetryBlock.
+//  Parameter(s):
+//    <1> block: The TelemetryBlock
+//    <2> r_values: A reference to the TelemetryValues to copy
+//                  the values into
+//  Precondition(s): N/A
+//  Returns: Whether a consistent copy was made.  If the values
+//           are being written, false is returned and the caller
+//           should try again.
+//  Side Effect: The values in block are copied into r_values.
+//               If false is returned, r_values may be a mixture
+//               of old and new values.
+//
+inline bool readTelemetry (const TelemetryBlock& block,
+                           TelemetryValues& r_values)
+{
+	uint32_t before = block.m_sequence.load(std::memory_order_acquire);
+	if(before % 2 != 0)
+		return false;
+	std::memcpy(&r_values, &block.m_values, sizeof(TelemetryValues));
+	std::atomic_thread_fence(std::memory_order_acquire);
+	uint32_t after = block.m_sequence.load(std::memory_order_relaxed);
+	return after == before;
+}
+
+
+
+#endif
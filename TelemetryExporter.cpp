@@ -0,0 +1,125 @@
+//
+//  TelemetryExporter.cpp
+//
+
+#include <cassert>
+#include <atomic>
+#include <cstdint>
+#include <fstream>
+#include <new>
+#include <string>
+
+#ifdef _WIN32
+	#include <windows.h>
+	#include <psapi.h>
+#else	// Posix
+	#include <unistd.h>
+#endif
+
+#include "SharedMemoryFile.h"
+#include "TelemetryBlock.h"
+#include "TelemetryExporter.h"
+
+using namespace std;
+
+
+
+TelemetryExporter :: TelemetryExporter ()
+		: m_file()
+		, mp_block(nullptr)
+		, m_display_rate(0.0)
+		, m_resident_bytes(0)
+{
+	assert(invariant());
+}
+
+
+
+bool TelemetryExporter :: isOpen () const
+{
+	return mp_block != nullptr;
+}
+
+bool TelemetryExporter :: open (const string& filename)
+{
+	assert(!isOpen());
+	assert(filename != "");
+
+	if(!m_file.openForWriting(filename, sizeof(TelemetryBlock)))
+		return false;
+
+	// readers check the magic number before anything else
+	mp_block = new (m_file.getData()) TelemetryBlock;
+	mp_block->m_magic       = 0;
+	mp_block->m_version     = TelemetryBlock::VERSION;
+	mp_block->m_values_size = sizeof(TelemetryValues);
+	mp_block->m_sequence.store(0, memory_order_relaxed);
+	TelemetryValues zero = {};
+	writeTelemetry(*mp_block, zero);
+	atomic_thread_fence(memory_order_release);
+	mp_block->m_magic = TelemetryBlock::MAGIC;
+
+	assert(invariant());
+	return true;
+}
+
+void TelemetryExporter :: close ()
+{
+	mp_block = nullptr;
+	m_file.close();
+
+	assert(invariant());
+}
+
+void TelemetryExporter :: setDisplayRate (double rate)
+{
+	m_display_rate.store(rate, memory_order_relaxed);
+}
+
+void TelemetryExporter :: setResidentBytes (uint64_t bytes)
+{
+	m_resident_bytes.store(bytes, memory_order_relaxed);
+}
+
+void TelemetryExporter :: publish (const TelemetryValues& values)
+{
+	assert(isOpen());
+
+	TelemetryValues published = values;
+	published.m_display_rate   = m_display_rate.load(memory_order_relaxed);
+	published.m_resident_bytes = m_resident_bytes.load(memory_order_relaxed);
+	writeTelemetry(*mp_block, published);
+}
+
+#ifdef _WIN32
+
+uint64_t TelemetryExporter :: getResidentBytes ()
+{
+	PROCESS_MEMORY_COUNTERS counters;
+	if(!K32GetProcessMemoryInfo(GetCurrentProcess(), &counters, sizeof(counters)))
+		return 0;
+	return counters.WorkingSetSize;
+}
+
+#else	// Posix
+
+uint64_t TelemetryExporter :: getResidentBytes ()
+{
+	// the second number is the resident size in pages
+	ifstream fin("/proc/self/statm");
+	uint64_t total_pages;
+	uint64_t resident_pages;
+	if(!(fin >> total_pages >> resident_pages))
+		return 0;
+	return resident_pages * (uint64_t)(sysconf(_SC_PAGESIZE));
+}
+
+#endif
+
+
+
+bool TelemetryExporter :: invariant () const
+{
+	if((mp_block == nullptr) != !m_file.isOpen()) return false;
+	return true;
+}
@@ -0,0 +1,181 @@
+//
+//  TelemetryExporter.h
+//
+//  A module to publish live statistics to other programs
+//    through a shared file.
+//
+
+#ifndef TELEMETRY_EXPORTER_H
+#define TELEMETRY_EXPORTER_H
+
+#include <cassert>
+#include <atomic>
+#include <cstdint>
+#include <string>
+
+#include "SharedMemoryFile.h"
+#include "TelemetryBlock.h"
+
+
+
+//
+//  TelemetryExporter
+//
+//  A class to publish TelemetryValues in a memory-mapped file,
+//    where a dashboard or Tools/TelemetryReader can watch them
+//    while the game runs.  Publishing copies the values into
+//    the mapped memory under a sequence lock, so it makes no
+//    system calls and never waits for a reader.
+//
+//  Only one thread may publish.  The display rate and the
+//    resident memory are kept separately, so the display
+//    thread can set them at any time, and they are included
+//    the next time the values are published.  Measuring the
+//    resident memory makes system calls, so this keeps them
+//    off the thread that publishes.
+//
+//  A TelemetryExporter cannot be copied.
+//
+//  Class Invariant:
+//    <1> (mp_block == nullptr) == !m_file.isOpen()
+//
+class TelemetryExporter
+{
+public:
+	//
+	//  Default Constructor
+	//
+	//  Purpose: To create a new TelemetryExporter that is not
+	//           open.
+	//  Parameter(s): N/A
+	//  Precondition(s): N/A
+	//  Returns: N/A
+	//  Side Effect: A new TelemetryExporter is created.
+	//
+	TelemetryExporter ();
+
+	TelemetryExporter (const TelemetryExporter& original) = delete;
+	TelemetryExporter& operator= (const TelemetryExporter& original) = delete;
+
+	//
+	//  isOpen
+	//
+	//  Purpose: To determine whether values are being
+	//           published.
+	//  Parameter(s): N/A
+	//  Precondition(s): N/A
+	//  Returns: Whether a file is open.
+	//  Side Effect: N/A
+	//
+	bool isOpen () const;
+
+	//
+	//  open
+	//
+	//  Purpose: To start publishing to the specified file.
+	//  Parameter(s):
+	//    <1> filename: The name of the file
+	//  Precondition(s):
+	//    <1> !isOpen()
+	//    <2> filename != ""
+	//  Returns: Whether the file was opened.
+	//  Side Effect: The file is created or replaced with a
+	//               TelemetryBlock with all values 0.  If it
+	//               cannot be, an error message is printed.
+	//
+	bool open (const std::string& filename);
+
+	//
+	//  close
+	//
+	//  Purpose: To stop publishing.
+	//  Parameter(s): N/A
+	//  Precondition(s): N/A
+	//  Returns: N/A
+	//  Side Effect: If the file is open, it is closed.  It is
+	//               left in place with the last values.
+	//
+	void close ();
+
+	//
+	//  setDisplayRate
+	//
+	//  Purpose: To set the display rate to publish.
+	//  Parameter(s):
+	//    <1> rate: The displayed frames per second
+	//  Precondition(s): N/A
+	//  Returns: N/A
+	//  Side Effect: rate will be published with the next
+	//               values.  This function may be called from
+	//               any thread.
+	//
+	void setDisplayRate (double rate);
+
+	//
+	//  setResidentBytes
+	//
+	//  Purpose: To set the resident memory to publish.
+	//  Parameter(s):
+	//    <1> bytes: The resident set size in bytes, as
+	//               returned by getResidentBytes
+	//  Precondition(s): N/A
+	//  Returns: N/A
+	//  Side Effect: bytes will be published with the next
+	//               values.  This function may be called from
+	//               any thread.
+	//
+	void setResidentBytes (uint64_t bytes);
+
+	//
+	//  publish
+	//
+	//  Purpose: To publish the specified values.
+	//  Parameter(s):
+	//    <1> values: The values
+	//  Precondition(s):
+	//    <1> isOpen()
+	//    <2> Only one thread calls publish.
+	//  Returns: N/A
+	//  Side Effect: values are written to the file, with the
+	//               display rate and resident memory replaced by
+	//               the last ones set.
+	//
+	void publish (const TelemetryValues& values);
+
+	//
+	//  getResidentBytes
+	//
+	//  Purpose: To determine how much memory this process is
+	//           using.
+	//  Parameter(s): N/A
+	//  Precondition(s): N/A
+	//  Returns: The resident set size in bytes, or 0 if it
+	//           cannot be determined.  This makes system calls,
+	//           so it should not be called every frame or from
+	//           the thread that publishes.
+	//  Side Effect: N/A
+	//
+	static uint64_t getResidentBytes ();
+
+private:
+	//
+	//  Helper Function: invariant
+	//
+	//  Purpose: To determine if the class invariant is true.
+	//  Parameter(s): N/A
+	//  Precondition(s): N/A
+	//  Returns: Whether the class invariant is true.
+	//  Side Effect: N/A
+	//
+	bool invariant () const;
+
+private:
+	SharedMemoryFile m_file;
+	TelemetryBlock* mp_block;
+	std::atomic<double> m_display_rate;
+	std::atomic<uint64_t> m_resident_bytes;
+};
+
+
+
+#endif
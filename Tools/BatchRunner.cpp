@@ -0,0 +1,361 @@
+//
+//  BatchRunner.cpp
+//
+//  A command-line program to run many games at once in the
+//    same world, for tuning the rings and load testing.
+//
+//  This program is not part of the game project.  Build it from
+//    the main folder with, for example:
+//
+//    g++ -std=c++17 -O2 -I. Tools/BatchRunner.cpp
+//        $(ls *.cpp | grep -v '^Main.cpp$') ObjLibrary/*.cpp
+//        -lglut -lGLU -lGL -pthread -o BatchRunner
+//
+//  and run it from the folder the game is run from:
+//
+//    ./BatchRunner [world file] [--games N] [--ticks T]
+//                  [--seed S] [--threads K] [--check C]
+//
+//  The World is loaded once and shared, read-only, by every
+//    Game.  Each Game has its own rods, rings, player, and
+//    RandomStream, seeded from S and its index, and is driven
+//    by a simple random player that changes its input every
+//    few physics frames.  The Games are handed out to K
+//    threads, one per hardware thread by default, and each is
+//    created, run for T physics frames, and destroyed on the
+//    thread that picked it up.  Its memory is therefore
+//    allocated by that thread, so Games on different threads
+//    do not share cache lines, and only a few Games exist at
+//    once.  The results are written to an array of cache-line
+//    sized records for the same reason.
+//
+//  To check for false sharing and other contention, the first
+//    C Games are then run again one at a time.  Each Game must
+//    end in exactly the same state, or the threads interfered
+//    with each other.  The time the physics frames took for
+//    those Games alone is compared with the time they took
+//    alongside the others.  If threads slow each other down by
+//    writing to the same cache lines, or by waiting on the
+//    same locks, the Games take longer together, and a warning
+//    is printed.
+//
+
+#include <algorithm>
+#include <cassert>
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "ObjLibrary/Vector3.h"
+
+#include "ParallelFor.h"
+#include "RandomStream.h"
+#include "World.h"
+#include "GameCheckpoint.h"
+#include "Game.h"
+
+using namespace std;
+using namespace ObjLibrary;
+namespace
+{
+	const string WORLD_FILENAME_DEFAULT = "Worlds/Basic.txt";
+	const unsigned int GAME_COUNT_DEFAULT  = 256;
+	const unsigned int TICK_COUNT_DEFAULT  = 600;
+	const unsigned int CHECK_COUNT_DEFAULT = 16;
+
+	//
+	//  INPUT_INTERVAL
+	//
+	//  How many physics frames the random player keeps the same
+	//    input for.
+	//
+	const unsigned int INPUT_INTERVAL = 15;
+
+	//
+	//  EFFICIENCY_MIN
+	//
+	//  The fraction of its speed alone that a Game must keep
+	//    when run alongside the others.  Below this, the
+	//    threads are probably slowing each other down.
+	//
+	const double EFFICIENCY_MIN = 0.75;
+
+	//
+	//  CACHE_LINE_SIZE
+	//
+	//  The size of a cache line in bytes on common processors.
+	//
+	const size_t CACHE_LINE_SIZE = 64;
+
+	const unsigned int NOT_OVER = 0xFFFFFFFF;
+
+	//
+	//  GameResult
+	//
+	//  A record of how one Game went.  Each GameResult is
+	//    written by a different thread, so each one has its own
+	//    cache line.
+	//
+	struct alignas(CACHE_LINE_SIZE) GameResult
+	{
+		uint64_t m_state_hash;
+		double m_init_time;
+		double m_tick_time;
+		int m_score;
+		unsigned int m_game_over_tick;
+	};
+
+	static_assert(sizeof(GameResult) % CACHE_LINE_SIZE == 0,
+	              "GameResult must fill whole cache lines");
+}
+
+
+
+//
+//  chooseInput
+//
+//  Purpose: To choose the next input for the random player.
+//  Parameter(s):
+//    <1> r_random: The RandomStream to choose with
+//  Precondition(s): N/A
+//  Returns: An input bitmask (see Game::INPUT_*) that usually
+//           moves forward, sometimes turning or jumping.
+//  Side Effect: r_random is advanced.
+//
+unsigned int chooseInput (RandomStream& r_random)
+{
+	unsigned int input = 0;
+	if(r_random.random0() < 0.8)
+		input |= Game::INPUT_FORWARD;
+
+	double turn = r_random.random0();
+	if(turn < 0.25)
+		input |= Game::INPUT_TURN_LEFT;
+	else if(turn < 0.5)
+		input |= Game::INPUT_TURN_RIGHT;
+
+	if(r_random.random0() < 0.1)
+		input |= Game::INPUT_JUMP;
+	return input;
+}
+
+//
+//  runGame
+//
+//  Purpose: To run one Game from start to finish.
+//  Parameter(s):
+//    <1> p_world: The World to play in
+//    <2> seed: The seed for the Game and the random player
+//    <3> tick_count: The number of physics frames to run
+//    <4> r_result: A reference to the GameResult to fill
+//  Precondition(s):
+//    <1> p_world != nullptr
+//    <2> p_world->isInitialized()
+//  Returns: N/A
+//  Side Effect: A Game is created in World p_world, run for
+//               tick_count physics frames, and destroyed.  How
+//               it went is written to r_result.
+//
+void runGame (const shared_ptr<const World>& p_world,
+              uint64_t seed,
+              unsigned int tick_count,
+              GameResult& r_result)
+{
+	assert(p_world != nullptr);
+	assert(p_world->isInitialized());
+
+	chrono::steady_clock::time_point start = chrono::steady_clock::now();
+	Game game;
+	game.init(p_world, RandomStream::mixSeed(seed, 0));
+	game.update();  // as the game does before it starts
+	RandomStream input_random(RandomStream::mixSeed(seed, 1));
+	chrono::steady_clock::time_point ticks_start = chrono::steady_clock::now();
+
+	unsigned int game_over_tick = NOT_OVER;
+	unsigned int input = 0;
+	for(unsigned int tick = 0; tick < tick_count; tick++)
+	{
+		if(tick % INPUT_INTERVAL == 0)
+			input = chooseInput(input_random);
+		if(!game.isGameOver())
+			game.handleInput(input);
+		game.update();
+		if(game_over_tick == NOT_OVER && game.isGameOver())
+			game_over_tick = tick;
+	}
+	chrono::steady_clock::time_point end = chrono::steady_clock::now();
+
+	GameCheckpoint checkpoint;
+	game.saveCheckpoint(checkpoint);
+
+	r_result.m_state_hash     = checkpoint.calculateHash();
+	r_result.m_init_time      = chrono::duration<double>(ticks_start - start).count();
+	r_result.m_tick_time      = chrono::duration<double>(end - ticks_start).count();
+	r_result.m_score          = game.getScore();
+	r_result.m_game_over_tick = game_over_tick;
+}
+
+//
+//  printUsage
+//
+//  Purpose: To print how to run this program.
+//  Parameter(s):
+//    <1> program: The name of this program
+//  Precondition(s): N/A
+//  Returns: N/A
+//  Side Effect: The usage is printed to standard error.
+//
+void printUsage (const char* program)
+{
+	cerr << "Usage: " << program << " [world file] [--games N] [--ticks T]" << endl
+	     << "       [--seed S] [--threads K] [--check C]" << endl;
+}
+
+
+
+int main (int argc, char* argv[])
+{
+	string world_filename    = WORLD_FILENAME_DEFAULT;
+	unsigned int game_count  = GAME_COUNT_DEFAULT;
+	unsigned int tick_count  = TICK_COUNT_DEFAULT;
+	uint64_t seed            = RandomStream::createSeed();
+	unsigned int thread_max  = 0;
+	unsigned int check_count = CHECK_COUNT_DEFAULT;
+
+	for(int a = 1; a < argc; a++)
+	{
+		string argument = argv[a];
+		if(argument.size() < 2 || argument.substr(0, 2) != "--")
+			world_filename = argument;
+		else if(a + 1 >= argc)
+		{
+			printUsage(argv[0]);
+			return 1;
+		}
+		else if(argument == "--games")
+			game_count = atoi(argv[++a]);
+		else if(argument == "--ticks")
+			tick_count = atoi(argv[++a]);
+		else if(argument == "--seed")
+			seed = strtoull(argv[++a], nullptr, 10);
+		else if(argument == "--threads")
+			thread_max = atoi(argv[++a]);
+		else if(argument == "--check")
+			check_count = atoi(argv[++a]);
+		else
+		{
+			printUsage(argv[0]);
+			return 1;
+		}
+	}
+	if(game_count == 0 || tick_count == 0)
+	{
+		printUsage(argv[0]);
+		return 1;
+	}
+	if(check_count > game_count)
+		check_count = game_count;
+
+	shared_ptr<World> p_loaded = make_shared<World>();
+	if(!p_loaded->init(world_filename, seed))
+	{
+		cerr << "Error: Could not load world \"" << world_filename << "\"" << endl;
+		return 1;
+	}
+	shared_ptr<const World> p_world = p_loaded;
+	p_loaded = nullptr;
+
+	unsigned int thread_count = thread::hardware_concurrency();
+	if(thread_max != 0 && thread_count > thread_max)
+		thread_count = thread_max;
+	if(thread_count > game_count)
+		thread_count = game_count;
+	if(thread_count < 1)
+		thread_count = 1;
+
+	cout << "World \"" << world_filename << "\": " << p_world->getDiskCount() << " disks, "
+	     << p_world->getMemoryBytes() / 1024 << " KB, shared by every Game" << endl;
+	cout << "Running " << game_count << " Games for " << tick_count
+	     << " physics frames each on " << thread_count
+	     << (thread_count == 1 ? " thread" : " threads") << " (seed " << seed << ")" << endl;
+
+	vector<GameResult> v_results(game_count);
+	chrono::steady_clock::time_point start = chrono::steady_clock::now();
+	parallelFor(0, game_count, [&] (unsigned int g)
+	{
+		runGame(p_world, RandomStream::mixSeed(seed, g), tick_count, v_results[g]);
+	}, thread_count);
+	double duration = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+
+	double init_time_total = 0.0;
+	double tick_time_total = 0.0;
+	long long score_total  = 0;
+	int score_max          = 0;
+	unsigned int game_over_count = 0;
+	for(unsigned int g = 0; g < game_count; g++)
+	{
+		init_time_total += v_results[g].m_init_time;
+		tick_time_total += v_results[g].m_tick_time;
+		score_total     += v_results[g].m_score;
+		score_max        = max(score_max, v_results[g].m_score);
+		if(v_results[g].m_game_over_tick != NOT_OVER)
+			game_over_count++;
+	}
+	double frame_count = (double)(game_count) * tick_count;
+
+	cout << "Ran " << (unsigned long long)(frame_count) << " physics frames in " << duration << " s"
+	     << " (" << init_time_total << " s of thread time initializing)" << endl;
+	cout << "Aggregate: " << (unsigned long long)(frame_count / duration) << " physics frames per second";
+	if(tick_time_total > 0.0)
+		cout << ", " << (unsigned long long)(frame_count / tick_time_total) << " per thread";
+	cout << endl;
+	cout << "Score: mean " << (double)(score_total) / game_count << ", best " << score_max
+	     << "; " << game_over_count << " of " << game_count << " Games over" << endl;
+
+	if(check_count == 0)
+		return 0;
+
+	// run some Games again with no other threads to interfere
+	cout << "Checking " << check_count << " Games on 1 thread..." << endl;
+	vector<GameResult> v_alone(check_count);
+	for(unsigned int g = 0; g < check_count; g++)
+		runGame(p_world, RandomStream::mixSeed(seed, g), tick_count, v_alone[g]);
+
+	unsigned int mismatch_count = 0;
+	double alone_time    = 0.0;
+	double together_time = 0.0;
+	for(unsigned int g = 0; g < check_count; g++)
+	{
+		if(v_alone[g].m_state_hash != v_results[g].m_state_hash)
+		{
+			if(mismatch_count == 0)
+				cout << "  Game " << g << " ended differently on its own" << endl;
+			mismatch_count++;
+		}
+		alone_time    += v_alone[g].m_tick_time;
+		together_time += v_results[g].m_tick_time;
+	}
+
+	if(mismatch_count > 0)
+		cout << "  " << mismatch_count << " of " << check_count
+		     << " Games did not match: the threads share state they change" << endl;
+	else
+		cout << "  Every Game matched" << endl;
+
+	if(together_time > 0.0)
+	{
+		double efficiency = alone_time / together_time;
+		cout << "  Efficiency with " << thread_count << (thread_count == 1 ? " thread: " : " threads: ")
+		     << (int)(efficiency * 100.0 + 0.5) << "% of the speed alone" << endl;
+		if(efficiency < EFFICIENCY_MIN)
+			cout << "  Warning: The threads slow each other down, possibly by false sharing" << endl
+			     << "           or waiting on the same locks" << endl;
+	}
+
+	return (mismatch_count > 0) ? 2 : 0;
+}
@@ -0,0 +1,117 @@
+//
+//  InputReplayer.cpp
+//
+//  A command-line program to replay a game session recorded by
+//    the game and check that it goes the same way.  The game
+//    only records a session when it is run with the --record
+//    argument.
+//
+//  This program is not part of the game project.  Build it from
+//    the main folder with, for example:
+//
+//    g++ -std=c++17 -O2 -I. Tools/InputReplayer.cpp
+//        $(ls *.cpp | grep -v '^Main.cpp$') ObjLibrary/*.cpp
+//        -lglut -lGLU -lGL -pthread -o InputReplayer
+//
+//  and run it from the folder the game is run from:
+//
+//    ./InputReplayer [recording file]
+//
+//  The world is loaded from the recorded world data file with
+//    the recorded seed, and a Game is initialized in it with
+//    the recorded seed.  The Game is then updated with the
+//    recorded input as fast as possible, without a display.
+//    After each physics frame, the hash of the game state is
+//    compared with the recorded one.  The replay stops at the
+//    first physics frame where they differ, which is the first
+//    place the game is not deterministic.  The world data file
+//    must not have been changed since the session was
+//    recorded.
+//
+
+#include <cassert>
+#include <chrono>
+#include <iostream>
+#include <memory>
+#include <string>
+
+#include "World.h"
+#include "GameCheckpoint.h"
+#include "Game.h"
+#include "InputRecording.h"
+
+using namespace std;
+namespace
+{
+	const string FILENAME_DEFAULT = "Recording.a5i";
+}
+
+
+
+int main (int argc, char* argv[])
+{
+	string filename = FILENAME_DEFAULT;
+	if(argc >= 2)
+		filename = argv[1];
+	if(argc >= 3)
+	{
+		cerr << "Usage: " << argv[0] << " [recording file]" << endl;
+		return 1;
+	}
+
+	InputRecording recording;
+	if(!recording.load(filename))
+		return 1;
+	cout << "Recording: " << recording.getTickCount() << " physics frames in "
+	     << recording.getRunCount() << " runs, world \""
+	     << recording.getWorldFilename() << "\"" << endl;
+
+	shared_ptr<World> p_world = make_shared<World>();
+	if(!p_world->init(recording.getWorldFilename(), recording.getWorldSeed()))
+	{
+		cerr << "Error: Could not load world \"" << recording.getWorldFilename() << "\"" << endl;
+		return 1;
+	}
+
+	Game game;
+	game.init(p_world, recording.getGameSeed());
+	for(unsigned int i = 0; i < recording.getWarmUpCount(); i++)
+		game.update();
+
+	// the game restarts from here, like in SimulationThread
+	GameCheckpoint restart_checkpoint;
+	game.saveCheckpoint(restart_checkpoint);
+
+	GameCheckpoint hash_checkpoint;
+	chrono::steady_clock::time_point start = chrono::steady_clock::now();
+	unsigned int tick_count = recording.getTickCount();
+	unsigned int tick = 0;
+	for( ; tick < tick_count; tick++)
+	{
+		unsigned int input = recording.getInput(tick);
+		if((input & Game::INPUT_RESTART) != 0)
+			game.restoreCheckpoint(restart_checkpoint);
+		if(!game.isGameOver())
+			game.handleInput(input);
+		game.update();
+
+		game.saveCheckpoint(hash_checkpoint);
+		if(!recording.isStateHashMatching(tick, hash_checkpoint.calculateHash()))
+			break;
+	}
+	double duration = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+
+	cout << "Replayed " << tick << " physics frames in " << duration << " s";
+	if(duration > 0.0)
+		cout << " (" << (unsigned int)(tick / duration) << " per second)";
+	cout << endl;
+	cout << "Score: " << game.getScore() << (game.isGameOver() ? " (game over)" : "") << endl;
+
+	if(tick < tick_count)
+	{
+		cout << "Desynchronized at physics frame " << tick << endl;
+		return 2;
+	}
+	cout << "All physics frames matched" << endl;
+	return 0;
+}
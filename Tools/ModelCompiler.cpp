@@ -0,0 +1,349 @@
+//
+//  ModelCompiler.cpp
+//
+//  A command-line program to convert the OBJ models used by the
+//    game into compiled models that load without parsing.
+//
+//  This program is not part of the game project.  Build it from
+//    the main folder with, for example:
+//
+//    g++ -std=c++17 -O2 -I. Tools/ModelCompiler.cpp
+//        CompiledModel.cpp AnimationModel.cpp MeshOptimizer.cpp
+//        MeshSimplifier.cpp Renderer.cpp ObjLibrary/*.cpp -lglut -lGLU -lGL -pthread
+//        -o ModelCompiler
+//
+//  and run it from the main folder so that the material and
+//    texture paths inside the models resolve:
+//
+//    ./ModelCompiler [OBJ file ...]
+//
+//  If no files are specified, every OBJ file in the Models
+//    folder is compiled.  Each compiled model is written beside
+//    its OBJ file, named by CompiledModel::getCompiledFilename.
+//    Models containing point sets or polylines are skipped,
+//    because the game would draw them incompletely; it falls
+//    back to the OBJ file for those.
+//
+//  Each model is optimized for the vertex cache before it is
+//    written, and its average cache miss ratio (ACMR) before
+//    and after is shown.  Identical vertexes are merged except
+//    in animation frames, where that could give frames
+//    different surfaces.
+//
+//  Simplified levels of detail are calculated for each model
+//    and stored in its compiled file.  The triangle count of
+//    each level and the time taken to simplify are shown.
+//    Animation frames are skipped, because the game calculates
+//    the levels for an animation from its shared surface.
+//
+//  For each animation among the models, named NAME_run0.obj,
+//    NAME_run1.obj, and so on, the memory needed to store the
+//    frames as separate models is compared to the memory
+//    needed for an AnimationModel, with and without quantized
+//    positions.  The time to blend two quantized frames is also
+//    shown.
+//
+
+#include <algorithm>
+#include <cassert>
+#include <cctype>
+#include <chrono>
+#include <filesystem>
+#include <iomanip>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "ObjLibrary/ObjModel.h"
+#include "CompiledModel.h"
+#include "AnimationModel.h"
+
+using namespace std;
+using namespace ObjLibrary;
+namespace
+{
+	const string MODEL_FOLDER_DEFAULT = "Models";
+	const string FIRST_FRAME_SUFFIX = "_run0.obj";
+	const unsigned int BLEND_REPEAT_COUNT = 10000;
+}
+
+
+
+//
+//  findModels
+//
+//  Purpose: To find all the OBJ files in the specified folder.
+//  Parameter(s):
+//    <1> folder: The folder to search
+//  Precondition(s): N/A
+//  Returns: The names of the OBJ files in folder, in sorted
+//           order.  If folder does not exist, an empty vector
+//           is returned.
+//  Side Effect: N/A
+//
+vector<string> findModels (const string& folder)
+{
+	vector<string> v_filenames;
+
+	error_code error;
+	for(filesystem::directory_iterator it(folder, error); !error && it != filesystem::directory_iterator(); it.increment(error))
+	{
+		if(it->path().extension() == ".obj")
+			v_filenames.push_back(it->path().generic_string());
+	}
+
+	sort(v_filenames.begin(), v_filenames.end());
+	return v_filenames;
+}
+
+//
+//  isAnimationFrame
+//
+//  Purpose: To determine whether the specified model is a frame
+//           of an animation.
+//  Parameter(s):
+//    <1> filename: The name of the OBJ file
+//  Precondition(s): N/A
+//  Returns: Whether filename has the form NAME_runN.obj, where N
+//           is a number.
+//  Side Effect: N/A
+//
+bool isAnimationFrame (const string& filename)
+{
+	static const string FRAME_MARKER = "_run";
+	static const string EXTENSION    = ".obj";
+
+	size_t marker = filename.rfind(FRAME_MARKER);
+	if(marker == string::npos || filename.size() < EXTENSION.size() ||
+	   filename.compare(filename.size() - EXTENSION.size(), string::npos, EXTENSION) != 0)
+	{
+		return false;
+	}
+
+	size_t digits_start = marker + FRAME_MARKER.size();
+	size_t digits_end   = filename.size() - EXTENSION.size();
+	if(digits_start >= digits_end)
+		return false;
+	for(size_t i = digits_start; i < digits_end; i++)
+		if(!isdigit((unsigned char)(filename[i])))
+			return false;
+	return true;
+}
+
+//
+//  compileModel
+//
+//  Purpose: To compile the specified model.
+//  Parameter(s):
+//    <1> filename: The name of the OBJ file
+//  Precondition(s):
+//    <1> filename != ""
+//  Returns: Whether the model was compiled.
+//  Side Effect: The compiled model is written and a summary is
+//               printed to standard output.  Any errors are
+//               printed to standard error.
+//
+bool compileModel (const string& filename)
+{
+	stringstream log;
+	ObjModel model;
+	model.load(filename, log);
+	if(!log.str().empty())
+		cerr << log.str();
+	if(!model.isValid() || model.getMeshCount() == 0)
+	{
+		cerr << "Could not load \"" << filename << "\"" << endl;
+		return false;
+	}
+	if(!CompiledModel::isCompilable(model))
+	{
+		cerr << "Skipping \"" << filename << "\": contains point sets or polylines" << endl;
+		return false;
+	}
+
+	CompiledModel compiled(model);
+	float acmr_before = compiled.getAcmr();
+	bool is_animation_frame = isAnimationFrame(filename);
+	compiled.optimize(!is_animation_frame);
+
+	auto simplify_start = chrono::steady_clock::now();
+	if(!is_animation_frame)
+		compiled.generateLevels();
+	auto simplify_end   = chrono::steady_clock::now();
+
+	stringstream level_triangles;
+	for(unsigned int level = 0; level < compiled.getLevelCount(); level++)
+	{
+		if(level > 0)
+			level_triangles << "/";
+		level_triangles << compiled.getTriangleCount(level);
+	}
+
+	string compiled_filename = CompiledModel::getCompiledFilename(filename);
+	if(!compiled.save(compiled_filename))
+	{
+		cerr << "Could not write \"" << compiled_filename << "\"" << endl;
+		return false;
+	}
+
+	// load it back to make sure the file is readable and time it
+	CompiledModel check;
+	auto start = chrono::steady_clock::now();
+	bool is_loaded = check.load(compiled_filename);
+	auto end   = chrono::steady_clock::now();
+	if(!is_loaded || check.getTriangleCount() != compiled.getTriangleCount() ||
+	   check.getLevelCount() != compiled.getLevelCount())
+	{
+		cerr << "Could not read back \"" << compiled_filename << "\"" << endl;
+		return false;
+	}
+
+	cout << setw(32) << left << filename << right
+	     << setw(10) << compiled.getVertexCount()
+	     << setw(10) << compiled.getTriangleCount()
+	     << setw(12) << filesystem::file_size(filename)
+	     << setw(12) << filesystem::file_size(compiled_filename)
+	     << setw(12) << chrono::duration<double, milli>(end - start).count()
+	     << setw(8)  << acmr_before
+	     << setw(8)  << compiled.getAcmr()
+	     << setw(20) << level_triangles.str()
+	     << setw(15) << chrono::duration<double, milli>(simplify_end - simplify_start).count() << endl;
+	return true;
+}
+
+//
+//  reportAnimation
+//
+//  Purpose: To compare the memory needed to store the specified
+//           animation as separate models and as an
+//           AnimationModel.
+//  Parameter(s):
+//    <1> first_filename: The name of the OBJ file for the first
+//                        frame, ending in FIRST_FRAME_SUFFIX
+//  Precondition(s):
+//    <1> first_filename ends with FIRST_FRAME_SUFFIX
+//  Returns: N/A
+//  Side Effect: The frames are loaded, one after another until
+//               a frame file does not exist, and a summary is
+//               printed to standard output.  Blending is timed
+//               between each frame and the next.
+//
+void reportAnimation (const string& first_filename)
+{
+	assert(first_filename.size() >= FIRST_FRAME_SUFFIX.size());
+	string prefix = first_filename.substr(0, first_filename.size() - FIRST_FRAME_SUFFIX.size()) + "_run";
+
+	AnimationModel animation(false);
+	AnimationModel quantized(true);
+	size_t separate_bytes = 0;
+	for(unsigned int i = 0; ; i++)
+	{
+		stringstream filename;
+		filename << prefix << i << ".obj";
+		if(!filesystem::exists(filename.str()))
+			break;
+
+		stringstream log;
+		ObjModel model;
+		model.load(filename.str(), log);
+		CompiledModel compiled(model);
+		separate_bytes += compiled.getMemoryUsage();
+		animation.addFrame(compiled);
+		quantized.addFrame(compiled);
+	}
+
+	unsigned int frame_count = quantized.getFrameCount();
+	double blend_us = 0.0;
+	if(frame_count > 0)
+	{
+		unsigned int vertex_count_max = 0;
+		for(unsigned int f = 0; f < frame_count; f++)
+			vertex_count_max = max(vertex_count_max, quantized.getVertexCount(f));
+		vector<float> v_positions(vertex_count_max * 3);
+
+		unsigned int blend_count = 0;
+		auto start = chrono::steady_clock::now();
+		for(unsigned int i = 0; i < BLEND_REPEAT_COUNT; i++)
+		{
+			unsigned int frame0 = i % frame_count;
+			unsigned int frame1 = (i + 1) % frame_count;
+			if(quantized.isBlendable(frame0, frame1))
+			{
+				quantized.getBlendedPositions(frame0, frame1, 0.5f, v_positions.data());
+				blend_count++;
+			}
+		}
+		auto end = chrono::steady_clock::now();
+		if(blend_count > 0)
+			blend_us = chrono::duration<double, micro>(end - start).count() / blend_count;
+	}
+
+	cout << setw(32) << left << (prefix + "*.obj") << right
+	     << setw(8)  << animation.getFrameCount()
+	     << setw(10) << animation.getSurfaceCount()
+	     << setw(12) << separate_bytes
+	     << setw(12) << animation.getMemoryUsage()
+	     << setw(12) << quantized.getMemoryUsage()
+	     << setw(12) << blend_us << endl;
+}
+
+int main (int argc, char* argv[])
+{
+	vector<string> v_filenames;
+	for(int i = 1; i < argc; i++)
+		v_filenames.push_back(argv[i]);
+	if(v_filenames.empty())
+		v_filenames = findModels(MODEL_FOLDER_DEFAULT);
+	if(v_filenames.empty())
+	{
+		cerr << "Usage: " << argv[0] << " [OBJ file ...]" << endl;
+		return 1;
+	}
+
+	cout << fixed << setprecision(3);
+	cout << setw(32) << left << "Model" << right
+	     << setw(10) << "Vertexes"
+	     << setw(10) << "Triangles"
+	     << setw(12) << "OBJ bytes"
+	     << setw(12) << "A5M bytes"
+	     << setw(12) << "Load (ms)"
+	     << setw(8)  << "ACMR"
+	     << setw(8)  << "Opt"
+	     << setw(20) << "LOD triangles"
+	     << setw(15) << "Simplify (ms)" << endl;
+
+	unsigned int failed_count = 0;
+	for(unsigned int i = 0; i < v_filenames.size(); i++)
+		if(!compileModel(v_filenames[i]))
+			failed_count++;
+
+	cout << (v_filenames.size() - failed_count) << " of " << v_filenames.size()
+	     << " models compiled" << endl;
+
+	bool is_any_animation = false;
+	for(unsigned int i = 0; i < v_filenames.size(); i++)
+	{
+		const string& filename = v_filenames[i];
+		if(filename.size() < FIRST_FRAME_SUFFIX.size() ||
+		   filename.compare(filename.size() - FIRST_FRAME_SUFFIX.size(), string::npos, FIRST_FRAME_SUFFIX) != 0)
+		{
+			continue;
+		}
+
+		if(!is_any_animation)
+		{
+			cout << endl;
+			cout << setw(32) << left << "Animation" << right
+			     << setw(8)  << "Frames"
+			     << setw(10) << "Surfaces"
+			     << setw(12) << "Separate"
+			     << setw(12) << "Float"
+			     << setw(12) << "Quantized"
+			     << setw(12) << "Blend (us)" << endl;
+			is_any_animation = true;
+		}
+		reportAnimation(filename);
+	}
+	return (failed_count == 0) ? 0 : 1;
+}
@@ -0,0 +1,181 @@
+//
+//  ObjLoadBenchmark.cpp
+//
+//  A command-line program to measure how long it takes to load
+//    the OBJ models used by the game.
+//
+//  This program is not part of the game project.  Build it from
+//    the main folder with, for example:
+//
+//    g++ -std=c++17 -O2 -I. Tools/ObjLoadBenchmark.cpp
+//        ObjLibrary/*.cpp -lglut -lGLU -lGL -o ObjLoadBenchmark
+//
+//  and run it from the main folder so that the models can be
+//    found:
+//
+//    ./ObjLoadBenchmark [repetitions] [model folder]
+//
+//  Only the file parsing is timed.  No OpenGL context is
+//    created and no textures are loaded.
+//
+
+#include <cstdlib>
+#include <algorithm>
+#include <chrono>
+#include <filesystem>
+#include <iomanip>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "ObjLibrary/ObjModel.h"
+
+using namespace std;
+using namespace ObjLibrary;
+namespace
+{
+	const unsigned int REPETITIONS_DEFAULT = 10;
+	const string MODEL_FOLDER_DEFAULT = "Models";
+
+	//
+	//  ModelTiming
+	//
+	//  A record of the load times for one model.
+	//
+	struct ModelTiming
+	{
+		string m_filename;
+		unsigned int m_vertex_count;
+		unsigned int m_face_count;
+		double m_min_ms;
+		double m_total_ms;
+	};
+}
+
+
+
+//
+//  findModels
+//
+//  Purpose: To find all the OBJ files in the specified folder.
+//  Parameter(s):
+//    <1> folder: The folder to search
+//  Precondition(s): N/A
+//  Returns: The names of the OBJ files in folder, in sorted
+//           order.  If folder does not exist, an empty vector
+//           is returned.
+//  Side Effect: N/A
+//
+vector<string> findModels (const string& folder)
+{
+	vector<string> v_filenames;
+
+	error_code error;
+	for(filesystem::directory_iterator it(folder, error); !error && it != filesystem::directory_iterator(); it.increment(error))
+	{
+		if(it->path().extension() == ".obj")
+			v_filenames.push_back(it->path().generic_string());
+	}
+
+	sort(v_filenames.begin(), v_filenames.end());
+	return v_filenames;
+}
+
+//
+//  timeModel
+//
+//  Purpose: To measure how long it takes to load the specified
+//           model.
+//  Parameter(s):
+//    <1> filename: The name of the model file
+//    <2> repetitions: The number of times to load the model
+//  Precondition(s):
+//    <1> filename != ""
+//    <2> repetitions >= 1
+//  Returns: The load times for the model.
+//  Side Effect: The model is loaded repetitions times.  Any
+//               loading errors are discarded.
+//
+ModelTiming timeModel (const string& filename, unsigned int repetitions)
+{
+	ModelTiming timing;
+	timing.m_filename     = filename;
+	timing.m_vertex_count = 0;
+	timing.m_face_count   = 0;
+	timing.m_min_ms       = 0.0;
+	timing.m_total_ms     = 0.0;
+
+	for(unsigned int r = 0; r < repetitions; r++)
+	{
+		stringstream log;
+		ObjModel model;
+
+		auto start = chrono::steady_clock::now();
+		model.load(filename, log);
+		auto end   = chrono::steady_clock::now();
+
+		double ms = chrono::duration<double, milli>(end - start).count();
+		if(r == 0 || ms < timing.m_min_ms)
+			timing.m_min_ms = ms;
+		timing.m_total_ms += ms;
+
+		timing.m_vertex_count = model.getVertexCount();
+		timing.m_face_count   = 0;
+		for(unsigned int m = 0; m < model.getMeshCount(); m++)
+			timing.m_face_count += model.getFaceCount(m);
+	}
+
+	return timing;
+}
+
+int main (int argc, char* argv[])
+{
+	unsigned int repetitions = REPETITIONS_DEFAULT;
+	string folder = MODEL_FOLDER_DEFAULT;
+	if(argc >= 2)
+		repetitions = atoi(argv[1]);
+	if(argc >= 3)
+		folder = argv[2];
+
+	if(repetitions < 1)
+	{
+		cerr << "Usage: " << argv[0] << " [repetitions] [model folder]" << endl;
+		return 1;
+	}
+
+	vector<string> v_filenames = findModels(folder);
+	if(v_filenames.empty())
+	{
+		cerr << "No OBJ files found in \"" << folder << "\"" << endl;
+		return 1;
+	}
+
+	cout << fixed << setprecision(3);
+	cout << setw(32) << left << "Model" << right
+	     << setw(10) << "Vertexes"
+	     << setw(10) << "Faces"
+	     << setw(12) << "Min (ms)"
+	     << setw(12) << "Mean (ms)" << endl;
+
+	double total_min_ms  = 0.0;
+	double total_mean_ms = 0.0;
+	for(unsigned int i = 0; i < v_filenames.size(); i++)
+	{
+		ModelTiming timing = timeModel(v_filenames[i], repetitions);
+		double mean_ms = timing.m_total_ms / repetitions;
+		total_min_ms  += timing.m_min_ms;
+		total_mean_ms += mean_ms;
+
+		cout << setw(32) << left << timing.m_filename << right
+		     << setw(10) << timing.m_vertex_count
+		     << setw(10) << timing.m_face_count
+		     << setw(12) << timing.m_min_ms
+		     << setw(12) << mean_ms << endl;
+	}
+
+	cout << setw(52) << left << "Total" << right
+	     << setw(12) << total_min_ms
+	     << setw(12) << total_mean_ms << endl;
+	return 0;
+}
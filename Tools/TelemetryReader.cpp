@@ -0,0 +1,237 @@
+//
+//  TelemetryReader.cpp
+//
+//  A command-line program to watch the live statistics the game
+//    publishes while it runs.
+//
+//  This program is not part of the game project.  Build it from
+//    the main folder with, for example:
+//
+//    g++ -std=c++17 -O2 -I. Tools/TelemetryReader.cpp
+//        SharedMemoryFile.cpp -o TelemetryReader
+//
+//  and run it from the folder the game is run from:
+//
+//    ./TelemetryReader [interval in seconds] [telemetry file]
+//
+//  The file is mapped read-only and polled, so reading it has
+//    no effect on the game.  A line is printed at each interval
+//    in which at least one physics frame ran.  If the game is
+//    not running yet, the reader waits for the file to appear.
+//
+
+#include <cassert>
+#include <chrono>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <thread>
+
+#include "SharedMemoryFile.h"
+#include "TelemetryBlock.h"
+
+using namespace std;
+namespace
+{
+	const double INTERVAL_DEFAULT = 0.5;
+	const string FILENAME_DEFAULT = "Telemetry.bin";
+	const unsigned int HEADER_INTERVAL = 20;
+	const unsigned int READ_ATTEMPT_MAX = 1000;
+}
+
+
+
+//
+//  isBlockValid
+//
+//  Purpose: To determine whether the specified file holds a
+//           TelemetryBlock this program can read.
+//  Parameter(s):
+//    <1> file: The mapped file
+//  Precondition(s):
+//    <1> file.isOpen()
+//  Returns: Whether file is large enough and has the right
+//           magic number, version, and value size.  If it does
+//           not, an error message is printed.
+//  Side Effect: N/A
+//
+bool isBlockValid (const SharedMemoryFile& file)
+{
+	assert(file.isOpen());
+
+	if(file.getSize() < sizeof(TelemetryBlock))
+	{
+		cerr << "Error: Telemetry file is too small" << endl;
+		return false;
+	}
+
+	const TelemetryBlock& block = *(const TelemetryBlock*)(file.getData());
+	if(block.m_magic != TelemetryBlock::MAGIC)
+	{
+		cerr << "Error: Not a telemetry file" << endl;
+		return false;
+	}
+	if(block.m_version != TelemetryBlock::VERSION ||
+	   block.m_values_size != sizeof(TelemetryValues))
+	{
+		cerr << "Error: Telemetry file is version " << block.m_version
+		     << ", but this program reads version " << TelemetryBlock::VERSION << endl;
+		return false;
+	}
+	return true;
+}
+
+//
+//  readValues
+//
+//  Purpose: To make a consistent copy of the values in the
+//           specified TelemetryBlock.
+//  Parameter(s):
+//    <1> block: The TelemetryBlock
+//    <2> r_values: A reference to the TelemetryValues to copy
+//                  the values into
+//  Precondition(s): N/A
+//  Returns: Whether a consistent copy was made.  This only
+//           fails if the game keeps writing for the whole time
+//           READ_ATTEMPT_MAX reads take.
+//  Side Effect: The values are copied into r_values.
+//
+bool readValues (const TelemetryBlock& block, TelemetryValues& r_values)
+{
+	for(unsigned int i = 0; i < READ_ATTEMPT_MAX; i++)
+	{
+		if(readTelemetry(block, r_values))
+			return true;
+		this_thread::yield();
+	}
+	return false;
+}
+
+//
+//  printHeader
+//
+//  Purpose: To print the column headings.
+//  Parameter(s): N/A
+//  Precondition(s): N/A
+//  Returns: N/A
+//  Side Effect: The column headings are printed to standard
+//               output.
+//
+void printHeader ()
+{
+	cout << setw(9)  << "Update"
+	     << setw(9)  << "Time"
+	     << setw(10) << "Tick ms"
+	     << setw(9)  << "Mean"
+	     << setw(9)  << "Max"
+	     << setw(8)  << "Ups"
+	     << setw(8)  << "Fps"
+	     << setw(10) << "Jitter us"
+	     << setw(8)  << "Drops"
+	     << setw(10) << "Searches"
+	     << setw(8)  << "Nodes"
+	     << setw(8)  << "Height"
+	     << setw(9)  << "RSS MB"
+	     << setw(7)  << "Score" << endl;
+}
+
+//
+//  printValues
+//
+//  Purpose: To print one line of statistics.
+//  Parameter(s):
+//    <1> values: The current values
+//    <2> update_rate: The physics frames per second since the
+//                     last line
+//  Precondition(s): N/A
+//  Returns: N/A
+//  Side Effect: The values are printed to standard output.
+//
+void printValues (const TelemetryValues& values, double update_rate)
+{
+	cout << setw(9)  << values.m_update_count
+	     << setw(9)  << setprecision(1) << values.m_elapsed_time
+	     << setw(10) << setprecision(3) << values.m_tick_time * 1000.0
+	     << setw(9)  << values.m_tick_time_mean * 1000.0
+	     << setw(9)  << values.m_tick_time_max  * 1000.0
+	     << setw(8)  << setprecision(1) << update_rate
+	     << setw(8)  << values.m_display_rate
+	     << setw(10) << values.m_jitter_rms * 1.0e6
+	     << setw(8)  << values.m_dropped_count
+	     << setw(10) << values.m_search_count_total
+	     << setw(8)  << values.m_nodes_expanded
+	     << setw(8)  << values.m_height_count
+	     << setw(9)  << values.m_resident_bytes / (1024.0 * 1024.0)
+	     << setw(7)  << values.m_score;
+	if(values.m_is_game_over != 0)
+		cout << "  (game over)";
+	cout << endl;
+}
+
+
+
+int main (int argc, char* argv[])
+{
+	double interval = INTERVAL_DEFAULT;
+	string filename = FILENAME_DEFAULT;
+	if(argc >= 2)
+		interval = atof(argv[1]);
+	if(argc >= 3)
+		filename = argv[2];
+
+	if(interval <= 0.0)
+	{
+		cerr << "Usage: " << argv[0] << " [interval in seconds] [telemetry file]" << endl;
+		return 1;
+	}
+	chrono::duration<double> sleep_time(interval);
+
+	SharedMemoryFile file;
+	bool is_waiting_shown = false;
+	while(!file.openForReading(filename))
+	{
+		if(!is_waiting_shown)
+		{
+			cout << "Waiting for \"" << filename << "\"..." << endl;
+			is_waiting_shown = true;
+		}
+		this_thread::sleep_for(sleep_time);
+	}
+	if(!isBlockValid(file))
+		return 1;
+	const TelemetryBlock& block = *(const TelemetryBlock*)(file.getData());
+
+	cout << fixed;
+	TelemetryValues previous = {};
+	unsigned int line_count = 0;
+	while(true)
+	{
+		TelemetryValues values;
+		if(!readValues(block, values))
+		{
+			cerr << "Warning: Could not read a consistent copy" << endl;
+		}
+		else if(values.m_update_count != previous.m_update_count)
+		{
+			// the game restarted
+			if(values.m_update_count < previous.m_update_count)
+				previous = TelemetryValues();
+
+			double update_rate = 0.0;
+			double elapsed = values.m_elapsed_time - previous.m_elapsed_time;
+			if(elapsed > 0.0)
+				update_rate = (values.m_update_count - previous.m_update_count) / elapsed;
+
+			if(line_count % HEADER_INTERVAL == 0)
+				printHeader();
+			printValues(values, update_rate);
+			line_count++;
+			previous = values;
+		}
+
+		this_thread::sleep_for(sleep_time);
+	}
+
+	return 0;
+}
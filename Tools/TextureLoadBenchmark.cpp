@@ -0,0 +1,228 @@
+//
+//  TextureLoadBenchmark.cpp
+//
+//  A command-line program to time how long each BMP texture
+//    used by the game takes to load and add to OpenGL.
+//
+//  This program is not part of the game project.  Build it from
+//    the main folder with, for example:
+//
+//    g++ -std=c++17 -O2 -I. Tools/TextureLoadBenchmark.cpp
+//        ObjLibrary/*.cpp -lglut -lGLU -lGL -pthread
+//        -o TextureLoadBenchmark
+//
+//  and run it from the main folder:
+//
+//    ./TextureLoadBenchmark [BMP file ...]
+//
+//  If no files are specified, every BMP file in the Models
+//    folder is timed.  A small window is opened because adding
+//    textures to OpenGL needs a context.  Each texture is
+//    loaded and added REPEAT_COUNT times and the fastest time
+//    for each step is printed:
+//
+//    Decode:  reading and converting the file
+//    Mipmaps: calculating the mipmaps on the CPU, which the
+//             game does on a loading thread
+//    Upload:  adding the texture to OpenGL with mipmaps
+//
+//  To compare with the original loader, comment out
+//    OBJ_LIBRARY_FAST_BMP in ObjLibrary/ObjSettings.h and
+//    rebuild.  The mipmaps are then made when the texture is
+//    uploaded, so the Mipmaps column is not shown.
+//
+
+#include <algorithm>
+#include <chrono>
+#include <filesystem>
+#include <iomanip>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "GetGlut.h"
+#include "ObjLibrary/TextureBmp.h"
+
+using namespace std;
+using namespace ObjLibrary;
+namespace
+{
+	const string MODEL_FOLDER_DEFAULT = "Models";
+	const unsigned int REPEAT_COUNT = 5;
+
+	//
+	//  Times
+	//
+	//  The fastest time seen for each step of loading one
+	//    texture, in milliseconds.
+	//
+	struct Times
+	{
+		double m_decode_ms;
+		double m_mipmap_ms;
+		double m_upload_ms;
+	};
+}
+
+
+
+//
+//  findTextures
+//
+//  Purpose: To find all the BMP files in the specified folder.
+//  Parameter(s):
+//    <1> folder: The folder to search
+//  Precondition(s): N/A
+//  Returns: The names of the BMP files in folder, in sorted
+//           order.  If folder does not exist, an empty vector
+//           is returned.
+//  Side Effect: N/A
+//
+vector<string> findTextures (const string& folder)
+{
+	vector<string> v_filenames;
+
+	error_code error;
+	for(filesystem::directory_iterator it(folder, error); !error && it != filesystem::directory_iterator(); it.increment(error))
+	{
+		if(it->path().extension() == ".bmp")
+			v_filenames.push_back(it->path().generic_string());
+	}
+
+	sort(v_filenames.begin(), v_filenames.end());
+	return v_filenames;
+}
+
+//
+//  getMilliseconds
+//
+//  Purpose: To determine the time between two points.
+//  Parameter(s):
+//    <1> start: The earlier point
+//    <2> end: The later point
+//  Precondition(s): N/A
+//  Returns: The time from start to end in milliseconds.
+//  Side Effect: N/A
+//
+double getMilliseconds (chrono::steady_clock::time_point start,
+                        chrono::steady_clock::time_point end)
+{
+	return chrono::duration<double, milli>(end - start).count();
+}
+
+//
+//  timeTexture
+//
+//  Purpose: To time loading the specified texture.
+//  Parameter(s):
+//    <1> filename: The name of the BMP file
+//    <2> r_times: The times to set
+//  Precondition(s):
+//    <1> filename != ""
+//    <2> An OpenGL context is current
+//  Returns: Whether the texture could be loaded.
+//  Side Effect: The texture is loaded and added to OpenGL
+//               REPEAT_COUNT times, and the fastest times are
+//               stored in r_times.  Any errors are printed to
+//               standard error.
+//
+bool timeTexture (const string& filename, Times& r_times)
+{
+	r_times.m_decode_ms = 1.0e30;
+	r_times.m_mipmap_ms = 1.0e30;
+	r_times.m_upload_ms = 1.0e30;
+
+	for(unsigned int i = 0; i < REPEAT_COUNT; i++)
+	{
+		stringstream log;
+		auto decode_start = chrono::steady_clock::now();
+		TextureBmp image(filename, log);
+		auto decode_end   = chrono::steady_clock::now();
+		if(image.isBad())
+		{
+			cerr << log.str();
+			return false;
+		}
+
+		auto mipmap_start = chrono::steady_clock::now();
+#ifdef OBJ_LIBRARY_FAST_BMP
+		if(image.isMipmapsPossible())
+			image.generateMipmaps();
+#endif
+		auto mipmap_end   = chrono::steady_clock::now();
+
+		// glFinish so the driver cannot defer the copy
+		auto upload_start = chrono::steady_clock::now();
+		unsigned int name = image.addToOpenGL(GL_REPEAT, GL_REPEAT, GL_LINEAR, GL_LINEAR_MIPMAP_LINEAR);
+		glFinish();
+		auto upload_end   = chrono::steady_clock::now();
+		glDeleteTextures(1, &name);
+
+		r_times.m_decode_ms = min(r_times.m_decode_ms, getMilliseconds(decode_start, decode_end));
+		r_times.m_mipmap_ms = min(r_times.m_mipmap_ms, getMilliseconds(mipmap_start, mipmap_end));
+		r_times.m_upload_ms = min(r_times.m_upload_ms, getMilliseconds(upload_start, upload_end));
+	}
+	return true;
+}
+
+int main (int argc, char* argv[])
+{
+	glutInit(&argc, argv);
+	glutInitDisplayMode(GLUT_RGB);
+	glutInitWindowSize(64, 64);
+	glutCreateWindow("Texture Load Benchmark");
+
+	vector<string> v_filenames;
+	for(int i = 1; i < argc; i++)
+		v_filenames.push_back(argv[i]);
+	if(v_filenames.empty())
+		v_filenames = findTextures(MODEL_FOLDER_DEFAULT);
+	if(v_filenames.empty())
+	{
+		cerr << "Usage: " << argv[0] << " [BMP file ...]" << endl;
+		return 1;
+	}
+
+	cout << fixed << setprecision(3);
+	cout << setw(32) << left << "Texture" << right
+	     << setw(12) << "Decode (ms)";
+#ifdef OBJ_LIBRARY_FAST_BMP
+	cout << setw(14) << "Mipmaps (ms)";
+#endif
+	cout << setw(14) << "Upload (ms)"
+	     << setw(12) << "Total (ms)" << endl;
+
+	Times total = { 0.0, 0.0, 0.0 };
+	unsigned int failed_count = 0;
+	for(unsigned int i = 0; i < v_filenames.size(); i++)
+	{
+		Times times;
+		if(!timeTexture(v_filenames[i], times))
+		{
+			failed_count++;
+			continue;
+		}
+
+		cout << setw(32) << left << v_filenames[i] << right
+		     << setw(12) << times.m_decode_ms;
+#ifdef OBJ_LIBRARY_FAST_BMP
+		cout << setw(14) << times.m_mipmap_ms;
+#endif
+		cout << setw(14) << times.m_upload_ms
+		     << setw(12) << (times.m_decode_ms + times.m_mipmap_ms + times.m_upload_ms) << endl;
+
+		total.m_decode_ms += times.m_decode_ms;
+		total.m_mipmap_ms += times.m_mipmap_ms;
+		total.m_upload_ms += times.m_upload_ms;
+	}
+
+	cout << setw(32) << left << "Total" << right
+	     << setw(12) << total.m_decode_ms;
+#ifdef OBJ_LIBRARY_FAST_BMP
+	cout << setw(14) << total.m_mipmap_ms;
+#endif
+	cout << setw(14) << total.m_upload_ms
+	     << setw(12) << (total.m_decode_ms + total.m_mipmap_ms + total.m_upload_ms) << endl;
+	return (failed_count == 0) ? 0 : 1;
+}
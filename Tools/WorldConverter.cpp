@@ -0,0 +1,251 @@
+//
+//  WorldConverter.cpp
+//
+//  A command-line program to convert the text world files used
+//    by the game into binary world files with the movement
+//    graph already built.
+//
+//  This program is not part of the game project.  Build it from
+//    the main folder with, for example:
+//
+//    g++ -std=c++17 -O2 -I. Tools/WorldConverter.cpp
+//        WorldFile.cpp DiskGrid.cpp RandomStream.cpp
+//        ObjLibrary/Vector3.cpp ObjLibrary/MappedFile.cpp
+//        -o WorldConverter
+//
+//  and run it from the main folder:
+//
+//    ./WorldConverter [--seed N] [text world file ...]
+//
+//  If no files are specified, every text file in the Worlds
+//    folder is converted.  Each binary file is written beside
+//    its text file, named by WorldFile::getBinaryFilename, and
+//    the game loads it instead of the text file as long as it
+//    is not older.
+//
+//  By default, the disks are not given seeds, so the game
+//    chooses their heightmaps randomly as it does for a text
+//    file.  With --seed, each disk is given a seed derived
+//    from N, so the world looks the same every time it is
+//    loaded.
+//
+//  For each world, the time to load the text file and build
+//    the movement graph is compared to the time to load the
+//    binary file.  The binary file is read back and checked
+//    against the graph that was built.
+//
+
+#include <algorithm>
+#include <cassert>
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <filesystem>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <system_error>
+#include <vector>
+
+#include "WorldFile.h"
+
+using namespace std;
+namespace
+{
+	const string WORLD_FOLDER_DEFAULT = "Worlds";
+	const string TEXT_EXTENSION       = ".txt";
+	const string SEED_OPTION          = "--seed";
+}
+
+
+
+//
+//  findWorlds
+//
+//  Purpose: To find all the text world files in the specified
+//           folder.
+//  Parameter(s):
+//    <1> folder: The folder to search
+//  Precondition(s): N/A
+//  Returns: The names of the text files in folder, in sorted
+//           order.  If folder does not exist, an empty vector
+//           is returned.
+//  Side Effect: N/A
+//
+vector<string> findWorlds (const string& folder)
+{
+	vector<string> v_filenames;
+
+	error_code error;
+	for(filesystem::directory_iterator it(folder, error); !error && it != filesystem::directory_iterator(); it.increment(error))
+	{
+		if(it->path().extension() == TEXT_EXTENSION)
+			v_filenames.push_back(it->path().generic_string());
+	}
+
+	sort(v_filenames.begin(), v_filenames.end());
+	return v_filenames;
+}
+
+//
+//  isSameGraph
+//
+//  Purpose: To determine whether two WorldFiles have the same
+//           disks and movement graph.
+//  Parameter(s):
+//    <1> file1
+//    <2> file2: The WorldFiles to compare
+//  Precondition(s):
+//    <1> file1.isMovementGraph()
+//    <2> file2.isMovementGraph()
+//  Returns: Whether file1 and file2 have exactly the same disks,
+//           seeds, nodes, and links.
+//  Side Effect: N/A
+//
+bool isSameGraph (const WorldFile& file1, const WorldFile& file2)
+{
+	assert(file1.isMovementGraph());
+	assert(file2.isMovementGraph());
+
+	if(file1.getRadius()    != file2.getRadius()    ||
+	   file1.getDiskCount() != file2.getDiskCount() ||
+	   file1.isSeeded()     != file2.isSeeded()     ||
+	   file1.getNodeCount() != file2.getNodeCount())
+	{
+		return false;
+	}
+
+	for(unsigned int d = 0; d < file1.getDiskCount(); d++)
+	{
+		if(file1.getDiskPosition(d) != file2.getDiskPosition(d) ||
+		   file1.getDiskRadius(d)   != file2.getDiskRadius(d))
+			return false;
+		if(file1.isSeeded() && file1.getDiskSeed(d) != file2.getDiskSeed(d))
+			return false;
+	}
+
+	for(unsigned int n = 0; n < file1.getNodeCount(); n++)
+	{
+		if(file1.getNodePosition(n) != file2.getNodePosition(n) ||
+		   file1.getNodeDisk(n)     != file2.getNodeDisk(n)     ||
+		   file1.getLinkCount(n)    != file2.getLinkCount(n))
+			return false;
+		for(unsigned int l = 0; l < file1.getLinkCount(n); l++)
+			if(file1.getLinkTarget(n, l) != file2.getLinkTarget(n, l) ||
+			   file1.getLinkWeight(n, l) != file2.getLinkWeight(n, l))
+				return false;
+	}
+	return true;
+}
+
+//
+//  convertWorld
+//
+//  Purpose: To convert the specified world.
+//  Parameter(s):
+//    <1> filename: The name of the text world file
+//    <2> is_seeded: Whether to give the disks seeds
+//    <3> seed: The seed for the world
+//  Precondition(s):
+//    <1> filename != ""
+//  Returns: Whether the world was converted.
+//  Side Effect: The binary world file is written and a summary
+//               is printed to standard output.  Any errors are
+//               printed to standard error.
+//
+bool convertWorld (const string& filename, bool is_seeded, uint64_t seed)
+{
+	assert(filename != "");
+
+	WorldFile text;
+	auto text_start = chrono::steady_clock::now();
+	if(!text.loadText(filename))
+		return false;
+	text.buildMovementGraph();
+	auto text_end   = chrono::steady_clock::now();
+
+	if(is_seeded)
+		text.setSeeds(seed);
+
+	string binary_filename = WorldFile::getBinaryFilename(filename);
+	if(!text.save(binary_filename))
+	{
+		cerr << "Could not write \"" << binary_filename << "\"" << endl;
+		return false;
+	}
+
+	WorldFile binary;
+	auto binary_start = chrono::steady_clock::now();
+	bool is_loaded = binary.load(binary_filename);
+	auto binary_end   = chrono::steady_clock::now();
+	if(!is_loaded || !isSameGraph(text, binary))
+	{
+		cerr << "\"" << binary_filename << "\" does not match \"" << filename << "\"" << endl;
+		return false;
+	}
+
+	unsigned int link_count = 0;
+	for(unsigned int n = 0; n < text.getNodeCount(); n++)
+		link_count += text.getLinkCount(n);
+
+	error_code error;
+	uintmax_t text_bytes   = filesystem::file_size(filename,        error);
+	uintmax_t binary_bytes = filesystem::file_size(binary_filename, error);
+
+	cout << setw(24) << left << filename << right
+	     << setw(8)  << text.getDiskCount()
+	     << setw(8)  << text.getNodeCount()
+	     << setw(10) << link_count
+	     << setw(12) << text_bytes
+	     << setw(12) << binary_bytes
+	     << setw(12) << chrono::duration<double, milli>(text_end   - text_start).count()
+	     << setw(12) << chrono::duration<double, milli>(binary_end - binary_start).count() << endl;
+	return true;
+}
+
+
+
+int main (int argc, char* argv[])
+{
+	bool is_seeded = false;
+	uint64_t seed = 0;
+	vector<string> v_filenames;
+	for(int i = 1; i < argc; i++)
+	{
+		string argument = argv[i];
+		if(argument == SEED_OPTION && i + 1 < argc)
+		{
+			is_seeded = true;
+			seed = strtoull(argv[i + 1], NULL, 0);
+			i++;
+		}
+		else
+			v_filenames.push_back(argument);
+	}
+	if(v_filenames.empty())
+		v_filenames = findWorlds(WORLD_FOLDER_DEFAULT);
+	if(v_filenames.empty())
+	{
+		cerr << "Usage: " << argv[0] << " [--seed N] [text world file ...]" << endl;
+		return 1;
+	}
+
+	cout << fixed << setprecision(3);
+	cout << setw(24) << left << "World" << right
+	     << setw(8)  << "Disks"
+	     << setw(8)  << "Nodes"
+	     << setw(10) << "Links"
+	     << setw(12) << "Text bytes"
+	     << setw(12) << "A5W bytes"
+	     << setw(12) << "Text (ms)"
+	     << setw(12) << "A5W (ms)" << endl;
+
+	unsigned int failed_count = 0;
+	for(unsigned int i = 0; i < v_filenames.size(); i++)
+		if(!convertWorld(v_filenames[i], is_seeded, seed))
+			failed_count++;
+
+	cout << (v_filenames.size() - failed_count) << " of " << v_filenames.size()
+	     << " worlds converted" << endl;
+	return (failed_count == 0) ? 0 : 1;
+}
@@ -0,0 +1,427 @@
+//
+//  WorldGenerator.cpp
+//
+//  A command-line program to generate large worlds for testing
+//    how the game scales with the number of disks.
+//
+//  This program is not part of the game project.  Build it from
+//    the main folder with, for example:
+//
+//    g++ -std=c++17 -O2 -I. Tools/WorldGenerator.cpp
+//        DiskGrid.cpp WorldFile.cpp RandomStream.cpp
+//        ObjLibrary/Vector3.cpp ObjLibrary/MappedFile.cpp
+//        -o WorldGenerator
+//
+//  and run it from the main folder:
+//
+//    ./WorldGenerator disk_count [--seed N] [--spacing S]
+//                     [--output FILE] [--binary]
+//
+//  The world is written in the text DISK format to FILE, which
+//    is Worlds/GeneratedN.txt by default, where N is the disk
+//    count.  With --binary, a binary world file with the
+//    movement graph and a seed for each disk is also written
+//    beside it (see WorldFile), so that the world looks the
+//    same every time it is loaded.
+//
+//  The disks are placed by Poisson-disk sampling with varying
+//    radii.  Starting from one disk at the origin, each new
+//    disk is placed touching a random disk that is still
+//    "active", so the world is always connected.  A new disk is
+//    rejected if it would overlap another disk or come closer
+//    to it than the spacing; an active disk is retired after
+//    ATTEMPT_COUNT rejections in a row.  A spacing of 0 packs
+//    the disks tightly, with many disks touching each other;
+//    larger spacings give sparser, more tree-like worlds.  The
+//    radii are spread evenly on a logarithmic scale between
+//    Disk::RADIUS_MIN and Disk::RADIUS_MAX, so the smaller disk
+//    types are about as common as the larger ones.
+//
+//  The disks that could block a new disk next to an active
+//    disk are found once, with a DiskGrid search bounded by the
+//    cell size, and every attempt next to that disk is checked
+//    against only those.  The disk that blocked the last
+//    attempt is checked first, because it usually blocks the
+//    next one too.  The time taken grows linearly with the disk
+//    count.  The same seed and settings always give the same
+//    world.
+//
+
+#include <algorithm>
+#include <cassert>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <cstdlib>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <limits>
+#include <string>
+#include <vector>
+
+#include "ObjLibrary/Vector3.h"
+#include "Pi.h"
+#include "RandomStream.h"
+#include "DiskGrid.h"
+#include "Disk.h"
+#include "WorldFile.h"
+
+using namespace std;
+using namespace ObjLibrary;
+namespace
+{
+	//
+	//  ATTEMPT_COUNT
+	//
+	//  The number of times in a row placing a disk next to an
+	//    active disk can fail before that disk is retired.
+	//
+	const unsigned int ATTEMPT_COUNT = 30;
+
+	//
+	//  GAP_MIN
+	//  GAP_MAX
+	//
+	//  The range for the gap between a new disk and the disk it
+	//    is placed next to.  The largest gap must be less than
+	//    the distance at which the game counts disks as touching
+	//    (0.1), or the world could be disconnected.
+	//
+	const double GAP_MIN = 0.01;
+	const double GAP_MAX = 0.09;
+
+	const string SEED_OPTION    = "--seed";
+	const string SPACING_OPTION = "--spacing";
+	const string OUTPUT_OPTION  = "--output";
+	const string BINARY_OPTION  = "--binary";
+
+	struct GeneratedDisk
+	{
+		Vector3 m_position;
+		float m_radius;
+	};
+}
+
+
+
+//
+//  chooseRadius
+//
+//  Purpose: To choose a random disk radius.
+//  Parameter(s):
+//    <1> r_random: The RandomStream to choose with
+//  Precondition(s): N/A
+//  Returns: A radius in the range [Disk::RADIUS_MIN,
+//           Disk::RADIUS_MAX].  The logarithm of the radius is
+//           evenly distributed.
+//  Side Effect: r_random advances.
+//
+float chooseRadius (RandomStream& r_random)
+{
+	static const double LOG_MIN = log((double)(Disk::RADIUS_MIN));
+	static const double LOG_MAX = log((double)(Disk::RADIUS_MAX));
+
+	float radius = (float)(exp(r_random.random2(LOG_MIN, LOG_MAX)));
+	return min(max(radius, Disk::RADIUS_MIN), Disk::RADIUS_MAX);
+}
+
+//
+//  findBlockers
+//
+//  Purpose: To find the disks that could stop a new disk from
+//           being placed next to the specified disk.
+//  Parameter(s):
+//    <1> v_disks: The disks already placed
+//    <2> grid: The DiskGrid containing v_disks
+//    <3> parent: The disk the new disk is placed next to
+//    <4> spacing: The space to leave around other disks
+//    <5> rv_near: A vector to use for the nearby disks
+//    <6> rv_blockers: A vector to put the blocking disks in
+//  Precondition(s):
+//    <1> parent < v_disks.size()
+//    <2> spacing >= 0.0
+//    <3> grid.getCellSize() >= Disk::RADIUS_MAX * 2.0 + spacing
+//  Returns: N/A
+//  Side Effect: rv_near is overwritten.  rv_blockers is set
+//               to every disk except parent that a disk placed
+//               touching parent, with a gap of at most GAP_MAX,
+//               could come within spacing of.
+//
+void findBlockers (const vector<GeneratedDisk>& v_disks,
+                   const DiskGrid& grid,
+                   unsigned int parent,
+                   double spacing,
+                   vector<unsigned int>& rv_near,
+                   vector<GeneratedDisk>& rv_blockers)
+{
+	assert(parent < v_disks.size());
+	assert(spacing >= 0.0);
+	assert(grid.getCellSize() >= Disk::RADIUS_MAX * 2.0 + spacing);
+
+	// a new disk is centered within parent radius + RADIUS_MAX
+	//  + GAP_MAX of the parent and can only be blocked by disks
+	//  with edges within RADIUS_MAX + spacing of its center, so
+	//  the blocking disks' centers are no more than the cell
+	//  size (RADIUS_MAX * 2 + spacing) farther than that
+	const GeneratedDisk& parent_disk = v_disks[parent];
+	double reach = parent_disk.m_radius + Disk::RADIUS_MAX * 2.0 + GAP_MAX + spacing;
+
+	rv_near.clear();
+	grid.getNear(parent_disk.m_position,
+	             parent_disk.m_radius + Disk::RADIUS_MAX + GAP_MAX + grid.getCellSize(),
+	             rv_near);
+
+	rv_blockers.clear();
+	for(unsigned int i = 0; i < rv_near.size(); i++)
+	{
+		unsigned int other = rv_near[i];
+		if(other == parent)
+			continue;  // the new disk is always placed clear of it
+		const GeneratedDisk& other_disk = v_disks[other];
+		double blocking_distance = reach + other_disk.m_radius;
+		if(parent_disk.m_position.getDistanceXZSquared(other_disk.m_position) < blocking_distance * blocking_distance)
+			rv_blockers.push_back(other_disk);
+	}
+}
+
+//
+//  isPlaceFree
+//
+//  Purpose: To determine whether a disk can be placed at the
+//           specified position.
+//  Parameter(s):
+//    <1> rv_blockers: The disks that could block the new disk,
+//                     as found by findBlockers
+//    <2> position: The center for the new disk
+//    <3> radius: The radius for the new disk
+//    <4> spacing: The space to leave around other disks
+//  Precondition(s):
+//    <1> spacing >= 0.0
+//  Returns: Whether the new disk would not overlap any disk
+//           in rv_blockers and would be at least spacing away
+//           from every one.
+//  Side Effect: If the new disk is blocked, the disk blocking
+//               it is moved to the front of rv_blockers.
+//
+bool isPlaceFree (vector<GeneratedDisk>& rv_blockers,
+                  const Vector3& position,
+                  float radius,
+                  double spacing)
+{
+	assert(spacing >= 0.0);
+
+	for(unsigned int i = 0; i < rv_blockers.size(); i++)
+	{
+		double clearance = rv_blockers[i].m_radius + radius + spacing;
+		if(position.getDistanceXZSquared(rv_blockers[i].m_position) < clearance * clearance)
+		{
+			swap(rv_blockers[i], rv_blockers[0]);
+			return false;
+		}
+	}
+	return true;
+}
+
+//
+//  generateDisks
+//
+//  Purpose: To place the disks for a new world.
+//  Parameter(s):
+//    <1> disk_count: The number of disks
+//    <2> seed: The seed to place the disks with
+//    <3> spacing: The space to leave between disks that are
+//                 not placed next to each other
+//  Precondition(s):
+//    <1> disk_count > 0
+//    <2> spacing >= 0.0
+//  Returns: The disks placed.  There are fewer than disk_count
+//           only if every disk was retired first, which can
+//           only happen with very large spacings.
+//  Side Effect: N/A
+//
+vector<GeneratedDisk> generateDisks (unsigned int disk_count,
+                                     uint64_t seed,
+                                     double spacing)
+{
+	assert(disk_count > 0);
+	assert(spacing >= 0.0);
+
+	RandomStream random(seed);
+	DiskGrid grid(Disk::RADIUS_MAX * 2.0 + spacing);
+	vector<GeneratedDisk> v_disks;
+	vector<unsigned int> v_active;
+	vector<unsigned int> v_near;
+	vector<GeneratedDisk> v_blockers;
+	v_disks.reserve(disk_count);
+
+	v_disks.push_back({ Vector3::ZERO, chooseRadius(random) });
+	grid.insert(0, v_disks[0].m_position);
+	v_active.push_back(0);
+
+	while(v_disks.size() < disk_count && !v_active.empty())
+	{
+		unsigned int active_index = random.random1((unsigned int)(v_active.size()));
+		unsigned int parent = v_active[active_index];
+
+		findBlockers(v_disks, grid, parent, spacing, v_near, v_blockers);
+
+		bool is_placed = false;
+		for(unsigned int a = 0; a < ATTEMPT_COUNT && !is_placed; a++)
+		{
+			float  radius   = chooseRadius(random);
+			double radians  = random.random1(TWO_PI);
+			double distance = v_disks[parent].m_radius + radius + random.random2(GAP_MIN, GAP_MAX);
+			Vector3 position = v_disks[parent].m_position + Vector3(cos(radians), 0.0, sin(radians)) * distance;
+
+			if(isPlaceFree(v_blockers, position, radius, spacing))
+			{
+				grid.insert(v_disks.size(), position);
+				v_active.push_back(v_disks.size());
+				v_disks.push_back({ position, radius });
+				is_placed = true;
+			}
+		}
+
+		if(!is_placed)
+		{
+			v_active[active_index] = v_active.back();
+			v_active.pop_back();
+		}
+	}
+
+	return v_disks;
+}
+
+//
+//  writeWorld
+//
+//  Purpose: To write the specified disks as a text world file.
+//  Parameter(s):
+//    <1> filename: The name of the file to write
+//    <2> v_disks: The disks
+//  Precondition(s):
+//    <1> filename != ""
+//    <2> !v_disks.empty()
+//  Returns: Whether the file was written.
+//  Side Effect: File filename is created or replaced.  The
+//               coordinates are written with enough digits to
+//               be read back exactly.
+//
+bool writeWorld (const string& filename,
+                 const vector<GeneratedDisk>& v_disks)
+{
+	assert(filename != "");
+	assert(!v_disks.empty());
+
+	double world_radius = 0.0;
+	for(unsigned int i = 0; i < v_disks.size(); i++)
+		world_radius = max(world_radius, v_disks[i].m_position.getNormXZ() + v_disks[i].m_radius);
+
+	ofstream fout(filename.c_str());
+	fout << "DISK version 1" << endl;
+	fout << setprecision(numeric_limits<float>::max_digits10) << (float)(ceil(world_radius)) << "\n";
+	fout << v_disks.size() << "\n";
+	for(unsigned int i = 0; i < v_disks.size(); i++)
+	{
+		fout << setprecision(numeric_limits<double>::max_digits10)
+		     << v_disks[i].m_position.x << "\t" << v_disks[i].m_position.z << "\t"
+		     << setprecision(numeric_limits<float>::max_digits10) << v_disks[i].m_radius << "\n";
+	}
+	fout.close();
+
+	return !fout.fail();
+}
+
+
+
+int main (int argc, char* argv[])
+{
+	unsigned int disk_count = 0;
+	uint64_t seed = (uint64_t)(chrono::system_clock::now().time_since_epoch().count());
+	double spacing = 0.0;
+	string filename;
+	bool is_binary = false;
+	bool is_valid = true;
+	for(int i = 1; i < argc; i++)
+	{
+		string argument = argv[i];
+		if(argument == SEED_OPTION && i + 1 < argc)
+			seed = strtoull(argv[++i], NULL, 0);
+		else if(argument == SPACING_OPTION && i + 1 < argc)
+			spacing = atof(argv[++i]);
+		else if(argument == OUTPUT_OPTION && i + 1 < argc)
+			filename = argv[++i];
+		else if(argument == BINARY_OPTION)
+			is_binary = true;
+		else if(disk_count == 0 && atoi(argument.c_str()) > 0)
+			disk_count = atoi(argument.c_str());
+		else
+			is_valid = false;
+	}
+	if(!is_valid || disk_count == 0 || spacing < 0.0)
+	{
+		cerr << "Usage: " << argv[0] << " disk_count [--seed N] [--spacing S] [--output FILE] [--binary]" << endl;
+		return 1;
+	}
+	if(filename == "")
+		filename = "Worlds/Generated" + to_string(disk_count) + ".txt";
+
+	cout << "Generating " << disk_count << " disks with seed " << seed
+	     << " and spacing " << spacing << endl;
+
+	auto generate_start = chrono::steady_clock::now();
+	vector<GeneratedDisk> v_disks = generateDisks(disk_count, seed, spacing);
+	auto generate_end   = chrono::steady_clock::now();
+	if(v_disks.size() < disk_count)
+	{
+		cerr << "Could only place " << v_disks.size() << " disks: try a smaller spacing" << endl;
+		return 1;
+	}
+
+	if(!writeWorld(filename, v_disks))
+	{
+		cerr << "Could not write \"" << filename << "\"" << endl;
+		return 1;
+	}
+	auto write_end = chrono::steady_clock::now();
+
+	double disk_area = 0.0;
+	double extent    = 0.0;
+	for(unsigned int i = 0; i < v_disks.size(); i++)
+	{
+		disk_area += PI * v_disks[i].m_radius * v_disks[i].m_radius;
+		extent = max(extent, v_disks[i].m_position.getNormXZ() + v_disks[i].m_radius);
+	}
+
+	cout << fixed << setprecision(3);
+	cout << "Wrote \"" << filename << "\"" << endl;
+	cout << "  World radius:  " << extent << endl;
+	cout << "  Disk coverage: " << disk_area / (PI * extent * extent) * 100.0 << "%" << endl;
+	cout << "  Generate:      " << chrono::duration<double>(generate_end - generate_start).count() << " s" << endl;
+	cout << "  Write:         " << chrono::duration<double>(write_end    - generate_end).count()   << " s" << endl;
+
+	if(is_binary)
+	{
+		// read the text back so the binary file matches it exactly
+		WorldFile file;
+		if(!file.loadText(filename))
+			return 1;
+		auto graph_start = chrono::steady_clock::now();
+		file.buildMovementGraph();
+		auto graph_end   = chrono::steady_clock::now();
+		file.setSeeds(seed);
+
+		string binary_filename = WorldFile::getBinaryFilename(filename);
+		if(!file.save(binary_filename))
+		{
+			cerr << "Could not write \"" << binary_filename << "\"" << endl;
+			return 1;
+		}
+		cout << "Wrote \"" << binary_filename << "\"" << endl;
+		cout << "  Nodes:         " << file.getNodeCount() << endl;
+		cout << "  Build graph:   " << chrono::duration<double>(graph_end - graph_start).count() << " s" << endl;
+	}
+
+	return 0;
+}
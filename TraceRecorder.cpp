@@ -0,0 +1,383 @@
+//
+//  TraceRecorder.cpp
+//
+
+#include <cassert>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <mutex>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "TraceRecorder.h"
+
+using namespace std;
+using namespace TraceRecorder;
+namespace
+{
+	//
+	//  PHASE_*
+	//
+	//  The kinds of event, using the letters from the Chrome
+	//    trace format.
+	//
+	const char PHASE_BEGIN   = 'B';
+	const char PHASE_END     = 'E';
+	const char PHASE_INSTANT = 'i';
+
+	//
+	//  Event
+	//
+	//  An event in a ring buffer.  The fields are atomic only
+	//    so that a dump can read them while they are being
+	//    written; the events that might have been half-written
+	//    are thrown out afterwards.
+	//
+	struct Event
+	{
+		atomic<int64_t> m_time_ns;
+		atomic<const char*> mp_name;
+		atomic<char> m_phase;
+	};
+
+	//
+	//  ThreadBuffer
+	//
+	//  The ring buffer for one thread.  Only that thread writes
+	//    the events and m_write_count.  The other fields are
+	//    guarded by g_buffers_mutex.  When a thread ends, its
+	//    buffer is kept, so its events can still be dumped,
+	//    until another thread starts and reuses it.
+	//
+	struct ThreadBuffer
+	{
+		Event ma_events[EVENT_CAPACITY];
+		atomic<uint64_t> m_write_count;
+		unsigned int m_thread_id;
+		string m_thread_name;
+		bool m_is_in_use;
+	};
+
+	//
+	//  BufferHandle
+	//
+	//  The buffer used by this thread.  It is given back when
+	//    the thread ends.
+	//
+	struct BufferHandle
+	{
+		ThreadBuffer* mp_buffer = nullptr;
+
+		~BufferHandle ();
+	};
+
+	//
+	//  CopiedEvent
+	//
+	//  An event copied out of a ring buffer to be written.
+	//
+	struct CopiedEvent
+	{
+		int64_t m_time_ns;
+		const char* mp_name;
+		char m_phase;
+	};
+
+	const TimePoint START_TIME = Clock::now();
+
+	// guards the list of buffers and the file numbers
+	mutex g_buffers_mutex;
+	vector<unique_ptr<ThreadBuffer>> gv_buffers;
+	unsigned int g_next_thread_id = 1;
+	unsigned int g_next_file_number = 1;
+
+	mutex g_hitch_mutex;
+	bool g_is_hitch_dumped = false;
+	TimePoint g_last_hitch_dump_time;
+
+	thread_local BufferHandle g_buffer_handle;
+
+	BufferHandle :: ~BufferHandle ()
+	{
+		if(mp_buffer != nullptr)
+		{
+			lock_guard<mutex> lock(g_buffers_mutex);
+			mp_buffer->m_is_in_use = false;
+		}
+	}
+
+	//
+	//  getBuffer
+	//
+	//  Purpose: To retrieve the buffer for this thread.
+	//  Parameter(s): N/A
+	//  Precondition(s): N/A
+	//  Returns: The buffer for this thread.
+	//  Side Effect: If this thread does not have a buffer yet,
+	//               it is given one, either an unused one or a
+	//               new one.
+	//
+	ThreadBuffer& getBuffer ()
+	{
+		if(g_buffer_handle.mp_buffer != nullptr)
+			return *g_buffer_handle.mp_buffer;
+
+		lock_guard<mutex> lock(g_buffers_mutex);
+		ThreadBuffer* p_buffer = nullptr;
+		for(unsigned int i = 0; i < gv_buffers.size(); i++)
+			if(!gv_buffers[i]->m_is_in_use)
+			{
+				p_buffer = gv_buffers[i].get();
+				break;
+			}
+		if(p_buffer == nullptr)
+		{
+			// value-initialized, so the atomics start at 0
+			gv_buffers.push_back(unique_ptr<ThreadBuffer>(new ThreadBuffer()));
+			p_buffer = gv_buffers.back().get();
+		}
+
+		p_buffer->m_write_count = 0;
+		p_buffer->m_thread_id   = g_next_thread_id++;
+		p_buffer->m_thread_name = "Thread " + to_string(p_buffer->m_thread_id);
+		p_buffer->m_is_in_use   = true;
+		g_buffer_handle.mp_buffer = p_buffer;
+		return *p_buffer;
+	}
+
+	//
+	//  record
+	//
+	//  Purpose: To add an event to the buffer for this thread.
+	//  Parameter(s):
+	//    <1> name: The name of the event
+	//    <2> phase: The kind of event
+	//    <3> time: When the event happened
+	//  Precondition(s):
+	//    <1> name != nullptr
+	//  Returns: N/A
+	//  Side Effect: The event is added to the buffer for this
+	//               thread, replacing the oldest event if the
+	//               buffer is full.
+	//
+	void record (const char* name, char phase, TimePoint time)
+	{
+		assert(name != nullptr);
+
+		ThreadBuffer& r_buffer = getBuffer();
+		uint64_t index = r_buffer.m_write_count.load(memory_order_relaxed);
+		Event& r_event = r_buffer.ma_events[index % EVENT_CAPACITY];
+		r_event.m_time_ns.store(chrono::duration_cast<chrono::nanoseconds>(time - START_TIME).count(), memory_order_relaxed);
+		r_event.mp_name.store(name, memory_order_relaxed);
+		r_event.m_phase.store(phase, memory_order_relaxed);
+		r_buffer.m_write_count.store(index + 1, memory_order_release);
+	}
+
+	//
+	//  copyEvents
+	//
+	//  Purpose: To copy the events out of the specified buffer.
+	//  Parameter(s):
+	//    <1> buffer: The buffer
+	//  Precondition(s):
+	//    <1> g_buffers_mutex is locked
+	//  Returns: The events in buffer that were not overwritten
+	//           while they were being copied, oldest first.  An
+	//           end event with no begin event is left out.
+	//  Side Effect: N/A
+	//
+	vector<CopiedEvent> copyEvents (const ThreadBuffer& buffer)
+	{
+		uint64_t end = buffer.m_write_count.load(memory_order_acquire);
+		uint64_t start = (end > EVENT_CAPACITY) ? end - EVENT_CAPACITY : 0;
+
+		vector<CopiedEvent> v_copied;
+		v_copied.reserve((size_t)(end - start));
+		for(uint64_t i = start; i < end; i++)
+		{
+			const Event& event = buffer.ma_events[i % EVENT_CAPACITY];
+			CopiedEvent copied;
+			copied.m_time_ns = event.m_time_ns.load(memory_order_relaxed);
+			copied.mp_name   = event.mp_name  .load(memory_order_relaxed);
+			copied.m_phase   = event.m_phase  .load(memory_order_relaxed);
+			v_copied.push_back(copied);
+		}
+
+		// the thread may have written over the oldest events meanwhile
+		atomic_thread_fence(memory_order_acquire);
+		uint64_t after = buffer.m_write_count.load(memory_order_relaxed);
+		uint64_t valid_start = start;
+		if(after >= EVENT_CAPACITY && after - EVENT_CAPACITY + 1 > start)
+			valid_start = after - EVENT_CAPACITY + 1;
+		if(valid_start > end)
+			valid_start = end;
+		v_copied.erase(v_copied.begin(), v_copied.begin() + (size_t)(valid_start - start));
+
+		// blocks that began before the oldest event cannot be shown
+		vector<CopiedEvent> v_result;
+		v_result.reserve(v_copied.size());
+		unsigned int depth = 0;
+		for(unsigned int i = 0; i < v_copied.size(); i++)
+		{
+			if(v_copied[i].mp_name == nullptr)
+				continue;
+			if(v_copied[i].m_phase == PHASE_BEGIN)
+				depth++;
+			else if(v_copied[i].m_phase == PHASE_END)
+			{
+				if(depth == 0)
+					continue;
+				depth--;
+			}
+			v_result.push_back(v_copied[i]);
+		}
+		return v_result;
+	}
+
+	//
+	//  writeJsonString
+	//
+	//  Purpose: To write the specified string as a quoted JSON
+	//           string.
+	//  Parameter(s):
+	//    <1> r_out: The stream to write to
+	//    <2> str: The string
+	//  Precondition(s): N/A
+	//  Returns: N/A
+	//  Side Effect: str is written to r_out in quotes, with
+	//               quotes, backslashes, and control characters
+	//               escaped.
+	//
+	void writeJsonString (ostream& r_out, const string& str)
+	{
+		r_out << '"';
+		for(unsigned int i = 0; i < str.size(); i++)
+		{
+			char c = str[i];
+			if(c == '"' || c == '\\')
+				r_out << '\\' << c;
+			else if((unsigned char)(c) < 0x20)
+				r_out << ' ';
+			else
+				r_out << c;
+		}
+		r_out << '"';
+	}
+}
+
+
+
+void TraceRecorder :: setThreadName (const string& name)
+{
+	ThreadBuffer& r_buffer = getBuffer();
+
+	lock_guard<mutex> lock(g_buffers_mutex);
+	r_buffer.m_thread_name = name;
+}
+
+void TraceRecorder :: recordBegin (const char* name, TimePoint time)
+{
+	assert(name != nullptr);
+
+	record(name, PHASE_BEGIN, time);
+}
+
+void TraceRecorder :: recordEnd (const char* name, TimePoint time)
+{
+	assert(name != nullptr);
+
+	record(name, PHASE_END, time);
+}
+
+void TraceRecorder :: recordInstant (const char* name)
+{
+	assert(name != nullptr);
+
+	record(name, PHASE_INSTANT, Clock::now());
+}
+
+bool TraceRecorder :: dump (const string& reason)
+{
+	stringstream json;
+	json << fixed << setprecision(3);
+	json << "{\"otherData\":{\"reason\":";
+	writeJsonString(json, reason);
+	json << "},\n\"displayTimeUnit\":\"ms\",\n\"traceEvents\":[\n";
+
+	unsigned int file_number;
+	unsigned int event_count = 0;
+	{
+		lock_guard<mutex> lock(g_buffers_mutex);
+		file_number = g_next_file_number++;
+
+		bool is_first = true;
+		for(unsigned int b = 0; b < gv_buffers.size(); b++)
+		{
+			const ThreadBuffer& buffer = *gv_buffers[b];
+			if(buffer.m_write_count.load(memory_order_acquire) == 0)
+				continue;
+
+			if(!is_first)
+				json << ",\n";
+			is_first = false;
+			json << "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":" << buffer.m_thread_id
+			     << ",\"args\":{\"name\":";
+			writeJsonString(json, buffer.m_thread_name);
+			json << "}}";
+
+			vector<CopiedEvent> v_events = copyEvents(buffer);
+			for(unsigned int i = 0; i < v_events.size(); i++)
+			{
+				const CopiedEvent& event = v_events[i];
+				json << ",\n{\"name\":";
+				writeJsonString(json, event.mp_name);
+				json << ",\"ph\":\"" << event.m_phase << "\"";
+				if(event.m_phase == PHASE_INSTANT)
+					json << ",\"s\":\"t\"";
+				json << ",\"ts\":" << event.m_time_ns * 1.0e-3
+				     << ",\"pid\":1,\"tid\":" << buffer.m_thread_id << "}";
+			}
+			event_count += v_events.size();
+		}
+	}
+	json << "\n]}\n";
+
+	// the file is written after the lock, so other threads can record meanwhile
+	string filename = "Trace" + to_string(file_number) + ".json";
+	ofstream output(filename);
+	if(!output)
+	{
+		cerr << "Error: Could not write trace file \"" << filename << "\"" << endl;
+		return false;
+	}
+	output << json.str();
+	output.close();
+
+	cout << "Wrote " << event_count << " trace events to \"" << filename << "\" (" << reason << ")" << endl;
+	return true;
+}
+
+bool TraceRecorder :: dumpHitch (const string& reason)
+{
+	recordInstant("Hitch");
+
+	TimePoint now = Clock::now();
+	{
+		lock_guard<mutex> lock(g_hitch_mutex);
+		if(g_is_hitch_dumped &&
+		   chrono::duration<double>(now - g_last_hitch_dump_time).count() < HITCH_DUMP_INTERVAL_MIN)
+		{
+			return false;
+		}
+		g_is_hitch_dumped      = true;
+		g_last_hitch_dump_time = now;
+	}
+
+	return dump(reason);
+}
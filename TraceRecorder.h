@@ -0,0 +1,243 @@
+//
+//  TraceRecorder.h
+//
+//  A module to keep a record of recent events on each thread
+//    and write it out in Chrome trace format.
+//
+
+#ifndef TRACE_RECORDER_H
+#define TRACE_RECORDER_H
+
+#include <chrono>
+#include <string>
+
+
+
+//
+//  TRACE_ENABLED
+//
+//  Whether the tracing macros do anything.  If this is
+//    defined as 0 before this file is included, TRACE_SCOPE
+//    and TRACE_INSTANT expand to nothing.
+//
+#ifndef TRACE_ENABLED
+	#define TRACE_ENABLED 1
+#endif
+
+#define TRACE_JOIN_INNER(a, b) a##b
+#define TRACE_JOIN(a, b)       TRACE_JOIN_INNER(a, b)
+
+#if TRACE_ENABLED
+	#define TRACE_SCOPE(name)   TraceRecorder::Scope TRACE_JOIN(trace_scope_, __LINE__)(name)
+	#define TRACE_INSTANT(name) TraceRecorder::recordInstant(name)
+#else
+	#define TRACE_SCOPE(name)
+	#define TRACE_INSTANT(name) ((void)0)
+#endif
+
+
+
+//
+//  TraceRecorder
+//
+//  A namespace to record when blocks of code begin and end,
+//    like a flight recorder.  Each thread writes to its own
+//    ring buffer of the last EVENT_CAPACITY events, with no
+//    locking, so recording can be left on all the time.  When
+//    something goes wrong, such as a physics frame taking too
+//    long, the buffers are written to a JSON file that can be
+//    opened in chrome://tracing or Perfetto to see what every
+//    thread was doing beforehand.
+//
+//  Event names must be string literals or otherwise last for
+//    the rest of the program, since only the pointer is kept.
+//
+//  The sections timed with PROFILE_SCOPE are also recorded, so
+//    most of the game is traced without any TRACE_SCOPEs.
+//
+namespace TraceRecorder
+{
+	//
+	//  Clock
+	//  TimePoint
+	//
+	//  The types used for time.
+	//
+	typedef std::chrono::steady_clock Clock;
+	typedef Clock::time_point TimePoint;
+
+	//
+	//  EVENT_CAPACITY
+	//
+	//  The number of events kept for each thread.  Once a
+	//    thread's buffer is full, each new event replaces the
+	//    oldest.
+	//
+	const unsigned int EVENT_CAPACITY = 16384;
+
+	//
+	//  HITCH_DUMP_INTERVAL_MIN
+	//
+	//  The shortest time in seconds between files written by
+	//    dumpHitch.  Slow frames often come in groups, and
+	//    writing a file is slow itself.
+	//
+	const double HITCH_DUMP_INTERVAL_MIN = 5.0;
+
+	//
+	//  setThreadName
+	//
+	//  Purpose: To set the name shown for this thread in the
+	//           trace files.
+	//  Parameter(s):
+	//    <1> name: The name
+	//  Precondition(s): N/A
+	//  Returns: N/A
+	//  Side Effect: This thread is named name.  Threads that are
+	//               never named are shown as "Thread" followed
+	//               by a number.
+	//
+	void setThreadName (const std::string& name);
+
+	//
+	//  recordBegin
+	//
+	//  Purpose: To record that a block of code has started on
+	//           this thread.
+	//  Parameter(s):
+	//    <1> name: The name of the block
+	//    <2> time: When the block started
+	//  Precondition(s):
+	//    <1> name != nullptr
+	//    <2> name will not be deallocated
+	//  Returns: N/A
+	//  Side Effect: The event is added to the buffer for this
+	//               thread.
+	//
+	void recordBegin (const char* name, TimePoint time);
+
+	//
+	//  recordEnd
+	//
+	//  Purpose: To record that a block of code has ended on
+	//           this thread.
+	//  Parameter(s):
+	//    <1> name: The name of the block
+	//    <2> time: When the block ended
+	//  Precondition(s):
+	//    <1> name != nullptr
+	//    <2> name will not be deallocated
+	//  Returns: N/A
+	//  Side Effect: The event is added to the buffer for this
+	//               thread.
+	//
+	void recordEnd (const char* name, TimePoint time);
+
+	//
+	//  recordInstant
+	//
+	//  Purpose: To record that something happened on this
+	//           thread now.
+	//  Parameter(s):
+	//    <1> name: The name of the event
+	//  Precondition(s):
+	//    <1> name != nullptr
+	//    <2> name will not be deallocated
+	//  Returns: N/A
+	//  Side Effect: The event is added to the buffer for this
+	//               thread.
+	//
+	void recordInstant (const char* name);
+
+	//
+	//  dump
+	//
+	//  Purpose: To write the events recorded on every thread to
+	//           a new trace file.
+	//  Parameter(s):
+	//    <1> reason: Why the file is being written
+	//  Precondition(s): N/A
+	//  Returns: Whether the file was written.
+	//  Side Effect: The events are written to a file named
+	//               "Trace" followed by a number and ".json" in
+	//               the working directory, and its name is
+	//               printed to standard output.  If the file
+	//               cannot be written, an error message is
+	//               printed instead.  The buffers are not
+	//               cleared.
+	//
+	bool dump (const std::string& reason);
+
+	//
+	//  dumpHitch
+	//
+	//  Purpose: To write the events recorded on every thread to
+	//           a new trace file after a slow frame, unless one
+	//           was written recently.
+	//  Parameter(s):
+	//    <1> reason: Why the file is being written
+	//  Precondition(s): N/A
+	//  Returns: Whether the file was written.
+	//  Side Effect: An instant event named "Hitch" is recorded
+	//               on this thread.  If no file has been
+	//               written by this function in the last
+	//               HITCH_DUMP_INTERVAL_MIN seconds, the events
+	//               are written as for dump.
+	//
+	bool dumpHitch (const std::string& reason);
+
+
+
+	//
+	//  Scope
+	//
+	//  A class to record a block of code.  An event is recorded
+	//    when a Scope is created and another when it is
+	//    destroyed.  It is normally created with TRACE_SCOPE.
+	//
+	class Scope
+	{
+	public:
+		//
+		//  Constructor
+		//
+		//  Purpose: To record the start of a block.
+		//  Parameter(s):
+		//    <1> name: The name of the block
+		//  Precondition(s):
+		//    <1> name != nullptr
+		//    <2> name will not be deallocated
+		//  Returns: N/A
+		//  Side Effect: A new Scope is created.
+		//
+		Scope (const char* name)
+				: m_name(name)
+		{
+			recordBegin(m_name, Clock::now());
+		}
+
+		//
+		//  Destructor
+		//
+		//  Purpose: To record the end of the block.
+		//  Parameter(s): N/A
+		//  Precondition(s): N/A
+		//  Returns: N/A
+		//  Side Effect: The end of the block is recorded.
+		//
+		~Scope ()
+		{
+			recordEnd(m_name, Clock::now());
+		}
+
+		Scope (const Scope& original) = delete;
+		Scope& operator= (const Scope& original) = delete;
+
+	private:
+		const char* m_name;
+	};
+}
+
+
+
+#endif
@@ -2,32 +2,139 @@
 //  World.cpp
 //
 
+#include <algorithm>
+#include <atomic>
 #include <cassert>
+#include <cstddef>
+#include <cstdint>
 #include <cstdlib>
+#include <deque>
+#include <functional>
 #include <string>
 #include <iostream>
 #include <fstream>
+#include <unordered_map>
 #include <vector>
 
 #include "ObjLibrary/Vector3.h"
-#include "GetGlut.h"
 
+#include "ParallelFor.h"
 #include "DiskType.h"
+#include "HeightmapMesh.h"
 #include "Heightmap.h"
+#include "HeightmapCache.h"
+#include "RandomStream.h"
 #include "Disk.h"
+#include "DiskGrid.h"
 #include "Collision.h"
+#include "TraceRecorder.h"
+#include "Profiler.h"
+#include "WorldFile.h"
 #include "World.h"
 #include "Nodes.h"
 #include "MovementGraph.h"
+#include "DebugOverlay.h"
 
 using namespace std;
 using namespace ObjLibrary;
+namespace
+{
+	//
+	//  HEIGHTMAP_BATCH_SIZE
+	//
+	//  The number of heightmap meshes to build at once.  This
+	//    limits how much memory is used for meshes that have
+	//    not been sent to the graphics card yet.
+	//
+	const unsigned int HEIGHTMAP_BATCH_SIZE = 256;
+
+	//
+	//  HEIGHTMAP_UPLOAD_MAX
+	//
+	//  The most heightmaps to copy to the graphics card each
+	//    time the World is drawn.  Any others are drawn without
+	//    their heightmaps until a later frame, so switching to
+	//    a new world does not stall the display.
+	//
+	const unsigned int HEIGHTMAP_UPLOAD_MAX = 16;
+
+	//
+	//  DISK_GRID_CELL_SIZE
+	//
+	//  The cell size for the grid used to find nearby disks.
+	//    With this size, any two disks that touch are in the
+	//    same cell or neighbouring cells.
+	//
+	const double DISK_GRID_CELL_SIZE = Disk::RADIUS_MAX * 2.0;
+
+	//
+	//  tv_near_disks
+	//
+	//  A vector to collect disks from the disk grid in, kept so
+	//    that it does not have to be allocated for every search.
+	//    There is one for each thread, because const Worlds can
+	//    be searched from more than one thread.
+	//
+	thread_local vector<unsigned int> tv_near_disks;
+
+	//
+	//  NO_COMPONENT
+	//
+	//  The component label for a disk that has not been
+	//    labelled yet.
+	//
+	const unsigned int NO_COMPONENT = ~0u;
+
+	//
+	//  PROGRESS_FILE_READ
+	//  PROGRESS_DISKS_CREATED
+	//
+	//  The progress reported once the world file has been read
+	//    and once the disks have been created.  Reading a text
+	//    file includes building the movement graph, which is
+	//    most of the work.
+	//
+	const float PROGRESS_FILE_READ     = 0.5f;
+	const float PROGRESS_DISKS_CREATED = 0.9f;
+
+	//
+	//  PROGRESS_DISK_INTERVAL
+	//
+	//  The number of disks created between progress reports.
+	//
+	const unsigned int PROGRESS_DISK_INTERVAL = 1024;
+
+	//
+	//  reportProgress
+	//
+	//  Purpose: To report loading progress.
+	//  Parameter(s):
+	//    <1> p_progress: A pointer to the variable to report
+	//                    progress in, or nullptr
+	//    <2> fraction: The fraction of the work done
+	//  Precondition(s): N/A
+	//  Returns: N/A
+	//  Side Effect: If p_progress != nullptr, it is set to
+	//               fraction.
+	//
+	void reportProgress (atomic<float>* p_progress, float fraction)
+	{
+		if(p_progress != nullptr)
+			p_progress->store(fraction);
+	}
+}
 
 
 
 World :: World ()
 		: m_radius(0.0f)
 		, mv_disks()
+		, m_disk_grid(DISK_GRID_CELL_SIZE)
+		, mv_disk_components()
+		, m_component_sizes()
+		, m_next_component(0)
+		, m_terrain_triangles_drawn(0)
+		, m_terrain_triangles_full(0)
 {
 	assert(invariant());
 }
@@ -35,14 +142,56 @@ World :: World ()
 World :: World (const string& filename)
 		: m_radius(0.0f)
 		, mv_disks()
+		, m_disk_grid(DISK_GRID_CELL_SIZE)
+		, mv_disk_components()
+		, m_component_sizes()
+		, m_next_component(0)
+		, m_terrain_triangles_drawn(0)
+		, m_terrain_triangles_full(0)
 {
 	assert(filename != "");
 
-	init(filename);
+	if(!init(filename))
+		exit(1);
 
 	assert(invariant());
 }
 
+World :: World (const World& original)
+		: m_radius(original.m_radius)
+		, mv_disks(original.mv_disks)
+		, m_disk_grid(original.m_disk_grid)
+		, mv_disk_components(original.mv_disk_components)
+		, m_component_sizes(original.m_component_sizes)
+		, m_next_component(original.m_next_component)
+		, m_terrain_triangles_drawn(0)
+		, m_terrain_triangles_full(0)
+		, all_nodes(original.all_nodes)
+		, m_graph(original.m_graph)
+{
+	assert(invariant());
+}
+
+World& World :: operator= (const World& original)
+{
+	if(&original != this)
+	{
+		m_radius                  = original.m_radius;
+		mv_disks                  = original.mv_disks;
+		m_disk_grid               = original.m_disk_grid;
+		mv_disk_components        = original.mv_disk_components;
+		m_component_sizes         = original.m_component_sizes;
+		m_next_component          = original.m_next_component;
+		m_terrain_triangles_drawn = 0;
+		m_terrain_triangles_full  = 0;
+		all_nodes                 = original.all_nodes;
+		m_graph                   = original.m_graph;
+	}
+
+	assert(invariant());
+	return *this;
+}
+
 
 
 bool World :: isInitialized () const
@@ -95,21 +244,57 @@ float World :: getHeightOnDisk (const ObjLibrary::Vector3& position) const
 
 unsigned int World :: getClosestDiskIndex (const ObjLibrary::Vector3& position) const
 {
-	unsigned int best_disk     = 0;
-	double       best_distance = position.getDistanceXZ(mv_disks[0].getPosition()) - mv_disks[0].getRadius();
+	assert(isInitialized());
 
-	for(unsigned int i = 1; i < mv_disks.size(); i++)
+	PROFILE_COUNT(COUNTER_CLOSEST_DISK, 1);
+
+	//
+	//  Search a growing square of grid cells.  Any disk not
+	//    found has its center farther than search_distance away,
+	//    so its edge is at least search_distance - RADIUS_MAX
+	//    away.  Once a disk at least that close has been found,
+	//    none of the others can be closer.  Far outside the
+	//    world, the square would have more cells than there are
+	//    disks, so every disk is checked instead.
+	//
+
+	vector<unsigned int>& rv_near = tv_near_disks;
+	double search_distance = m_disk_grid.getCellSize();
+	while(true)  // loop returns below
 	{
-		double distance = position.getDistanceXZ(mv_disks[i].getPosition()) - mv_disks[i].getRadius();
-		if(distance < best_distance)
+		rv_near.clear();
+		double cells_across = search_distance * 2.0 / m_disk_grid.getCellSize() + 1.0;
+		if(cells_across * cells_across < mv_disks.size())
+			m_disk_grid.getNear(position, search_distance, rv_near);
+		else
 		{
-			best_disk     = i;
-			best_distance = distance;
+			rv_near.resize(mv_disks.size());
+			for(unsigned int i = 0; i < mv_disks.size(); i++)
+				rv_near[i] = i;
+		}
+
+		unsigned int best_disk     = mv_disks.size();
+		double       best_distance = 0.0;
+		for(unsigned int n = 0; n < rv_near.size(); n++)
+		{
+			unsigned int i = rv_near[n];
+			double distance = position.getDistanceXZ(mv_disks[i].getPosition()) - mv_disks[i].getRadius();
+			if(best_disk == mv_disks.size() || distance < best_distance ||
+			   (distance == best_distance && i < best_disk))
+			{
+				best_disk     = i;
+				best_distance = distance;
+			}
 		}
-	}
 
-	assert(best_disk < mv_disks.size());
-	return best_disk;
+		if(best_disk < mv_disks.size() &&
+		   (best_distance <= search_distance - Disk::RADIUS_MAX ||
+		    rv_near.size() == mv_disks.size()))
+		{
+			return best_disk;
+		}
+		search_distance *= 2.0;
+	}
 }
 
 const Disk& World :: getClosestDisk (const ObjLibrary::Vector3& position) const
@@ -117,261 +302,796 @@ const Disk& World :: getClosestDisk (const ObjLibrary::Vector3& position) const
 	return mv_disks[getClosestDiskIndex(position)];
 }
 
-void World :: draw () 
+unsigned int World :: getComponentCount () const
+{
+	return m_component_sizes.size();
+}
+
+unsigned int World :: getDiskComponent (unsigned int disk) const
 {
 	assert(isInitialized());
+	assert(disk < getDiskCount());
 
-	for(unsigned int i = 0; i < mv_disks.size(); i++)
-		mv_disks[i].draw();
-	
+	assert(disk < mv_disk_components.size());
+	return mv_disk_components[disk];
 }
 
+bool World :: isConnected (unsigned int disk1,
+                           unsigned int disk2) const
+{
+	assert(isInitialized());
+	assert(disk1 < getDiskCount());
+	assert(disk2 < getDiskCount());
 
+	return getDiskComponent(disk1) == getDiskComponent(disk2);
+}
 
-void World :: init (const string& filename)
+unsigned int World :: getTerrainTriangleCountDrawn () const
 {
-	assert(filename != "");
+	return m_terrain_triangles_drawn;
+}
 
-	mv_disks.clear();
-	loadDisks(filename);
-	
-	initMovementGraph();
-	
-	assert(invariant());
+unsigned int World :: getTerrainTriangleCountFull () const
+{
+	return m_terrain_triangles_full;
 }
 
+size_t World :: getMemoryBytes () const
+{
+	size_t bytes = sizeof(World);
+
+	bytes += mv_disks.capacity() * sizeof(Disk);
+	for(unsigned int i = 0; i < mv_disks.size(); i++)
+		bytes += mv_disks[i].disk_node_list.capacity() * sizeof(unsigned int);
+
+	// each cell is a hash table node holding a vector
+	bytes += m_disk_grid.getCellCount() * (sizeof(uint64_t) + sizeof(vector<unsigned int>) + 2 * sizeof(void*));
+	bytes += mv_disks.size() * sizeof(unsigned int);
+
+	bytes += mv_disk_components.capacity() * sizeof(unsigned int);
+	bytes += m_component_sizes.size() * (2 * sizeof(unsigned int) + 2 * sizeof(void*));
 
+	bytes += m_graph.capacity() * sizeof(MovementGraph);
+	for(unsigned int n = 0; n < m_graph.size(); n++)
+		bytes += m_graph[n].disk_links.capacity() * sizeof(Links);
 
-void World :: loadDisks (const string& filename)
+	bytes += all_nodes.capacity() * sizeof(Nodes);
+	for(unsigned int n = 0; n < all_nodes.size(); n++)
+	{
+		bytes += all_nodes[n].all_links.capacity() * sizeof(Links);
+		bytes += all_nodes[n].search_data_node.capacity() * sizeof(Search_data);
+	}
+
+	return bytes;
+}
+
+void World :: draw (Renderer& r_renderer, const LodView& view) const
 {
-	assert(filename != "");
-	assert(mv_disks.empty());
+	assert(isInitialized());
+
+	PROFILE_SCOPE(SECTION_TERRAIN);
 
-	ifstream fin(filename.c_str());
-	if(!fin)
+	HeightmapCache::releaseEvicted();
+
+	// prepare all the heightmaps together, so it can be done in parallel
+	vector<unsigned int> v_visible;
+	for(unsigned int i = 0; i < mv_disks.size(); i++)
+		if(mv_disks[i].isHeightmapVisible(view))
+			v_visible.push_back(i);
+
+	// upload the nearest heightmaps first
+	vector<unsigned int> v_nearest = v_visible;
+	const Vector3& camera = view.getCameraPosition();
+	sort(v_nearest.begin(), v_nearest.end(), [&] (unsigned int a, unsigned int b)
 	{
-		cerr << "Error in loadDisks: Could not open file \"" << filename << "\"" << endl;
-		exit(1);
+		return camera.getDistanceSquared(mv_disks[a].getPosition()) <
+		       camera.getDistanceSquared(mv_disks[b].getPosition());
+	});
+	loadHeightmaps(v_nearest, true);
+
+	m_terrain_triangles_drawn = 0;
+	m_terrain_triangles_full  = 0;
+	unsigned int next_visible = 0;
+	for(unsigned int i = 0; i < mv_disks.size(); i++)
+	{
+		bool is_visible = next_visible < v_visible.size() && v_visible[next_visible] == i;
+		if(is_visible)
+			next_visible++;
+
+		if(is_visible && mv_disks[i].isHeightmapFinalized())
+		{
+			unsigned int level;
+			{
+				PROFILE_SCOPE(SECTION_TERRAIN_LOD);
+				level = mv_disks[i].chooseHeightmapLevel(view);
+			}
+			mv_disks[i].draw(r_renderer, level);
+
+			m_terrain_triangles_drawn += mv_disks[i].getHeightmapTriangleCount(level);
+		}
+		else
+			mv_disks[i].drawWithoutHeightmap(r_renderer);
+
+		m_terrain_triangles_full += mv_disks[i].getHeightmapTriangleCount(0);
 	}
+}
+
+void World :: prefetchHeightmaps (const vector<Vector3>& v_positions,
+                                  float distance) const
+{
+	assert(isInitialized());
+	assert(distance >= 0.0f);
 
-	string firstline;
-	getline(fin, firstline);
-	if(firstline != "DISK version 1")
+	vector<unsigned int> v_near;
+	vector<unsigned int> v_disks;
+	for(unsigned int p = 0; p < v_positions.size(); p++)
 	{
-		cerr << "Error in loadDisks: Invalid first line \"" << firstline << "\"" << endl;
-		exit(1);
+		v_near.clear();
+		m_disk_grid.getNear(v_positions[p], distance + Disk::RADIUS_MAX, v_near);
+		for(unsigned int n = 0; n < v_near.size(); n++)
+		{
+			const Disk& disk = mv_disks[v_near[n]];
+			if(v_positions[p].getDistanceXZ(disk.getPosition()) - disk.getRadius() <= distance)
+				v_disks.push_back(v_near[n]);
+		}
 	}
 
-	fin >> m_radius;
-	if(m_radius <= 0.0)
+	// check each disk once, because checking locks the HeightmapCache
+	sort(v_disks.begin(), v_disks.end());
+	v_disks.erase(unique(v_disks.begin(), v_disks.end()), v_disks.end());
+	v_disks.erase(remove_if(v_disks.begin(), v_disks.end(), [&] (unsigned int d)
 	{
-		cerr << "Error in loadDisks: Non-positive world radius" << endl;
-		exit(1);
+		return mv_disks[d].isHeightmapResident();
+	}), v_disks.end());
+	loadHeightmaps(v_disks, false);
+}
+
+
+
+bool World :: init (const string& filename,
+                    atomic<float>* p_progress)
+{
+	assert(filename != "");
+
+	return initFromFile(filename, false, 0, p_progress);
+}
+
+bool World :: init (const string& filename,
+                    uint64_t seed,
+                    atomic<float>* p_progress)
+{
+	assert(filename != "");
+
+	return initFromFile(filename, true, seed, p_progress);
+}
+
+unsigned int World :: addDisk (const Vector3& position,
+                               float radius,
+                               uint64_t seed)
+{
+	assert(radius >= Disk::RADIUS_MIN);
+	assert(radius <= Disk::RADIUS_MAX);
+
+	unsigned int disk = mv_disks.size();
+	mv_disks.push_back(Disk(position, radius, seed));
+	m_disk_grid.insert(disk, position);
+	mv_disk_components.push_back(NO_COMPONENT);
+	m_radius = max(m_radius, (float)(position.getNormXZ() + radius));
+
+	vector<unsigned int> v_touching;
+	getTouchingDisks(disk, v_touching);
+
+	// join the largest component touched, so the fewest disks are relabelled
+	unsigned int component      = NO_COMPONENT;
+	unsigned int component_size = 0;
+	for(unsigned int t = 0; t < v_touching.size(); t++)
+	{
+		unsigned int other = v_touching[t];
+		const Vector3& other_position = mv_disks[other].getPosition();
+		float          other_radius   = mv_disks[other].getRadius();
+
+		Vector3 node_position       = WorldFile::calculateNodePosition(position, radius, other_position);
+		Vector3 other_node_position = WorldFile::calculateNodePosition(other_position, other_radius, position);
+		unsigned int node       = addNode(node_position, disk);
+		unsigned int other_node = addNode(other_node_position, other);
+		addLink(node, other_node, WorldFile::calculateLinkWeight(node_position, radius,
+		                                                         other_node_position, other_radius));
+
+		const vector<int>& v_nodes = mv_disks[disk].disk_node_list;
+		for(unsigned int k = 0; k + 1 < v_nodes.size(); k++)
+			addLink(node, v_nodes[k], WorldFile::calculateRingLinkWeight(position, radius,
+			                                                             node_position, m_graph[v_nodes[k]].Node_position));
+		const vector<int>& v_other_nodes = mv_disks[other].disk_node_list;
+		for(unsigned int k = 0; k + 1 < v_other_nodes.size(); k++)
+			addLink(other_node, v_other_nodes[k], WorldFile::calculateRingLinkWeight(other_position, other_radius,
+			                                                                         other_node_position, m_graph[v_other_nodes[k]].Node_position));
+
+		unsigned int other_component = mv_disk_components[other];
+		if(m_component_sizes[other_component] > component_size)
+		{
+			component      = other_component;
+			component_size = m_component_sizes[other_component];
+		}
 	}
 
-	int disk_count;
-	fin >> disk_count;
-	if(disk_count < 0)
+	if(component == NO_COMPONENT)
+		component = m_next_component++;
+	relabelComponent(disk, component);
+
+	assert(invariant());
+	return disk;
+}
+
+void World :: removeDisk (unsigned int disk)
+{
+	assert(isInitialized());
+	assert(disk < getDiskCount());
+
+	Vector3 position = mv_disks[disk].getPosition();
+	vector<unsigned int> v_touching;
+	getTouchingDisks(disk, v_touching);
+
+	// remove the nodes on the touching disks that link to this one
+	vector<int>& rv_nodes = mv_disks[disk].disk_node_list;
+	vector<unsigned int> v_removed(rv_nodes.begin(), rv_nodes.end());
+	rv_nodes.clear();
+	for(unsigned int t = 0; t < v_touching.size(); t++)
 	{
-		cerr << "Error in loadDisks: Negative disk count" << endl;
-		exit(1);
+		Disk& r_other = mv_disks[v_touching[t]];
+		Vector3 node_position = WorldFile::calculateNodePosition(r_other.getPosition(), r_other.getRadius(), position);
+		unsigned int node = findNode(v_touching[t], node_position);
+		assert(node < m_graph.size());
+
+		vector<int>& rv_other_nodes = r_other.disk_node_list;
+		rv_other_nodes.erase(find(rv_other_nodes.begin(), rv_other_nodes.end(), (int)(node)));
+		for(unsigned int k = 0; k < rv_other_nodes.size(); k++)
+			removeLinksTo(rv_other_nodes[k], node_position);
+		v_removed.push_back(node);
 	}
 
-	mv_disks.reserve(disk_count);
+	// highest first, so the node moved into each gap is never one being removed
+	sort(v_removed.begin(), v_removed.end(), greater<unsigned int>());
+	for(unsigned int r = 0; r < v_removed.size(); r++)
+		removeNode(v_removed[r]);
 
-	assert(disk_count >= 0);
-	for(unsigned int i = 0; i < (unsigned int)(disk_count); i++)
+	// move the last disk into the gap
+	setDiskComponent(disk, NO_COMPONENT);
+	m_disk_grid.remove(disk, position);
+	unsigned int last = mv_disks.size() - 1;
+	if(disk != last)
 	{
-		double x;
-		fin >> x;
+		Vector3 last_position = mv_disks[last].getPosition();
+		m_disk_grid.remove(last, last_position);
+		m_disk_grid.insert(disk, last_position);
+		mv_disks[disk]           = move(mv_disks[last]);
+		mv_disk_components[disk] = mv_disk_components[last];
+
+		const vector<int>& v_moved_nodes = mv_disks[disk].disk_node_list;
+		for(unsigned int k = 0; k < v_moved_nodes.size(); k++)
+			m_graph[v_moved_nodes[k]].disk_index = disk;
+		for(unsigned int t = 0; t < v_touching.size(); t++)
+			if(v_touching[t] == last)
+				v_touching[t] = disk;
+	}
+	mv_disks.pop_back();
+	mv_disk_components.pop_back();
 
-		double z;
-		fin >> z;
+	splitComponent(v_touching);
 
-		float radius;
-		fin >> radius;
-		if(radius <= 0.0)
-		{
-			cerr << "Error in loadDisks: Non-positive disk radius" << endl;
-			exit(1);
-		}
+	assert(invariant());
+}
 
-		mv_disks.push_back( { Vector3(x, 0.0, z), radius } );
+void World :: applyChanges (const WorldFile& file)
+{
+	TRACE_SCOPE("Apply world changes");
+
+	// match the disks in file to the ones already here
+	vector<bool> v_is_kept(mv_disks.size(), false);
+	vector<unsigned int> v_added;
+	vector<unsigned int> v_near;
+	for(unsigned int f = 0; f < file.getDiskCount(); f++)
+	{
+		const Vector3& position = file.getDiskPosition(f);
+		v_near.clear();
+		m_disk_grid.getNear(position, 0.0, v_near);
 
-		if(!fin)
+		unsigned int match = mv_disks.size();
+		for(unsigned int n = 0; n < v_near.size(); n++)
 		{
-			cerr << "Error in loadDisks: Not enough disks" << endl;
-			exit(1);
+			const Disk& disk = mv_disks[v_near[n]];
+			if(!v_is_kept[v_near[n]] &&
+			   disk.getPosition() == position &&
+			   disk.getRadius()   == file.getDiskRadius(f) &&
+			   (!file.isSeeded() || disk.getSeed() == file.getDiskSeed(f)))
+			{
+				match = v_near[n];
+				break;
+			}
 		}
+
+		if(match < mv_disks.size())
+			v_is_kept[match] = true;
+		else
+			v_added.push_back(f);
+	}
+
+	// removing a disk moves the last one into its place, so go backwards
+	for(unsigned int d = mv_disks.size(); d > 0; d--)
+		if(!v_is_kept[d - 1])
+			removeDisk(d - 1);
+
+	for(unsigned int a = 0; a < v_added.size(); a++)
+	{
+		unsigned int f = v_added[a];
+		uint64_t seed = file.isSeeded() ? file.getDiskSeed(f) : RandomStream::createSeed();
+		addDisk(file.getDiskPosition(f), file.getDiskRadius(f), seed);
 	}
+	m_radius = file.getRadius();
+
+	assert(invariant());
 }
 
-bool World :: invariant () const
+bool World :: reload (const string& filename)
 {
-	if(m_radius < 0.0f) return false;
+	assert(filename != "");
+
+	TRACE_SCOPE("Reload world");
+
+	// the movement graph is not needed, so do not build it for a text file
+	WorldFile file;
+	bool is_loaded = false;
+	if(WorldFile::isBinaryFileCurrent(filename))
+		is_loaded = file.load(WorldFile::getBinaryFilename(filename));
+	if(!is_loaded && !file.loadText(filename))
+		return false;
+	if(file.getDiskCount() == 0)
+	{
+		cerr << "Error in World::reload: File \"" << filename << "\" has no disks" << endl;
+		return false;
+	}
+
+	applyChanges(file);
+
+	assert(invariant());
 	return true;
 }
 
 
 
-void World::initMovementGraph()
+bool World :: loadWorldFile (const string& filename,
+                             WorldFile& r_file)
 {
-	
-	for (int i = 0; i < mv_disks.size() - 1; i++)
-	{
-		//mv_disks[i].disk_node_list.clear();
-		for (int j = i + 1; j < mv_disks.size(); j++)
-		{
-			if (isTouching(mv_disks[i], mv_disks[j]))
-			{
-				//cout << "\nTouching";
-				node_position_i = Nodes::calculateNodePosition(mv_disks[i], mv_disks[j]);
-				node_position_j = Nodes::calculateNodePosition(mv_disks[j], mv_disks[i]);
+	assert(filename != "");
 
-				node_i = addNode(node_position_i, mv_disks[i]);
-				node_j = addNode(node_position_j, mv_disks[j]);
+	if(WorldFile::isBinaryFileCurrent(filename))
+	{
+		TRACE_SCOPE("Read binary world");
+		string binary_filename = WorldFile::getBinaryFilename(filename);
+		if(r_file.load(binary_filename))
+			return true;
+		cerr << "Could not load \"" << binary_filename << "\": loading text file instead" << endl;
+	}
 
-				weight_ij = calculateweight(node_i, node_j);
-				//cout << "Weight: " << weight_ij;
+	TRACE_SCOPE("Read text world");
+	if(!r_file.loadText(filename))
+		return false;
+	r_file.buildMovementGraph();
+	return true;
+}
 
-				addLink(node_i, node_j, weight_ij);
+bool World :: initFromFile (const string& filename,
+                            bool is_seeded,
+                            uint64_t seed,
+                            atomic<float>* p_progress)
+{
+	assert(filename != "");
 
-				
-				for (int k = 0; k < mv_disks[i].disk_node_list.size(); k++)
-				{
+	TRACE_SCOPE("Load world");
+	reportProgress(p_progress, 0.0f);
 
-					//node_k = addNode(node_position_i, mv_disks[i]);
-					weight_ik = calculateweightring(node_i, mv_disks[i].disk_node_list[k]);//Adjust***************************************
-					addLink(node_i, mv_disks[i].disk_node_list[k], weight_ik);
-				}
+	mv_disks.clear();
+	m_disk_grid.clear();
+	mv_disk_components.clear();
+	m_component_sizes.clear();
+	m_next_component = 0;
+	m_graph.clear();
+	all_nodes.clear();
+
+	WorldFile file;
+	if(!loadWorldFile(filename, file))
+		return false;
+	if(is_seeded && !file.isSeeded())
+		file.setSeeds(seed);
+	reportProgress(p_progress, PROGRESS_FILE_READ);
+
+	m_radius = file.getRadius();
+	createDisks(file, p_progress, PROGRESS_FILE_READ, PROGRESS_DISKS_CREATED);
+	initMovementGraph(file);
+	initComponents();
+	reportProgress(p_progress, 1.0f);
 
-				for (int k = 0; k < mv_disks[j].disk_node_list.size(); k++)
-				{
+	assert(invariant());
+	return true;
+}
 
-					//node_k = addNode(node_position_i, mv_disks[i]);
-					weight_jk = calculateweightring(node_j, mv_disks[j].disk_node_list[k]); ///Adjust*****************************************
-					addLink(node_j, mv_disks[j].disk_node_list[k], weight_jk);
-				}
+void World :: createDisks (const WorldFile& file,
+                           atomic<float>* p_progress,
+                           float progress_start,
+                           float progress_end)
+{
+	assert(mv_disks.empty());
+	assert(progress_start <= progress_end);
 
+	TRACE_SCOPE("Create disks");
+	unsigned int disk_count = file.getDiskCount();
+	mv_disks.reserve(disk_count);
+	for(unsigned int d = 0; d < disk_count; d++)
+	{
+		uint64_t seed = file.isSeeded() ? file.getDiskSeed(d) : RandomStream::createSeed();
+		mv_disks.push_back(Disk(file.getDiskPosition(d), file.getDiskRadius(d), seed));
+		m_disk_grid.insert(d, file.getDiskPosition(d));
 
-				mv_disks[i].disk_node_list.push_back(node_i);
-				mv_disks[j].disk_node_list.push_back(node_j);
-				
-			}
-		}
+		if(d % PROGRESS_DISK_INTERVAL == 0)
+			reportProgress(p_progress, progress_start + (progress_end - progress_start) * d / disk_count);
 	}
+}
 
-	for (int i = 0; i < m_graph.size(); i++)
+void World :: loadHeightmaps (const vector<unsigned int>& v_disks,
+                              bool is_finalize) const
+{
+	vector<unsigned int> v_missing;
+	for(unsigned int i = 0; i < v_disks.size(); i++)
 	{
-
-		all_nodes.push_back(m_graph[i].Node_position);
-		
+		assert(v_disks[i] < mv_disks.size());
+		if(!mv_disks[v_disks[i]].isHeightmapResident())
+			v_missing.push_back(v_disks[i]);
 	}
 
-	for (int i = 0; i < m_graph.size(); i++)
+	// generate on the CPU without OpenGL
+	parallelFor(0, v_missing.size(), [&] (unsigned int m)
+	{
+		TRACE_SCOPE("Generate heightmap");
+		mv_disks[v_missing[m]].prefetchHeightmap();
+	});
+
+	if(!is_finalize)
+		return;
+
+	vector<unsigned int> v_unfinalized;
+	for(unsigned int i = 0; i < v_disks.size(); i++)
+		if(!mv_disks[v_disks[i]].isHeightmapFinalized())
+			v_unfinalized.push_back(v_disks[i]);
+	if(v_unfinalized.size() > HEIGHTMAP_UPLOAD_MAX)
+		v_unfinalized.resize(HEIGHTMAP_UPLOAD_MAX);
+
+	vector<vector<HeightmapMesh> > v_meshes;
+	for(unsigned int batch = 0; batch < v_unfinalized.size(); batch += HEIGHTMAP_BATCH_SIZE)
 	{
-		for (int j = 0; j < m_graph[i].disk_links.size(); j++)
+		unsigned int batch_end = batch + HEIGHTMAP_BATCH_SIZE;
+		if(batch_end > v_unfinalized.size())
+			batch_end = v_unfinalized.size();
+
+		// build meshes on the CPU without OpenGL
+		v_meshes.resize(batch_end - batch);
+		parallelFor(batch, batch_end, [&] (unsigned int u)
 		{
-			all_nodes[i].all_links.push_back({ m_graph[i].disk_links[j].other_node, m_graph[i].disk_links[j].weight });
-		}
+			TRACE_SCOPE("Build heightmap");
+			v_meshes[u - batch] = mv_disks[v_unfinalized[u]].buildHeightmapMeshes();
+		});
+
+		// OpenGL calls must all be made from this thread
+		TRACE_SCOPE("Upload heightmaps");
+		for(unsigned int u = batch; u < batch_end; u++)
+			mv_disks[v_unfinalized[u]].finalizeHeightmap(v_meshes[u - batch]);
 	}
+}
 
-	
+unsigned int World :: addNode (const Vector3& position,
+                               unsigned int disk)
+{
+	assert(disk < getDiskCount());
+
+	unsigned int node = m_graph.size();
+	m_graph.push_back(MovementGraph(position, disk));
+	all_nodes.push_back(Nodes(position));
+	mv_disks[disk].disk_node_list.push_back(node);
+	return node;
 }
 
-bool World::isTouching(Disk disk_a, Disk disk_b)
+void World :: addLink (unsigned int node1,
+                       unsigned int node2,
+                       double weight)
 {
+	assert(node1 < m_graph.size());
+	assert(node2 < m_graph.size());
 
-	Vector3 pos_a = disk_a.getPosition();
-	Vector3 pos_b = disk_b.getPosition();
-	double dist_ab = pos_a.getDistance(pos_b);
+	Links link1(m_graph[node2].Node_position, weight);
+	m_graph[node1].disk_links.push_back(link1);
+	all_nodes[node1].all_links.push_back(link1);
 
-	if (dist_ab < (disk_a.getRadius() + disk_b.getRadius() + 0.1))
-		return 1;
-	else
-		return 0;
+	Links link2(m_graph[node1].Node_position, weight);
+	m_graph[node2].disk_links.push_back(link2);
+	all_nodes[node2].all_links.push_back(link2);
 }
 
-int World::addNode(Vector3 node_pos, Disk nodeondisk)
+void World :: removeLinksTo (unsigned int node,
+                             const Vector3& target)
 {
-	
-	m_graph.push_back({ node_pos, nodeondisk });
+	assert(node < m_graph.size());
+
+	auto is_to_target = [&] (const Links& link) -> bool
+	{
+		return link.other_node == target;
+	};
 
-	
-	return  m_graph.size()-1;
+	vector<Links>& rv_links = m_graph[node].disk_links;
+	rv_links.erase(remove_if(rv_links.begin(), rv_links.end(), is_to_target), rv_links.end());
+	vector<Links>& rv_all_links = all_nodes[node].all_links;
+	rv_all_links.erase(remove_if(rv_all_links.begin(), rv_all_links.end(), is_to_target), rv_all_links.end());
 }
 
-double World::calculateweight(int i, int j)
+void World :: removeNode (unsigned int node)
 {
+	assert(node < m_graph.size());
 
-	double dist_nodes = m_graph[i].Node_position.getDistance(m_graph[j].Node_position);
-	double cost_i = 1.0 / DiskType::getRingSpeedFactor(m_graph[i].disk_id.getDiskType());
-	double cost_j = 1.0 / DiskType::getRingSpeedFactor(m_graph[j].disk_id.getDiskType());
+	unsigned int last = m_graph.size() - 1;
+	if(node != last)
+	{
+		m_graph  [node] = move(m_graph  [last]);
+		all_nodes[node] = move(all_nodes[last]);
 
-	double weight = dist_nodes * ((cost_i + cost_j )/ 2.0);
-	return weight;
+		vector<int>& rv_nodes = mv_disks[m_graph[node].disk_index].disk_node_list;
+		vector<int>::iterator found = find(rv_nodes.begin(), rv_nodes.end(), (int)(last));
+		assert(found != rv_nodes.end());
+		*found = node;
+	}
+	m_graph.pop_back();
+	all_nodes.pop_back();
 }
 
-double World::calculateweightring(int i, int j)
+unsigned int World :: findNode (unsigned int disk,
+                                const Vector3& position) const
 {
-	Vector3 center_to_node1 = m_graph[i].Node_position - m_graph[i].disk_id.getPosition();
+	assert(disk < getDiskCount());
 
-	Vector3 center_to_node2 = m_graph[j].Node_position - m_graph[j].disk_id.getPosition();
+	const vector<int>& v_nodes = mv_disks[disk].disk_node_list;
+	for(unsigned int k = 0; k < v_nodes.size(); k++)
+		if(m_graph[v_nodes[k]].Node_position == position)
+			return v_nodes[k];
+	return m_graph.size();
+}
 
-	double  arc_radians = center_to_node1.getAngle(center_to_node2);
+void World :: getTouchingDisks (unsigned int disk,
+                                vector<unsigned int>& rv_touching) const
+{
+	assert(disk < getDiskCount());
 
-	double arc_radius = m_graph[i].disk_id.getRadius() - 0.7;
+	const Vector3& position = mv_disks[disk].getPosition();
+	float          radius   = mv_disks[disk].getRadius();
 
-	double arc_length = arc_radius * arc_radians;
+	rv_touching.clear();
+	m_disk_grid.getNear(position, radius + Disk::RADIUS_MAX + WorldFile::TOUCHING_DISTANCE, rv_touching);
+	rv_touching.erase(remove_if(rv_touching.begin(), rv_touching.end(), [&] (unsigned int other) -> bool
+	{
+		return other == disk ||
+		       !WorldFile::isTouching(position, radius, mv_disks[other].getPosition(), mv_disks[other].getRadius());
+	}), rv_touching.end());
+	sort(rv_touching.begin(), rv_touching.end());
+}
 
-	return arc_length;
+void World :: initComponents ()
+{
+	TRACE_SCOPE("Label components");
+
+	mv_disk_components.assign(mv_disks.size(), NO_COMPONENT);
+	m_component_sizes.clear();
+	m_next_component = 0;
+	for(unsigned int d = 0; d < mv_disks.size(); d++)
+		if(mv_disk_components[d] == NO_COMPONENT)
+			relabelComponent(d, m_next_component++);
 }
 
-void World::addLink(int i, int j, double weight)
+void World :: setDiskComponent (unsigned int disk,
+                                unsigned int component)
 {
-	m_graph[i].disk_links.push_back({ m_graph[j].Node_position, weight });
+	assert(disk < getDiskCount());
+
+	unsigned int old_component = mv_disk_components[disk];
+	if(old_component != NO_COMPONENT)
+	{
+		assert(m_component_sizes[old_component] > 0);
+		if(--m_component_sizes[old_component] == 0)
+			m_component_sizes.erase(old_component);
+	}
 
-	m_graph[j].disk_links.push_back({ m_graph[i].Node_position, weight });
+	mv_disk_components[disk] = component;
+	if(component != NO_COMPONENT)
+		m_component_sizes[component]++;
 }
 
+void World :: relabelComponent (unsigned int disk,
+                                unsigned int component)
+{
+	assert(disk < getDiskCount());
 
-void World::Display_movementGraph() 
+	if(mv_disk_components[disk] != component)
+		setDiskComponent(disk, component);
+
+	vector<unsigned int> v_open(1, disk);
+	vector<unsigned int> v_touching;
+	while(!v_open.empty())
+	{
+		unsigned int current = v_open.back();
+		v_open.pop_back();
+
+		getTouchingDisks(current, v_touching);
+		for(unsigned int t = 0; t < v_touching.size(); t++)
+			if(mv_disk_components[v_touching[t]] != component)
+			{
+				setDiskComponent(v_touching[t], component);
+				v_open.push_back(v_touching[t]);
+			}
+	}
+}
+
+void World :: splitComponent (const vector<unsigned int>& v_touching)
 {
-	const float LINE_High = 1.0f;
-	for (int i = 0; i < m_graph.size(); i++)
+	unsigned int search_count = v_touching.size();
+	if(search_count < 2)
+		return;  // nothing to split
+
+	//
+	//  Each search records the disks it reaches.  When two
+	//    searches meet, one is merged into the other, and the
+	//    merged searches are found by following v_merged_into
+	//    like a union-find structure.  The searches run
+	//    breadth-first, one disk each in turn, so if the parts
+	//    are still connected nearby, they meet quickly.
+	//
+
+	vector<unsigned int> v_merged_into(search_count);
+	vector<deque<unsigned int> > v_open(search_count);
+	vector<bool> v_is_finished(search_count, false);
+	unordered_map<unsigned int, unsigned int> reached;
+	for(unsigned int s = 0; s < search_count; s++)
 	{
-				
-		
-		Vector3 source = all_nodes[i].pos_node;
-		
-		for (int j = 0; j < m_graph[i].disk_links.size(); j++)
-		
+		assert(v_touching[s] < getDiskCount());
+		assert(mv_disk_components[v_touching[s]] == mv_disk_components[v_touching[0]]);
+		v_merged_into[s] = s;
+		v_open[s].push_back(v_touching[s]);
+		reached[v_touching[s]] = s;
+	}
+
+	auto find_search = [&] (unsigned int search) -> unsigned int
+	{
+		while(v_merged_into[search] != search)
+			search = v_merged_into[search] = v_merged_into[v_merged_into[search]];
+		return search;
+	};
+
+	unsigned int running_count = search_count;
+	vector<unsigned int> v_near;
+	while(running_count > 1)
+	{
+		for(unsigned int s = 0; s < search_count && running_count > 1; s++)
 		{
-			
-			Vector3 destination = m_graph[i].disk_links[j].other_node;
+			unsigned int root = find_search(s);
+			if(v_is_finished[root] || v_open[s].empty())
+				continue;
+
+			unsigned int current = v_open[s].front();
+			v_open[s].pop_front();
+			getTouchingDisks(current, v_near);
+			for(unsigned int n = 0; n < v_near.size(); n++)
+			{
+				unordered_map<unsigned int, unsigned int>::iterator found = reached.find(v_near[n]);
+				if(found == reached.end())
+				{
+					reached[v_near[n]] = s;
+					v_open[s].push_back(v_near[n]);
+				}
+				else
+				{
+					unsigned int other_root = find_search(found->second);
+					if(other_root != root)
+					{
+						assert(!v_is_finished[other_root]);
+						v_merged_into[other_root] = root;
+						running_count--;
+					}
+				}
+			}
+		}
+
+		// a search with nothing left to check has found a whole part
+		for(unsigned int r = 0; r < search_count && running_count > 1; r++)
+		{
+			if(find_search(r) != r || v_is_finished[r])
+				continue;
+
+			bool is_open = false;
+			for(unsigned int s = 0; s < search_count && !is_open; s++)
+				if(find_search(s) == r && !v_open[s].empty())
+					is_open = true;
+			if(is_open)
+				continue;
+
+			unsigned int component = m_next_component++;
+			for(unordered_map<unsigned int, unsigned int>::iterator it = reached.begin(); it != reached.end(); ++it)
+				if(find_search(it->second) == r)
+					setDiskComponent(it->first, component);
+			v_is_finished[r] = true;
+			running_count--;
+		}
+	}
+}
+
+bool World :: invariant () const
+{
+	if(m_radius < 0.0f) return false;
+	if(mv_disk_components.size() != mv_disks.size()) return false;
+	return true;
+}
+
+
 
-			glLineWidth(3.0);
-			glColor3d(1.0, 1.0 - m_graph[i].disk_links[j].weight / 150.0, 0.0);
-			glBegin(GL_LINE_STRIP);
+void World :: initMovementGraph (const WorldFile& file)
+{
+	assert(file.isMovementGraph());
+	assert(getDiskCount() == file.getDiskCount());
+
+	unsigned int node_count = file.getNodeCount();
+	m_graph.clear();
+	m_graph.reserve(node_count);
+	for(unsigned int n = 0; n < node_count; n++)
+	{
+		unsigned int disk = file.getNodeDisk(n);
+		m_graph.push_back(MovementGraph(file.getNodePosition(n), disk));
+		mv_disks[disk].disk_node_list.push_back(n);
+	}
 
-				glVertex3d(source.x, source.y + LINE_High, source.z);
-				glVertex3d(destination.x, destination.y + LINE_High, destination.z);
-			glEnd();
-			glLineWidth(1.0);
+	all_nodes.clear();
+	all_nodes.reserve(node_count);
+	for(unsigned int n = 0; n < node_count; n++)
+	{
+		vector<Links>& rv_links = m_graph[n].disk_links;
+		rv_links.reserve(file.getLinkCount(n));
+		for(unsigned int l = 0; l < file.getLinkCount(n); l++)
+			rv_links.push_back(Links(file.getNodePosition(file.getLinkTarget(n, l)), file.getLinkWeight(n, l)));
+
+		all_nodes.push_back(Nodes(m_graph[n].Node_position));
+		all_nodes.back().all_links = rv_links;
+	}
+}
 
-			
 
+void World :: addMovementGraphLines (DebugOverlay& r_overlay) const
+{
+	const float LINE_High = 1.0f;
+	for (unsigned int i = 0; i < m_graph.size(); i++)
+	{
+		Vector3 source = all_nodes[i].pos_node;
+		for (unsigned int j = 0; j < m_graph[i].disk_links.size(); j++)
+		{
+			Vector3 destination = m_graph[i].disk_links[j].other_node;
 
+			// every link is stored at both of its nodes, so only add it once
+			if (destination.x <  source.x ||
+			   (destination.x == source.x && destination.z <  source.z) ||
+			   (destination.x == source.x && destination.z == source.z && destination.y <= source.y))
+				continue;
+
+			r_overlay.addLine(source      + Vector3(0.0, LINE_High, 0.0),
+			                  destination + Vector3(0.0, LINE_High, 0.0),
+			                  1.0f,
+			                  (float)(1.0 - m_graph[i].disk_links[j].weight / 150.0),
+			                  0.0f);
 		}
-		
 	}
-	
-	
-	
 }
 
 
-std::vector<Nodes> World::getNodes()
+const std::vector<Nodes>& World::getNodes() const
 {
 	return all_nodes;
 
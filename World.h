@@ -7,17 +7,26 @@
 #ifndef WORLD_H
 #define WORLD_H
 
+#include <atomic>
 #include <cassert>
+#include <cstddef>
+#include <cstdint>
 #include <string>
+#include <unordered_map>
 #include <vector>
 
 #include "ObjLibrary/Vector3.h"
 
+#include "LodView.h"
+#include "Renderer.h"
+#include "DebugOverlay.h"
 #include "Heightmap.h"
 #include "Disk.h"
+#include "DiskGrid.h"
 #include "Nodes.h"
 #include "MovementGraph.h"
 #include "Ring.h"
+#include "WorldFile.h"
 
 //#include "Main.h"
 
@@ -27,8 +36,35 @@
 //
 //  A class to manage all the disks in the world.
 //
+//  The disk heightmaps are generated as they are needed to
+//    draw (see Disk), so loading a World takes time
+//    proportional to the number of disks but does not depend on
+//    the heightmaps.  The heightmaps that will be drawn soon can
+//    be generated ahead of time, in parallel, with
+//    prefetchHeightmaps.
+//
+//  A World does not use OpenGL until it is drawn, so it can be
+//    loaded on a background thread and then shared.  Once it is
+//    initialized, a World is only read while the game is
+//    updated, and only drawn on the thread with the OpenGL
+//    context.  Every function used to update or draw the game
+//    is const, so a World can be shared as a const World by any
+//    number of Games.  To change a World that is shared, change
+//    a copy instead and switch to that.
+//
+//  Disks can be added and removed one at a time.  Only the
+//    movement graph nodes and links for the disks touching the
+//    one changed are updated, so this takes time proportional
+//    to the number of nearby disks, not the size of the World.
+//    The disks are also labelled with the connected component
+//    of the movement graph they are in.  Removing a disk may
+//    split its component, which is checked by searching
+//    outward from each disk it touched until the searches meet
+//    or all but one run out.
+//
 //  Class Invariant:
 //    <1> m_radius >= 0.0f
+//    <2> mv_disk_components.size() == mv_disks.size()
 //
 
 class World
@@ -56,13 +92,43 @@ public:
 	//    <1> filename != ""
 	//  Returns: N/A
 	//  Side Effect: A new World is initialized from file
-	//               filename.
+	//               filename.  If the file cannot be loaded, an
+	//               error message is printed and the program is
+	//               terminated.
 	//
 	World (const std::string& filename);
 
-	World (const World& original) = default;
+	//
+	//  Copy Constructor
+	//
+	//  Purpose: To create a new World as a copy of another.
+	//  Parameter(s):
+	//    <1> original: The World to copy
+	//  Precondition(s): N/A
+	//  Returns: N/A
+	//  Side Effect: A new World is created with the same disks
+	//               and movement graph as original.  The
+	//               terrain triangle counts are not copied,
+	//               because original may be being drawn on
+	//               another thread.
+	//
+	World (const World& original);
+
 	~World () = default;
-	World& operator= (const World& original) = default;
+
+	//
+	//  Assignment Operator
+	//
+	//  Purpose: To modify this World to be a copy of another.
+	//  Parameter(s):
+	//    <1> original: The World to copy
+	//  Precondition(s): N/A
+	//  Returns: A reference to this World.
+	//  Side Effect: This World is set to have the same disks
+	//               and movement graph as original.  The
+	//               terrain triangle counts are reset.
+	//
+	World& operator= (const World& original);
 
 	//
 	//  isInitialized
@@ -164,7 +230,9 @@ public:
 	//  Precondition(s):
 	//    <1> isInitialized()
 	//  Returns: The index of the disk closest to position
-	//           position.
+	//           position.  If more than one disk is equally
+	//           close, the one with the lowest index is
+	//           returned.
 	//  Side Effect: N/A
 	//
 	unsigned int getClosestDiskIndex (
@@ -185,17 +253,142 @@ public:
 	const Disk& getClosestDisk (
 	                 const ObjLibrary::Vector3& position) const;
 
+	//
+	//  getComponentCount
+	//
+	//  Purpose: To determine how many separate groups of
+	//           touching disks there are in this World.
+	//  Parameter(s): N/A
+	//  Precondition(s): N/A
+	//  Returns: The number of connected components in the
+	//           movement graph, counting each disk that touches
+	//           no other as its own component.
+	//  Side Effect: N/A
+	//
+	unsigned int getComponentCount () const;
+
+	//
+	//  getDiskComponent
+	//
+	//  Purpose: To determine which connected component of the
+	//           movement graph the specified disk is in.
+	//  Parameter(s):
+	//    <1> disk: Which disk
+	//  Precondition(s):
+	//    <1> isInitialized()
+	//    <2> disk < getDiskCount()
+	//  Returns: The label for the component containing disk
+	//           disk.  Two disks have the same label if and
+	//           only if a ring can move from one to the other.
+	//           The labels are not consecutive, and may change
+	//           when disks are added or removed.
+	//  Side Effect: N/A
+	//
+	unsigned int getDiskComponent (unsigned int disk) const;
+
+	//
+	//  isConnected
+	//
+	//  Purpose: To determine whether a ring can move between
+	//           the specified disks.
+	//  Parameter(s):
+	//    <1> disk1
+	//    <2> disk2: The disks
+	//  Precondition(s):
+	//    <1> isInitialized()
+	//    <2> disk1 < getDiskCount()
+	//    <3> disk2 < getDiskCount()
+	//  Returns: Whether disk1 and disk2 are in the same
+	//           connected component of the movement graph.
+	//  Side Effect: N/A
+	//
+	bool isConnected (unsigned int disk1,
+	                  unsigned int disk2) const;
+
+	//
+	//  getTerrainTriangleCountDrawn
+	//
+	//  Purpose: To determine the number of heightmap triangles
+	//           drawn the last time this World was displayed.
+	//  Parameter(s): N/A
+	//  Precondition(s): N/A
+	//  Returns: The number of heightmap triangles drawn.
+	//  Side Effect: N/A
+	//
+	unsigned int getTerrainTriangleCountDrawn () const;
+
+	//
+	//  getTerrainTriangleCountFull
+	//
+	//  Purpose: To determine the number of heightmap triangles
+	//           that would have been drawn the last time this
+	//           World was displayed if every heightmap had been
+	//           drawn at full detail.
+	//  Parameter(s): N/A
+	//  Precondition(s): N/A
+	//  Returns: The number of heightmap triangles at full
+	//           detail.
+	//  Side Effect: N/A
+	//
+	unsigned int getTerrainTriangleCountFull () const;
+
+	//
+	//  getMemoryBytes
+	//
+	//  Purpose: To estimate how much memory this World uses.
+	//  Parameter(s): N/A
+	//  Precondition(s): N/A
+	//  Returns: The approximate number of bytes used for the
+	//           disks, the disk grid, and the movement graph.
+	//           The heightmaps are not included, because they
+	//           are kept by the HeightmapCache.
+	//  Side Effect: N/A
+	//
+	size_t getMemoryBytes () const;
+
 	//
 	//  draw
 	//
 	//  Purpose: To display this World.
-	//  Parameter(s): N/A
+	//  Parameter(s):
+	//    <1> r_renderer: The Renderer to draw with
+	//    <2> view: The camera to draw for
 	//  Precondition(s):
 	//    <1> isInitialized()
 	//  Returns: N/A
-	//  Side Effect: The disks in this World are displayed.
+	//  Side Effect: The disks in this World are displayed.  The
+	//               level of detail for each heightmap is
+	//               chosen based on its size on the screen and
+	//               the terrain triangle counts are updated.
+	//               Disks too small on the screen are drawn
+	//               without their heightmaps.  The heightmaps
+	//               to be drawn are generated first if needed.
+	//               Only a few are finalized each time, nearest
+	//               the camera first, and the rest are drawn
+	//               without their heightmaps until they are.
+	//
+	void draw (Renderer& r_renderer, const LodView& view) const;
+
+	//
+	//  prefetchHeightmaps
 	//
-	void draw ();
+	//  Purpose: To generate the heightmaps for the disks near
+	//           the specified positions.
+	//  Parameter(s):
+	//    <1> v_positions: The positions
+	//    <2> distance: How far from the positions to look
+	//  Precondition(s):
+	//    <1> isInitialized()
+	//    <2> distance >= 0.0f
+	//  Returns: N/A
+	//  Side Effect: The heightmap is generated for every disk
+	//               within distance of any of v_positions that
+	//               does not have one already, in parallel.
+	//               The heightmaps are not finalized.
+	//
+	void prefetchHeightmaps (
+	       const std::vector<ObjLibrary::Vector3>& v_positions,
+	       float distance) const;
 
 	//
 	//  init
@@ -204,30 +397,433 @@ public:
 	//           data file.
 	//  Parameter(s):
 	//    <1> filename: The name of the world data file
+	//    <2> p_progress: A pointer to the variable to report
+	//                    progress in, or nullptr
 	//  Precondition(s):
 	//    <1> filename != ""
-	//  Returns: N/A
+	//  Returns: Whether the world was loaded.
 	//  Side Effect: The disks in file filename are loaded into
-	//               this World.
+	//               this World.  If there is a binary world
+	//               file for it that is up to date, that is
+	//               loaded instead, along with its movement
+	//               graph.  Otherwise, the text file is loaded
+	//               and the movement graph is built.  If
+	//               p_progress != nullptr, the fraction of the
+	//               work done, from 0.0f to 1.0f, is stored in
+	//               it as loading goes on, so it can be watched
+	//               from another thread.  If the file cannot be
+	//               loaded, an error message is printed and this
+	//               World is left uninitialized.
+	//
+	bool init (const std::string& filename,
+	           std::atomic<float>* p_progress = nullptr);
+
 	//
-	void init (const std::string& filename);
+	//  init
+	//
+	//  Purpose: To initialize this World based on the specified
+	//           data file, with disk heightmaps chosen from the
+	//           specified seed.
+	//  Parameter(s):
+	//    <1> filename: The name of the world data file
+	//    <2> seed: The seed for the disks
+	//    <3> p_progress: A pointer to the variable to report
+	//                    progress in, or nullptr
+	//  Precondition(s):
+	//    <1> filename != ""
+	//  Returns: Whether the world was loaded.
+	//  Side Effect: This World is initialized as by the other
+	//               init function, except that disks without
+	//               seeds in the file are given seeds derived
+	//               from seed, as by WorldFile::setSeeds,
+	//               instead of random ones.  Loading the same
+	//               file with the same seed therefore always
+	//               gives the same heightmaps.
+	//
+	bool init (const std::string& filename,
+	           uint64_t seed,
+	           std::atomic<float>* p_progress = nullptr);
+
+	//
+	//  addDisk
+	//
+	//  Purpose: To add a disk to this World.
+	//  Parameter(s):
+	//    <1> position: The center of the disk
+	//    <2> radius: The radius of the disk
+	//    <3> seed: The seed for the disk heightmap
+	//  Precondition(s):
+	//    <1> radius >= Disk::RADIUS_MIN
+	//    <2> radius <= Disk::RADIUS_MAX
+	//    <3> No disk in this World has its center at position
+	//  Returns: The index of the new disk.
+	//  Side Effect: A disk is added at the end of the disk list.
+	//               A node is added on it and on each disk it
+	//               touches, and the nodes are linked to each
+	//               other and to the other nodes on the same
+	//               disks.  The components it joins are merged.
+	//               The world radius is increased to include
+	//               the new disk if needed.
+	//
+	unsigned int addDisk (const ObjLibrary::Vector3& position,
+	                      float radius,
+	                      uint64_t seed);
+
+	//
+	//  removeDisk
+	//
+	//  Purpose: To remove the specified disk from this World.
+	//  Parameter(s):
+	//    <1> disk: Which disk
+	//  Precondition(s):
+	//    <1> isInitialized()
+	//    <2> disk < getDiskCount()
+	//  Returns: N/A
+	//  Side Effect: Disk disk is removed, along with its nodes,
+	//               the nodes on the disks it touched that
+	//               linked to it, and all their links.  The last
+	//               disk is moved to index disk to take its
+	//               place, and some nodes may be renumbered.  If
+	//               removing the disk splits its component, the
+	//               smaller parts are given new labels.  The
+	//               world radius is not changed.
+	//
+	void removeDisk (unsigned int disk);
+
+	//
+	//  applyChanges
+	//
+	//  Purpose: To change this World to match the specified
+	//           WorldFile by adding and removing disks.
+	//  Parameter(s):
+	//    <1> file: The WorldFile
+	//  Precondition(s): N/A
+	//  Returns: N/A
+	//  Side Effect: Every disk in this World with the same
+	//               position and radius as a disk in file, and
+	//               the same seed if file has seeds, is kept
+	//               along with its heightmap.  The other disks
+	//               are removed, and then the disks in file not
+	//               matched are added, using their seeds if file
+	//               has them and random seeds otherwise.  The
+	//               movement graph in file, if any, is not used.
+	//               The world radius is set to the one in file.
+	//               Disks may be renumbered.
+	//
+	void applyChanges (const WorldFile& file);
+
+	//
+	//  reload
+	//
+	//  Purpose: To update this World to match the specified
+	//           data file after it has changed.
+	//  Parameter(s):
+	//    <1> filename: The name of the world data file
+	//  Precondition(s):
+	//    <1> filename != ""
+	//  Returns: Whether the file was loaded.
+	//  Side Effect: The disks in file filename are loaded, from
+	//               the binary world file if it is up to date,
+	//               and applied to this World with applyChanges.
+	//               The movement graph is not built for the
+	//               file, only updated around the disks that
+	//               changed.  If the file cannot be loaded, an
+	//               error message is printed and this World is
+	//               not changed.
+	//
+	bool reload (const std::string& filename);
 
 	
 
 private:
 	//
-	//  Helper Function: loadDisks
+	//  Helper Function: loadWorldFile
+	//
+	//  Purpose: To load the specified data file.
+	//  Parameter(s):
+	//    <1> filename: The name of the world data file
+	//    <2> r_file: A reference to the WorldFile to load into
+	//  Precondition(s):
+	//    <1> filename != ""
+	//  Returns: Whether the file was loaded.
+	//  Side Effect: The disks and movement graph for file
+	//               filename are loaded into r_file, from the
+	//               binary world file if it is up to date.  If
+	//               the file cannot be loaded, an error message
+	//               is printed.
+	//
+	bool loadWorldFile (const std::string& filename,
+	                    WorldFile& r_file);
+
+	//
+	//  Helper Function: initFromFile
 	//
-	//  Purpose: To load the disks from the specified data file.
+	//  Purpose: To initialize this World based on the specified
+	//           data file.
 	//  Parameter(s):
 	//    <1> filename: The name of the world data file
+	//    <2> is_seeded: Whether to seed unseeded disks from
+	//                   seed
+	//    <3> seed: The seed for the disks
+	//    <4> p_progress: A pointer to the variable to report
+	//                    progress in, or nullptr
 	//  Precondition(s):
 	//    <1> filename != ""
-	//    <2> mv_disks.empty()
+	//  Returns: Whether the world was loaded.
+	//  Side Effect: See the init functions.
+	//
+	bool initFromFile (const std::string& filename,
+	                   bool is_seeded,
+	                   uint64_t seed,
+	                   std::atomic<float>* p_progress);
+
+	//
+	//  Helper Function: createDisks
+	//
+	//  Purpose: To create the disks in the specified WorldFile.
+	//  Parameter(s):
+	//    <1> file: The WorldFile
+	//    <2> p_progress: A pointer to the variable to report
+	//                    progress in, or nullptr
+	//    <3> progress_start
+	//    <4> progress_end: The progress values for the start
+	//                      and end of this step
+	//  Precondition(s):
+	//    <1> mv_disks.empty()
+	//    <2> progress_start <= progress_end
+	//  Returns: N/A
+	//  Side Effect: A Disk is created for each disk in file,
+	//               using its seed if it has one and a random
+	//               seed otherwise, and added to the disk grid.
+	//               The heightmaps are not generated.  If
+	//               p_progress != nullptr, it is moved from
+	//               progress_start to progress_end as the disks
+	//               are created.
+	//
+	void createDisks (const WorldFile& file,
+	                  std::atomic<float>* p_progress,
+	                  float progress_start,
+	                  float progress_end);
+
+	//
+	//  Helper Function: initMovementGraph
+	//
+	//  Purpose: To set up the movement graph from the specified
+	//           WorldFile.
+	//  Parameter(s):
+	//    <1> file: The WorldFile
+	//  Precondition(s):
+	//    <1> file.isMovementGraph()
+	//    <2> getDiskCount() == file.getDiskCount()
+	//  Returns: N/A
+	//  Side Effect: The movement graph and node list are
+	//               replaced with the ones in file, and each
+	//               disk is given the list of its nodes.
+	//
+	void initMovementGraph (const WorldFile& file);
+
+	//
+	//  Helper Function: addNode
+	//
+	//  Purpose: To add a node to the movement graph.
+	//  Parameter(s):
+	//    <1> position: The node position
+	//    <2> disk: The disk the node is on
+	//  Precondition(s):
+	//    <1> disk < getDiskCount()
+	//  Returns: The index of the new node.
+	//  Side Effect: A node with no links is added at the end of
+	//               the node list and to the node list of disk
+	//               disk.
+	//
+	unsigned int addNode (const ObjLibrary::Vector3& position,
+	                      unsigned int disk);
+
+	//
+	//  Helper Function: addLink
+	//
+	//  Purpose: To link two nodes in the movement graph.
+	//  Parameter(s):
+	//    <1> node1
+	//    <2> node2: The nodes
+	//    <3> weight: The link weight
+	//  Precondition(s):
+	//    <1> node1 < m_graph.size()
+	//    <2> node2 < m_graph.size()
+	//  Returns: N/A
+	//  Side Effect: A link with weight weight is added to both
+	//               nodes.
+	//
+	void addLink (unsigned int node1,
+	              unsigned int node2,
+	              double weight);
+
+	//
+	//  Helper Function: removeLinksTo
+	//
+	//  Purpose: To remove the links from a node to the node at
+	//           the specified position.
+	//  Parameter(s):
+	//    <1> node: The node to remove the links from
+	//    <2> target: The position of the other node
+	//  Precondition(s):
+	//    <1> node < m_graph.size()
+	//  Returns: N/A
+	//  Side Effect: Every link at node node to position target
+	//               is removed.  The links at the other node
+	//               are not changed.
+	//
+	void removeLinksTo (unsigned int node,
+	                    const ObjLibrary::Vector3& target);
+
+	//
+	//  Helper Function: removeNode
+	//
+	//  Purpose: To remove a node from the movement graph.
+	//  Parameter(s):
+	//    <1> node: The node
+	//  Precondition(s):
+	//    <1> node < m_graph.size()
+	//    <2> node is not in the node list of any disk
 	//  Returns: N/A
-	//  Side Effect: The disks in file filename are loaded.
+	//  Side Effect: Node node is removed, along with its links.
+	//               The last node is moved to index node and
+	//               renumbered in the node list of its disk.
+	//               Links at other nodes are not changed.
+	//
+	void removeNode (unsigned int node);
+
+	//
+	//  Helper Function: findNode
+	//
+	//  Purpose: To find the node on the specified disk at the
+	//           specified position.
+	//  Parameter(s):
+	//    <1> disk: Which disk
+	//    <2> position: The node position
+	//  Precondition(s):
+	//    <1> disk < getDiskCount()
+	//  Returns: The index of the node, or m_graph.size() if
+	//           there is no such node on disk disk.
+	//  Side Effect: N/A
 	//
-	void loadDisks (const std::string& filename);
+	unsigned int findNode (unsigned int disk,
+	                       const ObjLibrary::Vector3& position) const;
+
+	//
+	//  Helper Function: getTouchingDisks
+	//
+	//  Purpose: To find the disks touching the specified disk.
+	//  Parameter(s):
+	//    <1> disk: Which disk
+	//    <2> rv_touching: A reference to the vector to put the
+	//                     touching disks in
+	//  Precondition(s):
+	//    <1> disk < getDiskCount()
+	//  Returns: N/A
+	//  Side Effect: rv_touching is set to the indexes of the
+	//               disks touching disk disk, in increasing
+	//               order.
+	//
+	void getTouchingDisks (unsigned int disk,
+	                       std::vector<unsigned int>& rv_touching) const;
+
+	//
+	//  Helper Function: initComponents
+	//
+	//  Purpose: To label every disk with its connected
+	//           component.
+	//  Parameter(s): N/A
+	//  Precondition(s): N/A
+	//  Returns: N/A
+	//  Side Effect: The component labels and sizes are
+	//               replaced, with the components numbered from
+	//               0 in the order of their lowest disks.
+	//
+	void initComponents ();
+
+	//
+	//  Helper Function: setDiskComponent
+	//
+	//  Purpose: To change the component label of the specified
+	//           disk.
+	//  Parameter(s):
+	//    <1> disk: Which disk
+	//    <2> component: The new label
+	//  Precondition(s):
+	//    <1> disk < getDiskCount()
+	//  Returns: N/A
+	//  Side Effect: Disk disk is given label component, and the
+	//               component sizes are updated.
+	//
+	void setDiskComponent (unsigned int disk,
+	                       unsigned int component);
+
+	//
+	//  Helper Function: relabelComponent
+	//
+	//  Purpose: To give every disk connected to the specified
+	//           disk the specified component label.
+	//  Parameter(s):
+	//    <1> disk: Which disk to start at
+	//    <2> component: The new label
+	//  Precondition(s):
+	//    <1> disk < getDiskCount()
+	//  Returns: N/A
+	//  Side Effect: Each disk reachable from disk disk through
+	//               disks without label component is given that
+	//               label.  The component sizes are updated.
+	//
+	void relabelComponent (unsigned int disk,
+	                       unsigned int component);
+
+	//
+	//  Helper Function: splitComponent
+	//
+	//  Purpose: To relabel the parts of a component that may
+	//           have been disconnected by removing a disk.
+	//  Parameter(s):
+	//    <1> v_touching: The disks the removed disk touched
+	//  Precondition(s):
+	//    <1> v_touching[i] < getDiskCount()
+	//                             WHERE 0 <= i < v_touching.size()
+	//    <2> All of v_touching have the same label
+	//  Returns: N/A
+	//  Side Effect: A search is started from each disk in
+	//               v_touching, and the searches are run in turn
+	//               one disk at a time.  Searches that meet are
+	//               merged.  Each search that finishes while
+	//               another is still running has found a
+	//               separate part, which is given a new label.
+	//
+	void splitComponent (const std::vector<unsigned int>& v_touching);
+
+	//
+	//  Helper Function: loadHeightmaps
+	//
+	//  Purpose: To make sure the specified disks have
+	//           heightmaps.
+	//  Parameter(s):
+	//    <1> v_disks: The indexes of the disks
+	//    <2> is_finalize: Whether to finalize the heightmaps
+	//  Precondition(s):
+	//    <1> v_disks[i] < getDiskCount()
+	//                                WHERE 0 <= i < v_disks.size()
+	//    <2> If is_finalize == true, this function is called
+	//        from the thread with the OpenGL context.
+	//  Returns: N/A
+	//  Side Effect: The missing heightmaps for v_disks are
+	//               generated in parallel and added to the
+	//               HeightmapCache.  If is_finalize == true, the
+	//               heightmap meshes for the first few disks in
+	//               v_disks that are not finalized are then
+	//               built in parallel on the CPU and copied to
+	//               the graphics card.
+	//               If the HeightmapCache is too small to hold
+	//               them all, some may be evicted again.
+	//
+	void loadHeightmaps (const std::vector<unsigned int>& v_disks,
+	                     bool is_finalize) const;
 
 	//
 	//  Helper Function: invariant
@@ -243,26 +839,43 @@ private:
 private:
 	float m_radius;
 	std::vector<Disk> mv_disks;
-	
-	
-	double weight_ij, weight_ik, weight_jk;
-	
-	void initMovementGraph();
-	bool isTouching(Disk disk_a, Disk disk_b);
-	Vector3 node_position_i, node_position_j;
-	int node_i, node_j, node_k;
-	
+	DiskGrid m_disk_grid;
+	std::vector<unsigned int> mv_disk_components;
+	std::unordered_map<unsigned int, unsigned int> m_component_sizes;
+	unsigned int m_next_component;
 
-	int addNode(Vector3 node_pos, Disk nodeondisk);
-	void addLink(int i, int j, double weight);
-	double calculateweight(int i, int j);
-	double calculateweightring(int i, int j);
+	// statistics for the last display, only used by that thread
+	mutable unsigned int m_terrain_triangles_drawn;
+	mutable unsigned int m_terrain_triangles_full;
 public:
-	void Display_movementGraph();
+	//
+	//  addMovementGraphLines
+	//
+	//  Purpose: To add the links in the movement graph for
+	//           this World to the specified DebugOverlay.
+	//  Parameter(s):
+	//    <1> r_overlay: The DebugOverlay to add the lines to
+	//  Precondition(s): N/A
+	//  Returns: N/A
+	//  Side Effect: One line is added to r_overlay for each
+	//               link, colored from yellow for cheap links
+	//               to red for expensive ones.
+	//
+	void addMovementGraphLines(DebugOverlay& r_overlay) const;
 	std::vector<Nodes> all_nodes;
 	std::vector<MovementGraph> m_graph;
 
-	std::vector<Nodes> getNodes();
+	//
+	//  getNodes
+	//
+	//  Purpose: To retrieve the movement graph nodes for this
+	//           World.
+	//  Parameter(s): N/A
+	//  Precondition(s): N/A
+	//  Returns: The nodes, without copying them.
+	//  Side Effect: N/A
+	//
+	const std::vector<Nodes>& getNodes() const;
 
 	
 	//void updateRings();
@@ -0,0 +1,696 @@
+//
+//  WorldFile.cpp
+//
+
+#include <algorithm>
+#include <cassert>
+#include <cstdint>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <string>
+#include <system_error>
+#include <vector>
+
+#include "ObjLibrary/Vector3.h"
+#include "ObjLibrary/MappedFile.h"
+
+#include "DiskType.h"
+#include "DiskGrid.h"
+#include "RandomStream.h"
+#include "WorldFile.h"
+
+using namespace std;
+using namespace ObjLibrary;
+namespace
+{
+	//
+	//  The binary file layout is:
+	//
+	//    FileHeader
+	//    DiskRecord disks       [disk_count]
+	//    NodeRecord nodes       [node_count]
+	//    double     link_weights[link_count]
+	//    uint32_t   link_offsets[node_count + 1]
+	//    uint32_t   link_targets[link_count]
+	//
+	//  The links from node n are those from link_offsets[n] up
+	//    to link_offsets[n + 1].  The records with doubles come
+	//    first, so every field is aligned if the file is.  The
+	//    checksum covers everything after the header.
+	//
+
+	const char FILE_MAGIC[4] = { 'A', '5', 'W', '\0' };
+
+	// written as a number, so it reads differently in the other byte order
+	const uint32_t BYTE_ORDER_MARK = 0x01020304;
+
+	const uint32_t FLAG_SEEDED = 0x1;
+
+	struct FileHeader
+	{
+		char ma_magic[4];
+		uint32_t m_byte_order;
+		uint32_t m_version;
+		uint32_t m_flags;
+		uint32_t m_disk_count;
+		uint32_t m_node_count;
+		uint32_t m_link_count;
+		float m_radius;
+		uint64_t m_checksum;
+	};
+
+	struct DiskRecord
+	{
+		double m_x;
+		double m_z;
+		uint64_t m_seed;
+		float m_radius;
+		uint32_t m_padding;
+	};
+
+	struct NodeRecord
+	{
+		double m_x;
+		double m_y;
+		double m_z;
+		uint32_t m_disk;
+		uint32_t m_padding;
+	};
+
+	static_assert(sizeof(FileHeader) == 40, "FileHeader must not be padded");
+	static_assert(sizeof(DiskRecord) == 32, "DiskRecord must not be padded");
+	static_assert(sizeof(NodeRecord) == 32, "NodeRecord must not be padded");
+
+	//
+	//  calculateChecksum
+	//
+	//  Purpose: To calculate the checksum of the specified
+	//           bytes.
+	//  Parameter(s):
+	//    <1> a_data: The bytes
+	//    <2> size: The number of bytes
+	//  Precondition(s):
+	//    <1> a_data != NULL || size == 0
+	//  Returns: The 64-bit FNV-1a hash of the size bytes in
+	//           a_data.
+	//  Side Effect: N/A
+	//
+	uint64_t calculateChecksum (const char* a_data, size_t size)
+	{
+		assert(a_data != NULL || size == 0);
+
+		uint64_t hash = 0xcbf29ce484222325ull;
+		for(size_t i = 0; i < size; i++)
+		{
+			hash ^= (unsigned char)(a_data[i]);
+			hash *= 0x100000001b3ull;
+		}
+		return hash;
+	}
+
+	//
+	//  appendBytes
+	//
+	//  Purpose: To append the contents of a vector to a buffer.
+	//  Parameter(s):
+	//    <1> r_buffer: The buffer
+	//    <2> v_values: The vector
+	//  Precondition(s): N/A
+	//  Returns: N/A
+	//  Side Effect: The bytes of the elements of v_values are
+	//               appended to r_buffer.
+	//
+	template <typename T>
+	void appendBytes (vector<char>& r_buffer, const vector<T>& v_values)
+	{
+		const char* a_bytes = (const char*)(v_values.data());
+		r_buffer.insert(r_buffer.end(), a_bytes, a_bytes + v_values.size() * sizeof(T));
+	}
+
+	//
+	//  readBytes
+	//
+	//  Purpose: To copy the next elements of a vector out of a
+	//           buffer.
+	//  Parameter(s):
+	//    <1> rp_next: A reference to the next byte to read
+	//    <2> count: The number of elements
+	//    <3> rv_values: A reference to the vector to fill
+	//  Precondition(s):
+	//    <1> There are at least count * sizeof(T) bytes after
+	//        rp_next
+	//  Returns: N/A
+	//  Side Effect: rv_values is set to the count elements at
+	//               rp_next, and rp_next is advanced past them.
+	//
+	template <typename T>
+	void readBytes (const char*& rp_next, size_t count, vector<T>& rv_values)
+	{
+		rv_values.resize(count);
+		memcpy(rv_values.data(), rp_next, count * sizeof(T));
+		rp_next += count * sizeof(T);
+	}
+}
+
+
+
+const char* const WorldFile :: FILE_EXTENSION = ".a5w";
+
+string WorldFile :: getBinaryFilename (const string& text_filename)
+{
+	assert(text_filename != "");
+
+	size_t last_dot   = text_filename.find_last_of('.');
+	size_t last_slash = text_filename.find_last_of("/\\");
+	if(last_dot == string::npos || (last_slash != string::npos && last_dot < last_slash))
+		return text_filename + FILE_EXTENSION;
+	else
+		return text_filename.substr(0, last_dot) + FILE_EXTENSION;
+}
+
+bool WorldFile :: isBinaryFileCurrent (const string& text_filename)
+{
+	assert(text_filename != "");
+
+	// a binary file older than its text file is out of date
+	error_code error;
+	filesystem::file_time_type binary_time = filesystem::last_write_time(getBinaryFilename(text_filename), error);
+	if(error)
+		return false;
+
+	filesystem::file_time_type text_time = filesystem::last_write_time(text_filename, error);
+	return error || binary_time >= text_time;
+}
+
+bool WorldFile :: isTouching (const Vector3& position1,
+                              float radius1,
+                              const Vector3& position2,
+                              float radius2)
+{
+	return position1.getDistance(position2) < radius1 + radius2 + TOUCHING_DISTANCE;
+}
+
+Vector3 WorldFile :: calculateNodePosition (const Vector3& position,
+                                            float radius,
+                                            const Vector3& other_position)
+{
+	assert(position != other_position);
+
+	Vector3 direction = (other_position - position).getNormalized();
+	return position + direction * (radius - NODE_INSET);
+}
+
+double WorldFile :: calculateLinkWeight (const Vector3& node1,
+                                         float radius1,
+                                         const Vector3& node2,
+                                         float radius2)
+{
+	double cost1 = 1.0 / DiskType::getRingSpeedFactor(DiskType::getForRadius(radius1));
+	double cost2 = 1.0 / DiskType::getRingSpeedFactor(DiskType::getForRadius(radius2));
+	return node1.getDistance(node2) * ((cost1 + cost2) / 2.0);
+}
+
+double WorldFile :: calculateRingLinkWeight (const Vector3& position,
+                                             float radius,
+                                             const Vector3& node1,
+                                             const Vector3& node2)
+{
+	Vector3 center_to_node1 = node1 - position;
+	Vector3 center_to_node2 = node2 - position;
+	return (radius - NODE_INSET) * center_to_node1.getAngle(center_to_node2);
+}
+
+
+
+WorldFile :: WorldFile ()
+		: m_radius(0.0f)
+		, mv_disk_positions()
+		, mv_disk_radii()
+		, mv_disk_seeds()
+		, mv_node_positions()
+		, mv_node_disks()
+		, mv_link_offsets()
+		, mv_link_targets()
+		, mv_link_weights()
+{
+	assert(invariant());
+}
+
+
+
+float WorldFile :: getRadius () const
+{
+	return m_radius;
+}
+
+unsigned int WorldFile :: getDiskCount () const
+{
+	return mv_disk_positions.size();
+}
+
+const Vector3& WorldFile :: getDiskPosition (unsigned int disk) const
+{
+	assert(disk < getDiskCount());
+
+	return mv_disk_positions[disk];
+}
+
+float WorldFile :: getDiskRadius (unsigned int disk) const
+{
+	assert(disk < getDiskCount());
+
+	return mv_disk_radii[disk];
+}
+
+bool WorldFile :: isSeeded () const
+{
+	return !mv_disk_seeds.empty();
+}
+
+uint64_t WorldFile :: getDiskSeed (unsigned int disk) const
+{
+	assert(isSeeded());
+	assert(disk < getDiskCount());
+
+	return mv_disk_seeds[disk];
+}
+
+bool WorldFile :: isMovementGraph () const
+{
+	return !mv_link_offsets.empty();
+}
+
+unsigned int WorldFile :: getNodeCount () const
+{
+	assert(isMovementGraph());
+
+	return mv_node_positions.size();
+}
+
+const Vector3& WorldFile :: getNodePosition (unsigned int node) const
+{
+	assert(isMovementGraph());
+	assert(node < getNodeCount());
+
+	return mv_node_positions[node];
+}
+
+unsigned int WorldFile :: getNodeDisk (unsigned int node) const
+{
+	assert(isMovementGraph());
+	assert(node < getNodeCount());
+
+	return mv_node_disks[node];
+}
+
+unsigned int WorldFile :: getLinkCount (unsigned int node) const
+{
+	assert(isMovementGraph());
+	assert(node < getNodeCount());
+
+	return mv_link_offsets[node + 1] - mv_link_offsets[node];
+}
+
+unsigned int WorldFile :: getLinkTarget (unsigned int node,
+                                         unsigned int link) const
+{
+	assert(isMovementGraph());
+	assert(node < getNodeCount());
+	assert(link < getLinkCount(node));
+
+	return mv_link_targets[mv_link_offsets[node] + link];
+}
+
+double WorldFile :: getLinkWeight (unsigned int node,
+                                   unsigned int link) const
+{
+	assert(isMovementGraph());
+	assert(node < getNodeCount());
+	assert(link < getLinkCount(node));
+
+	return mv_link_weights[mv_link_offsets[node] + link];
+}
+
+
+
+void WorldFile :: makeEmpty ()
+{
+	m_radius = 0.0f;
+	mv_disk_positions.clear();
+	mv_disk_radii.clear();
+	mv_disk_seeds.clear();
+	mv_node_positions.clear();
+	mv_node_disks.clear();
+	mv_link_offsets.clear();
+	mv_link_targets.clear();
+	mv_link_weights.clear();
+
+	assert(invariant());
+}
+
+bool WorldFile :: loadText (const string& filename)
+{
+	assert(filename != "");
+
+	makeEmpty();
+
+	ifstream fin(filename.c_str());
+	if(!fin)
+	{
+		cerr << "Error in WorldFile::loadText: Could not open file \"" << filename << "\"" << endl;
+		return false;
+	}
+
+	string firstline;
+	getline(fin, firstline);
+	if(firstline != "DISK version 1")
+	{
+		cerr << "Error in WorldFile::loadText: Invalid first line \"" << firstline << "\"" << endl;
+		return false;
+	}
+
+	float radius;
+	fin >> radius;
+	if(!fin || radius <= 0.0)
+	{
+		cerr << "Error in WorldFile::loadText: Non-positive world radius" << endl;
+		return false;
+	}
+
+	int disk_count;
+	fin >> disk_count;
+	if(!fin || disk_count < 0)
+	{
+		cerr << "Error in WorldFile::loadText: Negative disk count" << endl;
+		return false;
+	}
+
+	mv_disk_positions.reserve(disk_count);
+	mv_disk_radii.reserve(disk_count);
+
+	assert(disk_count >= 0);
+	for(unsigned int i = 0; i < (unsigned int)(disk_count); i++)
+	{
+		double x;
+		double z;
+		float disk_radius;
+		fin >> x >> z >> disk_radius;
+		if(!fin)
+		{
+			cerr << "Error in WorldFile::loadText: Not enough disks" << endl;
+			makeEmpty();
+			return false;
+		}
+		if(disk_radius <= 0.0)
+		{
+			cerr << "Error in WorldFile::loadText: Non-positive disk radius" << endl;
+			makeEmpty();
+			return false;
+		}
+
+		mv_disk_positions.push_back(Vector3(x, 0.0, z));
+		mv_disk_radii.push_back(disk_radius);
+	}
+	m_radius = radius;
+
+	assert(invariant());
+	return true;
+}
+
+bool WorldFile :: load (const string& filename)
+{
+	assert(filename != "");
+
+	makeEmpty();
+
+	MappedFile file(filename);
+	if(!file.isOpen() || file.getSize() < sizeof(FileHeader))
+		return false;
+
+	const char* a_data = file.getData();
+	FileHeader header;
+	memcpy(&header, a_data, sizeof(header));
+	if(memcmp(header.ma_magic, FILE_MAGIC, sizeof(FILE_MAGIC)) != 0 ||
+	   header.m_byte_order != BYTE_ORDER_MARK ||
+	   header.m_version    != FILE_VERSION ||
+	   !(header.m_radius > 0.0f))
+	{
+		return false;
+	}
+
+	// use 64-bit sizes so that damaged counts cannot overflow
+	uint64_t disk_bytes   = (uint64_t)(header.m_disk_count) * sizeof(DiskRecord);
+	uint64_t node_bytes   = (uint64_t)(header.m_node_count) * sizeof(NodeRecord);
+	uint64_t weight_bytes = (uint64_t)(header.m_link_count) * sizeof(double);
+	uint64_t offset_bytes = ((uint64_t)(header.m_node_count) + 1) * sizeof(uint32_t);
+	uint64_t target_bytes = (uint64_t)(header.m_link_count) * sizeof(uint32_t);
+	uint64_t payload_size = disk_bytes + node_bytes + weight_bytes + offset_bytes + target_bytes;
+	if(sizeof(FileHeader) + payload_size != file.getSize())
+		return false;
+
+	const char* p_next = a_data + sizeof(FileHeader);
+	if(calculateChecksum(p_next, (size_t)(payload_size)) != header.m_checksum)
+		return false;
+
+	vector<DiskRecord> v_disk_records;
+	vector<NodeRecord> v_node_records;
+	vector<uint32_t> v_offsets;
+	vector<uint32_t> v_targets;
+	readBytes(p_next, header.m_disk_count, v_disk_records);
+	readBytes(p_next, header.m_node_count, v_node_records);
+	readBytes(p_next, header.m_link_count, mv_link_weights);
+	readBytes(p_next, header.m_node_count + 1, v_offsets);
+	readBytes(p_next, header.m_link_count, v_targets);
+	assert(p_next == a_data + file.getSize());
+
+	// the checksum only catches damage, so check the contents too
+	if(v_offsets.front() != 0 || v_offsets.back() != header.m_link_count)
+	{
+		makeEmpty();
+		return false;
+	}
+	for(unsigned int n = 0; n < header.m_node_count; n++)
+		if(v_offsets[n] > v_offsets[n + 1] || v_node_records[n].m_disk >= header.m_disk_count)
+		{
+			makeEmpty();
+			return false;
+		}
+	for(unsigned int l = 0; l < header.m_link_count; l++)
+		if(v_targets[l] >= header.m_node_count)
+		{
+			makeEmpty();
+			return false;
+		}
+	for(unsigned int d = 0; d < header.m_disk_count; d++)
+		if(!(v_disk_records[d].m_radius > 0.0f))
+		{
+			makeEmpty();
+			return false;
+		}
+
+	m_radius = header.m_radius;
+	mv_disk_positions.resize(header.m_disk_count);
+	mv_disk_radii.resize(header.m_disk_count);
+	if((header.m_flags & FLAG_SEEDED) != 0)
+		mv_disk_seeds.resize(header.m_disk_count);
+	for(unsigned int d = 0; d < header.m_disk_count; d++)
+	{
+		const DiskRecord& record = v_disk_records[d];
+		mv_disk_positions[d] = Vector3(record.m_x, 0.0, record.m_z);
+		mv_disk_radii[d]     = record.m_radius;
+		if(isSeeded())
+			mv_disk_seeds[d] = record.m_seed;
+	}
+
+	mv_node_positions.resize(header.m_node_count);
+	mv_node_disks.resize(header.m_node_count);
+	for(unsigned int n = 0; n < header.m_node_count; n++)
+	{
+		const NodeRecord& record = v_node_records[n];
+		mv_node_positions[n] = Vector3(record.m_x, record.m_y, record.m_z);
+		mv_node_disks[n]     = record.m_disk;
+	}
+
+	mv_link_offsets.assign(v_offsets.begin(), v_offsets.end());
+	mv_link_targets.assign(v_targets.begin(), v_targets.end());
+
+	assert(invariant());
+	return true;
+}
+
+bool WorldFile :: save (const string& filename) const
+{
+	assert(filename != "");
+	assert(isMovementGraph());
+
+	vector<DiskRecord> v_disk_records(getDiskCount());
+	for(unsigned int d = 0; d < getDiskCount(); d++)
+	{
+		DiskRecord& r_record = v_disk_records[d];
+		r_record.m_x       = mv_disk_positions[d].x;
+		r_record.m_z       = mv_disk_positions[d].z;
+		r_record.m_seed    = isSeeded() ? mv_disk_seeds[d] : 0;
+		r_record.m_radius  = mv_disk_radii[d];
+		r_record.m_padding = 0;
+	}
+
+	vector<NodeRecord> v_node_records(getNodeCount());
+	for(unsigned int n = 0; n < getNodeCount(); n++)
+	{
+		NodeRecord& r_record = v_node_records[n];
+		r_record.m_x       = mv_node_positions[n].x;
+		r_record.m_y       = mv_node_positions[n].y;
+		r_record.m_z       = mv_node_positions[n].z;
+		r_record.m_disk    = mv_node_disks[n];
+		r_record.m_padding = 0;
+	}
+
+	vector<uint32_t> v_offsets(mv_link_offsets.begin(), mv_link_offsets.end());
+	vector<uint32_t> v_targets(mv_link_targets.begin(), mv_link_targets.end());
+
+	vector<char> v_payload;
+	appendBytes(v_payload, v_disk_records);
+	appendBytes(v_payload, v_node_records);
+	appendBytes(v_payload, mv_link_weights);
+	appendBytes(v_payload, v_offsets);
+	appendBytes(v_payload, v_targets);
+
+	FileHeader header;
+	memcpy(header.ma_magic, FILE_MAGIC, sizeof(FILE_MAGIC));
+	header.m_byte_order = BYTE_ORDER_MARK;
+	header.m_version    = FILE_VERSION;
+	header.m_flags      = isSeeded() ? FLAG_SEEDED : 0;
+	header.m_disk_count = getDiskCount();
+	header.m_node_count = getNodeCount();
+	header.m_link_count = mv_link_targets.size();
+	header.m_radius     = m_radius;
+	header.m_checksum   = calculateChecksum(v_payload.data(), v_payload.size());
+
+	ofstream output(filename.c_str(), ios::out | ios::binary | ios::trunc);
+	output.write((const char*)(&header), sizeof(header));
+	output.write(v_payload.data(), v_payload.size());
+	output.close();
+
+	return !output.fail();
+}
+
+void WorldFile :: setSeeds (uint64_t seed)
+{
+	mv_disk_seeds.resize(getDiskCount());
+	for(unsigned int d = 0; d < getDiskCount(); d++)
+		mv_disk_seeds[d] = RandomStream::mixSeed(seed, d);
+
+	assert(invariant());
+}
+
+void WorldFile :: buildMovementGraph ()
+{
+	unsigned int disk_count = getDiskCount();
+
+	// links are collected per node first, in the order they are made
+	mv_node_positions.clear();
+	mv_node_disks.clear();
+	vector<vector<unsigned int> > vv_disk_nodes(disk_count);
+	vector<vector<unsigned int> > vv_node_targets;
+	vector<vector<double> >       vv_node_weights;
+
+	auto add_node = [&] (const Vector3& position, unsigned int disk) -> unsigned int
+	{
+		mv_node_positions.push_back(position);
+		mv_node_disks.push_back(disk);
+		vv_node_targets.push_back(vector<unsigned int>());
+		vv_node_weights.push_back(vector<double>());
+		return mv_node_positions.size() - 1;
+	};
+
+	auto add_link = [&] (unsigned int node1, unsigned int node2, double weight)
+	{
+		vv_node_targets[node1].push_back(node2);
+		vv_node_weights[node1].push_back(weight);
+		vv_node_targets[node2].push_back(node1);
+		vv_node_weights[node2].push_back(weight);
+	};
+
+	auto ring_weight = [&] (unsigned int node1, unsigned int node2) -> double
+	{
+		unsigned int disk = mv_node_disks[node1];
+		assert(mv_node_disks[node2] == disk);
+		return calculateRingLinkWeight(mv_disk_positions[disk], mv_disk_radii[disk],
+		                               mv_node_positions[node1], mv_node_positions[node2]);
+	};
+
+	// only disks in nearby cells can touch
+	float radius_max = 0.0f;
+	for(unsigned int d = 0; d < disk_count; d++)
+		radius_max = max(radius_max, mv_disk_radii[d]);
+	DiskGrid grid(radius_max * 2.0 + TOUCHING_DISTANCE);
+	for(unsigned int d = 0; d < disk_count; d++)
+		grid.insert(d, mv_disk_positions[d]);
+
+	vector<unsigned int> v_near;
+	for(unsigned int i = 0; i < disk_count; i++)
+	{
+		const Vector3& position_i = mv_disk_positions[i];
+		v_near.clear();
+		grid.getNear(position_i, mv_disk_radii[i] + radius_max + TOUCHING_DISTANCE, v_near);
+
+		// pairs are handled in order, so the nodes are numbered the same as checking every pair
+		sort(v_near.begin(), v_near.end());
+		for(unsigned int n = 0; n < v_near.size(); n++)
+		{
+			unsigned int j = v_near[n];
+			if(j <= i)
+				continue;
+
+			const Vector3& position_j = mv_disk_positions[j];
+			if(!isTouching(position_i, mv_disk_radii[i], position_j, mv_disk_radii[j]))
+				continue;
+
+			unsigned int node_i = add_node(calculateNodePosition(position_i, mv_disk_radii[i], position_j), i);
+			unsigned int node_j = add_node(calculateNodePosition(position_j, mv_disk_radii[j], position_i), j);
+			add_link(node_i, node_j, calculateLinkWeight(mv_node_positions[node_i], mv_disk_radii[i],
+			                                             mv_node_positions[node_j], mv_disk_radii[j]));
+
+			for(unsigned int k = 0; k < vv_disk_nodes[i].size(); k++)
+				add_link(node_i, vv_disk_nodes[i][k], ring_weight(node_i, vv_disk_nodes[i][k]));
+			for(unsigned int k = 0; k < vv_disk_nodes[j].size(); k++)
+				add_link(node_j, vv_disk_nodes[j][k], ring_weight(node_j, vv_disk_nodes[j][k]));
+
+			vv_disk_nodes[i].push_back(node_i);
+			vv_disk_nodes[j].push_back(node_j);
+		}
+	}
+
+	// pack the links into one array
+	unsigned int node_count = mv_node_positions.size();
+	mv_link_offsets.resize(node_count + 1);
+	mv_link_targets.clear();
+	mv_link_weights.clear();
+	mv_link_offsets[0] = 0;
+	for(unsigned int n = 0; n < node_count; n++)
+	{
+		mv_link_targets.insert(mv_link_targets.end(), vv_node_targets[n].begin(), vv_node_targets[n].end());
+		mv_link_weights.insert(mv_link_weights.end(), vv_node_weights[n].begin(), vv_node_weights[n].end());
+		mv_link_offsets[n + 1] = mv_link_targets.size();
+	}
+
+	assert(invariant());
+}
+
+
+
+bool WorldFile :: invariant () const
+{
+	if(m_radius < 0.0f) return false;
+	if(mv_disk_radii.size() != mv_disk_positions.size()) return false;
+	if(!mv_disk_seeds.empty() && mv_disk_seeds.size() != mv_disk_positions.size()) return false;
+	if(mv_node_disks.size() != mv_node_positions.size()) return false;
+	for(unsigned int n = 0; n < mv_node_disks.size(); n++)
+		if(mv_node_disks[n] >= mv_disk_positions.size())
+			return false;
+	if(!mv_link_offsets.empty() && mv_link_offsets.size() != mv_node_positions.size() + 1) return false;
+	if(mv_link_weights.size() != mv_link_targets.size()) return false;
+	return true;
+}
@@ -0,0 +1,533 @@
+//
+//  WorldFile.h
+//
+//  A module to represent the contents of a world data file,
+//    either the text format or a compact binary format with
+//    the movement graph already built.
+//
+//  This module does not use OpenGL, so it can be used by tools
+//    as well as the game.
+//
+
+#ifndef WORLD_FILE_H
+#define WORLD_FILE_H
+
+#include <cassert>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "ObjLibrary/Vector3.h"
+
+
+
+//
+//  WorldFile
+//
+//  A class to represent the disks in a world and the movement
+//    graph connecting them, without the heightmaps or anything
+//    else needed to display the disks.
+//
+//  The text format lists the world radius and the position
+//    and radius of each disk.  The movement graph must then be
+//    built with buildMovementGraph.  A DiskGrid is used to find
+//    the touching disks, so this takes time roughly
+//    proportional to the number of disks, but it is still much
+//    slower than loading a binary file.
+//
+//  The binary format stores the disks, an optional seed for
+//    each disk, and the movement graph with its link weights,
+//    so that nothing has to be parsed or calculated when it is
+//    loaded.  Binary files are normally created offline with
+//    the WorldConverter tool and saved beside the text file
+//    with the extension FILE_EXTENSION.  The contents are
+//    protected by a checksum, and a file that is damaged,
+//    from another version, or from a machine with the other
+//    byte order is rejected.
+//
+//  The movement graph has one node where each pair of touching
+//    disks meet, on each of the two disks.  The two nodes are
+//    linked to each other and to every other node on the same
+//    disk.  The links of each node are stored in the order
+//    they were created, with each link appearing at both of its
+//    nodes.
+//
+//  Class Invariant:
+//    <1> m_radius >= 0.0f
+//    <2> mv_disk_radii.size() == mv_disk_positions.size()
+//    <3> mv_disk_seeds.empty() ||
+//        mv_disk_seeds.size() == mv_disk_positions.size()
+//    <4> mv_node_disks.size() == mv_node_positions.size()
+//    <5> mv_node_disks[n] < getDiskCount()
+//                                WHERE 0 <= n < getNodeCount()
+//    <6> mv_link_offsets.empty() ||
+//        mv_link_offsets.size() == mv_node_positions.size() + 1
+//    <7> mv_link_weights.size() == mv_link_targets.size()
+//
+class WorldFile
+{
+public:
+	//
+	//  FILE_EXTENSION
+	//
+	//  The file extension used for binary world files.
+	//
+	static const char* const FILE_EXTENSION;
+
+	//
+	//  FILE_VERSION
+	//
+	//  The version of the binary file format.  This must be
+	//    increased whenever the format or the way the movement
+	//    graph is built changes.
+	//
+	static const unsigned int FILE_VERSION = 1;
+
+	//
+	//  NODE_INSET
+	//
+	//  How far inside the edge of a disk its movement graph
+	//    nodes are placed.
+	//
+	static constexpr double NODE_INSET = 0.7;
+
+	//
+	//  TOUCHING_DISTANCE
+	//
+	//  How far apart the edges of two disks can be for them to
+	//    still count as touching.
+	//
+	static constexpr double TOUCHING_DISTANCE = 0.1;
+
+	//
+	//  getBinaryFilename
+	//
+	//  Purpose: To determine the name of the binary file for
+	//           the specified text world file.
+	//  Parameter(s):
+	//    <1> text_filename: The name of the text file
+	//  Precondition(s):
+	//    <1> text_filename != ""
+	//  Returns: text_filename with its extension replaced by
+	//           FILE_EXTENSION.
+	//  Side Effect: N/A
+	//
+	static std::string getBinaryFilename (
+	                           const std::string& text_filename);
+
+	//
+	//  isBinaryFileCurrent
+	//
+	//  Purpose: To determine whether there is a binary file for
+	//           the specified text world file that is at least
+	//           as new as the text file.
+	//  Parameter(s):
+	//    <1> text_filename: The name of the text file
+	//  Precondition(s):
+	//    <1> text_filename != ""
+	//  Returns: Whether the binary file exists and is not older
+	//           than the text file.  If the text file does not
+	//           exist, only the binary file is checked.
+	//  Side Effect: N/A
+	//
+	static bool isBinaryFileCurrent (
+	                           const std::string& text_filename);
+
+	//
+	//  isTouching
+	//
+	//  Purpose: To determine whether two disks touch, and so
+	//           are linked in the movement graph.
+	//  Parameter(s):
+	//    <1> position1
+	//    <2> radius1: The center and radius of one disk
+	//    <3> position2
+	//    <4> radius2: The center and radius of the other disk
+	//  Precondition(s): N/A
+	//  Returns: Whether the edges of the disks are less than
+	//           TOUCHING_DISTANCE apart.
+	//  Side Effect: N/A
+	//
+	static bool isTouching (const ObjLibrary::Vector3& position1,
+	                        float radius1,
+	                        const ObjLibrary::Vector3& position2,
+	                        float radius2);
+
+	//
+	//  calculateNodePosition
+	//
+	//  Purpose: To determine where the node on a disk for its
+	//           link to another disk is.
+	//  Parameter(s):
+	//    <1> position: The center of the disk
+	//    <2> radius: The radius of the disk
+	//    <3> other_position: The center of the other disk
+	//  Precondition(s):
+	//    <1> position != other_position
+	//  Returns: The point NODE_INSET inside the edge of the disk
+	//           in the direction of other_position.
+	//  Side Effect: N/A
+	//
+	static ObjLibrary::Vector3 calculateNodePosition (
+	                  const ObjLibrary::Vector3& position,
+	                  float radius,
+	                  const ObjLibrary::Vector3& other_position);
+
+	//
+	//  calculateLinkWeight
+	//
+	//  Purpose: To determine the weight of the link between the
+	//           nodes where two disks touch.
+	//  Parameter(s):
+	//    <1> node1
+	//    <2> radius1: The node and radius of one disk
+	//    <3> node2
+	//    <4> radius2: The node and radius of the other disk
+	//  Precondition(s): N/A
+	//  Returns: The distance between the nodes, scaled by the
+	//           average cost of moving on the two disks.
+	//  Side Effect: N/A
+	//
+	static double calculateLinkWeight (
+	                         const ObjLibrary::Vector3& node1,
+	                         float radius1,
+	                         const ObjLibrary::Vector3& node2,
+	                         float radius2);
+
+	//
+	//  calculateRingLinkWeight
+	//
+	//  Purpose: To determine the weight of the link between two
+	//           nodes on the same disk.
+	//  Parameter(s):
+	//    <1> position: The center of the disk
+	//    <2> radius: The radius of the disk
+	//    <3> node1
+	//    <4> node2: The nodes
+	//  Precondition(s): N/A
+	//  Returns: The length of the arc around the disk between
+	//           node1 and node2.
+	//  Side Effect: N/A
+	//
+	static double calculateRingLinkWeight (
+	                         const ObjLibrary::Vector3& position,
+	                         float radius,
+	                         const ObjLibrary::Vector3& node1,
+	                         const ObjLibrary::Vector3& node2);
+
+public:
+	//
+	//  Default Constructor
+	//
+	//  Purpose: To create a new WorldFile with no disks.
+	//  Parameter(s): N/A
+	//  Precondition(s): N/A
+	//  Returns: N/A
+	//  Side Effect: A new WorldFile is created.
+	//
+	WorldFile ();
+
+	WorldFile (const WorldFile& original) = default;
+	~WorldFile () = default;
+	WorldFile& operator= (const WorldFile& original) = default;
+
+	//
+	//  getRadius
+	//
+	//  Purpose: To determine the world radius.
+	//  Parameter(s): N/A
+	//  Precondition(s): N/A
+	//  Returns: The world radius.
+	//  Side Effect: N/A
+	//
+	float getRadius () const;
+
+	//
+	//  getDiskCount
+	//
+	//  Purpose: To determine the number of disks.
+	//  Parameter(s): N/A
+	//  Precondition(s): N/A
+	//  Returns: The number of disks.
+	//  Side Effect: N/A
+	//
+	unsigned int getDiskCount () const;
+
+	//
+	//  getDiskPosition
+	//
+	//  Purpose: To determine the center of the specified disk.
+	//  Parameter(s):
+	//    <1> disk: Which disk
+	//  Precondition(s):
+	//    <1> disk < getDiskCount()
+	//  Returns: The center of disk disk.  The Y-coordinate is
+	//           always 0.
+	//  Side Effect: N/A
+	//
+	const ObjLibrary::Vector3& getDiskPosition (
+	                                  unsigned int disk) const;
+
+	//
+	//  getDiskRadius
+	//
+	//  Purpose: To determine the radius of the specified disk.
+	//  Parameter(s):
+	//    <1> disk: Which disk
+	//  Precondition(s):
+	//    <1> disk < getDiskCount()
+	//  Returns: The radius of disk disk.
+	//  Side Effect: N/A
+	//
+	float getDiskRadius (unsigned int disk) const;
+
+	//
+	//  isSeeded
+	//
+	//  Purpose: To determine whether the disks have seeds.
+	//  Parameter(s): N/A
+	//  Precondition(s): N/A
+	//  Returns: Whether every disk has a seed.  Disks without
+	//           seeds should be given random ones.
+	//  Side Effect: N/A
+	//
+	bool isSeeded () const;
+
+	//
+	//  getDiskSeed
+	//
+	//  Purpose: To determine the seed for the specified disk.
+	//  Parameter(s):
+	//    <1> disk: Which disk
+	//  Precondition(s):
+	//    <1> isSeeded()
+	//    <2> disk < getDiskCount()
+	//  Returns: The seed for disk disk.
+	//  Side Effect: N/A
+	//
+	uint64_t getDiskSeed (unsigned int disk) const;
+
+	//
+	//  isMovementGraph
+	//
+	//  Purpose: To determine whether the movement graph has
+	//           been built.
+	//  Parameter(s): N/A
+	//  Precondition(s): N/A
+	//  Returns: Whether there is a movement graph.
+	//  Side Effect: N/A
+	//
+	bool isMovementGraph () const;
+
+	//
+	//  getNodeCount
+	//
+	//  Purpose: To determine the number of nodes in the
+	//           movement graph.
+	//  Parameter(s): N/A
+	//  Precondition(s):
+	//    <1> isMovementGraph()
+	//  Returns: The number of nodes.
+	//  Side Effect: N/A
+	//
+	unsigned int getNodeCount () const;
+
+	//
+	//  getNodePosition
+	//
+	//  Purpose: To determine the position of the specified
+	//           node.
+	//  Parameter(s):
+	//    <1> node: Which node
+	//  Precondition(s):
+	//    <1> isMovementGraph()
+	//    <2> node < getNodeCount()
+	//  Returns: The position of node node.
+	//  Side Effect: N/A
+	//
+	const ObjLibrary::Vector3& getNodePosition (
+	                                  unsigned int node) const;
+
+	//
+	//  getNodeDisk
+	//
+	//  Purpose: To determine which disk the specified node is
+	//           on.
+	//  Parameter(s):
+	//    <1> node: Which node
+	//  Precondition(s):
+	//    <1> isMovementGraph()
+	//    <2> node < getNodeCount()
+	//  Returns: The index of the disk node node is on.
+	//  Side Effect: N/A
+	//
+	unsigned int getNodeDisk (unsigned int node) const;
+
+	//
+	//  getLinkCount
+	//
+	//  Purpose: To determine the number of links from the
+	//           specified node.
+	//  Parameter(s):
+	//    <1> node: Which node
+	//  Precondition(s):
+	//    <1> isMovementGraph()
+	//    <2> node < getNodeCount()
+	//  Returns: The number of links from node node.
+	//  Side Effect: N/A
+	//
+	unsigned int getLinkCount (unsigned int node) const;
+
+	//
+	//  getLinkTarget
+	//
+	//  Purpose: To determine the node at the other end of the
+	//           specified link.
+	//  Parameter(s):
+	//    <1> node: Which node
+	//    <2> link: Which link from node node
+	//  Precondition(s):
+	//    <1> isMovementGraph()
+	//    <2> node < getNodeCount()
+	//    <3> link < getLinkCount(node)
+	//  Returns: The index of the other node for link link.
+	//  Side Effect: N/A
+	//
+	unsigned int getLinkTarget (unsigned int node,
+	                            unsigned int link) const;
+
+	//
+	//  getLinkWeight
+	//
+	//  Purpose: To determine the weight of the specified link.
+	//  Parameter(s):
+	//    <1> node: Which node
+	//    <2> link: Which link from node node
+	//  Precondition(s):
+	//    <1> isMovementGraph()
+	//    <2> node < getNodeCount()
+	//    <3> link < getLinkCount(node)
+	//  Returns: The weight of link link.  This is the cost for
+	//           a ring to move along it.
+	//  Side Effect: N/A
+	//
+	double getLinkWeight (unsigned int node,
+	                      unsigned int link) const;
+
+	//
+	//  makeEmpty
+	//
+	//  Purpose: To remove all disks and the movement graph.
+	//  Parameter(s): N/A
+	//  Precondition(s): N/A
+	//  Returns: N/A
+	//  Side Effect: This WorldFile is set to have no disks and
+	//               no movement graph.
+	//
+	void makeEmpty ();
+
+	//
+	//  loadText
+	//
+	//  Purpose: To load the disks from the specified text world
+	//           file.
+	//  Parameter(s):
+	//    <1> filename: The name of the text file
+	//  Precondition(s):
+	//    <1> filename != ""
+	//  Returns: Whether the file was loaded.
+	//  Side Effect: The disks in file filename replace the
+	//               contents of this WorldFile.  The disks do
+	//               not have seeds and there is no movement
+	//               graph.  If the file cannot be loaded, an
+	//               error message is printed and this WorldFile
+	//               is left empty.
+	//
+	bool loadText (const std::string& filename);
+
+	//
+	//  load
+	//
+	//  Purpose: To load the specified binary world file.
+	//  Parameter(s):
+	//    <1> filename: The name of the binary file
+	//  Precondition(s):
+	//    <1> filename != ""
+	//  Returns: Whether the file was loaded.  It is not loaded
+	//           if it does not exist, has the wrong version or
+	//           byte order, or fails its checksum or any other
+	//           check.
+	//  Side Effect: The file is mapped into memory and its
+	//               contents replace the contents of this
+	//               WorldFile.  If it cannot be loaded, this
+	//               WorldFile is left empty.
+	//
+	bool load (const std::string& filename);
+
+	//
+	//  save
+	//
+	//  Purpose: To save this WorldFile in the binary format.
+	//  Parameter(s):
+	//    <1> filename: The name of the file to write
+	//  Precondition(s):
+	//    <1> filename != ""
+	//    <2> isMovementGraph()
+	//  Returns: Whether the file was written.
+	//  Side Effect: File filename is created or replaced.
+	//
+	bool save (const std::string& filename) const;
+
+	//
+	//  setSeeds
+	//
+	//  Purpose: To give every disk a seed derived from the
+	//           specified seed.
+	//  Parameter(s):
+	//    <1> seed: The seed for the whole world
+	//  Precondition(s): N/A
+	//  Returns: N/A
+	//  Side Effect: Each disk is given a different seed
+	//               determined by seed and its index.
+	//
+	void setSeeds (uint64_t seed);
+
+	//
+	//  buildMovementGraph
+	//
+	//  Purpose: To build the movement graph for the disks.
+	//  Parameter(s): N/A
+	//  Precondition(s): N/A
+	//  Returns: N/A
+	//  Side Effect: The movement graph is replaced with one
+	//               calculated from the disk positions and radii.
+	//
+	void buildMovementGraph ();
+
+private:
+	//
+	//  Helper Function: invariant
+	//
+	//  Purpose: To determine if the class invariant is true.
+	//  Parameter(s): N/A
+	//  Precondition(s): N/A
+	//  Returns: Whether the class invariant is true.
+	//  Side Effect: N/A
+	//
+	bool invariant () const;
+
+private:
+	float m_radius;
+	std::vector<ObjLibrary::Vector3> mv_disk_positions;
+	std::vector<float> mv_disk_radii;
+	std::vector<uint64_t> mv_disk_seeds;
+	std::vector<ObjLibrary::Vector3> mv_node_positions;
+	std::vector<unsigned int> mv_node_disks;
+	std::vector<unsigned int> mv_link_offsets;
+	std::vector<unsigned int> mv_link_targets;
+	std::vector<double> mv_link_weights;
+};
+
+
+
+#endif
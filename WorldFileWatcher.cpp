@@ -0,0 +1,188 @@
+//
+//  WorldFileWatcher.cpp
+//
+
+#include <cassert>
+#include <filesystem>
+#include <iostream>
+#include <string>
+#include <system_error>
+
+#ifdef __linux__
+	#include <cerrno>
+	#include <cstring>
+	#include <sys/inotify.h>
+	#include <unistd.h>
+#endif
+
+#include "WorldFileWatcher.h"
+
+using namespace std;
+namespace
+{
+	//
+	//  EVENT_BUFFER_SIZE
+	//
+	//  The size of the buffer to read inotify events into.  If
+	//    there are more events, they are read in more than one
+	//    pass.
+	//
+	const unsigned int EVENT_BUFFER_SIZE = 4096;
+}
+
+
+
+WorldFileWatcher :: WorldFileWatcher ()
+		: m_filename()
+		, m_inotify_descriptor(-1)
+		, m_watch_descriptor(-1)
+		, m_last_write_time()
+{
+	assert(invariant());
+}
+
+WorldFileWatcher :: ~WorldFileWatcher ()
+{
+	stop();
+}
+
+
+
+bool WorldFileWatcher :: isWatching () const
+{
+	return m_filename != "";
+}
+
+const string& WorldFileWatcher :: getFilename () const
+{
+	assert(isWatching());
+
+	return m_filename;
+}
+
+#ifdef __linux__
+
+bool WorldFileWatcher :: isChanged ()
+{
+	if(!isWatching())
+		return false;
+
+	string name = filesystem::path(m_filename).filename().string();
+	bool is_changed = false;
+
+	alignas(inotify_event) char a_buffer[EVENT_BUFFER_SIZE];
+	while(true)  // loop exits below
+	{
+		ssize_t length = read(m_inotify_descriptor, a_buffer, sizeof(a_buffer));
+		if(length <= 0)
+			break;  // no more events (EAGAIN) or an error
+
+		for(ssize_t offset = 0; offset < length; )
+		{
+			const inotify_event* p_event = reinterpret_cast<const inotify_event*>(a_buffer + offset);
+			if((p_event->mask & IN_Q_OVERFLOW) != 0)
+				is_changed = true;  // some events were lost, so assume the worst
+			else if(p_event->len > 0 && name == p_event->name)
+				is_changed = true;
+			offset += sizeof(inotify_event) + p_event->len;
+		}
+	}
+
+	assert(invariant());
+	return is_changed;
+}
+
+bool WorldFileWatcher :: watch (const string& filename)
+{
+	assert(filename != "");
+
+	stop();
+
+	string folder = filesystem::path(filename).parent_path().string();
+	if(folder == "")
+		folder = ".";
+
+	m_inotify_descriptor = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+	if(m_inotify_descriptor == -1)
+	{
+		cerr << "Error in WorldFileWatcher::watch: Could not start inotify: " << strerror(errno) << endl;
+		return false;
+	}
+
+	// watch the folder, because saving may replace the file
+	m_watch_descriptor = inotify_add_watch(m_inotify_descriptor, folder.c_str(), IN_CLOSE_WRITE | IN_MOVED_TO);
+	if(m_watch_descriptor == -1)
+	{
+		cerr << "Error in WorldFileWatcher::watch: Could not watch \"" << folder << "\": " << strerror(errno) << endl;
+		stop();
+		return false;
+	}
+
+	m_filename = filename;
+	assert(invariant());
+	return true;
+}
+
+void WorldFileWatcher :: stop ()
+{
+	// closing the descriptor removes the watch
+	if(m_inotify_descriptor != -1)
+		close(m_inotify_descriptor);
+	m_inotify_descriptor = -1;
+	m_watch_descriptor   = -1;
+	m_filename = "";
+
+	assert(invariant());
+}
+
+#else	// not Linux
+
+bool WorldFileWatcher :: isChanged ()
+{
+	if(!isWatching())
+		return false;
+
+	error_code error;
+	filesystem::file_time_type write_time = filesystem::last_write_time(m_filename, error);
+	if(error || write_time == m_last_write_time)
+		return false;
+
+	m_last_write_time = write_time;
+	return true;
+}
+
+bool WorldFileWatcher :: watch (const string& filename)
+{
+	assert(filename != "");
+
+	stop();
+
+	error_code error;
+	m_last_write_time = filesystem::last_write_time(filename, error);
+	if(error)
+	{
+		cerr << "Error in WorldFileWatcher::watch: Could not find \"" << filename << "\": " << error.message() << endl;
+		return false;
+	}
+
+	m_filename = filename;
+	assert(invariant());
+	return true;
+}
+
+void WorldFileWatcher :: stop ()
+{
+	m_filename = "";
+
+	assert(invariant());
+}
+
+#endif
+
+
+
+bool WorldFileWatcher :: invariant () const
+{
+	if(m_filename == "" && m_watch_descriptor != -1) return false;
+	return true;
+}
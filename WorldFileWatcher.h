@@ -0,0 +1,164 @@
+//
+//  WorldFileWatcher.h
+//
+//  A module to notice when a world data file is changed on
+//    disk, so the world can be reloaded while the game runs.
+//
+
+#ifndef WORLD_FILE_WATCHER_H
+#define WORLD_FILE_WATCHER_H
+
+#include <filesystem>
+#include <string>
+
+
+
+//
+//  WorldFileWatcher
+//
+//  A class to watch one world data file for changes.  It is
+//    checked by polling isChanged, which never waits, so it can
+//    be called every frame.
+//
+//  On Linux, the folder containing the file is watched with
+//    inotify.  A change is reported when the file is closed
+//    after writing or another file is moved over it, which is
+//    how most editors save, so a file is never reported while
+//    it is only partly written.  Elsewhere, the time the file
+//    was last written is checked instead.
+//
+//  A WorldFileWatcher cannot be copied.
+//
+//  Class Invariant:
+//    <1> m_filename != "" || m_watch_descriptor == -1
+//
+class WorldFileWatcher
+{
+public:
+	//
+	//  Default Constructor
+	//
+	//  Purpose: To create a new WorldFileWatcher that is not
+	//           watching any file.
+	//  Parameter(s): N/A
+	//  Precondition(s): N/A
+	//  Returns: N/A
+	//  Side Effect: A new WorldFileWatcher is created.
+	//
+	WorldFileWatcher ();
+
+	//
+	//  Destructor
+	//
+	//  Purpose: To safely destroy this WorldFileWatcher.
+	//  Parameter(s): N/A
+	//  Precondition(s): N/A
+	//  Returns: N/A
+	//  Side Effect: The file is no longer watched.
+	//
+	~WorldFileWatcher ();
+
+	//
+	//  isWatching
+	//
+	//  Purpose: To determine whether a file is being watched.
+	//  Parameter(s): N/A
+	//  Precondition(s): N/A
+	//  Returns: Whether a file is being watched.
+	//  Side Effect: N/A
+	//
+	bool isWatching () const;
+
+	//
+	//  getFilename
+	//
+	//  Purpose: To determine which file is being watched.
+	//  Parameter(s): N/A
+	//  Precondition(s):
+	//    <1> isWatching()
+	//  Returns: The name of the file.
+	//  Side Effect: N/A
+	//
+	const std::string& getFilename () const;
+
+	//
+	//  isChanged
+	//
+	//  Purpose: To determine whether the file being watched has
+	//           changed since the last time this function was
+	//           called.
+	//  Parameter(s): N/A
+	//  Precondition(s): N/A
+	//  Returns: Whether the file has been changed.  If no file
+	//           is being watched, false is returned.
+	//  Side Effect: The changes are marked as seen, so the same
+	//               change is only reported once.  Any number of
+	//               changes since the last call are reported as
+	//               one.
+	//
+	bool isChanged ();
+
+	//
+	//  watch
+	//
+	//  Purpose: To start watching the specified file.
+	//  Parameter(s):
+	//    <1> filename: The name of the file
+	//  Precondition(s):
+	//    <1> filename != ""
+	//  Returns: Whether the file can be watched.
+	//  Side Effect: Any file already being watched is no longer
+	//               watched, and file filename is watched
+	//               instead.  If it cannot be watched, an error
+	//               message is printed and no file is watched.
+	//
+	bool watch (const std::string& filename);
+
+	//
+	//  stop
+	//
+	//  Purpose: To stop watching the file.
+	//  Parameter(s): N/A
+	//  Precondition(s): N/A
+	//  Returns: N/A
+	//  Side Effect: No file is watched.
+	//
+	void stop ();
+
+private:
+	//
+	//  Copy Constructor
+	//  Assignment Operator
+	//
+	//  These functions have intentionally not been implemented
+	//    because a WorldFileWatcher owns the operating system
+	//    resources used to watch its file.
+	//
+	WorldFileWatcher (const WorldFileWatcher& original);
+	WorldFileWatcher& operator= (const WorldFileWatcher& original);
+
+	//
+	//  Helper Function: invariant
+	//
+	//  Purpose: To determine if the class invariant is true.
+	//  Parameter(s): N/A
+	//  Precondition(s): N/A
+	//  Returns: Whether the class invariant is true.
+	//  Side Effect: N/A
+	//
+	bool invariant () const;
+
+private:
+	std::string m_filename;
+
+	// the inotify descriptors, unused elsewhere
+	int m_inotify_descriptor;
+	int m_watch_descriptor;
+
+	// unused with inotify
+	std::filesystem::file_time_type m_last_write_time;
+};
+
+
+
+#endif
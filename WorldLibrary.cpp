@@ -0,0 +1,438 @@
+//
+//  WorldLibrary.cpp
+//
+
+#include <atomic>
+#include <cassert>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "TraceRecorder.h"
+#include "World.h"
+#include "Game.h"
+#include "WorldLibrary.h"
+
+using namespace std;
+
+
+
+WorldLibrary :: WorldLibrary ()
+		: m_mutex()
+		, m_condition()
+		, m_entries()
+		, mv_failed()
+		, m_memory_budget(MEMORY_BUDGET_DEFAULT)
+		, m_memory_used(0)
+		, m_is_seeded(false)
+		, m_seed(0)
+		, m_requests()
+		, m_loading_filename()
+		, m_loading_progress(0.0f)
+		, m_prepare_filename()
+		, m_is_prepare_reload(false)
+		, m_prepared_filename()
+		, mp_prepared_game()
+		, mvp_released_games()
+		, m_is_stopping(false)
+		, m_thread()
+{
+}
+
+WorldLibrary :: ~WorldLibrary ()
+{
+	{
+		lock_guard<mutex> lock(m_mutex);
+		m_is_stopping = true;
+	}
+	m_condition.notify_all();
+	if(m_thread.joinable())
+		m_thread.join();
+}
+
+
+
+size_t WorldLibrary :: getMemoryBudget () const
+{
+	lock_guard<mutex> lock(m_mutex);
+	return m_memory_budget;
+}
+
+size_t WorldLibrary :: getMemoryUsed () const
+{
+	lock_guard<mutex> lock(m_mutex);
+	return m_memory_used;
+}
+
+unsigned int WorldLibrary :: getResidentCount () const
+{
+	lock_guard<mutex> lock(m_mutex);
+	return m_entries.size();
+}
+
+bool WorldLibrary :: isResident (const string& filename) const
+{
+	lock_guard<mutex> lock(m_mutex);
+	return findLocked(filename) != m_entries.end();
+}
+
+bool WorldLibrary :: isFailed (const string& filename) const
+{
+	lock_guard<mutex> lock(m_mutex);
+	for(unsigned int i = 0; i < mv_failed.size(); i++)
+		if(mv_failed[i] == filename)
+			return true;
+	return false;
+}
+
+float WorldLibrary :: getProgress (const string& filename) const
+{
+	lock_guard<mutex> lock(m_mutex);
+	if(findLocked(filename) != m_entries.end())
+		return 1.0f;
+	if(filename == m_loading_filename)
+		return m_loading_progress.load();
+	return 0.0f;
+}
+
+shared_ptr<World> WorldLibrary :: find (const string& filename)
+{
+	lock_guard<mutex> lock(m_mutex);
+
+	list<Entry>::const_iterator found = findLocked(filename);
+	if(found == m_entries.end())
+		return nullptr;
+
+	m_entries.splice(m_entries.begin(), m_entries, found);
+	return found->mp_world;
+}
+
+shared_ptr<World> WorldLibrary :: load (const string& filename)
+{
+	assert(filename != "");
+
+	shared_ptr<World> p_world = find(filename);
+	if(p_world != nullptr)
+		return p_world;
+	return loadOnThisThread(filename, nullptr);
+}
+
+void WorldLibrary :: request (const string& filename)
+{
+	assert(filename != "");
+
+	{
+		lock_guard<mutex> lock(m_mutex);
+		if(findLocked(filename) != m_entries.end() || filename == m_loading_filename)
+			return;
+		for(unsigned int i = 0; i < m_requests.size(); i++)
+			if(m_requests[i] == filename)
+				return;
+		m_requests.push_back(filename);
+		startThreadLocked();
+	}
+	m_condition.notify_all();
+}
+
+void WorldLibrary :: prepareGame (const string& filename)
+{
+	assert(filename != "");
+
+	{
+		lock_guard<mutex> lock(m_mutex);
+		clearFailedLocked(filename);
+		m_prepare_filename  = filename;
+		m_is_prepare_reload = false;
+		if(mp_prepared_game != nullptr)
+		{
+			mvp_released_games.push_back(move(mp_prepared_game));
+			m_prepared_filename = "";
+		}
+		startThreadLocked();
+	}
+	m_condition.notify_all();
+}
+
+void WorldLibrary :: reloadGame (const string& filename)
+{
+	assert(filename != "");
+
+	{
+		lock_guard<mutex> lock(m_mutex);
+		clearFailedLocked(filename);
+		m_prepare_filename  = filename;
+		m_is_prepare_reload = true;
+		if(mp_prepared_game != nullptr)
+		{
+			mvp_released_games.push_back(move(mp_prepared_game));
+			m_prepared_filename = "";
+		}
+		startThreadLocked();
+	}
+	m_condition.notify_all();
+}
+
+shared_ptr<Game> WorldLibrary :: takePreparedGame (const string& filename)
+{
+	lock_guard<mutex> lock(m_mutex);
+	if(mp_prepared_game == nullptr || filename != m_prepared_filename)
+		return nullptr;
+
+	m_prepared_filename = "";
+	return move(mp_prepared_game);
+}
+
+void WorldLibrary :: release (shared_ptr<Game>&& p_game)
+{
+	if(p_game == nullptr)
+		return;
+
+	{
+		lock_guard<mutex> lock(m_mutex);
+		mvp_released_games.push_back(move(p_game));
+		startThreadLocked();
+	}
+	m_condition.notify_all();
+}
+
+void WorldLibrary :: setMemoryBudget (size_t bytes)
+{
+	vector<shared_ptr<World> > v_released;
+	{
+		lock_guard<mutex> lock(m_mutex);
+		m_memory_budget = bytes;
+		evictOverBudget(v_released);
+	}
+	// v_released is destroyed here, without the lock
+}
+
+void WorldLibrary :: setSeed (uint64_t seed)
+{
+	lock_guard<mutex> lock(m_mutex);
+	m_is_seeded = true;
+	m_seed      = seed;
+}
+
+
+
+void WorldLibrary :: startThreadLocked ()
+{
+	if(!m_thread.joinable())
+		m_thread = thread(&WorldLibrary::run, this);
+}
+
+void WorldLibrary :: run ()
+{
+	TraceRecorder::setThreadName("World loader");
+
+	unique_lock<mutex> lock(m_mutex);
+	while(!m_is_stopping)
+	{
+		if(!mvp_released_games.empty())
+		{
+			vector<shared_ptr<Game> > v_released;
+			v_released.swap(mvp_released_games);
+			lock.unlock();
+			{
+				TRACE_SCOPE("Release game");
+				v_released.clear();
+			}
+			lock.lock();
+		}
+		else if(m_prepare_filename != "")
+		{
+			string filename = m_prepare_filename;
+			bool is_reload = m_is_prepare_reload;
+			m_is_prepare_reload = false;
+			m_loading_filename = filename;
+			lock.unlock();
+
+			shared_ptr<World> p_world;
+			if(is_reload)
+				p_world = reloadOnThisThread(filename, &m_loading_progress);
+			else
+			{
+				p_world = find(filename);
+				if(p_world == nullptr)
+					p_world = loadOnThisThread(filename, &m_loading_progress);
+			}
+			shared_ptr<Game> p_game;
+			if(p_world != nullptr)
+			{
+				TRACE_SCOPE("Prepare game");
+				p_game = make_shared<Game>(p_world);
+				p_game->update();  // the first update is always slow
+			}
+
+			lock.lock();
+			m_loading_filename = "";
+			if(filename == m_prepare_filename && !m_is_prepare_reload)
+			{
+				// otherwise, another Game or a reload was asked for meanwhile
+				m_prepare_filename = "";
+				if(p_game != nullptr)
+				{
+					mp_prepared_game    = move(p_game);
+					m_prepared_filename = filename;
+				}
+			}
+			if(p_game != nullptr)
+				mvp_released_games.push_back(move(p_game));
+		}
+		else if(!m_requests.empty())
+		{
+			string filename = m_requests.front();
+			m_requests.pop_front();
+			if(findLocked(filename) != m_entries.end())
+				continue;
+			m_loading_filename = filename;
+			lock.unlock();
+
+			loadOnThisThread(filename, &m_loading_progress);
+
+			lock.lock();
+			m_loading_filename = "";
+		}
+		else
+			m_condition.wait(lock);
+	}
+}
+
+shared_ptr<World> WorldLibrary :: loadOnThisThread (const string& filename,
+                                                    atomic<float>* p_progress)
+{
+	assert(filename != "");
+
+	bool is_seeded;
+	uint64_t seed;
+	{
+		lock_guard<mutex> lock(m_mutex);
+		is_seeded = m_is_seeded;
+		seed      = m_seed;
+	}
+
+	shared_ptr<World> p_world = make_shared<World>();
+	bool is_loaded;
+	{
+		TRACE_SCOPE("Load world in background");
+		if(is_seeded)
+			is_loaded = p_world->init(filename, seed, p_progress);
+		else
+			is_loaded = p_world->init(filename, p_progress);
+	}
+
+	vector<shared_ptr<World> > v_released;
+	lock_guard<mutex> lock(m_mutex);
+
+	clearFailedLocked(filename);
+	if(!is_loaded)
+	{
+		mv_failed.push_back(filename);
+		return nullptr;
+	}
+
+	list<Entry>::const_iterator found = findLocked(filename);
+	if(found != m_entries.end())
+	{
+		// another thread loaded it first
+		m_entries.splice(m_entries.begin(), m_entries, found);
+		v_released.push_back(move(p_world));
+		return found->mp_world;
+	}
+
+	size_t bytes = p_world->getMemoryBytes();
+	m_entries.push_front({ filename, p_world, bytes });
+	m_memory_used += bytes;
+	evictOverBudget(v_released);
+	return p_world;
+}
+
+shared_ptr<World> WorldLibrary :: reloadOnThisThread (const string& filename,
+                                                      atomic<float>* p_progress)
+{
+	assert(filename != "");
+
+	shared_ptr<World> p_old_world = find(filename);
+	if(p_old_world == nullptr)
+		return loadOnThisThread(filename, p_progress);
+
+	// the old World may still be in use, so change a copy
+	shared_ptr<World> p_world;
+	bool is_loaded;
+	{
+		TRACE_SCOPE("Reload world in background");
+		p_world = make_shared<World>(*p_old_world);
+		is_loaded = p_world->reload(filename);
+	}
+
+	vector<shared_ptr<World> > v_released;
+	lock_guard<mutex> lock(m_mutex);
+
+	clearFailedLocked(filename);
+	if(!is_loaded)
+	{
+		mv_failed.push_back(filename);
+		return nullptr;
+	}
+
+	list<Entry>::const_iterator found = findLocked(filename);
+	if(found != m_entries.end())
+	{
+		assert(m_memory_used >= found->m_bytes);
+		m_memory_used -= found->m_bytes;
+		m_entries.erase(found);
+	}
+
+	size_t bytes = p_world->getMemoryBytes();
+	m_entries.push_front({ filename, p_world, bytes });
+	m_memory_used += bytes;
+	evictOverBudget(v_released);
+	return p_world;
+}
+
+list<WorldLibrary::Entry>::const_iterator WorldLibrary :: findLocked (const string& filename) const
+{
+	for(list<Entry>::const_iterator it = m_entries.begin(); it != m_entries.end(); ++it)
+		if(it->m_filename == filename)
+			return it;
+	return m_entries.end();
+}
+
+void WorldLibrary :: clearFailedLocked (const string& filename)
+{
+	for(unsigned int i = 0; i < mv_failed.size(); i++)
+		if(mv_failed[i] == filename)
+		{
+			mv_failed.erase(mv_failed.begin() + i);
+			return;
+		}
+}
+
+void WorldLibrary :: evictOverBudget (vector<shared_ptr<World> >& rv_released)
+{
+	if(m_entries.empty())
+		return;
+
+	list<Entry>::iterator it = m_entries.end();
+	--it;
+	while(m_memory_used > m_memory_budget && it != m_entries.begin())
+	{
+		list<Entry>::iterator next = it;
+		--next;
+		if(it->mp_world.use_count() == 1)
+		{
+			assert(m_memory_used >= it->m_bytes);
+			m_memory_used -= it->m_bytes;
+			rv_released.push_back(move(it->mp_world));
+			m_entries.erase(it);
+		}
+		it = next;
+	}
+}
@@ -0,0 +1,513 @@
+//
+//  WorldLibrary.h
+//
+//  A module to load worlds on a background thread and keep
+//    several of them ready to switch to.
+//
+
+#ifndef WORLD_LIBRARY_H
+#define WORLD_LIBRARY_H
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+class World;
+class Game;
+
+
+
+//
+//  WorldLibrary
+//
+//  A class to load Worlds on a background thread and keep the
+//    ones loaded, up to a memory budget, so the game can
+//    switch between them without waiting.  Each World is
+//    identified by the name of its data file.
+//
+//  Loading a World and preparing a Game in it are done on the
+//    loading thread, one at a time, with the progress of the
+//    current load available to any thread.  A prepared Game
+//    can then be swapped in between physics frames (see
+//    Game::switchTo), so the game never waits for a load.
+//    The Game swapped out can be given back to be destroyed
+//    on the loading thread as well.
+//
+//  When a world data file is changed, the World can be
+//    reloaded with reloadGame.  A copy of the World is changed
+//    to match the file (see World::applyChanges) and replaces
+//    it here, so the Games still using the old World are not
+//    affected.
+//
+//  The Worlds are kept in least-recently-used order.  When a
+//    World is added and the memory used is over the budget,
+//    the least recently used Worlds that are not in use
+//    elsewhere are released until it is not.  The World most
+//    recently added is never released this way.  The
+//    heightmaps are not counted, because they are kept by the
+//    HeightmapCache.
+//
+//  Every function can be called from any thread.  A
+//    WorldLibrary cannot be copied.  The loading thread is
+//    stopped when the WorldLibrary is destroyed, after the
+//    current load finishes.
+//
+class WorldLibrary
+{
+public:
+	//
+	//  MEMORY_BUDGET_DEFAULT
+	//
+	//  The default memory budget in bytes.
+	//
+	static const size_t MEMORY_BUDGET_DEFAULT = 256 * 1024 * 1024;
+
+public:
+	//
+	//  Default Constructor
+	//
+	//  Purpose: To create a new WorldLibrary with no Worlds.
+	//  Parameter(s): N/A
+	//  Precondition(s): N/A
+	//  Returns: N/A
+	//  Side Effect: A new WorldLibrary is created.  Its
+	//               loading thread is started the first time
+	//               it is needed.
+	//
+	WorldLibrary ();
+
+	//
+	//  Destructor
+	//
+	//  Purpose: To safely destroy this WorldLibrary.
+	//  Parameter(s): N/A
+	//  Precondition(s): N/A
+	//  Returns: N/A
+	//  Side Effect: Any loads waiting to start are abandoned,
+	//               the loading thread is stopped, and the
+	//               Worlds are released.
+	//
+	~WorldLibrary ();
+
+	//
+	//  getMemoryBudget
+	//
+	//  Purpose: To determine the memory budget.
+	//  Parameter(s): N/A
+	//  Precondition(s): N/A
+	//  Returns: The largest number of bytes to use for Worlds
+	//           that are not in use.
+	//  Side Effect: N/A
+	//
+	size_t getMemoryBudget () const;
+
+	//
+	//  getMemoryUsed
+	//
+	//  Purpose: To determine how much memory is used by the
+	//           Worlds that have been loaded.
+	//  Parameter(s): N/A
+	//  Precondition(s): N/A
+	//  Returns: The number of bytes used, as estimated by
+	//           World::getMemoryBytes.
+	//  Side Effect: N/A
+	//
+	size_t getMemoryUsed () const;
+
+	//
+	//  getResidentCount
+	//
+	//  Purpose: To determine how many Worlds have been loaded
+	//           and are still kept.
+	//  Parameter(s): N/A
+	//  Precondition(s): N/A
+	//  Returns: The number of Worlds.
+	//  Side Effect: N/A
+	//
+	unsigned int getResidentCount () const;
+
+	//
+	//  isResident
+	//
+	//  Purpose: To determine whether the specified World has
+	//           been loaded and is still kept.
+	//  Parameter(s):
+	//    <1> filename: The name of the world data file
+	//  Precondition(s): N/A
+	//  Returns: Whether the World for file filename is ready.
+	//  Side Effect: N/A
+	//
+	bool isResident (const std::string& filename) const;
+
+	//
+	//  isFailed
+	//
+	//  Purpose: To determine whether the specified World could
+	//           not be loaded.
+	//  Parameter(s):
+	//    <1> filename: The name of the world data file
+	//  Precondition(s): N/A
+	//  Returns: Whether the last attempt to load file filename
+	//           failed.
+	//  Side Effect: N/A
+	//
+	bool isFailed (const std::string& filename) const;
+
+	//
+	//  getProgress
+	//
+	//  Purpose: To determine how much of the specified World
+	//           has been loaded.
+	//  Parameter(s):
+	//    <1> filename: The name of the world data file
+	//  Precondition(s): N/A
+	//  Returns: The fraction of the World loaded, from 0.0f to
+	//           1.0f.  This is 1.0f if the World is resident
+	//           and 0.0f if it is not being loaded.
+	//  Side Effect: N/A
+	//
+	float getProgress (const std::string& filename) const;
+
+	//
+	//  find
+	//
+	//  Purpose: To retrieve the specified World if it has been
+	//           loaded.
+	//  Parameter(s):
+	//    <1> filename: The name of the world data file
+	//  Precondition(s): N/A
+	//  Returns: The World for file filename, or nullptr if it
+	//           is not resident.
+	//  Side Effect: If the World is found, it becomes the most
+	//               recently used.
+	//
+	std::shared_ptr<World> find (const std::string& filename);
+
+	//
+	//  load
+	//
+	//  Purpose: To retrieve the specified World, loading it on
+	//           this thread if needed.
+	//  Parameter(s):
+	//    <1> filename: The name of the world data file
+	//  Precondition(s):
+	//    <1> filename != ""
+	//  Returns: The World for file filename, or nullptr if it
+	//           could not be loaded.
+	//  Side Effect: If the World is not resident, it is loaded
+	//               and added as the most recently used, and
+	//               the least recently used Worlds may be
+	//               released.  Otherwise, it becomes the most
+	//               recently used.
+	//
+	std::shared_ptr<World> load (const std::string& filename);
+
+	//
+	//  request
+	//
+	//  Purpose: To load the specified World in the background.
+	//  Parameter(s):
+	//    <1> filename: The name of the world data file
+	//  Precondition(s):
+	//    <1> filename != ""
+	//  Returns: N/A
+	//  Side Effect: If the World is not resident or being
+	//               loaded, it will be loaded on the loading
+	//               thread after the requests before it.
+	//
+	void request (const std::string& filename);
+
+	//
+	//  prepareGame
+	//
+	//  Purpose: To prepare a Game in the specified World in the
+	//           background.
+	//  Parameter(s):
+	//    <1> filename: The name of the world data file
+	//  Precondition(s):
+	//    <1> filename != ""
+	//  Returns: N/A
+	//  Side Effect: A Game will be initialized in the World for
+	//               file filename on the loading thread, after
+	//               the World is loaded if it is not resident.
+	//               This is done before any requests.  Any
+	//               other Game being prepared is discarded.  If
+	//               file filename failed to load before, that
+	//               is forgotten.
+	//
+	void prepareGame (const std::string& filename);
+
+	//
+	//  reloadGame
+	//
+	//  Purpose: To reload the specified World from its file and
+	//           prepare a Game in it in the background.
+	//  Parameter(s):
+	//    <1> filename: The name of the world data file
+	//  Precondition(s):
+	//    <1> filename != ""
+	//  Returns: N/A
+	//  Side Effect: As prepareGame, except that the World for
+	//               file filename is updated to match the file
+	//               first.  If the World is resident, a copy of
+	//               it is changed to match and replaces it, so
+	//               only the disks that changed are rebuilt.
+	//               Otherwise, the World is loaded.
+	//
+	void reloadGame (const std::string& filename);
+
+	//
+	//  takePreparedGame
+	//
+	//  Purpose: To retrieve the Game prepared for the specified
+	//           World.
+	//  Parameter(s):
+	//    <1> filename: The name of the world data file
+	//  Precondition(s): N/A
+	//  Returns: The Game, or nullptr if no Game is ready for
+	//           file filename.
+	//  Side Effect: If a Game is returned, the WorldLibrary no
+	//               longer keeps it.
+	//
+	std::shared_ptr<Game> takePreparedGame (
+	                               const std::string& filename);
+
+	//
+	//  release
+	//
+	//  Purpose: To destroy the specified Game on the loading
+	//           thread.
+	//  Parameter(s):
+	//    <1> p_game: The Game
+	//  Precondition(s): N/A
+	//  Returns: N/A
+	//  Side Effect: p_game is moved from, and the Game it
+	//               pointed to is released on the loading
+	//               thread.  If it is in use elsewhere, it is
+	//               destroyed there instead, whenever it is no
+	//               longer used.
+	//
+	void release (std::shared_ptr<Game>&& p_game);
+
+	//
+	//  setMemoryBudget
+	//
+	//  Purpose: To change the memory budget.
+	//  Parameter(s):
+	//    <1> bytes: The new budget in bytes
+	//  Precondition(s): N/A
+	//  Returns: N/A
+	//  Side Effect: The memory budget is set to bytes.  If more
+	//               memory than that is used, the least
+	//               recently used Worlds that are not in use are
+	//               released.
+	//
+	void setMemoryBudget (size_t bytes);
+
+	//
+	//  setSeed
+	//
+	//  Purpose: To choose the disk heightmaps for the Worlds
+	//           loaded from now on.
+	//  Parameter(s):
+	//    <1> seed: The seed for the disks
+	//  Precondition(s): N/A
+	//  Returns: N/A
+	//  Side Effect: The Worlds loaded afterwards are
+	//               initialized with seed seed (see
+	//               World::init), so a world data file always
+	//               gives the same heightmaps.  The Worlds
+	//               already loaded are not changed.
+	//
+	void setSeed (uint64_t seed);
+
+private:
+	//
+	//  Entry
+	//
+	//  A World that has been loaded, the name of its file, and
+	//    the memory it uses.
+	//
+	struct Entry
+	{
+		std::string m_filename;
+		std::shared_ptr<World> mp_world;
+		size_t m_bytes;
+	};
+
+	//
+	//  Copy Constructor
+	//  Assignment Operator
+	//
+	//  These functions have intentionally not been implemented
+	//    because the loading thread refers to this
+	//    WorldLibrary.
+	//
+	WorldLibrary (const WorldLibrary& original);
+	WorldLibrary& operator= (const WorldLibrary& original);
+
+	//
+	//  Helper Function: startThreadLocked
+	//
+	//  Purpose: To start the loading thread if it is not
+	//           running.
+	//  Parameter(s): N/A
+	//  Precondition(s):
+	//    <1> m_mutex is locked
+	//  Returns: N/A
+	//  Side Effect: If the loading thread has not been started,
+	//               it is started.
+	//
+	void startThreadLocked ();
+
+	//
+	//  Helper Function: run
+	//
+	//  Purpose: To load Worlds and prepare Games until the
+	//           WorldLibrary is destroyed.
+	//  Parameter(s): N/A
+	//  Precondition(s): N/A
+	//  Returns: N/A
+	//  Side Effect: The Games given to release are destroyed, a
+	//               Game is prepared if one was asked for (after
+	//               reloading its World, if requested), and
+	//               the Worlds requested are loaded, in that
+	//               order.  When there is nothing to do, the
+	//               thread waits.
+	//
+	void run ();
+
+	//
+	//  Helper Function: loadOnThisThread
+	//
+	//  Purpose: To load the specified World on the current
+	//           thread.
+	//  Parameter(s):
+	//    <1> filename: The name of the world data file
+	//    <2> p_progress: A pointer to the variable to report
+	//                    progress in, or nullptr
+	//  Precondition(s):
+	//    <1> filename != ""
+	//    <2> m_mutex is not locked by this thread
+	//  Returns: The World, or nullptr if it could not be
+	//           loaded.
+	//  Side Effect: The World is loaded without holding the
+	//               lock and added as the most recently used.
+	//               If another thread added it first, that one
+	//               is kept and returned instead.
+	//
+	std::shared_ptr<World> loadOnThisThread (
+	                          const std::string& filename,
+	                          std::atomic<float>* p_progress);
+
+	//
+	//  Helper Function: reloadOnThisThread
+	//
+	//  Purpose: To reload the specified World on the current
+	//           thread.
+	//  Parameter(s):
+	//    <1> filename: The name of the world data file
+	//    <2> p_progress: A pointer to the variable to report
+	//                    progress in, or nullptr
+	//  Precondition(s):
+	//    <1> filename != ""
+	//    <2> m_mutex is not locked by this thread
+	//  Returns: The reloaded World, or nullptr if it could not
+	//           be loaded.
+	//  Side Effect: If the World is resident, a copy of it is
+	//               updated from file filename without holding
+	//               the lock and replaces it as the most
+	//               recently used.  Otherwise, it is loaded as
+	//               with loadOnThisThread.
+	//
+	std::shared_ptr<World> reloadOnThisThread (
+	                          const std::string& filename,
+	                          std::atomic<float>* p_progress);
+
+	//
+	//  Helper Function: findLocked
+	//
+	//  Purpose: To find the entry for the specified World.
+	//  Parameter(s):
+	//    <1> filename: The name of the world data file
+	//  Precondition(s):
+	//    <1> m_mutex is locked
+	//  Returns: An iterator to the entry for file filename, or
+	//           the end iterator if it is not resident.
+	//  Side Effect: N/A
+	//
+	std::list<Entry>::const_iterator findLocked (
+	                         const std::string& filename) const;
+
+	//
+	//  Helper Function: clearFailedLocked
+	//
+	//  Purpose: To forget that the specified World could not
+	//           be loaded.
+	//  Parameter(s):
+	//    <1> filename: The name of the world data file
+	//  Precondition(s):
+	//    <1> m_mutex is locked
+	//  Returns: N/A
+	//  Side Effect: File filename is removed from the list of
+	//               files that failed to load, if it is there.
+	//
+	void clearFailedLocked (const std::string& filename);
+
+	//
+	//  Helper Function: evictOverBudget
+	//
+	//  Purpose: To release Worlds until the memory budget is
+	//           not exceeded.
+	//  Parameter(s):
+	//    <1> rv_released: A reference to the vector to move the
+	//                     released Worlds to
+	//  Precondition(s):
+	//    <1> m_mutex is locked
+	//  Returns: N/A
+	//  Side Effect: The least recently used Worlds that are not
+	//               in use elsewhere are removed until the
+	//               memory used is within the budget.  The most
+	//               recently used World is never removed.  The
+	//               Worlds removed are added to rv_released, so
+	//               they can be destroyed after the lock is
+	//               released.
+	//
+	void evictOverBudget (
+	        std::vector<std::shared_ptr<World> >& rv_released);
+
+private:
+	mutable std::mutex m_mutex;
+	std::condition_variable m_condition;
+	std::list<Entry> m_entries;
+	std::vector<std::string> mv_failed;
+	size_t m_memory_budget;
+	size_t m_memory_used;
+	bool m_is_seeded;
+	uint64_t m_seed;
+
+	std::deque<std::string> m_requests;
+	std::string m_loading_filename;
+	std::atomic<float> m_loading_progress;
+
+	std::string m_prepare_filename;
+	bool m_is_prepare_reload;
+	std::string m_prepared_filename;
+	std::shared_ptr<Game> mp_prepared_game;
+	std::vector<std::shared_ptr<Game> > mvp_released_games;
+
+	bool m_is_stopping;
+	std::thread m_thread;
+};
+
+
+
+#endif